@@ -81,6 +81,11 @@ SOURCES += \
 
 qtConfig(zstd): QMAKE_USE_PRIVATE += zstd
 
+qtConfig(future) {
+    HEADERS += io/qfileasyncio_p.h
+    SOURCES += io/qfileasyncio.cpp
+}
+
 qtConfig(filesystemwatcher) {
     HEADERS += \
         io/qfilesystemwatcher.h \
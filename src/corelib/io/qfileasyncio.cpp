@@ -0,0 +1,624 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplatformdefs.h"
+#include "qfileasyncio_p.h"
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/private/qbytearray_p.h>
+
+#ifdef Q_OS_UNIX
+#  include <QtCore/private/qcore_unix_p.h>
+#endif
+#ifdef Q_OS_WIN
+#  include <qt_windows.h>
+#endif
+
+#if QT_CONFIG(io_uring)
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#endif
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+QFileAsyncHandle::~QFileAsyncHandle()
+{
+#if defined(Q_OS_WIN)
+    CloseHandle(handle);
+#elif defined(Q_OS_UNIX)
+    qt_safe_close(fd);
+#endif
+}
+
+void QFileAsyncOperation::finish(qint64 result)
+{
+    // QFuture has no error state; like QtConcurrent does for exceptions, a
+    // failure cancels the future. The result still has to be reported first,
+    // a canceled interface drops it.
+    if (type == Read) {
+        if (result < 0) {
+            readInterface.reportResult(QByteArray());
+            readInterface.reportCanceled();
+        } else {
+            buffer.resize(int(transferred));
+            readInterface.reportResult(buffer);
+        }
+        readInterface.reportFinished();
+    } else {
+        if (result < 0) {
+            writeInterface.reportResult(qint64(-1));
+            writeInterface.reportCanceled();
+        } else {
+            writeInterface.reportResult(transferred);
+        }
+        writeInterface.reportFinished();
+    }
+}
+
+/*
+    QFileAsyncIO dispatches the positional reads and writes started with
+    QFileDevice::readAsync() and QFileDevice::writeAsync().
+
+    There is one process-wide instance. On Linux it submits the requests to an
+    io_uring and a single thread collects the completions, so any number of
+    requests can be in flight without blocking a thread for each of them.
+    Everywhere else, if the kernel does not allow io_uring to be set up, or if
+    QT_NO_IO_URING is set in the environment, the requests run as blocking
+    calls on a private thread pool. The io_uring backend also hands its
+    requests over to the thread pool for good if the ring stops working.
+
+    All requests go through a private duplicate of the device's descriptor,
+    so they reach the file the device has open (the temporary file of a
+    QSaveFile, for instance) with the access it was opened with. Devices
+    without a native descriptor, such as resources, are not supported.
+*/
+
+class QFileAsyncIOThreadPool : public QFileAsyncIO
+{
+public:
+    Backend backend() const override { return ThreadPoolBackend; }
+
+    void submit(QFileAsyncOperation *op) override
+    {
+        threadPool()->start([op]() { runBlocking(op); });
+    }
+};
+
+#if QT_CONFIG(io_uring)
+class QFileAsyncIOUring : public QFileAsyncIO
+{
+    class CompletionThread : public QThread
+    {
+    public:
+        explicit CompletionThread(QFileAsyncIOUring *io) : io(io) {}
+        void run() override { io->reapCompletions(); }
+
+    private:
+        QFileAsyncIOUring *io;
+    };
+
+public:
+    ~QFileAsyncIOUring();
+
+    bool initialize(unsigned entries);
+
+    Backend backend() const override { return IoUringBackend; }
+    void submit(QFileAsyncOperation *op) override;
+
+private:
+    bool queueLocked(QFileAsyncOperation *op);
+    bool submitLocked(unsigned count);
+    void failLocked();
+    void reapCompletions();
+
+    QMutex mutex;
+    QQueue<QFileAsyncOperation *> backlog;
+    unsigned inFlight = 0;
+    bool stopping = false;
+    // set once io_uring_enter() failed; everything goes to the thread pool
+    bool failed = false;
+
+    int ringFd = -1;
+    void *sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void *cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    io_uring_cqe *cqes = nullptr;
+    unsigned cqMask = 0;
+    unsigned cqEntries = 0;
+
+    std::unique_ptr<CompletionThread> reaper;
+};
+
+// The largest transfer passed to a single read or write submission.
+static const qint64 IoUringMaxTransfer = Q_INT64_C(1) << 30;
+
+static inline unsigned loadAcquire(const unsigned *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(unsigned *p, unsigned value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+bool QFileAsyncIOUring::initialize(unsigned entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = int(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd < 0)
+        return false;
+
+    // IORING_OP_READ and IORING_OP_WRITE need Linux 5.6, which is also the
+    // first release that can be probed for supported operations.
+    const unsigned probeOps = IORING_OP_WRITE + 1;
+    alignas(io_uring_probe) char probeBuffer[sizeof(io_uring_probe)
+                                             + probeOps * sizeof(io_uring_probe_op)];
+    memset(probeBuffer, 0, sizeof(probeBuffer));
+    auto probe = reinterpret_cast<io_uring_probe *>(probeBuffer);
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, probeOps) < 0
+            || probe->last_op < IORING_OP_WRITE
+            || !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)
+            || !(probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED)) {
+        return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+    sqRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+        return false;
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cqRing = sqRing;
+    } else {
+        cqRing = ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+            return false;
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, ringFd,
+                                              IORING_OFF_SQES));
+    if (sqes == MAP_FAILED)
+        return false;
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqEntries = params.cq_entries;
+
+    reaper.reset(new CompletionThread(this));
+    reaper->setObjectName(QStringLiteral("Qt file I/O completion thread"));
+    reaper->start();
+    return true;
+}
+
+QFileAsyncIOUring::~QFileAsyncIOUring()
+{
+    if (reaper) {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        // wake the completion thread up with an operation it does not own
+        const unsigned tail = *sqTail;
+        io_uring_sqe *sqe = &sqes[tail & sqMask];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = 0;
+        sqArray[tail & sqMask] = tail & sqMask;
+        storeRelease(sqTail, tail + 1);
+        const bool woken = submitLocked(1);
+        locker.unlock();
+        // A failed ring might not wake the completion thread up anymore. It
+        // still uses the ring then, so leak both rather than pull it away.
+        if (!woken && !reaper->wait(5000)) {
+            qWarning("QFileAsyncIO: Completion thread did not stop");
+            reaper.release();
+            return;
+        }
+        reaper->wait();
+    }
+
+    if (sqes != MAP_FAILED)
+        ::munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing)
+        ::munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+        ::munmap(sqRing, sqRingSize);
+    if (ringFd != -1)
+        qt_safe_close(ringFd);
+}
+
+void QFileAsyncIOUring::submit(QFileAsyncOperation *op)
+{
+    QMutexLocker locker(&mutex);
+    if (failed) {
+        threadPool()->start([op]() { runBlocking(op); });
+        return;
+    }
+    if (!backlog.isEmpty() || !queueLocked(op)) {
+        backlog.enqueue(op);
+        return;
+    }
+    if (!submitLocked(1))
+        failLocked();
+}
+
+// Places the next chunk of op into the submission queue. Returns false if
+// the completion queue could overflow with another request in flight.
+bool QFileAsyncIOUring::queueLocked(QFileAsyncOperation *op)
+{
+    // one slot stays reserved for the wake-up request of the destructor
+    if (inFlight + 1 >= cqEntries || *sqTail - loadAcquire(sqHead) + 1 >= sqEntries)
+        return false;
+
+    const unsigned tail = *sqTail;
+    const unsigned index = tail & sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = op->handle->fd;
+    sqe->off = quint64(op->offset + op->transferred);
+    if (op->type == QFileAsyncOperation::Read) {
+        sqe->opcode = IORING_OP_READ;
+        sqe->addr = quintptr(op->buffer.data() + op->transferred);
+        sqe->len = unsigned(qMin(op->buffer.size() - op->transferred, IoUringMaxTransfer));
+    } else {
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->addr = quintptr(op->buffer.constData() + op->transferred);
+        sqe->len = unsigned(qMin(op->buffer.size() - op->transferred, IoUringMaxTransfer));
+    }
+    sqe->user_data = quintptr(op);
+    sqArray[index] = index;
+    storeRelease(sqTail, tail + 1);
+    ++inFlight;
+    return true;
+}
+
+// Returns false if the kernel refused to take the requests.
+bool QFileAsyncIOUring::submitLocked(unsigned count)
+{
+    while (count) {
+        const long ret = syscall(__NR_io_uring_enter, ringFd, count, 0, 0, nullptr, 0);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                continue;
+            qErrnoWarning("QFileAsyncIO: io_uring_enter() failed, falling back to a thread pool");
+            return false;
+        }
+        count -= unsigned(ret);
+    }
+    return true;
+}
+
+// Gives up on the ring: takes back the requests the kernel has not picked up
+// yet and moves them, the backlog and all later requests to the thread pool.
+// The requests the kernel already has still complete through the ring.
+void QFileAsyncIOUring::failLocked()
+{
+    if (failed)
+        return;
+    failed = true;
+
+    // Without SQPOLL the kernel only consumes submissions inside
+    // io_uring_enter(), which is never called with to_submit > 0 outside
+    // of the mutex.
+    const unsigned head = loadAcquire(sqHead);
+    for (unsigned i = head; i != *sqTail; ++i) {
+        const io_uring_sqe &sqe = sqes[sqArray[i & sqMask]];
+        auto op = reinterpret_cast<QFileAsyncOperation *>(quintptr(sqe.user_data));
+        if (!op)
+            continue;
+        --inFlight;
+        threadPool()->start([op]() { runBlocking(op); });
+    }
+    storeRelease(sqTail, head);
+
+    while (!backlog.isEmpty()) {
+        QFileAsyncOperation *op = backlog.dequeue();
+        threadPool()->start([op]() { runBlocking(op); });
+    }
+}
+
+void QFileAsyncIOUring::reapCompletions()
+{
+    QVarLengthArray<QFileAsyncOperation *, 64> finished;
+    bool canWait = true;
+    forever {
+        if (canWait) {
+            const long ret = syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS,
+                                     nullptr, 0);
+            if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                qErrnoWarning("QFileAsyncIO: io_uring_enter() failed, falling back to a thread pool");
+                canWait = false;
+                QMutexLocker locker(&mutex);
+                failLocked();
+            }
+        } else {
+            // The kernel keeps posting the completions of the requests it
+            // has, it just cannot be waited for; poll the ring for them.
+            QThread::msleep(1);
+        }
+
+        QMutexLocker locker(&mutex);
+        unsigned head = *cqHead;
+        const unsigned tail = loadAcquire(cqTail);
+        unsigned resubmit = 0;
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes[head & cqMask];
+            auto op = reinterpret_cast<QFileAsyncOperation *>(quintptr(cqe.user_data));
+            if (!op)
+                continue;
+            --inFlight;
+
+            const int result = cqe.res;
+            bool again = result == -EINTR || result == -EAGAIN;
+            if (result < 0 && !again) {
+                op->transferred = result;
+                finished.append(op);
+                continue;
+            }
+            if (result > 0) {
+                op->transferred += result;
+                // short transfers continue until the end of the file is reached
+                again = op->transferred < op->buffer.size();
+            }
+            if (!again)
+                finished.append(op);
+            else if (failed)
+                threadPool()->start([op]() { runBlocking(op); });
+            else
+                backlog.prepend(op);
+        }
+        storeRelease(cqHead, head);
+
+        while (!failed && !backlog.isEmpty() && queueLocked(backlog.head())) {
+            backlog.dequeue();
+            ++resubmit;
+        }
+        if (resubmit && !submitLocked(resubmit))
+            failLocked();
+        // once the ring failed, nothing is going to be submitted to it again
+        const bool done = (stopping || failed) && inFlight == 0 && backlog.isEmpty();
+        locker.unlock();
+
+        // report outside of the lock, continuations may start new requests
+        for (QFileAsyncOperation *op : qAsConst(finished)) {
+            op->finish(op->transferred);
+            delete op;
+        }
+        finished.clear();
+
+        if (done)
+            return;
+    }
+}
+#endif // QT_CONFIG(io_uring)
+
+QFileAsyncIO::QFileAsyncIO()
+    = default;
+
+QFileAsyncIO::~QFileAsyncIO()
+    = default;
+
+namespace {
+class QFileAsyncThreadPool : public QThreadPool
+{
+public:
+    QFileAsyncThreadPool()
+    {
+        // the threads mostly block in the kernel, so do not limit them to
+        // the number of cores
+        setMaxThreadCount(qMax(8, QThread::idealThreadCount()));
+    }
+};
+
+struct QFileAsyncIOHolder
+{
+    QFileAsyncIOHolder()
+    {
+#if QT_CONFIG(io_uring)
+        if (!qEnvironmentVariableIsSet("QT_NO_IO_URING"))
+            io.reset(QFileAsyncIO::create(QFileAsyncIO::IoUringBackend));
+#endif
+        if (!io)
+            io.reset(QFileAsyncIO::create(QFileAsyncIO::ThreadPoolBackend));
+    }
+
+    std::unique_ptr<QFileAsyncIO> io;
+};
+}
+
+Q_GLOBAL_STATIC(QFileAsyncThreadPool, asyncThreadPool)
+Q_GLOBAL_STATIC(QFileAsyncIOHolder, asyncIO)
+
+QFileAsyncIO *QFileAsyncIO::instance()
+{
+    QFileAsyncIOHolder *holder = asyncIO();
+    return holder ? holder->io.get() : nullptr;
+}
+
+/*
+    Returns a new dispatcher that uses \a backend, or \nullptr if that
+    backend is not available on this system.
+*/
+QFileAsyncIO *QFileAsyncIO::create(Backend backend)
+{
+    switch (backend) {
+    case ThreadPoolBackend:
+        return new QFileAsyncIOThreadPool;
+    case IoUringBackend:
+#if QT_CONFIG(io_uring)
+        {
+            std::unique_ptr<QFileAsyncIOUring> io(new QFileAsyncIOUring);
+            if (io->initialize(256))
+                return io.release();
+        }
+#endif
+        break;
+    }
+    return nullptr;
+}
+
+QThreadPool *QFileAsyncIO::threadPool()
+{
+    return asyncThreadPool();
+}
+
+QFuture<QByteArray> QFileAsyncIO::read(const QSharedPointer<QFileAsyncHandle> &handle,
+                                       qint64 offset, qint64 maxSize)
+{
+    auto op = new QFileAsyncOperation(QFileAsyncOperation::Read, offset);
+    op->readInterface.reportStarted();
+    QFuture<QByteArray> future = op->readInterface.future();
+    if (!handle) {
+        op->finish(-1);
+        delete op;
+        return future;
+    }
+    op->handle = handle;
+    op->buffer.resize(int(qMin(maxSize, qint64(MaxByteArraySize - 1))));
+    submit(op);
+    return future;
+}
+
+QFuture<qint64> QFileAsyncIO::write(const QSharedPointer<QFileAsyncHandle> &handle,
+                                    qint64 offset, const QByteArray &data)
+{
+    auto op = new QFileAsyncOperation(QFileAsyncOperation::Write, offset);
+    op->writeInterface.reportStarted();
+    QFuture<qint64> future = op->writeInterface.future();
+    if (!handle) {
+        op->finish(-1);
+        delete op;
+        return future;
+    }
+    op->handle = handle;
+    op->buffer = data;
+    submit(op);
+    return future;
+}
+
+// Transfers up to size bytes of op at position with one blocking call.
+// Returns the number of bytes transferred, 0 at the end of the file, or -1.
+static qint64 transferAt(QFileAsyncOperation *op, qint64 position, qint64 size)
+{
+    const bool isRead = op->type == QFileAsyncOperation::Read;
+#if defined(Q_OS_WIN)
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = DWORD(position);
+    overlapped.OffsetHigh = DWORD(position >> 32);
+    DWORD done = 0;
+    BOOL ok;
+    if (isRead)
+        ok = ReadFile(op->handle->handle, op->buffer.data() + op->transferred, DWORD(size),
+                      &done, &overlapped);
+    else
+        ok = WriteFile(op->handle->handle, op->buffer.constData() + op->transferred, DWORD(size),
+                       &done, &overlapped);
+    if (!ok)
+        return isRead && GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+    return done;
+#elif defined(Q_OS_UNIX)
+    qint64 ret;
+    if (isRead)
+        EINTR_LOOP(ret, ::pread(op->handle->fd, op->buffer.data() + op->transferred,
+                                size_t(size), QT_OFF_T(position)));
+    else
+        EINTR_LOOP(ret, ::pwrite(op->handle->fd, op->buffer.constData() + op->transferred,
+                                 size_t(size), QT_OFF_T(position)));
+    return ret;
+#else
+    Q_UNUSED(isRead);
+    Q_UNUSED(position);
+    Q_UNUSED(size);
+    return -1;
+#endif
+}
+
+// Performs op with blocking calls and finishes it. Runs on the thread pool.
+void QFileAsyncIO::runBlocking(QFileAsyncOperation *op)
+{
+    std::unique_ptr<QFileAsyncOperation> guard(op);
+    qint64 result = 0;
+    while (op->transferred < op->buffer.size()) {
+        const qint64 size = op->buffer.size() - op->transferred;
+        result = transferAt(op, op->offset + op->transferred, size);
+        if (result <= 0)
+            break;
+        op->transferred += result;
+    }
+    op->finish(result);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFILEASYNCIO_P_H
+#define QFILEASYNCIO_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qsharedpointer.h>
+
+QT_REQUIRE_CONFIG(future);
+
+QT_BEGIN_NAMESPACE
+
+class QThreadPool;
+
+// A private duplicate of a file device's native descriptor (a handle of
+// its own to the same file on Windows). Pending operations hold a reference
+// to it, so that closing the device does not pull the descriptor away from
+// requests that are still in flight.
+class QFileAsyncHandle
+{
+public:
+#ifdef Q_OS_WIN
+    explicit QFileAsyncHandle(Qt::HANDLE handle) : handle(handle) {}
+#else
+    explicit QFileAsyncHandle(int fd) : fd(fd) {}
+#endif
+    ~QFileAsyncHandle();
+
+#ifdef Q_OS_WIN
+    const Qt::HANDLE handle;
+#else
+    const int fd;
+#endif
+
+private:
+    Q_DISABLE_COPY(QFileAsyncHandle)
+};
+
+struct QFileAsyncOperation
+{
+    enum Type { Read, Write };
+
+    QFileAsyncOperation(Type type, qint64 offset)
+        : type(type), offset(offset)
+    {}
+
+    // Reports the result; a negative result fails the operation, which
+    // cancels its future.
+    void finish(qint64 result);
+
+    Type type;
+    qint64 offset;
+    qint64 transferred = 0;
+
+    QSharedPointer<QFileAsyncHandle> handle;
+
+    // the data read so far, or the data still to be written
+    QByteArray buffer;
+
+    QFutureInterface<QByteArray> readInterface;
+    QFutureInterface<qint64> writeInterface;
+};
+
+class Q_AUTOTEST_EXPORT QFileAsyncIO
+{
+public:
+    enum Backend {
+        ThreadPoolBackend,
+        IoUringBackend
+    };
+
+    virtual ~QFileAsyncIO();
+
+    static QFileAsyncIO *instance();
+    static QFileAsyncIO *create(Backend backend);
+
+    virtual Backend backend() const = 0;
+
+    // Takes ownership of op and finishes it asynchronously.
+    virtual void submit(QFileAsyncOperation *op) = 0;
+
+    // Operations without a handle fail right away.
+    QFuture<QByteArray> read(const QSharedPointer<QFileAsyncHandle> &handle,
+                             qint64 offset, qint64 maxSize);
+    QFuture<qint64> write(const QSharedPointer<QFileAsyncHandle> &handle,
+                          qint64 offset, const QByteArray &data);
+
+protected:
+    QFileAsyncIO();
+
+    static QThreadPool *threadPool();
+    static void runBlocking(QFileAsyncOperation *op);
+};
+
+QT_END_NAMESPACE
+
+#endif // QFILEASYNCIO_P_H
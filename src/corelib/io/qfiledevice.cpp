@@ -43,6 +43,22 @@
 #include "qfsfileengine_p.h"
 
 #include <private/qmemory_p.h>
+#include <private/qbytearray_p.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+#if QT_CONFIG(future)
+#include "qfileasyncio_p.h"
+#ifdef Q_OS_UNIX
+#include <private/qcore_unix_p.h>
+#endif
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#include <io.h>
+#endif
+#endif
 
 #ifdef QT_NO_QOBJECT
 #define tr(X) QString::fromLatin1(X)
@@ -329,6 +345,11 @@ void QFileDevice::close()
     // reset cached size
     d->cachedSize = 0;
 
+#if QT_CONFIG(future)
+    // pending asynchronous requests keep their own reference
+    d->asyncFileHandle.reset();
+#endif
+
     // keep earlier error from flush
     if (d->fileEngine->close() && flushed)
         unsetError();
@@ -738,6 +759,97 @@ bool QFileDevice::unmap(uchar *address)
     return false;
 }
 
+#ifdef Q_OS_UNIX
+namespace {
+struct QFileDeviceMapping
+{
+    void *address;
+    size_t length;
+};
+}
+
+static void unmapFileDeviceMapping(void *info)
+{
+    auto mapping = static_cast<QFileDeviceMapping *>(info);
+    ::munmap(mapping->address, mapping->length);
+    delete mapping;
+}
+#endif
+
+/*!
+    \since 5.15
+
+    Returns up to \a size bytes of the file starting at \a offset in a
+    QByteArray that refers to a read-only memory mapping of the file instead
+    of a copy of its contents. The result is shorter than \a size if the end
+    of the file is reached.
+
+    The mapping is shared by all copies of the returned QByteArray and
+    released when the last of them is destroyed, independently of this
+    device: it stays valid after the file is closed or destroyed. This allows
+    passing large files to functions like QJsonDocument::fromJson(),
+    QCborStreamReader or QXmlStreamReader without reading them into memory
+    first. As with QByteArray::fromRawData(), modifying the returned array
+    creates a deep copy, and the array is not guaranteed to be
+    '\\0'-terminated.
+
+    If the file cannot be mapped, for instance because it is a resource or
+    has no native file handle, the data is read into a regular QByteArray
+    instead. The position of the device is not changed.
+
+    The file must be open for reading. Returns a null QByteArray and sets
+    error() if the data cannot be accessed.
+
+    \note Truncating the file while the mapping is in use results in
+    undefined behavior.
+
+    \sa map(), QByteArray::fromRawData()
+*/
+QByteArray QFileDevice::mapToByteArray(qint64 offset, qint64 size)
+{
+    Q_D(QFileDevice);
+    if (!isOpen() || !isReadable()) {
+        d->setError(PermissionsError, EACCES);
+        return QByteArray();
+    }
+    if (offset < 0 || size < 0 || size >= MaxByteArraySize) {
+        d->setError(UnspecifiedError, EINVAL);
+        return QByteArray();
+    }
+
+    unsetError();
+    if (!d->ensureFlushed())
+        return QByteArray();
+
+#ifdef Q_OS_UNIX
+    const int fd = handle();
+    if (fd != -1 && !isSequential()) {
+        // never map pages beyond the end of the file
+        const qint64 available = this->size() - offset;
+        if (available <= 0)
+            return QByteArray("");
+        size = qMin(size, available);
+
+        const qint64 extra = offset % getpagesize();
+        QFileDeviceMapping mapping = { MAP_FAILED, size_t(size + extra) };
+        mapping.address = QT_MMAP(nullptr, mapping.length, PROT_READ, MAP_SHARED, fd,
+                                  QT_OFF_T(offset - extra));
+        if (mapping.address != MAP_FAILED) {
+            return qByteArrayFromExternalData(static_cast<const char *>(mapping.address) + extra,
+                                              int(size), unmapFileDeviceMapping,
+                                              new QFileDeviceMapping(mapping));
+        }
+    }
+#endif
+
+    const qint64 oldPos = pos();
+    if (!seek(offset))
+        return QByteArray();
+    QByteArray data = read(size);
+    seek(oldPos);
+    return data;
+}
+
 /*!
     \enum QFileDevice::FileTime
     \since 5.10
@@ -808,6 +920,118 @@ bool QFileDevice::setFileTime(const QDateTime &newDate, QFileDevice::FileTime fi
     return true;
 }
 
+#if QT_CONFIG(future)
+QSharedPointer<QFileAsyncHandle> QFileDevicePrivate::asyncHandle()
+{
+    if (asyncFileHandle)
+        return asyncFileHandle;
+    const int fd = fileEngine->handle();
+    if (fd == -1)
+        return asyncFileHandle;
+#if defined(Q_OS_WIN)
+    // ReOpenFile() opens the file object itself again, not its name, and
+    // the new handle has a file pointer of its own
+    const HANDLE handle = HANDLE(_get_osfhandle(fd));
+    if (handle != INVALID_HANDLE_VALUE) {
+        DWORD access = 0;
+        if (openMode & QIODevice::ReadOnly)
+            access |= GENERIC_READ;
+        if (openMode & QIODevice::WriteOnly)
+            access |= GENERIC_WRITE;
+        const HANDLE reopened = ReOpenFile(handle, access,
+                                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                           0);
+        if (reopened != INVALID_HANDLE_VALUE)
+            asyncFileHandle = QSharedPointer<QFileAsyncHandle>::create(reopened);
+    }
+#elif defined(Q_OS_UNIX)
+    const int dupFd = qt_safe_dup(fd);
+    if (dupFd != -1)
+        asyncFileHandle = QSharedPointer<QFileAsyncHandle>::create(dupFd);
+#endif
+    return asyncFileHandle;
+}
+
+/*!
+    \since 5.15
+
+    Starts reading up to \a maxSize bytes from the file at position
+    \a offset without blocking the calling thread, and returns a QFuture
+    that receives the data once it has been read. The result is shorter
+    than \a maxSize if the end of the file is reached, and empty if
+    \a offset is at or beyond the end of the file.
+
+    If the read fails, the future is canceled and its result is empty. Once
+    the future has finished, QFuture::isCanceled() tells a failure apart
+    from the end of the file; QFutureWatcher emits
+    \l{QFutureWatcher::}{canceled()} before \l{QFutureWatcher::}{finished()}.
+    This is also the case if the file has no native file descriptor, as
+    for Qt resources: asynchronous requests always go to the file the device
+    has open, through a duplicate of that descriptor.
+
+    The file must be open for reading. The read does not go through the
+    buffers of the device and does not change pos(), so several reads and
+    writes can be in flight at the same time. Data that was written with
+    write() is flushed before the read is started.
+
+    On Linux the request is submitted to the kernel with io_uring when
+    possible, so hundreds of requests can be pending without a thread for
+    each of them; elsewhere it runs on an internal thread pool. Closing the
+    file does not abort requests that are already pending.
+
+    Use QFutureWatcher to get notified when the data is available.
+
+    \sa writeAsync(), read()
+*/
+QFuture<QByteArray> QFileDevice::readAsync(qint64 offset, qint64 maxSize)
+{
+    Q_D(QFileDevice);
+    if (!isOpen() || !isReadable() || offset < 0 || maxSize < 0) {
+        if (!isOpen())
+            qWarning("QFileDevice::readAsync: IODevice is not open");
+        else if (!isReadable())
+            qWarning("QFileDevice::readAsync: WriteOnly device");
+        else
+            qWarning("QFileDevice::readAsync: Invalid offset or size");
+        return QFileAsyncIO::instance()->read(QSharedPointer<QFileAsyncHandle>(), offset, 0);
+    }
+    d->ensureFlushed();
+    return QFileAsyncIO::instance()->read(d->asyncHandle(), offset, maxSize);
+}
+
+/*!
+    \since 5.15
+
+    Starts writing \a data to the file at position \a offset without
+    blocking the calling thread, and returns a QFuture that receives the
+    number of bytes written. If an error occurs, the future is canceled and
+    its result is -1, as with readAsync().
+
+    The file must be open for writing. Like readAsync(), the write does not
+    go through the buffers of the device and does not change pos().
+    Requests that overlap in the file are not ordered with respect to each
+    other. On files opened with QIODevice::Append the data may be appended
+    regardless of \a offset.
+
+    \sa readAsync(), write()
+*/
+QFuture<qint64> QFileDevice::writeAsync(qint64 offset, const QByteArray &data)
+{
+    Q_D(QFileDevice);
+    if (!isOpen() || !isWritable() || offset < 0) {
+        if (!isOpen())
+            qWarning("QFileDevice::writeAsync: IODevice is not open");
+        else if (!isWritable())
+            qWarning("QFileDevice::writeAsync: ReadOnly device");
+        else
+            qWarning("QFileDevice::writeAsync: Invalid offset");
+        return QFileAsyncIO::instance()->write(QSharedPointer<QFileAsyncHandle>(), offset, data);
+    }
+    d->ensureFlushed();
+    return QFileAsyncIO::instance()->write(d->asyncHandle(), offset, data);
+}
+#endif // QT_CONFIG(future)
+
 QT_END_NAMESPACE
 
 #ifndef QT_NO_QOBJECT
@@ -52,6 +52,7 @@
 //
 
 #include "private/qiodevice_p.h"
+#include <QtCore/qsharedpointer.h>
 
 #include <memory>
 
@@ -59,6 +60,9 @@ QT_BEGIN_NAMESPACE
 
 class QAbstractFileEngine;
 class QFSFileEngine;
+#if QT_CONFIG(future)
+class QFileAsyncHandle;
+#endif
 
 class QFileDevicePrivate : public QIODevicePrivate
 {
@@ -84,6 +88,12 @@ protected:
     QFileDevice::FileError error;
 
     bool lastWasWrite;
+
+#if QT_CONFIG(future)
+    QSharedPointer<QFileAsyncHandle> asyncHandle();
+
+    QSharedPointer<QFileAsyncHandle> asyncFileHandle;
+#endif
 };
 
 inline bool QFileDevicePrivate::ensureFlushed() const
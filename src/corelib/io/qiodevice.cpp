@@ -1751,6 +1751,30 @@ qint64 QIODevice::write(const char *data)
     \sa read(), writeData()
 */
 
+/*!
+    \since 5.15
+    \overload
+
+    Writes the contents of \a buffers to the device, in order, as if they
+    were one contiguous block of data. Returns the number of bytes that were
+    actually written, or -1 if an error occurred before anything was
+    written.
+
+    Sockets keep references to the buffers instead of copying them into
+    their write buffer, and send several buffers with a single system call
+    where the platform allows it. This is useful for protocols that write
+    a header and a body that are kept in separate byte arrays. Other
+    devices write the buffers one after the other.
+
+    \sa read(), writeData()
+*/
+qint64 QIODevice::write(const QByteArrayList &buffers)
+{
+    Q_D(QIODevice);
+    CHECK_WRITABLE(write, qint64(-1));
+    return d->writeVector(buffers);
+}
+
 /*!
     Puts the character \a c back into the device, and decrements the
     current position unless the position is 0. This function is
@@ -2009,6 +2033,31 @@ qint64 QIODevicePrivate::skipByReading(qint64 maxSize)
     return readSoFar;
 }
 
+/*!
+    \internal
+
+    Writes \a buffers one after the other, stopping at the first one that
+    could not be written completely. Devices that can do better, such as
+    sockets, reimplement this.
+*/
+qint64 QIODevicePrivate::writeVector(const QByteArrayList &buffers)
+{
+    Q_Q(QIODevice);
+
+    qint64 writtenSoFar = 0;
+    for (const QByteArray &buffer : buffers) {
+        if (buffer.isEmpty())
+            continue;
+        const qint64 written = q->write(buffer);
+        if (written < 0)
+            return writtenSoFar ? writtenSoFar : written;
+        writtenSoFar += written;
+        if (written < buffer.size())
+            break;
+    }
+    return writtenSoFar;
+}
+
 /*!
     \internal
 */
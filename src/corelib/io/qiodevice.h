@@ -47,6 +47,7 @@
 #include <QtCore/qobjectdefs.h>
 #include <QtCore/qscopedpointer.h>
 #endif
+#include <QtCore/qcontainerfwd.h>
 #include <QtCore/qstring.h>
 
 #ifdef open
@@ -135,6 +136,7 @@ public:
     qint64 write(const char *data);
     inline qint64 write(const QByteArray &data)
     { return write(data.constData(), data.size()); }
+    qint64 write(const QByteArrayList &buffers);
 
     qint64 peek(char *data, qint64 maxlen);
     QByteArray peek(qint64 maxlen);
@@ -97,6 +97,7 @@ public:
         inline qint64 nextDataBlockSize() const { return (m_buf ? m_buf->nextDataBlockSize() : Q_INT64_C(0)); }
         inline const char *readPointer() const { return (m_buf ? m_buf->readPointer() : nullptr); }
         inline const char *readPointerAtPosition(qint64 pos, qint64 &length) const { Q_ASSERT(m_buf); return m_buf->readPointerAtPosition(pos, length); }
+        inline int readPointers(const char **data, qint64 *sizes, int maxCount) const { return (m_buf ? m_buf->readPointers(data, sizes, maxCount) : 0); }
         inline void free(qint64 bytes) { Q_ASSERT(m_buf); m_buf->free(bytes); }
         inline char *reserve(qint64 bytes) { Q_ASSERT(m_buf); return m_buf->reserve(bytes); }
         inline char *reserveFront(qint64 bytes) { Q_ASSERT(m_buf); return m_buf->reserveFront(bytes); }
@@ -177,6 +178,7 @@ public:
     qint64 skipByReading(qint64 maxSize);
     // ### Qt6: consider replacing with a protected virtual QIODevice::skipData().
     virtual qint64 skip(qint64 maxSize);
+    virtual qint64 writeVector(const QByteArrayList &buffers);
 
 #ifdef QT_NO_QOBJECT
     QIODevice *q_ptr;
@@ -157,6 +157,11 @@ unix|integrity {
 
     qtConfig(poll_select): SOURCES += kernel/qpoll.cpp
 
+    qtConfig(epoll) {
+        SOURCES += kernel/qeventdispatcher_epoll.cpp
+        HEADERS += kernel/qeventdispatcher_epoll_p.h
+    }
+
     qtConfig(glib) {
         SOURCES += \
             kernel/qeventdispatcher_glib.cpp
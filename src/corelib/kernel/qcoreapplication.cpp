@@ -349,7 +349,9 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
-    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    // queued meta calls not yet moved to the postEventList count as one
+    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset
+            + (currentThreadData->queuedMetaCalls.isEmpty() ? 0 : 1);
 }
 
 QAbstractEventDispatcher *QCoreApplicationPrivate::eventDispatcher = nullptr;
@@ -501,6 +503,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->flushQueuedMetaCalls();
         for (int i = 0; i < thisThreadData->postEventList.size(); ++i) {
             const QPostEvent &pe = thisThreadData->postEventList.at(i);
             if (pe.event) {
@@ -1584,6 +1587,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QThreadData *data = locker.threadData;
 
+    // events posted by this thread must not overtake its earlier queued meta calls
+    data->flushQueuedMetaCalls();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1632,6 +1638,55 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         dispatcher->wakeUp();
 }
 
+/*!
+    \internal
+
+    Posts \a event, created by a queued connection, to \a receiver with
+    Qt::NormalEventPriority. Unlike postEvent(), this does not lock the
+    receiving thread's postEventList: the event is pushed onto a lock-free
+    list that the receiving thread moves into its postEventList before it
+    next sends posted events, and the thread is woken up only if that list
+    was empty. Senders emitting many signals to another thread therefore
+    do not contend with it (or each other) for the postEventList mutex.
+
+    Must be called with signalSlotLock(receiver) held, which keeps
+    \a receiver from being destroyed meanwhile.
+*/
+void QCoreApplicationPrivate::postQueuedMetaCall(QObject *receiver, QMetaCallEvent *event)
+{
+    Q_TRACE_SCOPE(QCoreApplication_postEvent, receiver, event, event->type());
+
+    QObjectPrivate *d = QObjectPrivate::get(receiver);
+    QThreadData *data = d->threadData.loadAcquire();
+    if (!data) {
+        // posting during destruction? just delete the event to prevent a leak
+        delete event;
+        return;
+    }
+
+    d->queuedMetaCalls.ref();
+    if (data->queuedMetaCalls.push(receiver, event)) {
+        // first event since the thread last flushed the list
+        QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire();
+        if (dispatcher)
+            dispatcher->wakeUp();
+    }
+
+    if (Q_UNLIKELY(d->threadData.loadAcquire() != data || data->movingObjects.loadAcquire())) {
+        // The receiver may be a child of an object being moved to another
+        // thread (we only hold the receiver's signalSlotLock, not the
+        // parent's). The push synchronized with the first flush of the old
+        // thread's list in QObjectPrivate::setThreadData_helper(), so if the
+        // event missed that flush, we see the receiver's new thread data or
+        // the move in progress. Waiting for the move to finish keeps our
+        // next call from reaching the new thread before this event is
+        // forwarded there; flushing forwards it before the receiver can be
+        // destroyed in its new thread.
+        const auto locker = qt_scoped_lock(data->postEventList.mutex);
+        data->flushQueuedMetaCalls();
+    }
+}
+
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1729,6 +1784,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->flushQueuedMetaCalls();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1883,6 +1939,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     QThreadData *data = locker.threadData;
+    data->flushQueuedMetaCalls();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -0,0 +1,536 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <stdio.h>
+
+#include <sys/timerfd.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QEventDispatcherEpoll is an alternative to QEventDispatcherUNIX for
+    Linux. Instead of building a pollfd array from all socket notifiers on
+    every iteration, it keeps them registered with the kernel through
+    epoll(7), so that the cost of an iteration depends on the number of
+    ready file descriptors only. The next timer deadline is programmed into
+    a timerfd(2), which is part of the epoll set, and wake-ups use the same
+    eventfd(2) (or pipe) as QEventDispatcherUNIX.
+
+    It is used when the QT_EVENT_DISPATCHER_EPOLL environment variable is
+    set to a positive number.
+
+    Because epoll tracks open files rather than file descriptors, a socket
+    notifier must be disabled or deleted before its file descriptor is
+    closed, as QAbstractSocket and the other Qt classes do.
+*/
+
+static const char *socketType(QSocketNotifier::Type type)
+{
+    switch (type) {
+    case QSocketNotifier::Read:
+        return "Read";
+    case QSocketNotifier::Write:
+        return "Write";
+    case QSocketNotifier::Exception:
+        return "Exception";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static quint32 toEpollEvents(short pollEvents)
+{
+    quint32 result = 0;
+    if (pollEvents & POLLIN)
+        result |= EPOLLIN;
+    if (pollEvents & POLLOUT)
+        result |= EPOLLOUT;
+    if (pollEvents & POLLPRI)
+        result |= EPOLLPRI;
+    return result;
+}
+
+static bool addToEpoll(int epollFd, int fd)
+{
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate()
+{
+    if (Q_UNLIKELY(threadPipe.init() == false))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot continue without a thread pipe");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (Q_UNLIKELY(epollFd == -1 || timerFd == -1
+                   || !addToEpoll(epollFd, threadPipe.fds[0])
+                   || !addToEpoll(epollFd, timerFd))) {
+        qFatal("QEventDispatcherEpollPrivate(): Cannot create the epoll instance: %s",
+               strerror(errno));
+    }
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    if (baseEpollFd != -1)
+        qt_safe_close(baseEpollFd);
+    qt_safe_close(timerFd);
+    qt_safe_close(epollFd);
+
+    // cleanup timers
+    qDeleteAll(timerList);
+}
+
+/*!
+    \internal
+
+    Brings the epoll registration of \a fd in line after the events its
+    notifiers are interested in changed from \a oldEvents to \a newEvents.
+*/
+void QEventDispatcherEpollPrivate::updateSocketNotifiers(int fd, short oldEvents, short newEvents)
+{
+    if (oldEvents == newEvents)
+        return;
+
+    if (alwaysReadyFds.contains(fd)) {
+        if (!newEvents)
+            alwaysReadyFds.removeOne(fd);
+        return;
+    }
+
+    epoll_event event = {};
+    event.events = toEpollEvents(newEvents);
+    event.data.fd = fd;
+
+    int op = !oldEvents ? EPOLL_CTL_ADD : !newEvents ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+    if (epoll_ctl(epollFd, op, fd, &event) == 0)
+        return;
+
+    switch (errno) {
+    case ENOENT:
+        // the file descriptor was closed and reused without disabling its
+        // notifiers first; register the new file
+        if (op == EPOLL_CTL_MOD && epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0)
+            return;
+        break;
+    case EEXIST:
+        if (op == EPOLL_CTL_ADD && epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == 0)
+            return;
+        break;
+    case EPERM:
+        // epoll does not support regular files and directories, which
+        // poll() always reports as ready; emulate that
+        if (op == EPOLL_CTL_ADD) {
+            alwaysReadyFds.append(fd);
+            return;
+        }
+        break;
+    }
+
+    if (op == EPOLL_CTL_DEL)
+        return; // the file descriptor was already closed; nothing left to remove
+
+    qWarning("QSocketNotifier: Invalid socket %d, cannot watch it: %s", fd, strerror(errno));
+}
+
+/*!
+    \internal
+
+    Programs the timer file descriptor to expire after \a timeout, or
+    disarms it if \a timeout is null.
+*/
+void QEventDispatcherEpollPrivate::armTimer(const timespec *timeout)
+{
+    itimerspec spec = {};
+    if (timeout) {
+        // the deadline only changes when timers are started, stopped or
+        // activated, so avoid reprogramming it on every iteration
+        const timespec deadline = timerList.currentTime + *timeout;
+        if (timerArmed && deadline == timerDeadline)
+            return;
+        timerDeadline = deadline;
+        spec.it_value = *timeout;
+    } else if (!timerArmed) {
+        return;
+    }
+
+    timerArmed = timeout != nullptr;
+    if (timerfd_settime(timerFd, 0, &spec, nullptr) == -1)
+        perror("QEventDispatcherEpoll: timerfd_settime");
+}
+
+void QEventDispatcherEpollPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+
+    if (pendingNotifiers.contains(notifier))
+        return;
+
+    pendingNotifiers << notifier;
+}
+
+void QEventDispatcherEpollPrivate::markPendingSocketNotifiers(int fd, quint32 events)
+{
+    auto it = socketNotifiers.constFind(fd);
+    if (it == socketNotifiers.cend())
+        return;
+
+    const QSocketNotifierSetUNIX &sn_set = it.value();
+
+    static const struct {
+        QSocketNotifier::Type type;
+        quint32 flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      EPOLLIN  | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Write,     EPOLLOUT | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Exception, EPOLLPRI | EPOLLHUP | EPOLLERR }
+    };
+
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+        if (notifier && (events & n.flags))
+            setSocketNotifierPending(notifier);
+    }
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers()
+{
+    if (pendingNotifiers.isEmpty())
+        return 0;
+
+    int n_activated = 0;
+    QEvent event(QEvent::SockAct);
+
+    while (!pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_activated;
+    }
+
+    return n_activated;
+}
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate, parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{ }
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = static_cast<int>(notifier->socket());
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd];
+
+    if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = notifier;
+    d->updateSocketNotifiers(sockfd, oldEvents, sn_set.events());
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = static_cast<int>(notifier->socket());
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifier (fd %d) cannot be disabled from another thread.\n"
+                "(Notifier's thread is %s(%p), event dispatcher's thread is %s(%p), current thread is %s(%p))",
+                sockfd,
+                notifier->thread() ? notifier->thread()->metaObject()->className() : "QThread", notifier->thread(),
+                thread() ? thread()->metaObject()->className() : "QThread", thread(),
+                QThread::currentThread() ? QThread::currentThread()->metaObject()->className() : "QThread", QThread::currentThread());
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+
+    d->pendingNotifiers.removeOne(notifier);
+
+    auto i = d->socketNotifiers.find(sockfd);
+    if (i == d->socketNotifiers.end())
+        return;
+
+    QSocketNotifierSetUNIX &sn_set = i.value();
+
+    if (sn_set.notifiers[type] == nullptr)
+        return;
+
+    if (sn_set.notifiers[type] != notifier) {
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+        return;
+    }
+
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = nullptr;
+    const short newEvents = sn_set.events();
+
+    if (sn_set.isEmpty())
+        d->socketNotifiers.erase(i);
+
+    d->updateSocketNotifiers(sockfd, oldEvents, newEvents);
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(0);
+
+    // we are awake, broadcast it
+    emit awake();
+
+    auto threadData = d->threadData.loadRelaxed();
+    QCoreApplicationPrivate::sendPostedEvents(nullptr, 0, threadData);
+
+    const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
+    const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
+    const bool wait_for_events = flags & QEventLoop::WaitForMoreEvents;
+
+    const bool canWait = (threadData->canWaitLocked()
+                          && !d->interrupt.loadRelaxed()
+                          && wait_for_events);
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (d->interrupt.loadRelaxed())
+        return false;
+
+    int timeout = -1;
+    timespec wait_tm = { 0, 0 };
+
+    if (!canWait || (include_notifiers && !d->alwaysReadyFds.isEmpty())) {
+        timeout = 0;
+    } else if (include_timers && d->timerList.timerWait(wait_tm)) {
+        if (wait_tm.tv_sec == 0 && wait_tm.tv_nsec == 0)
+            timeout = 0;
+        else
+            d->armTimer(&wait_tm);
+    } else {
+        d->armTimer(nullptr);
+    }
+
+    int epollFd = d->epollFd;
+    if (!include_notifiers) {
+        if (d->baseEpollFd == -1) {
+            d->baseEpollFd = epoll_create1(EPOLL_CLOEXEC);
+            if (d->baseEpollFd == -1
+                    || !addToEpoll(d->baseEpollFd, d->threadPipe.fds[0])
+                    || !addToEpoll(d->baseEpollFd, d->timerFd)) {
+                perror("QEventDispatcherEpoll: epoll_create1");
+            }
+        }
+        epollFd = d->baseEpollFd;
+    }
+
+    int nevents = 0;
+
+    int ready = epoll_wait(epollFd, d->events, QEventDispatcherEpollPrivate::MaxEvents, timeout);
+    if (ready == -1 && errno != EINTR)
+        perror("epoll_wait");
+
+    for (int i = 0; i < ready; ++i) {
+        const epoll_event &event = d->events[i];
+        const int fd = event.data.fd;
+        if (fd == d->threadPipe.fds[0]) {
+            pollfd pfd = d->threadPipe.prepare();
+            pfd.revents = POLLIN;
+            nevents += d->threadPipe.check(pfd);
+        } else if (fd == d->timerFd) {
+            // the timers themselves are activated below
+            quint64 expirations;
+            while (::read(d->timerFd, &expirations, sizeof(expirations)) > 0) {}
+            d->timerArmed = false;
+        } else {
+            d->markPendingSocketNotifiers(fd, event.events);
+        }
+    }
+
+    if (include_notifiers) {
+        for (int fd : qAsConst(d->alwaysReadyFds))
+            d->markPendingSocketNotifiers(fd, EPOLLIN | EPOLLOUT);
+        nevents += d->activateSocketNotifiers();
+    }
+
+    if (include_timers)
+        nevents += d->timerList.activateTimers();
+
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+bool QEventDispatcherEpoll::hasPendingEvents()
+{
+    extern uint qGlobalPostedEventsCount(); // from qapplication.cpp
+    return qGlobalPostedEventsCount();
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->threadPipe.wakeUp();
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(1);
+    wakeUp();
+}
+
+void QEventDispatcherEpoll::flush()
+{ }
+
+QT_END_NAMESPACE
+
+#include "moc_qeventdispatcher_epoll_p.cpp"
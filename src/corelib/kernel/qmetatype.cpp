@@ -43,6 +43,8 @@
 #include "qdatetime.h"
 #include "qbytearray.h"
 #include "qreadwritelock.h"
+#include "qmutex.h"
+#include "qhash.h"
 #include "qstring.h"
 #include "qstringlist.h"
 #include "qvector.h"
@@ -619,8 +621,207 @@ Q_STATIC_ASSERT(std::is_trivial<QMetaTypeInterface>::value);
 Q_STATIC_ASSERT(std::is_standard_layout<QMetaTypeInterface>::value);
 
 Q_DECLARE_TYPEINFO(QCustomTypeInfo, Q_MOVABLE_TYPE);
-Q_GLOBAL_STATIC(QVector<QCustomTypeInfo>, customTypes)
-Q_GLOBAL_STATIC(QReadWriteLock, customTypesLock)
+/*
+    Custom types are registered rarely, mostly once per type at startup, but
+    they are looked up all the time: by name when connecting signals or
+    streaming QVariants, and by id whenever a queued argument is copied or
+    destroyed. Lookups therefore never lock. Published entries are immutable;
+    writers (serialized by \c lock) publish a modified copy instead, and the
+    old copy, like a reallocated entry array or name index, stays alive until
+    the registry is destroyed so that readers may keep using it.
+
+    The name index is an open-addressing hash table over the static type
+    names and the custom ones. Its slots only ever go from empty to
+    occupied; a custom entry that was unregistered or reused for another
+    name simply stops matching.
+*/
+class QCustomTypeRegistry
+{
+public:
+    QCustomTypeRegistry();
+    ~QCustomTypeRegistry();
+
+    int count() const { return size.loadAcquire(); }
+    const QCustomTypeInfo *at(int index) const;
+    const QCustomTypeInfo *info(int type) const
+    { return uint(type - QMetaType::User) < uint(count()) ? at(type - QMetaType::User) : nullptr; }
+    int lookup(const char *typeName, int length) const;
+
+    // the following require lock to be held
+    int insert(const QCustomTypeInfo &info);
+    void update(int index, const QCustomTypeInfo &info);
+    void remove(int index);
+
+    QMutex lock;
+
+private:
+    typedef QAtomicPointer<const QCustomTypeInfo> EntryPointer;
+    struct Entries
+    {
+        explicit Entries(int capacity) : capacity(capacity), data(new EntryPointer[capacity]) {}
+        ~Entries() { delete[] data; }
+        const int capacity;
+        EntryPointer * const data;
+    };
+    struct NameIndex
+    {
+        // a slot holds the index of a custom type plus one, minus the index
+        // into types[] plus one for a static type, or 0 when it is empty
+        explicit NameIndex(int capacity) : mask(capacity - 1), buckets(new QAtomicInt[capacity]) {}
+        ~NameIndex() { delete[] buckets; }
+        const uint mask;
+        QAtomicInt * const buckets;
+    };
+
+    const QCustomTypeInfo *publish(int index, const QCustomTypeInfo &info);
+    void addName(const QByteArray &typeName, int slot);
+    static void addName(NameIndex *index, uint hash, int slot);
+
+    QAtomicInt size;
+    QAtomicPointer<Entries> entries;
+    QAtomicPointer<NameIndex> nameIndex;
+
+    // writer state, protected by lock
+    int namesInIndex = 0;
+    QVector<int> freeIndexes;
+    QVector<const QCustomTypeInfo *> versions;
+    QVector<Entries *> retiredEntries;
+    QVector<NameIndex *> retiredIndexes;
+};
+
+static inline uint qMetaTypeNameHash(const char *typeName, int length)
+{
+    return qHashBits(typeName, size_t(length));
+}
+
+QCustomTypeRegistry::QCustomTypeRegistry()
+    : entries(new Entries(64)), nameIndex(new NameIndex(256))
+{
+    for (int i = 0; types[i].typeName; ++i)
+        addName(QByteArray::fromRawData(types[i].typeName, types[i].typeNameLength), -(i + 1));
+}
+
+QCustomTypeRegistry::~QCustomTypeRegistry()
+{
+    qDeleteAll(versions);
+    qDeleteAll(retiredEntries);
+    qDeleteAll(retiredIndexes);
+    delete entries.loadRelaxed();
+    delete nameIndex.loadRelaxed();
+}
+
+const QCustomTypeInfo *QCustomTypeRegistry::at(int index) const
+{
+    // the entry array is published before the size grows past its previous capacity
+    return entries.loadAcquire()->data[index].loadAcquire();
+}
+
+int QCustomTypeRegistry::lookup(const char *typeName, int length) const
+{
+    const NameIndex *index = nameIndex.loadAcquire();
+    for (uint i = qMetaTypeNameHash(typeName, length) & index->mask; ; i = (i + 1) & index->mask) {
+        const int slot = index->buckets[i].loadAcquire();
+        if (!slot)
+            return QMetaType::UnknownType;
+        if (slot < 0) {
+            const auto &type = types[-slot - 1];
+            if (length == type.typeNameLength && !memcmp(typeName, type.typeName, length))
+                return type.type;
+        } else {
+            const QCustomTypeInfo *info = at(slot - 1);
+            if (length == info->typeName.size() && !memcmp(typeName, info->typeName.constData(), length))
+                return info->alias >= 0 ? info->alias : slot - 1 + QMetaType::User;
+        }
+    }
+}
+
+const QCustomTypeInfo *QCustomTypeRegistry::publish(int index, const QCustomTypeInfo &info)
+{
+    const QCustomTypeInfo *version = new QCustomTypeInfo(info);
+    versions.append(version);
+    entries.loadRelaxed()->data[index].storeRelease(version);
+    return version;
+}
+
+int QCustomTypeRegistry::insert(const QCustomTypeInfo &info)
+{
+    int index;
+    if (!freeIndexes.isEmpty()) {
+        // reuse the lowest unregistered id, like before
+        const auto lowest = std::min_element(freeIndexes.begin(), freeIndexes.end());
+        index = *lowest;
+        freeIndexes.erase(lowest);
+        publish(index, info);
+    } else {
+        index = size.loadRelaxed();
+        Entries *current = entries.loadRelaxed();
+        if (index == current->capacity) {
+            Entries *grown = new Entries(current->capacity * 2);
+            for (int i = 0; i < index; ++i)
+                grown->data[i].storeRelaxed(current->data[i].loadRelaxed());
+            entries.storeRelease(grown);
+            retiredEntries.append(current);
+        }
+        publish(index, info);
+        size.storeRelease(index + 1);
+    }
+    addName(info.typeName, index + 1);
+    return index;
+}
+
+void QCustomTypeRegistry::update(int index, const QCustomTypeInfo &info)
+{
+    Q_ASSERT(info.typeName == at(index)->typeName);
+    publish(index, info);
+}
+
+void QCustomTypeRegistry::remove(int index)
+{
+    QCustomTypeInfo info = *at(index);
+    info.typeName.clear();
+    publish(index, info);
+    freeIndexes.append(index);
+}
+
+void QCustomTypeRegistry::addName(NameIndex *index, uint hash, int slot)
+{
+    uint i = hash & index->mask;
+    while (index->buckets[i].loadRelaxed())
+        i = (i + 1) & index->mask;
+    index->buckets[i].storeRelease(slot);
+}
+
+void QCustomTypeRegistry::addName(const QByteArray &typeName, int slot)
+{
+    NameIndex *index = nameIndex.loadRelaxed();
+    if ((namesInIndex + 1) * 4 > int(index->mask + 1) * 3) {
+        NameIndex *grown = new NameIndex(int(index->mask + 1) * 2);
+        QVector<bool> seen(size.loadRelaxed());
+        for (uint i = 0; i <= index->mask; ++i) {
+            const int existing = index->buckets[i].loadRelaxed();
+            if (existing < 0) {
+                const auto &type = types[-existing - 1];
+                addName(grown, qMetaTypeNameHash(type.typeName, type.typeNameLength), existing);
+            } else if (existing > 0) {
+                // drop unregistered names and duplicates left by reused ids
+                const QByteArray &name = at(existing - 1)->typeName;
+                if (name.isEmpty() || seen.at(existing - 1)) {
+                    --namesInIndex;
+                    continue;
+                }
+                seen[existing - 1] = true;
+                addName(grown, qMetaTypeNameHash(name.constData(), name.size()), existing);
+            }
+        }
+        nameIndex.storeRelease(grown);
+        retiredIndexes.append(index);
+        index = grown;
+    }
+    addName(index, qMetaTypeNameHash(typeName.constData(), typeName.size()), slot);
+    ++namesInIndex;
+}
+
+Q_GLOBAL_STATIC(QCustomTypeRegistry, customTypes)
 Q_GLOBAL_STATIC(QMetaTypeConverterRegistry, customTypesConversionRegistry)
 Q_GLOBAL_STATIC(QMetaTypeComparatorRegistry, customTypesComparatorRegistry)
 Q_GLOBAL_STATIC(QMetaTypeDebugStreamRegistry, customTypesDebugStreamRegistry)
@@ -863,13 +1064,14 @@ void QMetaType::registerStreamOperators(int idx, SaveOperator saveOp,
 {
     if (idx < User)
         return; //builtin types should not be registered;
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct)
         return;
-    QWriteLocker locker(customTypesLock());
-    QCustomTypeInfo &inf = (*ct)[idx - User];
+    QMutexLocker locker(&ct->lock);
+    QCustomTypeInfo inf = *ct->at(idx - User);
     inf.saveOp = saveOp;
     inf.loadOp = loadOp;
+    ct->update(idx - User, inf);
 }
 #endif // QT_NO_DATASTREAM
 
@@ -984,11 +1186,9 @@ const char *QMetaType::typeName(int typeId)
         return nullptr; // It can happen when someone cast int to QVariant::Type, we should not crash...
     }
 
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    QReadLocker locker(customTypesLock());
-    return ct && uint(ct->count()) > type - QMetaType::User && !ct->at(type - QMetaType::User).typeName.isEmpty()
-            ? ct->at(type - QMetaType::User).typeName.constData()
-            : nullptr;
+    const QCustomTypeRegistry * const ct = customTypes();
+    const QCustomTypeInfo *info = ct ? ct->info(typeId) : nullptr;
+    return info && !info->typeName.isEmpty() ? info->typeName.constData() : nullptr;
 
 #undef QT_METATYPE_TYPEID_TYPENAME_CONVERTER
 }
@@ -1020,33 +1220,6 @@ static inline int qMetaTypeStaticType(const char *typeName, int length)
     return types[i].type;
 }
 
-/*
-    Similar to QMetaType::type(), but only looks in the custom set of
-    types, and doesn't lock the mutex.
-    The extra \a firstInvalidIndex parameter is an easy way to avoid
-    iterating over customTypes() a second time in registerNormalizedType().
-*/
-static int qMetaTypeCustomType_unlocked(const char *typeName, int length, int *firstInvalidIndex = nullptr)
-{
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    if (!ct)
-        return QMetaType::UnknownType;
-
-    if (firstInvalidIndex)
-        *firstInvalidIndex = -1;
-    for (int v = 0; v < ct->count(); ++v) {
-        const QCustomTypeInfo &customInfo = ct->at(v);
-        if ((length == customInfo.typeName.size())
-            && !memcmp(typeName, customInfo.typeName.constData(), length)) {
-            if (customInfo.alias >= 0)
-                return customInfo.alias;
-            return v + QMetaType::User;
-        }
-        if (firstInvalidIndex && (*firstInvalidIndex < 0) && customInfo.typeName.isEmpty())
-            *firstInvalidIndex = v;
-    }
-    return QMetaType::UnknownType;
-}
 
 /*!
     \internal
@@ -1075,21 +1248,25 @@ int QMetaType::registerType(const char *typeName, Deleter deleter,
  */
 bool QMetaType::unregisterType(int type)
 {
-    QWriteLocker locker(customTypesLock());
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
+    if (!ct)
+        return false;
+    QMutexLocker locker(&ct->lock);
 
     // check if user type
-    if ((type < User) || ((type - User) >= ct->size()))
+    const QCustomTypeInfo *info = ct->info(type);
+    if (!info)
         return false;
 
     // only types without Q_DECLARE_METATYPE can be unregistered
-    if (ct->data()[type - User].flags & WasDeclaredAsMetaType)
+    if (info->flags & WasDeclaredAsMetaType)
         return false;
 
     // invalidate type and all its alias entries
     for (int v = 0; v < ct->count(); ++v) {
-        if (((v + User) == type) || (ct->at(v).alias == type))
-            ct->data()[v].typeName.clear();
+        const QCustomTypeInfo *entry = ct->at(v);
+        if (!entry->typeName.isEmpty() && ((v + User) == type || entry->alias == type))
+            ct->remove(v);
     }
     return true;
 }
@@ -1151,7 +1328,7 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
                                   QMetaType::TypedConstructor typedConstructor,
                                   int size, QMetaType::TypeFlags flags, const QMetaObject *metaObject)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty() || (!destructor && !typedDestructor) || (!constructor && !typedConstructor))
         return -1;
 
@@ -1161,11 +1338,8 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
     int previousSize = 0;
     QMetaType::TypeFlags::Int previousFlags = 0;
     if (idx == QMetaType::UnknownType) {
-        QWriteLocker locker(customTypesLock());
-        int posInVector = -1;
-        idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                           normalizedTypeName.size(),
-                                           &posInVector);
+        QMutexLocker locker(&ct->lock);
+        idx = ct->lookup(normalizedTypeName.constData(), normalizedTypeName.size());
         if (idx == QMetaType::UnknownType) {
             QCustomTypeInfo inf;
             inf.typeName = normalizedTypeName;
@@ -1181,28 +1355,23 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
             inf.size = size;
             inf.flags = flags;
             inf.metaObject = metaObject;
-            if (posInVector == -1) {
-                idx = ct->size() + QMetaType::User;
-                ct->append(inf);
-            } else {
-                idx = posInVector + QMetaType::User;
-                ct->data()[posInVector] = inf;
-            }
-            return idx;
+            return ct->insert(inf) + QMetaType::User;
         }
 
         if (idx >= QMetaType::User) {
-            previousSize = ct->at(idx - QMetaType::User).size;
-            previousFlags = ct->at(idx - QMetaType::User).flags;
+            const QCustomTypeInfo *previous = ct->at(idx - QMetaType::User);
+            previousSize = previous->size;
+            previousFlags = previous->flags;
 
             // Set new/additional flags in case of old library/app.
             // Ensures that older code works in conjunction with new Qt releases
             // requiring the new flags.
             if (flags != previousFlags) {
-                QCustomTypeInfo &inf = ct->data()[idx - QMetaType::User];
+                QCustomTypeInfo inf = *previous;
                 inf.flags |= flags;
                 if (metaObject)
                     inf.metaObject = metaObject;
+                ct->update(idx - QMetaType::User, inf);
             }
         }
     }
@@ -1321,7 +1490,7 @@ int QMetaType::registerTypedef(const char* typeName, int aliasId)
 */
 int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeName, int aliasId)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty())
         return -1;
 
@@ -1329,20 +1498,14 @@ int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeNam
                                   normalizedTypeName.size());
 
     if (idx == UnknownType) {
-        QWriteLocker locker(customTypesLock());
-        int posInVector = -1;
-        idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                               normalizedTypeName.size(),
-                                               &posInVector);
+        QMutexLocker locker(&ct->lock);
+        idx = ct->lookup(normalizedTypeName.constData(), normalizedTypeName.size());
 
         if (idx == UnknownType) {
             QCustomTypeInfo inf;
             inf.typeName = normalizedTypeName;
             inf.alias = aliasId;
-            if (posInVector == -1)
-                ct->append(inf);
-            else
-                ct->data()[posInVector] = inf;
+            ct->insert(inf);
             return aliasId;
         }
     }
@@ -1372,9 +1535,9 @@ bool QMetaType::isRegistered(int type)
         return true;
     }
 
-    QReadLocker locker(customTypesLock());
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    return ((type >= User) && (ct && ct->count() > type - User) && !ct->at(type - User).typeName.isEmpty());
+    const QCustomTypeRegistry * const ct = customTypes();
+    const QCustomTypeInfo *info = ct ? ct->info(type) : nullptr;
+    return info && !info->typeName.isEmpty();
 }
 
 template <bool tryNormalizedType>
@@ -1382,22 +1545,17 @@ static inline int qMetaTypeTypeImpl(const char *typeName, int length)
 {
     if (!length)
         return QMetaType::UnknownType;
-    int type = qMetaTypeStaticType(typeName, length);
-    if (type == QMetaType::UnknownType) {
-        QReadLocker locker(customTypesLock());
-        type = qMetaTypeCustomType_unlocked(typeName, length);
+    const QCustomTypeRegistry * const ct = customTypes();
+    if (!ct)
+        return qMetaTypeStaticType(typeName, length);
+
+    int type = ct->lookup(typeName, length);
 #ifndef QT_NO_QOBJECT
-        if ((type == QMetaType::UnknownType) && tryNormalizedType) {
-            const NS(QByteArray) normalizedTypeName = QMetaObject::normalizedType(typeName);
-            type = qMetaTypeStaticType(normalizedTypeName.constData(),
-                                       normalizedTypeName.size());
-            if (type == QMetaType::UnknownType) {
-                type = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                                    normalizedTypeName.size());
-            }
-        }
-#endif
+    if ((type == QMetaType::UnknownType) && tryNormalizedType) {
+        const NS(QByteArray) normalizedTypeName = QMetaObject::normalizedType(typeName);
+        type = ct->lookup(normalizedTypeName.constData(), normalizedTypeName.size());
     }
+#endif
     return type;
 }
 
@@ -1541,14 +1699,11 @@ public:
     }
     bool delegate(const QMetaTypeSwitcher::NotBuiltinType *data)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         if (!ct)
             return false;
-        QMetaType::SaveOperator saveOp = nullptr;
-        {
-            QReadLocker locker(customTypesLock());
-            saveOp = ct->at(m_type - QMetaType::User).saveOp;
-        }
+        const QCustomTypeInfo *typeInfo = ct->info(m_type);
+        const QMetaType::SaveOperator saveOp = typeInfo ? typeInfo->saveOp : nullptr;
         if (!saveOp)
             return false;
         saveOp(stream, data);
@@ -1592,14 +1747,11 @@ public:
     }
     bool delegate(const QMetaTypeSwitcher::NotBuiltinType *data)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         if (!ct)
             return false;
-        QMetaType::LoadOperator loadOp = nullptr;
-        {
-            QReadLocker locker(customTypesLock());
-            loadOp = ct->at(m_type - QMetaType::User).loadOp;
-        }
+        const QCustomTypeInfo *typeInfo = ct->info(m_type);
+        const QMetaType::LoadOperator loadOp = typeInfo ? typeInfo->loadOp : nullptr;
         if (!loadOp)
             return false;
         loadOp(stream, const_cast<QMetaTypeSwitcher::NotBuiltinType*>(data));
@@ -1723,14 +1875,13 @@ private:
     {
         QMetaType::Constructor ctor;
         QMetaType::TypedConstructor tctor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
+            const QCustomTypeInfo *typeInfo = ct ? ct->info(type) : nullptr;
+            if (Q_UNLIKELY(!typeInfo))
                 return nullptr;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            ctor = typeInfo.constructor;
-            tctor = typeInfo.typedConstructor;
+            ctor = typeInfo->constructor;
+            tctor = typeInfo->typedConstructor;
         }
         Q_ASSERT_X((ctor || tctor) , "void *QMetaType::construct(int type, void *where, const void *copy)", "The type was not properly registered");
         if (Q_UNLIKELY(tctor))
@@ -1821,14 +1972,13 @@ private:
     {
         QMetaType::Destructor dtor;
         QMetaType::TypedDestructor tdtor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
+            const QCustomTypeInfo *typeInfo = ct ? ct->info(type) : nullptr;
+            if (Q_UNLIKELY(!typeInfo))
                 return;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            dtor = typeInfo.destructor;
-            tdtor = typeInfo.typedDestructor;
+            dtor = typeInfo->destructor;
+            tdtor = typeInfo->typedDestructor;
         }
         Q_ASSERT_X((dtor || tdtor), "void QMetaType::destruct(int type, void *where)", "The type was not properly registered");
         if (Q_UNLIKELY(tdtor))
@@ -1893,11 +2043,9 @@ public:
 private:
     static int customTypeSizeOf(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-            return 0;
-        return ct->at(type - QMetaType::User).size;
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->info(type) : nullptr;
+        return Q_LIKELY(typeInfo) ? typeInfo->size : 0;
     }
 
     const int m_type;
@@ -1961,13 +2109,9 @@ private:
     const int m_type;
     static quint32 customTypeFlags(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (Q_UNLIKELY(!ct || type < QMetaType::User))
-            return 0;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
-            return 0;
-        return ct->at(type - QMetaType::User).flags;
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->info(type) : nullptr;
+        return Q_LIKELY(typeInfo) ? typeInfo->flags : 0;
     }
 };
 }  // namespace
@@ -2025,13 +2169,9 @@ private:
     const int m_type;
     static const QMetaObject *customMetaObject(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (Q_UNLIKELY(!ct || type < QMetaType::User))
-            return nullptr;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
-            return nullptr;
-        return ct->at(type - QMetaType::User).metaObject;
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->info(type) : nullptr;
+        return Q_LIKELY(typeInfo) ? typeInfo->metaObject : nullptr;
     }
 };
 }  // namespace
@@ -2229,12 +2369,11 @@ public:
 private:
     void customTypeInfo(const uint type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         if (Q_UNLIKELY(!ct))
             return;
-        QReadLocker locker(customTypesLock());
-        if (Q_LIKELY(uint(ct->count()) > type - QMetaType::User))
-            info = ct->at(type - QMetaType::User);
+        if (const QCustomTypeInfo *typeInfo = ct->info(int(type)))
+            info = *typeInfo;
     }
 
     const uint m_type;
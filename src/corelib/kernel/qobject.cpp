@@ -223,7 +223,8 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    // check queuedMetaCalls first, see QThreadData::flushQueuedMetaCalls()
+    if (queuedMetaCalls.loadAcquire() || postedEvents)
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     thisThreadData->deref();
@@ -1614,7 +1615,9 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->movingObjects.ref();
     d_func()->setThreadData_helper(currentData, targetData);
+    currentData->movingObjects.deref();
 
     locker.unlock();
 
@@ -1638,6 +1641,7 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     Q_Q(QObject);
 
     // move posted events
+    currentData->flushQueuedMetaCalls();
     int eventsMoved = 0;
     for (int i = 0; i < currentData->postEventList.size(); ++i) {
         const QPostEvent &pe = currentData->postEventList.at(i);
@@ -1689,6 +1693,10 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     // synchronizes with loadAcquire e.g. in QCoreApplication::postEvent
     threadData.storeRelease(targetData);
 
+    // forward the queued meta calls that were pushed to currentData after the
+    // first flush above, see QCoreApplicationPrivate::postQueuedMetaCall()
+    currentData->flushQueuedMetaCalls();
+
     for (int i = 0; i < children.size(); ++i) {
         QObject *child = children.at(i);
         child->d_func()->setThreadData_helper(currentData, targetData);
@@ -3798,7 +3806,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         return;
     }
 
-    QCoreApplication::postEvent(c->receiver.loadRelaxed(), ev);
+    QCoreApplicationPrivate::postQueuedMetaCall(c->receiver.loadRelaxed(), ev);
 }
 
 template <bool callbacks_enabled>
@@ -417,6 +417,10 @@ public:
     // these objects are all used to indicate that a QObject was deleted
     // plus QPointer, which keeps a separate list
     QAtomicPointer<QtSharedPointer::ExternalRefCountData> sharedRefcount;
+
+    // number of QMetaCallEvents for this object still waiting in its thread's
+    // QQueuedMetaCallList, i.e. not yet counted in postedEvents
+    QAtomicInt queuedMetaCalls;
 };
 
 Q_DECLARE_TYPEINFO(QObjectPrivate::ConnectionList, Q_MOVABLE_TYPE);
@@ -592,6 +596,11 @@ public:
 private:
     inline void allocArgs();
 
+    friend class QQueuedMetaCallList;
+    // set while the event waits in a QQueuedMetaCallList
+    QObject *queuedReceiver_ = nullptr;
+    QMetaCallEvent *queuedNext_ = nullptr;
+
     struct Data {
         QtPrivate::QSlotObjectBase *slotObj_;
         void **args_;
@@ -47,6 +47,7 @@
 #include "private/qutfcodec_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -80,6 +81,7 @@ QT_BEGIN_NAMESPACE
 #define JSONERR_DEEP_NEST   QT_TRANSLATE_NOOP("QJsonParseError", "too deeply nested document")
 #define JSONERR_DOC_LARGE   QT_TRANSLATE_NOOP("QJsonParseError", "too large document")
 #define JSONERR_GARBAGEEND  QT_TRANSLATE_NOOP("QJsonParseError", "garbage at the end of the document")
+#define JSONERR_PREMATURE   QT_TRANSLATE_NOOP("QJsonParseError", "premature end of document")
 
 /*!
     \class QJsonParseError
@@ -114,6 +116,9 @@ QT_BEGIN_NAMESPACE
     \value DeepNesting              The JSON document is too deeply nested for the parser to parse it
     \value DocumentTooLarge         The JSON document is too large for the parser to parse it
     \value GarbageAtEnd             The parsed document contains additional garbage characters at the end
+    \value PrematureEndOfDocument   QJsonStreamReader ran out of data in the middle of a token or
+                                    document. This error is recoverable by adding more data.
+                                    This value was introduced in Qt 5.15.
 
 */
 
@@ -189,6 +194,9 @@ QString QJsonParseError::errorString() const
     case GarbageAtEnd:
         sz = JSONERR_GARBAGEEND;
         break;
+    case PrematureEndOfDocument:
+        sz = JSONERR_PREMATURE;
+        break;
     }
 #ifndef QT_BOOTSTRAPPED
     return QCoreApplication::translate("QJsonParseError", sz);
@@ -285,16 +293,7 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -777,6 +776,358 @@ bool Parser::parseNumber()
     return true;
 }
 
+/*
+    Vectorized scanning helpers, shared with QJsonStreamReader.
+
+    SSE2 is part of the x86-64 baseline and used unconditionally, like in
+    qutfcodec.cpp. The 32-byte AVX2 paths are selected at runtime; the
+    bootstrap library has no CPU feature detection, so it only gets them when
+    the compiler targets AVX2 anyway. SSE4.2's string instructions are not
+    used: PCMPISTRI is slower than a compare and movemask for sets of two to
+    four characters.
+*/
+#if !defined(QT_BOOTSTRAPPED) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+#  define QJSON_RUNTIME_AVX2
+#endif
+
+static inline bool isJsonWhitespace(char c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+const char *QJsonPrivate::skipWhitespace(const char *json, const char *end) noexcept
+{
+    // Compact JSON has no whitespace between tokens at all
+    if (json == end || !isJsonWhitespace(*json))
+        return json;
+
+#ifdef __SSE2__
+    // Pretty-printed JSON has indentation runs after every newline
+    const __m128i space = _mm_set1_epi8(Space);
+    const __m128i tab = _mm_set1_epi8(Tab);
+    const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+    const __m128i ret = _mm_set1_epi8(Return);
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                                     _mm_cmpeq_epi8(data, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                                     _mm_cmpeq_epi8(data, ret)));
+        const uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffff;
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+#endif
+
+    while (json < end && isJsonWhitespace(*json))
+        ++json;
+    return json;
+}
+
+#ifdef QJSON_RUNTIME_AVX2
+QT_FUNCTION_TARGET(AVX2)
+static const char *findStringSpecial_avx2(const char *json, const char *end, bool *isAscii)
+{
+    const __m256i quote = _mm256_set1_epi8(Quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    __m256i high = _mm256_setzero_si256();
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                _mm256_cmpeq_epi8(data, backslash));
+        const uint mask = _mm256_movemask_epi8(special);
+        if (mask) {
+            const uint n = qCountTrailingZeroBits(mask);
+            const uint before = (1U << n) - 1;
+            if ((uint(_mm256_movemask_epi8(data)) & before) || _mm256_movemask_epi8(high))
+                *isAscii = false;
+            return json + n;
+        }
+        high = _mm256_or_si256(high, data);
+    }
+    if (_mm256_movemask_epi8(high))
+        *isAscii = false;
+    return json;
+}
+#endif
+
+/*
+    Returns the first '"' or '\\' in [json, end), or end. Clears *isAscii if
+    any byte before it is not US-ASCII; it's never set.
+*/
+const char *QJsonPrivate::findStringSpecial(const char *json, const char *end, bool *isAscii) noexcept
+{
+#ifdef QJSON_RUNTIME_AVX2
+    if (end - json >= 64 && qCpuHasFeature(AVX2)) {
+        json = findStringSpecial_avx2(json, end, isAscii);
+        if (json < end && (*json == Quote || *json == '\\'))
+            return json;
+    }
+#endif
+
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8(Quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                             _mm_cmpeq_epi8(data, backslash));
+        const uint mask = _mm_movemask_epi8(special);
+        const uint high = _mm_movemask_epi8(data);
+        if (mask) {
+            const uint n = qCountTrailingZeroBits(mask);
+            if (high & ((1U << n) - 1))
+                *isAscii = false;
+            return json + n;
+        }
+        if (high)
+            *isAscii = false;
+    }
+#endif
+
+    for ( ; json < end; ++json) {
+        const char c = *json;
+        if (c == Quote || c == '\\')
+            break;
+        if (uchar(c) >= 0x80)
+            *isAscii = false;
+    }
+    return json;
+}
+
+#ifdef QJSON_RUNTIME_AVX2
+/*
+    UTF-8 validation following "Validating UTF-8 In Less Than One Instruction
+    Per Byte" (Keiser, Lemire; Software: Practice and Experience, 2021): three
+    16-entry table lookups classify each pair of adjacent bytes, and a
+    separate check catches missing third and fourth continuation bytes. This
+    accepts exactly what QUtf8Functions::fromUtf8<QUtf8BaseTraits> accepts:
+    no overlong forms, no surrogates, nothing above U+10FFFF, noncharacters
+    allowed.
+*/
+namespace {
+enum : uchar {
+    TooShort = 1 << 0,      // 11______ 0_______ and 11______ 11______
+    TooLong = 1 << 1,       // 0_______ 10______
+    Overlong3 = 1 << 2,     // 11100000 100_____
+    TooLarge = 1 << 3,      // 11110100 1001____ and larger
+    Surrogate = 1 << 4,     // 11101101 101_____
+    Overlong2 = 1 << 5,     // 1100000_ 10______
+    TooLarge1000 = 1 << 6,  // 11110101 1000____ and larger
+    Overlong4 = 1 << 6,     // 11110000 1000____
+    TwoConts = 1 << 7,      // 10______ 10______
+    Carry = TooShort | TooLong | TwoConts
+};
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i utf8Lookup(__m256i table, __m256i nibbles)
+{
+    return _mm256_shuffle_epi8(table, nibbles);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i utf8HighNibbles(__m256i v)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+}
+
+// The bytes of input, shifted by N and filled from the end of previous
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i utf8Prev1(__m256i input, __m256i previous)
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - 1);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i utf8Prev2(__m256i input, __m256i previous)
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - 2);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i utf8Prev3(__m256i input, __m256i previous)
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - 3);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i utf8CheckBlock(__m256i input, __m256i previous)
+{
+#define TABLE(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+    const __m256i byte1HighTable = TABLE(
+            // 0_______ ________ <ASCII in byte 1>
+            TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+            // 10______ ________ <continuation in byte 1>
+            TwoConts, TwoConts, TwoConts, TwoConts,
+            // 1100____ ________ <two byte lead in byte 1>
+            TooShort | Overlong2,
+            // 1101____ ________ <two byte lead in byte 1>
+            TooShort,
+            // 1110____ ________ <three byte lead in byte 1>
+            TooShort | Overlong3 | Surrogate,
+            // 1111____ ________ <four+ byte lead in byte 1>
+            char(TooShort | TooLarge | TooLarge1000 | Overlong4));
+    const __m256i byte1LowTable = TABLE(
+            // ____0000 ________
+            char(Carry | Overlong3 | Overlong2 | Overlong4),
+            // ____0001 ________
+            char(Carry | Overlong2),
+            // ____001_ ________
+            char(Carry), char(Carry),
+            // ____0100 ________
+            char(Carry | TooLarge),
+            // ____0101 ________ and ____011_ ________
+            char(Carry | TooLarge | TooLarge1000), char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            // ____1___ ________
+            char(Carry | TooLarge | TooLarge1000), char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000), char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            // ____1101 ________
+            char(Carry | TooLarge | TooLarge1000 | Surrogate),
+            char(Carry | TooLarge | TooLarge1000), char(Carry | TooLarge | TooLarge1000));
+    const __m256i byte2HighTable = TABLE(
+            // ________ 0_______ <ASCII in byte 2>
+            TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+            // ________ 1000____
+            char(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4),
+            // ________ 1001____
+            char(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge),
+            // ________ 101_____
+            char(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+            char(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+            // ________ 11______ <lead byte in byte 2>
+            TooShort, TooShort, TooShort, TooShort);
+#undef TABLE
+
+    const __m256i prev1 = utf8Prev1(input, previous);
+    const __m256i special =
+            _mm256_and_si256(_mm256_and_si256(utf8Lookup(byte1HighTable, utf8HighNibbles(prev1)),
+                                              utf8Lookup(byte1LowTable, _mm256_and_si256(prev1, _mm256_set1_epi8(0x0f)))),
+                             utf8Lookup(byte2HighTable, utf8HighNibbles(input)));
+
+    // Third and fourth bytes of three and four byte sequences must be
+    // continuations; the table lookups above report those as TwoConts
+    const __m256i isThirdByte = _mm256_subs_epu8(utf8Prev2(input, previous), _mm256_set1_epi8(char(0xe0 - 0x80)));
+    const __m256i isFourthByte = _mm256_subs_epu8(utf8Prev3(input, previous), _mm256_set1_epi8(char(0xf0 - 0x80)));
+    const __m256i must23 = _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte),
+                                            _mm256_set1_epi8(char(0x80)));
+    return _mm256_xor_si256(must23, special);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static bool isValidUtf8_avx2(const uchar *src, const uchar *end)
+{
+    // Non-zero where the last bytes of a block start a sequence that continues
+    // past it
+    const __m256i maxValue = _mm256_setr_epi8(
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xf0 - 1), char(0xe0 - 1), char(0xc0 - 1));
+
+    __m256i error = _mm256_setzero_si256();
+    __m256i previous = _mm256_setzero_si256();
+    __m256i previousIncomplete = _mm256_setzero_si256();
+    uchar tail[32];
+    while (src < end) {
+        __m256i input;
+        if (end - src >= 32) {
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+            src += 32;
+        } else {
+            // The zero padding makes any sequence cut off by the end an error
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, src, end - src);
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tail));
+            src = end;
+        }
+
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, previousIncomplete);
+        } else {
+            error = _mm256_or_si256(error, utf8CheckBlock(input, previous));
+            previousIncomplete = _mm256_subs_epu8(input, maxValue);
+        }
+        previous = input;
+    }
+    error = _mm256_or_si256(error, previousIncomplete);
+    return _mm256_testz_si256(error, error);
+}
+#endif
+
+/*
+    Returns the start of the first ill-formed UTF-8 sequence in [json, end),
+    or end if there is none. A sequence cut off by \a end is ill-formed.
+*/
+const char *QJsonPrivate::findInvalidUtf8(const char *json, const char *end) noexcept
+{
+#ifdef QJSON_RUNTIME_AVX2
+    if (end - json >= 32 && qCpuHasFeature(AVX2)
+            && isValidUtf8_avx2(reinterpret_cast<const uchar *>(json),
+                                reinterpret_cast<const uchar *>(end))) {
+        return end;
+    }
+    // otherwise, find where exactly it failed
+#endif
+
+    while (json < end) {
+        if (uchar(*json) < 0x80) {
+            ++json;
+            continue;
+        }
+        const char *next = json;
+        uint ch;
+        if (!scanUtf8Char(next, end, &ch))
+            return json;
+        json = next;
+    }
+    return end;
+}
+
+/*
+    Decodes the contents of a string that may contain escape sequences, from
+    \a json up to the closing quote or \a end. On error, \a json points to the
+    offending character, otherwise to the closing quote or \a end.
+*/
+QJsonParseError::ParseError QJsonPrivate::decodeString(const char *&json, const char *end, QString *out)
+{
+    while (json < end) {
+        // copy the unescaped run in one go
+        bool isAscii = true;
+        const char *runEnd = findStringSpecial(json, end, &isAscii);
+        if (runEnd != json) {
+            const int length = int(runEnd - json);
+            if (isAscii) {
+                out->append(QLatin1String(json, length));
+            } else {
+                const char *invalid = findInvalidUtf8(json, runEnd);
+                if (invalid != runEnd) {
+                    json = invalid;
+                    return QJsonParseError::IllegalUTF8String;
+                }
+                out->append(QString::fromUtf8(json, length));
+            }
+            json = runEnd;
+        }
+        if (json == end || *json == Quote)
+            break;
+
+        uint ch = 0;
+        if (!scanEscapeSequence(json, end, &ch))
+            return QJsonParseError::IllegalEscapeSequence;
+        if (QChar::requiresSurrogates(ch)) {
+            out->append(QChar::highSurrogate(ch));
+            out->append(QChar::lowSurrogate(ch));
+        } else {
+            out->append(QChar(ushort(ch)));
+        }
+    }
+    return QJsonParseError::NoError;
+}
+
 /*
 
         string = quotation-mark *char quotation-mark
@@ -799,78 +1150,6 @@ bool Parser::parseNumber()
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const auto *usrc = reinterpret_cast<const uchar *>(json);
-    const auto *uend = reinterpret_cast<const uchar *>(end);
-    const uchar b = *usrc++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, usrc, uend);
-    if (res < 0)
-        return false;
-
-    json = reinterpret_cast<const char *>(usrc);
-    return true;
-}
-
 bool Parser::parseString()
 {
     const char *start = json;
@@ -878,28 +1157,21 @@ bool Parser::parseString()
     // try to parse a utf-8 string without escape sequences, and note whether it's 7bit ASCII.
 
     BEGIN << "parse string" << json;
-    bool isUtf8 = true;
     bool isAscii = true;
-    while (json < end) {
-        uint ch = 0;
-        if (*json == '"')
-            break;
-        if (*json == '\\') {
-            isAscii = false;
-            // If we find escape sequences, we store UTF-16 as there are some
-            // escape sequences which are hard to represent in UTF-8.
-            // (plain "\\ud800" for example)
-            isUtf8 = false;
-            break;
-        }
-        if (!scanUtf8Char(json, end, &ch)) {
+    json = findStringSpecial(json, end, &isAscii);
+    if (!isAscii) {
+        const char *invalid = findInvalidUtf8(start, json);
+        if (invalid != json) {
+            json = invalid;
             lastError = QJsonParseError::IllegalUTF8String;
             return false;
         }
-        if (ch > 0x7f)
-            isAscii = false;
-        DEBUG << "  " << ch << char(ch);
     }
+
+    // If we find escape sequences, we store UTF-16 as there are some
+    // escape sequences which are hard to represent in UTF-8.
+    // (plain "\\ud800" for example)
+    const bool isUtf8 = json >= end || *json != '\\';
     ++json;
     DEBUG << "end of string";
     if (json >= end) {
@@ -921,28 +1193,9 @@ bool Parser::parseString()
     json = start;
 
     QString ucs4;
-    while (json < end) {
-        uint ch = 0;
-        if (*json == '"')
-            break;
-        else if (*json == '\\') {
-            if (!scanEscapeSequence(json, end, &ch)) {
-                lastError = QJsonParseError::IllegalEscapeSequence;
-                return false;
-            }
-        } else {
-            if (!scanUtf8Char(json, end, &ch)) {
-                lastError = QJsonParseError::IllegalUTF8String;
-                return false;
-            }
-        }
-        if (QChar::requiresSurrogates(ch)) {
-            ucs4.append(QChar::highSurrogate(ch));
-            ucs4.append(QChar::lowSurrogate(ch));
-        } else {
-            ucs4.append(QChar(ushort(ch)));
-        }
-    }
+    lastError = decodeString(json, end, &ucs4);
+    if (lastError != QJsonParseError::NoError)
+        return false;
     ++json;
 
     if (json >= end) {
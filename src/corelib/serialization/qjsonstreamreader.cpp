@@ -0,0 +1,991 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamreader.h"
+
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+#include "qjsonparser_p.h"
+#include "private/qnumeric_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \ingroup shared
+    \reentrant
+    \since 5.15
+
+    \brief The QJsonStreamReader class is a pull parser for JSON, operating
+    on either a QByteArray or a QIODevice.
+
+    QJsonDocument::fromJson() needs the complete document in memory and
+    builds a tree of QJsonValue objects from it before the first value can be
+    inspected. QJsonStreamReader instead walks the input token by token: each
+    call to readNext() scans exactly one token and makes its contents
+    available through name(), stringValue(), integerValue(), doubleValue() and
+    boolValue(). No tree is built, so memory usage is bounded by the size of
+    the largest single token rather than by the size of the document.
+
+    \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 0
+
+    The reader can be fed in two ways. If a QIODevice is set with setDevice()
+    or passed to the constructor, the reader pulls data from it in chunks as
+    needed. Alternatively, chunks can be pushed with addData(); when the
+    reader runs out of data in the middle of a token, readNext() returns
+    \l Invalid and error() reports QJsonParseError::PrematureEndOfDocument.
+    This error is recoverable: add more data and call readNext() again, and
+    parsing resumes with the incomplete token. A reader constructed from a
+    QByteArray treats that array as the complete input.
+
+    By default the input must contain exactly one JSON value, and data
+    following it is reported as QJsonParseError::GarbageAtEnd. With
+    setMultipleDocumentsAllowed(), any number of whitespace-separated JSON
+    values are read one after the other, which is the format used by JSON
+    Lines and similar log or export formats. The end of each document can be
+    recognized by depth() returning to zero.
+
+    Following RFC 8259, a document may consist of a single string, number,
+    boolean or null, not only of an object or array. Otherwise, errors are
+    reported with the same QJsonParseError codes that
+    QJsonDocument::fromJson() uses for the same input.
+
+    \sa QJsonDocument, QCborStreamReader, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token that the reader has just read.
+
+    \value NoToken          The reader has not yet read anything.
+    \value Invalid          An error has occurred, reported in error() and
+                            errorString().
+    \value StartObject      The reader reports the start of a JSON object.
+    \value EndObject        The reader reports the end of a JSON object.
+    \value StartArray       The reader reports the start of a JSON array.
+    \value EndArray         The reader reports the end of a JSON array.
+    \value Name             The reader reports the name of an object member
+                            in name(). The next token is the member's value.
+    \value String           The reader reports a string in stringValue().
+    \value Number           The reader reports a number in integerValue() or
+                            doubleValue(), depending on isInteger().
+    \value Bool             The reader reports a boolean in boolValue().
+    \value Null             The reader reports a null value.
+    \value EndDocument      The reader has consumed all input. No further
+                            tokens will be reported.
+*/
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum {
+        // Same limit as QJsonPrivate::Parser
+        NestingLimit = 1024,
+        IdealBufferSize = 16384
+    };
+
+    enum State {
+        ExpectValue,
+        ExpectValueOrEndArray,
+        ExpectNameOrEndObject,
+        ExpectName,
+        ExpectSeparatorOrEnd,
+        DocumentEnded
+    };
+
+    void reset();
+    bool atInputEnd() const;
+    bool fillBuffer();
+    QJsonStreamReader::TokenType scan(bool final);
+    QJsonStreamReader::TokenType scanValue(const char *json, const char *end, bool final);
+    QJsonStreamReader::TokenType scanLiteral(const char *json, const char *end, bool final);
+    QJsonStreamReader::TokenType scanNumber(const char *json, const char *end, bool final);
+    QJsonStreamReader::TokenType scanString(const char *json, const char *end, bool final,
+                                            QJsonStreamReader::TokenType type);
+    QJsonStreamReader::TokenType endContainer(const char *json, QJsonStreamReader::TokenType type);
+    void valueDone();
+
+    QJsonStreamReader::TokenType raise(QJsonParseError::ParseError e)
+    {
+        error = e;
+        type = QJsonStreamReader::Invalid;
+        return type;
+    }
+
+    QJsonStreamReader::TokenType token(const char *json, QJsonStreamReader::TokenType t)
+    {
+        pos = int(json - buffer.constData());
+        type = t;
+        return t;
+    }
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    int pos = 0;
+    qint64 bufferOffset = 0;
+    qint64 tokenOffset = 0;
+    QVarLengthArray<char, 64> containers;
+    State state = ExpectValue;
+    QJsonStreamReader::TokenType type = QJsonStreamReader::NoToken;
+    QJsonParseError::ParseError error = QJsonParseError::NoError;
+    bool multipleDocuments = false;
+    bool dataComplete = false;
+    bool bomChecked = false;
+    bool decode = true;
+
+    QString name;
+    QString string;
+    union {
+        qint64 integer;
+        double doubleValue;
+        bool boolean;
+    };
+    bool isInteger = false;
+};
+
+void QJsonStreamReaderPrivate::reset()
+{
+    buffer.clear();
+    pos = 0;
+    bufferOffset = 0;
+    tokenOffset = 0;
+    containers.clear();
+    state = ExpectValue;
+    type = QJsonStreamReader::NoToken;
+    error = QJsonParseError::NoError;
+    dataComplete = false;
+    bomChecked = false;
+    name.clear();
+    string.clear();
+    integer = 0;
+    isInteger = false;
+}
+
+bool QJsonStreamReaderPrivate::atInputEnd() const
+{
+    if (!device)
+        return dataComplete;
+    // A sequential device may receive more data later; only closing it ends the input.
+    return !device->isOpen() || (!device->isSequential() && device->atEnd());
+}
+
+bool QJsonStreamReaderPrivate::fillBuffer()
+{
+    if (!device)
+        return false;
+
+    // Move the unconsumed tail to the front. The buffer has reserved capacity,
+    // so this never reallocates. If we're in the middle of a token larger than
+    // the buffer, grow geometrically so that rescanning it stays linear.
+    const int remaining = buffer.size() - pos;
+    if (pos) {
+        if (remaining)
+            memmove(buffer.data(), buffer.constData() + pos, remaining);
+        buffer.resize(remaining);
+        bufferOffset += pos;
+        pos = 0;
+    }
+
+    const int chunk = qMax(int(IdealBufferSize), remaining);
+    buffer.resize(remaining + chunk);
+    const qint64 n = device->read(buffer.data() + remaining, chunk);
+    buffer.resize(remaining + int(qMax(n, qint64(0))));
+    return n > 0;
+}
+
+using QJsonPrivate::skipWhitespace;
+
+/*
+    Scans one token out of the buffer. The read position is only advanced past
+    complete tokens, so a NoToken return (not enough data, and \a final is
+    false) can simply be retried once more data has been appended. When \a
+    final is true, the buffer holds the remainder of the input and this
+    function never returns NoToken.
+*/
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::scan(bool final)
+{
+    const char *begin = buffer.constData();
+    const char *end = begin + buffer.size();
+    const char *json = begin + pos;
+
+    if (!bomChecked) {
+        static const char utf8bom[] = "\xef\xbb\xbf";
+        const int n = int(qMin<qptrdiff>(3, end - json));
+        if (memcmp(json, utf8bom, n) != 0) {
+            bomChecked = true;
+        } else if (n == 3) {
+            json += 3;
+            pos += 3;
+            bomChecked = true;
+        } else if (!final) {
+            return QJsonStreamReader::NoToken;
+        } else {
+            bomChecked = true;
+        }
+    }
+
+    forever {
+        json = skipWhitespace(json, end);
+        pos = int(json - begin);
+        tokenOffset = bufferOffset + pos;
+
+        if (json == end) {
+            // Without a device there is no way to wait for trailing data
+            if (state == DocumentEnded && (final || !device))
+                return token(json, QJsonStreamReader::EndDocument);
+            if (!final)
+                return QJsonStreamReader::NoToken;
+            if (containers.isEmpty()) {
+                if (multipleDocuments)
+                    return token(json, QJsonStreamReader::EndDocument);
+                return raise(QJsonParseError::IllegalValue);
+            }
+            return raise(containers.last() == '{' ? QJsonParseError::UnterminatedObject
+                                                  : QJsonParseError::UnterminatedArray);
+        }
+
+        const char c = *json;
+        switch (state) {
+        case DocumentEnded:
+            return raise(QJsonParseError::GarbageAtEnd);
+
+        case ExpectNameOrEndObject:
+            if (c == '}')
+                return endContainer(json, QJsonStreamReader::EndObject);
+            if (c != '"')
+                return raise(QJsonParseError::UnterminatedObject);
+            return scanString(json, end, final, QJsonStreamReader::Name);
+
+        case ExpectName:
+            if (c == '"')
+                return scanString(json, end, final, QJsonStreamReader::Name);
+            return raise(c == '}' ? QJsonParseError::MissingObject
+                                  : QJsonParseError::UnterminatedObject);
+
+        case ExpectSeparatorOrEnd: {
+            const bool inObject = containers.last() == '{';
+            if (c == ',') {
+                ++json;
+                state = inObject ? ExpectName : ExpectValue;
+                continue;
+            }
+            if (inObject && c == '}')
+                return endContainer(json, QJsonStreamReader::EndObject);
+            if (!inObject && c == ']')
+                return endContainer(json, QJsonStreamReader::EndArray);
+            return raise(inObject ? QJsonParseError::UnterminatedObject
+                                  : QJsonParseError::MissingValueSeparator);
+        }
+
+        case ExpectValueOrEndArray:
+            if (c == ']')
+                return endContainer(json, QJsonStreamReader::EndArray);
+            Q_FALLTHROUGH();
+        case ExpectValue:
+            return scanValue(json, end, final);
+        }
+        Q_UNREACHABLE();
+    }
+}
+
+void QJsonStreamReaderPrivate::valueDone()
+{
+    if (!containers.isEmpty())
+        state = ExpectSeparatorOrEnd;
+    else
+        state = multipleDocuments ? ExpectValue : DocumentEnded;
+}
+
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::endContainer(const char *json, QJsonStreamReader::TokenType type)
+{
+    containers.removeLast();
+    valueDone();
+    return token(json + 1, type);
+}
+
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::scanValue(const char *json, const char *end, bool final)
+{
+    switch (*json) {
+    case '{':
+    case '[':
+        if (containers.size() >= NestingLimit)
+            return raise(QJsonParseError::DeepNesting);
+        containers.append(*json);
+        if (*json == '{') {
+            state = ExpectNameOrEndObject;
+            return token(json + 1, QJsonStreamReader::StartObject);
+        }
+        state = ExpectValueOrEndArray;
+        return token(json + 1, QJsonStreamReader::StartArray);
+    case '"':
+        return scanString(json, end, final, QJsonStreamReader::String);
+    case 'n':
+    case 't':
+    case 'f':
+        return scanLiteral(json, end, final);
+    case ',':
+        // Essentially missing value, but after a colon, not after a comma
+        // like the other MissingObject errors.
+        return raise(QJsonParseError::IllegalValue);
+    case '}':
+    case ']':
+        return raise(QJsonParseError::MissingObject);
+    default:
+        return scanNumber(json, end, final);
+    }
+}
+
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::scanLiteral(const char *json, const char *end, bool final)
+{
+    static const char nullLiteral[] = "null";
+    static const char trueLiteral[] = "true";
+    static const char falseLiteral[] = "false";
+
+    const char *literal;
+    int length;
+    QJsonStreamReader::TokenType t = QJsonStreamReader::Bool;
+    switch (*json) {
+    case 'n':
+        literal = nullLiteral;
+        length = 4;
+        t = QJsonStreamReader::Null;
+        break;
+    case 't':
+        literal = trueLiteral;
+        length = 4;
+        boolean = true;
+        break;
+    default:
+        literal = falseLiteral;
+        length = 5;
+        boolean = false;
+        break;
+    }
+
+    const int available = int(qMin<qptrdiff>(length, end - json));
+    if (memcmp(json, literal, available) != 0)
+        return raise(QJsonParseError::IllegalValue);
+    if (available < length)
+        return final ? raise(QJsonParseError::IllegalValue) : QJsonStreamReader::NoToken;
+
+    valueDone();
+    return token(json + length, t);
+}
+
+/*
+    number = [ minus ] int [ frac ] [ exp ]
+
+    Same grammar as QJsonPrivate::Parser::parseNumber(). A number has no
+    terminator of its own, so one reaching the end of the buffer can only be
+    accepted once the input is known to be complete.
+*/
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::scanNumber(const char *json, const char *end, bool final)
+{
+    const char *start = json;
+    bool isInt = true;
+
+    if (json < end && *json == '-')
+        ++json;
+
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    if (json < end && *json == '.') {
+        isInt = false;
+        ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        isInt = false;
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    if (json == end) {
+        if (!final)
+            return QJsonStreamReader::NoToken;
+        // Only a top-level number may be terminated by the end of the input
+        if (!containers.isEmpty())
+            return raise(QJsonParseError::TerminationByNumber);
+    }
+
+    const QByteArray number = QByteArray::fromRawData(start, int(json - start));
+    bool ok = false;
+    if (isInt) {
+        integer = number.toLongLong(&ok);
+        isInteger = ok;
+    }
+    if (!ok) {
+        const double d = number.toDouble(&ok);
+        if (!ok)
+            return raise(QJsonParseError::IllegalNumber);
+        isInteger = convertDoubleTo(d, &integer);
+        if (!isInteger)
+            doubleValue = d;
+    }
+
+    valueDone();
+    return token(json, QJsonStreamReader::Number);
+}
+
+/*
+    The first pass finds the closing quote and notes whether there are escape
+    sequences or non-ASCII characters; only in the latter case is the string
+    validated as UTF-8. Strings without escapes are then decoded in one go.
+*/
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::scanString(const char *json, const char *end, bool final,
+                                     QJsonStreamReader::TokenType t)
+{
+    const char *start = ++json;
+    bool hasEscapes = false;
+    bool isAscii = true;
+    forever {
+        json = QJsonPrivate::findStringSpecial(json, end, &isAscii);
+        if (json == end || *json == '"')
+            break;
+        hasEscapes = true;
+        if (end - json < 2) {
+            json = end;
+            break;
+        }
+        json += 2;
+    }
+
+    if (json == end) {
+        if (!final)
+            return QJsonStreamReader::NoToken;
+        if (!isAscii && QJsonPrivate::findInvalidUtf8(start, end) != end)
+            return raise(QJsonParseError::IllegalUTF8String);
+        return raise(QJsonParseError::UnterminatedString);
+    }
+    if (!isAscii && QJsonPrivate::findInvalidUtf8(start, json) != json)
+        return raise(QJsonParseError::IllegalUTF8String);
+
+    const char *stringEnd = json++;
+    if (t == QJsonStreamReader::Name) {
+        json = skipWhitespace(json, end);
+        if (json == end && !final)
+            return QJsonStreamReader::NoToken;
+        if (json == end || *json != ':')
+            return raise(QJsonParseError::MissingNameSeparator);
+        ++json;
+    }
+
+    QString &target = t == QJsonStreamReader::Name ? name : string;
+    if (!decode) {
+        target.clear();
+    } else if (!hasEscapes) {
+        const int length = int(stringEnd - start);
+        target = isAscii ? QString::fromLatin1(start, length) : QString::fromUtf8(start, length);
+    } else {
+        target.clear();
+        target.reserve(int(stringEnd - start));
+        const char *p = start;
+        const QJsonParseError::ParseError e = QJsonPrivate::decodeString(p, stringEnd, &target);
+        if (e != QJsonParseError::NoError)
+            return raise(e);
+    }
+
+    if (t == QJsonStreamReader::Name)
+        state = ExpectValue;
+    else
+        valueDone();
+    return token(json, t);
+}
+
+/*!
+    Constructs a QJsonStreamReader object with no data. Use addData() or
+    setDevice() to supply input.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->reset();
+}
+
+/*!
+    Constructs a QJsonStreamReader object that reads from \a data. The array
+    is taken to contain the complete input: unlike with addData(), a
+    top-level number at the end of \a data is accepted.
+
+    The reader holds a shallow copy of \a data, so a QByteArray returned from
+    QFileDevice::mapToByteArray() is parsed without being copied.
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : QJsonStreamReader()
+{
+    d->buffer = data;
+    d->dataComplete = true;
+}
+
+/*!
+    Constructs a QJsonStreamReader object that reads from \a device.
+
+    \sa setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : QJsonStreamReader()
+{
+    setDevice(device);
+}
+
+/*!
+    Destroys the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device and resets the reader. Data is read
+    from the device in chunks as readNext() needs it.
+
+    The end of the input is reached when \a device is closed, or, for a
+    random-access device, when it is at its end. A sequential device such as
+    a socket can still receive data after readNext() reported
+    QJsonParseError::PrematureEndOfDocument; call readNext() again once
+    QIODevice::readyRead() has been emitted.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    clear();
+    d->device = device;
+    if (device)
+        d->buffer.reserve(QJsonStreamReaderPrivate::IdealBufferSize);
+}
+
+/*!
+    Returns the current device, or \nullptr if none is set.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Appends \a data to the input the reader is parsing, and marks the input
+    as possibly incomplete. Call readNext() again after a
+    QJsonParseError::PrematureEndOfDocument error to continue.
+
+    If all previously added data has been consumed, the reader keeps a
+    shallow copy of \a data instead of copying it.
+
+    Does nothing if a device has been set.
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+
+    d->dataComplete = false;
+    if (d->pos == d->buffer.size()) {
+        d->bufferOffset += d->pos;
+        d->pos = 0;
+        d->buffer = data;
+        return;
+    }
+
+    if (d->pos) {
+        d->bufferOffset += d->pos;
+        d->buffer = d->buffer.mid(d->pos);
+        d->pos = 0;
+    }
+    d->buffer.append(data);
+}
+
+/*!
+    Removes any device() or data from the reader and resets its internal
+    state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    d->device = nullptr;
+    d->reset();
+}
+
+/*!
+    If \a allowed is true, the reader accepts any number of JSON values
+    separated by whitespace, such as the lines of a JSON Lines file, instead
+    of exactly one. In that mode an input consisting only of whitespace is
+    not an error, and the end of each value is recognized by depth()
+    returning to zero.
+
+    The default is false.
+
+    \sa multipleDocumentsAllowed()
+*/
+void QJsonStreamReader::setMultipleDocumentsAllowed(bool allowed)
+{
+    d->multipleDocuments = allowed;
+    if (allowed && d->state == QJsonStreamReaderPrivate::DocumentEnded)
+        d->state = QJsonStreamReaderPrivate::ExpectValue;
+}
+
+/*!
+    Returns true if the reader accepts more than one JSON value.
+
+    \sa setMultipleDocumentsAllowed()
+*/
+bool QJsonStreamReader::multipleDocumentsAllowed() const
+{
+    return d->multipleDocuments;
+}
+
+/*!
+    Returns true if the reader has read until the end of the input, or if an
+    error has occurred and reading has been aborted. Otherwise, it returns
+    false.
+
+    As with QXmlStreamReader, this also returns true while error() is
+    QJsonParseError::PrematureEndOfDocument; in that case more data can be
+    added and reading continued.
+
+    \sa hasError(), error(), readNext()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->type == EndDocument || d->error != QJsonParseError::NoError;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    With one exception, once an error() is reported by readNext(), further
+    reading of the input is not possible and atEnd() returns true. The
+    exception is QJsonParseError::PrematureEndOfDocument: the reader has
+    reached the end of the data without the input being complete, and
+    continues where it left off when readNext() is called after more data
+    has arrived.
+
+    \sa tokenType(), tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    if (d->type == EndDocument)
+        return EndDocument;
+    if (d->error != QJsonParseError::NoError) {
+        if (d->error != QJsonParseError::PrematureEndOfDocument)
+            return Invalid;
+        d->error = QJsonParseError::NoError;
+    }
+
+    forever {
+        const TokenType t = d->scan(false);
+        if (t != NoToken)
+            return t;
+        if (d->fillBuffer())
+            continue;
+        if (d->atInputEnd() || d->state == QJsonStreamReaderPrivate::DocumentEnded)
+            return d->scan(true);
+        return d->raise(QJsonParseError::PrematureEndOfDocument);
+    }
+}
+
+/*!
+    Skips the current value: if the current token is a Name, the member's
+    value; if it is StartObject or StartArray, everything up to and including
+    the matching EndObject or EndArray. For scalar tokens, this function does
+    nothing. Strings inside the skipped value are validated but not decoded.
+
+    Returns true on success, false if an error was encountered.
+
+    \sa readNext()
+*/
+bool QJsonStreamReader::skipCurrentValue()
+{
+    if (d->type == Name) {
+        d->decode = false;
+        readNext();
+        d->decode = true;
+    }
+    if (d->type == StartObject || d->type == StartArray) {
+        const int target = depth() - 1;
+        d->decode = false;
+        while (depth() > target && readNext() != Invalid) {
+        }
+        d->decode = true;
+    }
+    return !hasError();
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->type;
+}
+
+/*!
+    Returns the name of the current token type as a string.
+
+    \sa tokenType()
+*/
+QString QJsonStreamReader::tokenString() const
+{
+    static const char names[][12] = {
+        "NoToken", "Invalid", "StartObject", "EndObject", "StartArray", "EndArray",
+        "Name", "String", "Number", "Bool", "Null", "EndDocument"
+    };
+    return QLatin1String(names[d->type]);
+}
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns true if tokenType() equals \l StartObject; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns true if tokenType() equals \l EndObject; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns true if tokenType() equals \l StartArray; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns true if tokenType() equals \l EndArray; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isName() const
+
+    Returns true if tokenType() equals \l Name; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isString() const
+
+    Returns true if tokenType() equals \l String; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNumber() const
+
+    Returns true if tokenType() equals \l Number; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isBool() const
+
+    Returns true if tokenType() equals \l Bool; otherwise returns false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNull() const
+
+    Returns true if tokenType() equals \l Null; otherwise returns false.
+*/
+
+/*!
+    Returns the number of objects and arrays enclosing the reader's current
+    position. After a StartObject or StartArray token, the new container is
+    included; after an EndObject or EndArray token, it is not.
+*/
+int QJsonStreamReader::depth() const
+{
+    return d->containers.size();
+}
+
+/*!
+    Returns the offset in bytes from the start of the input of the current
+    token, or of the error if an error has occurred.
+*/
+qint64 QJsonStreamReader::offset() const
+{
+    return d->tokenOffset;
+}
+
+/*!
+    Returns the most recently read member name. It stays valid while the
+    member's value is being read, until the next Name token.
+*/
+QString QJsonStreamReader::name() const
+{
+    return d->name;
+}
+
+/*!
+    Returns the value of the current String token, or a null string for
+    other tokens.
+*/
+QString QJsonStreamReader::stringValue() const
+{
+    return d->type == String ? d->string : QString();
+}
+
+/*!
+    Returns true if the current token is a Number that is exactly
+    representable as a 64-bit integer.
+
+    \sa integerValue(), doubleValue()
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    return d->type == Number && d->isInteger;
+}
+
+/*!
+    Returns the value of the current Number token as an integer. If the
+    number is not an integer, it is truncated.
+
+    \sa isInteger()
+*/
+qint64 QJsonStreamReader::integerValue() const
+{
+    if (d->type != Number)
+        return 0;
+    return d->isInteger ? d->integer : qint64(d->doubleValue);
+}
+
+/*!
+    Returns the value of the current Number token as a double.
+
+    \sa isInteger()
+*/
+double QJsonStreamReader::doubleValue() const
+{
+    if (d->type != Number)
+        return 0;
+    return d->isInteger ? double(d->integer) : d->doubleValue;
+}
+
+/*!
+    Returns the value of the current Bool token.
+*/
+bool QJsonStreamReader::boolValue() const
+{
+    return d->type == Bool && d->boolean;
+}
+
+/*!
+    Returns the current scalar token as a QJsonValue. For StartObject,
+    StartArray and all other non-value tokens, returns an undefined
+    QJsonValue.
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    switch (d->type) {
+    case String:
+        return QJsonValue(d->string);
+    case Number:
+        return d->isInteger ? QJsonValue(d->integer) : QJsonValue(d->doubleValue);
+    case Bool:
+        return QJsonValue(d->boolean);
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    Returns the type of the current error, or QJsonParseError::NoError if no
+    error occurred.
+
+    \sa errorString(), hasError()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    return d->error;
+}
+
+/*!
+    Returns the human readable message for the current error, or an empty
+    string if no error occurred.
+
+    \sa error()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    if (d->error == QJsonParseError::NoError)
+        return QString();
+    return QJsonParseError{int(d->tokenOffset), d->error}.errorString();
+}
+
+/*!
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa error()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->error != QJsonParseError::NoError;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
@@ -1597,7 +1597,7 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         return StreamEOF;
     }
 #else
-    readBuffer = QString::fromLatin1(rawReadBuffer.data(), nbytesread);
+    readBuffer = QString::fromLatin1(rawReadBuffer.constData(), nbytesread);
 #endif // textcodec
 
     readBuffer.reserve(1); // keep capacity when calling resize() next time
@@ -1872,7 +1872,7 @@ void QXmlStreamReaderPrivate::startDocument()
                 err = QXmlStream::tr("%1 is an invalid encoding name.").arg(value);
             else {
 #if !QT_CONFIG(textcodec)
-                readBuffer = QString::fromLatin1(rawReadBuffer.data(), nbytesread);
+                readBuffer = QString::fromLatin1(rawReadBuffer.constData(), nbytesread);
 #else
                 QTextCodec *const newCodec = QTextCodec::codecForName(value.toLatin1());
                 if (!newCodec)
@@ -1881,7 +1881,7 @@ void QXmlStreamReaderPrivate::startDocument()
                     codec = newCodec;
                     delete decoder;
                     decoder = codec->makeDecoder();
-                    decoder->toUnicode(&readBuffer, rawReadBuffer.data(), nbytesread);
+                    decoder->toUnicode(&readBuffer, rawReadBuffer.constData(), nbytesread);
                 }
 #endif // textcodec
             }
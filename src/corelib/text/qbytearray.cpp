@@ -4527,6 +4527,31 @@ QByteArray QByteArray::fromRawData(const char *data, int size)
     return QByteArray(dataPtr);
 }
 
+/*!
+    \internal
+    \since 5.15
+
+    Works like QByteArray::fromRawData(), except that the returned byte array
+    and its copies keep \a data alive: \a cleanup is called with
+    \a cleanupInfo when the last of them is destroyed or detached. If no byte
+    array could be created, \a cleanup is called right away.
+*/
+QByteArray qByteArrayFromExternalData(const char *data, int size,
+                                      QArrayDataCleanupFunction cleanup, void *cleanupInfo)
+{
+    Q_ASSERT(cleanup);
+    if (!data || !size) {
+        cleanup(cleanupInfo);
+        return QByteArray::fromRawData(data, size);
+    }
+
+    QByteArrayData *x = QTypedArrayData<char>::fromRawData(data, size);
+    Q_CHECK_PTR(x);
+    qSetArrayDataCleanup(x, cleanup, cleanupInfo);
+    QByteArrayDataPtr dataPtr = { x };
+    return QByteArray(dataPtr);
+}
+
 QByteArray QByteArray::fromNulTerminatedRawData(const char *data, int size)
 {
     Q_CHECK_PTR(data);
@@ -60,6 +60,10 @@ QT_BEGIN_NAMESPACE
 constexpr qsizetype MaxByteArraySize = MaxAllocSize - sizeof(std::remove_pointer<QByteArray::DataPtr>::type) - 1;
 constexpr qsizetype MaxStringSize = (MaxAllocSize - sizeof(std::remove_pointer<QByteArray::DataPtr>::type)) / 2 - 1;
 
+Q_CORE_EXPORT QByteArray qByteArrayFromExternalData(const char *data, int size,
+                                                    QArrayDataCleanupFunction cleanup,
+                                                    void *cleanupInfo);
+
 QT_END_NAMESPACE
 
 #endif // QBYTEARRAY_P_H
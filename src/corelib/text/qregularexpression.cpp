@@ -42,6 +42,8 @@
 #include "qregularexpression.h"
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qvector.h>
@@ -407,6 +409,20 @@ QT_BEGIN_NAMESPACE
     text) would have been \c{"abcabc"}; by matching only against the leading
     \c{"abc"} we instead get a partial match.
 
+    \section1 Pattern Cache
+
+    Compiling a pattern can take a noticeable amount of time, so
+    QRegularExpression keeps the compiled patterns in a process-wide cache,
+    shared by all threads. Regular expressions with the same pattern and
+    pattern options compile it only once, even if they were constructed
+    independently of each other. The cache holds up to
+    patternCacheCapacity() patterns, dropping the least recently used ones
+    beyond that; patternCacheStatistics() reports how effective it is.
+
+    To avoid compiling a fixed set of patterns again every time an
+    application starts, serializeCompiledPatterns() returns their compiled
+    code, which deserializeCompiledPatterns() loads in a later run.
+
     \section1 Error Handling
 
     It is possible for a QRegularExpression object to be invalid because of
@@ -844,6 +860,25 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    A compiled (and, if enabled, JIT-compiled) pattern. PCRE2 never modifies
+    the compiled code when matching, so the same code can be shared by any
+    number of QRegularExpression objects, in any thread.
+*/
+struct QRegularExpressionCompiledCode : QSharedData
+{
+    explicit QRegularExpressionCompiledCode(pcre2_code_16 *code)
+        : code(code)
+    {}
+    ~QRegularExpressionCompiledCode()
+    {
+        pcre2_code_free_16(code);
+    }
+    Q_DISABLE_COPY_MOVE(QRegularExpressionCompiledCode)
+
+    pcre2_code_16 * const code;
+};
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -852,6 +887,7 @@ struct QRegularExpressionPrivate : QSharedData
 
     void cleanCompiledPattern();
     void compilePattern();
+    void setCompiledCode(const QExplicitlySharedDataPointer<QRegularExpressionCompiledCode> &code);
     void getPatternInfo();
     void optimizePattern();
 
@@ -880,9 +916,11 @@ struct QRegularExpressionPrivate : QSharedData
     // (right after a detach happened).
     mutable QMutex mutex;
 
-    // The PCRE code pointer is reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // it is set to nullptr
+    // The compiled code is shared with the pattern cache and with the other
+    // QRegularExpressionPrivate objects using the same pattern and options;
+    // compiledPattern points into it. When the private is copied (i.e. a
+    // detach happened) both are reset.
+    QExplicitlySharedDataPointer<QRegularExpressionCompiledCode> compiledCode;
     pcre2_code_16 *compiledPattern;
     int errorCode;
     int errorOffset;
@@ -996,7 +1034,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre2_code_free_16(compiledPattern);
+    compiledCode.reset();
     compiledPattern = nullptr;
     errorCode = 0;
     errorOffset = -1;
@@ -1004,6 +1042,125 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
     usingCrLfNewlines = false;
 }
 
+struct QRegularExpressionCacheKey
+{
+    QString pattern;
+    QRegularExpression::PatternOptions patternOptions;
+};
+
+static inline bool operator==(const QRegularExpressionCacheKey &lhs, const QRegularExpressionCacheKey &rhs)
+{
+    return lhs.patternOptions == rhs.patternOptions && lhs.pattern == rhs.pattern;
+}
+
+static inline uint qHash(const QRegularExpressionCacheKey &key, uint seed = 0) noexcept
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.pattern);
+    seed = hash(seed, key.patternOptions);
+    return seed;
+}
+
+/*
+    The process-wide cache of compiled patterns: QRegularExpression objects
+    with the same pattern and options compile it only once, no matter where
+    they were created. The cache holds up to capacity() patterns and drops
+    the least recently used ones beyond that; a dropped pattern stays alive
+    as long as some QRegularExpression still uses it.
+*/
+class QRegularExpressionPatternCache
+{
+public:
+    typedef QExplicitlySharedDataPointer<QRegularExpressionCompiledCode> CodePointer;
+
+    enum { DefaultCapacity = 256 };
+
+    QRegularExpressionPatternCache()
+        : cache(DefaultCapacity)
+    {}
+
+    CodePointer find(const QRegularExpressionCacheKey &key)
+    {
+        const QMutexLocker lock(&mutex);
+        if (const CodePointer *code = cache.object(key)) {
+            ++hits;
+            return *code;
+        }
+        ++misses;
+        return CodePointer();
+    }
+
+    // Returns the code to use for key: code itself, or the cached one if
+    // another thread compiled the same pattern in the meantime.
+    CodePointer insert(const QRegularExpressionCacheKey &key, const CodePointer &code)
+    {
+        const QMutexLocker lock(&mutex);
+        if (const CodePointer *cached = cache.object(key))
+            return *cached;
+        const int count = cache.count();
+        if (cache.insert(key, new CodePointer(code)))
+            evictions += count + 1 - cache.count();
+        return code;
+    }
+
+    int capacity()
+    {
+        const QMutexLocker lock(&mutex);
+        return cache.maxCost();
+    }
+
+    void setCapacity(int capacity)
+    {
+        const QMutexLocker lock(&mutex);
+        const int count = cache.count();
+        cache.setMaxCost(qMax(capacity, 0));
+        evictions += count - cache.count();
+    }
+
+    QRegularExpression::PatternCacheStatistics statistics()
+    {
+        const QMutexLocker lock(&mutex);
+        return { hits, misses, evictions, cache.count(), cache.maxCost() };
+    }
+
+    void clear()
+    {
+        const QMutexLocker lock(&mutex);
+        cache.clear();
+        hits = misses = evictions = 0;
+    }
+
+private:
+    QMutex mutex;
+    QCache<QRegularExpressionCacheKey, CodePointer> cache;
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 evictions = 0;
+};
+
+Q_GLOBAL_STATIC(QRegularExpressionPatternCache, patternCache)
+
+/*!
+    \internal
+
+    Compiles \a pattern with \a patternOptions, without looking it up in the
+    pattern cache nor JIT-compiling it.
+*/
+static pcre2_code_16 *compileCode(const QString &pattern,
+                                  QRegularExpression::PatternOptions patternOptions,
+                                  int *errorCode, PCRE2_SIZE *errorOffset)
+{
+    int options = convertToPcreOptions(patternOptions);
+    options |= PCRE2_UTF;
+
+    return pcre2_compile_16(pattern.utf16(),
+                            pattern.length(),
+                            options,
+                            errorCode,
+                            errorOffset,
+                            nullptr);
+}
+
 /*!
     \internal
 */
@@ -1017,26 +1174,44 @@ void QRegularExpressionPrivate::compilePattern()
     isDirty = false;
     cleanCompiledPattern();
 
-    int options = convertToPcreOptions(patternOptions);
-    options |= PCRE2_UTF;
+    const QRegularExpressionCacheKey key = { pattern, patternOptions };
+    QRegularExpressionPatternCache *cache = patternCache();
+    if (cache) {
+        if (const auto code = cache->find(key)) {
+            setCompiledCode(code);
+            return;
+        }
+    }
 
     PCRE2_SIZE patternErrorOffset;
-    compiledPattern = pcre2_compile_16(pattern.utf16(),
-                                       pattern.length(),
-                                       options,
-                                       &errorCode,
-                                       &patternErrorOffset,
-                                       nullptr);
+    compiledPattern = compileCode(pattern, patternOptions, &errorCode, &patternErrorOffset);
 
     if (!compiledPattern) {
         errorOffset = static_cast<int>(patternErrorOffset);
         return;
-    } else {
-        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
-        errorCode = 0;
     }
 
     optimizePattern();
+
+    QExplicitlySharedDataPointer<QRegularExpressionCompiledCode> code(
+                new QRegularExpressionCompiledCode(compiledPattern));
+    setCompiledCode(cache ? cache->insert(key, code) : code);
+}
+
+/*!
+    \internal
+
+    Makes this regular expression use the already compiled \a code.
+*/
+void QRegularExpressionPrivate::setCompiledCode(const QExplicitlySharedDataPointer<QRegularExpressionCompiledCode> &code)
+{
+    Q_ASSERT(code);
+
+    compiledCode = code;
+    compiledPattern = code->code;
+    // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
+    errorCode = 0;
+    errorOffset = -1;
     getPatternInfo();
 }
 
@@ -1140,7 +1315,8 @@ static bool isJitEnabled()
     JIT-compiles the pattern.
 
     It gets called when a pattern is recompiled by us (in compilePattern()),
-    under mutex protection.
+    under mutex protection, or loaded by deserializeCompiledPatterns(), before
+    the compiled code gets shared with other QRegularExpression objects.
 */
 void QRegularExpressionPrivate::optimizePattern()
 {
@@ -2118,6 +2294,257 @@ QString QRegularExpression::anchoredPattern(QStringView expression)
            + QLatin1String(")\\z");
 }
 
+/*!
+    \class QRegularExpression::PatternCacheStatistics
+    \inmodule QtCore
+    \since 5.15
+
+    \brief The PatternCacheStatistics struct describes the use of the
+    process-wide cache of compiled patterns.
+
+    \sa QRegularExpression::patternCacheStatistics(), {Pattern Cache}
+*/
+
+/*!
+    \variable QRegularExpression::PatternCacheStatistics::hits
+
+    The number of times a pattern was found in the cache, and therefore
+    not compiled again.
+*/
+
+/*!
+    \variable QRegularExpression::PatternCacheStatistics::misses
+
+    The number of times a pattern had to be compiled because it was not
+    in the cache.
+*/
+
+/*!
+    \variable QRegularExpression::PatternCacheStatistics::evictions
+
+    The number of patterns dropped from the cache to stay within its
+    capacity.
+*/
+
+/*!
+    \variable QRegularExpression::PatternCacheStatistics::count
+
+    The number of patterns currently in the cache.
+*/
+
+/*!
+    \variable QRegularExpression::PatternCacheStatistics::capacity
+
+    The maximum number of patterns the cache holds.
+*/
+
+/*!
+    \since 5.15
+
+    Returns the maximum number of compiled patterns kept in the process-wide
+    pattern cache. The default is 256.
+
+    \sa setPatternCacheCapacity(), {Pattern Cache}
+*/
+int QRegularExpression::patternCacheCapacity()
+{
+    QRegularExpressionPatternCache *cache = patternCache();
+    return cache ? cache->capacity() : 0;
+}
+
+/*!
+    \since 5.15
+
+    Sets the maximum number of compiled patterns kept in the process-wide
+    pattern cache to \a capacity, dropping the least recently used patterns
+    if the cache holds more than that. A \a capacity of 0 disables the cache.
+
+    Patterns dropped from the cache remain valid for the QRegularExpression
+    objects that use them.
+
+    \sa patternCacheCapacity(), {Pattern Cache}
+*/
+void QRegularExpression::setPatternCacheCapacity(int capacity)
+{
+    if (QRegularExpressionPatternCache *cache = patternCache())
+        cache->setCapacity(capacity);
+}
+
+/*!
+    \since 5.15
+
+    Returns the number of hits, misses and evictions of the process-wide
+    pattern cache since it was last cleared, as well as its current size
+    and capacity.
+
+    \sa clearPatternCache(), {Pattern Cache}
+*/
+QRegularExpression::PatternCacheStatistics QRegularExpression::patternCacheStatistics()
+{
+    QRegularExpressionPatternCache *cache = patternCache();
+    return cache ? cache->statistics() : PatternCacheStatistics{ 0, 0, 0, 0, 0 };
+}
+
+/*!
+    \since 5.15
+
+    Removes all the patterns from the process-wide pattern cache and resets
+    its statistics. The capacity is not changed.
+
+    \sa patternCacheStatistics(), {Pattern Cache}
+*/
+void QRegularExpression::clearPatternCache()
+{
+    if (QRegularExpressionPatternCache *cache = patternCache())
+        cache->clear();
+}
+
+#ifndef QT_NO_DATASTREAM
+static const quint32 CompiledPatternsMagic = 0x51524543; // "QREC"
+static const quint32 CompiledPatternsVersion = 1;
+
+/*!
+    \since 5.15
+
+    Compiles the patterns of \a expressions and returns the compiled code,
+    together with the patterns and their options, in a form that
+    deserializeCompiledPatterns() can load without compiling the patterns
+    again. Applications with a large, fixed set of regular expressions can
+    use this to save the compilation time at startup, by storing the
+    returned data (for instance in a cache file) after the first run.
+
+    The data can only be loaded by a Qt build using the same version of
+    PCRE2, with the same configuration, on the same architecture. JIT
+    compiled code is not included; deserializeCompiledPatterns() JIT
+    compiles the patterns again if the JIT is enabled.
+
+    Returns an empty QByteArray if one of the \a expressions is invalid.
+
+    \sa deserializeCompiledPatterns(), isValid()
+*/
+QByteArray QRegularExpression::serializeCompiledPatterns(const QList<QRegularExpression> &expressions)
+{
+    QVector<const pcre2_code_16 *> codes;
+    codes.reserve(expressions.size());
+    for (const QRegularExpression &re : expressions) {
+        re.d.data()->compilePattern();
+        if (!re.d->compiledPattern)
+            return QByteArray();
+        codes.append(re.d->compiledPattern);
+    }
+
+    QByteArray code;
+    if (!codes.isEmpty()) {
+        uint8_t *bytes = nullptr;
+        PCRE2_SIZE size = 0;
+        int result = pcre2_serialize_encode_16(codes.data(), codes.size(), &bytes, &size, nullptr);
+        if (result == PCRE2_ERROR_MIXEDTABLES) {
+            // PCRE2 stores one set of character tables for all the codes, and
+            // each deserialized set of codes got its own copy of them. Compile
+            // the patterns again, so that they all use the default tables.
+            QVector<pcre2_code_16 *> copies;
+            copies.reserve(expressions.size());
+            for (const QRegularExpression &re : expressions) {
+                int errorCode;
+                PCRE2_SIZE errorOffset;
+                pcre2_code_16 *copy = compileCode(re.d->pattern, re.d->patternOptions,
+                                                  &errorCode, &errorOffset);
+                if (!copy)
+                    break;
+                copies.append(copy);
+            }
+            if (copies.size() == expressions.size()) {
+                result = pcre2_serialize_encode_16(const_cast<const pcre2_code_16 **>(copies.data()),
+                                                   copies.size(), &bytes, &size, nullptr);
+            }
+            for (pcre2_code_16 *copy : qAsConst(copies))
+                pcre2_code_free_16(copy);
+        }
+        if (result < 0)
+            return QByteArray();
+        code = QByteArray(reinterpret_cast<const char *>(bytes), int(size));
+        pcre2_serialize_free_16(bytes);
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << CompiledPatternsMagic << CompiledPatternsVersion << expressions << code
+        << QCryptographicHash::hash(code, QCryptographicHash::Sha1);
+    return data;
+}
+
+/*!
+    \since 5.15
+
+    Loads the regular expressions that serializeCompiledPatterns() stored in
+    \a data, without compiling their patterns again. The returned
+    expressions are in the order they were passed to
+    serializeCompiledPatterns(), and their compiled patterns are also added
+    to the process-wide pattern cache, so that other QRegularExpression
+    objects with the same patterns and options use them too.
+
+    Returns an empty list if \a data was not created by
+    serializeCompiledPatterns(), is corrupted, or was created by a Qt build
+    with an incompatible PCRE2 version or configuration.
+
+    \warning PCRE2 does not validate the compiled code it loads. Only load
+    data that this application created itself and stored where it cannot be
+    modified by others; the checksum included in \a data detects accidental
+    corruption, not tampering.
+
+    \sa serializeCompiledPatterns()
+*/
+QList<QRegularExpression> QRegularExpression::deserializeCompiledPatterns(const QByteArray &data)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_15);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != CompiledPatternsMagic || version != CompiledPatternsVersion)
+        return QList<QRegularExpression>();
+
+    QList<QRegularExpression> expressions;
+    QByteArray code;
+    QByteArray checksum;
+    in >> expressions >> code >> checksum;
+    if (in.status() != QDataStream::Ok
+            || checksum != QCryptographicHash::hash(code, QCryptographicHash::Sha1)) {
+        return QList<QRegularExpression>();
+    }
+    if (expressions.isEmpty())
+        return expressions;
+
+    // PCRE2's header is four 32-bit fields; pcre2_serialize_decode_16()
+    // checks the magic number, version and configuration in it
+    const auto bytes = reinterpret_cast<const uint8_t *>(code.constData());
+    if (code.size() < int(4 * sizeof(quint32))
+            || pcre2_serialize_get_number_of_codes_16(bytes) != expressions.size()) {
+        return QList<QRegularExpression>();
+    }
+    QVector<pcre2_code_16 *> codes(expressions.size());
+    if (pcre2_serialize_decode_16(codes.data(), codes.size(), bytes, nullptr) != codes.size())
+        return QList<QRegularExpression>();
+
+    QRegularExpressionPatternCache *cache = patternCache();
+    for (int i = 0; i < expressions.size(); ++i) {
+        QRegularExpressionPrivate *d = expressions[i].d.data();
+        const QMutexLocker lock(&d->mutex);
+        d->isDirty = false;
+        d->cleanCompiledPattern();
+        d->compiledPattern = codes.at(i);
+        d->optimizePattern();
+
+        QExplicitlySharedDataPointer<QRegularExpressionCompiledCode> compiled(
+                    new QRegularExpressionCompiledCode(codes.at(i)));
+        const QRegularExpressionCacheKey key = { d->pattern, d->patternOptions };
+        d->setCompiledCode(cache ? cache->insert(key, compiled) : compiled);
+    }
+    return expressions;
+}
+#endif // QT_NO_DATASTREAM
+
 /*!
     \since 5.1
 
@@ -160,6 +160,25 @@ public:
     static QString wildcardToRegularExpression(QStringView str);
     static QString anchoredPattern(QStringView expression);
 
+    struct PatternCacheStatistics
+    {
+        qint64 hits;
+        qint64 misses;
+        qint64 evictions;
+        int count;
+        int capacity;
+    };
+
+    static int patternCacheCapacity();
+    static void setPatternCacheCapacity(int capacity);
+    static PatternCacheStatistics patternCacheStatistics();
+    static void clearPatternCache();
+
+#ifndef QT_NO_DATASTREAM
+    static QByteArray serializeCompiledPatterns(const QList<QRegularExpression> &expressions);
+    static QList<QRegularExpression> deserializeCompiledPatterns(const QByteArray &data);
+#endif
+
     bool operator==(const QRegularExpression &re) const;
     inline bool operator!=(const QRegularExpression &re) const { return !operator==(re); }
 
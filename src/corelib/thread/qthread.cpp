@@ -43,6 +43,7 @@
 #include "qmutex.h"
 #include "qreadwritelock.h"
 #include "qabstracteventdispatcher.h"
+#include "qvarlengtharray.h"
 
 #include <qeventloop.h>
 
@@ -93,6 +94,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    flushQueuedMetaCalls();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -105,6 +107,42 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+void QThreadData::flushQueuedMetaCalls_helper()
+{
+    // The list can be long if the senders outpace this thread, and its
+    // events are no longer in the cache: walk it once to restore posting
+    // order, then prefetch ahead while adding the events.
+    QVarLengthArray<QMetaCallEvent *, 64> events;
+    for (QMetaCallEvent *event = queuedMetaCalls.takeAll(); event; event = QQueuedMetaCallList::next(event))
+        events.append(event);
+    postEventList.reserve(postEventList.size() + events.size());
+
+    for (int i = events.size() - 1; i >= 0; --i) {
+#if defined(Q_CC_GNU)
+        if (i >= 8)
+            __builtin_prefetch(events.at(i - 8));
+#endif
+        QMetaCallEvent *event = events.at(i);
+        QObject *receiver = QQueuedMetaCallList::receiver(event);
+        QObjectPrivate *d = QObjectPrivate::get(receiver);
+        QThreadData *receiverData = d->threadData.loadAcquire();
+        if (receiverData && receiverData != this) {
+            // the receiver was moved to another thread while the event was
+            // being queued, see QCoreApplicationPrivate::postQueuedMetaCall()
+            if (receiverData->queuedMetaCalls.push(receiver, event) && receiverData->hasEventDispatcher())
+                receiverData->eventDispatcher.loadRelaxed()->wakeUp();
+        } else {
+            postEventList.addEvent(QPostEvent(receiver, event, Qt::NormalEventPriority));
+            event->posted = true;
+            ++d->postedEvents;
+            // synchronizes with the loadAcquire in ~QObjectPrivate: once it sees
+            // the event gone from queuedMetaCalls, it also sees it in postedEvents
+            d->queuedMetaCalls.deref();
+        }
+    }
+    canWait = false;
+}
+
 void QThreadData::ref()
 {
 #if QT_CONFIG(thread)
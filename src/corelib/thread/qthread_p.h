@@ -143,6 +143,39 @@ private:
     using QVector<QPostEvent>::insert;
 };
 
+// This class holds the QMetaCallEvents that queued connections post to the
+// objects of one thread. Any number of threads can push without taking the
+// postEventList mutex; the events are moved into the postEventList in one go
+// (see QThreadData::flushQueuedMetaCalls()) by whoever next holds that mutex.
+class QQueuedMetaCallList
+{
+public:
+    // returns true if the list was empty, i.e. the thread needs a wake up
+    bool push(QObject *receiver, QMetaCallEvent *event)
+    {
+        event->queuedReceiver_ = receiver;
+        QMetaCallEvent *next = head.loadRelaxed();
+        do {
+            event->queuedNext_ = next;
+        } while (!head.testAndSetOrdered(next, event, next));
+        return !next;
+    }
+
+    // returns the list, newest event first, and leaves it empty
+    QMetaCallEvent *takeAll()
+    {
+        return head.fetchAndStoreOrdered(nullptr);
+    }
+
+    static QObject *receiver(const QMetaCallEvent *event) { return event->queuedReceiver_; }
+    static QMetaCallEvent *next(const QMetaCallEvent *event) { return event->queuedNext_; }
+
+    bool isEmpty() const { return !head.loadAcquire(); }
+
+private:
+    QAtomicPointer<QMetaCallEvent> head;
+};
+
 #if QT_CONFIG(thread)
 
 class Q_CORE_EXPORT QDaemonThread : public QThread
@@ -277,7 +310,15 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && queuedMetaCalls.isEmpty();
+    }
+
+    // must be called with postEventList.mutex locked
+    void flushQueuedMetaCalls()
+    {
+        if (Q_LIKELY(queuedMetaCalls.isEmpty()))
+            return;
+        flushQueuedMetaCalls_helper();
     }
 
     // This class provides per-thread (by way of being a QThreadData
@@ -301,6 +342,8 @@ public:
     };
 
 private:
+    void flushQueuedMetaCalls_helper();
+
     QAtomicInt _ref;
 
 public:
@@ -309,6 +352,10 @@ public:
 
     QStack<QEventLoop *> eventLoops;
     QPostEventList postEventList;
+    QQueuedMetaCallList queuedMetaCalls;
+    // non-zero while moveToThread() moves objects away from this thread,
+    // see QCoreApplicationPrivate::postQueuedMetaCall()
+    QAtomicInt movingObjects;
     QAtomicPointer<QThread> thread;
     QAtomicPointer<void> threadId;
     QAtomicPointer<QAbstractEventDispatcher> eventDispatcher;
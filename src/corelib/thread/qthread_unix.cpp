@@ -54,6 +54,9 @@
 #endif
 
 #include <private/qeventdispatcher_unix_p.h>
+#if QT_CONFIG(epoll)
+#  include <private/qeventdispatcher_epoll_p.h>
+#endif
 
 #include "qthreadstorage.h"
 
@@ -242,6 +245,10 @@ typedef void*(*QtThreadCallback)(void*);
 QAbstractEventDispatcher *QThreadPrivate::createEventDispatcher(QThreadData *data)
 {
     Q_UNUSED(data);
+#if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0)
+        return new QEventDispatcherEpoll;
+#endif
 #if defined(Q_OS_DARWIN)
     bool ok = false;
     int value = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_CORE_FOUNDATION", &ok);
@@ -60,8 +60,12 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+    uint workQueue;
+    quint32 stealSeed;
 };
 
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -71,7 +75,8 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(nullptr)
+    :manager(manager), runnable(nullptr), workQueue(manager->nextThreadQueue++),
+     stealSeed(0x9e3779b9u * (workQueue + 1))
 {
     setStackSize(manager->stackSize);
 }
@@ -81,6 +86,7 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -88,28 +94,36 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                const bool del = r->autoDelete();
-                Q_ASSERT(!del || r->ref == 1);
-
-
                 // run the task
                 locker.unlock();
+                do {
+                    const bool del = r->autoDelete();
+                    Q_ASSERT(!del || r->ref == 1);
+
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+
+                    // in work-stealing mode, keep running queued tasks
+                    // without going through the pool's mutex, unless this
+                    // thread may have to expire; that is checked below
+                    r = manager->workStealing.load(std::memory_order_relaxed)
+                                && !manager->tooManyThreads.load(std::memory_order_relaxed)
+                            ? manager->takeStealableTask(this) : nullptr;
+                } while (r);
                 locker.relock();
             }
 
@@ -117,6 +131,13 @@ void QThreadPoolThread::run()
             if (manager->tooManyThreadsActive())
                 break;
 
+            if (manager->workStealing.load(std::memory_order_relaxed)) {
+                r = manager->takeStealableTask(this);
+                if (!r)
+                    break;
+                continue;
+            }
+
             if (manager->queue.isEmpty()) {
                 r = nullptr;
                 break;
@@ -136,6 +157,18 @@ void QThreadPoolThread::run()
         if (!expired) {
             manager->waitingThreads.enqueue(this);
             registerThreadInactive();
+            if (manager->workStealing.load(std::memory_order_relaxed)) {
+                // Tasks are queued without holding the mutex. Publishing
+                // that a thread is waiting before looking at the task count
+                // (and the reverse order in QThreadPool::start()) guarantees
+                // that either we see the new task or its producer wakes us.
+                manager->updateStealingHint();
+                if (manager->queuedStealableTasks.load() > 0) {
+                    manager->waitingThreads.removeOne(this);
+                    ++manager->activeThreads;
+                    continue;
+                }
+            }
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
             ++manager->activeThreads;
@@ -149,6 +182,7 @@ void QThreadPoolThread::run()
         if (expired) {
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateStealingHint();
             break;
         }
     }
@@ -167,6 +201,11 @@ void QThreadPoolThread::registerThreadInactive()
 QThreadPoolPrivate:: QThreadPoolPrivate()
 { }
 
+QThreadPoolPrivate::~QThreadPoolPrivate()
+{
+    qDeleteAll(workQueues);
+}
+
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
     Q_ASSERT(task != nullptr);
@@ -214,9 +253,8 @@ inline bool comparePriority(int priority, const QueuePage *p)
     return p->priority() < priority;
 }
 
-void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
+static void enqueueInPages(QVector<QueuePage *> &queue, QRunnable *runnable, int priority)
 {
-    Q_ASSERT(runnable != nullptr);
     for (QueuePage *page : qAsConst(queue)) {
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
@@ -227,6 +265,173 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
 }
 
+void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
+{
+    Q_ASSERT(runnable != nullptr);
+    if (workStealing.load(std::memory_order_relaxed)) {
+        enqueueStealableTask(runnable, priority);
+        return;
+    }
+    enqueueInPages(queue, runnable, priority);
+}
+
+QThreadPoolWorkQueue::~QThreadPoolWorkQueue()
+{
+    qDeleteAll(pages);
+}
+
+void QThreadPoolWorkQueue::push(QRunnable *runnable, int priority)
+{
+    QMutexLocker locker(&mutex);
+    enqueueInPages(pages, runnable, priority);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+QRunnable *QThreadPoolWorkQueue::pop()
+{
+    // cheap check so that thieves do not lock every empty queue
+    if (count.load(std::memory_order_relaxed) == 0)
+        return nullptr;
+
+    QMutexLocker locker(&mutex);
+    if (pages.isEmpty())
+        return nullptr;
+
+    QueuePage *page = pages.first();
+    QRunnable *runnable = page->pop();
+    if (page->isFinished()) {
+        pages.removeFirst();
+        delete page;
+    }
+    count.fetch_sub(1, std::memory_order_relaxed);
+    return runnable;
+}
+
+bool QThreadPoolWorkQueue::tryTake(QRunnable *runnable)
+{
+    QMutexLocker locker(&mutex);
+    for (QueuePage *page : qAsConst(pages)) {
+        if (page->tryTake(runnable)) {
+            if (page->isFinished()) {
+                pages.removeOne(page);
+                delete page;
+            }
+            count.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Queues \a runnable in work-stealing mode. Runnables started from one of
+    the pool's threads go to that thread's queue, all others are spread
+    round-robin over the queues. Does not need the pool's mutex.
+*/
+void QThreadPoolPrivate::enqueueStealableTask(QRunnable *runnable, int priority)
+{
+    const uint queueCount = uint(workQueues.size());
+    uint index;
+    if (currentPoolThread && currentPoolThread->manager == this)
+        index = currentPoolThread->workQueue;
+    else
+        index = nextWorkQueue.fetch_add(1, std::memory_order_relaxed);
+    // Count the task before it becomes visible: once pushed, it may be taken
+    // and the count decremented right away. Waiting threads that see the
+    // count before the push lands just look at the queues again.
+    ++queuedStealableTasks;
+    workQueues.at(index % queueCount)->push(runnable, priority);
+}
+
+/*!
+    \internal
+
+    Returns the next runnable for \a thread in work-stealing mode, taking it
+    from the thread's own queue first and otherwise stealing from the other
+    queues, starting at a random one. Returns \c nullptr if all queues are
+    empty. Does not need the pool's mutex.
+*/
+QRunnable *QThreadPoolPrivate::takeStealableTask(QThreadPoolThread *thread)
+{
+    if (queuedStealableTasks.load(std::memory_order_relaxed) <= 0)
+        return nullptr;
+
+    const uint queueCount = uint(workQueues.size());
+    const uint home = thread->workQueue % queueCount;
+    QRunnable *runnable = workQueues.at(home)->pop();
+    if (!runnable) {
+        // xorshift32; good enough to keep thieves from piling onto one queue
+        quint32 x = thread->stealSeed;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        thread->stealSeed = x;
+
+        const uint first = x % queueCount;
+        for (uint i = 0; i < queueCount && !runnable; ++i) {
+            const uint victim = (first + i) % queueCount;
+            if (victim != home)
+                runnable = workQueues.at(victim)->pop();
+        }
+    }
+
+    if (runnable)
+        --queuedStealableTasks;
+    return runnable;
+}
+
+/*!
+    \internal
+
+    Wakes up or starts a thread that will look for queued runnables in
+    work-stealing mode. Returns \c false if the thread limit was reached.
+*/
+bool QThreadPoolPrivate::startStealingThread()
+{
+    if (!allThreads.isEmpty() && activeThreadCount() >= maxThreadCount)
+        return false;
+
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+        return true;
+    }
+
+    if (!expiredThreads.isEmpty()) {
+        // restart an expired thread
+        QThreadPoolThread *thread = expiredThreads.dequeue();
+        Q_ASSERT(thread->runnable == nullptr);
+
+        ++activeThreads;
+
+        // Ensure that the thread has actually finished, otherwise the following
+        // start() has no effect.
+        thread->wait();
+        Q_ASSERT(thread->isFinished());
+        thread->start();
+        return true;
+    }
+
+    startThread();
+    return true;
+}
+
+/*!
+    \internal
+
+    Records whether a newly queued runnable might need a thread to be woken
+    up or started, so that QThreadPool::start() only takes the mutex in that
+    case, and whether a thread should expire after its current task.
+*/
+void QThreadPoolPrivate::updateStealingHint()
+{
+    needsThreads.store(!waitingThreads.isEmpty()
+                       || allThreads.isEmpty()
+                       || activeThreadCount() < maxThreadCount);
+    tooManyThreads.store(tooManyThreadsActive(), std::memory_order_relaxed);
+}
+
 int QThreadPoolPrivate::activeThreadCount() const
 {
     return (allThreads.count()
@@ -237,6 +442,17 @@ int QThreadPoolPrivate::activeThreadCount() const
 
 void QThreadPoolPrivate::tryToStartMoreThreads()
 {
+    if (workStealing.load(std::memory_order_relaxed)) {
+        // make sure there is a thread for each queued task, as far as the
+        // thread limit allows; running threads will steal the rest
+        for (int pending = queuedStealableTasks.load(); pending > 0; --pending) {
+            if (!startStealingThread())
+                break;
+        }
+        updateStealingHint();
+        return;
+    }
+
     // try to push tasks on the queue to any available threads
     while (!queue.isEmpty()) {
         QueuePage *page = queue.first();
@@ -263,7 +479,8 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 */
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
-    Q_ASSERT(runnable != nullptr);
+    // in work-stealing mode, new threads may start out looking for work
+    Q_ASSERT(runnable != nullptr || workStealing.load(std::memory_order_relaxed));
     QScopedPointer <QThreadPoolThread> thread(new QThreadPoolThread(this));
     thread->setObjectName(QLatin1String("Thread (pooled)"));
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
@@ -297,6 +514,17 @@ void QThreadPoolPrivate::reset()
     }
 
     mutex.lock();
+    updateStealingHint();
+}
+
+/*!
+    \internal
+
+    Returns \c true if no runnables are queued or running.
+*/
+bool QThreadPoolPrivate::isDone() const
+{
+    return queue.isEmpty() && queuedStealableTasks.load() == 0 && activeThreads == 0;
 }
 
 /*!
@@ -306,10 +534,10 @@ void QThreadPoolPrivate::reset()
 */
 bool QThreadPoolPrivate::waitForDone(const QDeadlineTimer &timer)
 {
-    while (!(queue.isEmpty() && activeThreads == 0) && !timer.hasExpired())
+    while (!isDone() && !timer.hasExpired())
         noActiveThreads.wait(&mutex, timer);
 
-    return queue.isEmpty() && activeThreads == 0;
+    return isDone();
 }
 
 bool QThreadPoolPrivate::waitForDone(int msecs)
@@ -322,9 +550,9 @@ bool QThreadPoolPrivate::waitForDone(int msecs)
         reset();
         // More threads can be started during reset(), in that case continue
         // waiting if we still have time left.
-    } while ((!queue.isEmpty() || activeThreads) && !timer.hasExpired());
+    } while (!isDone() && !timer.hasExpired());
 
-    return queue.isEmpty() && activeThreads == 0;
+    return isDone();
 }
 
 void QThreadPoolPrivate::clear()
@@ -343,6 +571,18 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+
+    for (QThreadPoolWorkQueue *workQueue : qAsConst(workQueues)) {
+        while (QRunnable *r = workQueue->pop()) {
+            --queuedStealableTasks;
+            if (r->autoDelete()) {
+                Q_ASSERT(r->ref == 1);
+                locker.unlock();
+                delete r;
+                locker.relock();
+            }
+        }
+    }
 }
 
 /*!
@@ -384,6 +624,17 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         }
     }
 
+    for (QThreadPoolWorkQueue *workQueue : qAsConst(d->workQueues)) {
+        if (workQueue->tryTake(runnable)) {
+            --d->queuedStealableTasks;
+            if (runnable->autoDelete()) {
+                Q_ASSERT(runnable->ref == 1);
+                --runnable->ref; // undo ++ref in start()
+            }
+            return true;
+        }
+    }
+
     return false;
 }
 
@@ -455,6 +706,11 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     implementing time-consuming operations that are not visible to the
     QThreadPool.
 
+    By default all queued runnables are kept in a single queue. When many
+    threads start large numbers of small runnables, that queue can become
+    a point of contention; setWorkStealingEnabled() gives every thread its
+    own queue instead, and idle threads steal work from each other.
+
     Note that QThreadPool is a low-level class for managing threads, see
     the Qt Concurrent module for higher level alternatives.
 
@@ -512,6 +768,21 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->workStealing.load(std::memory_order_acquire)) {
+        if (runnable->autoDelete()) {
+            Q_ASSERT(runnable->ref == 0);
+            ++runnable->ref;
+        }
+
+        d->enqueueStealableTask(runnable, priority);
+        // pairs with the waiting logic in QThreadPoolThread::run()
+        if (d->needsThreads.load()) {
+            QMutexLocker locker(&d->mutex);
+            d->tryToStartMoreThreads();
+        }
+        return;
+    }
+
     QMutexLocker locker(&d->mutex);
     if (runnable->autoDelete()) {
         Q_ASSERT(runnable->ref == 0);
@@ -703,6 +974,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateStealingHint();
 }
 
 /*! \property QThreadPool::stackSize
@@ -731,6 +1003,60 @@ uint QThreadPool::stackSize() const
     return d->stackSize;
 }
 
+/*! \property QThreadPool::workStealingEnabled
+
+    This property holds whether the thread pool uses work stealing.
+
+    By default, all runnables waiting to be run are kept in one queue that
+    is shared by all threads of the pool. With work stealing enabled, each
+    thread has its own queue instead: runnables started from one of the
+    pool's threads are queued for that thread, and other runnables are
+    distributed over all queues. A thread that runs out of work takes
+    runnables from the queue of another, randomly chosen, thread. This
+    reduces contention when many small runnables are started, in particular
+    from within other runnables.
+
+    Runnables are still ordered by the \c priority passed to start(), but
+    only within each thread's queue, so a runnable with a higher priority
+    may start after one with a lower priority that was queued elsewhere.
+
+    The property can only be changed while the thread pool has no queued
+    or running runnables, for example right after creating it or after
+    waitForDone(). It must not be changed concurrently with calls to
+    start().
+
+    The default value is \c false.
+
+    \since 5.15
+*/
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    if (d->workStealing.load(std::memory_order_relaxed) == enabled)
+        return;
+
+    if (!d->isDone()) {
+        qWarning("QThreadPool::setWorkStealingEnabled: Cannot change the mode while runnables are queued or running");
+        return;
+    }
+
+    if (enabled && d->workQueues.isEmpty()) {
+        const int queueCount = qMax(d->maxThreadCount, QThread::idealThreadCount());
+        d->workQueues.reserve(queueCount);
+        for (int i = 0; i < queueCount; ++i)
+            d->workQueues.append(new QThreadPoolWorkQueue);
+    }
+    d->updateStealingHint();
+    d->workStealing.store(enabled, std::memory_order_release);
+}
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.load(std::memory_order_relaxed);
+}
+
 /*!
     Releases a thread previously reserved by a call to reserveThread().
 
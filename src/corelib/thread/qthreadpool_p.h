@@ -59,6 +59,8 @@
 #include "QtCore/qqueue.h"
 #include "private/qobject_p.h"
 
+#include <atomic>
+
 QT_REQUIRE_CONFIG(thread);
 
 QT_BEGIN_NAMESPACE
@@ -146,6 +148,26 @@ private:
     QRunnable *m_entries[MaxPageSize];
 };
 
+/*
+    A run queue used in work-stealing mode. Every pool thread has a home
+    queue; tasks are ordered by priority exactly like in the shared queue,
+    but each queue has its own lock, so that threads only contend when
+    they steal from each other.
+*/
+class QThreadPoolWorkQueue
+{
+public:
+    ~QThreadPoolWorkQueue();
+
+    void push(QRunnable *runnable, int priority);
+    QRunnable *pop();
+    bool tryTake(QRunnable *runnable);
+
+    QMutex mutex;
+    QVector<QueuePage *> pages;
+    std::atomic<int> count { 0 };
+};
+
 class QThreadPoolThread;
 class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 {
@@ -154,6 +176,7 @@ class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 
 public:
     QThreadPoolPrivate();
+    ~QThreadPoolPrivate();
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
@@ -164,12 +187,18 @@ public:
 
     void startThread(QRunnable *runnable = nullptr);
     void reset();
+    bool isDone() const;
     bool waitForDone(int msecs);
     bool waitForDone(const QDeadlineTimer &timer);
     void clear();
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    void enqueueStealableTask(QRunnable *task, int priority);
+    QRunnable *takeStealableTask(QThreadPoolThread *thread);
+    bool startStealingThread();
+    void updateStealingHint();
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -182,6 +211,19 @@ public:
     int reservedThreads = 0;
     int activeThreads = 0;
     uint stackSize = 0;
+
+    // work-stealing mode; the queues are created once and never shrink
+    QVector<QThreadPoolWorkQueue *> workQueues;
+    std::atomic<bool> workStealing { false };
+    std::atomic<int> queuedStealableTasks { 0 };
+    // set when a queued task may need a waiting thread to be woken or a new
+    // thread to be started; checked without holding the mutex
+    std::atomic<bool> needsThreads { true };
+    // mirrors tooManyThreadsActive() for threads running stolen tasks
+    // without holding the mutex
+    std::atomic<bool> tooManyThreads { false };
+    std::atomic<uint> nextWorkQueue { 0 };
+    uint nextThreadQueue = 0;
 };
 
 QT_END_NAMESPACE
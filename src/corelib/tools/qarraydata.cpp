@@ -147,6 +147,38 @@ qCalculateGrowingBlockSize(size_t elementCount, size_t elementSize, size_t heade
     return result;
 }
 
+namespace {
+// Headers allocated for raw data are followed by one of these, so that the
+// cleanup travels with the header and deallocate() needs no lookup.
+struct ArrayDataCleanup
+{
+    QArrayDataCleanupFunction function;
+    void *info;
+};
+}
+
+static inline ArrayDataCleanup *rawDataCleanup(QArrayData *header)
+{
+    return reinterpret_cast<ArrayDataCleanup *>(header + 1);
+}
+
+/*!
+    \internal
+    \since 5.15
+
+    Sets \a cleanup to be called with \a info once \a header, which must
+    have been allocated for raw data, is deallocated. This is how a
+    container created with fromRawData() can own the memory it refers to.
+*/
+void qSetArrayDataCleanup(QArrayData *header, QArrayDataCleanupFunction cleanup, void *info)
+{
+    Q_ASSERT(header && header->alloc == 0 && !header->ref.isStatic());
+    ArrayDataCleanup *slot = rawDataCleanup(header);
+    Q_ASSERT(!slot->function);
+    slot->function = cleanup;
+    slot->info = info;
+}
+
 // End of qtools_p.h implementation
 
 const QArrayData QArrayData::shared_null[2] = {
@@ -216,9 +248,12 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
     // Allocate extra (alignment - Q_ALIGNOF(QArrayData)) padding bytes so we
     // can properly align the data array. This assumes malloc is able to
     // provide appropriate alignment for the header -- as it should!
-    // Padding is skipped when allocating a header for RawData.
+    // Padding is skipped when allocating a header for RawData, which gets
+    // room for its cleanup instead.
     if (!(options & RawData))
         headerSize += (alignment - Q_ALIGNOF(QArrayData));
+    else
+        headerSize += sizeof(ArrayDataCleanup);
 
     if (headerSize > size_t(MaxAllocSize))
         return nullptr;
@@ -246,6 +281,8 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
         // XXX: always store the bounded pointer for purecap to make this more efficient?
         // We always use an offset except for fromRawData()
         header->setOffset(reinterpret_cast<const char*>(data) - reinterpret_cast<const char*>(header));
+        if (options & RawData)
+            *rawDataCleanup(header) = ArrayDataCleanup{ nullptr, nullptr };
     }
 
     Q_ASSERT(qIsAligned(header, alignof(void *)));
@@ -287,6 +324,15 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
 
     Q_ASSERT_X(data == nullptr || !data->ref.isStatic(), "QArrayData::deallocate",
                "Static data cannot be deleted");
+
+    // only headers for raw data have no capacity
+    if (data && data->alloc == 0) {
+        const ArrayDataCleanup cleanup = *rawDataCleanup(data);
+        ::free(data);
+        if (cleanup.function)
+            cleanup.function(cleanup.info);
+        return;
+    }
     ::free(data);
 }
 
@@ -40,6 +40,11 @@
 
 #include <qcryptographichash.h>
 #include <qiodevice.h>
+#include <qvector.h>
+#include <private/qsimd_p.h>
+
+#include <algorithm>
+#include <limits>
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
@@ -195,6 +200,504 @@ public:
     QByteArray result;
 };
 
+/*
+    The 3rdparty SHA-1 and RFC 6234 SHA-224/256 code only knows how to
+    compress one block at a time (and the latter consumes its input byte by
+    byte). The functions below hand whole 64-byte blocks to a compression
+    function instead, which is the SHA-NI one on x86 processors that have the
+    SHA extensions. hashBatch() additionally has AVX2 kernels that compress
+    one block of eight independent messages at once.
+*/
+
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(SHA) && !defined(QT_BOOTSTRAPPED)
+#  define QT_CRYPTOGRAPHICHASH_SHA_NI
+#endif
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED) \
+    && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1)
+#  define QT_CRYPTOGRAPHICHASH_MULTIBUFFER
+#endif
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+// FIPS 180-4, section 4.2.2
+static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+static inline bool hasShaNi()
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_NI
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+#else
+    return false;
+#endif
+}
+
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_NI
+QT_FUNCTION_TARGET(SHA)
+static void sha1ProcessBlocksShaNi(Sha1State *state, const uchar *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i abcd = _mm_set_epi32(state->h0, state->h1, state->h2, state->h3);
+    __m128i e0 = _mm_set_epi32(state->h4, 0, 0, 0);
+    __m128i e1;
+    __m128i msg[4];
+
+    for (; blocks; --blocks, data += 64) {
+        const __m128i abcdSave = abcd;
+        const __m128i eSave = e0;
+        for (int i = 0; i < 4; ++i) {
+            const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i));
+            msg[i] = _mm_shuffle_epi8(words, byteSwap);
+        }
+
+        // Four rounds per step. The message schedule runs three steps ahead:
+        // sha1msg1, xor and sha1msg2 each complete a part of it.
+#define SHA1_STEP(i, e, eNext) \
+        e = (i) == 0 ? _mm_add_epi32(e, msg[0]) : _mm_sha1nexte_epu32(e, msg[(i) & 3]); \
+        eNext = abcd; \
+        if ((i) >= 3 && (i) <= 18) \
+            msg[((i) + 1) & 3] = _mm_sha1msg2_epu32(msg[((i) + 1) & 3], msg[(i) & 3]); \
+        abcd = _mm_sha1rnds4_epu32(abcd, e, (i) / 5); \
+        if ((i) >= 1 && (i) <= 16) \
+            msg[((i) + 3) & 3] = _mm_sha1msg1_epu32(msg[((i) + 3) & 3], msg[(i) & 3]); \
+        if ((i) >= 2 && (i) <= 17) \
+            msg[((i) + 2) & 3] = _mm_xor_si128(msg[((i) + 2) & 3], msg[(i) & 3]);
+
+        SHA1_STEP( 0, e0, e1) SHA1_STEP( 1, e1, e0) SHA1_STEP( 2, e0, e1) SHA1_STEP( 3, e1, e0)
+        SHA1_STEP( 4, e0, e1) SHA1_STEP( 5, e1, e0) SHA1_STEP( 6, e0, e1) SHA1_STEP( 7, e1, e0)
+        SHA1_STEP( 8, e0, e1) SHA1_STEP( 9, e1, e0) SHA1_STEP(10, e0, e1) SHA1_STEP(11, e1, e0)
+        SHA1_STEP(12, e0, e1) SHA1_STEP(13, e1, e0) SHA1_STEP(14, e0, e1) SHA1_STEP(15, e1, e0)
+        SHA1_STEP(16, e0, e1) SHA1_STEP(17, e1, e0) SHA1_STEP(18, e0, e1) SHA1_STEP(19, e1, e0)
+#undef SHA1_STEP
+
+        e0 = _mm_sha1nexte_epu32(e0, eSave);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    state->h0 = quint32(_mm_extract_epi32(abcd, 3));
+    state->h1 = quint32(_mm_extract_epi32(abcd, 2));
+    state->h2 = quint32(_mm_extract_epi32(abcd, 1));
+    state->h3 = quint32(_mm_extract_epi32(abcd, 0));
+    state->h4 = quint32(_mm_extract_epi32(e0, 3));
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+QT_FUNCTION_TARGET(SHA)
+static void sha256ProcessBlocksShaNi(quint32 *hash, const uchar *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    // sha256rnds2 keeps the working variables as {A, B, E, F} and {C, D, G, H}
+    __m128i abef = _mm_set_epi32(hash[0], hash[1], hash[4], hash[5]);
+    __m128i cdgh = _mm_set_epi32(hash[2], hash[3], hash[6], hash[7]);
+    __m128i msg[4];
+    __m128i wk;
+
+    for (; blocks; --blocks, data += 64) {
+        const __m128i abefSave = abef;
+        const __m128i cdghSave = cdgh;
+        for (int i = 0; i < 4; ++i) {
+            const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i));
+            msg[i] = _mm_shuffle_epi8(words, byteSwap);
+        }
+
+        // Four rounds per step, with the message schedule running three steps ahead
+#define SHA256_STEP(i) \
+        wk = _mm_add_epi32(msg[(i) & 3], \
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(sha256RoundConstants + 4 * (i)))); \
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk); \
+        if ((i) >= 3 && (i) <= 14) { \
+            const __m128i w7 = _mm_alignr_epi8(msg[(i) & 3], msg[((i) + 3) & 3], 4); \
+            msg[((i) + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(msg[((i) + 1) & 3], w7), msg[(i) & 3]); \
+        } \
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e)); \
+        if ((i) >= 1 && (i) <= 12) \
+            msg[((i) + 3) & 3] = _mm_sha256msg1_epu32(msg[((i) + 3) & 3], msg[(i) & 3]);
+
+        SHA256_STEP( 0) SHA256_STEP( 1) SHA256_STEP( 2) SHA256_STEP( 3)
+        SHA256_STEP( 4) SHA256_STEP( 5) SHA256_STEP( 6) SHA256_STEP( 7)
+        SHA256_STEP( 8) SHA256_STEP( 9) SHA256_STEP(10) SHA256_STEP(11)
+        SHA256_STEP(12) SHA256_STEP(13) SHA256_STEP(14) SHA256_STEP(15)
+#undef SHA256_STEP
+
+        abef = _mm_add_epi32(abef, abefSave);
+        cdgh = _mm_add_epi32(cdgh, cdghSave);
+    }
+
+    hash[0] = quint32(_mm_extract_epi32(abef, 3));
+    hash[1] = quint32(_mm_extract_epi32(abef, 2));
+    hash[4] = quint32(_mm_extract_epi32(abef, 1));
+    hash[5] = quint32(_mm_extract_epi32(abef, 0));
+    hash[2] = quint32(_mm_extract_epi32(cdgh, 3));
+    hash[3] = quint32(_mm_extract_epi32(cdgh, 2));
+    hash[6] = quint32(_mm_extract_epi32(cdgh, 1));
+    hash[7] = quint32(_mm_extract_epi32(cdgh, 0));
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#endif // QT_CRYPTOGRAPHICHASH_SHA_NI
+
+static void sha1ProcessBlocks(Sha1State *state, const uchar *data, qint64 blocks)
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_NI
+    if (hasShaNi()) {
+        sha1ProcessBlocksShaNi(state, data, blocks);
+        return;
+    }
+#endif
+    for (; blocks; --blocks, data += 64)
+        sha1ProcessChunk(state, data);
+}
+
+// Same as sha1Update(), but compresses whole blocks with sha1ProcessBlocks()
+static void sha1Input(Sha1State *state, const uchar *data, qint64 len)
+{
+    const qint64 rest = qint64(state->messageSize & Q_UINT64_C(63));
+    state->messageSize += len;
+
+    if (rest) {
+        const qint64 fill = qMin(64 - rest, len);
+        memcpy(&state->buffer[rest], data, fill);
+        if (rest + fill < 64)
+            return;
+        sha1ProcessChunk(state, state->buffer);
+        data += fill;
+        len -= fill;
+    }
+
+    const qint64 blocks = len / 64;
+    if (blocks) {
+        sha1ProcessBlocks(state, data, blocks);
+        data += blocks * 64;
+        len -= blocks * 64;
+    }
+    memcpy(state->buffer, data, len);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static void sha256ProcessBlocks(SHA256Context *context, const uchar *data, qint64 blocks)
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_NI
+    if (hasShaNi()) {
+        sha256ProcessBlocksShaNi(context->Intermediate_Hash, data, blocks);
+        return;
+    }
+#endif
+    for (; blocks; --blocks, data += SHA256_Message_Block_Size) {
+        memcpy(context->Message_Block, data, SHA256_Message_Block_Size);
+        SHA224_256ProcessMessageBlock(context);
+    }
+}
+
+// Same as SHA256Input(), but compresses whole blocks with sha256ProcessBlocks()
+static void sha256Input(SHA256Context *context, const uchar *data, int length)
+{
+    if (context->Message_Block_Index) {
+        const int fill = qMin(length, SHA256_Message_Block_Size - int(context->Message_Block_Index));
+        SHA256Input(context, data, fill);
+        data += fill;
+        length -= fill;
+    }
+
+    const int blocks = length / SHA256_Message_Block_Size;
+    if (blocks && !context->Computed && !context->Corrupted) {
+        const quint64 bits = (quint64(context->Length_High) << 32) | context->Length_Low;
+        const quint64 newBits = bits + quint64(blocks) * SHA256_Message_Block_Size * 8;
+        if (newBits < bits) {
+            context->Corrupted = shaInputTooLong;
+            return;
+        }
+        context->Length_High = quint32(newBits >> 32);
+        context->Length_Low = quint32(newBits);
+
+        sha256ProcessBlocks(context, data, blocks);
+        data += blocks * SHA256_Message_Block_Size;
+        length -= blocks * SHA256_Message_Block_Size;
+    }
+
+    if (length > 0)
+        SHA256Input(context, data, length);
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
+#ifdef QT_CRYPTOGRAPHICHASH_MULTIBUFFER
+/*
+    Multi-buffer hashing: each 32-bit element of an AVX2 register belongs to
+    a different message ("lane"), so one pass of the scalar algorithm written
+    with vector instructions compresses one block of eight messages.
+*/
+enum { MultiBufferLanes = 8 };
+
+typedef quint32 MultiBufferState[8][MultiBufferLanes];     // [word][lane]
+
+struct MultiBufferAlgorithm
+{
+    void (*processLanes)(MultiBufferState &state, const uchar *const *blocks);
+    const quint32 *initialHash;
+    int stateWords;
+    int hashLength;
+};
+
+QT_FUNCTION_TARGET(AVX2)
+static inline void transposeLanes(__m256i *r)
+{
+    const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// Loads the sixteen big-endian message words of each lane's block, word-major
+QT_FUNCTION_TARGET(AVX2)
+static inline void loadLaneBlocks(__m256i *w, const uchar *const *blocks)
+{
+    const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                             12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    for (int half = 0; half < 2; ++half) {
+        __m256i *r = w + 8 * half;
+        for (int lane = 0; lane < MultiBufferLanes; ++lane)
+            r[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blocks[lane] + 32 * half));
+        transposeLanes(r);
+        for (int i = 0; i < 8; ++i)
+            r[i] = _mm256_shuffle_epi8(r[i], byteSwap);
+    }
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i rotl32x8(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i rotr32x8(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void sha1ProcessLanesAvx2(MultiBufferState &state, const uchar *const *blocks)
+{
+    __m256i w[16];
+    loadLaneBlocks(w, blocks);
+
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[0]));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[1]));
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[2]));
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[3]));
+    __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[4]));
+    const __m256i a0 = a, b0 = b, c0 = c, d0 = d, e0 = e;
+
+    for (int t = 0; t < 80; ++t) {
+        if (t >= 16) {
+            const __m256i x = _mm256_xor_si256(_mm256_xor_si256(w[(t - 3) & 15], w[(t - 8) & 15]),
+                                               _mm256_xor_si256(w[(t - 14) & 15], w[t & 15]));
+            w[t & 15] = rotl32x8(x, 1);
+        }
+
+        __m256i f;
+        quint32 k;
+        if (t < 20) {
+            f = _mm256_xor_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d));
+            k = 0x5A827999;
+        } else if (t < 40) {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = 0x6ED9EBA1;
+        } else if (t < 60) {
+            f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c)));
+            k = 0x8F1BBCDC;
+        } else {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = 0xCA62C1D6;
+        }
+
+        const __m256i temp = _mm256_add_epi32(_mm256_add_epi32(rotl32x8(a, 5), f),
+                                              _mm256_add_epi32(_mm256_add_epi32(e, w[t & 15]),
+                                                               _mm256_set1_epi32(int(k))));
+        e = d;
+        d = c;
+        c = rotl32x8(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[0]), _mm256_add_epi32(a, a0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[1]), _mm256_add_epi32(b, b0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[2]), _mm256_add_epi32(c, c0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[3]), _mm256_add_epi32(d, d0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[4]), _mm256_add_epi32(e, e0));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void sha256ProcessLanesAvx2(MultiBufferState &state, const uchar *const *blocks)
+{
+    __m256i w[16];
+    loadLaneBlocks(w, blocks);
+
+    __m256i v[8];
+    __m256i saved[8];
+    for (int i = 0; i < 8; ++i)
+        v[i] = saved[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[i]));
+    __m256i a = v[0], b = v[1], c = v[2], d = v[3], e = v[4], f = v[5], g = v[6], h = v[7];
+
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            const __m256i w2 = w[(t - 2) & 15];
+            const __m256i w15 = w[(t - 15) & 15];
+            const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr32x8(w2, 17), rotr32x8(w2, 19)),
+                                                _mm256_srli_epi32(w2, 10));
+            const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr32x8(w15, 7), rotr32x8(w15, 18)),
+                                                _mm256_srli_epi32(w15, 3));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0),
+                                         _mm256_add_epi32(w[(t - 7) & 15], s1));
+        }
+
+        const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr32x8(e, 6), rotr32x8(e, 11)),
+                                                rotr32x8(e, 25));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sigma1), ch),
+                                               _mm256_add_epi32(w[t & 15],
+                                                                _mm256_set1_epi32(int(sha256RoundConstants[t]))));
+        const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr32x8(a, 2), rotr32x8(a, 13)),
+                                                rotr32x8(a, 22));
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        const __m256i temp2 = _mm256_add_epi32(sigma0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, temp2);
+    }
+
+    v[0] = a; v[1] = b; v[2] = c; v[3] = d; v[4] = e; v[5] = f; v[6] = g; v[7] = h;
+    for (int i = 0; i < 8; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[i]), _mm256_add_epi32(v[i], saved[i]));
+}
+
+struct MultiBufferLane
+{
+    const uchar *data;
+    qint64 blocks;          // whole blocks left in data
+    int index;              // position of the message in the batch, -1 if the lane is idle
+    int tailBlocks;         // padded blocks left in tail
+    int tailOffset;
+    uchar tail[128];
+};
+
+// Hashes the messages data[order[i]] into result[order[i]]
+static void multiBufferHash(const MultiBufferAlgorithm &algorithm, const QByteArrayList &data,
+                            QVector<int> order, QByteArrayList &result)
+{
+    // Longest messages first, so that all lanes run out of work at about the same time
+    std::stable_sort(order.begin(), order.end(), [&data](int lhs, int rhs) {
+        return data.at(lhs).size() > data.at(rhs).size();
+    });
+
+    static const uchar idleBlock[64] = {};
+    MultiBufferState state;
+    MultiBufferLane lanes[MultiBufferLanes];
+    int next = 0;
+    int active = 0;
+
+    const auto startNextMessage = [&](int lane) {
+        MultiBufferLane &l = lanes[lane];
+        if (next == order.size()) {
+            l.index = -1;
+            return;
+        }
+        l.index = order.at(next++);
+        const QByteArray &message = data.at(l.index);
+        const int rest = message.size() % 64;
+        l.data = reinterpret_cast<const uchar *>(message.constData());
+        l.blocks = message.size() / 64;
+        l.tailBlocks = rest < 64 - 8 ? 1 : 2;
+        l.tailOffset = 0;
+        memset(l.tail, 0, sizeof(l.tail));
+        memcpy(l.tail, l.data + l.blocks * 64, rest);
+        l.tail[rest] = 0x80;
+        qToBigEndian(quint64(message.size()) * 8, l.tail + 64 * l.tailBlocks - 8);
+        for (int i = 0; i < algorithm.stateWords; ++i)
+            state[i][lane] = algorithm.initialHash[i];
+        ++active;
+    };
+
+    for (int lane = 0; lane < MultiBufferLanes; ++lane)
+        startNextMessage(lane);
+
+    while (active) {
+        const uchar *blocks[MultiBufferLanes];
+        for (int lane = 0; lane < MultiBufferLanes; ++lane) {
+            const MultiBufferLane &l = lanes[lane];
+            if (l.index < 0)
+                blocks[lane] = idleBlock;
+            else
+                blocks[lane] = l.blocks ? l.data : l.tail + l.tailOffset;
+        }
+
+        algorithm.processLanes(state, blocks);
+
+        for (int lane = 0; lane < MultiBufferLanes; ++lane) {
+            MultiBufferLane &l = lanes[lane];
+            if (l.index < 0)
+                continue;
+            if (l.blocks) {
+                l.data += 64;
+                --l.blocks;
+                continue;
+            }
+            l.tailOffset += 64;
+            if (--l.tailBlocks)
+                continue;
+
+            QByteArray &hash = result[l.index];
+            hash.resize(algorithm.hashLength);
+            for (int i = 0; i < algorithm.hashLength / 4; ++i)
+                qToBigEndian(state[i][lane], hash.data() + 4 * i);
+            --active;
+            startNextMessage(lane);
+        }
+    }
+}
+#endif // QT_CRYPTOGRAPHICHASH_MULTIBUFFER
+
 #ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
 void QCryptographicHashPrivate::sha3Finish(int bitCount, Sha3Variant sha3Variant)
 {
@@ -363,7 +866,7 @@ void QCryptographicHash::addData(const char *data, int length)
 {
     switch (d->method) {
     case Sha1:
-        sha1Update(&d->sha1Context, (const unsigned char *)data, length);
+        sha1Input(&d->sha1Context, (const unsigned char *)data, length);
         break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
     default:
@@ -378,10 +881,10 @@ void QCryptographicHash::addData(const char *data, int length)
         MD5Update(&d->md5Context, (const unsigned char *)data, length);
         break;
     case Sha224:
-        SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha256:
-        SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha384:
         SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -431,11 +934,15 @@ bool QCryptographicHash::addData(QIODevice* device)
     if (!device->isOpen())
         return false;
 
-    char buffer[1024];
-    int length;
+    // Files are read rather than mapped: a mapping faults with SIGBUS if
+    // another process truncates the file while it is being hashed.
+    enum { ReadChunkSize = 64 * 1024 };
+
+    QByteArray buffer(ReadChunkSize, Qt::Uninitialized);
+    qint64 length;
 
-    while ((length = device->read(buffer,sizeof(buffer))) > 0)
-        addData(buffer,length);
+    while ((length = device->read(buffer.data(), buffer.size())) > 0)
+        addData(buffer.constData(), int(length));
 
     return device->atEnd();
 }
@@ -548,6 +1055,84 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+/*!
+  \since 5.15
+
+  Returns the hash of the data read from \a device using \a method, or a
+  null QByteArray if \a device is not open for reading or cannot be read
+  until its end.
+
+  \sa addData(QIODevice *)
+*/
+QByteArray QCryptographicHash::hash(QIODevice *device, Algorithm method)
+{
+    QCryptographicHash hash(method);
+    if (!hash.addData(device))
+        return QByteArray();
+    return hash.result();
+}
+
+/*!
+  \since 5.15
+
+  Returns the hashes of each element of \a data using \a method, in the
+  same order. This is equivalent to calling hash() on each element, but for
+  SHA-1, SHA-224 and SHA-256 several messages may be hashed at once on
+  processors that support it.
+*/
+QByteArrayList QCryptographicHash::hashBatch(const QByteArrayList &data, Algorithm method)
+{
+    QByteArrayList result;
+    result.reserve(data.size());
+
+#ifdef QT_CRYPTOGRAPHICHASH_MULTIBUFFER
+    static const quint32 sha1InitialHash[5] = {
+        0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+    };
+    MultiBufferAlgorithm algorithm = {};
+    if (data.size() > 1 && qCpuHasFeature(AVX2)) {
+        switch (method) {
+        case Sha1:
+            algorithm = { sha1ProcessLanesAvx2, sha1InitialHash, 5, 20 };
+            break;
+        case Sha224:
+            algorithm = { sha256ProcessLanesAvx2, SHA224_H0, 8, SHA224HashSize };
+            break;
+        case Sha256:
+            algorithm = { sha256ProcessLanesAvx2, SHA256_H0, 8, SHA256HashSize };
+            break;
+        default:
+            break;
+        }
+    }
+    // A single SHA-NI stream overtakes eight AVX2 lanes of SHA-256 after a
+    // few blocks; for SHA-1 the lanes always win.
+    const int maxLaneSize = hasShaNi() && method != Sha1 ? 1024 : std::numeric_limits<int>::max();
+    QVector<int> lanes;
+#endif
+
+    QCryptographicHash hash(method);
+    for (int i = 0; i < data.size(); ++i) {
+        const QByteArray &message = data.at(i);
+#ifdef QT_CRYPTOGRAPHICHASH_MULTIBUFFER
+        if (algorithm.processLanes && message.size() <= maxLaneSize) {
+            lanes.append(i);
+            result.append(QByteArray());
+            continue;
+        }
+#endif
+        hash.reset();
+        hash.addData(message);
+        result.append(hash.result());
+    }
+
+#ifdef QT_CRYPTOGRAPHICHASH_MULTIBUFFER
+    if (!lanes.isEmpty())
+        multiBufferHash(algorithm, data, std::move(lanes), result);
+#endif
+    return result;
+}
+
 /*!
   Returns the size of the output of the selected hash \a method in bytes.
 
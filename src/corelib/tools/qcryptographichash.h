@@ -42,6 +42,7 @@
 #define QCRYPTOGRAPHICHASH_H
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qbytearraylist.h>
 #include <QtCore/qobjectdefs.h>
 
 QT_BEGIN_NAMESPACE
@@ -101,6 +102,8 @@ public:
     QByteArray result() const;
 
     static QByteArray hash(const QByteArray &data, Algorithm method);
+    static QByteArray hash(QIODevice *device, Algorithm method);
+    static QByteArrayList hashBatch(const QByteArrayList &data, Algorithm method);
     static int hashLength(Algorithm method);
 private:
     Q_DISABLE_COPY(QCryptographicHash)
@@ -0,0 +1,659 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qcontainerfwd.h>
+#include <QtCore/qglobal.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qlist.h>
+
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QFlatHashPrivate {
+
+// Every slot has a control byte. Full slots store the low seven bits of
+// the element's hash, so a whole group of slots can be compared against a
+// hash at once; empty and deleted slots have the high bit set.
+enum : quint8 {
+    Empty = 0x80,
+    Deleted = 0xfe
+};
+
+inline bool isFull(quint8 ctrl) noexcept { return !(ctrl & 0x80); }
+
+// The slots of a group selected by one of the Group matchers
+template <typename Mask, int Shift>
+struct BitMask
+{
+    Mask mask;
+
+    explicit operator bool() const noexcept { return mask != 0; }
+    int lowest() const noexcept { return int(qCountTrailingZeroBits(mask) >> Shift); }
+    void removeLowest() noexcept { mask &= mask - 1; }
+};
+
+#if defined(__SSE2__)
+struct Group
+{
+    enum { Width = 16 };
+    typedef BitMask<quint32, 0> Mask;
+
+    explicit Group(const quint8 *bytes) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes)))
+    {}
+
+    Mask match(quint8 h2) const noexcept
+    {
+        return Mask{ quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(char(h2)), ctrl))) };
+    }
+    Mask matchEmpty() const noexcept { return match(Empty); }
+    Mask matchEmptyOrDeleted() const noexcept { return Mask{ quint32(_mm_movemask_epi8(ctrl)) }; }
+
+    __m128i ctrl;
+};
+#else
+// Eight control bytes at a time in a 64-bit word
+struct Group
+{
+    enum { Width = 8 };
+    typedef BitMask<quint64, 3> Mask;
+
+    explicit Group(const quint8 *bytes) noexcept
+        : ctrl(qFromLittleEndian<quint64>(bytes))
+    {}
+
+    Mask match(quint8 h2) const noexcept
+    {
+        // May report a full slot that does not match; the keys are compared anyway
+        const quint64 x = ctrl ^ (lsbs() * h2);
+        return Mask{ (x - lsbs()) & ~x & msbs() };
+    }
+    Mask matchEmpty() const noexcept { return Mask{ ctrl & ~(ctrl << 6) & msbs() }; }
+    Mask matchEmptyOrDeleted() const noexcept { return Mask{ ctrl & msbs() }; }
+
+    static constexpr quint64 lsbs() noexcept { return Q_UINT64_C(0x0101010101010101); }
+    static constexpr quint64 msbs() noexcept { return Q_UINT64_C(0x8080808080808080); }
+
+    quint64 ctrl;
+};
+#endif
+
+// Visits every group of a table exactly once, since the number of groups
+// is a power of two
+struct ProbeSequence
+{
+    ProbeSequence(size_t hash, size_t groupMask) noexcept
+        : mask(groupMask), group(hash & groupMask)
+    {}
+
+    size_t offset() const noexcept { return group * Group::Width; }
+    void next() noexcept { group = (group + ++step) & mask; }
+
+    size_t mask;
+    size_t group;
+    size_t step = 0;
+};
+
+// qHash() of integers is the identity; spread the bits so that both the
+// group index and the control byte depend on all of them
+inline quint64 mixHash(uint h) noexcept
+{
+    const quint64 x = quint64(h) * Q_UINT64_C(0x9e3779b97f4a7c15);
+    return x ^ (x >> 32);
+}
+
+} // namespace QFlatHashPrivate
+
+template <class Key, class T>
+class QFlatHash
+{
+    struct Node
+    {
+        Key key;
+        T value;
+    };
+    typedef QFlatHashPrivate::Group Group;
+
+public:
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+
+        QFlatHash<Key, T> *d = nullptr;
+        size_t i = 0;
+
+        iterator(QFlatHash<Key, T> *hash, size_t index) noexcept : d(hash), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        constexpr iterator() noexcept = default;
+
+        const Key &key() const noexcept { return d->nodes[i].key; }
+        T &value() const noexcept { return d->nodes[i].value; }
+        T &operator*() const noexcept { return d->nodes[i].value; }
+        T *operator->() const noexcept { return &d->nodes[i].value; }
+        bool operator==(const iterator &o) const noexcept { return i == o.i && d == o.d; }
+        bool operator!=(const iterator &o) const noexcept { return !(*this == o); }
+
+        iterator &operator++() noexcept
+        {
+            i = d->nextFull(i + 1);
+            return *this;
+        }
+        iterator operator++(int) noexcept
+        {
+            iterator r = *this;
+            ++*this;
+            return r;
+        }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class QFlatHash<Key, T>;
+
+        const QFlatHash<Key, T> *d = nullptr;
+        size_t i = 0;
+
+        const_iterator(const QFlatHash<Key, T> *hash, size_t index) noexcept : d(hash), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        constexpr const_iterator() noexcept = default;
+        const_iterator(const iterator &o) noexcept : d(o.d), i(o.i) {}
+
+        const Key &key() const noexcept { return d->nodes[i].key; }
+        const T &value() const noexcept { return d->nodes[i].value; }
+        const T &operator*() const noexcept { return d->nodes[i].value; }
+        const T *operator->() const noexcept { return &d->nodes[i].value; }
+        bool operator==(const const_iterator &o) const noexcept { return i == o.i && d == o.d; }
+        bool operator!=(const const_iterator &o) const noexcept { return !(*this == o); }
+
+        const_iterator &operator++() noexcept
+        {
+            i = d->nextFull(i + 1);
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator r = *this;
+            ++*this;
+            return r;
+        }
+    };
+    friend class const_iterator;
+
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    QFlatHash() noexcept = default;
+    inline QFlatHash(std::initializer_list<std::pair<Key, T> > list);
+    inline QFlatHash(const QFlatHash<Key, T> &other);
+    QFlatHash(QFlatHash<Key, T> &&other) noexcept { swap(other); }
+    ~QFlatHash() { destroy(); }
+
+    QFlatHash<Key, T> &operator=(const QFlatHash<Key, T> &other)
+    {
+        if (this != &other)
+            QFlatHash<Key, T>(other).swap(*this);
+        return *this;
+    }
+    QFlatHash<Key, T> &operator=(QFlatHash<Key, T> &&other) noexcept
+    {
+        QFlatHash<Key, T> moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    void swap(QFlatHash<Key, T> &other) noexcept
+    {
+        qSwap(ctrl, other.ctrl);
+        qSwap(nodes, other.nodes);
+        qSwap(cap, other.cap);
+        qSwap(s, other.s);
+        qSwap(growthLeft, other.growthLeft);
+        qSwap(seed, other.seed);
+    }
+
+    bool operator==(const QFlatHash<Key, T> &other) const;
+    bool operator!=(const QFlatHash<Key, T> &other) const { return !(*this == other); }
+
+    int size() const noexcept { return int(s); }
+    int count() const noexcept { return int(s); }
+    bool isEmpty() const noexcept { return s == 0; }
+
+    int capacity() const noexcept { return int(maxLoad(cap)); }
+    void reserve(int size);
+    void squeeze();
+    void clear() noexcept { destroy(); }
+
+    iterator insert(const Key &key, const T &value);
+    int remove(const Key &key);
+    T take(const Key &key);
+    iterator erase(const_iterator it);
+
+    bool contains(const Key &key) const { return findIndex(key) != cap; }
+    const T value(const Key &key, const T &defaultValue = T()) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    iterator find(const Key &key) { return iterator(this, findIndex(key)); }
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const { return const_iterator(this, findIndex(key)); }
+
+    iterator begin() noexcept { return iterator(this, nextFull(0)); }
+    const_iterator begin() const noexcept { return const_iterator(this, nextFull(0)); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator constBegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(this, cap); }
+    const_iterator end() const noexcept { return const_iterator(this, cap); }
+    const_iterator cend() const noexcept { return end(); }
+    const_iterator constEnd() const noexcept { return end(); }
+
+    // STL compatibility
+    typedef T value_type;
+    typedef value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    bool empty() const noexcept { return isEmpty(); }
+
+private:
+    static size_t maxLoad(size_t capacity) noexcept { return capacity - capacity / 8; }
+    static size_t capacityFor(size_t size) noexcept
+    {
+        size_t capacity = Group::Width;
+        while (maxLoad(capacity) < size)
+            capacity *= 2;
+        return capacity;
+    }
+
+    quint64 hashOf(const Key &key) const
+    {
+        return QFlatHashPrivate::mixHash(qHash(key, seed));
+    }
+
+    size_t nextFull(size_t i) const noexcept
+    {
+        while (i < cap && !QFlatHashPrivate::isFull(ctrl[i]))
+            ++i;
+        return i;
+    }
+
+    size_t findIndex(const Key &key) const { return s ? findIndex(key, hashOf(key)) : cap; }
+    size_t findIndex(const Key &key, quint64 hash) const;
+    size_t findFreeIndex(quint64 hash) const noexcept;
+    size_t prepareInsert(const Key &key, quint64 *hash, bool *found);
+    void commitInsert(size_t i, quint64 hash) noexcept;
+    void eraseAt(size_t i);
+    void rehash(size_t capacity);
+    void allocate(size_t capacity);
+    void destroy() noexcept;
+
+    quint8 *ctrl = nullptr;     // cap control bytes, followed by the nodes
+    Node *nodes = nullptr;
+    size_t cap = 0;             // 0 or a power of two, at least Group::Width
+    size_t s = 0;
+    size_t growthLeft = 0;      // empty slots that may still be filled before a rehash
+    uint seed = 0;
+};
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T>::QFlatHash(std::initializer_list<std::pair<Key, T> > list)
+{
+    reserve(int(list.size()));
+    for (const std::pair<Key, T> &p : list)
+        insert(p.first, p.second);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T>::QFlatHash(const QFlatHash<Key, T> &other)
+{
+    if (!other.s)
+        return;
+    // Same capacity and seed: every element keeps its slot. The control
+    // bytes are copied as they are, deleted slots included, since probe
+    // sequences of the elements may run through groups that only have room
+    // because of an erase.
+    allocate(other.cap);
+    seed = other.seed;
+    for (size_t i = 0; i < cap; ++i) {
+        if (QFlatHashPrivate::isFull(other.ctrl[i])) {
+            new (nodes + i) Node(other.nodes[i]);
+            ctrl[i] = other.ctrl[i];
+            ++s;
+        }
+    }
+    memcpy(ctrl, other.ctrl, cap);
+    growthLeft = other.growthLeft;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::allocate(size_t capacity)
+{
+    Q_ASSERT(capacity >= size_t(Group::Width) && !(capacity & (capacity - 1)));
+    const size_t nodeOffset = (capacity + alignof(Node) - 1) & ~(alignof(Node) - 1);
+    ctrl = static_cast<quint8 *>(::malloc(nodeOffset + capacity * sizeof(Node)));
+    Q_CHECK_PTR(ctrl);
+    memset(ctrl, QFlatHashPrivate::Empty, capacity);
+    nodes = reinterpret_cast<Node *>(ctrl + nodeOffset);
+    cap = capacity;
+    s = 0;
+    growthLeft = maxLoad(capacity);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::destroy() noexcept
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        for (size_t i = 0; s && i < cap; ++i) {
+            if (QFlatHashPrivate::isFull(ctrl[i])) {
+                nodes[i].~Node();
+                --s;
+            }
+        }
+    }
+    ::free(ctrl);
+    ctrl = nullptr;
+    nodes = nullptr;
+    cap = s = growthLeft = 0;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(size_t capacity)
+{
+    quint8 *oldCtrl = ctrl;
+    Node *oldNodes = nodes;
+    const size_t oldCap = cap;
+    const size_t size = s;
+
+    allocate(capacity);
+    if (!oldCap)
+        seed = uint(qGlobalQHashSeed());
+
+    for (size_t i = 0; i < oldCap; ++i) {
+        if (!QFlatHashPrivate::isFull(oldCtrl[i]))
+            continue;
+        const quint64 hash = hashOf(oldNodes[i].key);
+        const size_t j = findFreeIndex(hash);
+        ctrl[j] = quint8(hash & 0x7f);
+        if (QTypeInfoQuery<Key>::isRelocatable && QTypeInfoQuery<T>::isRelocatable) {
+            memcpy(static_cast<void *>(nodes + j), static_cast<const void *>(oldNodes + i), sizeof(Node));
+        } else {
+            new (nodes + j) Node(std::move(oldNodes[i]));
+            oldNodes[i].~Node();
+        }
+    }
+    s = size;
+    growthLeft -= size;
+    ::free(oldCtrl);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE size_t QFlatHash<Key, T>::findIndex(const Key &key, quint64 hash) const
+{
+    const quint8 h2 = quint8(hash & 0x7f);
+    for (QFlatHashPrivate::ProbeSequence seq(size_t(hash >> 7), cap / Group::Width - 1); ; seq.next()) {
+        const Group group(ctrl + seq.offset());
+        for (auto match = group.match(h2); match; match.removeLowest()) {
+            const size_t i = seq.offset() + match.lowest();
+            if (nodes[i].key == key)
+                return i;
+        }
+        // A probe only continues past groups that have never had room
+        if (group.matchEmpty())
+            return cap;
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE size_t QFlatHash<Key, T>::findFreeIndex(quint64 hash) const noexcept
+{
+    for (QFlatHashPrivate::ProbeSequence seq(size_t(hash >> 7), cap / Group::Width - 1); ; seq.next()) {
+        if (const auto match = Group(ctrl + seq.offset()).matchEmptyOrDeleted())
+            return seq.offset() + match.lowest();
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE size_t QFlatHash<Key, T>::prepareInsert(const Key &key, quint64 *hash, bool *found)
+{
+    if (!cap)
+        rehash(capacityFor(1));
+    *hash = hashOf(key);
+    size_t i = findIndex(key, *hash);
+    *found = i != cap;
+    if (*found)
+        return i;
+
+    i = findFreeIndex(*hash);
+    if (!growthLeft && ctrl[i] == QFlatHashPrivate::Empty) {
+        // Out of room. If deleted slots make up much of the table, reclaim
+        // them at the same capacity instead of growing.
+        rehash((s + 1) * 2 <= maxLoad(cap) ? cap : cap * 2);
+        i = findFreeIndex(*hash);
+    }
+    return i;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::commitInsert(size_t i, quint64 hash) noexcept
+{
+    if (ctrl[i] == QFlatHashPrivate::Empty)
+        --growthLeft;
+    ctrl[i] = quint8(hash & 0x7f);
+    ++s;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::eraseAt(size_t i)
+{
+    nodes[i].~Node();
+    --s;
+    // If the group still has an empty slot it was never full, so no probe
+    // sequence runs through it and the slot can become empty again.
+    // Otherwise leave a tombstone; either way nothing moves.
+    if (Group(ctrl + (i & ~size_t(Group::Width - 1))).matchEmpty()) {
+        ctrl[i] = QFlatHashPrivate::Empty;
+        ++growthLeft;
+    } else {
+        ctrl[i] = QFlatHashPrivate::Deleted;
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    quint64 hash;
+    bool found;
+    const size_t i = prepareInsert(key, &hash, &found);
+    if (found) {
+        nodes[i].value = value;
+    } else {
+        new (nodes + i) Node{key, value};
+        commitInsert(i, hash);
+    }
+    return iterator(this, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    quint64 hash;
+    bool found;
+    const size_t i = prepareInsert(key, &hash, &found);
+    if (!found) {
+        new (nodes + i) Node{key, T()};
+        commitInsert(i, hash);
+    }
+    return nodes[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const size_t i = findIndex(key);
+    return i == cap ? defaultValue : nodes[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &key)
+{
+    const size_t i = findIndex(key);
+    if (i == cap)
+        return 0;
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    const size_t i = findIndex(key);
+    if (i == cap)
+        return T();
+    T t = std::move(nodes[i].value);
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.d == this, "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    Q_ASSERT(it.i < cap && QFlatHashPrivate::isFull(ctrl[it.i]));
+    eraseAt(it.i);
+    return iterator(this, nextFull(it.i + 1));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int size)
+{
+    if (size > 0 && size_t(size) > maxLoad(cap))
+        rehash(capacityFor(size_t(size)));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (!s)
+        destroy();
+    else if (capacityFor(s) < cap)
+        rehash(capacityFor(s));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash<Key, T> &other) const
+{
+    if (s != other.s)
+        return false;
+    for (const_iterator it = begin(), e = end(); it != e; ++it) {
+        const size_t i = other.findIndex(it.key());
+        if (i == other.cap || !(other.nodes[i].value == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = begin(), e = end(); it != e; ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = begin(), e = end(); it != e; ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+inline void swap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2) noexcept
+{
+    value1.swap(value2);
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
@@ -108,6 +108,29 @@ const char *QRingBuffer::readPointerAtPosition(qint64 pos, qint64 &length) const
     return nullptr;
 }
 
+/*!
+    \internal
+
+    Stores the addresses and sizes of at most \a maxCount consecutive
+    blocks of data, starting at the beginning of the buffer, in \a data and
+    \a sizes. Returns the number of blocks stored. Nothing is copied, so the
+    blocks can be written out with a single vectored write.
+*/
+int QRingBuffer::readPointers(const char **data, qint64 *sizes, int maxCount) const
+{
+    int count = 0;
+    for (const QRingChunk &chunk : buffers) {
+        if (count == maxCount)
+            break;
+        if (chunk.size() == 0)
+            continue;
+        data[count] = chunk.data();
+        sizes[count] = chunk.size();
+        ++count;
+    }
+    return count;
+}
+
 void QRingBuffer::free(qint64 bytes)
 {
     Q_ASSERT(bytes <= bufferSize);
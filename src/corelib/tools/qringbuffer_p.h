@@ -202,6 +202,7 @@ public:
     }
 
     Q_CORE_EXPORT const char *readPointerAtPosition(qint64 pos, qint64 &length) const;
+    Q_CORE_EXPORT int readPointers(const char **data, qint64 *sizes, int maxCount) const;
     Q_CORE_EXPORT void free(qint64 bytes);
     Q_CORE_EXPORT char *reserve(qint64 bytes);
     Q_CORE_EXPORT char *reserveFront(qint64 bytes);
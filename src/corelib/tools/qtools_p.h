@@ -86,6 +86,8 @@ Q_DECL_CONSTEXPR inline int fromOct(uint c) noexcept
 }
 }
 
+struct QArrayData;
+
 // We typically need an extra bit for qNextPowerOfTwo when determining the next allocation size.
 enum {
     MaxAllocSize = INT_MAX
@@ -102,6 +104,12 @@ qCalculateBlockSize(size_t elementCount, size_t elementSize, size_t headerSize =
 CalculateGrowingBlockSizeResult Q_CORE_EXPORT Q_DECL_CONST_FUNCTION
 qCalculateGrowingBlockSize(size_t elementCount, size_t elementSize, size_t headerSize = 0) noexcept ;
 
+// Makes QArrayData::deallocate() call cleanup(info) when the raw data
+// header is released, so that the array can keep external memory alive.
+typedef void (*QArrayDataCleanupFunction)(void *);
+void Q_CORE_EXPORT qSetArrayDataCleanup(QArrayData *header, QArrayDataCleanupFunction cleanup,
+                                        void *info);
+
 QT_END_NAMESPACE
 
 #endif // QTOOLS_P_H
@@ -2,6 +2,7 @@
 
 HEADERS += \
     access/qnetworkaccessauthenticationmanager_p.h \
+    access/qnetworkaccessconnectionpool_p.h \
     access/qnetworkaccessmanager.h \
     access/qnetworkaccessmanager_p.h \
     access/qnetworkaccesscache_p.h \
@@ -28,6 +29,7 @@ HEADERS += \
 
 SOURCES += \
     access/qnetworkaccessauthenticationmanager.cpp \
+    access/qnetworkaccessconnectionpool.cpp \
     access/qnetworkaccessmanager.cpp \
     access/qnetworkaccesscache.cpp \
     access/qnetworkaccessbackend.cpp \
@@ -96,6 +98,10 @@ qtConfig(http) {
         access/qhttpnetworkreply.cpp \
         access/qhttpnetworkrequest.cpp \
         access/qhttpprotocolhandler.cpp \
+        access/qhttpserver.cpp \
+        access/qhttpserverconnection.cpp \
+        access/qhttpserverrequest.cpp \
+        access/qhttpserverresponse.cpp \
         access/qhttpthreaddelegate.cpp \
         access/qnetworkreplyhttpimpl.cpp \
         access/qhttp2configuration.cpp
@@ -111,6 +117,11 @@ qtConfig(http) {
         access/qhttpnetworkreply_p.h \
         access/qhttpnetworkrequest_p.h \
         access/qhttpprotocolhandler_p.h \
+        access/qhttpserver.h \
+        access/qhttpserver_p.h \
+        access/qhttpserverconnection_p.h \
+        access/qhttpserverrequest.h \
+        access/qhttpserverresponse.h \
         access/qhttpthreaddelegate_p.h \
         access/qnetworkreplyhttpimpl_p.h \
         access/qhttp2configuration.h
@@ -41,9 +41,6 @@
 
 #include <QtCore/qdebug.h>
 
-#include <algorithm>
-#include <cstddef>
-#include <cstring>
 #include <limits>
 
 
@@ -71,78 +68,41 @@ HeaderSize entry_size(const QByteArray &name, const QByteArray &value)
 namespace
 {
 
-int compare(const QByteArray &lhs, const QByteArray &rhs)
-{
-    if (const int minLen = std::min(lhs.size(), rhs.size())) {
-        // We use memcmp, since strings in headers are allowed
-        // to contain '\0'.
-        const int cmp = std::memcmp(lhs.constData(), rhs.constData(), std::size_t(minLen));
-        if (cmp)
-            return cmp;
-    }
-
-    return lhs.size() - rhs.size();
-}
-
-} // unnamed namespace
-
-FieldLookupTable::SearchEntry::SearchEntry()
-    : field(),
-      chunk(),
-      offset(),
-      table()
+// Maps (name|value) pairs of the static table to their indices.
+const QHash<HeaderField, quint32> &staticFieldIndex()
 {
+    static const QHash<HeaderField, quint32> index = [] {
+        QHash<HeaderField, quint32> index;
+        const auto &table = FieldLookupTable::staticPart();
+        for (quint32 i = 0; i < table.size(); ++i)
+            index.insert(table[i], i + 1);
+        return index;
+    }();
+    return index;
 }
 
-FieldLookupTable::SearchEntry::SearchEntry(const HeaderField *f,
-                                           const Chunk *c,
-                                           quint32 o,
-                                           const FieldLookupTable *t)
-    : field(f),
-      chunk(c),
-      offset(o),
-      table(t)
-{
-    Q_ASSERT(field);
+// Maps names of the static table to the smallest index of an entry with this name.
+const QHash<QByteArray, quint32> &staticNameIndex()
+{
+    static const QHash<QByteArray, quint32> index = [] {
+        QHash<QByteArray, quint32> index;
+        const auto &table = FieldLookupTable::staticPart();
+        for (quint32 i = 0; i < table.size(); ++i) {
+            if (!index.contains(table[i].name))
+                index.insert(table[i].name, i + 1);
+        }
+        return index;
+    }();
+    return index;
 }
 
-bool FieldLookupTable::SearchEntry::operator < (const SearchEntry &rhs)const
-{
-    Q_ASSERT(field);
-    Q_ASSERT(rhs.field);
-
-    int cmp = compare(field->name, rhs.field->name);
-    if (cmp)
-        return cmp < 0;
-
-    cmp = compare(field->value, rhs.field->value);
-    if (cmp)
-        return cmp < 0;
-
-    if (!chunk) // 'this' is not in the searchIndex.
-        return rhs.chunk;
-
-    if (!rhs.chunk) // not in the searchIndex.
-        return false;
-
-    Q_ASSERT(table);
-    Q_ASSERT(rhs.table == table);
-
-    const quint32 leftChunkIndex = table->indexOfChunk(chunk);
-    const quint32 rightChunkIndex = rhs.table->indexOfChunk(rhs.chunk);
-
-    // Later added - smaller is chunk index (since we push_front).
-    if (leftChunkIndex != rightChunkIndex)
-        return leftChunkIndex > rightChunkIndex;
-
-    // Later added - smaller is offset.
-    return offset > rhs.offset;
-}
+} // unnamed namespace
 
 FieldLookupTable::FieldLookupTable(quint32 maxSize, bool use)
     : maxTableSize(maxSize),
       tableCapacity(maxSize),
       useIndex(use),
+      insertCount(),
       nDynamic(),
       begin(),
       end(),
@@ -182,10 +142,13 @@ bool FieldLookupTable::prependField(const QByteArray &name, const QByteArray &va
     newField.value = value;
 
     if (useIndex) {
-        const auto result = searchIndex.insert(frontKey());
-        Q_UNUSED(result) Q_ASSERT(result.second);
+        // The new entry hides its older duplicates (if any):
+        fieldIndex.insert(newField, insertCount);
+        nameIndex.insert(name, insertCount);
     }
 
+    ++insertCount;
+
     return true;
 }
 
@@ -196,12 +159,20 @@ void FieldLookupTable::evictEntry()
 
     Q_ASSERT(end != begin);
 
+    const HeaderField &field = back();
+
     if (useIndex) {
-        const auto res = searchIndex.erase(backKey());
-        Q_UNUSED(res) Q_ASSERT(res == 1);
+        // Unless a newer duplicate took the slot:
+        const quint64 insertion = insertCount - nDynamic;
+        const auto fieldPos = fieldIndex.find(field);
+        Q_ASSERT(fieldPos != fieldIndex.end());
+        if (fieldPos.value() == insertion)
+            fieldIndex.erase(fieldPos);
+        const auto namePos = nameIndex.find(field.name);
+        Q_ASSERT(namePos != nameIndex.end());
+        if (namePos.value() == insertion)
+            nameIndex.erase(namePos);
     }
-
-    const HeaderField &field = back();
     const auto entrySize = entry_size(field);
     Q_ASSERT(entrySize.first);
     Q_ASSERT(dataSize >= entrySize.second);
@@ -241,7 +212,8 @@ quint32 FieldLookupTable::dynamicDataSize() const
 
 void FieldLookupTable::clearDynamicTable()
 {
-    searchIndex.clear();
+    fieldIndex.clear();
+    nameIndex.clear();
     chunks.clear();
     begin = 0;
     end = 0;
@@ -257,13 +229,11 @@ bool FieldLookupTable::indexIsValid(quint32 index) const
 quint32 FieldLookupTable::indexOf(const QByteArray &name, const QByteArray &value)const
 {
     // Start from the static part first:
-    const auto &table = staticPart();
     const HeaderField field(name, value);
-    const auto staticPos = findInStaticPart(field, CompareMode::nameAndValue);
-    if (staticPos != table.end()) {
-        if (staticPos->name == name && staticPos->value == value)
-            return quint32(staticPos - table.begin() + 1);
-    }
+    const auto &staticIndex = staticFieldIndex();
+    const auto staticPos = staticIndex.constFind(field);
+    if (staticPos != staticIndex.cend())
+        return staticPos.value();
 
     // Now we have to lookup in our dynamic part ...
     if (!useIndex) {
@@ -271,13 +241,9 @@ quint32 FieldLookupTable::indexOf(const QByteArray &name, const QByteArray &valu
         return 0;
     }
 
-    const SearchEntry key(&field, nullptr, 0, this);
-    const auto pos = searchIndex.lower_bound(key);
-    if (pos != searchIndex.end()) {
-        const HeaderField &found = *pos->field;
-        if (found.name == name && found.value == value)
-            return keyToIndex(*pos);
-    }
+    const auto pos = fieldIndex.constFind(field);
+    if (pos != fieldIndex.cend())
+        return dynamicIndex(pos.value());
 
     return 0;
 }
@@ -285,13 +251,10 @@ quint32 FieldLookupTable::indexOf(const QByteArray &name, const QByteArray &valu
 quint32 FieldLookupTable::indexOf(const QByteArray &name) const
 {
     // Start from the static part first:
-    const auto &table = staticPart();
-    const HeaderField field(name, QByteArray());
-    const auto staticPos = findInStaticPart(field, CompareMode::nameOnly);
-    if (staticPos != table.end()) {
-        if (staticPos->name == name)
-            return quint32(staticPos - table.begin() + 1);
-    }
+    const auto &staticIndex = staticNameIndex();
+    const auto staticPos = staticIndex.constFind(name);
+    if (staticPos != staticIndex.cend())
+        return staticPos.value();
 
     // Now we have to lookup in our dynamic part ...
     if (!useIndex) {
@@ -299,13 +262,9 @@ quint32 FieldLookupTable::indexOf(const QByteArray &name) const
         return 0;
     }
 
-    const SearchEntry key(&field, nullptr, 0, this);
-    const auto pos = searchIndex.lower_bound(key);
-    if (pos != searchIndex.end()) {
-        const HeaderField &found = *pos->field;
-        if (found.name == name)
-            return keyToIndex(*pos);
-    }
+    const auto pos = nameIndex.constFind(name);
+    if (pos != nameIndex.cend())
+        return dynamicIndex(pos.value());
 
     return 0;
 }
@@ -371,47 +330,12 @@ const HeaderField &FieldLookupTable::back() const
     return (*chunks[chunkIndex])[offset];
 }
 
-quint32 FieldLookupTable::indexOfChunk(const Chunk *chunk) const
+quint32 FieldLookupTable::dynamicIndex(quint64 insertion) const
 {
-    Q_ASSERT(chunk);
-
-    for (size_type i = 0; i < chunks.size(); ++i) {
-        if (chunks[i].get() == chunk)
-            return quint32(i);
-    }
+    Q_ASSERT(insertion < insertCount && insertCount - insertion <= nDynamic);
 
-    Q_UNREACHABLE();
-    return 0;
-}
-
-quint32 FieldLookupTable::keyToIndex(const SearchEntry &key) const
-{
-    Q_ASSERT(key.chunk);
-
-    const auto chunkIndex = indexOfChunk(key.chunk);
-    const auto offset = key.offset;
-    Q_ASSERT(offset < ChunkSize);
-    Q_ASSERT(chunkIndex || offset >= begin);
-
-    return quint32(offset + chunkIndex * ChunkSize - begin + 1 + staticPart().size());
-}
-
-FieldLookupTable::SearchEntry FieldLookupTable::frontKey() const
-{
-    Q_ASSERT(chunks.size() && end != begin);
-    return SearchEntry(&front(), chunks.front().get(), begin, this);
-}
-
-FieldLookupTable::SearchEntry FieldLookupTable::backKey() const
-{
-    Q_ASSERT(chunks.size() && end != begin);
-
-    const HeaderField &field = back();
-    const quint32 absIndex = end - 1;
-    const auto offset = absIndex % ChunkSize;
-    const auto chunk = chunks[absIndex / ChunkSize].get();
-
-    return SearchEntry(&field, chunk, offset, this);
+    // The newest entry has the smallest index:
+    return quint32(staticPart().size() + (insertCount - insertion));
 }
 
 bool FieldLookupTable::updateDynamicTableSize(quint32 size)
@@ -442,8 +366,7 @@ void FieldLookupTable::setMaxDynamicTableSize(quint32 size)
     updateDynamicTableSize(size);
 }
 
-// This data is from the HPACK's specs and it's quite conveniently sorted,
-// except ... 'accept' is in the wrong position, see how we handle it below.
+// This data is from the HPACK's specs.
 const std::vector<HeaderField> &FieldLookupTable::staticPart()
 {
     static std::vector<HeaderField> table = {
@@ -513,32 +436,6 @@ const std::vector<HeaderField> &FieldLookupTable::staticPart()
     return table;
 }
 
-std::vector<HeaderField>::const_iterator FieldLookupTable::findInStaticPart(const HeaderField &field, CompareMode mode)
-{
-    const auto &table = staticPart();
-    const auto acceptPos = table.begin() + 18;
-    if (field.name == "accept") {
-        if (mode == CompareMode::nameAndValue && field.value != "")
-            return table.end();
-        return acceptPos;
-    }
-
-    auto predicate = [mode](const HeaderField &lhs, const HeaderField &rhs) {
-        const int cmp = compare(lhs.name, rhs.name);
-        if (cmp)
-            return cmp < 0;
-        else if (mode == CompareMode::nameAndValue)
-            return compare(lhs.value, rhs.value) < 0;
-        return false;
-    };
-
-    const auto staticPos = std::lower_bound(table.begin(), acceptPos, field, predicate);
-    if (staticPos != acceptPos)
-        return staticPos;
-
-    return std::lower_bound(acceptPos + 1, table.end(), field, predicate);
-}
-
 }
 
 QT_END_NAMESPACE
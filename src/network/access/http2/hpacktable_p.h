@@ -53,12 +53,12 @@
 
 #include <QtCore/qbytearray.h>
 #include <QtCore/qglobal.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qpair.h>
 
 #include <vector>
 #include <memory>
 #include <deque>
-#include <set>
 
 QT_BEGIN_NAMESPACE
 
@@ -86,6 +86,11 @@ struct Q_AUTOTEST_EXPORT HeaderField
     QByteArray value;
 };
 
+inline uint qHash(const HeaderField &field, uint seed = 0) noexcept
+{
+    return qHash(field.value, qHash(field.name, seed));
+}
+
 using HeaderSize = QPair<bool, quint32>;
 
 HeaderSize entry_size(const QByteArray &name, const QByteArray &value);
@@ -124,23 +129,20 @@ inline HeaderSize entry_size(const HeaderField &entry)
     offset in this chunk - random access.
 
     Lookup in a static part is straightforward:
-    it's an (immutable) vector, data is sorted,
-    contains no duplicates, we use binary search comparing string values.
+    it's an (immutable) vector and we have two immutable hash
+    tables mapping (name|value) pairs and names to their indices.
 
     To provide a lookup in dynamic table faster than a linear search,
-    we have an std::set of 'SearchEntries', where each entry contains:
-     - a pointer to a (name|value) pair (to compare
-       name|value strings).
-     - a pointer to a chunk containing this pair and
-     - an offset within this chunk - to calculate a
-       'linear' index.
-
-    Entries in a table can be duplicated (HPACK, 2.3.2),
-    if we evict an entry, we must update our index removing
-    the exactly right key, thus keys in this set are sorted
-    by name|value pairs first, and then by chunk index/offset
-    (so that NewSearchEntryKey < OldSearchEntry even if strings
-    are equal).
+    we number entries in the order they are inserted and keep two
+    hash tables that map (name|value) pairs and names to the number
+    of the most recently inserted matching entry (the one with the
+    smallest index). The 'linear' index of an entry is the distance
+    between its number and the number of the newest entry.
+
+    Entries in a table can be duplicated (HPACK, 2.3.2). A hash
+    table slot always refers to the newest duplicate, so when we
+    evict an entry (always the oldest one), we remove the slot only
+    if it still refers to this entry.
 */
 
 class Q_AUTOTEST_EXPORT FieldLookupTable
@@ -190,28 +192,12 @@ private:
     std::deque<ChunkPtr> chunks;
     using size_type = std::deque<ChunkPtr>::size_type;
 
-    struct SearchEntry;
-    friend struct SearchEntry;
-
-    struct SearchEntry
-    {
-        SearchEntry();
-        SearchEntry(const HeaderField *f, const Chunk *c,
-                    quint32 o, const FieldLookupTable *t);
-
-        const HeaderField *field;
-        const Chunk *chunk;
-        const quint32 offset;
-        const FieldLookupTable *table;
-
-        bool operator < (const SearchEntry &rhs) const;
-    };
-
     bool useIndex;
-    std::set<SearchEntry> searchIndex;
-
-    SearchEntry frontKey() const;
-    SearchEntry backKey() const;
+    // How many entries were ever inserted into the dynamic part;
+    // the newest entry is number insertCount - 1.
+    quint64 insertCount;
+    QHash<HeaderField, quint64> fieldIndex;
+    QHash<QByteArray, quint64> nameIndex;
 
     bool fieldAt(quint32 index, HeaderField *field) const;
 
@@ -224,15 +210,7 @@ private:
     quint32 end;
     quint32 dataSize;
 
-    quint32 indexOfChunk(const Chunk *chunk) const;
-    quint32 keyToIndex(const SearchEntry &key) const;
-
-    enum class CompareMode {
-        nameOnly,
-        nameAndValue
-    };
-
-    static std::vector<HeaderField>::const_iterator findInStaticPart(const HeaderField &field, CompareMode mode);
+    quint32 dynamicIndex(quint64 insertion) const;
 
     mutable QByteArray dummyDst;
 
@@ -42,7 +42,6 @@
 
 #include <QtCore/qbytearray.h>
 
-#include <algorithm>
 #include <limits>
 
 QT_BEGIN_NAMESPACE
@@ -60,32 +59,25 @@ namespace HPack
     code length. All codes were left-aligned - for implementation
     convenience.
 
-    Using binary trees to implement decoding would be prohibitively
-    expensive (both memory and time-wise). Instead we use a table-based
-    approach and any given code itself works as an index into such table(s).
-    We have 256 possible byte values and code lengths in
-    a range [5, 26]. This would require a huge table (and most of entries
-    would be 'wasted', since we only have to encode 256 elements).
-    Instead we use multi-level tables. The first level table
-    is using 9-bit length index; some entries in this table are 'terminal',
-    some reference the next level table(s).
+    Walking a binary tree bit by bit to decode is prohibitively
+    expensive. Instead we build the tree once and turn it into a
+    finite state machine that consumes a whole octet per step:
+    257 symbols (256 byte values + EOS) give a tree with 256
+    internal nodes, these are our states. For each state and each
+    octet value we precompute the state reached after walking 8 bits
+    down the tree (restarting from the root whenever a leaf is hit)
+    and the symbols found on the way. Codes are 5 to 30 bits long,
+    so an octet completes at most two symbols.
 
     For example, bytes with values 48 and 49 (ASCII codes for '0' and '1')
-    both have code length 5, Huffman codes are: 00000 and 00001. They
-    both are placed in the 'root' table,
-    the 'root' table has index length == 9:
-    [00000 | 4 remaining bits]
-     ...
-    [00001 | 4 remaining bits]
-
-    All entires with indices between these two will 'point' to value 48
-    with bitLength == 5 so that bit stream (for example) 000001010 will be
-    decoded as: 48 + "put 1010 back into bitstream".
-
-    A good description can be found here:
-    http://commandlinefanatic.com/cgi-bin/showarticle.cgi?article=art007
-    or just google "Efficient Huffman Decoding".
-    Also see comments below about 'filling holes'.
+    both have code length 5, Huffman codes are: 00000 and 00001. From
+    the initial state, octet 00000000 produces '0' and leaves us in the
+    state '000' (3 bits of the next code read), octet 00001010 produces
+    '1' and leaves us in the state '010'.
+
+    A string may end only in the initial state or in a state reached by
+    up to 7 '1' bits - the padding (HPACK, 5.2); a step that would
+    complete the EOS symbol is a decoding error.
 */
 
 namespace
@@ -352,29 +344,13 @@ const CodeEntry staticHuffmanCodeTable[]
     {256, 0xfffffffcul, 30}   // EOS 11111111|11111111|11111111|111111
 };
 
-void write_huffman_code(BitOStream &outputStream, const CodeEntry &code)
+// The decoder's code tree, a leaf is stored as ~symbol
+// in its parent's 'children' and 0 means 'no child'
+// (the root is never a child).
+struct TreeNode
 {
-    // Append octet by octet.
-    auto bitLength = code.bitLength;
-    const auto hc = code.huffmanCode >> (32 - bitLength);
-
-    if (bitLength > 24) {
-        outputStream.writeBits(uchar(hc >> 24), bitLength - 24);
-        bitLength = 24;
-    }
-
-    if (bitLength > 16) {
-        outputStream.writeBits(uchar(hc >> 16), bitLength - 16);
-        bitLength = 16;
-    }
-
-    if (bitLength > 8) {
-        outputStream.writeBits(uchar(hc >> 8), bitLength - 8);
-        bitLength = 8;
-    }
-
-    outputStream.writeBits(uchar(hc), bitLength);
-}
+    qint16 children[2] = {};
+};
 
 }
 
@@ -385,189 +361,148 @@ quint64 huffman_encoded_bit_length(const QByteArray &inputData)
 {
     quint64 bitLength = 0;
     for (int i = 0, e = inputData.size(); i < e; ++i)
-        bitLength += staticHuffmanCodeTable[int(inputData[i])].bitLength;
+        bitLength += staticHuffmanCodeTable[uchar(inputData[i])].bitLength;
 
     return bitLength;
 }
 
 void huffman_encode_string(const QByteArray &inputData, BitOStream &outputStream)
 {
+    // We collect codes in a 64-bit accumulator and write complete octets,
+    // 'pending' (< 8 between the iterations) is the number of bits
+    // not written yet, they are the least significant bits of 'bits'.
+    quint64 bits = 0;
+    quint32 pending = 0;
     for (int i = 0, e = inputData.size(); i < e; ++i) {
-        const auto value = uchar(inputData[i]);
-        write_huffman_code(outputStream, staticHuffmanCodeTable[value]);
+        const CodeEntry &code = staticHuffmanCodeTable[uchar(inputData[i])];
+        bits = (bits << code.bitLength) | (code.huffmanCode >> (32 - code.bitLength));
+        pending += code.bitLength;
+        while (pending >= 8) {
+            pending -= 8;
+            outputStream.writeBits(uchar(bits >> pending), 8);
+        }
     }
 
+    if (pending)
+        outputStream.writeBits(uchar(bits), quint8(pending));
+
     // Pad bits ...
     if (outputStream.bitLength() % 8)
         outputStream.writeBits(0xff, 8 - outputStream.bitLength() % 8);
 }
 
-bool padding_is_valid(quint32 chunk, quint32 nBits)
-{
-    Q_ASSERT(nBits);
-
-    // HPACK, 5.2: "A padding strictly longer than 7 bits MUST be
-    // treated as a decoding error."
-    if (nBits > 7)
-        return false;
-    // HPACK, 5.2:
-    // "A padding not corresponding to the most significant bits
-    // of the code for the EOS symbol MUST be treated as a decoding error."
-    return (chunk >> (32 - nBits)) == quint32((1 << nBits) - 1);
-}
-
 HuffmanDecoder::HuffmanDecoder()
-    : minCodeLength()
+    : transitions(stateCount * 256)
 {
-    const auto nCodes = sizeof staticHuffmanCodeTable / sizeof staticHuffmanCodeTable[0];
-
-    std::vector<CodeEntry> symbols(staticHuffmanCodeTable, staticHuffmanCodeTable + nCodes);
-    // Now we sort: by bit length first (in the descending order) and by the symbol
-    // value (descending). Descending order: to make sure we do not create prefix tables with
-    // short 'indexLength' first and having longer codes that do not fit into such tables later.
-    std::sort(symbols.begin(), symbols.end(), [](const CodeEntry &code1, const CodeEntry &code2) {
-        if (code1.bitLength == code2.bitLength)
-            return code1.byteValue > code2.byteValue;
-        return code1.bitLength > code2.bitLength;
-    });
-
-    minCodeLength = symbols.back().bitLength; // The shortest one, currently it's 5.
-
-    // TODO: add a verification - Huffman codes
-    // within a given bit length range also
-    // should be in descending order.
-
-    // Initialize 'prefixTables' and 'tableData'.
-    addTable(0, quint32(BitConstants::rootPrefix)); // 'root' table.
-
-    for (const auto &s : symbols) {
-        quint32 tableIndex = 0;
-        while (true) {
-            Q_ASSERT(tableIndex < prefixTables.size());
-            // Note, by value - since prefixTables will be updated in between.
-            const auto table = prefixTables[tableIndex];
-            // We skip prefixed bits (if any) and use indexed bits only:
-            const auto entryIndex = s.huffmanCode << table.prefixLength >> (32 - table.indexLength);
-            // Again, by value.
-            PrefixTableEntry entry = tableEntry(table, entryIndex);
-            // How many bits were coded by previous tables and this table:
-            const auto codedLength = table.prefixLength + table.indexLength;
-            if (codedLength < s.bitLength) {
-                // We have to add a new prefix table ... (if it's not done yet).
-                if (!entry.bitLength) {
-                    entry.nextTable = addTable(codedLength, std::min<quint32>(quint32(BitConstants::childPrefix),
-                                                                              s.bitLength - codedLength));
-                    entry.bitLength = s.bitLength;
-                    entry.byteValue = s.byteValue;
-                    setTableEntry(table, entryIndex, entry);
-                }
-                tableIndex = entry.nextTable;
-            } else {
-                // We found the slot for our code (terminal entry):
-                entry.byteValue = s.byteValue;
-                entry.bitLength = s.bitLength;
-                // Refer to our own table as 'nextTable':
-                entry.nextTable = tableIndex;
-                setTableEntry(table, entryIndex, entry);
+    // Build the code tree:
+    std::vector<TreeNode> tree(1);
+    for (const CodeEntry &code : staticHuffmanCodeTable) {
+        int node = 0;
+        for (quint32 i = 0; i < code.bitLength; ++i) {
+            const int bit = (code.huffmanCode >> (31 - i)) & 1;
+            if (i + 1 == code.bitLength) {
+                Q_ASSERT(!tree[node].children[bit]);
+                tree[node].children[bit] = qint16(~code.byteValue);
                 break;
             }
-        }
-    }
 
-    // Now, we have a table(s) and have to fill 'holes' to
-    // 'fix' terminal entries.
-    for (const auto &table : prefixTables) {
-        const quint32 codedLength = table.prefixLength + table.indexLength;
-        for (quint32 j = 0; j < table.size();) {
-            const PrefixTableEntry &entry = tableEntry(table, j);
-            if (entry.bitLength && entry.bitLength < codedLength) {
-                const quint32 range = 1 << (codedLength - entry.bitLength);
-                for (quint32 k = 1; k < range; ++k)
-                    setTableEntry(table, j + k, entry);
-                j += range;
-            } else {
-                ++j;
+            if (!tree[node].children[bit]) {
+                tree[node].children[bit] = qint16(tree.size());
+                tree.emplace_back();
             }
+            node = tree[node].children[bit];
+            Q_ASSERT(node > 0);
         }
     }
-}
 
-bool HuffmanDecoder::decodeStream(BitIStream &inputStream, QByteArray &outputBuffer)
-{
-    while (true) {
-        quint32 chunk = 0;
-        const quint32 readBits = inputStream.peekBits(inputStream.streamOffset(), 32, &chunk);
-        if (!readBits)
-            return !inputStream.hasMoreBits();
-
-        if (readBits < minCodeLength) {
-            inputStream.skipBits(readBits);
-            return padding_is_valid(chunk, readBits);
-        }
+    Q_ASSERT(tree.size() == stateCount);
 
-        quint32 tableIndex = 0;
-        const PrefixTable *table = &prefixTables[tableIndex];
-        quint32 entryIndex = chunk >> (32 - table->indexLength);
-        PrefixTableEntry entry = tableEntry(*table, entryIndex);
+    // The states where a string can end: the root and the
+    // nodes on the path of the EOS code up to 7 bits deep.
+    bool acceptingStates[stateCount] = {};
+    for (int node = 0, depth = 0; depth < 8; ++depth) {
+        acceptingStates[node] = true;
+        node = tree[node].children[1];
+        Q_ASSERT(node > 0);
+    }
 
-        while (true) {
-            if (entry.nextTable == tableIndex)
-                break;
+    for (int state = 0; state < stateCount; ++state) {
+        for (int octet = 0; octet < 256; ++octet) {
+            HuffmanTransition &transition = transitions[state * 256 + octet];
+            int node = state;
+            quint8 symbolCount = 0;
+            for (int i = 7; i >= 0; --i) {
+                const int child = tree[node].children[(octet >> i) & 1];
+                Q_ASSERT(child);
+                if (child > 0) {
+                    node = child;
+                    continue;
+                }
 
-            tableIndex = entry.nextTable;
-            table = &prefixTables[tableIndex];
-            entryIndex = chunk << table->prefixLength >> (32 - table->indexLength);
-            entry = tableEntry(*table, entryIndex);
-        }
+                const int symbol = ~child;
+                if (symbol == 256) {
+                    // EOS (256) == compression error (HPACK).
+                    transition.flags |= failure;
+                    break;
+                }
 
-        if (entry.bitLength > readBits) {
-            inputStream.skipBits(readBits);
-            return padding_is_valid(chunk, readBits);
-        }
+                Q_ASSERT(symbolCount < 2);
+                transition.symbols[symbolCount++] = uchar(symbol);
+                node = 0;
+            }
 
-        if (!entry.bitLength || entry.byteValue == 256) {
-            //EOS (256) == compression error (HPACK).
-            inputStream.skipBits(readBits);
-            return false;
+            transition.nextState = quint8(node);
+            transition.flags |= symbolCount;
+            if (acceptingStates[node])
+                transition.flags |= accepting;
         }
-
-        outputBuffer.append(entry.byteValue);
-        inputStream.skipBits(entry.bitLength);
     }
-
-    return false;
 }
 
-quint32 HuffmanDecoder::addTable(quint32 prefix, quint32 index)
+bool HuffmanDecoder::decodeStream(const uchar *first, const uchar *last, QByteArray &outputBuffer) const
 {
-    PrefixTable newTable{prefix, index};
-    newTable.offset = quint32(tableData.size());
-    prefixTables.push_back(newTable);
-    // Add entries for this table:
-    tableData.resize(tableData.size() + newTable.size());
+    Q_ASSERT(first <= last);
+
+    // Every symbol takes at least 5 bits:
+    const int oldSize = outputBuffer.size();
+    outputBuffer.resize(oldSize + int(quint64(last - first) * 8 / 5));
+    char *dst = outputBuffer.data() + oldSize;
+
+    quint32 state = 0;
+    bool accepted = true;
+    for (; first != last; ++first) {
+        const HuffmanTransition &transition = transitions[state * 256 + *first];
+        if (transition.flags & failure) {
+            outputBuffer.resize(oldSize);
+            return false;
+        }
 
-    return quint32(prefixTables.size() - 1);
-}
+        switch (transition.flags & symbolCountMask) {
+        case 2:
+            *dst++ = char(transition.symbols[0]);
+            *dst++ = char(transition.symbols[1]);
+            break;
+        case 1:
+            *dst++ = char(transition.symbols[0]);
+            break;
+        default:
+            break;
+        }
 
-PrefixTableEntry HuffmanDecoder::tableEntry(const PrefixTable &table, quint32 index)
-{
-    Q_ASSERT(index < table.size());
-    return tableData[table.offset + index];
-}
+        state = transition.nextState;
+        accepted = transition.flags & accepting;
+    }
 
-void HuffmanDecoder::setTableEntry(const PrefixTable &table, quint32 index,
-                                   const PrefixTableEntry &entry)
-{
-    Q_ASSERT(index < table.size());
-    tableData[table.offset + index] = entry;
+    outputBuffer.resize(int(dst - outputBuffer.constData()));
+    return accepted;
 }
 
-bool huffman_decode_string(BitIStream &inputStream, QByteArray *outputBuffer)
+bool huffman_decode_string(const uchar *first, const uchar *last, QByteArray *outputBuffer)
 {
     Q_ASSERT(outputBuffer);
 
-    static HuffmanDecoder decoder;
-    return decoder.decodeStream(inputStream, *outputBuffer);
+    static const HuffmanDecoder decoder;
+    return decoder.decodeStream(first, last, *outputBuffer);
 }
 
 }
@@ -53,6 +53,8 @@
 
 #include <QtCore/qglobal.h>
 
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 class QByteArray;
@@ -72,94 +74,50 @@ class BitOStream;
 quint64 huffman_encoded_bit_length(const QByteArray &inputData);
 void huffman_encode_string(const QByteArray &inputData, BitOStream &outputStream);
 
-// PrefixTable:
-// Huffman codes with a small bit length
-// fit into a table (these are 'terminal' symbols),
-// codes with longer codes require additional
-// tables, so several symbols will have the same index
-// in a table - pointing into the next table.
-// Every table has an 'indexLength' - that's
-// how many bits can fit in table's indices +
-// 'prefixLength' - how many bits were addressed
-// by its 'parent' table(s).
-// All PrefixTables are kept in 'prefixTables' array.
-// PrefixTable itself does not have any entries,
-// it just holds table's prefix/index + 'offset' -
-// there table's data starts in an array of all
-// possible entries ('tableData').
-
-struct PrefixTable
-{
-    PrefixTable()
-        : prefixLength(),
-          indexLength(),
-          offset()
-    {
-    }
-
-    PrefixTable(quint32 prefix, quint32 index)
-        : prefixLength(prefix),
-          indexLength(index),
-          offset()
-    {
-    }
-
-    quint32 size()const
-    {
-        // Number of entries table contains:
-        return 1 << indexLength;
-    }
-
-    quint32 prefixLength;
-    quint32 indexLength;
-    quint32 offset;
-};
-
-// Table entry is either a terminal entry (thus probably the code found)
-// or points into another table ('nextTable' - index into
-// 'prefixTables' array). If it's a terminal, 'nextTable' index
-// refers to the same table.
+// HuffmanDecoder is a finite state machine consuming the input
+// one octet at a time. A state is an internal node of the Huffman
+// code tree (the bits of a code read so far, the root being the
+// initial state). For every state and every possible octet the
+// transition table gives the next state and the symbols completed
+// while reading this octet - at most two, since the shortest code
+// is 5 bits long.
 
-struct PrefixTableEntry
+struct HuffmanTransition
 {
-    PrefixTableEntry()
-        : bitLength(),
-          nextTable(),
-          byteValue()
-    {
-    }
-
-    quint32 bitLength;
-    quint32 nextTable;
-    quint32 byteValue;
+    quint8 nextState;
+    // The number of symbols and TransitionFlags.
+    quint8 flags;
+    uchar symbols[2];
 };
 
-class BitIStream;
-
 class HuffmanDecoder
 {
 public:
-    enum class BitConstants
+    enum
     {
-        rootPrefix = 9,
-        childPrefix = 6
+        // 257 symbols (including EOS) make 256 internal nodes.
+        stateCount = 256
+    };
+
+    enum TransitionFlag : quint8
+    {
+        symbolCountMask = 0x3,
+        // The octet ends in a state where the end of
+        // the string is allowed (valid padding).
+        accepting = 0x4,
+        // The octet contains EOS.
+        failure = 0x8
     };
 
     HuffmanDecoder();
 
-    bool decodeStream(BitIStream &inputStream, QByteArray &outputBuffer);
+    bool decodeStream(const uchar *first, const uchar *last, QByteArray &outputBuffer) const;
 
 private:
-    quint32 addTable(quint32 prefixLength, quint32 indexLength);
-    PrefixTableEntry tableEntry(const PrefixTable &table, quint32 index);
-    void setTableEntry(const PrefixTable &table, quint32 index, const PrefixTableEntry &entry);
-
-    std::vector<PrefixTable> prefixTables;
-    std::vector<PrefixTableEntry> tableData;
-    quint32 minCodeLength;
+    std::vector<HuffmanTransition> transitions;
 };
 
-bool huffman_decode_string(BitIStream &inputStream, QByteArray *outputBuffer);
+bool huffman_decode_string(const uchar *first, const uchar *last, QByteArray *outputBuffer);
 
 } // namespace HPack
 
@@ -54,6 +54,11 @@ QAbstractProtocolHandler::~QAbstractProtocolHandler()
 {
 }
 
+int QAbstractProtocolHandler::requestsInFlight() const
+{
+    return m_channel->reply ? 1 + m_channel->alreadyPipelinedRequests.size() : 0;
+}
+
 void QAbstractProtocolHandler::setReply(QHttpNetworkReply *reply)
 {
     m_reply = reply;
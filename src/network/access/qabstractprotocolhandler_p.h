@@ -70,6 +70,8 @@ public:
     virtual void _q_receiveReply() = 0;
     virtual void _q_readyRead() = 0;
     virtual bool sendRequest() = 0;
+    // The number of requests that were sent and wait for their reply
+    virtual int requestsInFlight() const;
     void setReply(QHttpNetworkReply *reply);
 
 protected:
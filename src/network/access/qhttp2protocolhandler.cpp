@@ -1475,6 +1475,8 @@ void QHttp2ProtocolHandler::deleteActiveStream(quint32 streamID)
     removeFromSuspended(streamID);
     if (m_channel->spdyRequestsToSend.size())
         QMetaObject::invokeMethod(this, "sendRequest", Qt::QueuedConnection);
+
+    m_connection->d_func()->updateStatistics();
 }
 
 bool QHttp2ProtocolHandler::streamWasReset(quint32 streamID) const
@@ -106,6 +106,7 @@ private:
     void _q_readyRead() override;
     Q_INVOKABLE void _q_receiveReply() override;
     Q_INVOKABLE bool sendRequest() override;
+    int requestsInFlight() const override { return activeStreams.size(); }
 
     bool sendClientPreface();
     bool sendSETTINGS_ACK();
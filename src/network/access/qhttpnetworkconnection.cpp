@@ -52,6 +52,7 @@
 #include <qbuffer.h>
 #include <qpair.h>
 #include <qdebug.h>
+#include <qscopeguard.h>
 
 #ifndef QT_NO_SSL
 #    include <private/qsslsocket_p.h>
@@ -105,7 +106,13 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 connectionC
                                                              QHttpNetworkConnection::ConnectionType type)
 : state(RunningState), networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  activeChannelCount(connectionCount), channelCount(connectionCount)
+  activeChannelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2
+                     || type == QHttpNetworkConnection::ConnectionTypeHTTP2Direct
+#ifndef QT_NO_SSL
+                     || type == QHttpNetworkConnection::ConnectionTypeSPDY
+#endif
+                     ? 1 : connectionCount),
+  channelCount(connectionCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -127,6 +134,30 @@ QHttpNetworkConnectionPrivate::~QHttpNetworkConnectionPrivate()
         }
     }
     delete []channels;
+
+    if (connectionPool)
+        connectionPool->updateUsage(&publishedUsage, QNetworkAccessConnectionPool::Usage());
+}
+
+void QHttpNetworkConnectionPrivate::updateStatistics()
+{
+    if (!connectionPool)
+        return;
+
+    QNetworkAccessConnectionPool::Usage usage;
+    usage.queuedRequests = highPriorityQueue.size() + lowPriorityQueue.size();
+    for (int i = 0; i < channelCount; ++i) {
+        const QHttpNetworkConnectionChannel &channel = channels[i];
+        usage.queuedRequests += channel.spdyRequestsToSend.size();
+        if (!channel.socket || channel.socket->state() != QAbstractSocket::ConnectedState)
+            continue;
+        ++usage.openConnections;
+        const int inFlight = channel.protocolHandler ? channel.protocolHandler->requestsInFlight() : 0;
+        if (inFlight)
+            ++usage.busyConnections;
+        usage.activeRequests += inFlight;
+    }
+    connectionPool->updateUsage(&publishedUsage, usage);
 }
 
 void QHttpNetworkConnectionPrivate::init()
@@ -647,6 +678,8 @@ QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetwor
 
     if (request.isPreConnect())
         preConnectRequests++;
+    else if (connectionPool)
+        connectionPool->requestQueued();
 
     if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP
         || (!encrypt && connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2 && !channels[0].switchedToHttp2)) {
@@ -1047,6 +1080,8 @@ void QHttpNetworkConnectionPrivate::removeReply(QHttpNetworkReply *reply)
 // although it is called _q_startNextRequest, it will actually start multiple requests when possible
 void QHttpNetworkConnectionPrivate::_q_startNextRequest()
 {
+    const auto statisticsGuard = qScopeGuard([this] { updateStatistics(); });
+
     // If there is no network layer state decided we should not start any new requests.
     if (networkLayerState == Unknown || networkLayerState == HostLookupPending || networkLayerState == IPv4or6)
         return;
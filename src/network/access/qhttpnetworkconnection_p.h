@@ -71,6 +71,7 @@
 #include <private/qhttpnetworkreply_p.h>
 #include <private/qnetconmonitor_p.h>
 #include <private/http2protocol_p.h>
+#include <private/qnetworkaccessconnectionpool_p.h>
 
 #include <private/qhttpnetworkconnectionchannel_p.h>
 
@@ -314,6 +315,11 @@ public:
     // early).
     QNetworkConnectionMonitor connectionMonitor;
 
+    // Publishes what the channels are doing to the manager's statistics
+    void updateStatistics();
+    QSharedPointer<QNetworkAccessConnectionPool> connectionPool;
+    QNetworkAccessConnectionPool::Usage publishedUsage;
+
     friend class QHttpNetworkConnectionChannel;
 };
 
@@ -875,6 +875,7 @@ void QHttpNetworkConnectionChannel::_q_disconnected()
     }
 
     pendingEncrypt = false;
+    connection->d_func()->updateStatistics();
 }
 
 
@@ -921,6 +922,9 @@ void QHttpNetworkConnectionChannel::_q_connected()
     // not sure yet if it helps, but it makes sense
     socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
 
+    if (connection->d_func()->connectionPool)
+        connection->d_func()->connectionPool->connectionOpened();
+
     pipeliningSupported = QHttpNetworkConnectionChannel::PipeliningSupportUnknown;
 
     if (QNetworkStatusMonitor::isEnabled()) {
@@ -861,7 +861,7 @@ qint64 QHttpNetworkReplyPrivate::readReplyBodyChunked(QAbstractSocket *socket, Q
     qint64 bytes = 0;
     while (socket->bytesAvailable()) {
 
-        if (readBufferMaxSize && (bytes > readBufferMaxSize))
+        if (readBufferMaxSize && (bytes >= readBufferMaxSize))
             break;
 
         if (!lastChunkRead && currentChunkRead >= currentChunkSize) {
@@ -908,7 +908,10 @@ qint64 QHttpNetworkReplyPrivate::readReplyBodyChunked(QAbstractSocket *socket, Q
         }
 
         // otherwise, try to begin reading this chunk / to read what is missing for this chunk
-        qint64 haveRead = readReplyBodyRaw (socket, out, currentChunkSize - currentChunkRead);
+        qint64 toBeRead = currentChunkSize - currentChunkRead;
+        if (readBufferMaxSize)
+            toBeRead = qMin(toBeRead, readBufferMaxSize - bytes);
+        qint64 haveRead = readReplyBodyRaw (socket, out, toBeRead);
         currentChunkRead += haveRead;
         bytes += haveRead;
 
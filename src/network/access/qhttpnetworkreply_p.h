@@ -185,6 +185,7 @@ private:
     friend class QHttpNetworkConnectionChannel;
     friend class QHttp2ProtocolHandler;
     friend class QHttpProtocolHandler;
+    friend class QHttp1ServerConnection;
     friend class QSpdyProtocolHandler;
 };
 
@@ -57,6 +57,8 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
       customVerb(other.customVerb),
       priority(other.priority),
       uploadByteDevice(other.uploadByteDevice),
+      uploadFile(other.uploadFile),
+      uploadFileOffset(other.uploadFileOffset),
       autoDecompress(other.autoDecompress),
       pipeliningAllowed(other.pipeliningAllowed),
       spdyAllowed(other.spdyAllowed),
@@ -82,6 +84,8 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
         && (operation == other.operation)
         && (priority == other.priority)
         && (uploadByteDevice == other.uploadByteDevice)
+        && (uploadFile == other.uploadFile)
+        && (uploadFileOffset == other.uploadFileOffset)
         && (autoDecompress == other.autoDecompress)
         && (pipeliningAllowed == other.pipeliningAllowed)
         && (spdyAllowed == other.spdyAllowed)
@@ -396,6 +400,24 @@ QNonContiguousByteDevice* QHttpNetworkRequest::uploadByteDevice() const
     return d->uploadByteDevice;
 }
 
+// The upload data is the content of file from offset on. uploadByteDevice
+// is still needed for the size, for resets and to report progress.
+void QHttpNetworkRequest::setUploadFile(QFile *file, qint64 offset)
+{
+    d->uploadFile = file;
+    d->uploadFileOffset = offset;
+}
+
+QFile *QHttpNetworkRequest::uploadFile() const
+{
+    return d->uploadFile;
+}
+
+qint64 QHttpNetworkRequest::uploadFileOffset() const
+{
+    return d->uploadFileOffset;
+}
+
 int QHttpNetworkRequest::majorVersion() const
 {
     return 1;
@@ -60,6 +60,7 @@ QT_REQUIRE_CONFIG(http);
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
 class QNonContiguousByteDevice;
 
 class QHttpNetworkRequestPrivate;
@@ -145,6 +146,10 @@ public:
     void setUploadByteDevice(QNonContiguousByteDevice *bd);
     QNonContiguousByteDevice* uploadByteDevice() const;
 
+    void setUploadFile(QFile *file, qint64 offset);
+    QFile *uploadFile() const;
+    qint64 uploadFileOffset() const;
+
     QByteArray methodName() const;
     QByteArray uri(bool throughProxy) const;
 
@@ -175,6 +180,10 @@ public:
     QByteArray customVerb;
     QHttpNetworkRequest::Priority priority;
     mutable QNonContiguousByteDevice* uploadByteDevice;
+    // The file the upload data is read from, when it can be sent from
+    // the file directly instead of through uploadByteDevice
+    QFile *uploadFile = nullptr;
+    qint64 uploadFileOffset = 0;
     bool autoDecompress;
     bool pipeliningAllowed;
     bool spdyAllowed;
@@ -353,6 +353,35 @@ bool QHttpProtocolHandler::sendRequest()
         const qint64 socketBufferFill = 32*1024;
         const qint64 socketWriteMaxSize = 16*1024;
 
+        // On plain connections, let the socket send the upload data straight
+        // from the file (without copying it on Linux). The upload device is
+        // only advanced, to report progress.
+        QTcpSocket *tcpSocket = qobject_cast<QTcpSocket *>(m_socket);
+        if (m_channel->request.uploadFile() && tcpSocket && !m_channel->ssl) {
+            const qint64 socketFileChunkSize = 256*1024;
+            while (m_socket->bytesToWrite() <= socketBufferFill
+                   && m_channel->bytesTotal != m_channel->written) {
+                const qint64 size = qMin(socketFileChunkSize,
+                                         m_channel->bytesTotal - m_channel->written);
+                const qint64 offset = m_channel->request.uploadFileOffset() + m_channel->written;
+                if (tcpSocket->sendFile(m_channel->request.uploadFile(), offset, size) != size) {
+                    m_connection->d_func()->emitReplyError(m_socket, m_reply, QNetworkReply::UnknownNetworkError);
+                    return false;
+                }
+                m_channel->written += size;
+                uploadByteDevice->advanceReadPointer(size);
+
+                emit m_reply->dataSendProgress(m_channel->written, m_channel->bytesTotal);
+
+                if (m_channel->written == m_channel->bytesTotal) {
+                    // make sure this function is called once again
+                    m_channel->state = QHttpNetworkConnectionChannel::WaitingState;
+                    sendRequest();
+                    break;
+                }
+            }
+            break;
+        }
 
 #ifndef QT_NO_SSL
         QSslSocket *sslSocket = qobject_cast<QSslSocket*>(m_socket);
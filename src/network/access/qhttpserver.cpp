@@ -0,0 +1,407 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpserver.h"
+#include "qhttpserver_p.h"
+#include "qhttpserverconnection_p.h"
+
+#include <QtNetwork/qtcpsocket.h>
+#ifndef QT_NO_SSL
+#include <QtNetwork/qsslsocket.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttpServer
+    \brief The QHttpServer class is a minimal embedded HTTP/1.1 and HTTP/2 server.
+    \since 5.15
+
+    \inmodule QtNetwork
+    \ingroup network
+
+    QHttpServer accepts connections on one or more QTcpServer instances
+    and emits newRequest() for every request that arrives. The
+    application reads the request body from the QHttpServerRequest and
+    writes the response to the QHttpServerResponse; both are sequential
+    I/O devices, so large bodies can be streamed in either direction
+    without being held in memory.
+
+    \snippet code/src_network_access_qhttpserver.cpp 0
+
+    HTTP/1.1 connections are kept alive and may pipeline requests;
+    responses are sent in the order the requests arrived. HTTP/2 is
+    negotiated with ALPN on encrypted connections, and on cleartext
+    connections either with prior knowledge or with an \c{Upgrade: h2c}
+    request without a body. Use setHttp2Enabled() to serve HTTP/1.x only.
+
+    Request bodies are subject to flow control: the server reads at
+    most readBufferSize() bytes ahead of the application, and on HTTP/2
+    returns flow control credit to the client only once the application
+    has read the data.
+
+    The request and response objects are owned by the server. They are
+    deleted once the response has been sent, or when the connection
+    closes, so an application that completes a response asynchronously
+    should keep them in a QPointer.
+
+    \sa QHttpServerRequest, QHttpServerResponse, QHttp2Configuration
+*/
+
+/*!
+    \fn void QHttpServer::newRequest(QHttpServerRequest *request, QHttpServerResponse *response)
+
+    This signal is emitted when the headers of \a request have been
+    received. The body, if any, becomes readable through \a request as
+    it arrives. The application must eventually call
+    QHttpServerResponse::finish() on \a response.
+*/
+
+namespace {
+
+class QHttpServerTcpServer : public QTcpServer
+{
+public:
+    explicit QHttpServerTcpServer(QHttpServerPrivate *d, QObject *parent)
+        : QTcpServer(parent), d(d)
+    {
+    }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+#ifndef QT_NO_SSL
+        if (!d->sslConfiguration.isNull()) {
+            QSslSocket *socket = new QSslSocket(this);
+            if (!socket->setSocketDescriptor(socketDescriptor)) {
+                delete socket;
+                return;
+            }
+            QSslConfiguration configuration = d->sslConfiguration;
+            QList<QByteArray> protocols;
+            if (d->http2Enabled)
+                protocols.append(QSslConfiguration::ALPNProtocolHTTP2);
+            protocols.append(QSslConfiguration::NextProtocolHttp1_1);
+            configuration.setAllowedNextProtocols(protocols);
+            socket->setSslConfiguration(configuration);
+            addPendingConnection(socket);
+            socket->startServerEncryption();
+            return;
+        }
+#endif
+        QTcpServer::incomingConnection(socketDescriptor);
+    }
+
+private:
+    QHttpServerPrivate *d;
+};
+
+} // unnamed namespace
+
+void QHttpServerPrivate::_q_newConnection()
+{
+    // Drain every server rather than asking who sent the signal
+    for (const QPointer<QTcpServer> &server : qAsConst(servers)) {
+        if (!server)
+            continue;
+        while (QTcpSocket *socket = server->nextPendingConnection())
+            startConnection(socket);
+    }
+}
+
+void QHttpServerPrivate::startConnection(QAbstractSocket *socket)
+{
+    Q_Q(QHttpServer);
+
+#ifndef QT_NO_SSL
+    if (QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket)) {
+        if (sslSocket->mode() != QSslSocket::UnencryptedMode && !sslSocket->isEncrypted()) {
+            // Pick the protocol once ALPN is done
+            sslSocket->setParent(q);
+            QObject::connect(sslSocket, &QSslSocket::encrypted, q, [this, sslSocket]() {
+                sslSocket->disconnect(q_func());
+                startConnection(sslSocket);
+            });
+            QObject::connect(sslSocket, &QAbstractSocket::disconnected,
+                             sslSocket, &QObject::deleteLater);
+            return;
+        }
+        if (http2Enabled && sslSocket->isEncrypted()
+            && sslSocket->sslConfiguration().nextNegotiatedProtocol()
+               == QSslConfiguration::ALPNProtocolHTTP2) {
+            QHttp2ServerConnection *connection = new QHttp2ServerConnection(q, socket);
+            connection->start();
+            return;
+        }
+    }
+#endif
+
+    new QHttp1ServerConnection(q, socket);
+}
+
+/*!
+    Constructs a QHttpServer object with the given \a parent. Call
+    listen() or bind() to start accepting connections.
+*/
+QHttpServer::QHttpServer(QObject *parent)
+    : QObject(*new QHttpServerPrivate, parent)
+{
+}
+
+/*!
+    Destroys the server, closing all of its connections.
+*/
+QHttpServer::~QHttpServer()
+{
+}
+
+/*!
+    Tells the server to listen for incoming connections on \a address
+    and \a port. If \a port is 0, a port is chosen automatically.
+
+    Returns \c true on success; otherwise returns \c false, and
+    errorString() describes the error.
+
+    \sa bind(), serverPort(), close()
+*/
+bool QHttpServer::listen(const QHostAddress &address, quint16 port)
+{
+    Q_D(QHttpServer);
+    if (!d->ownServer) {
+        d->ownServer = new QHttpServerTcpServer(d, this);
+        bind(d->ownServer);
+    }
+    if (d->ownServer->isListening())
+        d->ownServer->close();
+    if (!d->ownServer->listen(address, port)) {
+        d->errorString = d->ownServer->errorString();
+        return false;
+    }
+    d->errorString.clear();
+    return true;
+}
+
+/*!
+    Serves the connections accepted by \a server, which must be listening
+    or be told to listen separately. This allows the same QHttpServer to
+    serve several addresses, or to use a QTcpServer configured by the
+    application, for example one sharing its port with other servers.
+
+    The server does not take ownership of \a server.
+
+    \sa listen()
+*/
+void QHttpServer::bind(QTcpServer *server)
+{
+    Q_D(QHttpServer);
+    if (!server || d->servers.contains(server))
+        return;
+    d->servers.append(server);
+    connect(server, SIGNAL(newConnection()), this, SLOT(_q_newConnection()));
+}
+
+/*!
+    Stops accepting new connections on all servers. Connections that
+    are already established are not affected.
+
+    \sa listen(), isListening()
+*/
+void QHttpServer::close()
+{
+    Q_D(QHttpServer);
+    for (const QPointer<QTcpServer> &server : qAsConst(d->servers)) {
+        if (server)
+            server->close();
+    }
+}
+
+/*!
+    Returns \c true if any of the servers is listening for connections.
+*/
+bool QHttpServer::isListening() const
+{
+    Q_D(const QHttpServer);
+    for (const QPointer<QTcpServer> &server : d->servers) {
+        if (server && server->isListening())
+            return true;
+    }
+    return false;
+}
+
+/*!
+    Returns the port of the first server that is listening, or 0 if
+    none is.
+*/
+quint16 QHttpServer::serverPort() const
+{
+    Q_D(const QHttpServer);
+    for (const QPointer<QTcpServer> &server : d->servers) {
+        if (server && server->isListening())
+            return server->serverPort();
+    }
+    return 0;
+}
+
+/*!
+    Returns a human readable description of the last error that
+    occurred in listen().
+*/
+QString QHttpServer::errorString() const
+{
+    Q_D(const QHttpServer);
+    return d->errorString;
+}
+
+/*!
+    If \a enable is \c true, which is the default, clients can use
+    HTTP/2; otherwise only HTTP/1.x is served. The setting applies to
+    connections accepted afterwards.
+*/
+void QHttpServer::setHttp2Enabled(bool enable)
+{
+    Q_D(QHttpServer);
+    d->http2Enabled = enable;
+}
+
+/*!
+    Returns \c true if clients can use HTTP/2.
+*/
+bool QHttpServer::isHttp2Enabled() const
+{
+    Q_D(const QHttpServer);
+    return d->http2Enabled;
+}
+
+/*!
+    Sets the HTTP/2 parameters the server advertises to clients to
+    \a configuration. The receive window sizes and the maximum frame
+    size are sent in the server's SETTINGS frame; server push is not
+    supported and ignored.
+*/
+void QHttpServer::setHttp2Configuration(const QHttp2Configuration &configuration)
+{
+    Q_D(QHttpServer);
+    d->http2Configuration = configuration;
+}
+
+/*!
+    Returns the HTTP/2 parameters the server advertises to clients.
+*/
+QHttp2Configuration QHttpServer::http2Configuration() const
+{
+    Q_D(const QHttpServer);
+    return d->http2Configuration;
+}
+
+#ifndef QT_NO_SSL
+/*!
+    Sets the TLS configuration for connections accepted by listen() to
+    \a configuration, which must contain a local certificate and its
+    private key. A null configuration, the default, serves cleartext
+    HTTP.
+*/
+void QHttpServer::setSslConfiguration(const QSslConfiguration &configuration)
+{
+    Q_D(QHttpServer);
+    d->sslConfiguration = configuration;
+}
+
+/*!
+    Returns the TLS configuration for connections accepted by listen().
+*/
+QSslConfiguration QHttpServer::sslConfiguration() const
+{
+    Q_D(const QHttpServer);
+    return d->sslConfiguration;
+}
+#endif
+
+/*!
+    Sets the number of request body bytes the server buffers ahead of
+    the application to \a size. Reading from the connection stops when
+    the buffer is full, which pushes back on the client. A size of 0
+    means the buffer is unlimited. The default is 64 KB.
+
+    The size also bounds how much the server reads from a connection
+    ahead of the request it is processing, for instance pipelined
+    requests, but never to less than the maximum size of a request
+    header.
+*/
+void QHttpServer::setReadBufferSize(qint64 size)
+{
+    Q_D(QHttpServer);
+    d->readBufferSize = size;
+}
+
+/*!
+    Returns the number of request body bytes the server buffers ahead of
+    the application.
+*/
+qint64 QHttpServer::readBufferSize() const
+{
+    Q_D(const QHttpServer);
+    return d->readBufferSize;
+}
+
+/*!
+    Sets the time an idle HTTP/1.x connection is kept open waiting for
+    the next request to \a msecs milliseconds. A timeout of 0 keeps
+    idle connections open until the client closes them. The default is
+    60 seconds.
+*/
+void QHttpServer::setKeepAliveTimeout(int msecs)
+{
+    Q_D(QHttpServer);
+    d->keepAliveTimeout = msecs;
+}
+
+/*!
+    Returns the time in milliseconds an idle HTTP/1.x connection is kept
+    open.
+*/
+int QHttpServer::keepAliveTimeout() const
+{
+    Q_D(const QHttpServer);
+    return d->keepAliveTimeout;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qhttpserver.cpp"
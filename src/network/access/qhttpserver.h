@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPSERVER_H
+#define QHTTPSERVER_H
+
+#include <QtNetwork/qtnetworkglobal.h>
+#include <QtNetwork/qhostaddress.h>
+#include <QtCore/qobject.h>
+
+QT_REQUIRE_CONFIG(http);
+
+QT_BEGIN_NAMESPACE
+
+class QHttp2Configuration;
+class QHttpServerRequest;
+class QHttpServerResponse;
+class QSslConfiguration;
+class QTcpServer;
+
+class QHttpServerPrivate;
+class Q_NETWORK_EXPORT QHttpServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QHttpServer(QObject *parent = nullptr);
+    ~QHttpServer();
+
+    bool listen(const QHostAddress &address = QHostAddress::Any, quint16 port = 0);
+    void bind(QTcpServer *server);
+    void close();
+
+    bool isListening() const;
+    quint16 serverPort() const;
+    QString errorString() const;
+
+    void setHttp2Enabled(bool enable);
+    bool isHttp2Enabled() const;
+
+    void setHttp2Configuration(const QHttp2Configuration &configuration);
+    QHttp2Configuration http2Configuration() const;
+
+#ifndef QT_NO_SSL
+    void setSslConfiguration(const QSslConfiguration &configuration);
+    QSslConfiguration sslConfiguration() const;
+#endif
+
+    void setReadBufferSize(qint64 size);
+    qint64 readBufferSize() const;
+
+    void setKeepAliveTimeout(int msecs);
+    int keepAliveTimeout() const;
+
+Q_SIGNALS:
+    void newRequest(QHttpServerRequest *request, QHttpServerResponse *response);
+
+private:
+    Q_DECLARE_PRIVATE(QHttpServer)
+    Q_DISABLE_COPY(QHttpServer)
+    Q_PRIVATE_SLOT(d_func(), void _q_newConnection())
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTPSERVER_H
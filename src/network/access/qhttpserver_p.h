@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPSERVER_P_H
+#define QHTTPSERVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtNetwork/qhttpserver.h>
+#include <QtNetwork/qhttpserverrequest.h>
+#include <QtNetwork/qhttpserverresponse.h>
+#include <QtNetwork/qhttp2configuration.h>
+#include <QtNetwork/qtcpserver.h>
+#ifndef QT_NO_SSL
+#include <QtNetwork/qsslconfiguration.h>
+#endif
+
+#include <QtCore/qpointer.h>
+#include <QtCore/qvector.h>
+
+#include <private/qobject_p.h>
+#include <private/qiodevice_p.h>
+#include <private/qbytedata_p.h>
+
+QT_REQUIRE_CONFIG(http);
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractSocket;
+class QAbstractHttpServerConnection;
+
+class QHttpServerPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QHttpServer)
+public:
+    void _q_newConnection();
+    void startConnection(QAbstractSocket *socket);
+
+    QVector<QPointer<QTcpServer> > servers;
+    QTcpServer *ownServer = nullptr;
+    QString errorString;
+
+    QHttp2Configuration http2Configuration;
+#ifndef QT_NO_SSL
+    QSslConfiguration sslConfiguration;
+#endif
+    qint64 readBufferSize = 64 * 1024;
+    int keepAliveTimeout = 60000;
+    bool http2Enabled = true;
+};
+
+class QHttpServerRequestPrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QHttpServerRequest)
+public:
+    static QHttpServerRequestPrivate *get(QHttpServerRequest *q) { return q->d_func(); }
+
+    void appendBody(const QByteArray &data);
+    void setFinished();
+
+    QByteArray method;
+    QUrl url;
+    int majorVersion = 1;
+    int minorVersion = 1;
+    QList<QPair<QByteArray, QByteArray> > headers;
+    QHostAddress peerAddress;
+    quint16 peerPort = 0;
+
+    QByteDataBuffer body;
+    bool finished = false;
+
+    QPointer<QAbstractHttpServerConnection> connection;
+};
+
+class QHttpServerResponsePrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QHttpServerResponse)
+public:
+    static QHttpServerResponsePrivate *get(QHttpServerResponse *q) { return q->d_func(); }
+
+    void dataSent(qint64 bytes);
+    void setFinished();
+
+    int statusCode = 200;
+    QList<QPair<QByteArray, QByteArray> > headers;
+
+    // Written by the application but not yet handed to the socket
+    QByteDataBuffer pending;
+    bool finishCalled = false;
+    bool finished = false;
+    bool headersSent = false;
+
+    QPointer<QAbstractHttpServerConnection> connection;
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTPSERVER_P_H
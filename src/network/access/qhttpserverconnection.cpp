@@ -0,0 +1,1324 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpserverconnection_p.h"
+#include "qhttpserver_p.h"
+
+#include "private/qhttpnetworkreply_p.h"
+#include "http2/bitstreams_p.h"
+
+#include <QtNetwork/qabstractsocket.h>
+#ifndef QT_NO_SSL
+#include <QtNetwork/qsslsocket.h>
+#endif
+
+#include <QtCore/qendian.h>
+
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Http2;
+
+namespace {
+
+// Stop taking data from responses while this much is queued in the socket
+const qint64 socketHighWaterMark = 256 * 1024;
+// How many requests we read ahead of the response currently being written
+const int maxPipelinedRequests = 16;
+const int maxRequestLineSize = 8 * 1024;
+const int maxHeaderSize = 64 * 1024;
+const quint32 maxAcceptableTableSize = 16 * HPack::FieldLookupTable::DefaultSize;
+
+QByteArray reasonPhrase(int statusCode)
+{
+    switch (statusCode) {
+    case 100: return QByteArrayLiteral("Continue");
+    case 101: return QByteArrayLiteral("Switching Protocols");
+    case 200: return QByteArrayLiteral("OK");
+    case 201: return QByteArrayLiteral("Created");
+    case 202: return QByteArrayLiteral("Accepted");
+    case 204: return QByteArrayLiteral("No Content");
+    case 206: return QByteArrayLiteral("Partial Content");
+    case 301: return QByteArrayLiteral("Moved Permanently");
+    case 302: return QByteArrayLiteral("Found");
+    case 303: return QByteArrayLiteral("See Other");
+    case 304: return QByteArrayLiteral("Not Modified");
+    case 307: return QByteArrayLiteral("Temporary Redirect");
+    case 308: return QByteArrayLiteral("Permanent Redirect");
+    case 400: return QByteArrayLiteral("Bad Request");
+    case 401: return QByteArrayLiteral("Unauthorized");
+    case 403: return QByteArrayLiteral("Forbidden");
+    case 404: return QByteArrayLiteral("Not Found");
+    case 405: return QByteArrayLiteral("Method Not Allowed");
+    case 408: return QByteArrayLiteral("Request Timeout");
+    case 411: return QByteArrayLiteral("Length Required");
+    case 413: return QByteArrayLiteral("Payload Too Large");
+    case 414: return QByteArrayLiteral("URI Too Long");
+    case 431: return QByteArrayLiteral("Request Header Fields Too Large");
+    case 500: return QByteArrayLiteral("Internal Server Error");
+    case 501: return QByteArrayLiteral("Not Implemented");
+    case 503: return QByteArrayLiteral("Service Unavailable");
+    case 505: return QByteArrayLiteral("HTTP Version Not Supported");
+    default:
+        return QByteArray();
+    }
+}
+
+// RFC 7230, 3.3: responses to HEAD and 1xx, 204 and 304 responses never
+// have a body
+bool hasNoBody(const QByteArray &method, int statusCode)
+{
+    return method == "HEAD" || statusCode < 200 || statusCode == 204 || statusCode == 304;
+}
+
+bool containsToken(const QByteArray &value, const char *token)
+{
+    const QList<QByteArray> tokens = value.split(',');
+    for (const QByteArray &t : tokens) {
+        if (t.trimmed().compare(token, Qt::CaseInsensitive) == 0)
+            return true;
+    }
+    return false;
+}
+
+} // unnamed namespace
+
+/*!
+    \class QAbstractHttpServerConnection
+    \internal
+
+    Serves the requests arriving on one socket accepted by QHttpServer.
+    Subclasses implement a protocol on top of the socket, which the
+    connection owns; the connection deletes itself when the socket
+    disconnects.
+*/
+QAbstractHttpServerConnection::QAbstractHttpServerConnection(QHttpServer *server,
+                                                             QAbstractSocket *socket)
+    : QObject(server), server(server), socket(socket), scheme("http")
+{
+    const QHttpServerPrivate *d = static_cast<QHttpServerPrivate *>(QObjectPrivate::get(server));
+    http2Configuration = d->http2Configuration;
+    readBufferSize = d->readBufferSize;
+    keepAliveTimeout = d->keepAliveTimeout;
+    http2Enabled = d->http2Enabled;
+
+    socket->setParent(this);
+    // Leave what we cannot take yet in the kernel, so that TCP flow control
+    // pushes back on the client; the socket has to hold a complete header
+    socket->setReadBufferSize(qMax(readBufferSize, qint64(maxHeaderSize)));
+#ifndef QT_NO_SSL
+    if (qobject_cast<QSslSocket *>(socket))
+        scheme = "https";
+#endif
+    connect(socket, &QAbstractSocket::disconnected, this, &QObject::deleteLater);
+}
+
+QAbstractHttpServerConnection::~QAbstractHttpServerConnection()
+{
+}
+
+QHttpServerRequest *QAbstractHttpServerConnection::createRequest(
+        const QByteArray &method, const QUrl &url, int majorVersion, int minorVersion,
+        const QList<QPair<QByteArray, QByteArray> > &headers)
+{
+    QHttpServerRequest *request = new QHttpServerRequest(this);
+    QHttpServerRequestPrivate *d = QHttpServerRequestPrivate::get(request);
+    d->method = method;
+    d->url = url;
+    d->majorVersion = majorVersion;
+    d->minorVersion = minorVersion;
+    d->headers = headers;
+    d->peerAddress = socket->peerAddress();
+    d->peerPort = socket->peerPort();
+    d->connection = this;
+    return request;
+}
+
+QHttpServerResponse *QAbstractHttpServerConnection::createResponse()
+{
+    QHttpServerResponse *response = new QHttpServerResponse(this);
+    QHttpServerResponsePrivate::get(response)->connection = this;
+    return response;
+}
+
+void QAbstractHttpServerConnection::emitNewRequest(QHttpServerRequest *request,
+                                                   QHttpServerResponse *response)
+{
+    if (server)
+        emit server->newRequest(request, response);
+}
+
+/*!
+    Detaches \a request and \a response from the connection once the
+    response is complete, and deletes them later.
+*/
+void QAbstractHttpServerConnection::release(QHttpServerRequest *request,
+                                            QHttpServerResponse *response)
+{
+    QHttpServerRequestPrivate::get(request)->connection = nullptr;
+    QHttpServerResponsePrivate *responsePrivate = QHttpServerResponsePrivate::get(response);
+    responsePrivate->connection = nullptr;
+    responsePrivate->setFinished();
+    request->deleteLater();
+    response->deleteLater();
+}
+
+void QAbstractHttpServerConnection::scheduleFlush()
+{
+    // Coalesce the writes an application makes in one go, so that a
+    // response completed right away is sent with a Content-Length
+    if (!flushScheduled) {
+        flushScheduled = true;
+        QMetaObject::invokeMethod(this, "_q_flush", Qt::QueuedConnection);
+    }
+}
+
+void QAbstractHttpServerConnection::_q_flush()
+{
+    flushScheduled = false;
+    flush();
+}
+
+void QAbstractHttpServerConnection::scheduleReceive()
+{
+    QMetaObject::invokeMethod(this, "receive", Qt::QueuedConnection);
+}
+
+QUrl QAbstractHttpServerConnection::requestUrl(const QByteArray &scheme,
+                                               const QByteArray &authority,
+                                               const QByteArray &target)
+{
+    // RFC 7230, 5.3: absolute-form is used with proxies, origin-form otherwise
+    if (!target.startsWith('/') && target != "*") {
+        const QUrl url = QUrl::fromEncoded(target);
+        if (url.isValid() && !url.scheme().isEmpty())
+            return url;
+    }
+    return QUrl::fromEncoded(scheme + "://" + authority + (target == "*" ? QByteArray() : target));
+}
+
+/*!
+    \class QHttp1ServerConnection
+    \internal
+
+    Serves HTTP/1.0 and HTTP/1.1 requests, including pipelined ones.
+    Request headers and bodies are parsed by QHttpNetworkReplyPrivate,
+    which the client side uses for responses. Responses are written
+    in the order the requests arrived, so a response only reaches the
+    socket once all previous responses are complete.
+*/
+QHttp1ServerConnection::QHttp1ServerConnection(QHttpServer *server, QAbstractSocket *socket)
+    : QAbstractHttpServerConnection(server, socket),
+      parser(new QHttpNetworkReply)
+{
+    connect(socket, &QIODevice::readyRead, this, &QHttp1ServerConnection::receive);
+    connect(socket, &QIODevice::bytesWritten, this, &QHttp1ServerConnection::scheduleFlush);
+    restartKeepAliveTimer();
+    if (socket->bytesAvailable())
+        scheduleReceive();
+}
+
+QHttp1ServerConnection::~QHttp1ServerConnection()
+{
+}
+
+void QHttp1ServerConnection::receive()
+{
+    bool progress = true;
+    while (progress) {
+        switch (state) {
+        case RequestLineState:
+            progress = readRequestLine();
+            break;
+        case HeaderState:
+            progress = readHeader();
+            break;
+        case BodyState:
+            progress = readBody();
+            break;
+        case ClosedState:
+            return;
+        }
+    }
+}
+
+bool QHttp1ServerConnection::readRequestLine()
+{
+    if (exchanges.size() >= size_t(maxPipelinedRequests)) {
+        readPaused = true;
+        return false;
+    }
+
+    if (firstRequest && http2Enabled && scheme == "http") {
+        // RFC 7540, 3.4: a client with prior knowledge starts with the
+        // HTTP/2 connection preface
+        char buffer[clientPrefaceLength];
+        const qint64 peeked = socket->peek(buffer, clientPrefaceLength);
+        if (peeked > 0 && std::memcmp(buffer, Http2clientPreface, size_t(peeked)) == 0) {
+            if (peeked < clientPrefaceLength)
+                return false;
+            state = ClosedState;
+            keepAliveTimer.stop();
+            socket->disconnect(this);
+            QHttp2ServerConnection *connection = new QHttp2ServerConnection(server, socket);
+            connection->start();
+            deleteLater();
+            return false;
+        }
+    }
+
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > maxRequestLineSize)
+            sendErrorAndClose(414);
+        return false;
+    }
+
+    const QByteArray line = socket->readLine(maxRequestLineSize + 1);
+    if (!line.endsWith('\n')) {
+        sendErrorAndClose(414);
+        return false;
+    }
+
+    const QByteArray requestLine = line.trimmed();
+    if (requestLine.isEmpty())
+        return true; // RFC 7230, 3.5: ignore empty lines before a request
+
+    const int first = requestLine.indexOf(' ');
+    const int last = requestLine.lastIndexOf(' ');
+    if (first <= 0 || last <= first) {
+        sendErrorAndClose(400);
+        return false;
+    }
+
+    const QByteArray version = requestLine.mid(last + 1);
+    if (version.size() != 8 || !version.startsWith("HTTP/") || version.at(6) != '.'
+        || version.at(5) < '0' || version.at(5) > '9'
+        || version.at(7) < '0' || version.at(7) > '9') {
+        sendErrorAndClose(400);
+        return false;
+    }
+    if (version.at(5) != '1') {
+        sendErrorAndClose(505);
+        return false;
+    }
+
+    method = requestLine.left(first);
+    target = requestLine.mid(first + 1, last - first - 1).trimmed();
+
+    QHttpNetworkReplyPrivate *p = parser->d_func();
+    p->clearHttpLayerInformation();
+    p->fragment.clear();
+    p->majorVersion = 1;
+    p->minorVersion = version.at(7) - '0';
+    p->state = QHttpNetworkReplyPrivate::ReadingHeaderState;
+
+    firstRequest = false;
+    keepAliveTimer.stop();
+    state = HeaderState;
+    return true;
+}
+
+bool QHttp1ServerConnection::readHeader()
+{
+    QHttpNetworkReplyPrivate *p = parser->d_func();
+    if (p->readHeader(socket) < 0) {
+        closeConnection();
+        return false;
+    }
+
+    if (p->state != QHttpNetworkReplyPrivate::ReadingDataState) {
+        if (p->fragment.size() > maxHeaderSize)
+            sendErrorAndClose(431);
+        return false;
+    }
+
+    if (http2Enabled && exchanges.empty() && upgradeToHttp2())
+        return false;
+
+    const QUrl url = requestUrl(scheme, p->headerField("host"), target);
+    QHttpServerRequest *request = createRequest(method, url, p->majorVersion, p->minorVersion,
+                                                p->fields);
+    QHttpServerResponse *response = createResponse();
+    exchanges.push_back({ request, response, method == "HEAD", false,
+                          p->isConnectionCloseEnabled() });
+
+    const bool hasBody = p->isChunked() || p->bodyLength > 0;
+    if (hasBody) {
+        // RFC 7231, 5.1.1: tell the client to go ahead, unless the
+        // interim response would be out of order
+        if (p->minorVersion >= 1 && exchanges.size() == 1
+            && p->headerField("expect").compare("100-continue", Qt::CaseInsensitive) == 0) {
+            socket->write("HTTP/1.1 100 Continue\r\n\r\n");
+        }
+        currentRequest = request;
+        discardingBody = false;
+        state = BodyState;
+    } else {
+        state = RequestLineState;
+    }
+
+    // A request without a body is complete when the application sees it
+    if (!hasBody)
+        QHttpServerRequestPrivate::get(request)->finished = true;
+    emitNewRequest(request, response);
+    return true;
+}
+
+bool QHttp1ServerConnection::readBody()
+{
+    QHttpNetworkReplyPrivate *p = parser->d_func();
+    QHttpServerRequestPrivate *d = currentRequest
+            ? QHttpServerRequestPrivate::get(currentRequest) : nullptr;
+
+    qint64 room = 128 * 1024;
+    if (d && !discardingBody) {
+        room = readBufferSize > 0 ? readBufferSize - d->body.byteAmount()
+                                  : std::numeric_limits<qint64>::max();
+        if (room <= 0) {
+            // Resumed by requestBodyRead()
+            readPaused = true;
+            return false;
+        }
+    }
+
+    QByteDataBuffer data;
+    const qint64 available = socket->bytesAvailable();
+    p->readBufferMaxSize = room;
+    const qint64 bytes = p->isChunked() ? p->readBody(socket, &data)
+                                        : p->readBodyFast(socket, &data);
+    if (bytes < 0) {
+        closeConnection();
+        return false;
+    }
+
+    if (d && !discardingBody) {
+        while (!data.isEmpty())
+            d->appendBody(data.read());
+    }
+
+    if (p->state == QHttpNetworkReplyPrivate::AllDoneState) {
+        currentRequest = nullptr;
+        discardingBody = false;
+        state = RequestLineState;
+        if (d)
+            d->setFinished();
+        return true;
+    }
+    // Chunk framing is consumed without producing data
+    return socket->bytesAvailable() < available;
+}
+
+bool QHttp1ServerConnection::upgradeToHttp2()
+{
+    // RFC 7540, 3.2: we only switch protocols for requests without a
+    // body, so that the whole request has been read
+    QHttpNetworkReplyPrivate *p = parser->d_func();
+    if (scheme != "http" || p->isChunked() || p->bodyLength > 0)
+        return false;
+    if (!containsToken(p->headerField("upgrade"), "h2c"))
+        return false;
+    if (!containsToken(p->headerField("connection"), "http2-settings"))
+        return false;
+
+    const QByteArray settings = QByteArray::fromBase64(p->headerField("http2-settings"),
+                                                       QByteArray::Base64UrlEncoding);
+    if (settings.size() % 6)
+        return false;
+
+    socket->write("HTTP/1.1 101 Switching Protocols\r\n"
+                  "Connection: Upgrade\r\n"
+                  "Upgrade: h2c\r\n\r\n");
+
+    state = ClosedState;
+    keepAliveTimer.stop();
+    socket->disconnect(this);
+    QHttp2ServerConnection *connection = new QHttp2ServerConnection(server, socket);
+    connection->startUpgraded(settings, method, requestUrl(scheme, p->headerField("host"), target),
+                              p->fields);
+    deleteLater();
+    return true;
+}
+
+void QHttp1ServerConnection::requestBodyRead(QHttpServerRequest *request, qint64 bytes)
+{
+    Q_UNUSED(bytes);
+    if (readPaused && request == currentRequest) {
+        readPaused = false;
+        scheduleReceive();
+    }
+}
+
+void QHttp1ServerConnection::writeResponseHeader(Exchange &exchange)
+{
+    QHttpServerResponsePrivate *d = QHttpServerResponsePrivate::get(exchange.response);
+    const QHttpServerRequestPrivate *request = QHttpServerRequestPrivate::get(exchange.request);
+    d->headersSent = true;
+
+    exchange.noBody = hasNoBody(request->method, d->statusCode);
+
+    QByteArray header = "HTTP/1.1 " + QByteArray::number(d->statusCode) + ' '
+            + reasonPhrase(d->statusCode) + "\r\n";
+    bool hasLength = false;
+    for (const auto &field : qAsConst(d->headers)) {
+        // We decide on the framing and the connection's persistence
+        if (field.first.compare("connection", Qt::CaseInsensitive) == 0) {
+            if (containsToken(field.second, "close"))
+                exchange.closeAfter = true;
+            continue;
+        }
+        if (field.first.compare("transfer-encoding", Qt::CaseInsensitive) == 0
+            || field.first.compare("keep-alive", Qt::CaseInsensitive) == 0) {
+            continue;
+        }
+        if (field.first.compare("content-length", Qt::CaseInsensitive) == 0)
+            hasLength = true;
+        header += field.first + ": " + field.second + "\r\n";
+    }
+
+    if (!hasLength && !exchange.noBody) {
+        if (d->finishCalled) {
+            header += "Content-Length: " + QByteArray::number(d->pending.byteAmount()) + "\r\n";
+        } else if (request->minorVersion >= 1) {
+            header += "Transfer-Encoding: chunked\r\n";
+            exchange.chunked = true;
+        } else {
+            // HTTP/1.0 without a length: the body ends when we close
+            exchange.closeAfter = true;
+        }
+    }
+
+    if (exchange.closeAfter)
+        header += "Connection: close\r\n";
+    else if (request->minorVersion == 0)
+        header += "Connection: keep-alive\r\n";
+    header += "\r\n";
+    socket->write(header);
+}
+
+void QHttp1ServerConnection::flush()
+{
+    while (!exchanges.empty() && state != ClosedState) {
+        if (socket->bytesToWrite() > socketHighWaterMark)
+            return; // Continued on bytesWritten()
+
+        Exchange &exchange = exchanges.front();
+        QHttpServerResponsePrivate *d = QHttpServerResponsePrivate::get(exchange.response);
+        if (!d->headersSent) {
+            if (d->pending.isEmpty() && !d->finishCalled)
+                return;
+            writeResponseHeader(exchange);
+        }
+
+        qint64 sent = 0;
+        while (!d->pending.isEmpty() && socket->bytesToWrite() <= socketHighWaterMark) {
+            const QByteArray data = d->pending.read();
+            if (!exchange.noBody) {
+                // The socket keeps a reference to the data instead of a copy
+                if (exchange.chunked) {
+                    socket->write(QByteArrayList{ QByteArray::number(data.size(), 16) + "\r\n",
+                                                  data, QByteArrayLiteral("\r\n") });
+                } else {
+                    socket->write(QByteArrayList{ data });
+                }
+            }
+            sent += data.size();
+        }
+        if (sent)
+            d->dataSent(sent);
+
+        if (!d->finishCalled || !d->pending.isEmpty())
+            return;
+
+        if (exchange.chunked)
+            socket->write("0\r\n\r\n", 5);
+
+        const Exchange done = exchange;
+        exchanges.pop_front();
+        if (done.request == currentRequest) {
+            // The application does not want the rest of the body
+            currentRequest = nullptr;
+            discardingBody = true;
+        }
+        release(done.request, done.response);
+
+        if (done.closeAfter) {
+            closeConnection();
+            return;
+        }
+        if (readPaused) {
+            readPaused = false;
+            scheduleReceive();
+        }
+    }
+
+    if (exchanges.empty() && state == RequestLineState)
+        restartKeepAliveTimer();
+}
+
+void QHttp1ServerConnection::sendErrorAndClose(int statusCode)
+{
+    if (exchanges.empty()) {
+        socket->write("HTTP/1.1 " + QByteArray::number(statusCode) + ' '
+                      + reasonPhrase(statusCode) + "\r\n"
+                      "Content-Length: 0\r\n"
+                      "Connection: close\r\n\r\n");
+    }
+    closeConnection();
+}
+
+void QHttp1ServerConnection::closeConnection()
+{
+    state = ClosedState;
+    keepAliveTimer.stop();
+    if (socket->state() == QAbstractSocket::UnconnectedState)
+        deleteLater();
+    else
+        socket->disconnectFromHost();
+}
+
+void QHttp1ServerConnection::restartKeepAliveTimer()
+{
+    if (keepAliveTimeout > 0)
+        keepAliveTimer.start(keepAliveTimeout, this);
+}
+
+void QHttp1ServerConnection::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != keepAliveTimer.timerId())
+        return QAbstractHttpServerConnection::timerEvent(event);
+
+    keepAliveTimer.stop();
+    if (exchanges.empty() && state == RequestLineState)
+        closeConnection();
+}
+
+/*!
+    \class QHttp2ServerConnection
+    \internal
+
+    Serves HTTP/2 streams, using the HPACK and frame code of the client
+    side protocol handler. Request bodies are flow controlled: window
+    updates are only sent once the application has read the data.
+*/
+QHttp2ServerConnection::QHttp2ServerConnection(QHttpServer *server, QAbstractSocket *socket)
+    : QAbstractHttpServerConnection(server, socket),
+      decoder(HPack::FieldLookupTable::DefaultSize),
+      encoder(HPack::FieldLookupTable::DefaultSize,
+              http2Configuration.huffmanCompressionEnabled())
+{
+    streamRecvWindowSize = qint32(http2Configuration.streamReceiveWindowSize());
+    sessionRecvWindowSize = qint32(http2Configuration.sessionReceiveWindowSize());
+    connect(socket, &QIODevice::readyRead, this, &QHttp2ServerConnection::receive);
+    connect(socket, &QIODevice::bytesWritten, this, &QHttp2ServerConnection::scheduleFlush);
+}
+
+QHttp2ServerConnection::~QHttp2ServerConnection()
+{
+}
+
+void QHttp2ServerConnection::start()
+{
+    sendServerSettings();
+    if (socket->bytesAvailable())
+        scheduleReceive();
+}
+
+void QHttp2ServerConnection::startUpgraded(const QByteArray &settings, const QByteArray &method,
+                                           const QUrl &url,
+                                           const QList<QPair<QByteArray, QByteArray> > &headers)
+{
+    // RFC 7540, 3.2.1: HTTP2-Settings is applied as a SETTINGS frame
+    if (!applySettings(reinterpret_cast<const uchar *>(settings.constData()),
+                       quint32(settings.size()))) {
+        return;
+    }
+    sendServerSettings();
+
+    // The upgrade request becomes stream 1, half-closed (remote)
+    lastStreamID = 1;
+    // Its response is sent over HTTP/2
+    QHttpServerRequest *request = createRequest(method, url, 2, 0, headers);
+    QHttpServerResponse *response = createResponse();
+    Stream &stream = streams[1];
+    stream.request = request;
+    stream.response = response;
+    stream.sendWindow = initialSendWindow;
+    stream.recvWindow = streamRecvWindowSize;
+    stream.remoteClosed = true;
+    stream.noBody = method == "HEAD";
+
+    QHttpServerRequestPrivate::get(request)->finished = true;
+    emitNewRequest(request, response);
+
+    if (socket->bytesAvailable())
+        scheduleReceive();
+}
+
+void QHttp2ServerConnection::sendServerSettings()
+{
+    frameWriter.start(FrameType::SETTINGS, FrameFlag::EMPTY, connectionStreamID);
+    frameWriter.append(Settings::MAX_CONCURRENT_STREAMS_ID);
+    frameWriter.append(quint32(maxConcurrentStreams));
+    frameWriter.append(Settings::INITIAL_WINDOW_SIZE_ID);
+    frameWriter.append(quint32(streamRecvWindowSize));
+    frameWriter.append(Settings::MAX_HEADER_LIST_SIZE_ID);
+    frameWriter.append(quint32(maxHeaderSize));
+    if (http2Configuration.maxFrameSize() != minPayloadLimit) {
+        frameWriter.append(Settings::MAX_FRAME_SIZE_ID);
+        frameWriter.append(quint32(http2Configuration.maxFrameSize()));
+    }
+    frameWriter.write(*socket);
+
+    sessionRecvWindow = sessionRecvWindowSize;
+    if (sessionRecvWindowSize > defaultSessionWindowSize)
+        sendWINDOW_UPDATE(connectionStreamID, quint32(sessionRecvWindowSize - defaultSessionWindowSize));
+}
+
+void QHttp2ServerConnection::receive()
+{
+    while (!closed && socket->bytesAvailable()) {
+        if (waitingForPreface) {
+            if (socket->bytesAvailable() < clientPrefaceLength)
+                return;
+            char buffer[clientPrefaceLength];
+            socket->read(buffer, clientPrefaceLength);
+            if (std::memcmp(buffer, Http2clientPreface, clientPrefaceLength)) {
+                connectionError(PROTOCOL_ERROR);
+                return;
+            }
+            waitingForPreface = false;
+            continue;
+        }
+
+        switch (frameReader.read(*socket)) {
+        case FrameStatus::incompleteFrame:
+            return;
+        case FrameStatus::goodFrame:
+            handleFrame();
+            break;
+        case FrameStatus::sizeError:
+            connectionError(FRAME_SIZE_ERROR);
+            return;
+        default:
+            connectionError(PROTOCOL_ERROR);
+            return;
+        }
+    }
+}
+
+void QHttp2ServerConnection::handleFrame()
+{
+    inboundFrame = std::move(frameReader.inboundFrame());
+    const FrameType type = inboundFrame.type();
+
+    // RFC 7540, 3.5: the preface ends with a SETTINGS frame
+    if (waitingForSettings
+        && (type != FrameType::SETTINGS || inboundFrame.flags().testFlag(FrameFlag::ACK))) {
+        return connectionError(PROTOCOL_ERROR);
+    }
+
+    // RFC 7540, 6.10: nothing may interrupt a header block
+    if (!continuedFrames.empty() && type != FrameType::CONTINUATION)
+        return connectionError(PROTOCOL_ERROR);
+
+    switch (type) {
+    case FrameType::DATA:
+        handleDATA();
+        break;
+    case FrameType::HEADERS:
+        handleHEADERS();
+        break;
+    case FrameType::PRIORITY:
+        break; // We do not prioritize streams
+    case FrameType::RST_STREAM:
+        handleRST_STREAM();
+        break;
+    case FrameType::SETTINGS:
+        handleSETTINGS();
+        break;
+    case FrameType::PUSH_PROMISE:
+        connectionError(PROTOCOL_ERROR); // Clients cannot push
+        break;
+    case FrameType::PING:
+        handlePING();
+        break;
+    case FrameType::GOAWAY:
+        handleGOAWAY();
+        break;
+    case FrameType::WINDOW_UPDATE:
+        handleWINDOW_UPDATE();
+        break;
+    case FrameType::CONTINUATION:
+        handleCONTINUATION();
+        break;
+    default:
+        break; // RFC 7540, 4.1: unknown frame types are ignored
+    }
+}
+
+void QHttp2ServerConnection::handleHEADERS()
+{
+    const quint32 streamID = inboundFrame.streamID();
+    if (streamID == connectionStreamID || !(streamID & 1))
+        return connectionError(PROTOCOL_ERROR);
+
+    headerBlockSize = 0;
+    continueHeaders();
+}
+
+void QHttp2ServerConnection::handleCONTINUATION()
+{
+    if (continuedFrames.empty() || inboundFrame.streamID() != continuedFrames.front().streamID())
+        return connectionError(PROTOCOL_ERROR);
+
+    continueHeaders();
+}
+
+void QHttp2ServerConnection::continueHeaders()
+{
+    // The same limit as for HTTP/1 headers, which we advertise as
+    // SETTINGS_MAX_HEADER_LIST_SIZE; without it a peer could send
+    // CONTINUATION frames until we run out of memory
+    headerBlockSize += inboundFrame.hpackBlockSize();
+    if (headerBlockSize > quint32(maxHeaderSize)) {
+        continuedFrames.clear();
+        return connectionError(ENHANCE_YOUR_CALM);
+    }
+
+    continuedFrames.push_back(std::move(inboundFrame));
+    if (continuedFrames.back().flags().testFlag(FrameFlag::END_HEADERS))
+        processHeaders();
+}
+
+void QHttp2ServerConnection::processHeaders()
+{
+    const quint32 streamID = continuedFrames.front().streamID();
+    const bool endStream = continuedFrames.front().flags().testFlag(FrameFlag::END_STREAM);
+
+    std::vector<uchar> hpackBlock;
+    hpackBlock.reserve(headerBlockSize);
+    for (const Frame &frame : continuedFrames) {
+        const uchar *begin = frame.hpackBlockBegin();
+        if (frame.hpackBlockSize())
+            hpackBlock.insert(hpackBlock.end(), begin, begin + frame.hpackBlockSize());
+    }
+    continuedFrames.clear();
+
+    // Always decode, the decoder's state is shared by all streams
+    HPack::BitIStream inputStream(hpackBlock.data(), hpackBlock.data() + hpackBlock.size());
+    if (!decoder.decodeHeaderFields(inputStream))
+        return connectionError(COMPRESSION_ERROR);
+
+    const auto it = streams.find(streamID);
+    if (it != streams.end()) {
+        // Trailers, which we do not expose
+        Stream &stream = it->second;
+        if (stream.remoteClosed || !endStream) {
+            sendRST_STREAM(streamID, PROTOCOL_ERROR);
+            stream.remoteClosed = true;
+            stream.localClosed = true;
+            closeStream(it);
+            return;
+        }
+        stream.remoteClosed = true;
+        if (stream.request)
+            QHttpServerRequestPrivate::get(stream.request)->setFinished();
+        scheduleFlush();
+        return;
+    }
+
+    if (streamID <= lastStreamID)
+        return connectionError(PROTOCOL_ERROR);
+    lastStreamID = streamID;
+
+    if (goingAway)
+        return;
+    if (streams.size() >= size_t(maxConcurrentStreams)) {
+        sendRST_STREAM(streamID, REFUSE_STREAM);
+        return;
+    }
+
+    openStream(streamID, decoder.decodedHeader(), endStream);
+}
+
+bool QHttp2ServerConnection::openStream(quint32 streamID, const HPack::HttpHeader &header,
+                                        bool endStream)
+{
+    QByteArray method;
+    QByteArray path;
+    QByteArray authority;
+    QByteArray requestScheme = scheme;
+    QList<QPair<QByteArray, QByteArray> > fields;
+    for (const HPack::HeaderField &field : header) {
+        if (field.name == ":method")
+            method = field.value;
+        else if (field.name == ":path")
+            path = field.value;
+        else if (field.name == ":authority")
+            authority = field.value;
+        else if (field.name == ":scheme")
+            requestScheme = field.value;
+        else if (!field.name.startsWith(':'))
+            fields.append(qMakePair(field.name, field.value));
+    }
+
+    // RFC 7540, 8.1.2.3
+    if (method.isEmpty() || path.isEmpty()) {
+        sendRST_STREAM(streamID, PROTOCOL_ERROR);
+        return false;
+    }
+
+    if (authority.isEmpty()) {
+        for (const auto &field : qAsConst(fields)) {
+            if (field.first == "host")
+                authority = field.second;
+        }
+    }
+
+    QHttpServerRequest *request = createRequest(method, requestUrl(requestScheme, authority, path),
+                                                2, 0, fields);
+    QHttpServerResponse *response = createResponse();
+    Stream &stream = streams[streamID];
+    stream.request = request;
+    stream.response = response;
+    stream.sendWindow = initialSendWindow;
+    stream.recvWindow = streamRecvWindowSize;
+    stream.remoteClosed = endStream;
+    stream.noBody = method == "HEAD";
+
+    QHttpServerRequestPrivate::get(request)->finished = endStream;
+    emitNewRequest(request, response);
+    return true;
+}
+
+void QHttp2ServerConnection::handleDATA()
+{
+    const quint32 streamID = inboundFrame.streamID();
+    if (streamID == connectionStreamID)
+        return connectionError(PROTOCOL_ERROR);
+
+    const qint32 size = qint32(inboundFrame.payloadSize());
+    if (size > sessionRecvWindow)
+        return connectionError(FLOW_CONTROL_ERROR);
+    sessionRecvWindow -= size;
+
+    const auto it = streams.find(streamID);
+    if (it == streams.end() || it->second.remoteClosed) {
+        if (streamID > lastStreamID)
+            return connectionError(PROTOCOL_ERROR);
+        // A stream we already closed or reset: the data still counts
+        // against the session window
+        sessionUnackedBytes += size;
+        if (it == streams.end()) {
+            Stream unused;
+            updateReceiveWindows(streamID, unused);
+        } else {
+            sendRST_STREAM(streamID, STREAM_CLOSED);
+            updateReceiveWindows(streamID, it->second);
+        }
+        return;
+    }
+
+    Stream &stream = it->second;
+    if (size > stream.recvWindow) {
+        sendRST_STREAM(streamID, FLOW_CONTROL_ERROR);
+        stream.remoteClosed = true;
+        stream.localClosed = true;
+        sessionUnackedBytes += size;
+        closeStream(it);
+        return;
+    }
+    stream.recvWindow -= size;
+
+    // Padding is returned right away, data once the application read it
+    const qint32 dataSize = qint32(inboundFrame.dataSize());
+    stream.unackedBytes += size - dataSize;
+    sessionUnackedBytes += size - dataSize;
+
+    const bool endStream = inboundFrame.flags().testFlag(FrameFlag::END_STREAM);
+    if (endStream)
+        stream.remoteClosed = true;
+
+    QHttpServerRequestPrivate *d = QHttpServerRequestPrivate::get(stream.request);
+    if (dataSize) {
+        d->appendBody(QByteArray(reinterpret_cast<const char *>(inboundFrame.dataBegin()),
+                                 dataSize));
+    }
+    if (endStream) {
+        d->setFinished();
+        scheduleFlush();
+    }
+    updateReceiveWindows(streamID, stream);
+}
+
+void QHttp2ServerConnection::requestBodyRead(QHttpServerRequest *request, qint64 bytes)
+{
+    for (auto &entry : streams) {
+        if (entry.second.request == request) {
+            entry.second.unackedBytes += qint32(bytes);
+            sessionUnackedBytes += qint32(bytes);
+            updateReceiveWindows(entry.first, entry.second);
+            return;
+        }
+    }
+}
+
+void QHttp2ServerConnection::updateReceiveWindows(quint32 streamID, Stream &stream)
+{
+    if (closed)
+        return;
+
+    if (!stream.remoteClosed && stream.unackedBytes >= streamRecvWindowSize / 2) {
+        sendWINDOW_UPDATE(streamID, quint32(stream.unackedBytes));
+        stream.recvWindow += stream.unackedBytes;
+        stream.unackedBytes = 0;
+    }
+    if (sessionUnackedBytes >= sessionRecvWindowSize / 2) {
+        sendWINDOW_UPDATE(connectionStreamID, quint32(sessionUnackedBytes));
+        sessionRecvWindow += sessionUnackedBytes;
+        sessionUnackedBytes = 0;
+    }
+}
+
+void QHttp2ServerConnection::handleSETTINGS()
+{
+    if (inboundFrame.streamID() != connectionStreamID)
+        return connectionError(PROTOCOL_ERROR);
+
+    if (inboundFrame.flags().testFlag(FrameFlag::ACK))
+        return;
+
+    if (!applySettings(inboundFrame.dataBegin(), inboundFrame.dataSize()))
+        return;
+
+    frameWriter.start(FrameType::SETTINGS, FrameFlag::ACK, connectionStreamID);
+    frameWriter.write(*socket);
+    waitingForSettings = false;
+    scheduleFlush();
+}
+
+bool QHttp2ServerConnection::applySettings(const uchar *src, quint32 size)
+{
+    for (const uchar *end = src + size; src + 6 <= end; src += 6) {
+        const Settings identifier = Settings(qFromBigEndian<quint16>(src));
+        const quint32 value = qFromBigEndian<quint32>(src + 2);
+        switch (identifier) {
+        case Settings::HEADER_TABLE_SIZE_ID:
+            if (value > maxAcceptableTableSize) {
+                connectionError(PROTOCOL_ERROR);
+                return false;
+            }
+            encoder.setMaxDynamicTableSize(value);
+            break;
+        case Settings::ENABLE_PUSH_ID:
+            if (value > 1) {
+                connectionError(PROTOCOL_ERROR);
+                return false;
+            }
+            break;
+        case Settings::INITIAL_WINDOW_SIZE_ID: {
+            if (value > quint32(std::numeric_limits<qint32>::max())) {
+                connectionError(FLOW_CONTROL_ERROR);
+                return false;
+            }
+            // RFC 7540, 6.9.2: adjust the windows of all open streams
+            const qint64 delta = qint64(value) - initialSendWindow;
+            for (auto &entry : streams) {
+                const qint64 window = entry.second.sendWindow + delta;
+                if (window > std::numeric_limits<qint32>::max()) {
+                    connectionError(FLOW_CONTROL_ERROR);
+                    return false;
+                }
+                entry.second.sendWindow = qint32(window);
+            }
+            initialSendWindow = qint32(value);
+            break;
+        }
+        case Settings::MAX_FRAME_SIZE_ID:
+            if (value < minPayloadLimit || value > maxPayloadSize) {
+                connectionError(PROTOCOL_ERROR);
+                return false;
+            }
+            maxFrameSize = value;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+void QHttp2ServerConnection::handlePING()
+{
+    if (inboundFrame.streamID() != connectionStreamID)
+        return connectionError(PROTOCOL_ERROR);
+    if (inboundFrame.flags().testFlag(FrameFlag::ACK))
+        return;
+
+    frameWriter.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
+    frameWriter.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
+    frameWriter.write(*socket);
+}
+
+void QHttp2ServerConnection::handleGOAWAY()
+{
+    if (inboundFrame.streamID() != connectionStreamID)
+        return connectionError(PROTOCOL_ERROR);
+
+    // Finish the streams we have, but accept no new ones
+    goingAway = true;
+    maybeClose();
+}
+
+void QHttp2ServerConnection::handleRST_STREAM()
+{
+    const quint32 streamID = inboundFrame.streamID();
+    if (streamID == connectionStreamID)
+        return connectionError(PROTOCOL_ERROR);
+    if (streamID > lastStreamID)
+        return connectionError(PROTOCOL_ERROR);
+
+    const auto it = streams.find(streamID);
+    if (it == streams.end())
+        return;
+
+    it->second.remoteClosed = true;
+    it->second.localClosed = true;
+    QHttpServerRequestPrivate *d = QHttpServerRequestPrivate::get(it->second.request);
+    if (!d->finished)
+        d->setFinished();
+    closeStream(it);
+    maybeClose();
+}
+
+void QHttp2ServerConnection::handleWINDOW_UPDATE()
+{
+    const quint32 streamID = inboundFrame.streamID();
+    const quint32 delta = qFromBigEndian<quint32>(inboundFrame.dataBegin()) & 0x7fffffff;
+
+    if (streamID == connectionStreamID) {
+        if (!delta || qint64(sessionSendWindow) + delta > std::numeric_limits<qint32>::max())
+            return connectionError(delta ? FLOW_CONTROL_ERROR : PROTOCOL_ERROR);
+        sessionSendWindow += qint32(delta);
+    } else {
+        const auto it = streams.find(streamID);
+        if (it == streams.end())
+            return; // Closed already
+        Stream &stream = it->second;
+        if (!delta || qint64(stream.sendWindow) + delta > std::numeric_limits<qint32>::max()) {
+            sendRST_STREAM(streamID, delta ? FLOW_CONTROL_ERROR : PROTOCOL_ERROR);
+            stream.remoteClosed = true;
+            stream.localClosed = true;
+            closeStream(it);
+            return;
+        }
+        stream.sendWindow += qint32(delta);
+    }
+    scheduleFlush();
+}
+
+void QHttp2ServerConnection::sendWINDOW_UPDATE(quint32 streamID, quint32 delta)
+{
+    frameWriter.start(FrameType::WINDOW_UPDATE, FrameFlag::EMPTY, streamID);
+    frameWriter.append(delta);
+    frameWriter.write(*socket);
+}
+
+void QHttp2ServerConnection::sendRST_STREAM(quint32 streamID, quint32 errorCode)
+{
+    frameWriter.start(FrameType::RST_STREAM, FrameFlag::EMPTY, streamID);
+    frameWriter.append(errorCode);
+    frameWriter.write(*socket);
+}
+
+void QHttp2ServerConnection::connectionError(quint32 errorCode)
+{
+    if (closed)
+        return;
+
+    frameWriter.start(FrameType::GOAWAY, FrameFlag::EMPTY, connectionStreamID);
+    frameWriter.append(lastStreamID);
+    frameWriter.append(errorCode);
+    frameWriter.write(*socket);
+
+    closed = true;
+    socket->disconnectFromHost();
+}
+
+void QHttp2ServerConnection::flush()
+{
+    if (closed)
+        return;
+
+    // Streams take turns in the order they were opened
+    auto it = streams.begin();
+    while (it != streams.end()) {
+        if (socket->bytesToWrite() > socketHighWaterMark)
+            return; // Continued on bytesWritten()
+
+        Stream &stream = it->second;
+        if (!stream.localClosed)
+            writeResponse(it->first, stream);
+
+        if (stream.localClosed) {
+            if (!stream.remoteClosed) {
+                // RFC 7540, 8.1: the response is complete, so the rest of
+                // the request is not needed
+                sendRST_STREAM(it->first, HTTP2_NO_ERROR);
+                stream.remoteClosed = true;
+            }
+            it = closeStream(it);
+        } else {
+            ++it;
+        }
+    }
+    maybeClose();
+}
+
+void QHttp2ServerConnection::writeResponse(quint32 streamID, Stream &stream)
+{
+    QHttpServerResponsePrivate *d = QHttpServerResponsePrivate::get(stream.response);
+    if (!d->headersSent) {
+        if (d->pending.isEmpty() && !d->finishCalled)
+            return;
+
+        d->headersSent = true;
+        stream.noBody = stream.noBody || hasNoBody(QByteArray(), d->statusCode);
+
+        HPack::HttpHeader header;
+        header.push_back(HPack::HeaderField(":status", QByteArray::number(d->statusCode)));
+        bool hasLength = false;
+        for (const auto &field : qAsConst(d->headers)) {
+            const QByteArray name = field.first.toLower();
+            // RFC 7540, 8.1.2.2: no connection-specific header fields
+            if (name == "connection" || name == "keep-alive" || name == "proxy-connection"
+                || name == "transfer-encoding" || name == "upgrade") {
+                continue;
+            }
+            if (name == "content-length")
+                hasLength = true;
+            header.push_back(HPack::HeaderField(name, field.second));
+        }
+        if (!hasLength && d->finishCalled && !stream.noBody) {
+            header.push_back(HPack::HeaderField("content-length",
+                                                QByteArray::number(d->pending.byteAmount())));
+        }
+
+        if (stream.noBody)
+            d->pending.clear();
+        const bool endStream = d->finishCalled && d->pending.isEmpty();
+
+        frameWriter.start(FrameType::HEADERS, FrameFlag::END_HEADERS, streamID);
+        if (endStream)
+            frameWriter.addFlag(FrameFlag::END_STREAM);
+        HPack::BitOStream outputStream(frameWriter.outboundFrame().buffer);
+        if (!encoder.encodeResponse(outputStream, header))
+            return connectionError(INTERNAL_ERROR);
+        frameWriter.writeHEADERS(*socket, maxFrameSize);
+
+        if (endStream) {
+            stream.localClosed = true;
+            return;
+        }
+    }
+
+    qint64 sent = 0;
+    if (stream.noBody) {
+        sent = d->pending.byteAmount();
+        d->pending.clear();
+    }
+    while (!d->pending.isEmpty() && socket->bytesToWrite() <= socketHighWaterMark) {
+        const qint32 window = qMin(stream.sendWindow, sessionSendWindow);
+        if (window <= 0)
+            break; // Continued on WINDOW_UPDATE
+
+        const qint64 size = qMin(qMin<qint64>(window, maxFrameSize), d->pending.byteAmount());
+        const QByteArray data = d->pending.read(size);
+        const bool last = d->finishCalled && d->pending.isEmpty();
+        frameWriter.start(FrameType::DATA, last ? FrameFlag::END_STREAM : FrameFlag::EMPTY,
+                          streamID);
+        frameWriter.writeDATA(*socket, maxFrameSize,
+                              reinterpret_cast<const uchar *>(data.constData()),
+                              quint32(data.size()));
+        stream.sendWindow -= qint32(size);
+        sessionSendWindow -= qint32(size);
+        sent += size;
+        if (last)
+            stream.localClosed = true;
+    }
+    if (sent)
+        d->dataSent(sent);
+
+    if (!stream.localClosed && d->finishCalled && d->pending.isEmpty()) {
+        frameWriter.start(FrameType::DATA, FrameFlag::END_STREAM, streamID);
+        frameWriter.setPayloadSize(0);
+        frameWriter.write(*socket);
+        stream.localClosed = true;
+    }
+}
+
+std::map<quint32, QHttp2ServerConnection::Stream>::iterator
+QHttp2ServerConnection::closeStream(std::map<quint32, Stream>::iterator it)
+{
+    Stream &stream = it->second;
+    // Whatever the application did not read goes back to the session
+    if (stream.request) {
+        const qint64 unread = QHttpServerRequestPrivate::get(stream.request)->body.byteAmount();
+        sessionUnackedBytes += qint32(unread);
+    }
+    release(stream.request, stream.response);
+    it = streams.erase(it);
+
+    Stream unused;
+    updateReceiveWindows(connectionStreamID, unused);
+    return it;
+}
+
+void QHttp2ServerConnection::maybeClose()
+{
+    if (goingAway && streams.empty() && !closed) {
+        closed = true;
+        socket->disconnectFromHost();
+    }
+}
+
+QT_END_NAMESPACE
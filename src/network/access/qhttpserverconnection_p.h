@@ -0,0 +1,268 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPSERVERCONNECTION_P_H
+#define QHTTPSERVERCONNECTION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtNetwork/qhttp2configuration.h>
+#include <QtNetwork/qhttpserverrequest.h>
+#include <QtNetwork/qhttpserverresponse.h>
+
+#include <QtCore/qbasictimer.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qscopedpointer.h>
+
+#include <private/http2frames_p.h>
+#include <private/hpack_p.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+QT_REQUIRE_CONFIG(http);
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractSocket;
+class QHttpNetworkReply;
+class QHttpServer;
+
+class QAbstractHttpServerConnection : public QObject
+{
+    Q_OBJECT
+public:
+    QAbstractHttpServerConnection(QHttpServer *server, QAbstractSocket *socket);
+    ~QAbstractHttpServerConnection();
+
+    // The application consumed bytes of a request body
+    virtual void requestBodyRead(QHttpServerRequest *request, qint64 bytes) = 0;
+    // The application wrote to or finished a response
+    void responseUpdated() { scheduleFlush(); }
+
+protected:
+    virtual void flush() = 0;
+
+    QHttpServerRequest *createRequest(const QByteArray &method, const QUrl &url,
+                                      int majorVersion, int minorVersion,
+                                      const QList<QPair<QByteArray, QByteArray> > &headers);
+    QHttpServerResponse *createResponse();
+    void emitNewRequest(QHttpServerRequest *request, QHttpServerResponse *response);
+    void release(QHttpServerRequest *request, QHttpServerResponse *response);
+    void scheduleFlush();
+    void scheduleReceive();
+
+    static QUrl requestUrl(const QByteArray &scheme, const QByteArray &authority,
+                           const QByteArray &target);
+
+    QPointer<QHttpServer> server;
+    QAbstractSocket *socket;
+    QByteArray scheme;
+    QHttp2Configuration http2Configuration;
+    qint64 readBufferSize;
+    int keepAliveTimeout;
+    bool http2Enabled;
+
+private Q_SLOTS:
+    void _q_flush();
+
+private:
+    bool flushScheduled = false;
+};
+
+class QHttp1ServerConnection : public QAbstractHttpServerConnection
+{
+    Q_OBJECT
+public:
+    QHttp1ServerConnection(QHttpServer *server, QAbstractSocket *socket);
+    ~QHttp1ServerConnection();
+
+    void requestBodyRead(QHttpServerRequest *request, qint64 bytes) override;
+
+protected:
+    void flush() override;
+    void timerEvent(QTimerEvent *event) override;
+
+private Q_SLOTS:
+    void receive();
+
+private:
+    struct Exchange
+    {
+        QHttpServerRequest *request;
+        QHttpServerResponse *response;
+        bool noBody;
+        bool chunked;
+        bool closeAfter;
+    };
+
+    enum State {
+        RequestLineState,
+        HeaderState,
+        BodyState,
+        ClosedState
+    };
+
+    bool readRequestLine();
+    bool readHeader();
+    bool readBody();
+    bool upgradeToHttp2();
+    void writeResponseHeader(Exchange &exchange);
+    void sendErrorAndClose(int statusCode);
+    void closeConnection();
+    void restartKeepAliveTimer();
+
+    std::deque<Exchange> exchanges;
+    // The request whose body is being read, if any
+    QHttpServerRequest *currentRequest = nullptr;
+    // Request headers and bodies are parsed by the client's reply parser
+    QScopedPointer<QHttpNetworkReply> parser;
+    QByteArray method;
+    QByteArray target;
+    State state = RequestLineState;
+    bool firstRequest = true;
+    bool discardingBody = false;
+    // Reading stopped because the request body buffer or the pipeline is full
+    bool readPaused = false;
+    QBasicTimer keepAliveTimer;
+};
+
+class QHttp2ServerConnection : public QAbstractHttpServerConnection
+{
+    Q_OBJECT
+public:
+    QHttp2ServerConnection(QHttpServer *server, QAbstractSocket *socket);
+    ~QHttp2ServerConnection();
+
+    void start();
+    void startUpgraded(const QByteArray &settings, const QByteArray &method, const QUrl &url,
+                       const QList<QPair<QByteArray, QByteArray> > &headers);
+
+    void requestBodyRead(QHttpServerRequest *request, qint64 bytes) override;
+
+protected:
+    void flush() override;
+
+private Q_SLOTS:
+    void receive();
+
+private:
+    struct Stream
+    {
+        QHttpServerRequest *request = nullptr;
+        QHttpServerResponse *response = nullptr;
+        qint32 sendWindow = 0;
+        qint32 recvWindow = 0;
+        // Bytes the application has read but we have not yet returned
+        // to the peer with WINDOW_UPDATE
+        qint32 unackedBytes = 0;
+        bool remoteClosed = false;
+        bool localClosed = false;
+        bool noBody = false;
+    };
+
+    void sendServerSettings();
+    bool applySettings(const uchar *src, quint32 size);
+    void handleFrame();
+    void handleHEADERS();
+    void handleCONTINUATION();
+    void continueHeaders();
+    void processHeaders();
+    void handleDATA();
+    void handleSETTINGS();
+    void handlePING();
+    void handleGOAWAY();
+    void handleRST_STREAM();
+    void handleWINDOW_UPDATE();
+    bool openStream(quint32 streamID, const HPack::HttpHeader &header, bool endStream);
+
+    void sendWINDOW_UPDATE(quint32 streamID, quint32 delta);
+    void sendRST_STREAM(quint32 streamID, quint32 errorCode);
+    void updateReceiveWindows(quint32 streamID, Stream &stream);
+    void connectionError(quint32 errorCode);
+    void writeResponse(quint32 streamID, Stream &stream);
+    std::map<quint32, Stream>::iterator closeStream(std::map<quint32, Stream>::iterator it);
+    void maybeClose();
+
+    Http2::FrameReader frameReader;
+    Http2::Frame inboundFrame;
+    Http2::FrameWriter frameWriter;
+    std::vector<Http2::Frame> continuedFrames;
+    // Size of the header block fragments in continuedFrames
+    quint32 headerBlockSize = 0;
+
+    HPack::Decoder decoder;
+    HPack::Encoder encoder;
+
+    std::map<quint32, Stream> streams;
+    quint32 lastStreamID = 0;
+
+    // Our peer's limits
+    quint32 maxFrameSize = Http2::minPayloadLimit;
+    qint32 initialSendWindow = Http2::defaultSessionWindowSize;
+    qint32 sessionSendWindow = Http2::defaultSessionWindowSize;
+
+    // Our limits
+    qint32 streamRecvWindowSize = Http2::defaultSessionWindowSize;
+    qint32 sessionRecvWindowSize = Http2::defaultSessionWindowSize;
+    qint32 sessionRecvWindow = Http2::defaultSessionWindowSize;
+    qint32 sessionUnackedBytes = 0;
+
+    bool waitingForPreface = true;
+    bool waitingForSettings = true;
+    bool goingAway = false;
+    bool closed = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTPSERVERCONNECTION_P_H
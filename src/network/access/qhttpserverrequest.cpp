@@ -0,0 +1,270 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpserverrequest.h"
+#include "qhttpserver_p.h"
+#include "qhttpserverconnection_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttpServerRequest
+    \brief The QHttpServerRequest class is a request received by QHttpServer.
+    \since 5.15
+
+    \inmodule QtNetwork
+    \ingroup network
+
+    QHttpServerRequest holds the request line and headers of a request,
+    and is a sequential, read-only QIODevice for its body. readyRead()
+    is emitted as body data arrives, and finished() once the whole body
+    has been received. Reading the body makes room for more of it to be
+    received from the client.
+
+    For HTTP/2 requests, majorVersion() returns 2, and the \c :authority
+    and \c :path pseudo-header fields are part of url() rather than of
+    headers().
+
+    The object is owned by QHttpServer and deleted when the response has
+    been sent or the connection closes.
+
+    \sa QHttpServer::newRequest(), QHttpServerResponse
+*/
+
+/*!
+    \fn void QHttpServerRequest::finished()
+
+    This signal is emitted when the request body has been received in
+    full, or when the client abandoned the request. It is not emitted
+    for requests that are complete when QHttpServer::newRequest() is
+    emitted, such as requests without a body; check isFinished() first.
+*/
+
+void QHttpServerRequestPrivate::appendBody(const QByteArray &data)
+{
+    Q_Q(QHttpServerRequest);
+    body.append(data);
+    emit q->readyRead();
+}
+
+void QHttpServerRequestPrivate::setFinished()
+{
+    Q_Q(QHttpServerRequest);
+    if (finished)
+        return;
+    finished = true;
+    emit q->readChannelFinished();
+    emit q->finished();
+}
+
+/*!
+    \internal
+*/
+QHttpServerRequest::QHttpServerRequest(QObject *parent)
+    : QIODevice(*new QHttpServerRequestPrivate, parent)
+{
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+/*!
+    Destroys the request.
+*/
+QHttpServerRequest::~QHttpServerRequest()
+{
+}
+
+/*!
+    Returns the request method, such as \c GET or \c POST.
+*/
+QByteArray QHttpServerRequest::method() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->method;
+}
+
+/*!
+    Returns the requested URL. Its host and port are taken from the
+    \c Host header or the \c :authority pseudo-header field.
+*/
+QUrl QHttpServerRequest::url() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->url;
+}
+
+/*!
+    Returns the major HTTP version of the request.
+*/
+int QHttpServerRequest::majorVersion() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->majorVersion;
+}
+
+/*!
+    Returns the minor HTTP version of the request.
+*/
+int QHttpServerRequest::minorVersion() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->minorVersion;
+}
+
+/*!
+    Returns the request header fields in the order they were received.
+*/
+QList<QPair<QByteArray, QByteArray> > QHttpServerRequest::headers() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->headers;
+}
+
+/*!
+    Returns \c true if the request has a header field called \a name,
+    compared case-insensitively.
+*/
+bool QHttpServerRequest::hasHeader(const QByteArray &name) const
+{
+    Q_D(const QHttpServerRequest);
+    for (const auto &field : d->headers) {
+        if (field.first.compare(name, Qt::CaseInsensitive) == 0)
+            return true;
+    }
+    return false;
+}
+
+/*!
+    Returns the value of the header field called \a name, compared
+    case-insensitively. If there are several, their values are joined
+    with a comma.
+*/
+QByteArray QHttpServerRequest::header(const QByteArray &name) const
+{
+    Q_D(const QHttpServerRequest);
+    QByteArray value;
+    for (const auto &field : d->headers) {
+        if (field.first.compare(name, Qt::CaseInsensitive) == 0) {
+            if (!value.isEmpty())
+                value += ", ";
+            value += field.second;
+        }
+    }
+    return value;
+}
+
+/*!
+    Returns the address of the client.
+*/
+QHostAddress QHttpServerRequest::peerAddress() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->peerAddress;
+}
+
+/*!
+    Returns the port of the client.
+*/
+quint16 QHttpServerRequest::peerPort() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->peerPort;
+}
+
+/*!
+    Returns \c true once the request body has been received in full.
+*/
+bool QHttpServerRequest::isFinished() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->finished;
+}
+
+/*!
+    \reimp
+*/
+bool QHttpServerRequest::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+*/
+qint64 QHttpServerRequest::bytesAvailable() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->body.byteAmount() + QIODevice::bytesAvailable();
+}
+
+/*!
+    \reimp
+*/
+bool QHttpServerRequest::atEnd() const
+{
+    Q_D(const QHttpServerRequest);
+    return d->finished && d->body.isEmpty();
+}
+
+/*!
+    \reimp
+*/
+qint64 QHttpServerRequest::readData(char *data, qint64 maxlen)
+{
+    Q_D(QHttpServerRequest);
+    const qint64 bytes = d->body.read(data, maxlen);
+    if (bytes > 0) {
+        if (d->connection)
+            d->connection->requestBodyRead(this, bytes);
+        return bytes;
+    }
+    return d->finished ? qint64(-1) : qint64(0);
+}
+
+/*!
+    \reimp
+*/
+qint64 QHttpServerRequest::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return -1;
+}
+
+QT_END_NAMESPACE
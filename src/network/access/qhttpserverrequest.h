@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPSERVERREQUEST_H
+#define QHTTPSERVERREQUEST_H
+
+#include <QtNetwork/qtnetworkglobal.h>
+#include <QtNetwork/qhostaddress.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qurl.h>
+
+QT_REQUIRE_CONFIG(http);
+
+QT_BEGIN_NAMESPACE
+
+class QHttpServerRequestPrivate;
+class Q_NETWORK_EXPORT QHttpServerRequest : public QIODevice
+{
+    Q_OBJECT
+public:
+    ~QHttpServerRequest();
+
+    QByteArray method() const;
+    QUrl url() const;
+    int majorVersion() const;
+    int minorVersion() const;
+
+    QList<QPair<QByteArray, QByteArray> > headers() const;
+    bool hasHeader(const QByteArray &name) const;
+    QByteArray header(const QByteArray &name) const;
+
+    QHostAddress peerAddress() const;
+    quint16 peerPort() const;
+
+    bool isFinished() const;
+
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+    bool atEnd() const override;
+
+Q_SIGNALS:
+    void finished();
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    explicit QHttpServerRequest(QObject *parent = nullptr);
+
+    friend class QAbstractHttpServerConnection;
+    Q_DECLARE_PRIVATE(QHttpServerRequest)
+    Q_DISABLE_COPY(QHttpServerRequest)
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTPSERVERREQUEST_H
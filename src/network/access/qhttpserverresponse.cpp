@@ -0,0 +1,256 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpserverresponse.h"
+#include "qhttpserver_p.h"
+#include "qhttpserverconnection_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttpServerResponse
+    \brief The QHttpServerResponse class is the response to a QHttpServerRequest.
+    \since 5.15
+
+    \inmodule QtNetwork
+    \ingroup network
+
+    QHttpServerResponse is a sequential, write-only QIODevice for the
+    body of a response. Set the status code and the headers before the
+    first write, then write the body and call finish().
+
+    Nothing is sent before the application returns to the event loop.
+    A response that is finished by then is sent with a \c Content-Length
+    header; otherwise HTTP/1.1 uses chunked transfer encoding, HTTP/2
+    simply sends DATA frames, and HTTP/1.0 closes the connection after
+    the body. bytesToWrite() is the amount of data that is waiting for
+    the connection, and bytesWritten() is emitted as it is handed to the
+    socket, which lets an application generating a large body keep it
+    out of memory.
+
+    The framing headers \c Connection and \c Transfer-Encoding are
+    controlled by the server; a \c{Connection: close} header closes an
+    HTTP/1.x connection after the response.
+
+    The object is owned by QHttpServer and deleted shortly after
+    finished() is emitted.
+
+    \sa QHttpServer::newRequest(), QHttpServerRequest
+*/
+
+/*!
+    \fn void QHttpServerResponse::finished()
+
+    This signal is emitted when the response has been handed to the
+    connection in full, or when the connection closed first.
+*/
+
+void QHttpServerResponsePrivate::dataSent(qint64 bytes)
+{
+    Q_Q(QHttpServerResponse);
+    emit q->bytesWritten(bytes);
+}
+
+void QHttpServerResponsePrivate::setFinished()
+{
+    Q_Q(QHttpServerResponse);
+    if (finished)
+        return;
+    finished = true;
+    emit q->finished();
+}
+
+/*!
+    \internal
+*/
+QHttpServerResponse::QHttpServerResponse(QObject *parent)
+    : QIODevice(*new QHttpServerResponsePrivate, parent)
+{
+    open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+}
+
+/*!
+    Destroys the response.
+*/
+QHttpServerResponse::~QHttpServerResponse()
+{
+}
+
+/*!
+    Sets the status code of the response to \a code. The default is 200.
+    The status code cannot be changed once the headers have been sent.
+*/
+void QHttpServerResponse::setStatusCode(int code)
+{
+    Q_D(QHttpServerResponse);
+    if (d->headersSent) {
+        qWarning("QHttpServerResponse::setStatusCode: headers have already been sent");
+        return;
+    }
+    d->statusCode = code;
+}
+
+/*!
+    Returns the status code of the response.
+*/
+int QHttpServerResponse::statusCode() const
+{
+    Q_D(const QHttpServerResponse);
+    return d->statusCode;
+}
+
+/*!
+    Sets the header field \a name to \a value, replacing any field of
+    the same name, compared case-insensitively.
+
+    \sa addHeader()
+*/
+void QHttpServerResponse::setHeader(const QByteArray &name, const QByteArray &value)
+{
+    Q_D(QHttpServerResponse);
+    auto it = d->headers.begin();
+    while (it != d->headers.end()) {
+        if (it->first.compare(name, Qt::CaseInsensitive) == 0)
+            it = d->headers.erase(it);
+        else
+            ++it;
+    }
+    addHeader(name, value);
+}
+
+/*!
+    Adds a header field \a name with \a value, keeping any field of
+    the same name.
+
+    \sa setHeader()
+*/
+void QHttpServerResponse::addHeader(const QByteArray &name, const QByteArray &value)
+{
+    Q_D(QHttpServerResponse);
+    if (d->headersSent) {
+        qWarning("QHttpServerResponse::addHeader: headers have already been sent");
+        return;
+    }
+    d->headers.append(qMakePair(name, value));
+}
+
+/*!
+    Returns the header fields of the response.
+*/
+QList<QPair<QByteArray, QByteArray> > QHttpServerResponse::headers() const
+{
+    Q_D(const QHttpServerResponse);
+    return d->headers;
+}
+
+/*!
+    Completes the response. No more data can be written afterwards.
+
+    \sa isFinished()
+*/
+void QHttpServerResponse::finish()
+{
+    Q_D(QHttpServerResponse);
+    if (d->finishCalled)
+        return;
+    d->finishCalled = true;
+    if (d->connection)
+        d->connection->responseUpdated();
+}
+
+/*!
+    Returns \c true once the response has been handed to the connection
+    in full, or the connection closed.
+
+    \sa finished()
+*/
+bool QHttpServerResponse::isFinished() const
+{
+    Q_D(const QHttpServerResponse);
+    return d->finished;
+}
+
+/*!
+    \reimp
+*/
+bool QHttpServerResponse::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+*/
+qint64 QHttpServerResponse::bytesToWrite() const
+{
+    Q_D(const QHttpServerResponse);
+    return d->pending.byteAmount();
+}
+
+/*!
+    \reimp
+*/
+qint64 QHttpServerResponse::readData(char *data, qint64 maxlen)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxlen);
+    return -1;
+}
+
+/*!
+    \reimp
+*/
+qint64 QHttpServerResponse::writeData(const char *data, qint64 len)
+{
+    Q_D(QHttpServerResponse);
+    if (d->finishCalled) {
+        setErrorString(tr("The response has already been finished"));
+        return -1;
+    }
+    if (!d->connection) {
+        setErrorString(tr("The connection has been closed"));
+        return -1;
+    }
+    d->pending.append(QByteArray(data, int(len)));
+    d->connection->responseUpdated();
+    return len;
+}
+
+QT_END_NAMESPACE
@@ -182,15 +182,18 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
     // Q_OBJECT
 public:
 #ifdef QT_NO_BEARERMANAGEMENT
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, /*parent=*/nullptr,
+                                 connectionType)
 #else // ### Qt6: Remove section
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType,
                                        QSharedPointer<QNetworkSession> networkSession)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType, /*parent=*/nullptr,
-                                 std::move(networkSession))
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, /*parent=*/nullptr,
+                                 std::move(networkSession), connectionType)
 #endif
     {
         setExpires(true);
@@ -284,6 +287,8 @@ void QHttpThreadDelegate::startRequest()
     if (!connections.hasLocalData()) {
         connections.setLocalData(new QNetworkAccessCache());
     }
+    if (connectionPool)
+        connections.localData()->setExpiryTimeout(connectionPool->idleTimeout());
 
     // check if we have an open connection to this host
     QUrl urlCopy = httpRequest.url();
@@ -345,14 +350,20 @@ void QHttpThreadDelegate::startRequest()
     if (!httpConnection) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
+        const quint16 channelCount = connectionPool
+                ? connectionPool->channelCount(urlCopy.host())
+                : QHttpNetworkConnectionPrivate::defaultHttpChannelCount;
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(channelCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType);
 #else // ### Qt6: Remove section
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(channelCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType,
                                                                 networkSession);
 #endif // QT_NO_BEARERMANAGEMENT
+        httpConnection->d_func()->connectionPool = connectionPool;
         if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
             || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
             httpConnection->setHttp2Parameters(http2Parameters);
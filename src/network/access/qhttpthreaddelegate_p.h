@@ -67,6 +67,7 @@
 #include <QScopedPointer>
 #include "private/qnoncontiguousbytedevice_p.h"
 #include "qnetworkaccessauthenticationmanager_p.h"
+#include "qnetworkaccessconnectionpool_p.h"
 #include <QtNetwork/private/http2protocol_p.h>
 
 QT_REQUIRE_CONFIG(http);
@@ -104,6 +105,7 @@ public:
     QNetworkProxy transparentProxy;
 #endif
     QSharedPointer<QNetworkAccessAuthenticationManager> authenticationManager;
+    QSharedPointer<QNetworkAccessConnectionPool> connectionPool;
     bool synchronous;
 
     // outgoing, Retrieved in the synchronous HTTP case
@@ -203,6 +205,7 @@ protected:
     bool m_atEnd;
     qint64 m_size;
     qint64 m_pos; // to match calls of haveDataSlot with the expected position
+    bool m_fileBacked = false; // data may also be sent from the request's upload file
 public:
     QNonContiguousByteDeviceThreadForwardImpl(bool aE, qint64 s)
         : QNonContiguousByteDevice(),
@@ -244,10 +247,22 @@ public:
         return nullptr;
     }
 
+    void setFileBacked(bool fileBacked)
+    {
+        m_fileBacked = fileBacked;
+    }
+
     bool advanceReadPointer(qint64 a) override
     {
-        if (m_data == nullptr)
-            return false;
+        if (m_data == nullptr) {
+            if (!m_fileBacked)
+                return false;
+
+            // The HTTP code sent this data from the upload file itself
+            m_pos += a;
+            emit processedFileData(m_pos, a);
+            return true;
+        }
 
         m_amount -= a;
         m_data += a;
@@ -323,6 +338,7 @@ signals:
     // to main thread:
     void wantData(qint64);
     void processedData(qint64 pos, qint64 amount);
+    void processedFileData(qint64 pos, qint64 amount);
     void resetData(bool *b);
 };
 
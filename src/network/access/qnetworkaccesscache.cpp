@@ -44,6 +44,7 @@
 #include "qnetworkreply_p.h"
 #include "qnetworkrequest.h"
 
+#include <limits>
 #include <vector>
 
 QT_BEGIN_NAMESPACE
@@ -103,7 +104,7 @@ void QNetworkAccessCache::CacheableObject::setShareable(bool enable)
 }
 
 QNetworkAccessCache::QNetworkAccessCache()
-    : oldest(nullptr), newest(nullptr)
+    : oldest(nullptr), newest(nullptr), expiryTimeout(ExpiryTime * 1000)
 {
 }
 
@@ -112,6 +113,15 @@ QNetworkAccessCache::~QNetworkAccessCache()
     clear();
 }
 
+/*!
+    Sets the time unused entries are kept to \a msecs milliseconds.
+    Entries that are unused already keep their expiry time.
+*/
+void QNetworkAccessCache::setExpiryTimeout(int msecs)
+{
+    expiryTimeout = msecs;
+}
+
 void QNetworkAccessCache::clear()
 {
     NodeHash hashCopy = hash;
@@ -158,7 +168,7 @@ void QNetworkAccessCache::linkEntry(const QByteArray &key)
         oldest = node;
     }
 
-    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(ExpiryTime);
+    node->timestamp = QDateTime::currentDateTimeUtc().addMSecs(expiryTimeout);
     newest = node;
 }
 
@@ -197,15 +207,11 @@ void QNetworkAccessCache::updateTimer()
     if (!oldest)
         return;
 
-    int interval = QDateTime::currentDateTimeUtc().secsTo(oldest->timestamp);
-    if (interval <= 0) {
-        interval = 0;
-    } else {
-        // round up the interval
-        interval = (interval + 15) & ~16;
-    }
+    const qint64 interval = QDateTime::currentDateTimeUtc().msecsTo(oldest->timestamp);
 
-    timer.start(interval * 1000, this);
+    // expiry does not need to be precise, let the timer be coalesced
+    timer.start(int(qBound<qint64>(0, interval, std::numeric_limits<int>::max())),
+                Qt::CoarseTimer, this);
 }
 
 bool QNetworkAccessCache::emitEntryReady(Node *node, QObject *target, const char *member)
@@ -93,6 +93,8 @@ public:
     QNetworkAccessCache();
     ~QNetworkAccessCache();
 
+    void setExpiryTimeout(int msecs);
+
     void clear();
 
     void addEntry(const QByteArray &key, CacheableObject *entry);
@@ -113,6 +115,7 @@ private:
     NodeHash hash;
     Node *oldest;
     Node *newest;
+    int expiryTimeout;
 
     QBasicTimer timer;
 
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qnetworkaccessconnectionpool_p.h"
+
+QT_BEGIN_NAMESPACE
+
+void QNetworkAccessConnectionPool::setDefaultChannelCount(int count)
+{
+    QMutexLocker locker(&mutex);
+    defaultCount = qBound(1, count, int(MaximumChannelCount));
+}
+
+int QNetworkAccessConnectionPool::defaultChannelCount() const
+{
+    QMutexLocker locker(&mutex);
+    return defaultCount;
+}
+
+void QNetworkAccessConnectionPool::setHostChannelCount(const QString &hostName, int count)
+{
+    QMutexLocker locker(&mutex);
+    if (count > 0)
+        hostCounts.insert(hostName.toLower(), qMin(count, int(MaximumChannelCount)));
+    else
+        hostCounts.remove(hostName.toLower());
+}
+
+int QNetworkAccessConnectionPool::hostChannelCount(const QString &hostName) const
+{
+    QMutexLocker locker(&mutex);
+    return hostCounts.value(hostName.toLower());
+}
+
+int QNetworkAccessConnectionPool::channelCount(const QString &hostName) const
+{
+    QMutexLocker locker(&mutex);
+    return hostCounts.value(hostName.toLower(), defaultCount);
+}
+
+void QNetworkAccessConnectionPool::setIdleTimeout(int msecs)
+{
+    idleTimeoutMSecs.storeRelaxed(qMax(0, msecs));
+}
+
+int QNetworkAccessConnectionPool::idleTimeout() const
+{
+    return idleTimeoutMSecs.loadRelaxed();
+}
+
+/*
+    Replaces what a connection last published in \a published with
+    \a current. Connections publish differences so that the totals can
+    be read without asking the HTTP thread.
+*/
+void QNetworkAccessConnectionPool::updateUsage(Usage *published, const Usage &current)
+{
+    if (int delta = current.openConnections - published->openConnections)
+        openConnections.fetchAndAddRelaxed(delta);
+    if (int delta = current.busyConnections - published->busyConnections)
+        busyConnections.fetchAndAddRelaxed(delta);
+    if (int delta = current.activeRequests - published->activeRequests)
+        activeRequests.fetchAndAddRelaxed(delta);
+    if (int delta = current.queuedRequests - published->queuedRequests)
+        queuedRequests.fetchAndAddRelaxed(delta);
+    *published = current;
+}
+
+QNetworkAccessManager::ConnectionPoolStatistics QNetworkAccessConnectionPool::statistics() const
+{
+    QNetworkAccessManager::ConnectionPoolStatistics result;
+    result.openConnections = openConnections.loadRelaxed();
+    // The counters are updated one at a time, so keep them consistent
+    result.idleConnections = qMax(0, result.openConnections - busyConnections.loadRelaxed());
+    result.activeRequests = activeRequests.loadRelaxed();
+    result.queuedRequests = queuedRequests.loadRelaxed();
+    result.requestCount = requestCount.loadRelaxed();
+    result.connectionCount = connectionCount.loadRelaxed();
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QNETWORKACCESSCONNECTIONPOOL_P_H
+#define QNETWORKACCESSCONNECTIONPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include "qnetworkaccessmanager.h"
+
+#include "QtCore/qatomic.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qmutex.h"
+
+QT_BEGIN_NAMESPACE
+
+// Settings and accounting for the HTTP connections of one
+// QNetworkAccessManager. Shared with the HTTP thread, which reads the
+// settings when it opens connections and publishes what its connections
+// are doing.
+class QNetworkAccessConnectionPool
+{
+public:
+    enum {
+        DefaultChannelCount = 6,
+        MaximumChannelCount = 256,
+        DefaultIdleTimeout = 120 * 1000
+    };
+
+    // What one QHttpNetworkConnection contributes to the statistics
+    struct Usage
+    {
+        int openConnections = 0;
+        int busyConnections = 0;
+        int activeRequests = 0;
+        int queuedRequests = 0;
+    };
+
+    void setDefaultChannelCount(int count);
+    int defaultChannelCount() const;
+    void setHostChannelCount(const QString &hostName, int count);
+    int hostChannelCount(const QString &hostName) const;
+    int channelCount(const QString &hostName) const;
+
+    void setIdleTimeout(int msecs);
+    int idleTimeout() const;
+
+    // Called from the HTTP thread
+    void updateUsage(Usage *published, const Usage &current);
+    void requestQueued() { requestCount.fetchAndAddRelaxed(1); }
+    void connectionOpened() { connectionCount.fetchAndAddRelaxed(1); }
+
+    QNetworkAccessManager::ConnectionPoolStatistics statistics() const;
+
+private:
+    mutable QMutex mutex;
+    int defaultCount = DefaultChannelCount;
+    QHash<QString, int> hostCounts;
+    QAtomicInt idleTimeoutMSecs = DefaultIdleTimeout;
+
+    QAtomicInt openConnections;
+    QAtomicInt busyConnections;
+    QAtomicInt activeRequests;
+    QAtomicInt queuedRequests;
+    QAtomicInteger<qint64> requestCount;
+    QAtomicInteger<qint64> connectionCount;
+};
+
+QT_END_NAMESPACE
+
+#endif // QNETWORKACCESSCONNECTIONPOOL_P_H
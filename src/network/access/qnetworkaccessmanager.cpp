@@ -1694,6 +1694,159 @@ void QNetworkAccessManager::setTransferTimeout(int timeout)
     d_func()->transferTimeout = timeout;
 }
 
+/*!
+    \since 5.15
+
+    Returns the number of connections that are opened in parallel to
+    a host for which no count was set with
+    setMaximumConnectionsPerHost(const QString &, int). The default is 6.
+
+    \sa connectionPoolStatistics()
+*/
+int QNetworkAccessManager::maximumConnectionsPerHost() const
+{
+    return d_func()->connectionPool->defaultChannelCount();
+}
+
+/*!
+    \since 5.15
+
+    Sets the number of connections that are opened in parallel to a
+    host to \a count, which must be between 1 and 256. HTTP/1.1 sends
+    one request at a time on each connection, unless pipelining is
+    enabled, so this limits the number of requests that are in flight
+    to a host. HTTP/2 always uses a single connection per host.
+
+    The limit applies to connections to hosts that have not been
+    contacted yet, or whose connections were closed with
+    clearConnectionCache() or after connectionIdleTimeout().
+*/
+void QNetworkAccessManager::setMaximumConnectionsPerHost(int count)
+{
+    if (count < 1)
+        qWarning("QNetworkAccessManager::setMaximumConnectionsPerHost: count must be positive");
+    d_func()->connectionPool->setDefaultChannelCount(count);
+}
+
+/*!
+    \since 5.15
+    \overload
+
+    Returns the number of connections that are opened in parallel to
+    \a hostName, or 0 if the host uses maximumConnectionsPerHost().
+*/
+int QNetworkAccessManager::maximumConnectionsPerHost(const QString &hostName) const
+{
+    return d_func()->connectionPool->hostChannelCount(hostName);
+}
+
+/*!
+    \since 5.15
+    \overload
+
+    Sets the number of connections that are opened in parallel to
+    \a hostName to \a count, overriding maximumConnectionsPerHost().
+    Host names are compared case-insensitively; the port is not
+    taken into account. A \a count of 0 removes the override.
+*/
+void QNetworkAccessManager::setMaximumConnectionsPerHost(const QString &hostName, int count)
+{
+    d_func()->connectionPool->setHostChannelCount(hostName, count);
+}
+
+/*!
+    \since 5.15
+
+    Returns the time in milliseconds the connections to a host are kept
+    open once no request uses them. The default is two minutes.
+*/
+int QNetworkAccessManager::connectionIdleTimeout() const
+{
+    return d_func()->connectionPool->idleTimeout();
+}
+
+/*!
+    \since 5.15
+
+    Sets the time the connections to a host are kept open once no
+    request uses them to \a msecs milliseconds. A short timeout frees
+    sockets and server resources sooner, a long one avoids connecting
+    again when requests arrive in bursts.
+
+    The timeout takes effect with the next request.
+*/
+void QNetworkAccessManager::setConnectionIdleTimeout(int msecs)
+{
+    d_func()->connectionPool->setIdleTimeout(msecs);
+}
+
+/*!
+    \class QNetworkAccessManager::ConnectionPoolStatistics
+    \inmodule QtNetwork
+    \since 5.15
+
+    \brief Describes the HTTP connections of a QNetworkAccessManager.
+
+    \sa QNetworkAccessManager::connectionPoolStatistics()
+*/
+
+/*!
+    \variable QNetworkAccessManager::ConnectionPoolStatistics::openConnections
+
+    The number of connected sockets.
+*/
+
+/*!
+    \variable QNetworkAccessManager::ConnectionPoolStatistics::idleConnections
+
+    The number of connected sockets without a request in flight.
+*/
+
+/*!
+    \variable QNetworkAccessManager::ConnectionPoolStatistics::activeRequests
+
+    The number of requests that have been sent and wait for their reply.
+*/
+
+/*!
+    \variable QNetworkAccessManager::ConnectionPoolStatistics::queuedRequests
+
+    The number of requests that wait for a connection.
+*/
+
+/*!
+    \variable QNetworkAccessManager::ConnectionPoolStatistics::requestCount
+
+    The number of HTTP requests made since the manager was created.
+*/
+
+/*!
+    \variable QNetworkAccessManager::ConnectionPoolStatistics::connectionCount
+
+    The number of connections opened since the manager was created.
+*/
+
+/*!
+    \fn double QNetworkAccessManager::ConnectionPoolStatistics::reuseRatio() const
+
+    Returns the fraction of requests that did not need a new connection,
+    between 0 and 1.
+*/
+
+/*!
+    \since 5.15
+
+    Returns a snapshot of the HTTP connections this manager has open and
+    of the requests using them. The connections are served by a
+    separate thread, so the snapshot may be slightly out of date.
+
+    \sa setMaximumConnectionsPerHost(), setConnectionIdleTimeout()
+*/
+QNetworkAccessManager::ConnectionPoolStatistics QNetworkAccessManager::connectionPoolStatistics() const
+{
+    return d_func()->connectionPool->statistics();
+}
+
 void QNetworkAccessManagerPrivate::_q_replyFinished(QNetworkReply *reply)
 {
     Q_Q(QNetworkAccessManager);
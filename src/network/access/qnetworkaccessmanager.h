@@ -103,6 +103,22 @@ QT_WARNING_DISABLE_DEPRECATED
 QT_WARNING_POP
 #endif
 
+    struct ConnectionPoolStatistics
+    {
+        int openConnections = 0;
+        int idleConnections = 0;
+        int activeRequests = 0;
+        int queuedRequests = 0;
+        qint64 requestCount = 0;
+        qint64 connectionCount = 0;
+
+        double reuseRatio() const
+        {
+            return requestCount > connectionCount
+                    ? 1.0 - double(connectionCount) / double(requestCount) : 0.0;
+        }
+    };
+
     explicit QNetworkAccessManager(QObject *parent = nullptr);
     ~QNetworkAccessManager();
 
@@ -179,6 +195,16 @@ QT_WARNING_POP
     int transferTimeout() const;
     void setTransferTimeout(int timeout = QNetworkRequest::DefaultTransferTimeoutConstant);
 
+    int maximumConnectionsPerHost() const;
+    void setMaximumConnectionsPerHost(int count);
+    int maximumConnectionsPerHost(const QString &hostName) const;
+    void setMaximumConnectionsPerHost(const QString &hostName, int count);
+
+    int connectionIdleTimeout() const;
+    void setConnectionIdleTimeout(int msecs);
+
+    ConnectionPoolStatistics connectionPoolStatistics() const;
+
 Q_SIGNALS:
 #ifndef QT_NO_NETWORKPROXY
     void proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
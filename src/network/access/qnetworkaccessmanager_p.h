@@ -62,6 +62,7 @@
 #include "QtNetwork/qnetworkproxy.h"
 #include "QtNetwork/qnetworksession.h"
 #include "qnetworkaccessauthenticationmanager_p.h"
+#include "qnetworkaccessconnectionpool_p.h"
 #ifndef QT_NO_BEARERMANAGEMENT // ### Qt6: Remove section
 #include "QtNetwork/qnetworkconfigmanager.h"
 #endif
@@ -100,7 +101,8 @@ public:
           cookieJarCreated(false),
           defaultAccessControl(true),
           redirectPolicy(QNetworkRequest::ManualRedirectPolicy),
-          authenticationManager(QSharedPointer<QNetworkAccessAuthenticationManager>::create())
+          authenticationManager(QSharedPointer<QNetworkAccessAuthenticationManager>::create()),
+          connectionPool(QSharedPointer<QNetworkAccessConnectionPool>::create())
     {
 #ifndef QT_NO_BEARERMANAGEMENT // ### Qt6: Remove section
         // we would need all active configurations to check for
@@ -211,6 +213,9 @@ public:
     // The cache with authorization data:
     QSharedPointer<QNetworkAccessAuthenticationManager> authenticationManager;
 
+    // Per-host connection limits and statistics, shared with the HTTP thread:
+    QSharedPointer<QNetworkAccessConnectionPool> connectionPool;
+
     // this cache can be used by individual backends to cache e.g. their TCP connections to a server
     // and use the connections for multiple requests.
     QNetworkAccessCache objectCache;
@@ -53,10 +53,20 @@
 #include <qcryptographichash.h>
 #include <qdebug.h>
 
+#include <algorithm>
+#include <limits>
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_INTEGRITY) && !defined(Q_OS_RTEMS) && !defined(Q_OS_QNX)
+#  include <private/qcore_unix_p.h>
+#  include <sys/file.h>
+#  define QNETWORKDISKCACHE_FLOCK
+#endif
+
 #define CACHE_POSTFIX QLatin1String(".d")
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -74,8 +84,13 @@ QT_BEGIN_NAMESPACE
     are compressed using qCompress.  Data is written to disk only in insert()
     and updateMetaData().
 
-    Currently you cannot share the same cache files with more than
-    one disk cache.
+    Since Qt 5.15, the cache keeps an index of its files in the cache
+    directory, with their sizes and the order in which they were last used.
+    This lets it open a large cache and decide which files to remove
+    without examining every file. Several disk caches, also in different
+    processes, can use the same cache directory; each operation locks the
+    index while it runs. Before Qt 5.15, the same cache files could not be
+    shared by more than one disk cache.
 
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
@@ -259,6 +274,10 @@ void QNetworkDiskCachePrivate::prepareLayout()
         QString subdir = dataDirectory + str;
         helper.mkdir(subdir);
     }
+
+    index.open(dataDirectory + INDEX_FILE, dataDirectory);
+    const QNetworkDiskCacheIndex::Locker locker(&index);
+    currentCacheSize = index.totalSize();
 }
 
 
@@ -266,6 +285,7 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
 {
     Q_Q(QNetworkDiskCache);
     Q_ASSERT(cacheItem->metaData.saveToDisk());
+    const QNetworkDiskCacheIndex::Locker locker(&index);
 
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
@@ -292,10 +312,13 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
-        else
+        if (cacheItem->file->rename(fileName)) {
+            const qint64 size = cacheItem->file->size();
+            index.insert(indexKey(fileName), size);
+            currentCacheSize += size;
+        } else {
             cacheItem->file->setAutoRemove(true);
+        }
     }
     if (cacheItem->metaData.url() == lastItem.metaData.url())
         lastItem.reset();
@@ -340,12 +363,19 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     QString fileName = info.fileName();
     if (!fileName.endsWith(CACHE_POSTFIX))
         return false;
-    qint64 size = info.size();
-    if (QFile::remove(file)) {
+    const QNetworkDiskCacheIndex::Locker locker(&index);
+    const quint64 key = indexKey(file);
+    if (!key || !index.contains(key))
+        return QFile::remove(file);
+
+    const qint64 size = index.size(key);
+    const bool removed = QFile::remove(file);
+    // Also forget about files that were removed behind our back
+    if (removed || !QFile::exists(file)) {
+        index.remove(key);
         currentCacheSize -= size;
-        return true;
     }
-    return false;
+    return removed;
 }
 
 /*!
@@ -357,9 +387,22 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     qDebug() << "QNetworkDiskCache::metaData()" << url;
 #endif
     Q_D(QNetworkDiskCache);
-    if (d->lastItem.metaData.url() == url)
+    const QString fileName = d->cacheFileName(url);
+    const quint64 key = d->indexKey(fileName);
+    const QNetworkDiskCacheIndex::Locker locker(&d->index);
+    if (d->lastItem.metaData.url() == url) {
+        d->index.touch(key);
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    }
+    if (!d->index.contains(key))
+        return QNetworkCacheMetaData();
+
+    QNetworkCacheMetaData metaData = fileMetaData(fileName);
+    if (metaData.isValid())
+        d->index.touch(key);
+    else if (!QFile::exists(fileName))
+        d->removeFile(fileName);
+    return metaData;
 }
 
 /*!
@@ -396,13 +439,20 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
     QScopedPointer<QBuffer> buffer;
     if (!url.isValid())
         return nullptr;
+    const QString fileName = d->cacheFileName(url);
+    const quint64 key = d->indexKey(fileName);
+    const QNetworkDiskCacheIndex::Locker locker(&d->index);
     if (d->lastItem.metaData.url() == url && d->lastItem.data.isOpen()) {
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
-        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
+        if (!d->index.contains(key))
+            return nullptr;
+        QScopedPointer<QFile> file(new QFile(fileName));
+        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered)) {
+            d->removeFile(fileName);
             return nullptr;
+        }
 
         if (!d->lastItem.read(file.data(), true)) {
             file->close();
@@ -418,6 +468,7 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
             buffer->setData(file->readAll());
         }
     }
+    d->index.touch(key);
     buffer->open(QBuffer::ReadOnly);
     return buffer.take();
 }
@@ -487,9 +538,12 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
     Returns the current size of the cache.
 
     When the current size of the cache is greater than the maximumCacheSize()
-    older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    cache files are removed until the total size is less then 90% of
+    maximumCacheSize(), starting with the least recently used ones, that is,
+    the ones that were inserted or returned by metaData() or data() the
+    longest time ago. For the files of a cache directory that was written
+    without the index, such as by an older version of Qt, the file creation
+    date is used instead.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
@@ -514,56 +568,26 @@ qint64 QNetworkDiskCache::expire()
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
 
-    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    QMultiMap<QDateTime, QString> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QString path = it.next();
-        QFileInfo info = it.fileInfo();
-        QString fileName = info.fileName();
-        if (fileName.endsWith(CACHE_POSTFIX)) {
-            const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
-            cacheItems.insert(birthTime.isValid() ? birthTime
-                              : info.fileTime(QFile::FileMetadataChangeTime), path);
-            totalSize += info.size();
-        }
-    }
-
+    const QNetworkDiskCacheIndex::Locker locker(&d->index);
     int removedFiles = 0;
     qint64 goal = (maximumCacheSize() * 9) / 10;
-    QMultiMap<QDateTime, QString>::const_iterator i = cacheItems.constBegin();
-    while (i != cacheItems.constEnd()) {
-        if (totalSize < goal)
+    while (d->index.totalSize() >= goal) {
+        const quint64 key = d->index.leastRecentlyUsed();
+        if (!key)
             break;
-        QString name = i.value();
-        QFile file(name);
-
-        if (name.contains(PREPARED_SLASH)) {
-            for (QCacheItem *item : qAsConst(d->inserting)) {
-                if (item && item->file && item->file->fileName() == name) {
-                    delete item->file;
-                    item->file = nullptr;
-                    break;
-                }
-            }
-        }
-
-        qint64 size = file.size();
-        file.remove();
-        totalSize -= size;
+        QFile::remove(d->dataDirectory
+                      + QNetworkDiskCachePrivate::fileNameForId(QNetworkDiskCacheIndex::fileId(key)));
+        d->index.remove(key);
         ++removedFiles;
-        ++i;
     }
 #if defined(QNETWORKDISKCACHE_DEBUG)
     if (removedFiles > 0) {
         qDebug() << "QNetworkDiskCache::expire()"
                 << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
+                << "Kept:" << d->index.count();
     }
 #endif
-    return totalSize;
+    return d->index.totalSize();
 }
 
 /*!
@@ -582,9 +606,9 @@ void QNetworkDiskCache::clear()
 }
 
 /*!
-    Given a URL, generates a unique enough filename (and subdirectory)
+    Given a URL, generates a unique enough file id of at most 8 characters
  */
-QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
+QByteArray QNetworkDiskCachePrivate::fileId(const QUrl &url)
 {
     QUrl cleanUrl = url;
     cleanUrl.setPassword(QString());
@@ -593,7 +617,14 @@ QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
     QCryptographicHash hash(QCryptographicHash::Sha1);
     hash.addData(cleanUrl.toEncoded());
     // convert sha1 to base36 form and return first 8 bytes for use as string
-    const QByteArray id = QByteArray::number(*(qlonglong*)hash.result().constData(), 36).left(8);
+    return QByteArray::number(*(qlonglong*)hash.result().constData(), 36).left(8);
+}
+
+/*!
+    Returns the filename (and subdirectory) for the file id \a id
+ */
+QString QNetworkDiskCachePrivate::fileNameForId(const QByteArray &id)
+{
     // generates <one-char subdir>/<8-char filname.d>
     uint code = (uint)id.at(id.length()-1) % 16;
     QString pathFragment = QString::number(code, 16) + QLatin1Char('/')
@@ -602,6 +633,14 @@ QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
     return pathFragment;
 }
 
+/*!
+    Given a URL, generates a unique enough filename (and subdirectory)
+ */
+QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
+{
+    return fileNameForId(fileId(url));
+}
+
 QString QNetworkDiskCachePrivate::tmpCacheFileName() const
 {
     //The subdirectory is presumed to be already read for use.
@@ -620,6 +659,25 @@ QString QNetworkDiskCachePrivate::cacheFileName(const QUrl &url) const
     return  fullpath;
 }
 
+/*!
+    Returns the index key of the cache file \a fileName, or 0 if it is not
+    one of the files at the place where the cache looks for them.
+ */
+quint64 QNetworkDiskCachePrivate::indexKey(const QString &fileName) const
+{
+    if (dataDirectory.isEmpty() || !fileName.startsWith(dataDirectory)
+        || !fileName.endsWith(CACHE_POSTFIX)) {
+        return 0;
+    }
+    const QStringRef pathFragment = fileName.midRef(dataDirectory.size());
+    const int slash = pathFragment.indexOf(QLatin1Char('/'));
+    const QByteArray id = pathFragment.mid(slash + 1, pathFragment.size() - slash - 1
+                                                      - CACHE_POSTFIX.size()).toLatin1();
+    if (id.isEmpty() || id.size() > int(sizeof(quint64)) || fileNameForId(id) != pathFragment)
+        return 0;
+    return QNetworkDiskCacheIndex::key(id);
+}
+
 /*!
     We compress small text and JavaScript files.
  */
@@ -723,4 +781,361 @@ bool QCacheItem::read(QFile *device, bool readData)
     return metaData.isValid();
 }
 
+enum
+{
+    IndexMagic = 0x49444e51, // "QNDI"
+    IndexVersion = 1,
+    MinimumIndexCapacity = 256
+};
+
+quint64 QNetworkDiskCacheIndex::key(const QByteArray &fileId)
+{
+    Q_ASSERT(!fileId.isEmpty() && fileId.size() <= int(sizeof(quint64)));
+    quint64 key = 0;
+    memcpy(&key, fileId.constData(), fileId.size());
+    return key;
+}
+
+QByteArray QNetworkDiskCacheIndex::fileId(quint64 key)
+{
+    const char *id = reinterpret_cast<const char *>(&key);
+    return QByteArray(id, int(qstrnlen(id, sizeof(key))));
+}
+
+/*!
+    Opens the index file \a fileName, or creates it from the files in
+    \a dataDirectory if it does not exist or cannot be used.
+ */
+void QNetworkDiskCacheIndex::open(const QString &fileName, const QString &dataDirectory)
+{
+    Q_ASSERT(!lockDepth);
+    close();
+#ifndef QNETWORKDISKCACHE_FLOCK
+    lockFile.reset(new QLockFile(fileName + QLatin1String(".lock")));
+#endif
+    file.setFileName(fileName);
+    // Opened before locking, as the lock may be taken on the file itself
+    file.open(QIODevice::ReadWrite);
+    const Locker locker(this);
+
+    if (file.isOpen() && file.size() >= qint64(sizeof(Header)) && map()) {
+        const Header *h = header();
+        if (h->magic == IndexMagic && h->version == IndexVersion
+            && h->capacity >= MinimumIndexCapacity && file.size() == fileSize(h->capacity)) {
+            load();
+            return;
+        }
+    }
+
+    rebuild(dataDirectory);
+}
+
+void QNetworkDiskCacheIndex::close()
+{
+    if (memory && file.isOpen())
+        file.unmap(memory);
+    memory = nullptr;
+    file.close();
+    buffer.clear();
+    capacity = 0;
+    generation = 0;
+    slotForKey.clear();
+    freeSlots.clear();
+    previous.clear();
+    next.clear();
+    head = tail = -1;
+    total = 0;
+}
+
+bool QNetworkDiskCacheIndex::map()
+{
+    memory = file.map(0, file.size());
+    return memory != nullptr;
+}
+
+bool QNetworkDiskCacheIndex::lock()
+{
+#ifdef QNETWORKDISKCACHE_FLOCK
+    // Much cheaper than a lock file, which is created and removed every time
+    if (!file.isOpen())
+        return false;
+    int result;
+    EINTR_LOOP(result, ::flock(file.handle(), LOCK_EX));
+    return result == 0;
+#else
+    return lockFile && lockFile->lock();
+#endif
+}
+
+void QNetworkDiskCacheIndex::unlock()
+{
+#ifdef QNETWORKDISKCACHE_FLOCK
+    // Closing the file while locked has released the lock already
+    if (file.isOpen())
+        ::flock(file.handle(), LOCK_UN);
+#else
+    lockFile->unlock();
+#endif
+}
+
+void QNetworkDiskCacheIndex::rebuild(const QString &dataDirectory)
+{
+    struct CacheFile
+    {
+        quint64 key;
+        qint64 size;
+        QDateTime time;
+    };
+    QVector<CacheFile> cacheFiles;
+
+    const QStringList nameFilters(QLatin1Char('*') + CACHE_POSTFIX);
+    QDirIterator it(dataDirectory, nameFilters, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QByteArray id = info.completeBaseName().toLatin1();
+        if (id.isEmpty() || id.size() > int(sizeof(quint64))
+            || QNetworkDiskCachePrivate::fileNameForId(id)
+               != info.dir().dirName() + QLatin1Char('/') + info.fileName()) {
+            continue;
+        }
+        const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
+        cacheFiles.append({key(id), info.size(), birthTime.isValid() ? birthTime
+                           : info.fileTime(QFile::FileMetadataChangeTime)});
+    }
+    std::sort(cacheFiles.begin(), cacheFiles.end(), [](const CacheFile &a, const CacheFile &b) {
+        return a.time < b.time;
+    });
+
+    quint32 newCapacity = MinimumIndexCapacity;
+    while (newCapacity < quint32(cacheFiles.size()) * 2)
+        newCapacity *= 2;
+
+    // Rewrite the file in place, so that other caches which have it mapped
+    // see the new generation and capacity and reload it
+    quint64 oldGeneration = 0;
+    if (memory) {
+        oldGeneration = header()->generation;
+        file.unmap(memory);
+        memory = nullptr;
+    }
+    if ((!file.isOpen() && !file.open(QIODevice::ReadWrite))
+        || !file.resize(fileSize(newCapacity)) || !map()) {
+        // Carry on without persisting the index
+        file.close();
+        buffer.resize(int(fileSize(newCapacity)));
+        memory = reinterpret_cast<uchar *>(buffer.data());
+    }
+
+    memset(memory, 0, size_t(fileSize(newCapacity)));
+    Header *h = header();
+    h->magic = IndexMagic;
+    h->version = IndexVersion;
+    h->capacity = newCapacity;
+    h->generation = oldGeneration + 1;
+    Entry *e = entries();
+    for (int i = 0; i < cacheFiles.size(); ++i)
+        e[i] = {cacheFiles.at(i).key, cacheFiles.at(i).size, ++h->clock};
+    load();
+}
+
+void QNetworkDiskCacheIndex::load()
+{
+    capacity = header()->capacity;
+    generation = header()->generation;
+    slotForKey.clear();
+    slotForKey.reserve(int(capacity / 2));
+    freeSlots.clear();
+    previous.fill(-1, int(capacity));
+    next.fill(-1, int(capacity));
+    head = tail = -1;
+    total = 0;
+
+    QVector<int> used;
+    Entry *e = entries();
+    // Backwards, so that the free slots are handed out from the front
+    for (int slot = int(capacity) - 1; slot >= 0; --slot) {
+        if (e[slot].key && !slotForKey.contains(e[slot].key)) {
+            slotForKey.insert(e[slot].key, slot);
+            used.append(slot);
+            total += e[slot].size;
+        } else {
+            e[slot].key = 0;
+            freeSlots.append(slot);
+        }
+    }
+
+    std::sort(used.begin(), used.end(), [e](int a, int b) {
+        return e[a].lastAccess < e[b].lastAccess;
+    });
+    for (int slot : qAsConst(used))
+        link(slot);
+}
+
+void QNetworkDiskCacheIndex::sync()
+{
+    if (!memory || (header()->generation == generation && header()->capacity == capacity))
+        return;
+
+    // Another cache using the same directory has changed the index
+    const quint32 newCapacity = header()->capacity;
+    if (newCapacity != capacity && file.isOpen()) {
+        file.unmap(memory);
+        memory = nullptr;
+        if (file.size() != fileSize(newCapacity) || !map()) {
+            close();
+            return;
+        }
+    }
+    load();
+}
+
+bool QNetworkDiskCacheIndex::grow()
+{
+    if (capacity > quint32(std::numeric_limits<int>::max() / 2))
+        return false;
+
+    const quint32 newCapacity = capacity * 2;
+    const qint64 oldSize = fileSize(capacity);
+    const qint64 newSize = fileSize(newCapacity);
+    if (file.isOpen()) {
+        // The file is zero-filled when it grows
+        file.unmap(memory);
+        memory = nullptr;
+        if (!file.resize(newSize) || !map()) {
+            // Carry on without persisting the index
+            file.seek(0);
+            buffer = file.read(oldSize);
+            file.close();
+            if (buffer.size() != oldSize) {
+                close();
+                return false;
+            }
+        }
+    }
+    if (!file.isOpen()) {
+        buffer.resize(int(newSize));
+        memory = reinterpret_cast<uchar *>(buffer.data());
+        memset(memory + oldSize, 0, size_t(newSize - oldSize));
+    }
+
+    header()->capacity = newCapacity;
+    previous.resize(int(newCapacity));
+    next.resize(int(newCapacity));
+    for (int slot = int(newCapacity) - 1; slot >= int(capacity); --slot)
+        freeSlots.append(slot);
+    capacity = newCapacity;
+    changed();
+    return true;
+}
+
+void QNetworkDiskCacheIndex::link(int slot)
+{
+    previous[slot] = -1;
+    next[slot] = head;
+    if (head >= 0)
+        previous[head] = slot;
+    else
+        tail = slot;
+    head = slot;
+}
+
+void QNetworkDiskCacheIndex::unlink(int slot)
+{
+    if (previous.at(slot) >= 0)
+        next[previous.at(slot)] = next.at(slot);
+    else
+        head = next.at(slot);
+    if (next.at(slot) >= 0)
+        previous[next.at(slot)] = previous.at(slot);
+    else
+        tail = previous.at(slot);
+}
+
+bool QNetworkDiskCacheIndex::contains(quint64 key)
+{
+    Q_ASSERT(lockDepth);
+    return slotForKey.contains(key);
+}
+
+qint64 QNetworkDiskCacheIndex::size(quint64 key)
+{
+    Q_ASSERT(lockDepth);
+    const int slot = slotForKey.value(key, -1);
+    return slot >= 0 ? entries()[slot].size : -1;
+}
+
+qint64 QNetworkDiskCacheIndex::totalSize()
+{
+    Q_ASSERT(lockDepth);
+    return total;
+}
+
+int QNetworkDiskCacheIndex::count()
+{
+    Q_ASSERT(lockDepth);
+    return slotForKey.size();
+}
+
+void QNetworkDiskCacheIndex::insert(quint64 key, qint64 size)
+{
+    Q_ASSERT(lockDepth);
+    if (!memory || !key)
+        return;
+
+    int slot = slotForKey.value(key, -1);
+    if (slot >= 0) {
+        total -= entries()[slot].size;
+        unlink(slot);
+    } else {
+        if (freeSlots.isEmpty() && !grow())
+            return;
+        slot = freeSlots.takeLast();
+        slotForKey.insert(key, slot);
+        entries()[slot].key = key;
+    }
+
+    Entry &entry = entries()[slot];
+    entry.size = size;
+    entry.lastAccess = ++header()->clock;
+    total += size;
+    link(slot);
+    changed();
+}
+
+void QNetworkDiskCacheIndex::touch(quint64 key)
+{
+    Q_ASSERT(lockDepth);
+    const int slot = slotForKey.value(key, -1);
+    if (slot < 0 || slot == head)
+        return;
+
+    unlink(slot);
+    link(slot);
+    entries()[slot].lastAccess = ++header()->clock;
+    changed();
+}
+
+void QNetworkDiskCacheIndex::remove(quint64 key)
+{
+    Q_ASSERT(lockDepth);
+    const int slot = slotForKey.value(key, -1);
+    if (slot < 0)
+        return;
+
+    unlink(slot);
+    slotForKey.remove(key);
+    freeSlots.append(slot);
+    Entry &entry = entries()[slot];
+    total -= entry.size;
+    entry = Entry();
+    changed();
+}
+
+quint64 QNetworkDiskCacheIndex::leastRecentlyUsed()
+{
+    Q_ASSERT(lockDepth);
+    return tail >= 0 ? entries()[tail].key : 0;
+}
+
 QT_END_NAMESPACE
@@ -55,15 +55,17 @@
 #include "private/qabstractnetworkcache_p.h"
 
 #include <qbuffer.h>
+#include <qfile.h>
 #include <qhash.h>
+#include <qlockfile.h>
+#include <qscopedpointer.h>
 #include <qtemporaryfile.h>
+#include <qvector.h>
 
 QT_REQUIRE_CONFIG(networkdiskcache);
 
 QT_BEGIN_NAMESPACE
 
-class QFile;
-
 class QCacheItem
 {
 public:
@@ -94,6 +96,123 @@ public:
     bool canCompress() const;
 };
 
+// Persistent index of the files in the cache's data directory, kept in a
+// memory-mapped file so that it can be opened without looking at every
+// cache file, and ordered by last access for eviction. Caches using the
+// same directory share the file; the accessors below must be called while
+// a Locker holds the lock on it.
+class QNetworkDiskCacheIndex
+{
+public:
+    class Locker;
+
+    ~QNetworkDiskCacheIndex() { close(); }
+
+    void open(const QString &fileName, const QString &dataDirectory);
+    void close();
+
+    // The file ids are the base names of the cache files
+    static quint64 key(const QByteArray &fileId);
+    static QByteArray fileId(quint64 key);
+
+    bool contains(quint64 key);
+    qint64 size(quint64 key);
+    qint64 totalSize();
+    int count();
+
+    void insert(quint64 key, qint64 size);
+    void touch(quint64 key);
+    void remove(quint64 key);
+    // Returns 0 if the index is empty
+    quint64 leastRecentlyUsed();
+
+private:
+    struct Header
+    {
+        quint32 magic;
+        quint32 version;
+        quint32 capacity;
+        quint32 reserved;
+        // Incremented on every change, to notice changes by another
+        // cache using the same directory
+        quint64 generation;
+        // The last access stamp handed out
+        quint64 clock;
+    };
+
+    struct Entry
+    {
+        quint64 key; // 0 if the slot is free
+        qint64 size;
+        quint64 lastAccess;
+    };
+
+    static qint64 fileSize(quint32 capacity)
+    { return qint64(sizeof(Header)) + qint64(capacity) * qint64(sizeof(Entry)); }
+    Header *header() const { return reinterpret_cast<Header *>(memory); }
+    Entry *entries() const { return reinterpret_cast<Entry *>(memory + sizeof(Header)); }
+
+    bool map();
+    bool lock();
+    void unlock();
+    void rebuild(const QString &dataDirectory);
+    void load();
+    void sync();
+    bool grow();
+    void changed() { generation = ++header()->generation; }
+    void link(int slot);
+    void unlink(int slot);
+
+    QFile file;
+    // Only used where the index file itself cannot be locked
+    QScopedPointer<QLockFile> lockFile;
+    // Number of Locker objects on the stack; only the outermost one locks
+    int lockDepth = 0;
+    // Used instead of the file if it cannot be mapped
+    QByteArray buffer;
+    uchar *memory = nullptr;
+    quint32 capacity = 0;
+    quint64 generation = 0;
+
+    QHash<quint64, int> slotForKey;
+    QVector<int> freeSlots;
+    // Doubly-linked list of the used slots, most recently used first
+    QVector<int> previous;
+    QVector<int> next;
+    int head = -1;
+    int tail = -1;
+    qint64 total = 0;
+};
+
+// Serializes access to the index file with other caches using the same
+// directory, and picks up the changes they made. Each public
+// QNetworkDiskCache operation holds one for its whole duration, so that
+// it sees a consistent index; nested lockers do nothing.
+class QNetworkDiskCacheIndex::Locker
+{
+public:
+    explicit Locker(QNetworkDiskCacheIndex *index)
+        : index(index)
+    {
+        if (index->lockDepth++ == 0) {
+            locked = index->lock();
+            index->sync();
+        }
+    }
+
+    ~Locker()
+    {
+        --index->lockDepth;
+        if (locked)
+            index->unlock();
+    }
+
+private:
+    Q_DISABLE_COPY(Locker)
+    QNetworkDiskCacheIndex *index;
+    bool locked = false;
+};
+
 class QNetworkDiskCachePrivate : public QAbstractNetworkCachePrivate
 {
 public:
@@ -103,8 +222,11 @@ public:
         , currentCacheSize(-1)
         {}
 
+    static QByteArray fileId(const QUrl &url);
+    static QString fileNameForId(const QByteArray &fileId);
     static QString uniqueFileName(const QUrl &url);
     QString cacheFileName(const QUrl &url) const;
+    quint64 indexKey(const QString &fileName) const;
     QString tmpCacheFileName() const;
     bool removeFile(const QString &file);
     void storeItem(QCacheItem *item);
@@ -116,6 +238,7 @@ public:
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
+    QNetworkDiskCacheIndex index;
 
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
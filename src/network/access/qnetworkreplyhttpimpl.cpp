@@ -50,6 +50,7 @@
 #include "qnetworkcookie_p.h"
 #include "QtCore/qdatetime.h"
 #include "QtCore/qelapsedtimer.h"
+#include "QtCore/qfile.h"
 #include "QtNetwork/qsslconfiguration.h"
 #include "qhttpthreaddelegate_p.h"
 #include "qhsts_p.h"
@@ -838,6 +839,7 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     // The authentication manager is used to avoid the BlockingQueuedConnection communication
     // from HTTP thread to user thread in some cases.
     delegate->authenticationManager = managerPrivate->authenticationManager;
+    delegate->connectionPool = managerPrivate->connectionPool;
 
     if (!synchronous) {
         // Tell our zerocopy policy to the delegate
@@ -942,6 +944,22 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
             QObject::connect(forwardUploadDevice, SIGNAL(resetData(bool*)),
                     q, SLOT(resetUploadDataSlot(bool*)),
                     Qt::BlockingQueuedConnection); // this is the only one with BlockingQueued!
+
+            // A local file uploaded over a plain connection is sent by the
+            // HTTP thread straight from the file descriptor, so its data
+            // does not have to be copied to the HTTP thread at all.
+            QFile *file = outgoingDataBuffer ? nullptr : qobject_cast<QFile *>(outgoingData);
+            if (!ssl && file && !file->isSequential() && file->handle() != -1) {
+                QFile *uploadFile = new QFile(delegate); // moved to the HTTP thread with it
+                if (uploadFile->open(file->handle(), QIODevice::ReadOnly, QFileDevice::DontCloseHandle)) {
+                    delegate->httpRequest.setUploadFile(uploadFile, file->pos());
+                    forwardUploadDevice->setFileBacked(true);
+                    QObject::connect(forwardUploadDevice, SIGNAL(processedFileData(qint64,qint64)),
+                                     q, SLOT(sentUploadFileDataSlot(qint64,qint64)));
+                } else {
+                    delete uploadFile;
+                }
+            }
         }
     } else if (synchronous) {
         QObject::connect(q, SIGNAL(startHttpRequestSynchronously()), delegate, SLOT(startRequestSynchronously()), Qt::BlockingQueuedConnection);
@@ -1533,6 +1551,22 @@ void QNetworkReplyHttpImplPrivate::sentUploadDataSlot(qint64 pos, qint64 amount)
     uploadByteDevicePosition += amount;
 }
 
+// Coming from QNonContiguousByteDeviceThreadForwardImpl in HTTP thread
+void QNetworkReplyHttpImplPrivate::sentUploadFileDataSlot(qint64 pos, qint64 amount)
+{
+    if (!uploadByteDevice) // uploadByteDevice is no longer available
+        return;
+
+    if (uploadByteDevicePosition + amount != pos) {
+        // Sanity check, should not happen.
+        error(QNetworkReply::UnknownNetworkError, QString());
+        return;
+    }
+    // The data was sent from the file, our device was never read
+    uploadByteDevicePosition += amount;
+    emitReplyUploadProgress(uploadByteDevicePosition, uploadByteDevice->size());
+}
+
 // Coming from QNonContiguousByteDeviceThreadForwardImpl in HTTP thread
 void QNetworkReplyHttpImplPrivate::wantUploadDataSlot(qint64 maxSize)
 {
@@ -36,6 +36,11 @@ qtConfig(dnslookup) {
                kernel/qdnslookup_p.h
 
     SOURCES += kernel/qdnslookup.cpp
+
+    qtConfig(udpsocket) {
+        HEADERS += kernel/qdnshostresolver_p.h
+        SOURCES += kernel/qdnshostresolver.cpp
+    }
 }
 
 unix {
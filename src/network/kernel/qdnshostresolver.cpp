@@ -0,0 +1,644 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdnshostresolver_p.h"
+#include "qhostinfo_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qrandom.h>
+#include <QtCore/qurl.h>
+#include <QtNetwork/qnetworkdatagram.h>
+#include <QtNetwork/qtcpsocket.h>
+#include <QtNetwork/qudpsocket.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+enum : quint16 {
+    TypeA = 1,
+    TypeCNAME = 5,
+    TypeSOA = 6,
+    TypeAAAA = 28,
+    ClassIN = 1
+};
+
+enum : quint16 {
+    FlagResponse = 0x8000,
+    FlagTruncated = 0x0200,
+    FlagRecursionDesired = 0x0100
+};
+
+enum {
+    HeaderSize = 12,
+    RcodeNoError = 0,
+    RcodeNameError = 3,
+    // RFC 1035, 2.3.4
+    MaxLabelLength = 63,
+    MaxNameLength = 253,
+    // Timer granularity for the query deadlines
+    TimerInterval = 100
+};
+
+void appendUInt16(QByteArray *message, quint16 value)
+{
+    message->append(char(value >> 8));
+    message->append(char(value & 0xff));
+}
+
+QByteArray buildQuery(quint16 id, const QByteArray &name, quint16 type)
+{
+    QByteArray message;
+    message.reserve(HeaderSize + name.size() + 6);
+    appendUInt16(&message, id);
+    appendUInt16(&message, FlagRecursionDesired);
+    appendUInt16(&message, 1); // QDCOUNT
+    appendUInt16(&message, 0); // ANCOUNT
+    appendUInt16(&message, 0); // NSCOUNT
+    appendUInt16(&message, 0); // ARCOUNT
+    for (const QByteArray &label : name.split('.')) {
+        message.append(char(label.size()));
+        message.append(label);
+    }
+    message.append('\0');
+    appendUInt16(&message, type);
+    appendUInt16(&message, ClassIN);
+    return message;
+}
+
+quint16 readUInt16(const QByteArray &message, int offset)
+{
+    return qFromBigEndian<quint16>(message.constData() + offset);
+}
+
+quint32 readUInt32(const QByteArray &message, int offset)
+{
+    return qFromBigEndian<quint32>(message.constData() + offset);
+}
+
+// Reads a (possibly compressed) domain name starting at 'offset',
+// leaves 'offset' just after the name in the record.
+bool readName(const QByteArray &message, int *offset, QByteArray *name)
+{
+    name->clear();
+    int pos = *offset;
+    int next = -1;
+    // Each pointer must go back, so this is enough to detect loops:
+    int limit = pos;
+    while (true) {
+        if (pos >= message.size())
+            return false;
+        const uchar length = uchar(message.at(pos));
+        if ((length & 0xc0) == 0xc0) {
+            if (pos + 1 >= message.size())
+                return false;
+            const int target = ((length & 0x3f) << 8) | uchar(message.at(pos + 1));
+            if (target >= limit)
+                return false;
+            if (next < 0)
+                next = pos + 2;
+            pos = limit = target;
+            continue;
+        }
+        if (length & 0xc0)
+            return false;
+        ++pos;
+        if (!length)
+            break;
+        if (pos + length > message.size() || name->size() + length + 1 > 255)
+            return false;
+        if (!name->isEmpty())
+            name->append('.');
+        name->append(message.constData() + pos, length);
+        pos += length;
+    }
+    *offset = next < 0 ? pos : next;
+    return true;
+}
+
+struct ResourceRecord
+{
+    QByteArray name;
+    quint16 type;
+    quint16 rrClass;
+    quint32 ttl;
+    int dataOffset;
+    quint16 dataLength;
+};
+
+bool readRecord(const QByteArray &message, int *offset, ResourceRecord *record)
+{
+    if (!readName(message, offset, &record->name) || *offset + 10 > message.size())
+        return false;
+    record->type = readUInt16(message, *offset);
+    record->rrClass = readUInt16(message, *offset + 2);
+    // RFC 2181, 8: a TTL with the most significant bit set is zero
+    record->ttl = readUInt32(message, *offset + 4);
+    if (record->ttl > quint32(std::numeric_limits<qint32>::max()))
+        record->ttl = 0;
+    record->dataLength = readUInt16(message, *offset + 8);
+    record->dataOffset = *offset + 10;
+    *offset = record->dataOffset + record->dataLength;
+    return *offset <= message.size();
+}
+
+bool sameName(const QByteArray &name1, const QByteArray &name2)
+{
+    return name1.compare(name2, Qt::CaseInsensitive) == 0;
+}
+
+} // unnamed namespace
+
+QDnsHostResolver::QDnsHostResolver(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QDnsHostResolver::~QDnsHostResolver()
+{
+    for (Query *query : qAsConst(pendingQueries)) {
+        Lookup *lookup = query->lookup;
+        // Both queries of a lookup may be pending
+        if (!query->finished) {
+            query->finished = true;
+            if (lookup->queries[0].finished && lookup->queries[1].finished)
+                delete lookup;
+        }
+    }
+}
+
+QDnsHostResolver::Configuration QDnsHostResolver::systemConfiguration()
+{
+    Configuration configuration;
+#ifdef Q_OS_UNIX
+    QFile resolvconf(QStringLiteral("/etc/resolv.conf"));
+    if (!resolvconf.open(QIODevice::ReadOnly))
+        return configuration;
+
+    while (!resolvconf.atEnd()) {
+        const QByteArray line = resolvconf.readLine().simplified();
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';'))
+            continue;
+        const QList<QByteArray> fields = line.split(' ');
+        if (fields.at(0) == "nameserver" && fields.size() > 1) {
+            QHostAddress address;
+            if (address.setAddress(QString::fromLatin1(fields.at(1))))
+                configuration.nameservers.append({address, 53});
+        } else if (fields.at(0) == "options") {
+            for (const QByteArray &option : fields) {
+                bool ok = false;
+                if (option.startsWith("timeout:")) {
+                    const int timeout = option.mid(8).toInt(&ok);
+                    if (ok)
+                        configuration.timeout = qBound(1, timeout, 30) * 1000;
+                } else if (option.startsWith("attempts:")) {
+                    const int attempts = option.mid(9).toInt(&ok);
+                    if (ok)
+                        configuration.attempts = qBound(1, attempts, 5);
+                }
+            }
+        }
+    }
+#endif
+    return configuration;
+}
+
+bool QDnsHostResolver::canResolve(const QString &name)
+{
+    if (QHostAddress(name).protocol() != QAbstractSocket::UnknownNetworkLayerProtocol)
+        return false;
+
+    QStringRef host(&name);
+    if (host.endsWith(QLatin1Char('.')))
+        host.chop(1);
+    // Names without a dot are looked up using the search list
+    if (!host.contains(QLatin1Char('.')))
+        return false;
+    return !host.endsWith(QLatin1String(".localhost"), Qt::CaseInsensitive);
+}
+
+void QDnsHostResolver::lookup(const QString &name, const Configuration &configuration,
+                              Callback callback)
+{
+    Q_ASSERT(callback);
+
+    QByteArray aceName = QUrl::toAce(name);
+    if (aceName.endsWith('.'))
+        aceName.chop(1);
+
+    bool valid = !aceName.isEmpty() && aceName.size() <= MaxNameLength;
+    for (int start = 0; valid && start <= aceName.size();) {
+        int end = aceName.indexOf('.', start);
+        if (end < 0)
+            end = aceName.size();
+        valid = end > start && end - start <= MaxLabelLength;
+        start = end + 1;
+    }
+
+    if (!valid || configuration.nameservers.isEmpty()) {
+        QHostInfo results;
+        results.setHostName(name);
+        if (valid) {
+            results.setError(QHostInfo::UnknownError);
+            results.setErrorString(QCoreApplication::translate("QHostInfoAgent",
+                                                               "No name servers configured"));
+        } else {
+            results.setError(QHostInfo::HostNotFound);
+            results.setErrorString(QCoreApplication::translate("QHostInfoAgent", "Invalid hostname"));
+        }
+        callback(results);
+        return;
+    }
+
+    Lookup *lookup = new Lookup;
+    lookup->name = name;
+    lookup->aceName = aceName;
+    lookup->configuration = configuration;
+    lookup->callback = std::move(callback);
+
+    const quint16 types[] = {TypeA, TypeAAAA};
+    for (int i = 0; i < 2; ++i) {
+        Query &query = lookup->queries[i];
+        query.lookup = lookup;
+        query.type = types[i];
+        do {
+            query.id = quint16(QRandomGenerator::global()->generate());
+        } while (pendingQueries.contains(query.id));
+        pendingQueries.insert(query.id, &query);
+    }
+
+    for (Query &query : lookup->queries)
+        send(query);
+
+    if (!timer.isActive())
+        timer.start(TimerInterval, Qt::CoarseTimer, this);
+}
+
+void QDnsHostResolver::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    const QList<quint16> ids = pendingQueries.keys();
+    for (quint16 id : ids) {
+        // An earlier query's lookup may have finished this one
+        Query *query = pendingQueries.value(id);
+        if (!query || !query->deadline.hasExpired())
+            continue;
+        retryOrFail(*query);
+    }
+
+    if (pendingQueries.isEmpty())
+        timer.stop();
+}
+
+const QDnsHostResolver::Nameserver &QDnsHostResolver::currentNameserver(const Query &query) const
+{
+    // Attempts go round the list of name servers
+    const QVector<Nameserver> &nameservers = query.lookup->configuration.nameservers;
+    return nameservers.at((query.transmissions - 1) % nameservers.size());
+}
+
+void QDnsHostResolver::send(Query &query)
+{
+    ++query.transmissions;
+    query.deadline.setRemainingTime(query.lookup->configuration.timeout, Qt::CoarseTimer);
+
+    // RFC 5452, 9.2: every transmission comes from a new socket, bound to
+    // a port the system picks at random, so that a spoofed answer has to
+    // guess the port as well as the ID
+    if (query.udpSocket) {
+        query.udpSocket->disconnect(this);
+        query.udpSocket->deleteLater();
+    }
+    const Nameserver &nameserver = currentNameserver(query);
+    const bool ipv6 = nameserver.address.protocol() == QAbstractSocket::IPv6Protocol;
+    query.udpSocket = new QUdpSocket(this);
+    query.udpSocket->bind(ipv6 ? QHostAddress(QHostAddress::AnyIPv6)
+                               : QHostAddress(QHostAddress::AnyIPv4));
+    connect(query.udpSocket, SIGNAL(readyRead()), this, SLOT(_q_readDatagrams()));
+
+    const QByteArray message = buildQuery(query.id, query.lookup->aceName, query.type);
+    query.udpSocket->writeDatagram(message, nameserver.address, nameserver.port);
+}
+
+void QDnsHostResolver::sendOverTcp(Query &query)
+{
+    // RFC 7766: retry the truncated query over TCP, with the same name server
+    query.deadline.setRemainingTime(query.lookup->configuration.timeout, Qt::CoarseTimer);
+    query.tcpBuffer.clear();
+    query.tcpSocket = new QTcpSocket(this);
+
+    const QByteArray message = buildQuery(query.id, query.lookup->aceName, query.type);
+    QTcpSocket *socket = query.tcpSocket;
+    const quint16 id = query.id;
+    connect(socket, &QTcpSocket::connected, this, [socket, message] {
+        QByteArray prefixed;
+        appendUInt16(&prefixed, quint16(message.size()));
+        socket->write(prefixed + message);
+    });
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket, id] {
+        Query *query = pendingQueries.value(id);
+        if (!query || query->tcpSocket != socket)
+            return;
+        query->tcpBuffer += socket->readAll();
+        if (query->tcpBuffer.size() < 2)
+            return;
+        const int length = readUInt16(query->tcpBuffer, 0);
+        if (query->tcpBuffer.size() < 2 + length)
+            return;
+        processResponse(*query, query->tcpBuffer.mid(2, length), true);
+    });
+    connect(socket, &QAbstractSocket::errorOccurred, this, [this, socket, id] {
+        Query *query = pendingQueries.value(id);
+        if (query && query->tcpSocket == socket)
+            retryOrFail(*query);
+    });
+
+    const Nameserver &nameserver = currentNameserver(query);
+    socket->connectToHost(nameserver.address, nameserver.port);
+}
+
+void QDnsHostResolver::_q_readDatagrams()
+{
+    QUdpSocket *socket = qobject_cast<QUdpSocket *>(sender());
+    Q_ASSERT(socket);
+
+    while (socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = socket->receiveDatagram();
+        const QByteArray response = datagram.data();
+        if (response.size() < HeaderSize)
+            continue;
+
+        Query *query = pendingQueries.value(readUInt16(response, 0));
+        if (!query || query->udpSocket != socket || query->tcpSocket)
+            continue;
+
+        // Only accept answers from the server we asked
+        const Nameserver &nameserver = currentNameserver(*query);
+        if (!datagram.senderAddress().isEqual(nameserver.address, QHostAddress::TolerantConversion)
+            || datagram.senderPort() != nameserver.port) {
+            continue;
+        }
+
+        processResponse(*query, response, false);
+    }
+}
+
+void QDnsHostResolver::processResponse(Query &query, const QByteArray &response, bool overTcp)
+{
+    QList<QHostAddress> addresses;
+    int ttl = -1;
+    switch (parseResponse(response, query, &addresses, &ttl)) {
+    case Status::Truncated:
+        if (!overTcp) {
+            sendOverTcp(query);
+            return;
+        }
+        // Nothing can be larger than a TCP message: the answer is incomplete
+        retryOrFail(query);
+        return;
+    case Status::Answer:
+        query.answered = true;
+        query.addresses = addresses;
+        query.ttl = ttl;
+        finishQuery(query);
+        return;
+    case Status::NameError:
+        query.answered = true;
+        query.nameError = true;
+        query.ttl = ttl;
+        finishQuery(query);
+        return;
+    case Status::ServerFailure:
+        retryOrFail(query);
+        return;
+    case Status::Malformed:
+        // Ignore it, the right answer may still arrive
+        if (overTcp)
+            retryOrFail(query);
+        return;
+    }
+}
+
+void QDnsHostResolver::retryOrFail(Query &query)
+{
+    if (query.tcpSocket) {
+        query.tcpSocket->disconnect(this);
+        query.tcpSocket->deleteLater();
+        query.tcpSocket = nullptr;
+    }
+
+    const Configuration &configuration = query.lookup->configuration;
+    if (query.transmissions < configuration.attempts * configuration.nameservers.size())
+        send(query);
+    else
+        finishQuery(query);
+}
+
+void QDnsHostResolver::closeSockets(Query &query)
+{
+    if (query.udpSocket) {
+        query.udpSocket->disconnect(this);
+        query.udpSocket->deleteLater();
+        query.udpSocket = nullptr;
+    }
+    if (query.tcpSocket) {
+        query.tcpSocket->disconnect(this);
+        query.tcpSocket->deleteLater();
+        query.tcpSocket = nullptr;
+    }
+}
+
+void QDnsHostResolver::finishQuery(Query &query)
+{
+    closeSockets(query);
+    query.finished = true;
+    pendingQueries.remove(query.id);
+
+    Lookup *lookup = query.lookup;
+    const Query &ipv4 = lookup->queries[0];
+    const Query &ipv6 = lookup->queries[1];
+    if (!ipv4.finished || !ipv6.finished)
+        return;
+
+    QHostInfo results;
+    results.setHostName(lookup->name);
+    results.setAddresses(ipv4.addresses + ipv6.addresses);
+
+    // The results are valid as long as all records they were built from are.
+    int ttl = -1;
+    auto addTtl = [&ttl](int queryTtl) {
+        if (queryTtl >= 0)
+            ttl = ttl < 0 ? queryTtl : qMin(ttl, queryTtl);
+    };
+
+    if (!results.addresses().isEmpty()) {
+        for (const Query &query : lookup->queries) {
+            if (!query.addresses.isEmpty())
+                addTtl(query.ttl);
+        }
+    } else if (ipv4.nameError || ipv6.nameError || (ipv4.answered && ipv6.answered)) {
+        // NXDOMAIN or no address records (RFC 2308 negative answers)
+        for (const Query &query : lookup->queries) {
+            if (query.answered)
+                addTtl(query.ttl);
+        }
+        results.setError(QHostInfo::HostNotFound);
+        results.setErrorString(QCoreApplication::translate("QHostInfoAgent", "Host not found"));
+    } else {
+        results.setError(QHostInfo::UnknownError);
+        results.setErrorString(QCoreApplication::translate("QHostInfoAgent",
+                                                           "Temporary failure in name resolution"));
+    }
+    QHostInfoPrivate::setTimeToLive(results, ttl);
+
+    const Callback callback = std::move(lookup->callback);
+    delete lookup;
+    callback(results);
+}
+
+QDnsHostResolver::Status QDnsHostResolver::parseResponse(const QByteArray &response,
+                                                         const Query &query,
+                                                         QList<QHostAddress> *addresses,
+                                                         int *ttl)
+{
+    if (response.size() < HeaderSize || readUInt16(response, 0) != query.id)
+        return Status::Malformed;
+
+    const quint16 flags = readUInt16(response, 2);
+    // A response to a standard query
+    if (!(flags & FlagResponse) || (flags & 0x7800))
+        return Status::Malformed;
+    if (flags & FlagTruncated)
+        return Status::Truncated;
+
+    const int rcode = flags & 0xf;
+    if (rcode != RcodeNoError && rcode != RcodeNameError)
+        return Status::ServerFailure;
+
+    // The question must be ours
+    if (readUInt16(response, 4) != 1)
+        return Status::Malformed;
+    const int answerCount = readUInt16(response, 6);
+    const int authorityCount = readUInt16(response, 8);
+
+    int offset = HeaderSize;
+    QByteArray name;
+    if (!readName(response, &offset, &name) || offset + 4 > response.size()
+        || !sameName(name, query.lookup->aceName) || readUInt16(response, offset) != query.type
+        || readUInt16(response, offset + 2) != ClassIN) {
+        return Status::Malformed;
+    }
+    offset += 4;
+
+    QVector<ResourceRecord> answers;
+    answers.reserve(answerCount);
+    for (int i = 0; i < answerCount; ++i) {
+        ResourceRecord record;
+        if (!readRecord(response, &offset, &record))
+            return Status::Malformed;
+        if (record.rrClass == ClassIN)
+            answers.append(record);
+    }
+
+    // Follow the CNAME chain from the name we asked for
+    QByteArray owner = query.lookup->aceName;
+    quint32 minimumTtl = std::numeric_limits<quint32>::max();
+    for (int hops = 0; hops < 16; ++hops) {
+        auto it = std::find_if(answers.cbegin(), answers.cend(), [&owner](const ResourceRecord &r) {
+            return r.type == TypeCNAME && sameName(r.name, owner);
+        });
+        if (it == answers.cend())
+            break;
+        int dataOffset = it->dataOffset;
+        if (!readName(response, &dataOffset, &owner))
+            return Status::Malformed;
+        minimumTtl = qMin(minimumTtl, it->ttl);
+    }
+
+    for (const ResourceRecord &record : qAsConst(answers)) {
+        if (record.type != query.type || !sameName(record.name, owner))
+            continue;
+        if (record.type == TypeA && record.dataLength == 4) {
+            addresses->append(QHostAddress(readUInt32(response, record.dataOffset)));
+        } else if (record.type == TypeAAAA && record.dataLength == 16) {
+            addresses->append(QHostAddress(reinterpret_cast<const quint8 *>(
+                                               response.constData() + record.dataOffset)));
+        } else {
+            continue;
+        }
+        minimumTtl = qMin(minimumTtl, record.ttl);
+    }
+
+    if (addresses->isEmpty()) {
+        // RFC 2308, 5: negative answers are cached for the SOA's
+        // MINIMUM field or its TTL, whichever is less.
+        minimumTtl = std::numeric_limits<quint32>::max();
+        for (int i = 0; i < authorityCount; ++i) {
+            ResourceRecord record;
+            if (!readRecord(response, &offset, &record))
+                break;
+            if (record.type != TypeSOA)
+                continue;
+            int dataOffset = record.dataOffset;
+            if (readName(response, &dataOffset, &name) && readName(response, &dataOffset, &name)
+                && dataOffset + 20 <= record.dataOffset + record.dataLength) {
+                minimumTtl = qMin(record.ttl, readUInt32(response, dataOffset + 16));
+            }
+            break;
+        }
+    }
+
+    if (minimumTtl != std::numeric_limits<quint32>::max())
+        *ttl = int(qMin(minimumTtl, quint32(std::numeric_limits<qint32>::max())));
+
+    return rcode == RcodeNameError ? Status::NameError : Status::Answer;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qdnshostresolver_p.cpp"
@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDNSHOSTRESOLVER_P_H
+#define QDNSHOSTRESOLVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QHostInfo class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include "QtCore/qbasictimer.h"
+#include "QtCore/qdeadlinetimer.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qobject.h"
+#include "QtCore/qvector.h"
+#include "QtNetwork/qhostaddress.h"
+#include "QtNetwork/qhostinfo.h"
+
+#include <functional>
+
+QT_REQUIRE_CONFIG(dnslookup);
+QT_REQUIRE_CONFIG(udpsocket);
+
+QT_BEGIN_NAMESPACE
+
+class QTcpSocket;
+class QUdpSocket;
+
+// Resolves host names by sending A and AAAA queries to the name servers
+// directly (over UDP, retrying over TCP if the answer was truncated),
+// without blocking a thread per lookup. The results carry the TTL of
+// the records they were built from.
+class QDnsHostResolver : public QObject
+{
+    Q_OBJECT
+public:
+    struct Nameserver
+    {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    struct Configuration
+    {
+        QVector<Nameserver> nameservers;
+        int timeout = 5000; // msecs, per attempt
+        int attempts = 2;   // per name server
+    };
+
+    using Callback = std::function<void(const QHostInfo &)>;
+
+    explicit QDnsHostResolver(QObject *parent = nullptr);
+    ~QDnsHostResolver();
+
+    // The name servers and options from the system's resolver configuration
+    static Configuration systemConfiguration();
+    // Names that need the system resolver (IP addresses, 'localhost',
+    // names subject to the search list) are not resolved here
+    static bool canResolve(const QString &name);
+
+    // Must be called in the resolver's thread, 'callback' is invoked in it
+    // when the lookup is done (possibly from within this function).
+    void lookup(const QString &name, const Configuration &configuration, Callback callback);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private Q_SLOTS:
+    void _q_readDatagrams();
+
+private:
+    struct Lookup;
+
+    struct Query
+    {
+        Lookup *lookup = nullptr;
+        quint16 type = 0;
+        quint16 id = 0;
+        int transmissions = 0;
+        QDeadlineTimer deadline;
+        QUdpSocket *udpSocket = nullptr;
+        QTcpSocket *tcpSocket = nullptr;
+        QByteArray tcpBuffer;
+        bool finished = false;
+        bool answered = false;
+        bool nameError = false;
+        QList<QHostAddress> addresses;
+        int ttl = -1;
+    };
+
+    struct Lookup
+    {
+        QString name;
+        QByteArray aceName;
+        Configuration configuration;
+        Callback callback;
+        Query queries[2];
+    };
+
+    enum class Status {
+        Answer,
+        NameError,
+        Truncated,
+        ServerFailure,
+        Malformed
+    };
+
+    static Status parseResponse(const QByteArray &response, const Query &query,
+                                QList<QHostAddress> *addresses, int *ttl);
+
+    const Nameserver &currentNameserver(const Query &query) const;
+    void send(Query &query);
+    void sendOverTcp(Query &query);
+    void processResponse(Query &query, const QByteArray &response, bool overTcp);
+    void retryOrFail(Query &query);
+    void finishQuery(Query &query);
+    void closeSockets(Query &query);
+
+    QHash<quint16, Query *> pendingQueries;
+    QBasicTimer timer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDNSHOSTRESOLVER_P_H
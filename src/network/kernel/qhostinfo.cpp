@@ -242,6 +242,16 @@ bool QHostInfoResult::event(QEvent *event)
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
     for performance improvements.
+    \note Since Qt 5.15 results are kept in the cache no longer than the
+    time to live of the DNS records they were built from (when known), and
+    failed lookups for names that do not exist are cached as well, for a
+    shorter time.
+
+    By default, lookupHost() calls the operating system's resolver in a
+    pool of threads, so each lookup in progress occupies a thread. With
+    setResolverMode(DnsResolver), QHostInfo sends the queries to the name
+    servers itself and waits for the answers without blocking any thread.
+    Concurrent lookups of the same name are always combined into one.
 
     \sa QAbstractSocket, {http://www.rfc-editor.org/rfc/rfc3492.txt}{RFC 3492},
     {https://tools.ietf.org/html/rfc6724}{RFC 6724}
@@ -771,6 +781,104 @@ QString QHostInfo::localHostName()
     \sa hostName()
 */
 
+/*!
+    \enum QHostInfo::ResolverMode
+    \since 5.15
+
+    This enum describes how lookupHost() resolves host names.
+
+    \value SystemResolver The name is resolved by the operating system's
+           resolver (for example, \c getaddrinfo()) in a pool of threads.
+           This is the default.
+    \value DnsResolver The A and AAAA records of the name are queried
+           from the name servers directly, over UDP (or TCP if the answer
+           does not fit into a datagram), without occupying a thread for
+           each lookup. The results are cached according to the records'
+           time to live. IP addresses, \c localhost and names without a
+           dot (which are subject to the resolver's search list) are still
+           resolved by the operating system, as are all names if no name
+           server is known.
+
+    \sa setResolverMode(), setNameserver()
+*/
+
+/*!
+    \since 5.15
+
+    Sets the way lookupHost() resolves host names to \a mode. The mode
+    applies to the lookups started after this call; fromName() always
+    uses the operating system's resolver.
+
+    In the DnsResolver mode, the name servers configured with
+    setNameserver() are used or, if none was set, the ones from the
+    system's resolver configuration (\c /etc/resolv.conf on Unix systems,
+    which is read when this function is called). If Qt was built without
+    support for QDnsLookup or QUdpSocket, DnsResolver behaves like
+    SystemResolver.
+
+    \sa resolverMode(), setNameserver()
+*/
+void QHostInfo::setResolverMode(ResolverMode mode)
+{
+    if (QHostInfoLookupManager *manager = theHostInfoLookupManager())
+        manager->setResolverMode(mode);
+}
+
+/*!
+    \since 5.15
+
+    Returns the way lookupHost() resolves host names.
+
+    \sa setResolverMode()
+*/
+QHostInfo::ResolverMode QHostInfo::resolverMode()
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    return manager ? manager->resolverMode() : SystemResolver;
+}
+
+/*!
+    \since 5.15
+
+    Sets the name server used in the DnsResolver mode to \a nameserver,
+    listening on \a port. A null address restores the system's name
+    servers.
+
+    \sa nameserver(), nameserverPort(), setResolverMode()
+*/
+void QHostInfo::setNameserver(const QHostAddress &nameserver, quint16 port)
+{
+    if (QHostInfoLookupManager *manager = theHostInfoLookupManager())
+        manager->setNameserver(nameserver, port);
+}
+
+/*!
+    \since 5.15
+
+    Returns the name server set with setNameserver(), or a null address
+    if the system's name servers are used.
+
+    \sa nameserverPort()
+*/
+QHostAddress QHostInfo::nameserver()
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    return manager ? manager->nameserver() : QHostAddress();
+}
+
+/*!
+    \since 5.15
+
+    Returns the port of the name server set with setNameserver().
+
+    \sa nameserver()
+*/
+quint16 QHostInfo::nameserverPort()
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    return manager ? manager->nameserverPort() : 53;
+}
+
 // ### Qt 6 merge with function below
 int QHostInfo::lookupHostImpl(const QString &name,
                               const QObject *receiver,
@@ -889,6 +997,15 @@ void QHostInfoRunnable::run()
         hostInfo = QHostInfoAgent::fromName(toBeLookedUp);
     }
 
+    postResults(hostInfo);
+    // thread goes back to QThreadPool
+}
+
+// Delivers the results of this lookup and the ones postponed for the same name
+void QHostInfoRunnable::postResults(QHostInfo hostInfo)
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+
     // check aborted again
     if (manager->wasAborted(id))
         return;
@@ -913,16 +1030,19 @@ void QHostInfoRunnable::run()
         }
         manager->postponedLookups.erase(partitionBegin, partitionEnd);
     }
-
 #endif
-    // thread goes back to QThreadPool
 }
 
 QHostInfoLookupManager::QHostInfoLookupManager() : wasDeleted(false)
 {
 #if QT_CONFIG(thread)
     QObject::connect(QCoreApplication::instance(), &QObject::destroyed,
-                     &threadPool, [&](QObject *) { threadPool.waitForDone(); },
+                     &threadPool, [&](QObject *) {
+                         threadPool.waitForDone();
+#if QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+                         stopDnsResolver();
+#endif
+                     },
                      Qt::DirectConnection);
     threadPool.setMaxThreadCount(20); // do up to 20 DNS lookups in parallel
 #endif
@@ -936,6 +1056,9 @@ QHostInfoLookupManager::~QHostInfoLookupManager()
 
     // don't qDeleteAll currentLookups, the QThreadPool has ownership
     clear();
+#if QT_CONFIG(thread) && QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+    stopDnsResolver();
+#endif
 }
 
 void QHostInfoLookupManager::clear()
@@ -998,14 +1121,20 @@ void QHostInfoLookupManager::rescheduleWithMutexHeld()
                                        isAlreadyRunning).second,
                            scheduledLookups.end());
 
-    const int availableThreads = threadPool.maxThreadCount() - currentLookups.size();
+    int maxLookups = threadPool.maxThreadCount();
+#if QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+    // DNS lookups do not occupy a thread
+    if (currentResolverMode == QHostInfo::DnsResolver && !dnsConfiguration.nameservers.isEmpty())
+        maxLookups = MaxDnsLookups;
+#endif
+    const int availableThreads = maxLookups - currentLookups.size();
     if (availableThreads > 0) {
         int readyToStartCount = qMin(availableThreads, scheduledLookups.size());
         auto it = scheduledLookups.begin();
         while (readyToStartCount--) {
             // runnable now running in new thread, track this in currentLookups
-            threadPool.start(*it);
-            currentLookups.push_back(std::move(*it));
+            currentLookups.push_back(*it);
+            startLookup(*it);
             ++it;
         }
         scheduledLookups.erase(scheduledLookups.begin(), it);
@@ -1016,6 +1145,147 @@ void QHostInfoLookupManager::rescheduleWithMutexHeld()
 #endif
 }
 
+#if QT_CONFIG(thread)
+// assumes mutex is locked by caller
+void QHostInfoLookupManager::startLookup(QHostInfoRunnable *r)
+{
+#if QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+    if (currentResolverMode == QHostInfo::DnsResolver && !dnsConfiguration.nameservers.isEmpty()
+        && QDnsHostResolver::canResolve(r->toBeLookedUp)) {
+        if (!dnsResolver) {
+            dnsThread = new QThread;
+            dnsThread->setObjectName(QStringLiteral("QHostInfo DNS resolver"));
+            dnsResolver = new QDnsHostResolver;
+            dnsResolver->moveToThread(dnsThread);
+            // The resolver's sockets must be destroyed in its thread, which
+            // may happen after the application object is gone and no
+            // events are delivered any more
+            QDnsHostResolver *resolver = dnsResolver;
+            QObject::connect(dnsThread, &QThread::finished, [resolver] { delete resolver; });
+            dnsThread->start();
+        }
+        // stopDnsResolver() may reset dnsResolver before this runs
+        QDnsHostResolver *resolver = dnsResolver;
+        const QDnsHostResolver::Configuration configuration = dnsConfiguration;
+        dnsLookups.append(r);
+        QMetaObject::invokeMethod(resolver, [this, resolver, r, configuration] {
+            startDnsLookup(resolver, r, configuration);
+        }, Qt::QueuedConnection);
+        return;
+    }
+#endif
+    threadPool.start(r);
+}
+
+#if QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+// called in the resolver's thread, does what QHostInfoRunnable::run() does
+void QHostInfoLookupManager::startDnsLookup(QDnsHostResolver *resolver, QHostInfoRunnable *r,
+                                            const QDnsHostResolver::Configuration &configuration)
+{
+    auto finish = [this, r] {
+        {
+            QMutexLocker locker(&mutex);
+            dnsLookups.removeOne(r);
+        }
+        lookupFinished(r);
+        delete r;
+    };
+
+    if (wasAborted(r->id)) {
+        finish();
+        return;
+    }
+
+    if (cache.isEnabled()) {
+        bool valid = false;
+        const QHostInfo hostInfo = cache.get(r->toBeLookedUp, &valid);
+        if (valid) {
+            r->postResults(hostInfo);
+            finish();
+            return;
+        }
+    }
+
+    resolver->lookup(r->toBeLookedUp, configuration, [this, r, finish](const QHostInfo &hostInfo) {
+        if (cache.isEnabled())
+            cache.put(r->toBeLookedUp, hostInfo);
+        r->postResults(hostInfo);
+        finish();
+    });
+}
+
+// assumes mutex is locked by caller
+void QHostInfoLookupManager::updateDnsConfiguration()
+{
+    dnsConfiguration = QDnsHostResolver::systemConfiguration();
+    if (!configuredNameserver.isNull())
+        dnsConfiguration.nameservers = {{configuredNameserver, configuredNameserverPort}};
+}
+
+void QHostInfoLookupManager::stopDnsResolver()
+{
+    QMutexLocker locker(&mutex);
+    QThread *thread = qExchange(dnsThread, nullptr);
+    dnsResolver = nullptr;
+    locker.unlock();
+
+    if (!thread)
+        return;
+    thread->quit();
+    thread->wait();
+    delete thread;
+
+    // The lookups still queued for or in progress in the resolver were
+    // dropped with it. This is only called once the thread pool is done,
+    // so no other lookup is in progress either.
+    locker.relock();
+    const QList<QHostInfoRunnable *> dropped = qExchange(dnsLookups, {});
+    currentLookups.clear();
+    locker.unlock();
+    qDeleteAll(dropped);
+}
+#endif // QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+#endif // QT_CONFIG(thread)
+
+void QHostInfoLookupManager::setResolverMode(QHostInfo::ResolverMode mode)
+{
+    QMutexLocker locker(&mutex);
+    currentResolverMode = mode;
+#if QT_CONFIG(thread) && QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+    if (mode == QHostInfo::DnsResolver)
+        updateDnsConfiguration();
+#endif
+}
+
+QHostInfo::ResolverMode QHostInfoLookupManager::resolverMode()
+{
+    QMutexLocker locker(&mutex);
+    return currentResolverMode;
+}
+
+void QHostInfoLookupManager::setNameserver(const QHostAddress &address, quint16 port)
+{
+    QMutexLocker locker(&mutex);
+    configuredNameserver = address;
+    configuredNameserverPort = port;
+#if QT_CONFIG(thread) && QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+    if (currentResolverMode == QHostInfo::DnsResolver)
+        updateDnsConfiguration();
+#endif
+}
+
+QHostAddress QHostInfoLookupManager::nameserver()
+{
+    QMutexLocker locker(&mutex);
+    return configuredNameserver;
+}
+
+quint16 QHostInfoLookupManager::nameserverPort()
+{
+    QMutexLocker locker(&mutex);
+    return configuredNameserverPort;
+}
+
 // called by QHostInfo
 void QHostInfoLookupManager::scheduleLookup(QHostInfoRunnable *r)
 {
@@ -1094,9 +1364,10 @@ QHostInfo qt_qhostinfo_lookup(const QString &name, QObject *receiver, const char
     QHostInfoLookupManager* manager = theHostInfoLookupManager();
     if (manager && manager->cache.isEnabled()) {
         QHostInfo info = manager->cache.get(name, valid);
-        if (*valid) {
+        // Failures are reported asynchronously, as if there was no cache
+        if (*valid && info.error() == QHostInfo::NoError)
             return info;
-        }
+        *valid = false;
     }
 
     // was not in cache, trigger lookup
@@ -1133,9 +1404,10 @@ void qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolut
 }
 #endif
 
-// cache for 60 seconds
+// cache for 60 seconds (or the TTL, if shorter)
+// cache failures for 10 seconds (or the negative TTL)
 // cache 128 items
-QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
+QHostInfoCache::QHostInfoCache() : max_age(60), negative_max_age(10), enabled(true), cache(128)
 {
 #ifdef QT_QHOSTINFO_CACHE_DISABLED_BY_DEFAULT
     enabled.store(false, std::memory_order_relaxed);
@@ -1148,7 +1420,7 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 
     *valid = false;
     if (QHostInfoCacheElement *element = cache.object(name)) {
-        if (element->age.elapsed() < max_age*1000)
+        if (element->age.elapsed() < element->lifetime)
             *valid = true;
         return element->info;
 
@@ -1162,14 +1434,26 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 
 void QHostInfoCache::put(const QString &name, const QHostInfo &info)
 {
-    // if the lookup failed, don't cache
-    if (info.error() != QHostInfo::NoError)
+    // Only cache the answers of the name servers: addresses,
+    // or the fact that the host does not exist
+    int lifetime;
+    const int ttl = QHostInfoPrivate::timeToLive(info);
+    if (info.error() == QHostInfo::NoError)
+        lifetime = ttl < 0 ? max_age : qMin(ttl, max_age);
+    else if (info.error() == QHostInfo::HostNotFound && !info.hostName().isEmpty())
+        lifetime = ttl < 0 ? negative_max_age : qMin(ttl, max_age);
+    else
+        return;
+
+    // A TTL of zero means the answer must not be cached
+    if (lifetime <= 0)
         return;
 
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
     element->age = QElapsedTimer();
     element->age.start();
+    element->lifetime = lifetime * qint64(1000);
 
     QMutexLocker locker(&this->mutex);
     cache.insert(name, element); // cache will take ownership
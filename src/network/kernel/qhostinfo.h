@@ -60,6 +60,11 @@ public:
         UnknownError
     };
 
+    enum ResolverMode {
+        SystemResolver,
+        DnsResolver
+    };
+
     explicit QHostInfo(int lookupId = -1);
     QHostInfo(const QHostInfo &d);
     QHostInfo(QHostInfo &&other) noexcept : d_ptr(qExchange(other.d_ptr, nullptr)) {}
@@ -91,6 +96,12 @@ public:
     static QString localHostName();
     static QString localDomainName();
 
+    static void setResolverMode(ResolverMode mode);
+    static ResolverMode resolverMode();
+    static void setNameserver(const QHostAddress &nameserver, quint16 port = 53);
+    static QHostAddress nameserver();
+    static quint16 nameserverPort();
+
 #ifdef Q_CLANG_QDOC
     template<typename Functor>
     static int lookupHost(const QString &name, Functor functor);
@@ -150,6 +161,7 @@ public:
 private:
     QHostInfoPrivate *d_ptr;
     Q_DECLARE_PRIVATE(QHostInfo)
+    friend class QHostInfoPrivate;
 
     static int lookupHostImpl(const QString &name,
                               const QObject *receiver,
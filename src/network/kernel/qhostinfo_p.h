@@ -73,6 +73,10 @@
 #include <QNetworkSession>
 #include <QSharedPointer>
 
+#if QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+#include "private/qdnshostresolver_p.h"
+#endif
+
 #include <atomic>
 
 QT_BEGIN_NAMESPACE
@@ -138,7 +142,8 @@ public:
     inline QHostInfoPrivate()
         : err(QHostInfo::NoError),
           errorStr(QLatin1String(QT_TRANSLATE_NOOP("QHostInfo", "Unknown error"))),
-          lookupId(0)
+          lookupId(0),
+          ttl(-1)
     {
     }
     static int lookupHostImpl(const QString &name,
@@ -151,6 +156,11 @@ public:
     QList<QHostAddress> addrs;
     QString hostName;
     int lookupId;
+    // How long the results may be cached (in seconds), -1 if unknown
+    int ttl;
+
+    static int timeToLive(const QHostInfo &info) { return info.d_ptr->ttl; }
+    static void setTimeToLive(QHostInfo &info, int seconds) { info.d_ptr->ttl = seconds; }
 };
 
 // These functions are outside of the QHostInfo class and strictly internal.
@@ -165,6 +175,8 @@ class QHostInfoCache
 public:
     QHostInfoCache();
     const int max_age; // seconds
+    // for failed lookups that did not come with a TTL
+    const int negative_max_age; // seconds
 
     QHostInfo get(const QString &name, bool *valid);
     void put(const QString &name, const QHostInfo &info);
@@ -179,6 +191,7 @@ private:
     struct QHostInfoCacheElement {
         QHostInfo info;
         QElapsedTimer age;
+        qint64 lifetime; // msecs
     };
     QCache<QString,QHostInfoCacheElement> cache;
     QMutex mutex;
@@ -192,6 +205,7 @@ public:
     QHostInfoRunnable(const QString &hn, int i, const QObject *receiver,
                       QtPrivate::QSlotObjectBase *slotObj);
     void run() override;
+    void postResults(QHostInfo hostInfo);
 
     QString toBeLookedUp;
     int id;
@@ -210,6 +224,11 @@ public:
     // called from QHostInfo
     void scheduleLookup(QHostInfoRunnable *r);
     void abortLookup(int id);
+    void setResolverMode(QHostInfo::ResolverMode mode);
+    QHostInfo::ResolverMode resolverMode();
+    void setNameserver(const QHostAddress &address, quint16 port);
+    QHostAddress nameserver();
+    quint16 nameserverPort();
 
     // called from QHostInfoRunnable
     void lookupFinished(QHostInfoRunnable *r);
@@ -234,8 +253,27 @@ protected:
 
     bool wasDeleted;
 
+    QHostInfo::ResolverMode currentResolverMode = QHostInfo::SystemResolver;
+    QHostAddress configuredNameserver;
+    quint16 configuredNameserverPort = 53;
+
 private:
     void rescheduleWithMutexHeld();
+    void startLookup(QHostInfoRunnable *r);
+#if QT_CONFIG(thread) && QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket)
+    enum { MaxDnsLookups = 256 };
+
+    void updateDnsConfiguration();
+    void startDnsLookup(QDnsHostResolver *resolver, QHostInfoRunnable *r,
+                        const QDnsHostResolver::Configuration &configuration);
+    void stopDnsResolver();
+
+    QDnsHostResolver::Configuration dnsConfiguration;
+    QThread *dnsThread = nullptr;
+    QDnsHostResolver *dnsResolver = nullptr;
+    // Lookups handed to dnsResolver that have not finished yet
+    QList<QHostInfoRunnable*> dnsLookups;
+#endif
 };
 
 QT_END_NAMESPACE
@@ -105,6 +105,9 @@ private:
     QNetworkDatagramPrivate *d;
     friend class QUdpSocket;
     friend class QSctpSocket;
+    friend class QAbstractSocketEngine;
+    friend class QNativeSocketEngine;
+    friend class QNativeSocketEnginePrivate;
 
     explicit QNetworkDatagram(QNetworkDatagramPrivate &dd);
     QNetworkDatagram makeReply_helper(const QByteArray &data) const;
@@ -401,6 +401,21 @@
     allow setting the MTU for transmission.
     This enum value was introduced in Qt 5.11.
 
+    \value ReceiveOffloadSocketOption Lets the operating system coalesce
+    consecutive UDP datagrams of the same flow before they are read, which
+    reduces the per-datagram overhead of receiving. QUdpSocket splits them
+    again, so each call still returns one datagram. This maps to the UDP_GRO
+    socket option on Linux and is not supported on other platforms.
+    This enum value was introduced in Qt 5.15.
+
+    \value ReusePortSocketOption Set this to 1 to allow several sockets to
+    bind the same address and port, with the operating system distributing
+    incoming connections or datagrams between them. It only has an effect
+    if it is set before the socket is bound; see
+    QTcpServer::setSocketOption(). This maps to the SO_REUSEPORT socket
+    option and is not supported on Windows.
+    This enum value was introduced in Qt 5.15.
+
     Possible values for \e{TypeOfServiceOption} are:
 
     \table
@@ -485,8 +500,10 @@
 #include <qhostinfo.h>
 #include <qmetaobject.h>
 #include <qpointer.h>
+#include <qtcpsocket.h>
 #include <qtimer.h>
 #include <qelapsedtimer.h>
+#include <qfile.h>
 #include <qscopedvaluerollback.h>
 #include <qvarlengtharray.h>
 
@@ -495,6 +512,9 @@
 #endif
 
 #include <private/qthread_p.h>
+#ifdef Q_OS_UNIX
+#include <private/qcore_unix_p.h>
+#endif
 
 #ifdef QABSTRACTSOCKET_DEBUG
 #include <qdebug.h>
@@ -514,6 +534,9 @@
 
 QT_BEGIN_NAMESPACE
 
+// The number of write buffer chunks writeToSocket() passes to one write
+static const int MaxWriteBlocks = 16;
+
 #if defined QABSTRACTSOCKET_DEBUG
 QT_BEGIN_INCLUDE_NAMESPACE
 #include <qstring.h>
@@ -843,7 +866,7 @@ void QAbstractSocketPrivate::connectionNotification()
 bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
-    if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
+    if (!socketEngine || !socketEngine->isValid() || (!hasPendingWrites()
         && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
@@ -861,11 +884,45 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
+    // A queued file goes out once everything written before it has gone out
+    if (!pendingFiles.empty() && pendingFiles.front().precedingBytes == 0) {
+        const qint64 written = writeFileToSocket();
+        if (written < 0) {
+            q->abort();
+            return false;
+        }
+        if (written > 0)
+            emitBytesWritten(written);
+        if (!hasPendingWrites() && !socketEngine->bytesToWrite())
+            socketEngine->setWriteNotificationEnabled(false);
+        if (state == QAbstractSocket::ClosingState)
+            q->disconnectFromHost();
+        return written > 0;
+    }
+
+    // Attempt to write it all in one go. The buffer can consist of many
+    // chunks, for instance byte arrays queued by write(QByteArrayList).
+    const char *blocks[MaxWriteBlocks];
+    qint64 blockSizes[MaxWriteBlocks];
+    int blockCount = writeBuffer.readPointers(blocks, blockSizes, MaxWriteBlocks);
+    if (!pendingFiles.empty()) {
+        // Data written after a queued file has to wait for it
+        qint64 precedingBytes = pendingFiles.front().precedingBytes;
+        for (int i = 0; i < blockCount; ++i) {
+            if (blockSizes[i] >= precedingBytes) {
+                blockSizes[i] = precedingBytes;
+                blockCount = i + 1;
+                break;
+            }
+            precedingBytes -= blockSizes[i];
+        }
+    }
 
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    qint64 written = 0;
+    if (blockCount == 1)
+        written = socketEngine->write(blocks[0], blockSizes[0]);
+    else if (blockCount > 1)
+        written = socketEngine->writeVector(blocks, blockSizes, blockCount);
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -885,12 +942,14 @@ bool QAbstractSocketPrivate::writeToSocket()
     if (written > 0) {
         // Remove what we wrote so far.
         writeBuffer.free(written);
+        if (!pendingFiles.empty())
+            pendingFiles.front().precedingBytes -= written;
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (!hasPendingWrites() && socketEngine && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
@@ -898,6 +957,229 @@ bool QAbstractSocketPrivate::writeToSocket()
     return written > 0;
 }
 
+/*
+    Reads up to \a maxSize bytes of a file queued by sendFile(), starting
+    at \a offset, without moving the file's position: its owner may still
+    be using it, or a file sharing its descriptor, in another thread.
+    Files without a descriptor are read through \a copy, which is opened
+    on first use. Returns the number of bytes read, or -1 after setting
+    \a errorString, also if the file ended early.
+*/
+static qint64 qt_readFileAt(QFile *file, QSharedPointer<QFile> &copy, qint64 offset,
+                            char *data, qint64 maxSize, QString *errorString)
+{
+    qint64 readBytes = -1;
+#ifdef Q_OS_UNIX
+    const int fileDescriptor = file->handle();
+    if (fileDescriptor != -1) {
+        EINTR_LOOP(readBytes, ::pread(fileDescriptor, data, size_t(maxSize), QT_OFF_T(offset)));
+        if (readBytes < 0)
+            *errorString = qt_error_string(errno);
+    } else
+#endif
+    {
+        if (!copy) {
+            copy.reset(new QFile(file->fileName()));
+            if (!copy->open(QIODevice::ReadOnly)) {
+                *errorString = copy->errorString();
+                return -1;
+            }
+        }
+        if (copy->seek(offset))
+            readBytes = copy->read(data, maxSize);
+        if (readBytes < 0)
+            *errorString = copy->errorString();
+    }
+
+    if (readBytes == 0) {
+        *errorString = QAbstractSocket::tr("File to send was truncated");
+        return -1;
+    }
+    return readBytes;
+}
+
+/*! \internal
+
+    Writes the file at the head of pendingFiles to the socket, directly
+    from the file if the socket engine supports it, and otherwise through
+    a temporary buffer. Returns the number of bytes written, or -1 after
+    setting the error if the file could not be read or written.
+*/
+qint64 QAbstractSocketPrivate::writeFileToSocket()
+{
+    PendingFile &pending = pendingFiles.front();
+    if (!pending.file || !pending.file->isOpen()) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File to send was closed before it was sent"));
+        return -1;
+    }
+
+    qint64 written = -2;
+    const int fileDescriptor = pending.file->handle();
+    if (fileDescriptor != -1)
+        written = socketEngine->sendFile(fileDescriptor, pending.offset, pending.remaining);
+
+    if (written == -2) {
+        // The engine cannot send from the file, copy one chunk instead
+        QVarLengthArray<char, 4096> chunk(int(qMin<qint64>(pending.remaining,
+                                                           writeBufferChunkSize)));
+        QString errorString;
+        const qint64 readBytes = qt_readFileAt(pending.file, pending.copy, pending.offset,
+                                               chunk.data(), chunk.size(), &errorString);
+        if (readBytes < 0) {
+            setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                            QAbstractSocket::tr("Could not read file to send: %1")
+                                    .arg(errorString));
+            return -1;
+        }
+        written = socketEngine->write(chunk.constData(), readBytes);
+    }
+
+    if (written < 0) {
+#if defined (QABSTRACTSOCKET_DEBUG)
+        qDebug() << "QAbstractSocketPrivate::writeFileToSocket() write error, aborting."
+                 << socketEngine->errorString();
+#endif
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        return -1;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeFileToSocket() %lld bytes written to the network",
+           written);
+#endif
+
+    pending.offset += written;
+    pending.remaining -= written;
+    pendingFileBytes -= written;
+    if (pending.remaining == 0)
+        pendingFiles.pop_front();
+    return written;
+}
+
+/*! \internal
+
+    Queues \a size bytes of \a file, starting at \a offset, to be written
+    after the data that is already buffered. Returns \a size, or -1 if
+    the socket is not connected.
+
+    Sockets without a socket engine of their own (QSslSocket) and sockets
+    that are still looking up their peer read the file into the write
+    buffer right away.
+*/
+qint64 QAbstractSocketPrivate::sendFile(QFile *file, qint64 offset, qint64 size)
+{
+    Q_Q(QAbstractSocket);
+    if (state == QAbstractSocket::UnconnectedState) {
+        setError(QAbstractSocket::UnknownSocketError, QAbstractSocket::tr("Socket is not connected"));
+        return -1;
+    }
+
+    if (!socketEngine) {
+        QVarLengthArray<char, 4096> chunk(int(qMin<qint64>(size, writeBufferChunkSize)));
+        QSharedPointer<QFile> copy;
+        QString errorString;
+        qint64 remaining = size;
+        while (remaining > 0) {
+            const qint64 readBytes = qt_readFileAt(file, copy, offset + size - remaining,
+                                                   chunk.data(),
+                                                   qMin<qint64>(remaining, chunk.size()),
+                                                   &errorString);
+            if (readBytes < 0 || q->write(chunk.constData(), readBytes) != readBytes)
+                return -1;
+            remaining -= readBytes;
+        }
+        return size;
+    }
+
+    qint64 precedingBytes = writeBuffer.size();
+    for (const PendingFile &pending : pendingFiles)
+        precedingBytes -= pending.precedingBytes;
+    pendingFiles.push_back({file, offset, size, precedingBytes});
+    pendingFileBytes += size;
+    socketEngine->setWriteNotificationEnabled(true);
+    return size;
+}
+
+/*! \internal
+
+    Drops the files queued by sendFile() that have not been written.
+*/
+void QAbstractSocketPrivate::clearPendingFiles()
+{
+    pendingFiles.clear();
+    pendingFileBytes = 0;
+}
+
+/*! \internal
+
+    Writes \a buffers without copying them. An unbuffered TCP socket with
+    nothing queued hands them to the socket engine right away; whatever
+    does not go out then is queued by reference, to be sent by
+    writeToSocket() together with the rest of the write buffer.
+*/
+qint64 QAbstractSocketPrivate::writeVector(const QByteArrayList &buffers)
+{
+    Q_Q(QAbstractSocket);
+    // Datagram sockets send every write as a datagram of its own. Subclasses
+    // may reimplement writeData(), so they get every buffer passed to it.
+    if (socketType != QAbstractSocket::TcpSocket || (openMode & QIODevice::Text)
+        || (typeid(*q) != typeid(QTcpSocket) && typeid(*q) != typeid(QAbstractSocket))) {
+        return QIODevicePrivate::writeVector(buffers);
+    }
+
+    if (state == QAbstractSocket::UnconnectedState) {
+        setError(QAbstractSocket::UnknownSocketError, QAbstractSocket::tr("Socket is not connected"));
+        return -1;
+    }
+
+    qint64 totalSize = 0;
+    for (const QByteArray &buffer : buffers)
+        totalSize += buffer.size();
+
+    qint64 written = 0;
+    if (!isBuffered && socketEngine && !hasPendingWrites()) {
+        QVarLengthArray<const char *, 16> data;
+        QVarLengthArray<qint64, 16> sizes;
+        for (const QByteArray &buffer : buffers) {
+            if (!buffer.isEmpty()) {
+                data.append(buffer.constData());
+                sizes.append(buffer.size());
+            }
+        }
+        if (!data.isEmpty())
+            written = socketEngine->writeVector(data.constData(), sizes.constData(), data.size());
+        if (written < 0) {
+            setError(socketEngine->error(), socketEngine->errorString());
+            return written;
+        }
+    }
+
+    // The write buffer is empty if anything was written above, so
+    // dropping the written part from its front leaves the rest
+    qint64 skip = written;
+    for (const QByteArray &buffer : buffers) {
+        if (skip >= buffer.size()) {
+            skip -= buffer.size();
+            continue;
+        }
+        writeBuffer.append(buffer);
+        if (skip > 0) {
+            writeBuffer.free(skip);
+            skip = 0;
+        }
+    }
+
+    if (socketEngine && hasPendingWrites())
+        socketEngine->setWriteNotificationEnabled(true);
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeVector(%d buffers) == %lli [%lli written directly]",
+           buffers.size(), totalSize, written);
+#endif
+    return totalSize;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -908,7 +1190,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while ((!allWriteBuffersEmpty() || !pendingFiles.empty()) && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1832,7 +2114,7 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    const qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->pendingFileBytes;
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -2078,6 +2360,14 @@ void QAbstractSocket::setSocketOption(QAbstractSocket::SocketOption option, cons
         case PathMtuSocketOption:
             d_func()->socketEngine->setOption(QAbstractSocketEngine::PathMtuInformation, value.toInt());
             break;
+
+        case ReceiveOffloadSocketOption:
+            d_func()->socketEngine->setOption(QAbstractSocketEngine::ReceiveOffload, value.toInt());
+            break;
+
+        case ReusePortSocketOption:
+            d_func()->socketEngine->setOption(QAbstractSocketEngine::PortReusable, value.toInt());
+            break;
     }
 }
 
@@ -2124,6 +2414,14 @@ QVariant QAbstractSocket::socketOption(QAbstractSocket::SocketOption option)
         case PathMtuSocketOption:
                 ret = d_func()->socketEngine->option(QAbstractSocketEngine::PathMtuInformation);
                 break;
+
+        case ReceiveOffloadSocketOption:
+                ret = d_func()->socketEngine->option(QAbstractSocketEngine::ReceiveOffload);
+                break;
+
+        case ReusePortSocketOption:
+                ret = d_func()->socketEngine->option(QAbstractSocketEngine::PortReusable);
+                break;
     }
     if (ret == -1)
         return QVariant();
@@ -2290,7 +2588,7 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2342,7 +2640,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (!d->hasPendingWrites())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2359,7 +2657,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  d->hasPendingWrites(),
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2439,7 +2737,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2476,6 +2774,7 @@ void QAbstractSocket::abort()
     qDebug("QAbstractSocket::abort()");
 #endif
     d->setWriteChannelCount(0);
+    d->clearPendingFiles();
     if (d->state == UnconnectedState)
         return;
 #ifndef QT_NO_SSL
@@ -2585,7 +2884,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && !d->hasPendingWrites()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2628,7 +2927,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     d->writeBuffer.append(data, size);
     qint64 written = size;
 
-    if (d->socketEngine && !d->writeBuffer.isEmpty())
+    if (d->socketEngine && d->hasPendingWrites())
         d->socketEngine->setWriteNotificationEnabled(true);
 
 #if defined (QABSTRACTSOCKET_DEBUG)
@@ -2816,7 +3115,7 @@ void QAbstractSocket::disconnectFromHost()
 
         // Wait for pending data to be written.
         if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
-            || d->socketEngine->bytesToWrite() > 0)) {
+            || !d->pendingFiles.empty() || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
 #if defined(QABSTRACTSOCKET_DEBUG)
@@ -2846,6 +3145,7 @@ void QAbstractSocket::disconnectFromHost()
     d->peerAddress.clear();
     d->peerName.clear();
     d->setWriteChannelCount(0);
+    d->clearPendingFiles();
 
 #if defined(QABSTRACTSOCKET_DEBUG)
         qDebug("QAbstractSocket::disconnectFromHost() disconnected!");
@@ -121,7 +121,9 @@ public:
         TypeOfServiceOption, //IP_TOS
         SendBufferSizeSocketOption,    //SO_SNDBUF
         ReceiveBufferSizeSocketOption,  //SO_RCVBUF
-        PathMtuSocketOption // IP_MTU
+        PathMtuSocketOption, // IP_MTU
+        ReceiveOffloadSocketOption, // UDP_GRO
+        ReusePortSocketOption // SO_REUSEPORT
     };
     Q_ENUM(SocketOption)
     enum BindFlag {
@@ -55,13 +55,18 @@
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
+#include "QtCore/qsharedpointer.h"
 #include "QtCore/qtimer.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
 #include "qnetworkproxy.h"
 
+#include <deque>
+
 QT_BEGIN_NAMESPACE
 
+class QFile;
 class QHostInfo;
 
 class QAbstractSocketPrivate : public QIODevicePrivate, public QAbstractSocketEngineReceiver
@@ -140,12 +145,32 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    qint64 writeFileToSocket();
+    virtual qint64 sendFile(QFile *file, qint64 offset, qint64 size);
+    void clearPendingFiles();
+    qint64 writeVector(const QByteArrayList &buffers) override;
+    inline bool hasPendingWrites() const
+    { return !writeBuffer.isEmpty() || !pendingFiles.empty(); }
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
     void setError(QAbstractSocket::SocketError errorCode, const QString &errorString);
     void setErrorAndEmit(QAbstractSocket::SocketError errorCode, const QString &errorString);
 
+    // A file queued by QTcpSocket::sendFile(). It is sent directly from
+    // the file once the precedingBytes in writeBuffer that were written
+    // before it have gone out.
+    struct PendingFile {
+        QPointer<QFile> file;
+        qint64 offset;
+        qint64 remaining;
+        qint64 precedingBytes;
+        // Opened to copy the data if the file cannot be read in place
+        QSharedPointer<QFile> copy;
+    };
+    std::deque<PendingFile> pendingFiles;
+    qint64 pendingFileBytes = 0;
+
     qint64 readBufferMaxSize;
     bool isBuffered;
     bool hasPendingData;
@@ -192,6 +192,105 @@ void QAbstractSocketEngine::proxyAuthenticationRequired(const QNetworkProxy &pro
 }
 #endif
 
+#ifndef QT_NO_UDPSOCKET
+/*!
+    \internal
+
+    Reads at most \a maxCount pending datagrams, each truncated to \a maxSize
+    bytes unless it is -1, and appends them to \a datagrams. Returns the
+    number of datagrams read, or -2 if none was pending, or -1 if an error
+    occurred before any datagram was read.
+
+    This implementation calls readDatagram() once per datagram. Engines that
+    can receive several datagrams with one system call reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount,
+                                         qint64 maxSize, PacketHeaderOptions options)
+{
+    int count = 0;
+    while (count < maxCount && hasPendingDatagrams()) {
+        const qint64 size = maxSize < 0 ? pendingDatagramSize() : maxSize;
+        if (size < 0)
+            break;
+
+        QNetworkDatagram datagram(QByteArray(size, Qt::Uninitialized));
+        const qint64 readBytes = readDatagram(datagram.d->data.data(), size,
+                                              &datagram.d->header, options);
+        if (readBytes < 0)
+            return count ? count : int(readBytes);
+        datagram.d->data.truncate(readBytes);
+        datagrams->append(datagram);
+        ++count;
+    }
+    return count ? count : -2;
+}
+
+/*!
+    \internal
+
+    Sends the \a count datagrams in \a datagrams, in order. Returns the
+    number of datagrams sent, which is less than \a count if the send
+    buffer filled up, or -2 if none could be sent because of that, or -1
+    if an error occurred before any datagram was sent.
+
+    This implementation calls writeDatagram() once per datagram.
+*/
+int QAbstractSocketEngine::writeDatagrams(const QNetworkDatagram *datagrams, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const qint64 sent = writeDatagram(datagrams[i].d->data.constData(),
+                                          datagrams[i].d->data.size(), datagrams[i].d->header);
+        if (sent < 0)
+            return i ? i : int(sent);
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
+/*!
+    \internal
+
+    Writes the \a count blocks of data \a data, with sizes \a sizes, to
+    the socket, in order, as one stream of bytes. Returns the number of
+    bytes written, which is less than the total if the send buffer filled
+    up, or -1 if an error occurred before anything was written.
+
+    This implementation calls write() once per block.
+*/
+qint64 QAbstractSocketEngine::writeVector(const char * const *data, const qint64 *sizes, int count)
+{
+    qint64 writtenSoFar = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = write(data[i], sizes[i]);
+        if (written < 0)
+            return writtenSoFar ? writtenSoFar : written;
+        writtenSoFar += written;
+        if (written < sizes[i])
+            break;
+    }
+    return writtenSoFar;
+}
+
+/*!
+    \internal
+
+    Writes up to \a len bytes of the file referred to by \a fileDescriptor,
+    starting at \a offset, to the socket without copying them through a
+    user space buffer. The file position of \a fileDescriptor is not used
+    or changed. Returns the number of bytes written, 0 if the send buffer
+    is full, or -1 if an error occurred.
+
+    This implementation returns -2, meaning that the engine cannot send
+    files directly and the caller has to read the data and pass it to
+    write().
+*/
+qint64 QAbstractSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 len)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(len);
+    return -2;
+}
 
 QAbstractSocket::SocketState QAbstractSocketEngine::state() const
 {
@@ -56,7 +56,9 @@
 #include "QtNetwork/qhostaddress.h"
 #include "QtNetwork/qabstractsocket.h"
 #include "private/qobject_p.h"
+#include "QtNetwork/qnetworkdatagram.h"
 #include "private/qnetworkdatagram_p.h"
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -106,7 +108,9 @@ public:
         ReceivePacketInformation,
         ReceiveHopLimit,
         MaxStreamsSocketOption,
-        PathMtuInformation
+        PathMtuInformation,
+        ReceiveOffload,
+        PortReusable
     };
 
     enum PacketHeaderOption {
@@ -140,6 +144,8 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 writeVector(const char * const *data, const qint64 *sizes, int count);
+    virtual qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 len);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -158,6 +164,11 @@ public:
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = nullptr,
                                 PacketHeaderOptions = WantNone) = 0;
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
+#ifndef QT_NO_UDPSOCKET
+    virtual int readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount, qint64 maxSize,
+                              PacketHeaderOptions options = WantNone);
+    virtual int writeDatagrams(const QNetworkDatagram *datagrams, int count);
+#endif // QT_NO_UDPSOCKET
     virtual qint64 bytesToWrite() const = 0;
 
     virtual int option(SocketOption option) const = 0;
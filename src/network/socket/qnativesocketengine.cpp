@@ -825,6 +825,10 @@ bool QNativeSocketEngine::hasPendingDatagrams() const
     Q_CHECK_NOT_STATE(QNativeSocketEngine::hasPendingDatagrams(), QAbstractSocket::UnconnectedState, false);
     Q_CHECK_TYPE(QNativeSocketEngine::hasPendingDatagrams(), QAbstractSocket::UdpSocket, false);
 
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    if (!d->pendingSegments.isEmpty())
+        return true;
+#endif
     return d->nativeHasPendingDatagrams();
 }
 
@@ -840,6 +844,19 @@ qint64 QNativeSocketEngine::pendingDatagramSize() const
     Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::pendingDatagramSize(), -1);
     Q_CHECK_TYPE(QNativeSocketEngine::pendingDatagramSize(), QAbstractSocket::UdpSocket, -1);
 
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    if (d->receiveOffload && d->pendingSegments.isEmpty()) {
+        // The datagram in the kernel may consist of several coalesced
+        // ones; receive and split it to learn the size of the first one
+        QNativeSocketEnginePrivate *dd = const_cast<QNativeSocketEnginePrivate *>(d);
+        QVector<QNetworkDatagram> received;
+        if (dd->nativeReceiveDatagrams(&received, 1, -1, WantAll) <= 0)
+            return -1;
+        dd->pendingSegments.prepend(received.constFirst());
+    }
+    if (!d->pendingSegments.isEmpty())
+        return d->pendingSegments.head().d->data.size();
+#endif
     return d->nativePendingDatagramSize();
 }
 #endif // QT_NO_UDPSOCKET
@@ -867,9 +884,56 @@ qint64 QNativeSocketEngine::readDatagram(char *data, qint64 maxSize, QIpPacketHe
     Q_CHECK_STATES(QNativeSocketEngine::readDatagram(), QAbstractSocket::BoundState,
                    QAbstractSocket::ConnectedState, -1);
 
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    if (d->receiveOffload || !d->pendingSegments.isEmpty())
+        return d->receivePendingSegment(data, maxSize, header);
+#endif
     return d->nativeReceiveDatagram(data, maxSize, header, options);
 }
 
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Reads up to \a maxCount datagrams from the socket and appends them to
+    \a datagrams, using as few system calls as the platform allows. Each
+    datagram is truncated to \a maxSize bytes, unless \a maxSize is -1.
+    The address, port, and other IP header fields are stored according to
+    the request in \a options.
+
+    Returns the number of datagrams read, -2 if no datagram was pending,
+    or -1 if an error occurred.
+
+    \sa readDatagram()
+*/
+int QNativeSocketEngine::readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount,
+                                       qint64 maxSize, PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    int count = 0;
+    while (count < maxCount && !d->pendingSegments.isEmpty()) {
+        QNetworkDatagram datagram = d->pendingSegments.dequeue();
+        if (maxSize >= 0)
+            datagram.d->data.truncate(maxSize);
+        datagrams->append(std::move(datagram));
+        ++count;
+    }
+    if (count == maxCount)
+        return count;
+
+    const int received = d->nativeReceiveDatagrams(datagrams, maxCount - count, maxSize, options);
+    if (received < 0)
+        return count ? count : received;
+    return count + received;
+#else
+    return QAbstractSocketEngine::readDatagrams(datagrams, maxCount, maxSize, options);
+#endif
+}
+#endif // QT_NO_UDPSOCKET
+
 /*!
     Writes a datagram of size \a size bytes to the socket from
     \a data to the destination contained in \a header, and returns the
@@ -902,6 +966,34 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size, const Q
     return d->nativeSendDatagram(data, size, header);
 }
 
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Writes the \a count datagrams in \a datagrams to the socket, in order,
+    using as few system calls as the platform allows. Where supported,
+    consecutive datagrams of the same size to the same destination are
+    handed to the kernel as one message that it segments (UDP_SEGMENT).
+
+    Returns the number of datagrams written, which is less than \a count
+    if the send buffer filled up, -2 if none could be written because of
+    that, or -1 if an error occurred.
+
+    \sa writeDatagram()
+*/
+int QNativeSocketEngine::writeDatagrams(const QNetworkDatagram *datagrams, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    return d->nativeSendDatagrams(datagrams, count);
+#else
+    return QAbstractSocketEngine::writeDatagrams(datagrams, count);
+#endif
+}
+#endif // QT_NO_UDPSOCKET
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -918,6 +1010,40 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+#ifdef QNATIVESOCKETENGINE_HAVE_WRITEV
+/*!
+    Writes the \a count blocks of data \a data, with sizes \a sizes, to
+    the socket with a single system call. Returns the number of bytes
+    written, or -1 if an error occurred.
+*/
+qint64 QNativeSocketEngine::writeVector(const char * const *data, const qint64 *sizes, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeVector(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeVector(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeWriteVector(data, sizes, count);
+}
+#endif
+
+
+#ifdef QNATIVESOCKETENGINE_HAVE_SENDFILE
+/*!
+    Writes up to \a len bytes of the file referred to by \a fileDescriptor,
+    starting at \a offset, to the socket. The kernel copies the data
+    directly from the page cache. Returns the number of bytes written, 0 if
+    the send buffer is full, -1 if an error occurred, or -2 if the file
+    cannot be sent this way.
+*/
+qint64 QNativeSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 len)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::sendFile(), QAbstractSocket::TcpSocket, -1);
+    return d->nativeSendFile(fileDescriptor, offset, len);
+}
+#endif
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
@@ -983,6 +1109,11 @@ void QNativeSocketEngine::close()
     d->peerPort = 0;
     d->peerAddress.clear();
     d->inboundStreamCount = d->outboundStreamCount = 0;
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    d->pendingSegments.clear();
+    d->receiveBuffer.clear();
+    d->receiveOffload = false;
+#endif
     if (d->readNotifier) {
         qDeleteInEventHandler(d->readNotifier);
         d->readNotifier = nullptr;
@@ -64,9 +64,21 @@
 #  include <ws2tcpip.h>
 #  include <mswsock.h>
 #endif
+#include <QtCore/qqueue.h>
 
 QT_BEGIN_NAMESPACE
 
+#if defined(Q_OS_LINUX)
+// recvmmsg(), sendmmsg(), UDP_GRO and UDP_SEGMENT
+#  define QNATIVESOCKETENGINE_HAVE_MMSG
+// sendfile() to a socket
+#  define QNATIVESOCKETENGINE_HAVE_SENDFILE
+#endif
+#if defined(Q_OS_UNIX)
+// sendmsg() with several buffers
+#  define QNATIVESOCKETENGINE_HAVE_WRITEV
+#endif
+
 #ifdef Q_OS_WIN
 #  define QT_SOCKLEN_T int
 #  define QT_SOCKOPTLEN_T int
@@ -146,6 +158,12 @@ public:
 
     qint64 read(char *data, qint64 maxlen) override;
     qint64 write(const char *data, qint64 len) override;
+#ifdef QNATIVESOCKETENGINE_HAVE_WRITEV
+    qint64 writeVector(const char * const *data, const qint64 *sizes, int count) override;
+#endif
+#ifdef QNATIVESOCKETENGINE_HAVE_SENDFILE
+    qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 len) override;
+#endif
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -164,6 +182,11 @@ public:
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = nullptr,
                         PacketHeaderOptions = WantNone) override;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) override;
+#ifndef QT_NO_UDPSOCKET
+    int readDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount, qint64 maxSize,
+                      PacketHeaderOptions options = WantNone) override;
+    int writeDatagrams(const QNetworkDatagram *datagrams, int count) override;
+#endif
     qint64 bytesToWrite() const override;
 
 #if 0   // currently unused
@@ -212,6 +235,16 @@ public:
 
     QSocketNotifier *readNotifier, *writeNotifier, *exceptNotifier;
 
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    // Segments of a coalesced datagram received with UDP_GRO that have not
+    // been read yet
+    QQueue<QNetworkDatagram> pendingSegments;
+    QByteArray receiveBuffer;
+    // UDP_SEGMENT is only tried for segments smaller than this; 0 disables it
+    int sendOffloadLimit = 65508;
+    bool receiveOffload = false;
+#endif
+
 #if defined(Q_OS_WIN)
     LPFN_WSASENDMSG sendmsg;
     LPFN_WSARECVMSG recvmsg;
@@ -277,8 +310,20 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+    int nativeReceiveDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount, qint64 maxSize,
+                               QAbstractSocketEngine::PacketHeaderOptions options);
+    int nativeSendDatagrams(const QNetworkDatagram *datagrams, int count);
+    qint64 receivePendingSegment(char *data, qint64 maxSize, QIpPacketHeader *header);
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#ifdef QNATIVESOCKETENGINE_HAVE_WRITEV
+    qint64 nativeWriteVector(const char * const *data, const qint64 *sizes, int count);
+#endif
+#ifdef QNATIVESOCKETENGINE_HAVE_SENDFILE
+    qint64 nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -69,6 +69,12 @@
 #endif
 
 #include <netinet/tcp.h>
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+#include <netinet/udp.h>
+#endif
+#ifdef QNATIVESOCKETENGINE_HAVE_SENDFILE
+#include <sys/sendfile.h>
+#endif
 #ifndef QT_NO_SCTP
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -151,6 +157,7 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
     case QNativeSocketEngine::NonBlockingSocketOption:  // fcntl, not setsockopt
     case QNativeSocketEngine::BindExclusively:          // not handled on Unix
     case QNativeSocketEngine::MaxStreamsSocketOption:
+    case QNativeSocketEngine::ReceiveOffload:
         Q_UNREACHABLE();
 
     case QNativeSocketEngine::BroadcastSocketOption:
@@ -165,6 +172,11 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
     case QNativeSocketEngine::AddressReusable:
         n = SO_REUSEADDR;
         break;
+    case QNativeSocketEngine::PortReusable:
+#ifdef SO_REUSEPORT
+        n = SO_REUSEPORT;
+#endif
+        break;
     case QNativeSocketEngine::ReceiveOutOfBandData:
         n = SO_OOBINLINE;
         break;
@@ -346,6 +358,13 @@ int QNativeSocketEnginePrivate::option(QNativeSocketEngine::SocketOption opt) co
         return -1;
     }
 
+    case QNativeSocketEngine::ReceiveOffload:
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+        return receiveOffload ? 1 : 0;
+#else
+        return -1;
+#endif
+
     case QNativeSocketEngine::PathMtuInformation:
 #if defined(IPV6_PATHMTU) && !defined(IPV6_MTU)
         // Prefer IPV6_MTU (handled by convertToLevelAndOption), if available
@@ -433,6 +452,19 @@ bool QNativeSocketEnginePrivate::setOption(QNativeSocketEngine::SocketOption opt
         return false;
     }
 
+    case QNativeSocketEngine::ReceiveOffload:
+#if defined(QNATIVESOCKETENGINE_HAVE_MMSG) && defined(UDP_GRO)
+        // Let the kernel coalesce datagrams of the same flow; they are split
+        // again in nativeReceiveDatagrams()
+        if (socketType != QAbstractSocket::UdpSocket
+            || ::setsockopt(socketDescriptor, SOL_UDP, UDP_GRO, &v, sizeof(v)) != 0)
+            return false;
+        receiveOffload = v != 0;
+        return true;
+#else
+        return false;
+#endif
+
     default:
         break;
     }
@@ -936,6 +968,87 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
+/*
+    Fills \a header from the sender address \a aa and the ancillary data
+    of \a msg, as received by recvmsg() or recvmmsg(). If \a segmentSize is
+    not null, it is set to the size of the segments of a datagram that the
+    kernel coalesced with UDP_GRO.
+*/
+static void qt_socket_getPacketHeader(msghdr *msg, const qt_sockaddr *aa, quint16 localPort,
+                                      QIpPacketHeader *header, int *segmentSize = nullptr)
+{
+    qt_socket_getPortAndAddress(aa, &header->senderPort, &header->senderAddress);
+    header->destinationPort = localPort;
+    header->endOfRecord = (msg->msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    struct cmsghdr *cmsgptr;
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_CLANG("-Wsign-compare")
+    for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != nullptr;
+         cmsgptr = CMSG_NXTHDR(msg, cmsgptr)) {
+        QT_WARNING_POP
+        if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
+            in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
+        }
+
+#ifdef IP_PKTINFO
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
+            in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+            header->ifindex = info->ipi_ifindex;
+        }
+#else
+#  ifdef IP_RECVDSTADDR
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
+            in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(addr->s_addr));
+        }
+#  endif
+#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
+            sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
+            header->ifindex = sdl->sdl_index;
+        }
+#  endif
+#endif
+
+        if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
+                && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+                    || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
+            Q_STATIC_ASSERT(sizeof(header->hopLimit) == sizeof(int));
+            memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
+        }
+
+#ifdef UDP_GRO
+        if (segmentSize && cmsgptr->cmsg_level == SOL_UDP && cmsgptr->cmsg_type == UDP_GRO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(int))) {
+            memcpy(segmentSize, CMSG_DATA(cmsgptr), sizeof(int));
+        }
+#endif
+
+#ifndef QT_NO_SCTP
+        if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
+            && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
+            sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
+
+            header->streamNumber = int(rcvInfo->sinfo_stream);
+        }
+#endif
+    }
+}
+
 qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
                                                          QAbstractSocketEngine::PacketHeaderOptions options)
 {
@@ -995,69 +1108,7 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
             header->clear();
     } else if (options != QAbstractSocketEngine::WantNone) {
         Q_ASSERT(header);
-        qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
-        header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        struct cmsghdr *cmsgptr;
-        QT_WARNING_PUSH
-        QT_WARNING_DISABLE_CLANG("-Wsign-compare")
-        for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != nullptr;
-             cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
-            QT_WARNING_POP
-            if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
-                in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
-
-#ifdef IP_PKTINFO
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
-                in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-                header->ifindex = info->ipi_ifindex;
-            }
-#else
-#  ifdef IP_RECVDSTADDR
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
-                in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(addr->s_addr));
-            }
-#  endif
-#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
-                sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
-                header->ifindex = sdl->sdl_index;
-            }
-#  endif
-#endif
-
-            if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
-                    && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
-                        || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
-                Q_STATIC_ASSERT(sizeof(header->hopLimit) == sizeof(int));
-                memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
-            }
-
-#ifndef QT_NO_SCTP
-            if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
-                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
-                sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
-
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-            }
-#endif
-        }
+        qt_socket_getPacketHeader(&msg, &aa, localPort, header);
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
@@ -1072,37 +1123,38 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     return qint64((maxSize || recvResult < 0) ? recvResult : Q_INT64_C(0));
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
-{
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+// we use quintptr to force the alignment
+typedef quintptr QSendControlBuffer[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+                                     + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+#if defined(QNATIVESOCKETENGINE_HAVE_MMSG) && defined(UDP_SEGMENT)
+                                     + CMSG_SPACE(sizeof(quint16))
+#endif
+                                     + sizeof(quintptr) - 1) / sizeof(quintptr)];
 
+/*
+    Prepares \a msg to be sent to the destination in \a header, using \a aa
+    for the address, and adds the ancillary data requested by \a header to
+    \a cbuf. Returns where further ancillary data can be added.
+*/
+static cmsghdr *qt_socket_setPacketHeader(QNativeSocketEnginePrivate *d, msghdr *msg, qt_sockaddr *aa,
+                                          QSendControlBuffer &cbuf, const QIpPacketHeader &header)
+{
     struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(cbuf);
-    struct msghdr msg;
-    struct iovec vec;
-    qt_sockaddr aa;
-
-    memset(&msg, 0, sizeof(msg));
-    memset(&aa, 0, sizeof(aa));
-    vec.iov_base = const_cast<char *>(data);
-    vec.iov_len = len;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
-    msg.msg_control = &cbuf;
+    memset(aa, 0, sizeof(*aa));
+    msg->msg_control = &cbuf;
+    msg->msg_controllen = 0;
 
     if (header.destinationPort != 0) {
-        msg.msg_name = &aa.a;
-        setPortAndAddress(header.destinationPort, header.destinationAddress,
-                          &aa, &msg.msg_namelen);
+        msg->msg_name = &aa->a;
+        d->setPortAndAddress(header.destinationPort, header.destinationAddress,
+                             aa, &msg->msg_namelen);
     }
 
-    if (msg.msg_namelen == sizeof(aa.a6)) {
+    if (msg->msg_namelen == sizeof(aa->a6)) {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_HOPLIMIT;
@@ -1112,7 +1164,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         if (header.ifindex != 0 || !header.senderAddress.isNull()) {
             struct in6_pktinfo *data = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
             memset(data, 0, sizeof(*data));
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_PKTINFO;
@@ -1124,7 +1176,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         }
     } else {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IP;
             cmsgptr->cmsg_type = IP_TTL;
@@ -1146,7 +1198,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
             data->s_addr = htonl(header.senderAddress.toIPv4Address());
 #  endif
             cmsgptr->cmsg_level = IPPROTO_IP;
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
         }
@@ -1157,7 +1209,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     if (header.streamNumber != -1) {
         struct sctp_sndrcvinfo *data = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
         memset(data, 0, sizeof(*data));
-        msg.msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
+        msg->msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_level = IPPROTO_SCTP;
         cmsgptr->cmsg_type =  SCTP_SNDRCV;
@@ -1166,6 +1218,23 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     }
 #endif
 
+    return cmsgptr;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+{
+    QSendControlBuffer cbuf;
+    struct msghdr msg;
+    struct iovec vec;
+    qt_sockaddr aa;
+
+    memset(&msg, 0, sizeof(msg));
+    vec.iov_base = const_cast<char *>(data);
+    vec.iov_len = len;
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    qt_socket_setPacketHeader(this, &msg, &aa, cbuf, header);
+
     if (msg.msg_controllen == 0)
         msg.msg_control = nullptr;
     ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
@@ -1199,6 +1268,280 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#ifdef QNATIVESOCKETENGINE_HAVE_MMSG
+enum {
+    // Datagrams per recvmmsg() or sendmmsg() call, and segments per
+    // UDP_SEGMENT message (UDP_MAX_SEGMENTS in Linux)
+    MaxDatagramsPerCall = 64,
+    // Largest UDP payload over IPv4, and largest datagram UDP_GRO delivers
+    MaxDatagramSize = 65507,
+    // Size of the receive buffer, which is kept between calls
+    MaxReceiveBufferSize = 4 * MaxDatagramSize
+};
+
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(QVector<QNetworkDatagram> *datagrams, int maxCount,
+                                                       qint64 maxSize,
+                                                       QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    // we use quintptr to force the alignment
+    typedef quintptr ControlBuffer[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+#ifndef QT_NO_SCTP
+                                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+#endif
+#ifdef UDP_GRO
+                                   + CMSG_SPACE(sizeof(int))
+#endif
+                                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+
+    if (maxCount <= 0)
+        return 0;
+
+    // Without a limit any datagram can be as large as the maximum, and
+    // coalesced datagrams use up to that much, too. Read fewer datagrams
+    // at once rather than growing the buffer past MaxReceiveBufferSize.
+    const qint64 bufferSize = (maxSize < 0 || receiveOffload)
+            ? qint64(MaxDatagramSize) : qBound(qint64(1), maxSize, qint64(MaxDatagramSize));
+    const int count = qMin(maxCount, int(qMin(qint64(MaxDatagramsPerCall),
+                                              MaxReceiveBufferSize / bufferSize)));
+    if (receiveBuffer.size() < count * bufferSize)
+        receiveBuffer.resize(int(count * bufferSize));
+    char *buffer = receiveBuffer.data();
+
+    const bool wantControl = receiveOffload
+            || (options & (QAbstractSocketEngine::WantDatagramHopLimit
+                           | QAbstractSocketEngine::WantDatagramDestination
+                           | QAbstractSocketEngine::WantStreamNumber));
+
+    struct mmsghdr msgs[MaxDatagramsPerCall];
+    struct iovec vecs[MaxDatagramsPerCall];
+    qt_sockaddr addresses[MaxDatagramsPerCall];
+    ControlBuffer cbufs[MaxDatagramsPerCall];
+    memset(msgs, 0, count * sizeof(mmsghdr));
+    // The sender is parsed into the header even if it was not requested
+    memset(addresses, 0, count * sizeof(qt_sockaddr));
+    for (int i = 0; i < count; ++i) {
+        vecs[i].iov_base = buffer + i * bufferSize;
+        vecs[i].iov_len = bufferSize;
+        msgs[i].msg_hdr.msg_iov = &vecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (options & QAbstractSocketEngine::WantDatagramSender) {
+            msgs[i].msg_hdr.msg_name = &addresses[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(qt_sockaddr);
+        }
+        if (wantControl) {
+            msgs[i].msg_hdr.msg_control = cbufs[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof(cbufs[i]);
+        }
+    }
+
+    int received;
+    EINTR_LOOP(received, ::recvmmsg(socketDescriptor, msgs, count, 0, nullptr));
+    if (received == -1) {
+        switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            // No datagram was available for reading
+            return -2;
+        case ECONNREFUSED:
+            setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+        }
+        return -1;
+    }
+
+    int produced = 0;
+    for (int i = 0; i < received; ++i) {
+        QIpPacketHeader header;
+        int segmentSize = 0;
+        if (options != QAbstractSocketEngine::WantNone || receiveOffload)
+            qt_socket_getPacketHeader(&msgs[i].msg_hdr, &addresses[i], localPort, &header, &segmentSize);
+
+        // Split datagrams that the kernel coalesced with UDP_GRO
+        const char *data = buffer + i * bufferSize;
+        const qint64 length = msgs[i].msg_len;
+        if (segmentSize <= 0 || segmentSize > length)
+            segmentSize = int(length);
+        qint64 offset = 0;
+        do {
+            qint64 size = qMin(qint64(segmentSize), length - offset);
+            QNetworkDatagram datagram(QByteArray(data + offset,
+                                                 int(maxSize < 0 ? size : qMin(size, maxSize))));
+            datagram.d->header = header;
+            if (produced < maxCount) {
+                datagrams->append(std::move(datagram));
+                ++produced;
+            } else {
+                pendingSegments.enqueue(std::move(datagram));
+            }
+            offset += size;
+        } while (offset < length);
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%d, %lli) == %d (%d pending)",
+           maxCount, maxSize, produced, pendingSegments.size());
+#endif
+
+    return produced;
+}
+
+/*
+    Reads the next datagram when UDP_GRO is enabled, splitting coalesced
+    datagrams and keeping the segments that were not read yet.
+*/
+qint64 QNativeSocketEnginePrivate::receivePendingSegment(char *data, qint64 maxSize, QIpPacketHeader *header)
+{
+    if (pendingSegments.isEmpty()) {
+        QVector<QNetworkDatagram> received;
+        const int result = nativeReceiveDatagrams(&received, 1, -1, QAbstractSocketEngine::WantAll);
+        if (result < 0) {
+            if (header)
+                header->clear();
+            return result;
+        }
+        // Any further segments of the datagram were queued already
+        pendingSegments.prepend(received.constFirst());
+    }
+
+    const QNetworkDatagram datagram = pendingSegments.dequeue();
+    const qint64 size = qMin(qint64(datagram.d->data.size()), maxSize);
+    if (size > 0)
+        memcpy(data, datagram.d->data.constData(), size);
+    if (header)
+        *header = datagram.d->header;
+    return size;
+}
+
+static bool qt_canSendAsSegments(const QIpPacketHeader &first, const QIpPacketHeader &other)
+{
+    return first.destinationPort == other.destinationPort
+            && first.hopLimit == other.hopLimit
+            && first.ifindex == other.ifindex
+            && first.streamNumber == other.streamNumber
+            && first.destinationAddress == other.destinationAddress
+            && first.senderAddress == other.senderAddress;
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const QNetworkDatagram *datagrams, int count)
+{
+    struct mmsghdr msgs[MaxDatagramsPerCall];
+    struct iovec vecs[MaxDatagramsPerCall];
+    qt_sockaddr addresses[MaxDatagramsPerCall];
+    QSendControlBuffer cbufs[MaxDatagramsPerCall];
+    int segments[MaxDatagramsPerCall];
+    bool offload = true;
+
+    int sent = 0;
+    while (sent < count) {
+        // Build up to MaxDatagramsPerCall messages. With UDP_SEGMENT, a run
+        // of datagrams to the same destination that have the same size,
+        // except for a shorter last one, is sent as a single message.
+        int messages = 0;
+        int next = sent;
+        while (next < count && next - sent < MaxDatagramsPerCall) {
+            const QNetworkDatagramPrivate *first = datagrams[next].d;
+            const int segmentSize = first->data.size();
+            int run = 1;
+#ifdef UDP_SEGMENT
+            if (offload && segmentSize > 0 && segmentSize < sendOffloadLimit) {
+                qint64 total = segmentSize;
+                while (next + run < count && next + run - sent < MaxDatagramsPerCall) {
+                    const QNetworkDatagramPrivate *other = datagrams[next + run].d;
+                    const int size = other->data.size();
+                    if (size == 0 || size > segmentSize || total + size > MaxDatagramSize
+                        || !qt_canSendAsSegments(first->header, other->header)) {
+                        break;
+                    }
+                    total += size;
+                    ++run;
+                    if (size < segmentSize)
+                        break;
+                }
+            }
+#endif
+
+            msghdr *msg = &msgs[messages].msg_hdr;
+            memset(&msgs[messages], 0, sizeof(mmsghdr));
+            for (int i = 0; i < run; ++i) {
+                const QNetworkDatagramPrivate *datagram = datagrams[next + i].d;
+                vecs[next - sent + i].iov_base = const_cast<char *>(datagram->data.constData());
+                vecs[next - sent + i].iov_len = datagram->data.size();
+            }
+            msg->msg_iov = &vecs[next - sent];
+            msg->msg_iovlen = run;
+            cmsghdr *cmsgptr = qt_socket_setPacketHeader(this, msg, &addresses[messages],
+                                                         cbufs[messages], first->header);
+#ifdef UDP_SEGMENT
+            if (run > 1) {
+                const quint16 size = quint16(segmentSize);
+                msg->msg_controllen += CMSG_SPACE(sizeof(size));
+                cmsgptr->cmsg_len = CMSG_LEN(sizeof(size));
+                cmsgptr->cmsg_level = SOL_UDP;
+                cmsgptr->cmsg_type = UDP_SEGMENT;
+                memcpy(CMSG_DATA(cmsgptr), &size, sizeof(size));
+            }
+#else
+            Q_UNUSED(cmsgptr);
+#endif
+            if (msg->msg_controllen == 0)
+                msg->msg_control = nullptr;
+
+            segments[messages++] = run;
+            next += run;
+        }
+
+        int result;
+        EINTR_LOOP(result, ::sendmmsg(socketDescriptor, msgs, messages, 0));
+        if (result < 0) {
+            if ((errno == EINVAL || errno == EIO) && segments[0] > 1) {
+                // The segments were too large for the path MTU, or the
+                // device cannot offload; send this batch without UDP_SEGMENT
+                if (errno == EIO)
+                    sendOffloadLimit = 0;
+                else
+                    sendOffloadLimit = qMin(sendOffloadLimit, datagrams[sent].d->data.size());
+                offload = false;
+                continue;
+            }
+            if (sent)
+                break;
+            switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                return -2;
+            case EMSGSIZE:
+                setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+                break;
+            case ECONNRESET:
+                setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+            }
+            return -1;
+        }
+
+        offload = true;
+        for (int i = 0; i < result; ++i)
+            sent += segments[i];
+        if (result < messages)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%d) == %d", count, sent);
+#endif
+
+    return sent;
+}
+#endif // QNATIVESOCKETENGINE_HAVE_MMSG
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1364,6 +1707,111 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+#ifdef QNATIVESOCKETENGINE_HAVE_WRITEV
+qint64 QNativeSocketEnginePrivate::nativeWriteVector(const char * const *data,
+                                                     const qint64 *sizes, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+#ifdef IOV_MAX
+    count = qMin(count, int(IOV_MAX));
+#endif
+    QVarLengthArray<iovec, 16> vectors(count);
+    for (int i = 0; i < count; ++i) {
+        vectors[i].iov_base = const_cast<char *>(data[i]);
+        vectors[i].iov_len = size_t(sizes[i]);
+    }
+
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = vectors.data();
+    message.msg_iovlen = count;
+
+    ssize_t writtenBytes = qt_safe_sendmsg(socketDescriptor, &message, 0);
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        case EMSGSIZE:
+            setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+            break;
+        default:
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteVector(%d blocks) == %i",
+           count, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+#endif // QNATIVESOCKETENGINE_HAVE_WRITEV
+
+#ifdef QNATIVESOCKETENGINE_HAVE_SENDFILE
+qint64 QNativeSocketEnginePrivate::nativeSendFile(qintptr fileDescriptor, qint64 offset,
+                                                  qint64 length)
+{
+    Q_Q(QNativeSocketEngine);
+
+    // sendfile() transfers at most 0x7ffff000 bytes per call
+    const size_t count = size_t(qMin<qint64>(length, 0x7ffff000));
+    off_t fileOffset = off_t(offset);
+    ssize_t writtenBytes;
+    EINTR_LOOP(writtenBytes, ::sendfile(socketDescriptor, int(fileDescriptor), &fileOffset, count));
+
+    if (writtenBytes == 0 && count > 0) {
+        // The file ended early, it was truncated while being sent
+        writtenBytes = -1;
+        setError(QAbstractSocket::UnknownSocketError, ReadErrorString);
+    } else if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        case EINVAL:
+        case ENOSYS:
+        case EOPNOTSUPP:
+            // The file does not support mmap-like operations (e.g. a pipe
+            // or some FUSE file systems): let the caller copy the data
+            writtenBytes = -2;
+            break;
+        case EIO:
+            writtenBytes = -1;
+            setError(QAbstractSocket::UnknownSocketError, ReadErrorString);
+            break;
+        default:
+            writtenBytes = -1;
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%d, %lld, %lld) == %i",
+           int(fileDescriptor), offset, length, int(writtenBytes));
+#endif
+
+    return qint64(writtenBytes);
+}
+#endif
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
@@ -285,6 +285,8 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
         break;
 
     case QAbstractSocketEngine::PathMtuInformation:
+    case QAbstractSocketEngine::ReceiveOffload:
+    case QAbstractSocketEngine::PortReusable:
         break;          // not supported on Windows
     }
 }
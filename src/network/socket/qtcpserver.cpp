@@ -72,6 +72,15 @@
     Calling close() makes QTcpServer stop listening for incoming
     connections.
 
+    A busy server can spread the work of accepting connections over
+    several threads. Each thread runs its own QTcpServer and event loop,
+    and every server enables QAbstractSocket::ReusePortSocketOption with
+    setSocketOption() before calling listen() on the same address and
+    port. The operating system then distributes incoming connections
+    between the listening sockets, so no thread has to hand accepted
+    sockets to another. This is supported on Linux and most other Unix
+    systems.
+
     Although QTcpServer is mostly designed for use with an event
     loop, it's possible to use it without one. In that case, you must
     use waitForNewConnection(), which blocks until either a
@@ -188,6 +197,41 @@ void QTcpServerPrivate::configureCreatedSocket()
     // trying to bind/listen.
     socketEngine->setOption(QAbstractSocketEngine::AddressReusable, 1);
 #endif
+
+    for (auto it = socketOptions.cbegin(), end = socketOptions.cend(); it != end; ++it)
+        socketEngine->setOption(engineOption(it.key()), it.value().toInt());
+}
+
+/*! \internal
+
+    Returns the socket engine option corresponding to \a option.
+*/
+QAbstractSocketEngine::SocketOption QTcpServerPrivate::engineOption(QAbstractSocket::SocketOption option)
+{
+    switch (option) {
+    case QAbstractSocket::LowDelayOption:
+        return QAbstractSocketEngine::LowDelayOption;
+    case QAbstractSocket::KeepAliveOption:
+        return QAbstractSocketEngine::KeepAliveOption;
+    case QAbstractSocket::MulticastTtlOption:
+        return QAbstractSocketEngine::MulticastTtlOption;
+    case QAbstractSocket::MulticastLoopbackOption:
+        return QAbstractSocketEngine::MulticastLoopbackOption;
+    case QAbstractSocket::TypeOfServiceOption:
+        return QAbstractSocketEngine::TypeOfServiceOption;
+    case QAbstractSocket::SendBufferSizeSocketOption:
+        return QAbstractSocketEngine::SendBufferSocketOption;
+    case QAbstractSocket::ReceiveBufferSizeSocketOption:
+        return QAbstractSocketEngine::ReceiveBufferSocketOption;
+    case QAbstractSocket::PathMtuSocketOption:
+        return QAbstractSocketEngine::PathMtuInformation;
+    case QAbstractSocket::ReceiveOffloadSocketOption:
+        return QAbstractSocketEngine::ReceiveOffload;
+    case QAbstractSocket::ReusePortSocketOption:
+        return QAbstractSocketEngine::PortReusable;
+    }
+    Q_UNREACHABLE();
+    return QAbstractSocketEngine::PortReusable;
 }
 
 /*! \internal
@@ -702,6 +746,58 @@ void QTcpServer::resumeAccepting()
     d_func()->socketEngine->setReadNotificationEnabled(true);
 }
 
+/*!
+    \since 5.15
+
+    Sets the given \a option to the value described by \a value.
+
+    Options set before listen() are applied to the listening socket
+    before it is bound, which is required for
+    QAbstractSocket::ReusePortSocketOption. Several QTcpServer instances,
+    typically one per thread, can then listen on the same address and
+    port:
+
+    \code
+        QTcpServer *server = new QTcpServer; // created in the worker thread
+        server->setSocketOption(QAbstractSocket::ReusePortSocketOption, 1);
+        server->listen(QHostAddress::Any, 8080);
+    \endcode
+
+    On Linux, accepted sockets inherit options such as the buffer sizes
+    and QAbstractSocket::LowDelayOption from the listening socket.
+    Options set while the server is listening are applied immediately.
+
+    \sa socketOption(), QAbstractSocket::setSocketOption()
+*/
+void QTcpServer::setSocketOption(QAbstractSocket::SocketOption option, const QVariant &value)
+{
+    Q_D(QTcpServer);
+    d->socketOptions.insert(option, value);
+    if (d->socketEngine)
+        d->socketEngine->setOption(QTcpServerPrivate::engineOption(option), value.toInt());
+}
+
+/*!
+    \since 5.15
+
+    Returns the value of the \a option option. If the server is not
+    listening, this is the value set with setSocketOption(), if any.
+    Returns an invalid QVariant if the option is not set or not supported.
+
+    \sa setSocketOption(), QAbstractSocket::socketOption()
+*/
+QVariant QTcpServer::socketOption(QAbstractSocket::SocketOption option) const
+{
+    Q_D(const QTcpServer);
+    if (!d->socketEngine)
+        return d->socketOptions.value(option);
+
+    int ret = d->socketEngine->option(QTcpServerPrivate::engineOption(option));
+    if (ret == -1)
+        return QVariant();
+    return QVariant(ret);
+}
+
 #ifndef QT_NO_NETWORKPROXY
 /*!
     \since 4.1
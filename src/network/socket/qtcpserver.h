@@ -53,6 +53,7 @@ class QTcpServerPrivate;
 class QNetworkProxy;
 #endif
 class QTcpSocket;
+class QVariant;
 
 class Q_NETWORK_EXPORT QTcpServer : public QObject
 {
@@ -85,6 +86,9 @@ public:
     void pauseAccepting();
     void resumeAccepting();
 
+    void setSocketOption(QAbstractSocket::SocketOption option, const QVariant &value);
+    QVariant socketOption(QAbstractSocket::SocketOption option) const;
+
 #ifndef QT_NO_NETWORKPROXY
     void setProxy(const QNetworkProxy &networkProxy);
     QNetworkProxy proxy() const;
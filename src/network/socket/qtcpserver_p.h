@@ -59,6 +59,8 @@
 #include "QtNetwork/qabstractsocket.h"
 #include "qnetworkproxy.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qmap.h"
+#include "QtCore/qvariant.h"
 #include "qhostaddress.h"
 
 QT_BEGIN_NAMESPACE
@@ -85,12 +87,15 @@ public:
 
     int maxConnections;
 
+    QMap<QAbstractSocket::SocketOption, QVariant> socketOptions;
+
 #ifndef QT_NO_NETWORKPROXY
     QNetworkProxy proxy;
     QNetworkProxy resolveProxy(const QHostAddress &address, quint16 port);
 #endif
 
     virtual void configureCreatedSocket();
+    static QAbstractSocketEngine::SocketOption engineOption(QAbstractSocket::SocketOption option);
 
     // from QAbstractSocketEngineReceiver
     void readNotification() override;
@@ -68,6 +68,7 @@
 #include "qtcpsocket_p.h"
 #include "qlist.h"
 #include "qhostaddress.h"
+#include "qfile.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -118,4 +119,47 @@ QTcpSocket::QTcpSocket(QAbstractSocket::SocketType socketType,
 {
 }
 
+/*!
+    \since 5.15
+
+    Queues \a size bytes of \a file, starting at \a offset, to be sent
+    after any data that was written to the socket before. If \a size is
+    -1, the file is sent up to its end. Returns the number of bytes
+    queued, or -1 if an error occurred.
+
+    On Linux, the data is handed from the file to the network by the
+    kernel (sendfile), without being copied into the socket's write
+    buffer; elsewhere it is read in small chunks as the socket becomes
+    ready for writing. bytesToWrite() includes the file data that has
+    not been sent yet, and bytesWritten() is emitted as it goes out.
+
+    \a file must be open for reading, must not be sequential, and must
+    stay open and unchanged until all of its data has been written.
+    Data written to \a file through QFile must be flushed first. The
+    current position of \a file is ignored and may change.
+
+    Encrypted QSslSocket connections and sockets that are still looking
+    up their peer read the file into the write buffer immediately.
+
+    \sa write(), bytesToWrite()
+*/
+qint64 QTcpSocket::sendFile(QFile *file, qint64 offset, qint64 size)
+{
+    Q_D(QTcpSocket);
+    if (!file || !file->isReadable() || file->isSequential()) {
+        qWarning("QTcpSocket::sendFile: file must be open for reading and not sequential");
+        return -1;
+    }
+    const qint64 fileSize = file->size();
+    if (offset < 0 || offset > fileSize || size < -1 || (size != -1 && offset + size > fileSize)) {
+        qWarning("QTcpSocket::sendFile: offset and size must lie within the file");
+        return -1;
+    }
+    if (size == -1)
+        size = fileSize - offset;
+    if (size == 0)
+        return 0;
+    return d->sendFile(file, offset, size);
+}
+
 QT_END_NAMESPACE
@@ -46,6 +46,7 @@
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
 
 class QTcpSocketPrivate;
 
@@ -56,6 +57,8 @@ public:
     explicit QTcpSocket(QObject *parent = nullptr);
     virtual ~QTcpSocket();
 
+    qint64 sendFile(QFile *file, qint64 offset = 0, qint64 size = -1);
+
 protected:
     QTcpSocket(QTcpSocketPrivate &dd, QObject *parent = nullptr);
     QTcpSocket(QAbstractSocket::SocketType socketType, QTcpSocketPrivate &dd,
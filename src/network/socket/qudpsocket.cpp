@@ -431,6 +431,56 @@ qint64 QUdpSocket::writeDatagram(const QNetworkDatagram &datagram)
     return sent;
 }
 
+/*!
+    \since 5.15
+
+    Sends the datagrams in \a datagrams, in order, to the destinations
+    contained in each of them, as writeDatagram() does. Where the platform
+    supports it, the datagrams are passed to the operating system with
+    as few system calls as possible, and consecutive datagrams of the same
+    size to the same destination are segmented by the kernel or the network
+    interface (UDP_SEGMENT on Linux). This makes sending many small
+    datagrams considerably cheaper than calling writeDatagram() for each.
+
+    Returns the number of datagrams sent, which is less than the size of
+    \a datagrams if the operating system's send buffer filled up; the rest
+    can be sent again later. Returns -1 if an error occurred before any
+    datagram was sent.
+
+    \sa writeDatagram(), receiveDatagrams()
+*/
+int QUdpSocket::writeDatagrams(const QVector<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%d)", datagrams.size());
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.constFirst().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    int sent = d->socketEngine->writeDatagrams(datagrams.constData(), datagrams.size());
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent > 0) {
+        qint64 bytes = 0;
+        for (int i = 0; i < sent; ++i)
+            bytes += datagrams.at(i).d->data.size();
+        emit bytesWritten(bytes);
+    } else if (sent == -2) {
+        // Socket engine reports EAGAIN. Treat as a temporary error.
+        d->setErrorAndEmit(QAbstractSocket::TemporaryError,
+                           tr("Unable to send a datagram"));
+        return -1;
+    } else if (sent < 0) {
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    }
+    return sent;
+}
+
 /*!
     \since 5.8
 
@@ -476,6 +526,47 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 5.15
+
+    Receives up to \a maxCount pending datagrams and returns them, along
+    with their sender's host address and port, and, if possible, their
+    destination address, port, and hop count at reception time. Where the
+    platform supports it, the datagrams are received with as few system
+    calls as possible (\c recvmmsg() on Linux), which makes draining a busy
+    socket considerably cheaper than calling receiveDatagram() for each.
+
+    Returns an empty list if no datagram is pending or an error occurred.
+
+    Each datagram is truncated to \a maxSize bytes. If \a maxSize is -1 (the
+    default), datagrams of any size are received in full, at the cost of
+    reserving room for the largest possible datagram for each of them; pass
+    the largest size you expect, such as the path MTU, to avoid that.
+
+    \sa receiveDatagram(), writeDatagrams(), ReceiveOffloadSocketOption
+*/
+QVector<QNetworkDatagram> QUdpSocket::receiveDatagrams(int maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%d, %lld)", maxCount, maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QVector<QNetworkDatagram>());
+
+    QVector<QNetworkDatagram> result;
+    if (maxCount <= 0)
+        return result;
+
+    const int received = d->socketEngine->readDatagrams(&result, maxCount, maxSize,
+                                                        QAbstractSocketEngine::WantAll);
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (received == -1)
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    return result;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
@@ -167,7 +167,14 @@ Q_LOGGING_CATEGORY(lcSsl, "qt.network.ssl");
     option can allow connections for legacy servers, but it introduces the
     possibility that an attacker could inject plaintext into the SSL session.
     \value SslOptionDisableSessionSharing Disables SSL session sharing via
-    the session ID handshake attribute.
+    the session ID handshake attribute. With the OpenSSL backend, sockets
+    share sessions through a process-wide cache unless this option is set:
+    a client offers the session it last negotiated with the same host and
+    port, and servers resume each other's sessions and session tickets.
+    Sessions are only shared between sockets with the same verification
+    settings, certificates and ciphers. The cache holds 256 sessions by
+    default; the \c QT_SSL_SESSION_CACHE_SIZE environment variable changes
+    that, and 0 disables it.
     \value SslOptionDisableSessionPersistence Disables storing the SSL session
     in ASN.1 format as returned by QSslConfiguration::sessionTicket(). Enabling
     this feature adds memory overhead of approximately 1K per used session
@@ -985,6 +985,13 @@ QMap<QByteArray, QVariant> QSslConfiguration::backendConfiguration() const
     {https://www.openssl.org/docs/manmaster/man3/SSL_CONF_cmd.html#EXAMPLES}{examples}
     show how to use some of the options.
 
+    On Linux, setting the \c Qt-KTLS option to \c true makes QSslSocket hand
+    encryption of the data it sends to the kernel after a TLS 1.3 handshake,
+    if the kernel supports it for the negotiated cipher and the socket is not
+    connected through a proxy. Data is then copied once less. The connection
+    is aborted if OpenSSL has to answer a TLS control message, such as a key
+    update request, afterwards. This option is not passed to OpenSSL.
+
     \note The backend-specific configuration will be applied after the general
     configuration. Using the backend-specific configuration to set a general
     configuration option again will overwrite the general configuration option.
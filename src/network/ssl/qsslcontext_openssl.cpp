@@ -49,6 +49,11 @@
 #include "private/qsslsocket_openssl_p.h"
 #include "private/qsslsocket_openssl_symbols_p.h"
 #include "private/qssldiffiehellmanparameters_p.h"
+#include "private/qsslsessioncache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
 
 #include <vector>
 
@@ -81,6 +86,10 @@ extern "C" int q_verify_cookie_callback(SSL *ssl, const unsigned char *cookie,
 extern "C" int q_ssl_sess_set_new_cb(SSL *context, SSL_SESSION *session);
 #endif // TLS1_3_VERSION
 
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+extern "C" void q_ssl_keylog_callback(const SSL *ssl, const char *line);
+#endif
+
 // Defined in qsslsocket.cpp
 QList<QSslCipher> q_getDefaultDtlsCiphers();
 
@@ -274,6 +283,11 @@ int QSslContext::sessionTicketLifeTimeHint() const
     return m_sessionTicketLifeTimeHint;
 }
 
+QByteArray QSslContext::sessionCacheDigest() const
+{
+    return m_sessionCacheDigest;
+}
+
 QSslError::SslError QSslContext::error() const
 {
     return errorCode;
@@ -698,6 +712,197 @@ init_context:
     }
 
     applyBackendConfig(sslContext);
+    if (sslContext->errorCode != QSslError::NoError)
+        return;
+
+    if (!isDtls && !configuration.testSslOption(QSsl::SslOptionDisableSessionSharing))
+        initSessionSharing(sslContext, mode);
+
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+    // The kernel needs the traffic secrets, which OpenSSL only hands out
+    // through the key log
+    if (!isDtls && configuration.backendConfiguration().value("Qt-KTLS").toBool())
+        q_SSL_CTX_set_keylog_callback(sslContext->ctx, q_ssl_keylog_callback);
+#endif
+}
+
+#ifdef TLS1_3_VERSION
+// Server side session cache callbacks, see initSessionSharing().
+static QByteArray sessionCacheServerKey(const SSL_SESSION *session)
+{
+    unsigned int length = 0;
+    const unsigned char *id = q_SSL_SESSION_get_id(session, &length);
+    if (!id || !length)
+        return QByteArray();
+    return QSslSessionCache::serverKey(QByteArray(reinterpret_cast<const char *>(id), int(length)));
+}
+
+extern "C" int q_ssl_server_sess_new_cb(SSL *, SSL_SESSION *session)
+{
+    const QByteArray key = sessionCacheServerKey(session);
+    const int sessionSize = q_i2d_SSL_SESSION(session, nullptr);
+    if (key.isEmpty() || sessionSize <= 0)
+        return 0;
+
+    QByteArray sessionData(sessionSize, Qt::Uninitialized);
+    auto data = reinterpret_cast<unsigned char *>(sessionData.data());
+    if (!q_i2d_SSL_SESSION(session, &data))
+        return 0;
+
+    QSslSessionCache::instance()->insert(key, sessionData, int(q_SSL_SESSION_get_timeout(session)));
+    // We keep a copy, not a reference
+    return 0;
+}
+
+extern "C" SSL_SESSION *q_ssl_server_sess_get_cb(SSL *, const unsigned char *id, int length, int *copy)
+{
+    *copy = 0;
+    const QByteArray sessionData = QSslSessionCache::instance()->find(
+            QSslSessionCache::serverKey(QByteArray(reinterpret_cast<const char *>(id), length)));
+    if (sessionData.isEmpty())
+        return nullptr;
+
+    // OpenSSL takes the reference and checks the session ID context
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(sessionData.constData());
+    return q_d2i_SSL_SESSION(nullptr, &data, sessionData.size());
+}
+
+extern "C" void q_ssl_server_sess_remove_cb(SSL_CTX *, SSL_SESSION *session)
+{
+    const QByteArray key = sessionCacheServerKey(session);
+    if (!key.isEmpty())
+        QSslSessionCache::instance()->remove(key);
+}
+
+#ifndef OPENSSL_NO_AES
+namespace {
+// Every server context uses the same ticket keys, so that a ticket issued
+// by one QSslSocket can be redeemed by another. The keys are replaced every
+// hour; tickets encrypted with the previous key are still accepted for one
+// more lifetime, and the client is asked to renew them.
+class SessionTicketKeys
+{
+public:
+    struct Key
+    {
+        unsigned char name[16];
+        unsigned char hmacSecret[32];
+        unsigned char aesKey[32];
+    };
+
+    enum Match {
+        Unknown = 0,
+        Current = 1,
+        Previous = 2 // Tells OpenSSL to issue a fresh ticket
+    };
+
+    static constexpr qint64 lifetime = 60 * 60 * 1000;
+
+    bool current(Key *key)
+    {
+        QMutexLocker locker(&mutex);
+        rotateLocked();
+        if (!valid[0])
+            return false;
+        *key = keys[0];
+        return true;
+    }
+
+    Match find(const unsigned char *name, Key *key)
+    {
+        QMutexLocker locker(&mutex);
+        rotateLocked();
+        for (int i = 0; i < 2; ++i) {
+            if (valid[i] && !memcmp(keys[i].name, name, sizeof keys[i].name)) {
+                *key = keys[i];
+                return i == 0 ? Current : Previous;
+            }
+        }
+        return Unknown;
+    }
+
+private:
+    void rotateLocked()
+    {
+        if (valid[0] && !age.hasExpired(lifetime))
+            return;
+        keys[1] = keys[0];
+        valid[1] = valid[0] && !age.hasExpired(2 * lifetime);
+        valid[0] = q_RAND_bytes(reinterpret_cast<unsigned char *>(&keys[0]), sizeof keys[0]) == 1;
+        age.start();
+    }
+
+    QMutex mutex;
+    Key keys[2] = {};
+    bool valid[2] = {};
+    QElapsedTimer age;
+};
+}
+
+Q_GLOBAL_STATIC(SessionTicketKeys, sessionTicketKeys)
+
+extern "C" int q_ssl_ticket_key_cb(SSL *, unsigned char *name, unsigned char *iv,
+                                   EVP_CIPHER_CTX *cipherContext, HMAC_CTX *hmacContext, int encrypt)
+{
+    SessionTicketKeys::Key key;
+    int result = SessionTicketKeys::Current;
+    if (encrypt) {
+        if (!sessionTicketKeys()->current(&key) || q_RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1)
+            return -1;
+        memcpy(name, key.name, sizeof key.name);
+    } else {
+        result = sessionTicketKeys()->find(name, &key);
+        if (result == SessionTicketKeys::Unknown)
+            return 0; // Full handshake
+    }
+
+    if (q_HMAC_Init_ex(hmacContext, key.hmacSecret, int(sizeof key.hmacSecret), q_EVP_sha256(), nullptr) != 1
+        || q_EVP_CipherInit_ex(cipherContext, q_EVP_aes_256_cbc(), nullptr, key.aesKey, iv, encrypt) != 1) {
+        return encrypt ? -1 : 0;
+    }
+    return result;
+}
+#endif // OPENSSL_NO_AES
+#endif // TLS1_3_VERSION
+
+// static
+void QSslContext::initSessionSharing(QSslContext *sslContext, QSslSocket::SslMode mode)
+{
+    // Sessions may only be resumed by contexts that would have accepted the
+    // original handshake: resumption skips certificate verification.
+    const QSslConfigurationPrivate *d = sslContext->sslConfiguration.d.constData();
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    const qint32 settings[] = { qint32(mode), qint32(d->protocol), qint32(d->peerVerifyMode),
+                                qint32(d->peerVerifyDepth), qint32(d->sslOptions),
+                                qint32(d->allowRootCertOnDemandLoading) };
+    hash.addData(reinterpret_cast<const char *>(settings), sizeof settings);
+    for (const QSslCipher &cipher : d->ciphers)
+        hash.addData(cipher.name().toLatin1() + ':');
+    for (const QSslCertificate &certificate : d->localCertificateChain)
+        hash.addData(certificate.toDer());
+    hash.addData("|", 1);
+    for (const QSslCertificate &certificate : d->caCertificates)
+        hash.addData(certificate.toDer());
+    sslContext->m_sessionCacheDigest = hash.result();
+
+    if (mode != QSslSocket::SslServerMode)
+        return;
+
+#ifdef TLS1_3_VERSION
+    // The digest is 32 bytes, SSL_MAX_SID_CTX_LENGTH
+    const QByteArray &digest = sslContext->m_sessionCacheDigest;
+    q_SSL_CTX_set_session_id_context(sslContext->ctx,
+                                     reinterpret_cast<const unsigned char *>(digest.constData()),
+                                     unsigned(qMin(digest.size(), SSL_MAX_SID_CTX_LENGTH)));
+    q_SSL_CTX_set_session_cache_mode(sslContext->ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+    q_SSL_CTX_sess_set_new_cb(sslContext->ctx, q_ssl_server_sess_new_cb);
+    q_SSL_CTX_sess_set_get_cb(sslContext->ctx, q_ssl_server_sess_get_cb);
+    q_SSL_CTX_sess_set_remove_cb(sslContext->ctx, q_ssl_server_sess_remove_cb);
+
+#ifndef OPENSSL_NO_AES
+    q_SSL_CTX_set_tlsext_ticket_key_cb(sslContext->ctx, q_ssl_ticket_key_cb);
+#endif
+#endif // TLS1_3_VERSION
 }
 
 #if QT_CONFIG(ocsp)
@@ -710,6 +915,7 @@ void QSslContext::applyBackendConfig(QSslContext *sslContext)
     if (conf.isEmpty())
         return;
 
+    int qtOptionCount = 0;
 #if QT_CONFIG(ocsp)
     auto ocspResponsePos = conf.find("Qt-OCSP-response");
     if (ocspResponsePos != conf.end()) {
@@ -717,10 +923,14 @@ void QSslContext::applyBackendConfig(QSslContext *sslContext)
         // the purpose of testing OCSP status responses. We don't even check this
         // callback was set. If no - the test must fail.
         q_SSL_CTX_set_tlsext_status_cb(sslContext->ctx, qt_OCSP_status_server_callback);
-        if (conf.size() == 1)
-            return;
+        ++qtOptionCount;
     }
 #endif // ocsp
+    // Handled in initSslContext()
+    if (conf.contains("Qt-KTLS"))
+        ++qtOptionCount;
+    if (conf.size() == qtOptionCount)
+        return;
 
     QSharedPointer<SSL_CONF_CTX> cctx(q_SSL_CONF_CTX_new(), &q_SSL_CONF_CTX_free);
     if (cctx) {
@@ -728,7 +938,8 @@ void QSslContext::applyBackendConfig(QSslContext *sslContext)
         q_SSL_CONF_CTX_set_flags(cctx.data(), SSL_CONF_FLAG_FILE);
 
         for (auto i = conf.constBegin(); i != conf.constEnd(); ++i) {
-            if (i.key() == "Qt-OCSP-response") // This never goes to SSL_CONF_cmd().
+            // These never go to SSL_CONF_cmd().
+            if (i.key() == "Qt-OCSP-response" || i.key() == "Qt-KTLS")
                 continue;
 
             if (!i.value().canConvert(QMetaType::QByteArray)) {
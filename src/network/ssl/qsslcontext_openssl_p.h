@@ -65,7 +65,7 @@ QT_BEGIN_NAMESPACE
 
 class QSslContextPrivate;
 
-class QSslContext
+class Q_AUTOTEST_EXPORT QSslContext
 {
 public:
 
@@ -85,6 +85,9 @@ public:
     QByteArray sessionASN1() const;
     void setSessionASN1(const QByteArray &sessionASN1);
     int sessionTicketLifeTimeHint() const;
+    // Identifies the configuration in QSslSessionCache, empty if sessions
+    // are not shared
+    QByteArray sessionCacheDigest() const;
 
 #ifndef OPENSSL_NO_NEXTPROTONEG
     // must be public because we want to use it from an OpenSSL callback
@@ -108,6 +111,7 @@ private:
     static void initSslContext(QSslContext* sslContext, QSslSocket::SslMode mode, const QSslConfiguration &configuration,
                                bool allowRootCertOnDemandLoading);
     static void applyBackendConfig(QSslContext *sslContext);
+    static void initSessionSharing(QSslContext *sslContext, QSslSocket::SslMode mode);
 
 private:
     SSL_CTX* ctx;
@@ -115,6 +119,7 @@ private:
     SSL_SESSION *session;
     QByteArray m_sessionASN1;
     int m_sessionTicketLifeTimeHint;
+    QByteArray m_sessionCacheDigest;
     QSslError::SslError errorCode;
     QString errorStr;
     QSslConfiguration sslConfiguration;
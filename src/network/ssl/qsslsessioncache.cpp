@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsslsessioncache_p.h"
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(QSslSessionCache, globalSessionCache)
+
+QSslSessionCache::QSslSessionCache()
+    : cache(256)
+{
+    bool ok = false;
+    const int entries = qEnvironmentVariableIntValue("QT_SSL_SESSION_CACHE_SIZE", &ok);
+    if (ok && entries >= 0)
+        cache.setMaxCost(entries);
+}
+
+QSslSessionCache *QSslSessionCache::instance()
+{
+    return globalSessionCache();
+}
+
+/*
+    The configuration digest keeps sockets apart that would not accept each
+    other's sessions: resuming skips certificate verification, so a session
+    negotiated with VerifyNone must not be offered by a socket that verifies
+    its peer.
+*/
+QByteArray QSslSessionCache::clientKey(const QString &peerName, quint16 port,
+                                       const QByteArray &configurationDigest)
+{
+    return "c:" + peerName.toLower().toUtf8() + ':' + QByteArray::number(port)
+            + ':' + configurationDigest;
+}
+
+QByteArray QSslSessionCache::serverKey(const QByteArray &sessionId)
+{
+    return "s:" + sessionId;
+}
+
+QByteArray QSslSessionCache::find(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    Entry *entry = cache.object(key);
+    if (!entry)
+        return QByteArray();
+    if (entry->age.elapsed() >= entry->lifetime) {
+        cache.remove(key);
+        return QByteArray();
+    }
+    return entry->session;
+}
+
+void QSslSessionCache::insert(const QByteArray &key, const QByteArray &session, int lifetime)
+{
+    if (session.isEmpty() || lifetime == 0)
+        return;
+
+    Entry *entry = new Entry;
+    entry->session = session;
+    entry->age.start();
+    entry->lifetime = (lifetime < 0 ? defaultLifetime : lifetime) * qint64(1000);
+
+    QMutexLocker locker(&mutex);
+    cache.insert(key, entry); // takes ownership, or deletes it if the cache is disabled
+}
+
+void QSslSessionCache::remove(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    cache.remove(key);
+}
+
+void QSslSessionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+int QSslSessionCache::maxEntries() const
+{
+    QMutexLocker locker(&mutex);
+    return cache.maxCost();
+}
+
+void QSslSessionCache::setMaxEntries(int entries)
+{
+    QMutexLocker locker(&mutex);
+    cache.setMaxCost(entries);
+}
+
+int QSslSessionCache::count() const
+{
+    QMutexLocker locker(&mutex);
+    return cache.count();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSSLSESSIONCACHE_P_H
+#define QSSLSESSIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+
+QT_REQUIRE_CONFIG(ssl);
+
+QT_BEGIN_NAMESPACE
+
+// A process-wide cache of serialized TLS sessions. Clients store the
+// session they got from a server under its host name and port, so that
+// the next connection to the same server can resume it even if it uses a
+// different QSslContext. Servers store the sessions they hand out under
+// their session ID.
+class Q_AUTOTEST_EXPORT QSslSessionCache
+{
+public:
+    QSslSessionCache();
+
+    static QSslSessionCache *instance();
+
+    static QByteArray clientKey(const QString &peerName, quint16 port,
+                                const QByteArray &configurationDigest);
+    static QByteArray serverKey(const QByteArray &sessionId);
+
+    QByteArray find(const QByteArray &key);
+    // lifetime in seconds, -1 for defaultLifetime
+    void insert(const QByteArray &key, const QByteArray &session, int lifetime);
+    void remove(const QByteArray &key);
+    void clear();
+
+    int maxEntries() const;
+    void setMaxEntries(int entries);
+    int count() const;
+
+    // seconds, if the TLS library did not tell us
+    static const int defaultLifetime = 300;
+
+private:
+    struct Entry {
+        QByteArray session;
+        QElapsedTimer age;
+        qint64 lifetime; // msecs
+    };
+    QCache<QByteArray, Entry> cache;
+    mutable QMutex mutex;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSLSESSIONCACHE_P_H
@@ -2942,6 +2942,50 @@ bool QSslSocketPrivate::flush()
     return plainSocket && plainSocket->flush();
 }
 
+/*!
+    \internal
+
+    Unencrypted data is written by the plain socket, which can send the
+    file without copying it.
+*/
+qint64 QSslSocketPrivate::sendFile(QFile *file, qint64 offset, qint64 size)
+{
+    if (mode == QSslSocket::UnencryptedMode && !autoStartHandshake && plainSocket)
+        return plainSocket->sendFile(file, offset, size);
+    return QTcpSocketPrivate::sendFile(file, offset, size);
+}
+
+/*!
+    \internal
+
+    Like writeData(), but queues the buffers without copying them.
+*/
+qint64 QSslSocketPrivate::writeVector(const QByteArrayList &buffers)
+{
+    Q_Q(QSslSocket);
+    // Subclasses may reimplement writeData()
+    if (typeid(*q) != typeid(QSslSocket))
+        return QIODevicePrivate::writeVector(buffers);
+    if (mode == QSslSocket::UnencryptedMode && !autoStartHandshake)
+        return plainSocket->write(buffers);
+
+    qint64 written = 0;
+    for (const QByteArray &buffer : buffers) {
+        if (!buffer.isEmpty()) {
+            writeBuffer.append(buffer);
+            written += buffer.size();
+        }
+    }
+
+    // make sure we flush to the plain socket's buffer
+    if (written && !flushTriggered) {
+        flushTriggered = true;
+        QMetaObject::invokeMethod(q, "_q_flushWriteBuffer", Qt::QueuedConnection);
+    }
+
+    return written;
+}
+
 /*!
     \internal
 */
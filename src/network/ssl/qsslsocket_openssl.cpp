@@ -67,6 +67,7 @@
 #include "qsslpresharedkeyauthenticator_p.h"
 #include "qocspresponse_p.h"
 #include "qsslkey.h"
+#include "qsslsessioncache_p.h"
 
 #ifdef Q_OS_WIN
 #include "qwindowscarootfetcher_p.h"
@@ -92,6 +93,22 @@
 #include "qocsp_p.h"
 #endif
 
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+#include "private/qnativesocketengine_p.h"
+#include "private/qnet_unix_p.h"
+#include <QtCore/qendian.h>
+#include <QtCore/qmessageauthenticationcode.h>
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
 #include <algorithm>
 #include <memory>
 
@@ -265,6 +282,16 @@ int q_ssl_sess_set_new_cb(SSL *ssl, SSL_SESSION *session)
 
 #endif // !OPENSSL_NO_PSK
 
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+void q_ssl_keylog_callback(const SSL *ssl, const char *line)
+{
+    auto socketPrivate = static_cast<QSslSocketBackendPrivate *>(q_SSL_get_ex_data(ssl,
+                                                                 QSslSocketBackendPrivate::s_indexForSSLExtraData));
+    if (socketPrivate && line)
+        socketPrivate->handleKeyLogLine(line);
+}
+#endif // QSSLSOCKET_OPENSSL_HAVE_KTLS
+
 #if QT_CONFIG(ocsp)
 
 int qt_OCSP_status_server_callback(SSL *ssl, void *ocspRequest)
@@ -624,14 +651,18 @@ bool QSslSocketBackendPrivate::initSslContext()
         return false;
     }
 
+    QString tlsHostName;
+    if (mode == QSslSocket::SslClientMode) {
+        tlsHostName = verificationPeerName.isEmpty() ? q->peerName() : verificationPeerName;
+        if (tlsHostName.isEmpty())
+            tlsHostName = hostName;
+    }
+
     if (configuration.protocol != QSsl::SslV2 &&
         configuration.protocol != QSsl::SslV3 &&
         configuration.protocol != QSsl::UnknownProtocol &&
         mode == QSslSocket::SslClientMode) {
         // Set server hostname on TLS extension. RFC4366 section 3.1 requires it in ACE format.
-        QString tlsHostName = verificationPeerName.isEmpty() ? q->peerName() : verificationPeerName;
-        if (tlsHostName.isEmpty())
-            tlsHostName = hostName;
         QByteArray ace = QUrl::toAce(tlsHostName);
         // only send the SNI header if the URL is valid and not an IP
         if (!ace.isEmpty()
@@ -646,6 +677,32 @@ bool QSslSocketBackendPrivate::initSslContext()
         }
     }
 
+    // Offer a session that another socket negotiated with this server,
+    // unless we already resume our context's own one
+    sessionCacheKey.clear();
+    const QByteArray sessionCacheDigest = sslContextPointer->sessionCacheDigest();
+    if (mode == QSslSocket::SslClientMode && !sessionCacheDigest.isEmpty()
+        && !tlsHostName.isEmpty()) {
+        sessionCacheKey = QSslSessionCache::clientKey(tlsHostName, q->peerPort(), sessionCacheDigest);
+        if (!q_SSL_get_session(ssl)) {
+            const QByteArray sessionData = QSslSessionCache::instance()->find(sessionCacheKey);
+            if (!sessionData.isEmpty()) {
+                const unsigned char *data = reinterpret_cast<const unsigned char *>(sessionData.constData());
+                if (SSL_SESSION *session = q_d2i_SSL_SESSION(nullptr, &data, sessionData.size())) {
+                    if (!q_SSL_set_session(ssl, session))
+                        qCWarning(lcSsl, "could not set shared SSL session");
+                    // SSL_set_session() took its own reference
+                    q_SSL_SESSION_free(session);
+                }
+            }
+        }
+    }
+
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+    kernelTlsSecret.clear();
+    kernelTlsTransmit = false;
+#endif
+
     // Clear the session.
     errorList.clear();
 
@@ -1031,6 +1088,21 @@ void QSslSocketBackendPrivate::transmit()
             qint64 totalBytesWritten = 0;
             int nextDataBlockSize;
             while ((nextDataBlockSize = writeBuffer.nextDataBlockSize()) > 0) {
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+                if (kernelTlsTransmit) {
+                    // The kernel encrypts what we write to the socket
+                    const qint64 writtenBytes = plainSocket->write(writeBuffer.readPointer(),
+                                                                   nextDataBlockSize);
+                    if (writtenBytes < 0) {
+                        const ScopedBool bg(inSetAndEmitError, true);
+                        setErrorAndEmit(plainSocket->error(), plainSocket->errorString());
+                        return;
+                    }
+                    writeBuffer.free(writtenBytes);
+                    totalBytesWritten += writtenBytes;
+                    continue;
+                }
+#endif
                 int writtenBytes = q_SSL_write(ssl, writeBuffer.readPointer(), nextDataBlockSize);
                 if (writtenBytes <= 0) {
                     int error = q_SSL_get_error(ssl, writtenBytes);
@@ -1078,6 +1150,17 @@ void QSslSocketBackendPrivate::transmit()
         // Check if we've got any data to be written to the socket.
         QVarLengthArray<char, 4096> data;
         int pendingBytes;
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+        if (kernelTlsTransmit && q_BIO_pending(writeBio) > 0) {
+            // OpenSSL answered a post-handshake message, such as a key update
+            // request, with a record sealed by its own, now stale, state.
+            const ScopedBool bg(inSetAndEmitError, true);
+            setErrorAndEmit(QAbstractSocket::SslInternalError,
+                            QSslSocket::tr("Cannot send TLS control message with kernel TLS enabled"));
+            q->abort();
+            return;
+        }
+#endif
         while (plainSocket->isValid() && (pendingBytes = q_BIO_pending(writeBio)) > 0
                 && plainSocket->openMode() != QIODevice::NotOpen) {
             // Read encrypted data from the write BIO into a buffer.
@@ -1350,6 +1433,9 @@ bool QSslSocketBackendPrivate::startHandshake()
 #ifdef QSSLSOCKET_DEBUG
             qCDebug(lcSsl) << "QSslSocketBackendPrivate::startHandshake: error!" << errorString;
 #endif
+            // Don't offer the server a session it may have choked on again
+            if (!sessionCacheKey.isEmpty())
+                QSslSessionCache::instance()->remove(sessionCacheKey);
             {
                 const ScopedBool bg(inSetAndEmitError, true);
                 setErrorAndEmit(QAbstractSocket::SslHandshakeFailedError, errorString);
@@ -1506,11 +1592,6 @@ int QSslSocketBackendPrivate::handleNewSessionTicket(SSL *connection)
 
     Q_ASSERT(connection);
 
-    if (q->sslConfiguration().testSslOption(QSsl::SslOptionDisableSessionPersistence)) {
-        // We silently ignore, do nothing, remove from cache.
-        return 0;
-    }
-
     SSL_SESSION *currentSession = q_SSL_get_session(connection);
     if (!currentSession) {
         qCWarning(lcSsl,
@@ -1523,6 +1604,14 @@ int QSslSocketBackendPrivate::handleNewSessionTicket(SSL *connection)
         return 0;
     }
 
+    // TLS 1.3 sessions only become resumable with a ticket
+    storeSharedSession(currentSession);
+
+    if (q->sslConfiguration().testSslOption(QSsl::SslOptionDisableSessionPersistence)) {
+        // We silently ignore, do nothing, remove from cache.
+        return 0;
+    }
+
 #ifdef TLS1_3_VERSION
     if (!q_SSL_SESSION_is_resumable(currentSession)) {
         qCDebug(lcSsl, "New session ticket, but the session is non-resumable");
@@ -1551,6 +1640,36 @@ int QSslSocketBackendPrivate::handleNewSessionTicket(SSL *connection)
     return 0;
 }
 
+void QSslSocketBackendPrivate::storeSharedSession(SSL_SESSION *session)
+{
+    // A session whose certificate errors were ignored must not be resumed
+    // by a socket that would not ignore them. Without verification, the
+    // errors don't matter: only such sockets share the session.
+    if (sessionCacheKey.isEmpty() || !session
+        || (!sslErrors.isEmpty() && configuration.peerVerifyMode != QSslSocket::VerifyNone)) {
+        return;
+    }
+
+#ifdef TLS1_3_VERSION
+    if (!q_SSL_SESSION_is_resumable(session))
+        return;
+#endif
+
+    const int sessionSize = q_i2d_SSL_SESSION(session, nullptr);
+    if (sessionSize <= 0)
+        return;
+
+    QByteArray sessionData(sessionSize, Qt::Uninitialized);
+    auto data = reinterpret_cast<unsigned char *>(sessionData.data());
+    if (!q_i2d_SSL_SESSION(session, &data))
+        return;
+
+    const long lifetimeHint = long(q_SSL_SESSION_get_ticket_lifetime_hint(session));
+    const long lifetime = lifetimeHint > 0 ? lifetimeHint : q_SSL_SESSION_get_timeout(session);
+    QSslSessionCache::instance()->insert(sessionCacheKey, sessionData,
+                                         lifetime > 0 ? int(qMin(lifetime, long(INT_MAX))) : -1);
+}
+
 bool QSslSocketBackendPrivate::checkSslErrors()
 {
     Q_Q(QSslSocket);
@@ -1891,6 +2010,13 @@ bool QSslSocketBackendPrivate::checkOcspStatus()
 void QSslSocketBackendPrivate::disconnectFromHost()
 {
     if (ssl) {
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+        if (kernelTlsTransmit && !shutdown && !systemOrSslErrorDetected) {
+            shutdown = true;
+            transmit();
+            sendKernelTlsCloseNotify();
+        }
+#endif
         if (!shutdown && !q_SSL_in_init(ssl) && !systemOrSslErrorDetected) {
             if (q_SSL_shutdown(ssl) != 1) {
                 // Some error may be queued, clear it.
@@ -1994,6 +2120,9 @@ void QSslSocketBackendPrivate::continueHandshake()
     }
 #endif
 
+    // Share this SSL session with other sockets connecting to the same server
+    storeSharedSession(q_SSL_get_session(ssl));
+
     // Cache this SSL session inside the QSslContext
     if (!(configuration.sslOptions & QSsl::SslOptionDisableSessionSharing)) {
         if (!sslContextPointer->cacheSession(ssl)) {
@@ -2041,6 +2170,14 @@ void QSslSocketBackendPrivate::continueHandshake()
             configuration.ephemeralServerKey = QSslKey(key, QSsl::PublicKey);
     }
 
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+    if (!kernelTlsSecret.isEmpty()) {
+        kernelTlsTransmit = enableKernelTlsTransmit();
+        kernelTlsSecret.fill(0);
+        kernelTlsSecret.clear();
+    }
+#endif
+
     connectionEncrypted = true;
     emit q->encrypted();
     if (autoStartHandshake && pendingClose) {
@@ -2049,6 +2186,178 @@ void QSslSocketBackendPrivate::continueHandshake()
     }
 }
 
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+namespace {
+// HKDF-Expand-Label from RFC 8446, for outputs no longer than one hash
+QByteArray hkdfExpandLabel(QCryptographicHash::Algorithm algorithm, const QByteArray &secret,
+                           const QByteArray &label, int length)
+{
+    const QByteArray fullLabel = "tls13 " + label;
+    QByteArray info;
+    info.append(char(length >> 8)).append(char(length));
+    info.append(char(fullLabel.size())).append(fullLabel);
+    info.append(char(0)); // no context
+    info.append(char(1)); // first and only block
+    return QMessageAuthenticationCode::hash(info, secret, algorithm).left(length);
+}
+
+template <typename CryptoInfo>
+socklen_t setupKernelTlsCryptoInfo(CryptoInfo *info, quint16 cipherType,
+                                   QCryptographicHash::Algorithm algorithm,
+                                   const QByteArray &secret, quint64 sequenceNumber)
+{
+    info->info.version = TLS_1_3_VERSION;
+    info->info.cipher_type = cipherType;
+    const QByteArray key = hkdfExpandLabel(algorithm, secret, "key", int(sizeof info->key));
+    // The kernel takes the TLS 1.3 IV split like TLS 1.2's salt and nonce
+    const QByteArray iv = hkdfExpandLabel(algorithm, secret, "iv",
+                                          int(sizeof info->salt + sizeof info->iv));
+    memcpy(info->key, key.constData(), sizeof info->key);
+    memcpy(info->salt, iv.constData(), sizeof info->salt);
+    memcpy(info->iv, iv.constData() + sizeof info->salt, sizeof info->iv);
+    qToBigEndian(sequenceNumber, info->rec_seq);
+    return socklen_t(sizeof *info);
+}
+
+// TLS 1.3 disguises all encrypted records as application data
+int countEncryptedRecords(const char *data, int size)
+{
+    int count = 0;
+    for (int pos = 0; pos + 5 <= size; ) {
+        if (uchar(data[pos]) == 23)
+            ++count;
+        pos += 5 + (uchar(data[pos + 3]) << 8 | uchar(data[pos + 4]));
+    }
+    return count;
+}
+} // unnamed namespace
+
+void QSslSocketBackendPrivate::handleKeyLogLine(const char *line)
+{
+    // "<label> <client random> <secret>"; we need the secret we send with
+    const QByteArray label = mode == QSslSocket::SslClientMode
+            ? QByteArrayLiteral("CLIENT_TRAFFIC_SECRET_0")
+            : QByteArrayLiteral("SERVER_TRAFFIC_SECRET_0");
+    const QList<QByteArray> fields = QByteArray(line).split(' ');
+    if (fields.size() == 3 && fields.at(0) == label)
+        kernelTlsSecret = QByteArray::fromHex(fields.at(2));
+}
+
+/*
+    Hands encryption of outgoing application data to the kernel. Only
+    TLS 1.3 is supported: there, the traffic secret OpenSSL logs and the
+    records we have seen so far tell us the key and the sequence number.
+*/
+bool QSslSocketBackendPrivate::enableKernelTlsTransmit()
+{
+    // A proxy's socket engine frames the data itself
+    auto plainSocketPrivate = static_cast<QAbstractSocketPrivate *>(QObjectPrivate::get(plainSocket));
+    if (!qobject_cast<QNativeSocketEngine *>(plainSocketPrivate->socketEngine)
+        || q_SSL_version(ssl) != TLS1_3_VERSION) {
+        return false;
+    }
+
+    enum { Aes128Gcm, Aes256Gcm, Chacha20Poly1305 } cipher;
+    const QString cipherName = sessionCipher().name();
+    if (cipherName == QLatin1String("TLS_AES_128_GCM_SHA256"))
+        cipher = Aes128Gcm;
+    else if (cipherName == QLatin1String("TLS_AES_256_GCM_SHA384"))
+        cipher = Aes256Gcm;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    else if (cipherName == QLatin1String("TLS_CHACHA20_POLY1305_SHA256"))
+        cipher = Chacha20Poly1305;
+#endif
+    else
+        return false;
+
+    // OpenSSL still seals the records of the handshake's last step: a
+    // client's Finished message, or a server's session tickets. The latter
+    // already use the traffic key, so the kernel continues their sequence.
+    quint64 sequenceNumber = 0;
+    QVarLengthArray<char, 4096> data;
+    int pendingBytes;
+    while ((pendingBytes = q_BIO_pending(writeBio)) > 0) {
+        data.resize(pendingBytes);
+        const int encryptedBytesRead = q_BIO_read(writeBio, data.data(), pendingBytes);
+        if (encryptedBytesRead <= 0)
+            return false;
+        if (mode == QSslSocket::SslServerMode)
+            sequenceNumber += countEncryptedRecords(data.constData(), encryptedBytesRead);
+        if (plainSocket->write(data.constData(), encryptedBytesRead) < 0)
+            return false;
+    }
+
+    // These records have to be in the kernel before it takes over
+    plainSocket->flush();
+    if (plainSocket->bytesToWrite() > 0)
+        return false;
+
+    union {
+        tls12_crypto_info_aes_gcm_128 aes128;
+        tls12_crypto_info_aes_gcm_256 aes256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        tls12_crypto_info_chacha20_poly1305 chacha20;
+#endif
+    } cryptoInfo;
+    memset(&cryptoInfo, 0, sizeof cryptoInfo);
+
+    socklen_t cryptoInfoSize = 0;
+    switch (cipher) {
+    case Aes128Gcm:
+        cryptoInfoSize = setupKernelTlsCryptoInfo(&cryptoInfo.aes128, TLS_CIPHER_AES_GCM_128,
+                                                  QCryptographicHash::Sha256,
+                                                  kernelTlsSecret, sequenceNumber);
+        break;
+    case Aes256Gcm:
+        cryptoInfoSize = setupKernelTlsCryptoInfo(&cryptoInfo.aes256, TLS_CIPHER_AES_GCM_256,
+                                                  QCryptographicHash::Sha384,
+                                                  kernelTlsSecret, sequenceNumber);
+        break;
+    case Chacha20Poly1305:
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        cryptoInfoSize = setupKernelTlsCryptoInfo(&cryptoInfo.chacha20, TLS_CIPHER_CHACHA20_POLY1305,
+                                                  QCryptographicHash::Sha256,
+                                                  kernelTlsSecret, sequenceNumber);
+#endif
+        break;
+    }
+
+    const int descriptor = int(plainSocket->socketDescriptor());
+    bool enabled = ::setsockopt(descriptor, SOL_TCP, TCP_ULP, "tls", sizeof "tls") == 0
+            && ::setsockopt(descriptor, SOL_TLS, TLS_TX, &cryptoInfo, cryptoInfoSize) == 0;
+    if (!enabled)
+        qCDebug(lcSsl) << "Kernel TLS is not available:" << qt_error_string(errno);
+    memset(&cryptoInfo, 0, sizeof cryptoInfo);
+    return enabled;
+}
+
+void QSslSocketBackendPrivate::sendKernelTlsCloseNotify()
+{
+    // The alert must follow the data, and the plain socket may still be
+    // holding some. In that case the peer only sees the connection close.
+    if (!plainSocket->isValid())
+        return;
+    plainSocket->flush();
+    if (plainSocket->bytesToWrite() > 0)
+        return;
+
+    char alert[2] = { 1, 0 }; // warning, close_notify
+    iovec vector = { alert, sizeof alert };
+    char control[CMSG_SPACE(sizeof(unsigned char))] = {};
+    msghdr message = {};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof control;
+    cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_TLS;
+    header->cmsg_type = TLS_SET_RECORD_TYPE;
+    header->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+    *CMSG_DATA(header) = 21; // alert
+    qt_safe_sendmsg(int(plainSocket->socketDescriptor()), &message, 0);
+}
+#endif // QSSLSOCKET_OPENSSL_HAVE_KTLS
+
 bool QSslSocketPrivate::ensureLibraryLoaded()
 {
     if (!q_resolveOpenSslSymbols())
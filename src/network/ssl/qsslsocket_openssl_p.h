@@ -87,6 +87,7 @@
 #include <openssl/bn.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
 #include <openssl/pem.h>
 #include <openssl/pkcs12.h>
 #include <openssl/pkcs7.h>
@@ -105,6 +106,12 @@
 #include <openssl/dh.h>
 #endif
 
+// With the Qt-KTLS backend option, encryption of outgoing application
+// data moves to the kernel after a TLS 1.3 handshake.
+#if defined(Q_OS_LINUX) && defined(TLS1_3_VERSION) && QT_HAS_INCLUDE(<linux/tls.h>)
+#  define QSSLSOCKET_OPENSSL_HAVE_KTLS
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if defined(OPENSSL_VERSION_MAJOR) && OPENSSL_VERSION_MAJOR >= 3
@@ -143,6 +150,15 @@ public:
     bool inSslRead = false;
     bool renegotiated = false;
 
+    // Key of our session in QSslSessionCache, empty if it is not shared
+    QByteArray sessionCacheKey;
+
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+    // Our application traffic secret, until the kernel has it
+    QByteArray kernelTlsSecret;
+    bool kernelTlsTransmit = false;
+#endif
+
     // Platform specific functions
     void startClientEncryption() override;
     void startServerEncryption() override;
@@ -156,6 +172,12 @@ public:
     bool checkSslErrors();
     void storePeerCertificates();
     int handleNewSessionTicket(SSL *context);
+    void storeSharedSession(SSL_SESSION *session);
+#ifdef QSSLSOCKET_OPENSSL_HAVE_KTLS
+    void handleKeyLogLine(const char *line);
+    bool enableKernelTlsTransmit();
+    void sendKernelTlsCloseNotify();
+#endif
     unsigned int tlsPskClientCallback(const char *hint, char *identity, unsigned int max_identity_len, unsigned char *psk, unsigned int max_psk_len);
     unsigned int tlsPskServerCallback(const char *identity, unsigned char *psk, unsigned int max_psk_len);
 
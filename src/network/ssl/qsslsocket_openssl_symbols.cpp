@@ -286,6 +286,8 @@ DEFINEFUNC(const EVP_CIPHER *, EVP_aes_192_cbc, DUMMYARG, DUMMYARG, return nullp
 DEFINEFUNC(const EVP_CIPHER *, EVP_aes_256_cbc, DUMMYARG, DUMMYARG, return nullptr, return)
 #endif
 DEFINEFUNC(const EVP_MD *, EVP_sha1, DUMMYARG, DUMMYARG, return nullptr, return)
+DEFINEFUNC(const EVP_MD *, EVP_sha256, DUMMYARG, DUMMYARG, return nullptr, return)
+DEFINEFUNC5(int, HMAC_Init_ex, HMAC_CTX *ctx, ctx, const void *key, key, int len, len, const EVP_MD *md, md, ENGINE *impl, impl, return 0, return)
 DEFINEFUNC3(int, EVP_PKEY_assign, EVP_PKEY *a, a, int b, b, char *c, c, return -1, return)
 DEFINEFUNC2(int, EVP_PKEY_set1_RSA, EVP_PKEY *a, a, RSA *b, b, return -1, return)
 DEFINEFUNC2(int, EVP_PKEY_set1_DSA, EVP_PKEY *a, a, DSA *b, b, return -1, return)
@@ -394,6 +396,12 @@ DEFINEFUNC2(int, SSL_set_session, SSL* to, to, SSL_SESSION *session, session, re
 DEFINEFUNC(void, SSL_SESSION_free, SSL_SESSION *ses, ses, return, DUMMYARG)
 DEFINEFUNC(SSL_SESSION*, SSL_get1_session, SSL *ssl, ssl, return nullptr, return)
 DEFINEFUNC(SSL_SESSION*, SSL_get_session, const SSL *ssl, ssl, return nullptr, return)
+DEFINEFUNC2(const unsigned char *, SSL_SESSION_get_id, const SSL_SESSION *s, s, unsigned int *len, len, return nullptr, return)
+DEFINEFUNC(long, SSL_SESSION_get_timeout, const SSL_SESSION *s, s, return 0, return)
+DEFINEFUNC3(int, SSL_CTX_set_session_id_context, SSL_CTX *ctx, ctx, const unsigned char *sid_ctx, sid_ctx, unsigned int sid_ctx_len, sid_ctx_len, return 0, return)
+DEFINEFUNC2(void, SSL_CTX_sess_set_get_cb, SSL_CTX *ctx, ctx, GetSessionCallback cb, cb, return, DUMMYARG)
+DEFINEFUNC2(void, SSL_CTX_sess_set_remove_cb, SSL_CTX *ctx, ctx, RemoveSessionCallback cb, cb, return, DUMMYARG)
+DEFINEFUNC2(void, SSL_CTX_set_keylog_callback, SSL_CTX *ctx, ctx, KeylogCallback cb, cb, return, DUMMYARG)
 DEFINEFUNC3(int, SSL_set_ex_data, SSL *ssl, ssl, int idx, idx, void *arg, arg, return 0, return)
 DEFINEFUNC2(void *, SSL_get_ex_data, const SSL *ssl, ssl, int idx, idx, return nullptr, return)
 
@@ -1032,6 +1040,8 @@ bool q_resolveOpenSslSymbols()
     RESOLVEFUNC(EVP_aes_256_cbc)
 #endif
     RESOLVEFUNC(EVP_sha1)
+    RESOLVEFUNC(EVP_sha256)
+    RESOLVEFUNC(HMAC_Init_ex)
     RESOLVEFUNC(EVP_PKEY_assign)
     RESOLVEFUNC(EVP_PKEY_set1_RSA)
     RESOLVEFUNC(EVP_PKEY_set1_DSA)
@@ -1135,6 +1145,12 @@ bool q_resolveOpenSslSymbols()
     RESOLVEFUNC(SSL_SESSION_free)
     RESOLVEFUNC(SSL_get1_session)
     RESOLVEFUNC(SSL_get_session)
+    RESOLVEFUNC(SSL_SESSION_get_id)
+    RESOLVEFUNC(SSL_SESSION_get_timeout)
+    RESOLVEFUNC(SSL_CTX_set_session_id_context)
+    RESOLVEFUNC(SSL_CTX_sess_set_get_cb)
+    RESOLVEFUNC(SSL_CTX_sess_set_remove_cb)
+    RESOLVEFUNC(SSL_CTX_set_keylog_callback)
     RESOLVEFUNC(SSL_set_ex_data)
     RESOLVEFUNC(SSL_get_ex_data)
     RESOLVEFUNC(SSL_get_ex_data_X509_STORE_CTX_idx)
@@ -414,6 +414,8 @@ const EVP_CIPHER *q_EVP_aes_256_cbc();
 #endif // OPENSSL_NO_AES
 
 Q_AUTOTEST_EXPORT const EVP_MD *q_EVP_sha1();
+const EVP_MD *q_EVP_sha256();
+int q_HMAC_Init_ex(HMAC_CTX *ctx, const void *key, int len, const EVP_MD *md, ENGINE *impl);
 int q_EVP_PKEY_assign(EVP_PKEY *a, int b, char *c);
 Q_AUTOTEST_EXPORT int q_EVP_PKEY_set1_RSA(EVP_PKEY *a, RSA *b);
 Q_AUTOTEST_EXPORT int q_EVP_PKEY_set1_DSA(EVP_PKEY *a, DSA *b);
@@ -524,6 +526,25 @@ int q_SSL_set_session(SSL *to, SSL_SESSION *session);
 void q_SSL_SESSION_free(SSL_SESSION *ses);
 SSL_SESSION *q_SSL_get1_session(SSL *ssl);
 SSL_SESSION *q_SSL_get_session(const SSL *ssl);
+const unsigned char *q_SSL_SESSION_get_id(const SSL_SESSION *s, unsigned int *len);
+long q_SSL_SESSION_get_timeout(const SSL_SESSION *s);
+int q_SSL_CTX_set_session_id_context(SSL_CTX *ctx, const unsigned char *sid_ctx, unsigned int sid_ctx_len);
+extern "C"
+{
+using GetSessionCallback = SSL_SESSION *(*)(SSL *, const unsigned char *, int, int *);
+using RemoveSessionCallback = void (*)(SSL_CTX *, SSL_SESSION *);
+using KeylogCallback = void (*)(const SSL *, const char *);
+}
+void q_SSL_CTX_sess_set_get_cb(SSL_CTX *ctx, GetSessionCallback cb);
+void q_SSL_CTX_sess_set_remove_cb(SSL_CTX *ctx, RemoveSessionCallback cb);
+void q_SSL_CTX_set_keylog_callback(SSL_CTX *ctx, KeylogCallback cb);
+extern "C"
+{
+using TicketKeyCallback = int (*)(SSL *, unsigned char *, unsigned char *, EVP_CIPHER_CTX *,
+                                  HMAC_CTX *, int);
+}
+#define q_SSL_CTX_set_tlsext_ticket_key_cb(ctx, cb) \
+    q_SSL_CTX_callback_ctrl((ctx), SSL_CTRL_SET_TLSEXT_TICKET_KEY_CB, GenericCallbackType(TicketKeyCallback(cb)))
 int q_SSL_set_ex_data(SSL *ssl, int idx, void *arg);
 void *q_SSL_get_ex_data(const SSL *ssl, int idx);
 #ifndef OPENSSL_NO_PSK
@@ -196,6 +196,8 @@ public:
     virtual QByteArray peek(qint64 maxSize) override;
     qint64 skip(qint64 maxSize) override;
     bool flush() override;
+    qint64 sendFile(QFile *file, qint64 offset, qint64 size) override;
+    qint64 writeVector(const QByteArrayList &buffers) override;
 
     // Platform specific functions
     virtual void startClientEncryption() = 0;
@@ -86,6 +86,7 @@ qtConfig(ssl) {
     qtConfig(openssl) {
         HEADERS += ssl/qsslcontext_openssl_p.h \
                    ssl/qsslsocket_openssl_p.h \
+                   ssl/qsslsessioncache_p.h \
                    ssl/qsslsocket_openssl_symbols_p.h
         SOURCES += ssl/qsslsocket_openssl_symbols.cpp \
                    ssl/qssldiffiehellmanparameters_openssl.cpp \
@@ -94,6 +95,7 @@ qtConfig(ssl) {
                    ssl/qsslkey_openssl.cpp \
                    ssl/qsslsocket_openssl.cpp \
                    ssl/qsslcontext_openssl.cpp \
+                   ssl/qsslsessioncache.cpp \
 
         qtConfig(dtls) {
             HEADERS += ssl/qdtls_openssl_p.h
@@ -52,9 +52,12 @@
 #include <qstringlist.h>
 #include <qlocale.h>
 #include <QtSql/private/qsqlresult_p.h>
+#include <QtSql/private/qsqlcolumnblock_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 #include <QtCore/private/qlocale_tools_p.h>
 
+#include <QScopedValueRollback>
+
 #include <queue>
 
 #include <libpq-fe.h>
@@ -143,6 +146,7 @@ protected:
     QVariant lastInsertId() const override;
     bool prepare(const QString &query) override;
     bool exec() override;
+    bool execBatch(bool arrayBind) override;
 };
 
 class QPSQLDriverPrivate final : public QSqlDriverPrivate
@@ -153,6 +157,7 @@ public:
 
     QStringList seid;
     PGconn *connection = nullptr;
+    PGcancel *cancel = nullptr;
     QSocketNotifier *sn = nullptr;
     QPSQLDriver::Protocol pro = QPSQLDriver::Version6;
     StatementId currentStmtId = InvalidStatementId;
@@ -291,6 +296,7 @@ public:
     using QSqlResultPrivate::QSqlResultPrivate;
 
     QString fieldSerial(int i) const override { return QLatin1Char('$') + QString::number(i + 1); }
+    void fetchBlock(QSqlColumnBlockPrivate *block) override;
     void deallocatePreparedStmt();
 
     std::queue<PGresult*> nextResultSets;
@@ -715,6 +721,76 @@ bool QPSQLResult::isNull(int field)
     return PQgetisnull(d->result, currentRow, field);
 }
 
+void QPSQLResultPrivate::fetchBlock(QSqlColumnBlockPrivate *block)
+{
+    Q_Q(QPSQLResult);
+    const bool isUtf8 = drv_d_func()->isUtf8;
+    while (block->rowCount < block->capacity) {
+        if (!q->fetchNext()) {
+            q->setAt(QSql::AfterLastRow);
+            return;
+        }
+        const int row = block->rowCount++;
+        const int currentRow = q->isForwardOnly() ? 0 : q->at();
+        const int columnCount = qMin(block->columnCount(), PQnfields(result));
+        for (int i = 0; i < columnCount; ++i) {
+            if (PQgetisnull(result, currentRow, i)) {
+                block->setNull(row, i);
+                continue;
+            }
+            // Decode the common cases from the wire text directly; everything
+            // else is converted the same way data() does it.
+            const char *val = PQgetvalue(result, currentRow, i);
+            const int len = PQgetlength(result, currentRow, i);
+            const QVariant::Type type = qDecodePSQLType(PQftype(result, i));
+            bool ok = false;
+            switch (block->columnType(i)) {
+            case QMetaType::LongLong:
+                if (type == QVariant::Bool) {
+                    block->setInt64(row, i, val[0] == 't');
+                    continue;
+                }
+                if (type == QVariant::Int || type == QVariant::LongLong) {
+                    const qlonglong value = QByteArray::fromRawData(val, len).toLongLong(&ok);
+                    if (ok) {
+                        block->setInt64(row, i, value);
+                        continue;
+                    }
+                }
+                break;
+            case QMetaType::Double:
+                if (type == QVariant::Double || type == QVariant::Int || type == QVariant::LongLong) {
+                    const double value = qstrtod(val, nullptr, &ok);
+                    if (ok) {
+                        block->setDouble(row, i, value);
+                        continue;
+                    }
+                }
+                break;
+            case QMetaType::QByteArray:
+                if (type == QVariant::ByteArray) {
+                    size_t size;
+                    unsigned char *data = PQunescapeBytea(reinterpret_cast<const unsigned char *>(val), &size);
+                    block->setBytes(row, i, reinterpret_cast<const char *>(data), int(size));
+                    qPQfreemem(data);
+                    continue;
+                }
+                break;
+            default:
+                if (type == QVariant::String) {
+                    if (isUtf8)
+                        block->setUtf8(row, i, val, len);
+                    else
+                        block->setLatin1(row, i, val, len);
+                    continue;
+                }
+                break;
+            }
+            block->setValue(row, i, q->data(i));
+        }
+    }
+}
+
 bool QPSQLResult::reset(const QString &query)
 {
     Q_D(QPSQLResult);
@@ -938,6 +1014,82 @@ bool QPSQLResult::exec()
     return d->processResults();
 }
 
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+    if (!d->preparedQueriesEnabled || d->preparedStmtId.isEmpty())
+        return QSqlResult::execBatch(arrayBind);
+
+    QScopedValueRollback<QVector<QVariant>> valuesScope(d->values);
+    const QVector<QVariant> values = d->values;
+    if (values.count() == 0)
+        return false;
+
+    QVector<QVariantList> columns;
+    columns.reserve(values.count());
+    for (const QVariant &value : values)
+        columns.append(value.toList());
+    const int rowCount = columns.at(0).count();
+    if (rowCount == 0)
+        return true;
+
+    const auto bindRow = [&](int row) {
+        for (int j = 0; j < columns.count(); ++j)
+            d->values[j] = columns.at(j).value(row);
+    };
+
+    // All rows but the last are pipelined: up to BatchChunkSize EXECUTE
+    // statements are sent in a single query string, which costs one round
+    // trip and which the server runs as one implicit transaction. The last
+    // row goes through exec() so that the result is in the same state as
+    // after executing the statement directly.
+    enum { BatchChunkSize = 1024, BatchChunkLength = 1024 * 1024 };
+    const QString executePrefix = QStringLiteral("EXECUTE %1 (").arg(d->preparedStmtId);
+    QString stmt;
+    int chunkStart = 0;
+    for (int i = 0; i < rowCount - 1; ++i) {
+        bindRow(i);
+        const QString params = qCreateParamString(d->values, driver());
+        if (params.isEmpty())
+            stmt += QStringLiteral("EXECUTE %1;").arg(d->preparedStmtId);
+        else
+            stmt += executePrefix + params + QLatin1String(");");
+
+        if (i + 1 - chunkStart < BatchChunkSize && stmt.size() < BatchChunkLength && i < rowCount - 2)
+            continue;
+
+        cleanup();
+        PGresult *result = d->drv_d_func()->exec(stmt);
+        const int status = PQresultStatus(result);
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+            if (PQtransactionStatus(d->drv_d_func()->connection) != PQTRANS_IDLE) {
+                // The user's transaction is aborted now; replaying rows would fail anyway.
+                setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                        "Unable to execute batch"), QSqlError::StatementError,
+                                        d->drv_d_func(), result));
+                PQclear(result);
+                return false;
+            }
+            // The implicit transaction rolled the whole chunk back. Replay it
+            // row by row so that the rows before the failing one are kept and
+            // the error is reported for the row that caused it.
+            PQclear(result);
+            for (int row = chunkStart; row <= i; ++row) {
+                bindRow(row);
+                if (!exec())
+                    return false;
+            }
+        } else {
+            PQclear(result);
+        }
+        stmt.clear();
+        chunkStart = i + 1;
+    }
+
+    bindRow(rowCount - 1);
+    return exec();
+}
+
 ///////////////////////////////////////////////////////////////////
 
 bool QPSQLDriverPrivate::setEncodingUtf8()
@@ -1129,6 +1281,7 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
     Q_D(QPSQLDriver);
     d->connection = conn;
     if (conn) {
+        d->cancel = PQgetCancel(conn);
         d->pro = d->getPSQLVersion();
         d->detectBackslashEscape();
         setOpen(true);
@@ -1139,6 +1292,8 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
 QPSQLDriver::~QPSQLDriver()
 {
     Q_D(QPSQLDriver);
+    if (d->cancel)
+        PQfreeCancel(d->cancel);
     if (d->connection)
         PQfinish(d->connection);
 }
@@ -1164,11 +1319,12 @@ bool QPSQLDriver::hasFeature(DriverFeature f) const
     case PreparedQueries:
     case PositionalPlaceholders:
         return d->pro >= QPSQLDriver::Version8_2;
+    case CancelQuery:
+        return true;
     case BatchOperations:
     case NamedPlaceholders:
     case SimpleLocking:
     case FinishQuery:
-    case CancelQuery:
         return false;
     case Unicode:
         return d->isUtf8;
@@ -1227,6 +1383,8 @@ bool QPSQLDriver::open(const QString &db,
         return false;
     }
 
+    // Obtained up front, as PQcancel() may be used from other threads
+    d->cancel = PQgetCancel(d->connection);
     d->pro = d->getPSQLVersion();
     d->detectBackslashEscape();
     d->isUtf8 = d->setEncodingUtf8();
@@ -1249,6 +1407,9 @@ void QPSQLDriver::close()
         d->sn = nullptr;
     }
 
+    if (d->cancel)
+        PQfreeCancel(d->cancel);
+    d->cancel = nullptr;
     if (d->connection)
         PQfinish(d->connection);
     d->connection = nullptr;
@@ -1256,6 +1417,19 @@ void QPSQLDriver::close()
     setOpenError(false);
 }
 
+bool QPSQLDriver::cancelQuery()
+{
+    Q_D(QPSQLDriver);
+    if (!d->cancel)
+        return false;
+    char errorBuffer[256];
+    if (!PQcancel(d->cancel, errorBuffer, sizeof(errorBuffer))) {
+        qWarning("QPSQLDriver::cancelQuery: %s", errorBuffer);
+        return false;
+    }
+    return true;
+}
+
 QSqlResult *QPSQLDriver::createResult() const
 {
     return new QPSQLResult(this);
@@ -124,6 +124,8 @@ public:
     bool unsubscribeFromNotification(const QString &name) override;
     QStringList subscribedToNotifications() const override;
 
+    bool cancelQuery() override;
+
 protected:
     bool beginTransaction() override;
     bool commitTransaction() override;
@@ -47,6 +47,7 @@
 #include <qsqlindex.h>
 #include <qsqlquery.h>
 #include <QtSql/private/qsqlcachedresult_p.h>
+#include <QtSql/private/qsqlcolumnblock_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 #include <qstringlist.h>
 #include <qvector.h>
@@ -165,6 +166,7 @@ public:
     using QSqlCachedResultPrivate::QSqlCachedResultPrivate;
     void cleanup();
     bool fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch);
+    void fetchBlock(QSqlColumnBlockPrivate *block) override;
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
@@ -353,6 +355,66 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
     return false;
 }
 
+void QSQLiteResultPrivate::fetchBlock(QSqlColumnBlockPrivate *block)
+{
+    Q_Q(QSQLiteResult);
+    // Scrollable results have to go through the row cache
+    if (!q->isForwardOnly() || !stmt) {
+        QSqlCachedResultPrivate::fetchBlock(block);
+        return;
+    }
+
+    const int columnCount = qMin(block->columnCount(), sqlite3_column_count(stmt));
+    const int firstIndex = q->at() + 1;
+    int &row = block->rowCount;
+    if (skipRow) {
+        // exec() has already stepped to the first row
+        skipRow = false;
+        if (!skippedStatus) {
+            atEnd = true;
+            q->setAt(QSql::AfterLastRow);
+            return;
+        }
+        for (int i = 0; i < columnCount; ++i)
+            block->setValue(row, i, firstRow.at(i));
+        ++row;
+    }
+
+    while (row < block->capacity) {
+        // Only steps the statement, the values are read directly below
+        if (!fetchNext(cache, -1, false)) {
+            atEnd = true;
+            return;
+        }
+        for (int i = 0; i < columnCount; ++i) {
+            if (sqlite3_column_type(stmt, i) == SQLITE_NULL) {
+                block->setNull(row, i);
+                continue;
+            }
+            switch (block->columnType(i)) {
+            case QMetaType::LongLong:
+                block->setInt64(row, i, sqlite3_column_int64(stmt, i));
+                break;
+            case QMetaType::Double:
+                block->setDouble(row, i, sqlite3_column_double(stmt, i));
+                break;
+            case QMetaType::QByteArray: {
+                // The pointer must be fetched before the size
+                const void *data = sqlite3_column_blob(stmt, i);
+                block->setBytes(row, i, static_cast<const char *>(data), sqlite3_column_bytes(stmt, i));
+                break; }
+            default: {
+                const void *data = sqlite3_column_text16(stmt, i);
+                block->setString(row, i, static_cast<const QChar *>(data),
+                                 sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
+                break; }
+            }
+        }
+        ++row;
+    }
+    q->setAt(firstIndex + row - 1);
+}
+
 QSQLiteResult::QSQLiteResult(const QSQLiteDriver* db)
     : QSqlCachedResult(*new QSQLiteResultPrivate(this, db))
 {
@@ -417,24 +479,65 @@ bool QSQLiteResult::prepare(const QString &query)
 bool QSQLiteResult::execBatch(bool arrayBind)
 {
     Q_UNUSED(arrayBind);
-    Q_D(QSqlResult);
+    Q_D(QSQLiteResult);
     QScopedValueRollback<QVector<QVariant>> valuesScope(d->values);
-    QVector<QVariant> values = d->values;
+    const QVector<QVariant> values = d->values;
     if (values.count() == 0)
         return false;
 
-    for (int i = 0; i < values.at(0).toList().count(); ++i) {
-        d->values.clear();
-        QScopedValueRollback<QHash<QString, QVector<int>>> indexesScope(d->indexes);
-        QHash<QString, QVector<int>>::const_iterator it = d->indexes.constBegin();
-        while (it != d->indexes.constEnd()) {
-            bindValue(it.key(), values.at(it.value().first()).toList().at(i), QSql::In);
-            ++it;
-        }
-        if (!exec())
+    QVector<QVariantList> columns;
+    columns.reserve(values.count());
+    for (const QVariant &value : values)
+        columns.append(value.toList());
+    const int rowCount = columns.at(0).count();
+
+    // Outside of a transaction SQLite commits, and syncs its journal, after
+    // every single row. Wrap the batch in one transaction unless the user
+    // already opened one; the prepared statement is reused for every row.
+    // Statements returning rows are left alone, as a pending read would make
+    // the COMMIT fail.
+    sqlite3 *access = d->drv_d_func()->access;
+    const bool ownTransaction = rowCount > 1 && d->stmt && sqlite3_column_count(d->stmt) == 0
+            && sqlite3_get_autocommit(access)
+            && sqlite3_exec(access, "BEGIN", nullptr, nullptr, nullptr) == SQLITE_OK;
+
+    const auto execRow = [&](int row) {
+        for (int j = 0; j < columns.count(); ++j)
+            d->values[j] = columns.at(j).value(row);
+        return exec();
+    };
+
+    int row = 0;
+    while (row < rowCount && execRow(row))
+        ++row;
+    bool ok = row == rowCount;
+
+    if (ownTransaction) {
+        // Rows executed before a failing one are kept, exactly as if each of
+        // them had been committed on its own.
+        if (!ok && sqlite3_get_autocommit(access)) {
+            // SQLite rolled the whole transaction back by itself (SQLITE_FULL,
+            // SQLITE_IOERR, SQLITE_BUSY, ON CONFLICT ROLLBACK, ...). Replay
+            // the earlier rows without it and report the original error.
+            const QSqlError error = lastError();
+            for (int i = 0; i < row; ++i) {
+                if (!execRow(i))
+                    return false;
+            }
+            setLastError(error);
             return false;
+        }
+        const int res = sqlite3_exec(access, "COMMIT", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK) {
+            if (ok) {
+                setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                             "Unable to commit batch"), QSqlError::TransactionError, res));
+                ok = false;
+            }
+            sqlite3_exec(access, "ROLLBACK", nullptr, nullptr, nullptr);
+        }
     }
-    return true;
+    return ok;
 }
 
 bool QSQLiteResult::exec()
@@ -693,10 +796,11 @@ bool QSQLiteDriver::hasFeature(DriverFeature f) const
     case LowPrecisionNumbers:
     case EventNotifications:
         return true;
+    case CancelQuery:
+        return true;
     case QuerySize:
     case BatchOperations:
     case MultipleResultSets:
-    case CancelQuery:
         return false;
     case NamedPlaceholders:
 #if (SQLITE_VERSION_NUMBER < 3003011)
@@ -823,6 +927,16 @@ void QSQLiteDriver::close()
     }
 }
 
+bool QSQLiteDriver::cancelQuery()
+{
+    Q_D(QSQLiteDriver);
+    // sqlite3_interrupt() may be called from any thread
+    if (!d->access)
+        return false;
+    sqlite3_interrupt(d->access);
+    return true;
+}
+
 QSqlResult *QSQLiteDriver::createResult() const
 {
     return new QSQLiteResult(this);
@@ -83,6 +83,7 @@ public:
                    int port,
                    const QString & connOpts) override;
     void close() override;
+    bool cancelQuery() override;
     QSqlResult *createResult() const override;
     bool beginTransaction() override;
     bool commitTransaction() override;
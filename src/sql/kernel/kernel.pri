@@ -2,6 +2,7 @@ HEADERS +=      kernel/qtsqlglobal.h \
                 kernel/qtsqlglobal_p.h \
                 kernel/qsqlquery.h \
                 kernel/qsqldatabase.h \
+                kernel/qsqldatabase_p.h \
                 kernel/qsqlfield.h \
                 kernel/qsqlrecord.h \
                 kernel/qsqldriver.h \
@@ -12,6 +13,9 @@ HEADERS +=      kernel/qtsqlglobal.h \
                 kernel/qsqlresult.h \
                 kernel/qsqlresult_p.h \
                 kernel/qsqlcachedresult_p.h \
+                kernel/qsqlcolumnblock.h \
+                kernel/qsqlcolumnblock_p.h \
+                kernel/qsqlconnectionpool.h \
                 kernel/qsqlindex.h
 
 SOURCES +=      kernel/qsqlquery.cpp \
@@ -23,5 +27,11 @@ SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqlerror.cpp \
                 kernel/qsqlresult.cpp \
                 kernel/qsqlindex.cpp \
-                kernel/qsqlcachedresult.cpp
+                kernel/qsqlcachedresult.cpp \
+                kernel/qsqlcolumnblock.cpp \
+                kernel/qsqlconnectionpool.cpp
 
+qtConfig(future) {
+    HEADERS += kernel/qsqlasyncconnection.h
+    SOURCES += kernel/qsqlasyncconnection.cpp
+}
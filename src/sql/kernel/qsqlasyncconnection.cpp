@@ -0,0 +1,726 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsqlasyncconnection.h"
+
+#include "qsqldatabase.h"
+#include "qsqldriver.h"
+#include "qsqlquery.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qfutureinterface.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSqlAsyncResultPrivate : public QSharedData
+{
+public:
+    QSqlError error;
+    QString query;
+    QSqlRecord record;
+    QVector<QVariant> values;
+    QVariant lastInsertId;
+    // Identifies the open result set that fetchMore() continues
+    QString connectionName;
+    quint64 cursor = 0;
+    int rowCount = 0;
+    int numRowsAffected = -1;
+    bool valid = false;
+    bool select = false;
+    bool moreRows = false;
+};
+
+/*!
+    \class QSqlAsyncResult
+    \brief The QSqlAsyncResult class holds the outcome of a query executed by QSqlAsyncConnection.
+    \since 5.15
+
+    \ingroup database
+    \inmodule QtSql
+
+    Unlike QSqlQuery, a QSqlAsyncResult is not tied to a connection or a
+    thread. For a \c SELECT statement it holds the rows of the result,
+    which are accessed with value() or records(): all of them, or one
+    block of them if a \l{QSqlAsyncConnection::setBlockSize()}{block size}
+    is set.
+
+    \sa QSqlAsyncConnection
+*/
+
+/*!
+    Constructs an invalid result.
+*/
+QSqlAsyncResult::QSqlAsyncResult()
+    : d(new QSqlAsyncResultPrivate)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSqlAsyncResult::QSqlAsyncResult(const QSqlAsyncResult &other) = default;
+
+/*!
+    Assigns \a other to this result.
+*/
+QSqlAsyncResult &QSqlAsyncResult::operator=(const QSqlAsyncResult &other) = default;
+
+/*!
+    Destroys the result.
+*/
+QSqlAsyncResult::~QSqlAsyncResult() = default;
+
+/*!
+    Returns \c true if the query was executed successfully.
+
+    \sa lastError()
+*/
+bool QSqlAsyncResult::isValid() const
+{
+    return d->valid;
+}
+
+/*!
+    Returns the error that occurred while opening the connection or while
+    executing the query, if any.
+*/
+QSqlError QSqlAsyncResult::lastError() const
+{
+    return d->error;
+}
+
+/*!
+    Returns the text of the query that produced this result.
+*/
+QString QSqlAsyncResult::lastQuery() const
+{
+    return d->query;
+}
+
+/*!
+    Returns \c true if the query was a \c SELECT statement.
+*/
+bool QSqlAsyncResult::isSelect() const
+{
+    return d->select;
+}
+
+/*!
+    Returns the number of rows in the result, or in this block of it.
+
+    \sa hasMoreRows()
+*/
+int QSqlAsyncResult::size() const
+{
+    return d->rowCount;
+}
+
+/*!
+    Returns the fields of the result, without values.
+*/
+QSqlRecord QSqlAsyncResult::record() const
+{
+    return d->record;
+}
+
+/*!
+    Returns the rows of the result as records. Prefer value() for large
+    results, as every record holds a copy of the field information.
+*/
+QVector<QSqlRecord> QSqlAsyncResult::records() const
+{
+    QVector<QSqlRecord> records;
+    records.reserve(d->rowCount);
+    const int columnCount = d->record.count();
+    for (int row = 0; row < d->rowCount; ++row) {
+        QSqlRecord record = d->record;
+        for (int i = 0; i < columnCount; ++i)
+            record.setValue(i, d->values.at(row * columnCount + i));
+        records.append(record);
+    }
+    return records;
+}
+
+/*!
+    Returns the value of field \a column in \a row, or an invalid QVariant
+    if either is out of range.
+*/
+QVariant QSqlAsyncResult::value(int row, int column) const
+{
+    const int columnCount = d->record.count();
+    if (row < 0 || row >= d->rowCount || column < 0 || column >= columnCount)
+        return QVariant();
+    return d->values.at(row * columnCount + column);
+}
+
+/*!
+    \overload
+
+    Returns the value of the field called \a name in \a row.
+*/
+QVariant QSqlAsyncResult::value(int row, const QString &name) const
+{
+    return value(row, d->record.indexOf(name));
+}
+
+/*!
+    Returns \c true if this result holds one block of the rows of a
+    \c SELECT statement, and the next block can be requested with
+    QSqlAsyncConnection::fetchMore(). The last block may be empty.
+
+    \sa QSqlAsyncConnection::setBlockSize()
+*/
+bool QSqlAsyncResult::hasMoreRows() const
+{
+    return d->moreRows;
+}
+
+/*!
+    Returns the number of rows affected by the query, or -1 if it cannot
+    be determined.
+
+    \sa QSqlQuery::numRowsAffected()
+*/
+int QSqlAsyncResult::numRowsAffected() const
+{
+    return d->numRowsAffected;
+}
+
+/*!
+    Returns the object ID of the most recently inserted row, if the
+    database supports it.
+
+    \sa QSqlQuery::lastInsertId()
+*/
+QVariant QSqlAsyncResult::lastInsertId() const
+{
+    return d->lastInsertId;
+}
+
+class QSqlAsyncConnectionPrivate : public QThread
+{
+public:
+    struct Task
+    {
+        QString query;
+        QVariantList boundValues;
+        QFutureInterface<QSqlAsyncResult> future;
+        int blockSize = 0;
+        // Continues the open result set instead of executing the query
+        bool fetch = false;
+        quint64 cursor = 0;
+    };
+
+    QSqlAsyncConnectionPrivate(const QSqlDatabase &settings);
+
+    void run() override;
+    bool takeTask(Task *task);
+    void taskDone(Task *task);
+    QSqlAsyncResult execute(QSqlDatabase &db, const Task &task);
+    QSqlAsyncResult fetchMore(const Task &task);
+    bool fetchRows(QSqlQuery *query, QSqlAsyncResultPrivate *r, const Task &task);
+    void closeCursor();
+    void cancelQueued();
+
+    const QString connectionName;
+    const QString driverName;
+    const QString databaseName;
+    const QString userName;
+    const QString password;
+    const QString hostName;
+    const QString connectOptions;
+    const int port;
+    const QSql::NumericalPrecisionPolicy precisionPolicy;
+
+    mutable QMutex mutex;
+    QWaitCondition taskAvailable;
+    QWaitCondition idle;
+    QQueue<Task> queue;
+    QFutureInterface<QSqlAsyncResult> running;
+    QSqlDriver *driver = nullptr;
+    int blockSize = 0;
+    bool busy = false;
+    bool quit = false;
+
+    // Only used by the worker thread: the result set of the last query,
+    // while rows of it have not been delivered yet
+    QScopedPointer<QSqlQuery> cursorQuery;
+    QSqlRecord cursorRecord;
+    quint64 cursor = 0;
+    quint64 lastCursor = 0;
+};
+
+static QString qMakeAsyncConnectionName()
+{
+    static QBasicAtomicInt counter = Q_BASIC_ATOMIC_INITIALIZER(0);
+    return QStringLiteral("qt_sql_async_connection_") + QString::number(counter.fetchAndAddRelaxed(1) + 1);
+}
+
+QSqlAsyncConnectionPrivate::QSqlAsyncConnectionPrivate(const QSqlDatabase &settings)
+    : connectionName(qMakeAsyncConnectionName()),
+      driverName(settings.driverName()),
+      databaseName(settings.databaseName()),
+      userName(settings.userName()),
+      password(settings.password()),
+      hostName(settings.hostName()),
+      connectOptions(settings.connectOptions()),
+      port(settings.port()),
+      precisionPolicy(settings.numericalPrecisionPolicy())
+{
+    setObjectName(connectionName);
+}
+
+void QSqlAsyncConnectionPrivate::run()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(driverName, connectionName);
+        db.setDatabaseName(databaseName);
+        db.setUserName(userName);
+        db.setPassword(password);
+        db.setHostName(hostName);
+        db.setConnectOptions(connectOptions);
+        db.setPort(port);
+        db.setNumericalPrecisionPolicy(precisionPolicy);
+
+        Task task;
+        while (takeTask(&task)) {
+            const QSqlAsyncResult result = execute(db, task);
+            task.future.reportResult(result);
+            taskDone(&task);
+        }
+
+        closeCursor();
+        QMutexLocker locker(&mutex);
+        driver = nullptr;
+        locker.unlock();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+bool QSqlAsyncConnectionPrivate::takeTask(Task *task)
+{
+    QMutexLocker locker(&mutex);
+    while (queue.isEmpty() && !quit)
+        taskAvailable.wait(&mutex);
+    if (queue.isEmpty())
+        return false;
+    *task = queue.dequeue();
+    running = task->future;
+    busy = true;
+    return true;
+}
+
+void QSqlAsyncConnectionPrivate::taskDone(Task *task)
+{
+    QMutexLocker locker(&mutex);
+    // Finish under the mutex, so that pendingCount() never counts a task
+    // whose future already is finished
+    task->future.reportFinished();
+    *task = Task();
+    running = QFutureInterface<QSqlAsyncResult>();
+    busy = false;
+    if (queue.isEmpty())
+        idle.wakeAll();
+}
+
+QSqlAsyncResult QSqlAsyncConnectionPrivate::execute(QSqlDatabase &db, const Task &task)
+{
+    if (task.fetch)
+        return fetchMore(task);
+
+    QSqlAsyncResult result;
+    QSqlAsyncResultPrivate *r = result.d.data();
+    r->query = task.query;
+    if (task.future.isCanceled())
+        return result;
+
+    // Only the result set of the last query can be continued
+    closeCursor();
+
+    if (!db.isOpen()) {
+        if (!db.open()) {
+            r->error = db.lastError();
+            return result;
+        }
+        QMutexLocker locker(&mutex);
+        driver = db.driver();
+    }
+
+    QScopedPointer<QSqlQuery> query(new QSqlQuery(db));
+    query->setForwardOnly(true);
+    bool ok;
+    if (task.boundValues.isEmpty()) {
+        ok = query->exec(task.query);
+    } else {
+        ok = query->prepare(task.query);
+        if (ok) {
+            for (const QVariant &value : task.boundValues)
+                query->addBindValue(value);
+            ok = query->exec();
+        }
+    }
+    if (!ok) {
+        r->error = query->lastError();
+        // Reconnect for the next query if the connection went away
+        if (r->error.type() == QSqlError::ConnectionError) {
+            QMutexLocker locker(&mutex);
+            driver = nullptr;
+            locker.unlock();
+            query.reset();
+            db.close();
+        }
+        return result;
+    }
+
+    r->select = query->isSelect();
+    if (r->select) {
+        r->record = query->record();
+        r->record.clearValues();
+        if (!fetchRows(query.data(), r, task))
+            return result;
+    }
+    r->numRowsAffected = query->numRowsAffected();
+    r->lastInsertId = query->lastInsertId();
+    r->valid = true;
+
+    if (r->moreRows) {
+        cursorQuery.reset(query.take());
+        cursorRecord = r->record;
+        cursor = ++lastCursor;
+        r->connectionName = connectionName;
+        r->cursor = cursor;
+    }
+    return result;
+}
+
+QSqlAsyncResult QSqlAsyncConnectionPrivate::fetchMore(const Task &task)
+{
+    QSqlAsyncResult result;
+    QSqlAsyncResultPrivate *r = result.d.data();
+    r->query = task.query;
+    r->select = true;
+    if (!cursorQuery || task.cursor != cursor) {
+        r->error = QSqlError(QString(), QCoreApplication::translate("QSqlAsyncConnection",
+                                 "The result set is no longer available"),
+                             QSqlError::StatementError);
+        return result;
+    }
+    if (task.future.isCanceled())
+        return result;
+
+    r->record = cursorRecord;
+    if (!fetchRows(cursorQuery.data(), r, task)) {
+        closeCursor();
+        return result;
+    }
+    r->valid = true;
+    if (r->moreRows) {
+        r->connectionName = connectionName;
+        r->cursor = cursor;
+    } else {
+        closeCursor();
+    }
+    return result;
+}
+
+// Fetches up to task.blockSize rows, or all of them if it is not positive
+bool QSqlAsyncConnectionPrivate::fetchRows(QSqlQuery *query, QSqlAsyncResultPrivate *r,
+                                           const Task &task)
+{
+    const int columnCount = r->record.count();
+    if (task.blockSize > 0)
+        r->values.reserve(task.blockSize * columnCount);
+    while (task.blockSize <= 0 || r->rowCount < task.blockSize) {
+        if (!query->next()) {
+            if (query->lastError().isValid()) {
+                r->error = query->lastError();
+                return false;
+            }
+            return true;
+        }
+        for (int i = 0; i < columnCount; ++i)
+            r->values.append(query->value(i));
+        // Stop transferring a large result nobody waits for anymore
+        if ((++r->rowCount & 0xff) == 0 && task.future.isCanceled())
+            return false;
+    }
+    r->moreRows = true;
+    return true;
+}
+
+void QSqlAsyncConnectionPrivate::closeCursor()
+{
+    cursorQuery.reset();
+    cursorRecord = QSqlRecord();
+    cursor = 0;
+}
+
+// Call with the mutex locked
+void QSqlAsyncConnectionPrivate::cancelQueued()
+{
+    for (Task &task : queue) {
+        task.future.cancel();
+        task.future.reportFinished();
+    }
+    queue.clear();
+    if (!busy)
+        idle.wakeAll();
+}
+
+/*!
+    \class QSqlAsyncConnection
+    \brief The QSqlAsyncConnection class executes queries on a database connection owned by a worker thread.
+    \since 5.15
+
+    \ingroup database
+    \inmodule QtSql
+
+    QSqlQuery::exec() blocks the calling thread, and a QSqlDatabase
+    connection may only be used from the thread that created it.
+    QSqlAsyncConnection opens its own connection, using the settings of
+    an existing QSqlDatabase, on a dedicated worker thread. exec() returns
+    immediately with a QFuture that reports a QSqlAsyncResult once the
+    query has been executed.
+
+    Any number of queries can be in flight at once. They are queued and
+    executed one after the other, in the order exec() was called, on the
+    single connection. That means statements such as \c BEGIN and
+    \c COMMIT apply to the queries queued between them.
+
+    \code
+    QSqlAsyncConnection connection(QSqlDatabase::database("reports"));
+    QFutureWatcher<QSqlAsyncResult> *watcher = new QFutureWatcher<QSqlAsyncResult>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [watcher] {
+        const QSqlAsyncResult result = watcher->result();
+        if (!result.isValid())
+            qWarning() << result.lastError();
+        for (int row = 0; row < result.size(); ++row)
+            qDebug() << result.value(row, "name");
+        watcher->deleteLater();
+    });
+    watcher->setFuture(connection.exec("SELECT name FROM customer WHERE region = ?", {region}));
+    \endcode
+
+    The connection is opened when the first query is executed. If it
+    fails, or the connection is lost, the result of the query reports a
+    QSqlError::ConnectionError, and the next query tries to open the
+    connection again.
+
+    By default, the result of a \c SELECT statement holds all of its rows.
+    To keep large results from being buffered completely, set a block
+    size with setBlockSize(). Each result then holds up to that many rows,
+    and QSqlAsyncResult::hasMoreRows() tells whether fetchMore() returns
+    more of them. The rows not fetched yet stay on the database side, and
+    are discarded when the next query is executed.
+
+    \code
+    connection.setBlockSize(1000);
+    QSqlAsyncResult block = connection.exec("SELECT name FROM customer").result();
+    while (block.isValid()) {
+        for (int row = 0; row < block.size(); ++row)
+            process(block.value(row, 0));
+        if (!block.hasMoreRows())
+            break;
+        block = connection.fetchMore(block).result();
+    }
+    \endcode
+
+    Canceling a future with QFuture::cancel() prevents a query that has
+    not started yet from being executed, and stops transferring the rows
+    of a running query. cancelAll() also asks the database to abort the
+    query that is running, if the driver supports
+    \l{QSqlDriver::CancelQuery}{canceling queries}.
+
+    \sa QSqlDatabase, QFutureWatcher
+*/
+
+/*!
+    Constructs an asynchronous connection that uses the driver, host,
+    database, user name, password, port, connect options and numerical
+    precision policy of \a settings. \a settings itself is not used by the
+    worker thread, and it does not have to be open.
+*/
+QSqlAsyncConnection::QSqlAsyncConnection(const QSqlDatabase &settings)
+    : d(new QSqlAsyncConnectionPrivate(settings))
+{
+    d->start();
+}
+
+/*!
+    Cancels the queries that have not started yet, waits for the running
+    query to finish and closes the connection.
+*/
+QSqlAsyncConnection::~QSqlAsyncConnection()
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->quit = true;
+        d->cancelQueued();
+        d->taskAvailable.wakeAll();
+    }
+    d->wait();
+    delete d;
+}
+
+/*!
+    Queues \a query for execution and returns a future that reports the
+    result. If \a boundValues is not empty, the query is prepared and the
+    values are bound to its placeholders in order, as with
+    QSqlQuery::addBindValue().
+
+    The future never reports an exception; check
+    QSqlAsyncResult::isValid() and QSqlAsyncResult::lastError() instead.
+*/
+QFuture<QSqlAsyncResult> QSqlAsyncConnection::exec(const QString &query,
+                                                   const QVariantList &boundValues)
+{
+    QFutureInterface<QSqlAsyncResult> future;
+    future.reportStarted();
+
+    QMutexLocker locker(&d->mutex);
+    QSqlAsyncConnectionPrivate::Task task;
+    task.query = query;
+    task.boundValues = boundValues;
+    task.future = future;
+    task.blockSize = d->blockSize;
+    d->queue.enqueue(task);
+    d->taskAvailable.wakeOne();
+    return future.future();
+}
+
+/*!
+    Queues a request for the next block of rows of \a result, and returns
+    a future that reports them. The block holds up to blockSize() rows,
+    or all remaining rows if no block size is set.
+
+    Only the result set of the last query executed can be continued. If
+    \a result does not have more rows, or another query was executed
+    since, the future reports an invalid result with an error.
+
+    \sa QSqlAsyncResult::hasMoreRows()
+*/
+QFuture<QSqlAsyncResult> QSqlAsyncConnection::fetchMore(const QSqlAsyncResult &result)
+{
+    QFutureInterface<QSqlAsyncResult> future;
+    future.reportStarted();
+
+    QMutexLocker locker(&d->mutex);
+    QSqlAsyncConnectionPrivate::Task task;
+    task.query = result.lastQuery();
+    task.future = future;
+    task.blockSize = d->blockSize;
+    task.fetch = true;
+    if (result.d->moreRows && result.d->connectionName == d->connectionName)
+        task.cursor = result.d->cursor;
+    d->queue.enqueue(task);
+    d->taskAvailable.wakeOne();
+    return future.future();
+}
+
+/*!
+    Sets the maximum number of rows that a result of a \c SELECT statement
+    holds to \a rows. Queries executed afterwards deliver their rows in
+    blocks of that size, which are requested with fetchMore(). If \a rows
+    is 0, the default, results hold all rows.
+
+    \sa QSqlAsyncResult::hasMoreRows()
+*/
+void QSqlAsyncConnection::setBlockSize(int rows)
+{
+    QMutexLocker locker(&d->mutex);
+    d->blockSize = qMax(rows, 0);
+}
+
+/*!
+    Returns the maximum number of rows that a result of a \c SELECT
+    statement holds, or 0 if results hold all rows.
+
+    \sa setBlockSize()
+*/
+int QSqlAsyncConnection::blockSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->blockSize;
+}
+
+/*!
+    Returns the number of queries that are queued or running.
+*/
+int QSqlAsyncConnection::pendingCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->queue.size() + (d->busy ? 1 : 0);
+}
+
+/*!
+    Cancels all queued queries and the running one. Their futures are
+    canceled. The running query is interrupted on the database server if
+    the driver supports \l{QSqlDriver::CancelQuery}{canceling queries};
+    otherwise it runs to completion and only its result is dropped.
+*/
+void QSqlAsyncConnection::cancelAll()
+{
+    QMutexLocker locker(&d->mutex);
+    d->cancelQueued();
+    if (d->busy) {
+        d->running.cancel();
+        // Only safe while the mutex keeps the worker from moving on
+        if (d->driver && d->driver->hasFeature(QSqlDriver::CancelQuery))
+            d->driver->cancelQuery();
+    }
+}
+
+/*!
+    Blocks until all queued queries have been executed.
+*/
+void QSqlAsyncConnection::waitForDone()
+{
+    QMutexLocker locker(&d->mutex);
+    while (d->busy || !d->queue.isEmpty())
+        d->idle.wait(&d->mutex);
+}
+
+QT_END_NAMESPACE
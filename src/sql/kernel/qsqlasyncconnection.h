@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLASYNCCONNECTION_H
+#define QSQLASYNCCONNECTION_H
+
+#include <QtSql/qtsqlglobal.h>
+#include <QtSql/qsqlerror.h>
+#include <QtSql/qsqlrecord.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_REQUIRE_CONFIG(future);
+
+QT_BEGIN_NAMESPACE
+
+
+class QSqlDatabase;
+class QSqlAsyncResultPrivate;
+class QSqlAsyncConnectionPrivate;
+
+class Q_SQL_EXPORT QSqlAsyncResult
+{
+public:
+    QSqlAsyncResult();
+    QSqlAsyncResult(const QSqlAsyncResult &other);
+    QSqlAsyncResult &operator=(const QSqlAsyncResult &other);
+    ~QSqlAsyncResult();
+
+    bool isValid() const;
+    QSqlError lastError() const;
+    QString lastQuery() const;
+
+    bool isSelect() const;
+    int size() const;
+    QSqlRecord record() const;
+    QVector<QSqlRecord> records() const;
+    QVariant value(int row, int column) const;
+    QVariant value(int row, const QString &name) const;
+    bool hasMoreRows() const;
+
+    int numRowsAffected() const;
+    QVariant lastInsertId() const;
+
+private:
+    friend class QSqlAsyncConnection;
+    friend class QSqlAsyncConnectionPrivate;
+    QSharedDataPointer<QSqlAsyncResultPrivate> d;
+};
+
+Q_DECLARE_TYPEINFO(QSqlAsyncResult, Q_MOVABLE_TYPE);
+
+class Q_SQL_EXPORT QSqlAsyncConnection
+{
+public:
+    explicit QSqlAsyncConnection(const QSqlDatabase &settings);
+    ~QSqlAsyncConnection();
+
+    QFuture<QSqlAsyncResult> exec(const QString &query,
+                                  const QVariantList &boundValues = QVariantList());
+    QFuture<QSqlAsyncResult> fetchMore(const QSqlAsyncResult &result);
+
+    void setBlockSize(int rows);
+    int blockSize() const;
+
+    int pendingCount() const;
+    void cancelAll();
+    void waitForDone();
+
+private:
+    QSqlAsyncConnectionPrivate *d;
+
+    Q_DISABLE_COPY(QSqlAsyncConnection)
+};
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QSqlAsyncResult)
+
+#endif // QSQLASYNCCONNECTION_H
@@ -0,0 +1,465 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsqlcolumnblock.h"
+#include "qsqlcolumnblock_p.h"
+
+#include "qsqlfield.h"
+#include "qsqlrecord.h"
+#include "qvariant.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QSqlColumnBlock
+    \brief The QSqlColumnBlock class holds a block of rows fetched column by column.
+    \since 5.15
+
+    \ingroup database
+    \inmodule QtSql
+
+    QSqlColumnBlock is filled by QSqlQuery::fetchBlock(). It stores up to
+    capacity() rows in one typed buffer per column, so scanning a large
+    result does not construct a QVariant for every cell. The buffers are
+    allocated once and reused for every block fetched into the same
+    QSqlColumnBlock.
+
+    Each column is stored as one of the following types, returned by
+    columnType():
+
+    \table
+    \header \li Type \li Accessor
+    \row \li QMetaType::LongLong \li int64Column()
+    \row \li QMetaType::Double \li doubleColumn()
+    \row \li QMetaType::QString \li stringColumn()
+    \row \li QMetaType::QByteArray \li byteArrayColumn()
+    \endtable
+
+    Unless a type has been requested with setColumnType(), it is derived
+    from the field type reported by the query: integer and boolean fields
+    are stored as 64-bit integers, floating point fields as doubles, binary
+    fields as byte arrays and all other fields as strings.
+
+    \code
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.exec("SELECT id, price, name FROM article");
+
+    QSqlColumnBlock block(4096);
+    while (query.fetchBlock(&block)) {
+        const qint64 *ids = block.int64Column(0);
+        const double *prices = block.doubleColumn(1);
+        for (int row = 0; row < block.rowCount(); ++row) {
+            if (!block.isNull(row, 1))
+                total += prices[row];
+            ...
+        }
+    }
+    \endcode
+
+    The SQLite and PostgreSQL drivers decode the values straight into the
+    column buffers. Other drivers fall back to fetching the rows one by one.
+
+    \sa QSqlQuery::fetchBlock(), QSqlQuery::setForwardOnly()
+*/
+
+/*!
+    Constructs an empty block that can hold up to \a capacity rows.
+*/
+QSqlColumnBlock::QSqlColumnBlock(int capacity)
+    : d(new QSqlColumnBlockPrivate)
+{
+    setCapacity(capacity);
+}
+
+/*!
+    Destroys the block and its column buffers.
+*/
+QSqlColumnBlock::~QSqlColumnBlock()
+{
+    delete d;
+}
+
+/*!
+    Returns the maximum number of rows fetched into this block at once.
+
+    \sa setCapacity()
+*/
+int QSqlColumnBlock::capacity() const
+{
+    return d->capacity;
+}
+
+/*!
+    Sets the maximum number of rows fetched into this block at once to
+    \a capacity. The rows currently held by the block are discarded.
+
+    \sa capacity()
+*/
+void QSqlColumnBlock::setCapacity(int capacity)
+{
+    d->capacity = qMax(1, capacity);
+    d->columns.clear();
+    d->rowCount = 0;
+}
+
+/*!
+    Requests that \a column is stored as \a type, which must be one of
+    QMetaType::LongLong, QMetaType::Double, QMetaType::QString or
+    QMetaType::QByteArray. Passing QMetaType::UnknownType restores the
+    type derived from the field type. The request takes effect on the
+    next call to QSqlQuery::fetchBlock().
+
+    \sa columnType()
+*/
+void QSqlColumnBlock::setColumnType(int column, QMetaType::Type type)
+{
+    if (column < 0)
+        return;
+    switch (type) {
+    case QMetaType::UnknownType:
+    case QMetaType::LongLong:
+    case QMetaType::Double:
+    case QMetaType::QString:
+    case QMetaType::QByteArray:
+        break;
+    default:
+        qWarning("QSqlColumnBlock::setColumnType: unsupported type %s",
+                 QMetaType::typeName(type));
+        return;
+    }
+    if (column >= d->requestedTypes.size())
+        d->requestedTypes.resize(column + 1);
+    d->requestedTypes[column] = type;
+}
+
+/*!
+    Returns the type \a column is stored as, or QMetaType::UnknownType if
+    \a column is out of range or nothing has been fetched yet.
+
+    \sa setColumnType()
+*/
+QMetaType::Type QSqlColumnBlock::columnType(int column) const
+{
+    if (column < 0 || column >= d->columns.size())
+        return QMetaType::UnknownType;
+    return d->columns.at(column).type;
+}
+
+/*!
+    Discards the rows held by the block, its column buffers and all
+    types requested with setColumnType().
+*/
+void QSqlColumnBlock::clear()
+{
+    d->requestedTypes.clear();
+    d->columns.clear();
+    d->rowCount = 0;
+}
+
+/*!
+    Returns the number of columns in the block.
+*/
+int QSqlColumnBlock::columnCount() const
+{
+    return d->columns.size();
+}
+
+/*!
+    Returns the number of rows fetched by the last call to
+    QSqlQuery::fetchBlock().
+*/
+int QSqlColumnBlock::rowCount() const
+{
+    return d->rowCount;
+}
+
+/*!
+    Returns \c true if the value of \a column in \a row is NULL. The
+    buffers hold 0 or an empty string or byte array for NULL values.
+*/
+bool QSqlColumnBlock::isNull(int row, int column) const
+{
+    if (column < 0 || column >= d->columns.size() || row < 0 || row >= d->rowCount)
+        return true;
+    return d->columns.at(column).nulls.at(row);
+}
+
+/*!
+    Returns the values of \a column, or \nullptr if \a column is not
+    stored as QMetaType::LongLong. The pointer stays valid until the
+    next call to QSqlQuery::fetchBlock() or setCapacity().
+*/
+const qint64 *QSqlColumnBlock::int64Column(int column) const
+{
+    if (columnType(column) != QMetaType::LongLong)
+        return nullptr;
+    return d->columns.at(column).int64s.constData();
+}
+
+/*!
+    Returns the values of \a column, or \nullptr if \a column is not
+    stored as QMetaType::Double. The pointer stays valid until the
+    next call to QSqlQuery::fetchBlock() or setCapacity().
+*/
+const double *QSqlColumnBlock::doubleColumn(int column) const
+{
+    if (columnType(column) != QMetaType::Double)
+        return nullptr;
+    return d->columns.at(column).doubles.constData();
+}
+
+/*!
+    Returns the values of \a column, or \nullptr if \a column is not
+    stored as QMetaType::QString. The pointer stays valid until the
+    next call to QSqlQuery::fetchBlock() or setCapacity().
+*/
+const QString *QSqlColumnBlock::stringColumn(int column) const
+{
+    if (columnType(column) != QMetaType::QString)
+        return nullptr;
+    return d->columns.at(column).strings.constData();
+}
+
+/*!
+    Returns the values of \a column, or \nullptr if \a column is not
+    stored as QMetaType::QByteArray. The pointer stays valid until the
+    next call to QSqlQuery::fetchBlock() or setCapacity().
+*/
+const QByteArray *QSqlColumnBlock::byteArrayColumn(int column) const
+{
+    if (columnType(column) != QMetaType::QByteArray)
+        return nullptr;
+    return d->columns.at(column).byteArrays.constData();
+}
+
+/*! \internal
+    Returns the type values of a field of type \a fieldType are stored as.
+*/
+QMetaType::Type QSqlColumnBlockPrivate::storageType(int fieldType)
+{
+    switch (fieldType) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+        return QMetaType::LongLong;
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return QMetaType::Double;
+    case QMetaType::QByteArray:
+        return QMetaType::QByteArray;
+    default:
+        return QMetaType::QString;
+    }
+}
+
+/*! \internal
+    Sets up one buffer of capacity rows for every field of \a record. The
+    buffers are kept if the columns did not change since the last block.
+*/
+void QSqlColumnBlockPrivate::prepare(const QSqlRecord &record)
+{
+    rowCount = 0;
+    const int count = record.count();
+    if (columns.size() != count)
+        columns.resize(count);
+    for (int i = 0; i < count; ++i) {
+        QMetaType::Type type = requestedTypes.value(i, QMetaType::UnknownType);
+        if (type == QMetaType::UnknownType)
+            type = storageType(record.field(i).type());
+        Column &c = columns[i];
+        if (c.type == type && c.nulls.size() == capacity)
+            continue;
+        c = Column();
+        c.type = type;
+        c.nulls.resize(capacity);
+        switch (type) {
+        case QMetaType::LongLong:
+            c.int64s.resize(capacity);
+            break;
+        case QMetaType::Double:
+            c.doubles.resize(capacity);
+            break;
+        case QMetaType::QByteArray:
+            c.byteArrays.resize(capacity);
+            break;
+        default:
+            c.strings.resize(capacity);
+            break;
+        }
+    }
+}
+
+/*! \internal
+    Marks \a column in \a row as NULL.
+*/
+void QSqlColumnBlockPrivate::setNull(int row, int column)
+{
+    Column &c = columns[column];
+    c.nulls[row] = true;
+    switch (c.type) {
+    case QMetaType::LongLong:
+        c.int64s[row] = 0;
+        break;
+    case QMetaType::Double:
+        c.doubles[row] = 0;
+        break;
+    case QMetaType::QByteArray:
+        c.byteArrays[row].clear();
+        break;
+    default:
+        c.strings[row].clear();
+        break;
+    }
+}
+
+/*! \internal
+    Stores \a size UTF-16 code units at \a data in \a column of \a row.
+    For a non-string column the text is converted.
+*/
+void QSqlColumnBlockPrivate::setString(int row, int column, const QChar *data, int size)
+{
+    Column &c = columns[column];
+    if (c.type != QMetaType::QString) {
+        setValue(row, column, QString::fromRawData(data, size));
+        return;
+    }
+    c.nulls[row] = false;
+    // Reuses the existing allocation unless the string has been shared.
+    QString &s = c.strings[row];
+    s.resize(size);
+    if (size)
+        memcpy(s.data(), data, size * sizeof(QChar));
+}
+
+/*! \internal
+    Stores the Latin-1 text of \a size bytes at \a data in \a column of \a row.
+*/
+void QSqlColumnBlockPrivate::setLatin1(int row, int column, const char *data, int size)
+{
+    Column &c = columns[column];
+    if (c.type != QMetaType::QString) {
+        setValue(row, column, QString::fromLatin1(data, size));
+        return;
+    }
+    c.nulls[row] = false;
+    QString &s = c.strings[row];
+    s.resize(size);
+    ushort *dst = reinterpret_cast<ushort *>(s.data());
+    for (int i = 0; i < size; ++i)
+        dst[i] = uchar(data[i]);
+}
+
+/*! \internal
+    Stores the UTF-8 text of \a size bytes at \a data in \a column of \a row.
+    Plain ASCII is widened in place; anything else goes through the codec.
+*/
+void QSqlColumnBlockPrivate::setUtf8(int row, int column, const char *data, int size)
+{
+    Column &c = columns[column];
+    if (c.type != QMetaType::QString) {
+        setValue(row, column, QString::fromUtf8(data, size));
+        return;
+    }
+    c.nulls[row] = false;
+    QString &s = c.strings[row];
+    s.resize(size);
+    ushort *dst = reinterpret_cast<ushort *>(s.data());
+    for (int i = 0; i < size; ++i) {
+        const uchar ch = data[i];
+        if (ch >= 0x80) {
+            s = QString::fromUtf8(data, size);
+            return;
+        }
+        dst[i] = ch;
+    }
+}
+
+/*! \internal
+    Stores the \a size bytes at \a data in \a column of \a row.
+*/
+void QSqlColumnBlockPrivate::setBytes(int row, int column, const char *data, int size)
+{
+    Column &c = columns[column];
+    if (c.type != QMetaType::QByteArray) {
+        setValue(row, column, QByteArray::fromRawData(data, size));
+        return;
+    }
+    c.nulls[row] = false;
+    QByteArray &ba = c.byteArrays[row];
+    ba.resize(size);
+    if (size)
+        memcpy(ba.data(), data, size);
+}
+
+/*! \internal
+    Converts \a value to the type of \a column and stores it in \a row.
+*/
+void QSqlColumnBlockPrivate::setValue(int row, int column, const QVariant &value)
+{
+    if (value.isNull()) {
+        setNull(row, column);
+        return;
+    }
+    Column &c = columns[column];
+    c.nulls[row] = false;
+    switch (c.type) {
+    case QMetaType::LongLong:
+        c.int64s[row] = value.toLongLong();
+        break;
+    case QMetaType::Double:
+        c.doubles[row] = value.toDouble();
+        break;
+    case QMetaType::QByteArray:
+        c.byteArrays[row] = value.toByteArray();
+        break;
+    default:
+        c.strings[row] = value.toString();
+        break;
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLCOLUMNBLOCK_H
+#define QSQLCOLUMNBLOCK_H
+
+#include <QtSql/qtsqlglobal.h>
+#include <QtCore/qmetatype.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QByteArray;
+class QString;
+class QSqlColumnBlockPrivate;
+
+class Q_SQL_EXPORT QSqlColumnBlock
+{
+public:
+    explicit QSqlColumnBlock(int capacity = 1024);
+    ~QSqlColumnBlock();
+
+    int capacity() const;
+    void setCapacity(int capacity);
+
+    void setColumnType(int column, QMetaType::Type type);
+    QMetaType::Type columnType(int column) const;
+    void clear();
+
+    int columnCount() const;
+    int rowCount() const;
+
+    bool isNull(int row, int column) const;
+    const qint64 *int64Column(int column) const;
+    const double *doubleColumn(int column) const;
+    const QString *stringColumn(int column) const;
+    const QByteArray *byteArrayColumn(int column) const;
+
+private:
+    friend class QSqlColumnBlockPrivate;
+    QSqlColumnBlockPrivate *d;
+
+    Q_DISABLE_COPY(QSqlColumnBlock)
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLCOLUMNBLOCK_H
@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLCOLUMNBLOCK_P_H
+#define QSQLCOLUMNBLOCK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtSql/private/qtsqlglobal_p.h>
+#include "QtSql/qsqlcolumnblock.h"
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSqlRecord;
+class QVariant;
+
+class Q_SQL_EXPORT QSqlColumnBlockPrivate
+{
+public:
+    struct Column
+    {
+        QMetaType::Type type = QMetaType::UnknownType;
+        QVector<bool> nulls;
+        QVector<qint64> int64s;
+        QVector<double> doubles;
+        QVector<QString> strings;
+        QVector<QByteArray> byteArrays;
+    };
+
+    static QSqlColumnBlockPrivate *get(QSqlColumnBlock *block) { return block->d; }
+    static QMetaType::Type storageType(int fieldType);
+
+    void prepare(const QSqlRecord &record);
+
+    int columnCount() const { return columns.size(); }
+    QMetaType::Type columnType(int column) const { return columns.at(column).type; }
+
+    void setNull(int row, int column);
+    void setInt64(int row, int column, qint64 value)
+    {
+        Column &c = columns[column];
+        c.nulls[row] = false;
+        c.int64s[row] = value;
+    }
+    void setDouble(int row, int column, double value)
+    {
+        Column &c = columns[column];
+        c.nulls[row] = false;
+        c.doubles[row] = value;
+    }
+    void setString(int row, int column, const QChar *data, int size);
+    void setLatin1(int row, int column, const char *data, int size);
+    void setUtf8(int row, int column, const char *data, int size);
+    void setBytes(int row, int column, const char *data, int size);
+    void setValue(int row, int column, const QVariant &value);
+
+    QVector<QMetaType::Type> requestedTypes;
+    QVector<Column> columns;
+    int capacity = 0;
+    int rowCount = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLCOLUMNBLOCK_P_H
@@ -0,0 +1,649 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsqlconnectionpool.h"
+
+#include "qsqldriver.h"
+#include "qsqlquery.h"
+#include "private/qsqldatabase_p.h"
+
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtCore/private/qobject_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSqlConnectionPoolPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QSqlConnectionPool)
+
+public:
+    struct Connection
+    {
+        QSqlDatabase db;
+        QThread *lastThread;
+        QElapsedTimer idleSince;
+    };
+
+    QSqlDatabase openConnection();
+    bool checkConnection(Connection &connection);
+    void discard(QVector<QSqlDatabase> &connections);
+    void closeExpired();
+    void updateTimer();
+
+    QString poolName;
+    QString templateName;
+    QSqlDatabase settings;
+    QTimer *idleTimer = nullptr;
+
+    mutable QMutex mutex;
+    QWaitCondition available;
+    // Most recently released last, so that checkout prefers warm connections
+    QVector<Connection> idle;
+    QSet<QString> active;
+    QString healthCheckQuery;
+    QSqlError lastError;
+    // Connections that are idle, checked out or being opened
+    int total = 0;
+    int serial = 0;
+    int minimumSize = 0;
+    int maximumSize = QThread::idealThreadCount();
+    int idleTimeout = 60000;
+    int healthCheckInterval = 0;
+};
+
+static QString qMakeConnectionPoolName()
+{
+    static QBasicAtomicInt counter = Q_BASIC_ATOMIC_INITIALIZER(0);
+    return QStringLiteral("qt_sql_pool_") + QString::number(counter.fetchAndAddRelaxed(1) + 1);
+}
+
+/*
+    Opens a new connection for the calling thread. Must be called with
+    total already counting the new connection, and without the mutex held.
+*/
+QSqlDatabase QSqlConnectionPoolPrivate::openConnection()
+{
+    QString name;
+    {
+        QMutexLocker locker(&mutex);
+        name = poolName + QLatin1Char('_') + QString::number(++serial);
+    }
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(settings, name);
+    if (db.open())
+        return db;
+
+    const QSqlError error = db.lastError();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(name);
+
+    QMutexLocker locker(&mutex);
+    lastError = error;
+    --total;
+    available.wakeOne();
+    return QSqlDatabase();
+}
+
+/*
+    Moves an idle connection to the calling thread and makes sure it is
+    still usable, reopening it once if it is not.
+*/
+bool QSqlConnectionPoolPrivate::checkConnection(Connection &connection)
+{
+    QSqlDriver *driver = connection.db.driver();
+    if (driver->thread() != QThread::currentThread())
+        driver->moveToThread(QThread::currentThread());
+    if (driver->thread() != QThread::currentThread())
+        return false;
+
+    bool healthy = connection.db.isOpen() && !connection.db.isOpenError();
+    if (healthy && !healthCheckQuery.isEmpty()
+        && connection.idleSince.elapsed() >= healthCheckInterval) {
+        QSqlQuery query(connection.db);
+        healthy = query.exec(healthCheckQuery);
+    }
+    if (healthy)
+        return true;
+
+    connection.db.close();
+    return connection.db.open();
+}
+
+/*
+    Closes connections that have been taken out of the pool. Must be
+    called without the mutex held.
+*/
+void QSqlConnectionPoolPrivate::discard(QVector<QSqlDatabase> &connections)
+{
+    QStringList names;
+    names.reserve(connections.size());
+    for (QSqlDatabase &db : connections) {
+        names.append(db.connectionName());
+        db.close();
+    }
+    connections.clear();
+    for (const QString &name : qAsConst(names))
+        QSqlDatabase::removeDatabase(name);
+}
+
+void QSqlConnectionPoolPrivate::closeExpired()
+{
+    QVector<QSqlDatabase> expired;
+    {
+        QMutexLocker locker(&mutex);
+        // The oldest idle connections are at the front
+        while (!idle.isEmpty() && total > minimumSize
+               && idle.constFirst().idleSince.hasExpired(idleTimeout)) {
+            expired.append(idle.takeFirst().db);
+            --total;
+        }
+    }
+    discard(expired);
+}
+
+void QSqlConnectionPoolPrivate::updateTimer()
+{
+    if (idleTimeout < 0) {
+        idleTimer->stop();
+    } else {
+        // Idle connections are closed between one and one and a half timeouts
+        idleTimer->start(qMax(idleTimeout / 2, 1));
+    }
+}
+
+/*!
+    \class QSqlConnectionPool
+    \brief The QSqlConnectionPool class keeps a set of open database connections for reuse across threads.
+    \since 5.15
+
+    \ingroup database
+    \inmodule QtSql
+
+    Opening a connection to a database server can take tens of
+    milliseconds, and a QSqlDatabase connection may only be used by the
+    thread that created it. Code that runs short tasks on many threads,
+    such as QRunnable objects in a QThreadPool, therefore either opens a
+    new connection per task or keeps one connection per thread alive.
+    QSqlConnectionPool instead hands out open connections with acquire()
+    and takes them back with release(), moving them to the thread that
+    checks them out.
+
+    \code
+    QSqlConnectionPool pool(QSqlDatabase::database("orders"));
+    pool.setMaximumSize(8);
+
+    QThreadPool::globalInstance()->start([&pool, id] {
+        QSqlPooledConnection connection(&pool);
+        if (!connection.isValid())
+            return;
+        QSqlQuery query(connection.database());
+        query.prepare("UPDATE orders SET shipped = 1 WHERE id = ?");
+        query.addBindValue(id);
+        query.exec();
+    });
+    \endcode
+
+    A connection must be released by the thread that acquired it, and
+    must not be used afterwards. QSqlPooledConnection does both
+    automatically. Transactions should be committed or rolled back before
+    a connection is released.
+
+    At most maximumSize() connections are open at once; acquire() waits
+    for a connection to be released when all of them are in use. Idle
+    connections are closed after idleTimeout(), unless that would leave
+    fewer than minimumSize() connections open. When a connection is
+    checked out, it prefers the idle connection last used by the calling
+    thread, and otherwise the most recently released one.
+
+    Before an idle connection is handed out again, the pool checks that
+    it is still open. If a healthCheckQuery() is set, it is executed as
+    well, and a connection that fails the check is reopened.
+
+    The idle timeout is handled by the thread the pool lives in, which
+    must run an event loop for idle connections to be closed.
+
+    \sa QSqlDatabase, QSqlPooledConnection, QThreadPool
+*/
+
+/*!
+    Constructs a connection pool with parent \a parent. The connections
+    in the pool use the driver, host, database, user name, password,
+    port, connect options and numerical precision policy of \a settings,
+    which does not have to be open.
+
+    Connections are opened on demand.
+
+    \sa QSqlDatabase::cloneDatabase()
+*/
+QSqlConnectionPool::QSqlConnectionPool(const QSqlDatabase &settings, QObject *parent)
+    : QObject(*new QSqlConnectionPoolPrivate, parent)
+{
+    Q_D(QSqlConnectionPool);
+    d->poolName = qMakeConnectionPoolName();
+    d->templateName = d->poolName + QLatin1String("_template");
+    d->settings = QSqlDatabase::cloneDatabase(settings, d->templateName);
+    d->idleTimer = new QTimer(this);
+    connect(d->idleTimer, &QTimer::timeout, this, [d] { d->closeExpired(); });
+    d->updateTimer();
+}
+
+/*!
+    Closes all idle connections and destroys the pool. All connections
+    must have been released.
+*/
+QSqlConnectionPool::~QSqlConnectionPool()
+{
+    Q_D(QSqlConnectionPool);
+    clear();
+    if (!d->active.isEmpty()) {
+        qWarning("QSqlConnectionPool: Destroyed while %d connection(s) are still in use",
+                 d->active.size());
+    }
+    d->settings = QSqlDatabase();
+    QSqlDatabase::removeDatabase(d->templateName);
+}
+
+/*!
+    \property QSqlConnectionPool::minimumSize
+    \brief the number of connections that are kept open even when idle
+
+    The pool does not open connections in advance; this only prevents
+    idle connections from being closed after idleTimeout(). The default
+    is 0.
+*/
+int QSqlConnectionPool::minimumSize() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->minimumSize;
+}
+
+void QSqlConnectionPool::setMinimumSize(int size)
+{
+    Q_D(QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    d->minimumSize = qMax(size, 0);
+}
+
+/*!
+    \property QSqlConnectionPool::maximumSize
+    \brief the maximum number of connections the pool opens
+
+    The default is QThread::idealThreadCount(), which matches the default
+    size of a QThreadPool. Lowering the maximum does not close
+    connections that are in use; they are closed when they are released.
+*/
+int QSqlConnectionPool::maximumSize() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->maximumSize;
+}
+
+void QSqlConnectionPool::setMaximumSize(int size)
+{
+    Q_D(QSqlConnectionPool);
+    QVector<QSqlDatabase> surplus;
+    {
+        QMutexLocker locker(&d->mutex);
+        d->maximumSize = qMax(size, 1);
+        while (!d->idle.isEmpty() && d->total > d->maximumSize) {
+            surplus.append(d->idle.takeFirst().db);
+            --d->total;
+        }
+        d->available.wakeAll();
+    }
+    d->discard(surplus);
+}
+
+/*!
+    \property QSqlConnectionPool::idleTimeout
+    \brief the time in milliseconds after which an idle connection is closed
+
+    A negative value keeps idle connections open until clear() is called
+    or the pool is destroyed. The default is 60000 (one minute).
+*/
+int QSqlConnectionPool::idleTimeout() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->idleTimeout;
+}
+
+void QSqlConnectionPool::setIdleTimeout(int msecs)
+{
+    Q_D(QSqlConnectionPool);
+    {
+        QMutexLocker locker(&d->mutex);
+        d->idleTimeout = msecs;
+    }
+    d->updateTimer();
+}
+
+/*!
+    \property QSqlConnectionPool::healthCheckQuery
+    \brief the statement executed to check an idle connection before it is handed out
+
+    A simple statement such as \c{SELECT 1} detects connections that were
+    closed by the server or lost. When the query is empty, which is the
+    default, the pool only checks that the connection is open.
+
+    \sa healthCheckInterval
+*/
+QString QSqlConnectionPool::healthCheckQuery() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->healthCheckQuery;
+}
+
+void QSqlConnectionPool::setHealthCheckQuery(const QString &query)
+{
+    Q_D(QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    d->healthCheckQuery = query;
+}
+
+/*!
+    \property QSqlConnectionPool::healthCheckInterval
+    \brief the time in milliseconds a connection must have been idle before healthCheckQuery() is executed
+
+    Connections released more recently are handed out without the extra
+    round trip to the server. The default is 0, which checks the
+    connection every time it is handed out.
+*/
+int QSqlConnectionPool::healthCheckInterval() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->healthCheckInterval;
+}
+
+void QSqlConnectionPool::setHealthCheckInterval(int msecs)
+{
+    Q_D(QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    d->healthCheckInterval = qMax(msecs, 0);
+}
+
+/*!
+    Checks out an open connection for the calling thread, opening a new
+    one if no connection is idle and the pool has not reached
+    maximumSize(). Otherwise waits at most \a msecs milliseconds for
+    another thread to release a connection; a negative value waits
+    forever.
+
+    Returns an invalid QSqlDatabase if no connection became available in
+    time, or if a new connection could not be opened. In the latter case
+    lastError() describes the error.
+
+    \threadsafe
+
+    \sa release(), QSqlPooledConnection
+*/
+QSqlDatabase QSqlConnectionPool::acquire(int msecs)
+{
+    Q_D(QSqlConnectionPool);
+    QThread *currentThread = QThread::currentThread();
+    QDeadlineTimer deadline(msecs);
+
+    QMutexLocker locker(&d->mutex);
+    for (;;) {
+        if (!d->idle.isEmpty()) {
+            int index = d->idle.size() - 1;
+            for (int i = index; i >= 0; --i) {
+                if (d->idle.at(i).lastThread == currentThread) {
+                    index = i;
+                    break;
+                }
+            }
+            QSqlConnectionPoolPrivate::Connection connection = d->idle.takeAt(index);
+            locker.unlock();
+
+            const bool usable = d->checkConnection(connection);
+            locker.relock();
+            if (usable) {
+                d->active.insert(connection.db.connectionName());
+                return connection.db;
+            }
+            d->lastError = connection.db.lastError();
+            --d->total;
+            locker.unlock();
+            QVector<QSqlDatabase> broken{ connection.db };
+            connection.db = QSqlDatabase();
+            d->discard(broken);
+            locker.relock();
+            continue;
+        }
+
+        if (d->total < d->maximumSize) {
+            ++d->total;
+            locker.unlock();
+            QSqlDatabase db = d->openConnection();
+            if (db.isValid()) {
+                locker.relock();
+                d->active.insert(db.connectionName());
+            }
+            return db;
+        }
+
+        if (!d->available.wait(&d->mutex, deadline))
+            return QSqlDatabase();
+    }
+}
+
+/*!
+    Returns \a db, which must have been returned by acquire() and must
+    not be used afterwards, to the pool. This function must be called by
+    the thread that acquired the connection.
+
+    Connections that are no longer open, or that exceed maximumSize(),
+    are closed instead of being kept for reuse.
+
+    \threadsafe
+
+    \sa acquire()
+*/
+void QSqlConnectionPool::release(const QSqlDatabase &db)
+{
+    Q_D(QSqlConnectionPool);
+    if (!db.isValid())
+        return;
+
+    const QString name = db.connectionName();
+    {
+        QMutexLocker locker(&d->mutex);
+        if (!d->active.remove(name)) {
+            qWarning("QSqlConnectionPool::release: Connection '%s' does not belong to this pool",
+                     qPrintable(name));
+            return;
+        }
+    }
+
+    QSqlDriver *driver = db.driver();
+    const bool detached = driver->thread() == QThread::currentThread();
+    if (detached) {
+        // Detach the driver from the thread, so that any thread can adopt it
+        driver->moveToThread(nullptr);
+    } else {
+        qWarning("QSqlConnectionPool::release: Connection '%s' must be released by the "
+                 "thread that acquired it", qPrintable(name));
+    }
+
+    QSqlDatabase closed;
+    {
+        QMutexLocker locker(&d->mutex);
+        if (!detached || !db.isOpen() || d->total > d->maximumSize) {
+            closed = db;
+            --d->total;
+        } else {
+            QSqlConnectionPoolPrivate::Connection connection{ db, QThread::currentThread(),
+                                                               QElapsedTimer() };
+            connection.idleSince.start();
+            d->idle.append(connection);
+        }
+        d->available.wakeOne();
+    }
+    if (closed.isValid()) {
+        // The caller still holds db, which removeDatabase() would disable;
+        // the connection is deleted together with the caller's last handle
+        qt_sql_forgetDatabase(name);
+        closed.close();
+    }
+}
+
+/*!
+    Returns the number of open connections, both idle and in use.
+*/
+int QSqlConnectionPool::size() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->idle.size() + d->active.size();
+}
+
+/*!
+    Returns the number of open connections that are waiting to be
+    acquired.
+*/
+int QSqlConnectionPool::idleCount() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->idle.size();
+}
+
+/*!
+    Returns the number of connections that have been acquired and not
+    yet released.
+*/
+int QSqlConnectionPool::activeCount() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->active.size();
+}
+
+/*!
+    Returns the error of the last connection that could not be opened,
+    or reopened after failing its health check.
+*/
+QSqlError QSqlConnectionPool::lastError() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->lastError;
+}
+
+/*!
+    Closes all idle connections, regardless of minimumSize(). Connections
+    that are in use are not affected.
+*/
+void QSqlConnectionPool::clear()
+{
+    Q_D(QSqlConnectionPool);
+    QVector<QSqlDatabase> connections;
+    {
+        QMutexLocker locker(&d->mutex);
+        for (const QSqlConnectionPoolPrivate::Connection &connection : qAsConst(d->idle))
+            connections.append(connection.db);
+        d->total -= d->idle.size();
+        d->idle.clear();
+    }
+    d->discard(connections);
+}
+
+/*!
+    \class QSqlPooledConnection
+    \brief The QSqlPooledConnection class checks out a connection from a QSqlConnectionPool for the duration of a scope.
+    \since 5.15
+
+    \ingroup database
+    \inmodule QtSql
+
+    The constructor acquires a connection and the destructor releases
+    it, in the same way as QMutexLocker locks and unlocks a mutex.
+
+    \sa QSqlConnectionPool
+*/
+
+/*!
+    \fn QSqlPooledConnection::QSqlPooledConnection(QSqlConnectionPool *pool, int msecs)
+
+    Acquires a connection from \a pool, waiting at most \a msecs
+    milliseconds.
+
+    \sa QSqlConnectionPool::acquire()
+*/
+
+/*!
+    \fn QSqlPooledConnection::~QSqlPooledConnection()
+
+    Releases the connection.
+*/
+
+/*!
+    \fn bool QSqlPooledConnection::isValid() const
+
+    Returns \c true if a connection was acquired.
+*/
+
+/*!
+    \fn QSqlDatabase QSqlPooledConnection::database() const
+
+    Returns the acquired connection, or an invalid QSqlDatabase.
+*/
+
+/*!
+    \fn void QSqlPooledConnection::release()
+
+    Returns the connection to the pool before the object is destroyed.
+    database() returns an invalid QSqlDatabase afterwards.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qsqlconnectionpool.cpp"
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLCONNECTIONPOOL_H
+#define QSQLCONNECTIONPOOL_H
+
+#include <QtSql/qtsqlglobal.h>
+#include <QtSql/qsqldatabase.h>
+#include <QtSql/qsqlerror.h>
+#include <QtCore/qobject.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QSqlConnectionPoolPrivate;
+
+class Q_SQL_EXPORT QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QSqlConnectionPool)
+
+    Q_PROPERTY(int minimumSize READ minimumSize WRITE setMinimumSize)
+    Q_PROPERTY(int maximumSize READ maximumSize WRITE setMaximumSize)
+    Q_PROPERTY(int idleTimeout READ idleTimeout WRITE setIdleTimeout)
+    Q_PROPERTY(QString healthCheckQuery READ healthCheckQuery WRITE setHealthCheckQuery)
+    Q_PROPERTY(int healthCheckInterval READ healthCheckInterval WRITE setHealthCheckInterval)
+
+public:
+    explicit QSqlConnectionPool(const QSqlDatabase &settings, QObject *parent = nullptr);
+    ~QSqlConnectionPool();
+
+    int minimumSize() const;
+    void setMinimumSize(int size);
+
+    int maximumSize() const;
+    void setMaximumSize(int size);
+
+    int idleTimeout() const;
+    void setIdleTimeout(int msecs);
+
+    QString healthCheckQuery() const;
+    void setHealthCheckQuery(const QString &query);
+
+    int healthCheckInterval() const;
+    void setHealthCheckInterval(int msecs);
+
+    QSqlDatabase acquire(int msecs = -1);
+    void release(const QSqlDatabase &db);
+
+    int size() const;
+    int idleCount() const;
+    int activeCount() const;
+    QSqlError lastError() const;
+
+    void clear();
+
+private:
+    Q_DISABLE_COPY(QSqlConnectionPool)
+};
+
+class QSqlPooledConnection
+{
+public:
+    inline explicit QSqlPooledConnection(QSqlConnectionPool *pool, int msecs = -1)
+        : p(pool), db(pool->acquire(msecs)) {}
+    inline ~QSqlPooledConnection() { release(); }
+
+    inline bool isValid() const { return db.isValid(); }
+    inline QSqlDatabase database() const { return db; }
+    inline void release()
+    {
+        if (p && db.isValid())
+            p->release(db);
+        p = nullptr;
+        db = QSqlDatabase();
+    }
+
+private:
+    Q_DISABLE_COPY(QSqlPooledConnection)
+
+    QSqlConnectionPool *p;
+    QSqlDatabase db;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLCONNECTIONPOOL_H
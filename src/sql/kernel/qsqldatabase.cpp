@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qsqldatabase.h"
+#include "private/qsqldatabase_p.h"
 #include "qsqlquery.h"
 #include "qdebug.h"
 #include "qcoreapplication.h"
@@ -204,6 +205,22 @@ void QSqlDatabasePrivate::removeDatabase(const QString &name)
     invalidateDb(dict->take(name), name);
 }
 
+/*
+    Removes the connection called \a name without invalidating handles
+    that still refer to it; the connection is closed and deleted with the
+    last one. Used by QSqlConnectionPool.
+*/
+void qt_sql_forgetDatabase(const QString &name)
+{
+    QConnectionDict *dict = dbDict();
+    Q_ASSERT(dict);
+    QSqlDatabase db;
+    {
+        QWriteLocker locker(&dict->lock);
+        db = dict->take(name);
+    }
+}
+
 void QSqlDatabasePrivate::addDatabase(const QSqlDatabase &db, const QString &name)
 {
     QConnectionDict *dict = dbDict();
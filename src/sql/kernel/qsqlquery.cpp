@@ -46,6 +46,8 @@
 #include "qatomic.h"
 #include "qsqlrecord.h"
 #include "qsqlresult.h"
+#include "qsqlresult_p.h"
+#include "qsqlcolumnblock_p.h"
 #include "qsqldriver.h"
 #include "qsqldatabase.h"
 #include "private/qsqlnulldriver_p.h"
@@ -763,6 +765,41 @@ bool QSqlQuery::last()
     return d->sqlResult->fetchLast();
 }
 
+/*!
+    \since 5.15
+
+    Fetches up to \l{QSqlColumnBlock::capacity()}{capacity()} rows
+    following the current record into \a block, and returns \c true if at
+    least one row was fetched. The previous contents of \a block are
+    replaced; QSqlColumnBlock::rowCount() returns the number of rows
+    fetched.
+
+    Afterwards the query is positioned on the last row fetched, or after
+    the last record once the end of the result has been reached, so the
+    next call continues with the following rows. value() does not return
+    the values of the rows in \a block.
+
+    This is considerably faster than next() and value() for scanning large
+    results, in particular together with setForwardOnly(), since the SQLite
+    and PostgreSQL drivers decode the values directly into the typed
+    column buffers of \a block instead of creating a QVariant per value.
+
+    The query must be \l{isActive()}{active} and isSelect() must return
+    \c true.
+
+    \sa QSqlColumnBlock, next(), setForwardOnly()
+*/
+bool QSqlQuery::fetchBlock(QSqlColumnBlock *block)
+{
+    QSqlColumnBlockPrivate *b = QSqlColumnBlockPrivate::get(block);
+    b->rowCount = 0;
+    if (!isSelect() || !isActive() || at() == QSql::AfterLastRow)
+        return false;
+    b->prepare(d->sqlResult->record());
+    d->sqlResult->d_func()->fetchBlock(b);
+    return b->rowCount > 0;
+}
+
 /*!
   Returns the size of the result (number of rows returned), or -1 if
   the size cannot be determined or if the database does not support
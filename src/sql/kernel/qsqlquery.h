@@ -52,6 +52,7 @@ class QSqlDriver;
 class QSqlError;
 class QSqlResult;
 class QSqlRecord;
+class QSqlColumnBlock;
 template <class Key, class T> class QMap;
 class QSqlQueryPrivate;
 
@@ -93,6 +94,7 @@ public:
     bool previous();
     bool first();
     bool last();
+    bool fetchBlock(QSqlColumnBlock *block);
 
     void clear();
 
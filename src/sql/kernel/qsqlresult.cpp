@@ -48,6 +48,7 @@
 #include "qsqldriver.h"
 #include "qpointer.h"
 #include "qsqlresult_p.h"
+#include "qsqlcolumnblock_p.h"
 #include "private/qsqldriver_p.h"
 #include <QDebug>
 
@@ -58,6 +59,28 @@ QString QSqlResultPrivate::holderAt(int index) const
     return holders.size() > index ? holders.at(index).holderName : fieldSerial(index);
 }
 
+/*! \internal
+    Fetches the rows following the current one into \a block, one by one
+    through fetchNext() and data(). Drivers that can decode values straight
+    into the column buffers reimplement this. The result is positioned on
+    the last row fetched, or after the last row once the end is reached.
+*/
+void QSqlResultPrivate::fetchBlock(QSqlColumnBlockPrivate *block)
+{
+    Q_Q(QSqlResult);
+    const int columnCount = block->columnCount();
+    while (block->rowCount < block->capacity) {
+        const bool fetched = q->at() == QSql::BeforeFirstRow ? q->fetchFirst() : q->fetchNext();
+        if (!fetched) {
+            q->setAt(QSql::AfterLastRow);
+            break;
+        }
+        for (int i = 0; i < columnCount; ++i)
+            block->setValue(block->rowCount, i, q->isNull(i) ? QVariant() : q->data(i));
+        ++block->rowCount;
+    }
+}
+
 // return a unique id for bound names
 QString QSqlResultPrivate::fieldSerial(int i) const
 {
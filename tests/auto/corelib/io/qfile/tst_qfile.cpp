@@ -35,11 +35,16 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QTemporaryDir>
 
 #include <private/qabstractfileengine_p.h>
 #include <private/qfsfileengine_p.h>
 #include <private/qfilesystemengine_p.h>
+#if defined(QT_BUILD_INTERNAL) && QT_CONFIG(future)
+#include <private/qfileasyncio_p.h>
+#endif
 
 #include "emulationdetector.h"
 
@@ -256,6 +261,8 @@ private slots:
     void mapOpenMode();
     void mapWrittenFile_data();
     void mapWrittenFile();
+    void mapToByteArray();
+    void mapToByteArrayResource();
 
     void openStandardStreamsFileDescriptors();
     void openStandardStreamsBufferedStreams();
@@ -279,6 +286,17 @@ private slots:
 
     void reuseQFile();
 
+    void readAsync();
+    void writeAsync();
+    void asyncManyInFlight();
+    void asyncAfterClose();
+    void asyncSaveFile();
+    void asyncResource();
+    void asyncInvalid();
+#if defined(QT_BUILD_INTERNAL) && QT_CONFIG(future) && defined(Q_OS_UNIX)
+    void asyncThreadPoolBackend();
+#endif
+
     void moveToTrash_data();
     void moveToTrash();
 
@@ -3303,6 +3321,82 @@ void tst_QFile::mapWrittenFile()
     file.remove();
 }
 
+#ifdef Q_OS_LINUX
+static bool isMapped(const QString &fileName)
+{
+    QFile maps("/proc/self/maps");
+    if (!maps.open(QIODevice::ReadOnly))
+        return false;
+    return maps.readAll().contains(QFile::encodeName(QFileInfo(fileName).canonicalFilePath()));
+}
+#endif
+
+void tst_QFile::mapToByteArray()
+{
+    const QString fileName = QDir::currentPath() + "/maptobytearray.json";
+    QByteArray json = "{\n";
+    for (int i = 0; i < 2000; ++i)
+        json += "  \"key" + QByteArray::number(i) + "\": [1, 2.5, \"text\"],\n";
+    json += "  \"last\": true\n}\n";
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(json), qint64(json.size()));
+    }
+
+    QByteArray mapped;
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(file.seek(7));
+
+        mapped = file.mapToByteArray(0, file.size());
+        QCOMPARE(file.error(), QFile::NoError);
+        QCOMPARE(mapped, json);
+        QCOMPARE(file.pos(), qint64(7));
+
+        // unaligned offsets and sizes beyond the end of the file
+        QCOMPARE(file.mapToByteArray(5, 20), json.mid(5, 20));
+        QCOMPARE(file.mapToByteArray(json.size() - 4, 100), json.right(4));
+        QVERIFY(file.mapToByteArray(json.size() + 100, 10).isEmpty());
+        QCOMPARE(file.error(), QFile::NoError);
+
+        QVERIFY(file.mapToByteArray(-1, 10).isNull());
+        QCOMPARE(file.error(), QFile::UnspecifiedError);
+    }
+
+    // the mapping outlives the file
+#ifdef Q_OS_LINUX
+    QVERIFY(isMapped(fileName));
+#endif
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(mapped, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(document.object().size(), 2001);
+    QVERIFY(document.object().value("last").toBool());
+
+    mapped.clear();
+#ifdef Q_OS_LINUX
+    QVERIFY(!isMapped(fileName));
+#endif
+
+    QFile writeOnly(fileName);
+    QVERIFY(writeOnly.open(QIODevice::WriteOnly | QIODevice::Append));
+    QVERIFY(writeOnly.mapToByteArray(0, 10).isNull());
+    QCOMPARE(writeOnly.error(), QFile::PermissionsError);
+}
+
+void tst_QFile::mapToByteArrayResource()
+{
+    QFile resource(":/tst_qfileinfo/resources/file1.ext1");
+    QVERIFY(resource.open(QIODevice::ReadOnly));
+    const QByteArray contents = resource.readAll();
+    QVERIFY(!contents.isEmpty());
+    QVERIFY(resource.seek(1));
+    QCOMPARE(resource.mapToByteArray(2, 100), contents.mid(2));
+    QCOMPARE(resource.pos(), qint64(1));
+}
+
 void tst_QFile::openDirectory()
 {
     QFile f1(m_resourcesDir);
@@ -3676,6 +3770,196 @@ void tst_QFile::reuseQFile()
     }
 }
 
+void tst_QFile::readAsync()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i)
+        data += QByteArray::number(i) + '\n';
+
+    QFile file("readasync.txt");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), qint64(data.size()));
+    file.close();
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.seek(5));
+
+    QFuture<QByteArray> all = file.readAsync(0, data.size());
+    QFuture<QByteArray> middle = file.readAsync(100, 50);
+    QFuture<QByteArray> tail = file.readAsync(data.size() - 10, 100);
+    QFuture<QByteArray> beyond = file.readAsync(data.size() + 10, 100);
+
+    QCOMPARE(all.result(), data);
+    QCOMPARE(middle.result(), data.mid(100, 50));
+    QCOMPARE(tail.result(), data.right(10));
+    QVERIFY(beyond.result().isEmpty());
+    // the end of the file is not an error
+    beyond.waitForFinished();
+    QVERIFY(!beyond.isCanceled());
+
+    // the position of the device is not affected
+    QCOMPARE(file.pos(), qint64(5));
+    QCOMPARE(file.read(5), data.mid(5, 5));
+}
+
+void tst_QFile::writeAsync()
+{
+    QFile file("writeasync.txt");
+    QVERIFY(file.open(QIODevice::ReadWrite | QIODevice::Truncate));
+
+    // buffered data is flushed before the asynchronous request
+    QCOMPARE(file.write("0123456789"), qint64(10));
+    QFuture<qint64> first = file.writeAsync(10, QByteArray("abcdef"));
+    QFuture<qint64> second = file.writeAsync(20, QByteArray("XYZ"));
+    QCOMPARE(first.result(), qint64(6));
+    QCOMPARE(second.result(), qint64(3));
+    QCOMPARE(file.pos(), qint64(10));
+
+    QCOMPARE(file.size(), qint64(23));
+    QByteArray expected = QByteArray("0123456789abcdef") + QByteArray(4, '\0') + "XYZ";
+    QCOMPARE(file.readAsync(0, 100).result(), expected);
+
+    QFutureWatcher<qint64> watcher;
+    QSignalSpy spy(&watcher, &QFutureWatcher<qint64>::finished);
+    watcher.setFuture(file.writeAsync(0, QByteArray("ABC")));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(watcher.result(), qint64(3));
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.read(5), QByteArray("ABC34"));
+}
+
+void tst_QFile::asyncManyInFlight()
+{
+    const int blockSize = 4096;
+    const int blockCount = 512;
+
+    QFile file("asyncmany.bin");
+    QVERIFY(file.open(QIODevice::ReadWrite | QIODevice::Truncate));
+
+    QVector<QFuture<qint64>> writes;
+    for (int i = 0; i < blockCount; ++i)
+        writes.append(file.writeAsync(qint64(i) * blockSize, QByteArray(blockSize, char('a' + i % 26))));
+    for (int i = 0; i < blockCount; ++i)
+        QCOMPARE(writes.at(i).result(), qint64(blockSize));
+    QCOMPARE(file.size(), qint64(blockCount) * blockSize);
+
+    QVector<QFuture<QByteArray>> reads;
+    for (int i = 0; i < blockCount; ++i)
+        reads.append(file.readAsync(qint64(i) * blockSize, blockSize));
+    for (int i = 0; i < blockCount; ++i)
+        QCOMPARE(reads.at(i).result(), QByteArray(blockSize, char('a' + i % 26)));
+}
+
+void tst_QFile::asyncAfterClose()
+{
+    QFile file("asyncclose.txt");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(QByteArray(100000, 'x')), qint64(100000));
+    file.close();
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QFuture<QByteArray> pending = file.readAsync(0, 100000);
+    file.close();
+
+    // the request owns its own descriptor and completes anyway
+    QCOMPARE(pending.result(), QByteArray(100000, 'x'));
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAsync(1, 3).result(), QByteArray("xxx"));
+}
+
+void tst_QFile::asyncSaveFile()
+{
+    const QString fileName = QStringLiteral("asyncsavefile.txt");
+    QFile::remove(fileName);
+
+    // the writes go to the temporary file, not to the target
+    QSaveFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QFuture<qint64> written = file.writeAsync(0, QByteArray("saved"));
+    written.waitForFinished();
+    QVERIFY(!written.isCanceled());
+    QCOMPARE(written.result(), qint64(5));
+    QVERIFY(!QFile::exists(fileName));
+    QVERIFY(file.commit());
+
+    QFile target(fileName);
+    QVERIFY(target.open(QIODevice::ReadOnly));
+    QCOMPARE(target.readAll(), QByteArray("saved"));
+}
+
+void tst_QFile::asyncResource()
+{
+    // there is no descriptor to do positional I/O on
+    QFile resource(":/tst_qfileinfo/resources/file1.ext1");
+    QVERIFY(resource.open(QIODevice::ReadOnly));
+    QFuture<QByteArray> pending = resource.readAsync(0, 10);
+    pending.waitForFinished();
+    QVERIFY(pending.isCanceled());
+    QVERIFY(pending.result().isEmpty());
+}
+
+void tst_QFile::asyncInvalid()
+{
+    QFile file("asyncinvalid.txt");
+    QTest::ignoreMessage(QtWarningMsg, "QFileDevice::readAsync: IODevice is not open");
+    QFuture<QByteArray> read = file.readAsync(0, 10);
+    read.waitForFinished();
+    QVERIFY(read.isCanceled());
+    QVERIFY(read.result().isEmpty());
+    QTest::ignoreMessage(QtWarningMsg, "QFileDevice::writeAsync: IODevice is not open");
+    QFuture<qint64> written = file.writeAsync(0, "abc");
+    written.waitForFinished();
+    QVERIFY(written.isCanceled());
+    QCOMPARE(written.result(), qint64(-1));
+
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QFileDevice::readAsync: WriteOnly device");
+    QVERIFY(file.readAsync(0, 10).isCanceled());
+    QTest::ignoreMessage(QtWarningMsg, "QFileDevice::writeAsync: Invalid offset");
+    QVERIFY(file.writeAsync(-1, "abc").isCanceled());
+}
+
+#if defined(QT_BUILD_INTERNAL) && QT_CONFIG(future) && defined(Q_OS_UNIX)
+void tst_QFile::asyncThreadPoolBackend()
+{
+    std::unique_ptr<QFileAsyncIO> io(QFileAsyncIO::create(QFileAsyncIO::ThreadPoolBackend));
+    QVERIFY(io);
+    QCOMPARE(io->backend(), QFileAsyncIO::ThreadPoolBackend);
+
+    const QByteArray fileName = QByteArrayLiteral("asyncthreadpool.bin");
+    QFile::remove(QString::fromLatin1(fileName));
+    const int fd = QT_OPEN(fileName.constData(), QT_OPEN_RDWR | QT_OPEN_CREAT, 0666);
+    QVERIFY(fd != -1);
+    const auto handle = QSharedPointer<QFileAsyncHandle>::create(fd);
+
+    const QByteArray data(100000, 'q');
+    QFuture<qint64> written = io->write(handle, 10, data);
+    written.waitForFinished();
+    QVERIFY(!written.isCanceled());
+    QCOMPARE(written.result(), qint64(data.size()));
+
+    QFuture<QByteArray> read = io->read(handle, 0, 2 * data.size());
+    read.waitForFinished();
+    QVERIFY(!read.isCanceled());
+    QCOMPARE(read.result(), QByteArray(10, '\0') + data);
+
+    QFuture<QByteArray> atEnd = io->read(handle, 2 * data.size(), 10);
+    atEnd.waitForFinished();
+    QVERIFY(!atEnd.isCanceled());
+    QVERIFY(atEnd.result().isEmpty());
+
+    // a descriptor that is not open for reading fails the read distinctly
+    const int writeOnlyFd = QT_OPEN(fileName.constData(), QT_OPEN_WRONLY);
+    QVERIFY(writeOnlyFd != -1);
+    const auto writeOnly = QSharedPointer<QFileAsyncHandle>::create(writeOnlyFd);
+    QFuture<QByteArray> failed = io->read(writeOnly, 0, 10);
+    failed.waitForFinished();
+    QVERIFY(failed.isCanceled());
+    QVERIFY(failed.result().isEmpty());
+}
+#endif
+
 void tst_QFile::moveToTrash_data()
 {
     QTest::addColumn<QString>("source");
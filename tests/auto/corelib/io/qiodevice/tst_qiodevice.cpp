@@ -55,6 +55,7 @@ private slots:
 
     void readAllKeepPosition();
     void writeInTextMode();
+    void writeByteArrayList();
     void skip_data();
     void skip();
     void skipAfterPeek_data();
@@ -638,6 +639,21 @@ void tst_QIODevice::writeInTextMode()
 #endif
 }
 
+void tst_QIODevice::writeByteArrayList()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QBuffer::WriteOnly));
+    QCOMPARE(buffer.write(QByteArrayList{ "one", QByteArray(), "two", "three" }), Q_INT64_C(11));
+    QCOMPARE(buffer.write(QByteArrayList()), Q_INT64_C(0));
+    QCOMPARE(buffer.pos(), Q_INT64_C(11));
+    QCOMPARE(buffer.data(), QByteArray("onetwothree"));
+    buffer.close();
+
+    QVERIFY(buffer.open(QBuffer::ReadOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::write (QBuffer): ReadOnly device");
+    QCOMPARE(buffer.write(QByteArrayList{ "four" }), Q_INT64_C(-1));
+}
+
 void tst_QIODevice::skip_data()
 {
     QTest::addColumn<bool>("sequential");
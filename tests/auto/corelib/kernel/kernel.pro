@@ -4,6 +4,7 @@ SUBDIRS=\
     qdeadlinetimer \
     qelapsedtimer \
     qeventdispatcher \
+    qeventdispatcher_epoll \
     qeventloop \
     qmath \
     qmetaobject \
@@ -0,0 +1,284 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qtemporaryfile.h>
+#include <QtCore/private/qeventdispatcher_epoll_p.h>
+#include <QtCore/private/qcore_unix_p.h>
+
+#include <unistd.h>
+
+class tst_QEventDispatcherEpoll : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void isUsed();
+    void timers();
+    void readNotifier();
+    void writeNotifier();
+    void regularFile();
+    void excludeSocketNotifiers();
+    void excludeTimers();
+    void manyNotifiers();
+    void wakeUpFromOtherThread();
+};
+
+class Pipe
+{
+public:
+    Pipe() { QCOMPARE(qt_safe_pipe(fds, O_NONBLOCK), 0); }
+    ~Pipe()
+    {
+        qt_safe_close(fds[0]);
+        qt_safe_close(fds[1]);
+    }
+
+    void write() { QCOMPARE(qt_safe_write(fds[1], "x", 1), qint64(1)); }
+    void drain()
+    {
+        char buffer[64];
+        while (qt_safe_read(fds[0], buffer, sizeof(buffer)) > 0) {}
+    }
+
+    int fds[2];
+};
+
+void tst_QEventDispatcherEpoll::isUsed()
+{
+    QVERIFY(qobject_cast<QEventDispatcherEpoll *>(QCoreApplication::eventDispatcher()));
+
+    QThread thread;
+    thread.start();
+    QTRY_VERIFY(thread.eventDispatcher());
+    QVERIFY(qobject_cast<QEventDispatcherEpoll *>(thread.eventDispatcher()));
+    thread.quit();
+    QVERIFY(thread.wait());
+}
+
+void tst_QEventDispatcherEpoll::timers()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    int zeroTimerCount = 0;
+    QTimer zeroTimer;
+    zeroTimer.setInterval(0);
+    connect(&zeroTimer, &QTimer::timeout, [&] { ++zeroTimerCount; });
+    zeroTimer.start();
+
+    bool shortFired = false;
+    bool longFired = false;
+    QTimer::singleShot(50, Qt::PreciseTimer, [&] { shortFired = true; });
+    QTimer::singleShot(200, Qt::PreciseTimer, [&] { longFired = true; });
+
+    QTRY_VERIFY(shortFired);
+    QVERIFY(elapsed.elapsed() >= 50);
+    QVERIFY(!longFired);
+    QTRY_VERIFY(longFired);
+    QVERIFY(elapsed.elapsed() >= 200);
+    QVERIFY(zeroTimerCount > 0);
+
+    // a stopped timer must not wake the dispatcher up any more
+    QTimer timer;
+    int fired = 0;
+    connect(&timer, &QTimer::timeout, [&] { ++fired; });
+    timer.start(20);
+    timer.stop();
+    zeroTimer.stop();
+    QTest::qWait(100);
+    QCOMPARE(fired, 0);
+}
+
+void tst_QEventDispatcherEpoll::readNotifier()
+{
+    Pipe pipe;
+    QSocketNotifier notifier(pipe.fds[0], QSocketNotifier::Read);
+    int activated = 0;
+    connect(&notifier, &QSocketNotifier::activated, [&] {
+        ++activated;
+        pipe.drain();
+    });
+
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 0);
+
+    pipe.write();
+    QTRY_COMPARE(activated, 1);
+    QTest::qWait(20);
+    QCOMPARE(activated, 1);
+
+    // disabling and enabling again re-registers the file descriptor
+    notifier.setEnabled(false);
+    pipe.write();
+    QCoreApplication::processEvents();
+    QCOMPARE(activated, 1);
+    notifier.setEnabled(true);
+    QTRY_COMPARE(activated, 2);
+}
+
+void tst_QEventDispatcherEpoll::writeNotifier()
+{
+    Pipe pipe;
+    QSocketNotifier readNotifier(pipe.fds[0], QSocketNotifier::Read);
+    QSocketNotifier writeNotifier(pipe.fds[1], QSocketNotifier::Write);
+    QSignalSpy readSpy(&readNotifier, &QSocketNotifier::activated);
+    QSignalSpy writeSpy(&writeNotifier, &QSocketNotifier::activated);
+
+    QTRY_VERIFY(writeSpy.count() > 0);
+    QCOMPARE(readSpy.count(), 0);
+
+    writeNotifier.setEnabled(false);
+    pipe.write();
+    QTRY_VERIFY(readSpy.count() > 0);
+    pipe.drain();
+}
+
+void tst_QEventDispatcherEpoll::regularFile()
+{
+    // epoll cannot watch regular files; like poll(), the dispatcher
+    // reports them as always ready
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    QSocketNotifier notifier(file.handle(), QSocketNotifier::Read);
+    QSignalSpy spy(&notifier, &QSocketNotifier::activated);
+    QTRY_VERIFY(spy.count() > 0);
+
+    notifier.setEnabled(false);
+    spy.clear();
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 0);
+}
+
+void tst_QEventDispatcherEpoll::excludeSocketNotifiers()
+{
+    Pipe pipe;
+    QSocketNotifier notifier(pipe.fds[0], QSocketNotifier::Read);
+    int activated = 0;
+    connect(&notifier, &QSocketNotifier::activated, [&] {
+        ++activated;
+        pipe.drain();
+    });
+
+    pipe.write();
+    QCoreApplication::processEvents(QEventLoop::ExcludeSocketNotifiers);
+    QCOMPARE(activated, 0);
+
+    // the ready file descriptor must not end the wait either
+    bool fired = false;
+    QTimer::singleShot(20, [&] { fired = true; });
+    QEventLoop loop;
+    int iterations = 0;
+    while (!fired) {
+        loop.processEvents(QEventLoop::ExcludeSocketNotifiers | QEventLoop::WaitForMoreEvents);
+        ++iterations;
+    }
+    QCOMPARE(activated, 0);
+    QVERIFY(iterations < 10);
+
+    QTRY_COMPARE(activated, 1);
+}
+
+void tst_QEventDispatcherEpoll::excludeTimers()
+{
+    bool fired = false;
+    QTimer timer;
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, [&] { fired = true; });
+    timer.start(0);
+
+    QCoreApplication::processEvents(QEventLoop::X11ExcludeTimers);
+    QVERIFY(!fired);
+    QCoreApplication::processEvents();
+    QVERIFY(fired);
+}
+
+void tst_QEventDispatcherEpoll::manyNotifiers()
+{
+    const int count = 100;
+    std::vector<std::unique_ptr<Pipe>> pipes;
+    std::vector<std::unique_ptr<QSocketNotifier>> notifiers;
+    QVector<int> activated;
+
+    for (int i = 0; i < count; ++i) {
+        pipes.emplace_back(new Pipe);
+        notifiers.emplace_back(new QSocketNotifier(pipes.back()->fds[0], QSocketNotifier::Read));
+        Pipe *pipe = pipes.back().get();
+        connect(notifiers.back().get(), &QSocketNotifier::activated, [&activated, pipe, i] {
+            activated.append(i);
+            pipe->drain();
+        });
+    }
+
+    for (int i = 0; i < count; i += 10)
+        pipes[i]->write();
+    QTRY_COMPARE(activated.size(), count / 10);
+    for (int i = 0; i < count; i += 10)
+        QVERIFY(activated.contains(i));
+
+    // deleting a notifier that is ready while another one is being activated
+    activated.clear();
+    connect(notifiers[1].get(), &QSocketNotifier::activated, [&] { notifiers[2].reset(); });
+    connect(notifiers[2].get(), &QSocketNotifier::activated, [&] { notifiers[1].reset(); });
+    pipes[1]->write();
+    pipes[2]->write();
+    QTRY_COMPARE(activated.size(), 1);
+    QTest::qWait(20);
+    QCOMPARE(activated.size(), 1);
+}
+
+void tst_QEventDispatcherEpoll::wakeUpFromOtherThread()
+{
+    QEventLoop loop;
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    QThread *thread = QThread::create([&loop] {
+        QThread::msleep(50);
+        QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+    });
+    thread->start();
+    QTimer::singleShot(5000, &loop, [&loop] { loop.exit(1); });
+    QCOMPARE(loop.exec(), 0);
+    QVERIFY(elapsed.elapsed() < 5000);
+    QVERIFY(thread->wait());
+    delete thread;
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    QCoreApplication app(argc, argv);
+    tst_QEventDispatcherEpoll tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_qeventdispatcher_epoll.moc"
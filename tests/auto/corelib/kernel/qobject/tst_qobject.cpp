@@ -40,6 +40,7 @@
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QSemaphore>
 #include <QScopedPointer>
 #if QT_CONFIG(process)
 # include <QProcess>
@@ -78,6 +79,8 @@ private slots:
     void thread();
     void thread0();
     void moveToThread();
+    void queuedConnectionsFromManyThreads();
+    void queuedConnectionsDuringChildMove();
     void senderTest();
     void declareInterface();
     void qpointerResetBeforeDestroyedSignal();
@@ -1907,6 +1910,261 @@ void tst_QObject::moveToThread()
 #endif
 }
 
+class QueuedCallEvent : public QEvent
+{
+public:
+    enum { Type = QEvent::User + 1 };
+    QueuedCallEvent(int producer, int sequence)
+        : QEvent(QEvent::Type(Type)), producer(producer), sequence(sequence) {}
+    int producer;
+    int sequence;
+};
+
+class QueuedCallSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void produced(int producer, int sequence);
+};
+
+class QueuedCallRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    QueuedCallRecorder(int producerCount, int expected, QObject *parent = nullptr)
+        : QObject(parent), lastSequence(producerCount, -1), expected(expected) {}
+
+    QVector<int> lastSequence;
+    QThread *lastThread = nullptr;
+    bool ordered = true;
+    int received = 0;
+    QSemaphore done;
+
+public slots:
+    void record(int producer, int sequence) { check(producer, sequence); }
+
+protected:
+    void customEvent(QEvent *e) override
+    {
+        const QueuedCallEvent *event = static_cast<QueuedCallEvent *>(e);
+        check(event->producer, event->sequence);
+    }
+
+private:
+    void check(int producer, int sequence)
+    {
+        if (lastSequence[producer] + 1 != sequence)
+            ordered = false;
+        lastSequence[producer] = sequence;
+        lastThread = QThread::currentThread();
+        if (++received == expected)
+            done.release();
+    }
+
+    int expected;
+};
+
+class QueuedCallProducer : public QThread
+{
+public:
+    QueuedCallProducer(int id, int count, QueuedCallSender *sender, QObject *receiver)
+        : id(id), count(count), sender(sender), receiver(receiver) {}
+
+    void run() override
+    {
+        for (int i = 0; i < count; ++i) {
+            if (i % 16 == 15)
+                QCoreApplication::postEvent(receiver, new QueuedCallEvent(id, i));
+            else
+                emit sender->produced(id, i);
+        }
+    }
+
+private:
+    int id;
+    int count;
+    QueuedCallSender *sender;
+    QObject *receiver;
+};
+
+void tst_QObject::queuedConnectionsFromManyThreads()
+{
+    const int producerCount = 4;
+    const int perProducer = 5000;
+    QueuedCallSender sender;
+
+    {
+        // queued calls and posted events from one thread arrive in order
+        QThread consumer;
+        QueuedCallRecorder recorder(producerCount, producerCount * perProducer);
+        recorder.moveToThread(&consumer);
+        connect(&sender, &QueuedCallSender::produced, &recorder, &QueuedCallRecorder::record,
+                Qt::QueuedConnection);
+        consumer.start();
+
+        QVector<QueuedCallProducer *> producers;
+        for (int i = 0; i < producerCount; ++i)
+            producers << new QueuedCallProducer(i, perProducer, &sender, &recorder);
+        for (QueuedCallProducer *producer : qAsConst(producers))
+            producer->start();
+        QVERIFY(recorder.done.tryAcquire(1, 60000));
+        for (QueuedCallProducer *producer : qAsConst(producers))
+            QVERIFY(producer->wait());
+        qDeleteAll(producers);
+        consumer.quit();
+        QVERIFY(consumer.wait());
+
+        QVERIFY(recorder.ordered);
+        QCOMPARE(recorder.lastThread, &consumer);
+        sender.disconnect();
+    }
+
+    {
+        // calls queued while the receiver's parent moves to another thread follow it
+        QThread consumer;
+        consumer.start();
+        QObject parent;
+        QueuedCallRecorder *recorder = new QueuedCallRecorder(producerCount, producerCount * perProducer, &parent);
+        connect(&sender, &QueuedCallSender::produced, recorder, &QueuedCallRecorder::record,
+                Qt::QueuedConnection);
+
+        QVector<QueuedCallProducer *> producers;
+        for (int i = 0; i < producerCount; ++i)
+            producers << new QueuedCallProducer(i, perProducer, &sender, recorder);
+        for (QueuedCallProducer *producer : qAsConst(producers))
+            producer->start();
+        QThread::msleep(1);
+        parent.moveToThread(&consumer);
+        QVERIFY(recorder->done.tryAcquire(1, 60000));
+        for (QueuedCallProducer *producer : qAsConst(producers))
+            QVERIFY(producer->wait());
+        qDeleteAll(producers);
+
+        QVERIFY(recorder->ordered);
+        QCOMPARE(recorder->received, producerCount * perProducer);
+        QCOMPARE(recorder->lastThread, &consumer);
+        QThread *currentThread = QThread::currentThread();
+        QMetaObject::invokeMethod(&parent, [&parent, currentThread] { parent.moveToThread(currentThread); },
+                                  Qt::BlockingQueuedConnection);
+        consumer.quit();
+        QVERIFY(consumer.wait());
+        sender.disconnect();
+    }
+
+    {
+        // deleting the receiver discards the calls still queued for it
+        QueuedCallRecorder *recorder = new QueuedCallRecorder(producerCount, producerCount * perProducer);
+        connect(&sender, &QueuedCallSender::produced, recorder, &QueuedCallRecorder::record,
+                Qt::QueuedConnection);
+        QVector<QueuedCallProducer *> producers;
+        for (int i = 0; i < producerCount; ++i)
+            producers << new QueuedCallProducer(i, perProducer, &sender, recorder);
+        for (QueuedCallProducer *producer : qAsConst(producers))
+            producer->start();
+        for (QueuedCallProducer *producer : qAsConst(producers))
+            QVERIFY(producer->wait());
+        qDeleteAll(producers);
+        delete recorder;
+        QCoreApplication::processEvents();
+    }
+}
+
+// Runs a hook from wakeUp(), which moveToThread() calls while it moves the
+// posted events of an object and when it forwards queued calls.
+class WakeUpHookDispatcher : public QAbstractEventDispatcher
+{
+public:
+    bool processEvents(QEventLoop::ProcessEventsFlags) override
+    {
+        QCoreApplication::sendPostedEvents();
+        return false;
+    }
+    bool hasPendingEvents() override { return false; }
+    void registerSocketNotifier(QSocketNotifier *) override {}
+    void unregisterSocketNotifier(QSocketNotifier *) override {}
+    void registerTimer(int, int, Qt::TimerType, QObject *) override {}
+    bool unregisterTimer(int) override { return false; }
+    bool unregisterTimers(QObject *) override { return false; }
+    QList<TimerInfo> registeredTimers(QObject *) const override { return QList<TimerInfo>(); }
+    int remainingTime(int) override { return 0; }
+    void wakeUp() override
+    {
+        if (hook)
+            hook(++wakeUps);
+    }
+    void interrupt() override {}
+    void flush() override {}
+#ifdef Q_OS_WIN
+    bool registerEventNotifier(QWinEventNotifier *) override { return false; }
+    void unregisterEventNotifier(QWinEventNotifier *) override {}
+#endif
+
+    std::function<void(int)> hook;
+    QAtomicInt wakeUps;
+};
+
+void tst_QObject::queuedConnectionsDuringChildMove()
+{
+#if !QT_CONFIG(cxx11_future)
+    QSKIP("This test requires QThread::create");
+#else
+    // A thread emits while the receiver is moved as the child of another
+    // object: its first call is pushed to the old thread after the receiver's
+    // posted events were moved, and its second one is emitted while the
+    // first is being forwarded to the new thread.
+    QueuedCallSender sender;
+    QObject parent;
+    QueuedCallRecorder *recorder = new QueuedCallRecorder(2, 4, &parent);
+    connect(&sender, &QueuedCallSender::produced, recorder, &QueuedCallRecorder::record,
+            Qt::QueuedConnection);
+    QCoreApplication::postEvent(recorder, new QueuedCallEvent(1, 0));
+
+    QSemaphore emitFirst, firstEmitted, emitSecond, secondEmitted;
+    QScopedPointer<QThread> producer(QThread::create([&] {
+        emitFirst.acquire();
+        emit sender.produced(0, 0);
+        emit sender.produced(0, 1);
+        firstEmitted.release();
+        emitSecond.acquire();
+        emit sender.produced(0, 2);
+        secondEmitted.release();
+    }));
+    producer->start();
+
+    QThread *mainThread = QThread::currentThread();
+    QScopedPointer<QThread> consumer(QThread::create([&] {
+        QCoreApplication::sendPostedEvents();
+        parent.moveToThread(mainThread);
+    }));
+    auto dispatcher = new WakeUpHookDispatcher;
+    consumer->setEventDispatcher(dispatcher);
+    // The hooks run with the post event lists of both threads locked. A
+    // producer that waits for the move to finish cannot emit meanwhile,
+    // so only wait for it for a while.
+    dispatcher->hook = [&](int wakeUp) {
+        if (wakeUp == 1) {
+            // the recorder's posted event moves to the consumer
+            emitFirst.release();
+            firstEmitted.tryAcquire(1, 1000);
+        } else if (wakeUp == 2) {
+            // the first queued call is forwarded to the consumer
+            emitSecond.release();
+            secondEmitted.tryAcquire(1, 1000);
+        }
+    };
+
+    parent.moveToThread(consumer.data());
+    QVERIFY(producer->wait(10000));
+    QVERIFY(dispatcher->wakeUps.loadRelaxed() >= 2);
+    dispatcher->hook = nullptr;
+    consumer->start();
+    QVERIFY(consumer->wait(10000));
+
+    QCOMPARE(recorder->received, 4);
+    QVERIFY(recorder->ordered);
+    QCOMPARE(recorder->lastThread, consumer.data());
+#endif
+}
 
 void tst_QObject::property()
 {
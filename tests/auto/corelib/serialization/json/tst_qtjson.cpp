@@ -145,6 +145,8 @@ private Q_SLOTS:
     void nesting();
 
     void longStrings();
+    void utf8Validation_data();
+    void utf8Validation();
 
     void arrayInitializerList();
     void objectInitializerList();
@@ -3138,6 +3140,76 @@ void tst_QtJson::testJsonValueRefDefault()
     QCOMPARE(empty["n/a"].toDouble(42.0), 42.0);
 }
 
+void tst_QtJson::utf8Validation_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+    QTest::addColumn<int>("errorOffset");
+
+    const struct {
+        const char *name;
+        const char *utf8;
+        bool valid;
+    } sequences[] = {
+        { "2-byte", "\xc3\xa9", true },
+        { "3-byte", "\xe2\x82\xac", true },
+        { "4-byte", "\xf0\x9f\x98\x80", true },
+        { "before-surrogates", "\xed\x9f\xbf", true },
+        { "non-character", UNICODE_NON_CHARACTER, true },
+        { "last-code-point", "\xf4\x8f\xbf\xbf", true },
+        { "lone-continuation", "\x80", false },
+        { "overlong-2", "\xc0\xaf", false },
+        { "overlong-2b", "\xc1\xbf", false },
+        { "overlong-3", "\xe0\x9f\xbf", false },
+        { "overlong-4", "\xf0\x8f\xbf\xbf", false },
+        { "surrogate", "\xed\xa0\x80", false },
+        { "too-large", "\xf4\x90\x80\x80", false },
+        { "too-large-lead", "\xf5\x80\x80\x80", false },
+        { "invalid-byte", "\xff", false },
+        { "truncated-2", "\xc3", false },
+        { "truncated-3", "\xe2\x82", false },
+        { "truncated-4", "\xf0\x9f\x98", false },
+    };
+    // Positions around the 16- and 32-byte blocks of the vectorized code
+    const int prefixes[] = { 0, 1, 15, 16, 29, 30, 31, 32, 33, 63, 64, 100 };
+    const int suffixes[] = { 0, 40 };
+
+    for (const auto &sequence : sequences) {
+        for (int prefix : prefixes) {
+            for (int suffix : suffixes) {
+                for (bool escaped : { false, true }) {
+                    QByteArray string = QByteArray(prefix, 'a') + sequence.utf8 + QByteArray(suffix, 'b');
+                    QString expected = QString::fromUtf8(string);
+                    if (escaped) {
+                        string.prepend("\\t");
+                        expected.prepend(QLatin1Char('\t'));
+                    }
+                    const int errorOffset = sequence.valid ? 0 : 2 + (escaped ? 2 : 0) + prefix;
+                    QTest::addRow("%s-%d-%d%s", sequence.name, prefix, suffix, escaped ? "-escaped" : "")
+                            << "[\"" + string + "\"]" << expected << errorOffset;
+                }
+            }
+        }
+    }
+}
+
+void tst_QtJson::utf8Validation()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+    QFETCH(int, errorOffset);
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+    if (errorOffset) {
+        QCOMPARE(error.error, QJsonParseError::IllegalUTF8String);
+        QCOMPARE(error.offset, errorOffset);
+    } else {
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(doc.array().at(0).toString(), expected);
+    }
+}
+
 void tst_QtJson::arrayInitializerList()
 {
     QVERIFY(QJsonArray{}.isEmpty());
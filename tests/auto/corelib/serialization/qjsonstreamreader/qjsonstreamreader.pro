@@ -0,0 +1,7 @@
+QT = core testlib
+TARGET = tst_qjsonstreamreader
+CONFIG += testcase
+SOURCES += \
+    tst_qjsonstreamreader.cpp
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,542 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qjsonstreamreader.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtTest>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void basics();
+    void tokens_data();
+    void tokens();
+    void tokensFromDevice_data() { tokens_data(); }
+    void tokensFromDevice();
+    void tokensByteByByte_data() { tokens_data(); }
+    void tokensByteByByte();
+    void values();
+    void strings_data();
+    void strings();
+    void errors_data();
+    void errors();
+    void nestingLimit();
+    void multipleDocuments();
+    void singleDocumentTrailingData();
+    void skipCurrentValue();
+    void largeTokensFromDevice();
+    void compareWithQJsonDocument();
+    void clear();
+};
+
+// Renders the token stream in a compact form that is easy to compare against
+static QString trace(QJsonStreamReader &reader)
+{
+    QStringList result;
+    do {
+        switch (reader.readNext()) {
+        case QJsonStreamReader::StartObject:
+            result << QStringLiteral("{");
+            break;
+        case QJsonStreamReader::EndObject:
+            result << QStringLiteral("}");
+            break;
+        case QJsonStreamReader::StartArray:
+            result << QStringLiteral("[");
+            break;
+        case QJsonStreamReader::EndArray:
+            result << QStringLiteral("]");
+            break;
+        case QJsonStreamReader::Name:
+            result << reader.name() + QLatin1Char(':');
+            break;
+        case QJsonStreamReader::String:
+            result << QLatin1Char('"') + reader.stringValue() + QLatin1Char('"');
+            break;
+        case QJsonStreamReader::Number:
+            if (reader.isInteger())
+                result << QString::number(reader.integerValue());
+            else
+                result << QString::number(reader.doubleValue(), 'g', 17);
+            break;
+        case QJsonStreamReader::Bool:
+            result << (reader.boolValue() ? QStringLiteral("true") : QStringLiteral("false"));
+            break;
+        case QJsonStreamReader::Null:
+            result << QStringLiteral("null");
+            break;
+        case QJsonStreamReader::EndDocument:
+            result << QStringLiteral("$");
+            break;
+        case QJsonStreamReader::Invalid:
+        case QJsonStreamReader::NoToken:
+            result << QStringLiteral("!");
+            break;
+        }
+    } while (!reader.atEnd());
+    return result.join(QLatin1Char(' '));
+}
+
+static QJsonValue readValue(QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject: {
+        QJsonObject o;
+        while (reader.readNext() == QJsonStreamReader::Name) {
+            const QString name = reader.name();
+            reader.readNext();
+            o.insert(name, readValue(reader));
+        }
+        return o;
+    }
+    case QJsonStreamReader::StartArray: {
+        QJsonArray a;
+        while (reader.readNext() != QJsonStreamReader::EndArray && !reader.hasError())
+            a.append(readValue(reader));
+        return a;
+    }
+    default:
+        return reader.value();
+    }
+}
+
+void tst_QJsonStreamReader::basics()
+{
+    QJsonStreamReader reader;
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QCOMPARE(reader.tokenString(), QStringLiteral("NoToken"));
+    QCOMPARE(reader.device(), nullptr);
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.offset(), qint64(0));
+    QVERIFY(!reader.multipleDocumentsAllowed());
+    QVERIFY(!reader.hasError());
+    QVERIFY(!reader.atEnd());
+    QVERIFY(reader.errorString().isEmpty());
+
+    // No data at all: more may still arrive
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    QVERIFY(reader.atEnd());
+
+    reader.addData("[]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenString(), QStringLiteral("StartArray"));
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.offset(), qint64(1));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty-object") << QByteArray("{}") << "{ } $";
+    QTest::newRow("empty-array") << QByteArray(" [ ] ") << "[ ] $";
+    QTest::newRow("bom") << QByteArray("\xef\xbb\xbf[]") << "[ ] $";
+    QTest::newRow("object")
+            << QByteArray("{\"a\": 1, \"b\" : \"x\",\n\"c\":true,\"d\":false, \"e\":null}")
+            << "{ a: 1 b: \"x\" c: true d: false e: null } $";
+    QTest::newRow("array")
+            << QByteArray("[1, -2, 3.5, 1e3, -0.25e-2, \"s\", true, false, null]")
+            << "[ 1 -2 3.5 1000 -0.0025000000000000001 \"s\" true false null ] $";
+    QTest::newRow("nested")
+            << QByteArray("{\"a\":[{\"b\":[[]]},{}],\"c\":{\"d\":{}}}")
+            << "{ a: [ { b: [ [ ] ] } { } ] c: { d: { } } } $";
+    QTest::newRow("large-integer")
+            << QByteArray("[9223372036854775807, -9223372036854775808]")
+            << "[ 9223372036854775807 -9223372036854775808 ] $";
+    QTest::newRow("escapes")
+            << QByteArray("[\"a\\\"b\\\\c\\/d\\n\\t\\u0041\\ud83d\\ude00\"]")
+            << QString::fromUtf8("[ \"a\"b\\c/d\n\tA\xf0\x9f\x98\x80\" ] $");
+    QTest::newRow("utf8")
+            << QByteArray("{\"\xc3\xa9\":\"\xe2\x82\xac\xf0\x9f\x98\x80\"}")
+            << QString::fromUtf8("{ \xc3\xa9: \"\xe2\x82\xac\xf0\x9f\x98\x80\" } $");
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(trace(reader), expected);
+    QCOMPARE(reader.error(), QJsonParseError::NoError);
+}
+
+void tst_QJsonStreamReader::tokensFromDevice()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(trace(reader), expected);
+    QCOMPARE(reader.error(), QJsonParseError::NoError);
+}
+
+void tst_QJsonStreamReader::tokensByteByByte()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader;
+    QStringList result;
+    for (int i = 0; i < json.size(); ++i) {
+        if (reader.tokenType() == QJsonStreamReader::EndDocument) {
+            QVERIFY(json.mid(i).trimmed().isEmpty());
+            break;
+        }
+        reader.addData(json.mid(i, 1));
+        QString chunk = trace(reader);
+        QCOMPARE(reader.hasError(), reader.error() == QJsonParseError::PrematureEndOfDocument);
+        if (reader.tokenType() != QJsonStreamReader::EndDocument) {
+            QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+            chunk.chop(1);      // the "!" of the premature end
+        }
+        chunk = chunk.trimmed();
+        if (!chunk.isEmpty())
+            result << chunk;
+    }
+    QCOMPARE(result.join(QLatin1Char(' ')), expected);
+}
+
+void tst_QJsonStreamReader::values()
+{
+    QJsonStreamReader reader(QByteArray("[\"s\", 42, 1.5, 1e2, true, null, {}]"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.value(), QJsonValue(QJsonValue::Undefined));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QVERIFY(reader.isString());
+    QCOMPARE(reader.value(), QJsonValue(QStringLiteral("s")));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(reader.isNumber());
+    QVERIFY(reader.isInteger());
+    QCOMPARE(reader.integerValue(), qint64(42));
+    QCOMPARE(reader.doubleValue(), 42.);
+    QCOMPARE(reader.value(), QJsonValue(42));
+    QCOMPARE(reader.offset(), qint64(6));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(!reader.isInteger());
+    QCOMPARE(reader.doubleValue(), 1.5);
+    QCOMPARE(reader.integerValue(), qint64(1));
+    QCOMPARE(reader.value(), QJsonValue(1.5));
+
+    // Doubles that are exactly integers are reported as such, like QJsonDocument does
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(reader.isInteger());
+    QCOMPARE(reader.integerValue(), qint64(100));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QVERIFY(reader.isBool());
+    QVERIFY(reader.boolValue());
+    QCOMPARE(reader.value(), QJsonValue(true));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Null);
+    QVERIFY(reader.isNull());
+    QCOMPARE(reader.value(), QJsonValue(QJsonValue::Null));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(reader.isStartObject());
+    QCOMPARE(reader.depth(), 2);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QVERIFY(reader.isEndObject());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QVERIFY(reader.isEndArray());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QCOMPARE(reader.tokenString(), QStringLiteral("EndDocument"));
+}
+
+void tst_QJsonStreamReader::strings_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("empty") << QByteArray("\"\"");
+    QTest::newRow("ascii") << QByteArray("\"hello world\"");
+    QTest::newRow("latin1") << QByteArray("\"gr\xc3\xbc\xc3\x9f\"");
+    QTest::newRow("surrogates") << QByteArray("\"\\ud834\\udd1e \xf0\x9d\x84\x9e\"");
+    QTest::newRow("control-escapes") << QByteArray("\"\\b\\f\\n\\r\\t\"");
+    QTest::newRow("lenient-escape") << QByteArray("\"\\a\"");
+}
+
+void tst_QJsonStreamReader::strings()
+{
+    QFETCH(QByteArray, json);
+
+    const QByteArray wrapped = '[' + json + ']';
+    QJsonStreamReader reader(wrapped);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.stringValue(),
+             QJsonDocument::fromJson(wrapped).array().at(0).toString());
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("empty") << QByteArray("");
+    QTest::newRow("whitespace") << QByteArray("  \n ");
+    QTest::newRow("unterminated-object") << QByteArray("{\"a\":1");
+    QTest::newRow("unterminated-array") << QByteArray("[1, 2");
+    QTest::newRow("unterminated-array-ws") << QByteArray("[1, 2 ");
+    QTest::newRow("unterminated-nested") << QByteArray("{\"a\": [{}");
+    QTest::newRow("unterminated-string") << QByteArray("[\"abc");
+    QTest::newRow("missing-name-separator") << QByteArray("{\"a\" 1}");
+    QTest::newRow("missing-value-separator") << QByteArray("[1 2]");
+    QTest::newRow("object-missing-comma") << QByteArray("{\"a\":1 \"b\":2}");
+    QTest::newRow("object-trailing-comma") << QByteArray("{\"a\":1,}");
+    QTest::newRow("array-trailing-comma") << QByteArray("[1,]");
+    QTest::newRow("object-bad-name") << QByteArray("{1:2}");
+    QTest::newRow("missing-value") << QByteArray("{\"a\":,}");
+    QTest::newRow("bad-literal") << QByteArray("[tru]");
+    QTest::newRow("bad-literal2") << QByteArray("[nul1]");
+    QTest::newRow("bad-number") << QByteArray("[-]");
+    QTest::newRow("bad-value") << QByteArray("[x]");
+    QTest::newRow("bad-escape") << QByteArray("[\"\\u12g4\"]");
+    QTest::newRow("bad-utf8") << QByteArray("[\"\xc0\xaf\"]");
+    QTest::newRow("truncated-utf8") << QByteArray("[\"\xe2\x82");
+    QTest::newRow("garbage") << QByteArray("{} x");
+    QTest::newRow("two-documents") << QByteArray("{}{}");
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError expected;
+    QJsonDocument::fromJson(json, &expected);
+    QVERIFY(expected.error != QJsonParseError::NoError);
+
+    QJsonStreamReader reader(json);
+    QVERIFY(trace(reader).endsWith(QLatin1Char('!')));
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), expected.error);
+    QCOMPARE(reader.errorString(), expected.errorString());
+    QVERIFY(reader.atEnd());
+
+    // errors are sticky
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), expected.error);
+}
+
+void tst_QJsonStreamReader::nestingLimit()
+{
+    QByteArray json(1024, '[');
+    json += QByteArray(1024, ']');
+    QJsonStreamReader reader(json);
+    QVERIFY(trace(reader).endsWith(QLatin1Char('$')));
+
+    json = QByteArray(1025, '[') + QByteArray(1025, ']');
+    reader.clear();
+    reader.addData(json);
+    QVERIFY(trace(reader).endsWith(QLatin1Char('!')));
+    QCOMPARE(reader.error(), QJsonParseError::DeepNesting);
+    QCOMPARE(reader.depth(), 1024);
+    QCOMPARE(reader.offset(), qint64(1024));
+}
+
+void tst_QJsonStreamReader::multipleDocuments()
+{
+    const QByteArray json = "{\"a\":1}\n[2]\n\"three\" 4\n\n";
+
+    QJsonStreamReader reader(json);
+    reader.setMultipleDocumentsAllowed(true);
+    QVERIFY(reader.multipleDocumentsAllowed());
+    QCOMPARE(trace(reader), QStringLiteral("{ a: 1 } [ 2 ] \"three\" 4 $"));
+
+    // Without an end of input, each document is still complete when it's been read
+    reader.clear();
+    reader.setMultipleDocumentsAllowed(true);
+    int documents = 0;
+    const QList<QByteArray> lines = json.split('\n');
+    for (const QByteArray &line : lines) {
+        reader.addData(line + '\n');
+        while (reader.readNext() != QJsonStreamReader::Invalid) {
+            if (reader.depth() == 0 && !reader.isStartObject() && !reader.isStartArray())
+                ++documents;
+        }
+        QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    }
+    QCOMPARE(documents, 4);
+
+    // Empty input
+    QJsonStreamReader empty(QByteArray(" \n"));
+    empty.setMultipleDocumentsAllowed(true);
+    QCOMPARE(trace(empty), QStringLiteral("$"));
+
+    // Errors still stop the reader
+    QJsonStreamReader broken(QByteArray("{} [1 2]"));
+    broken.setMultipleDocumentsAllowed(true);
+    QCOMPARE(trace(broken), QStringLiteral("{ } [ 1 !"));
+    QCOMPARE(broken.error(), QJsonParseError::MissingValueSeparator);
+}
+
+void tst_QJsonStreamReader::singleDocumentTrailingData()
+{
+    // Trailing whitespace is fine, in any number of chunks
+    QJsonStreamReader reader;
+    reader.addData("{\"a\"");
+    QCOMPARE(trace(reader), QStringLiteral("{ !"));
+    reader.addData(": [1]}  ");
+    QCOMPARE(trace(reader), QStringLiteral("a: [ 1 ] } $"));
+
+    // A top-level number is complete only at the end of the input
+    QJsonStreamReader number;
+    number.addData("12");
+    QCOMPARE(trace(number), QStringLiteral("!"));
+    number.addData("34 ");
+    QCOMPARE(trace(number), QStringLiteral("1234 $"));
+
+    QByteArray data("[] 1");
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader device(&buffer);
+    QCOMPARE(trace(device), QStringLiteral("[ ] !"));
+    QCOMPARE(device.error(), QJsonParseError::GarbageAtEnd);
+    QCOMPARE(device.offset(), qint64(3));
+}
+
+void tst_QJsonStreamReader::skipCurrentValue()
+{
+    QJsonStreamReader reader(QByteArray(
+            "{\"skip\": {\"a\": [1, {\"b\": \"\\u0041\"}], \"c\": {}}, \"keep\": 2,"
+            " \"skip2\": \"string\", \"last\": [[], [3]]}"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.name(), QStringLiteral("skip"));
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.name(), QStringLiteral("keep"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Number);
+    QCOMPARE(reader.integerValue(), qint64(2));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::String);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.name(), QStringLiteral("last"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+
+    QJsonStreamReader broken(QByteArray("[{\"a\": [1 2]}]"));
+    QCOMPARE(broken.readNext(), QJsonStreamReader::StartArray);
+    QVERIFY(!broken.skipCurrentValue());
+    QCOMPARE(broken.error(), QJsonParseError::MissingValueSeparator);
+}
+
+void tst_QJsonStreamReader::largeTokensFromDevice()
+{
+    // Tokens that straddle and exceed the internal chunk size
+    const QString big(100000, QLatin1Char('x'));
+    QByteArray json = "[\"" + big.toLatin1() + "\",";
+    for (int i = 0; i < 20000; ++i)
+        json += QByteArray::number(i) + ',';
+    json += "\"\xc3\xa9" + big.toLatin1() + "\\n\"]";
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.stringValue(), big);
+    for (int i = 0; i < 20000; ++i) {
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+        QCOMPARE(reader.integerValue(), qint64(i));
+    }
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.stringValue(), QString(QChar(0xe9) + big + QLatin1Char('\n')));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QCOMPARE(reader.offset(), qint64(json.size()));
+}
+
+void tst_QJsonStreamReader::compareWithQJsonDocument()
+{
+    QFile file(QFINDTESTDATA("../json/test.json"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray json = file.readAll();
+    QVERIFY(file.seek(0));
+
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    QVERIFY(!doc.isNull());
+
+    QJsonStreamReader reader(&file);
+    reader.readNext();
+    const QJsonValue value = readValue(reader);
+    QCOMPARE(reader.error(), QJsonParseError::NoError);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QCOMPARE(value, doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object()));
+}
+
+void tst_QJsonStreamReader::clear()
+{
+    QByteArray data("[1, 2]");
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamReader: addData() with device()");
+    reader.addData("x");
+
+    reader.clear();
+    QCOMPARE(reader.device(), nullptr);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QCOMPARE(reader.depth(), 0);
+    reader.addData("{}");
+    QCOMPARE(trace(reader), QStringLiteral("{ } $"));
+    QCOMPARE(reader.offset(), qint64(2));
+}
+
+QTEST_MAIN(tst_QJsonStreamReader)
+
+#include "tst_qjsonstreamreader.moc"
@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 SUBDIRS = \
     json \
+    qjsonstreamreader \
     qcborstreamreader \
     qcborstreamwriter \
     qcborvalue \
@@ -34,6 +34,7 @@
 #include <qhash.h>
 #include <limits.h>
 #include <private/qtools_p.h>
+#include <private/qbytearray_p.h>
 
 class tst_QByteArray : public QObject
 {
@@ -139,6 +140,7 @@ private slots:
     void movablity_data();
     void movablity();
     void literals();
+    void externalData();
     void toUpperLower_data();
     void toUpperLower();
     void isUpper();
@@ -2304,6 +2306,54 @@ void tst_QByteArray::movablity()
 }
 
 // Only tested on c++0x compliant compiler or gcc
+static void countCleanup(void *info)
+{
+    ++*static_cast<int *>(info);
+}
+
+void tst_QByteArray::externalData()
+{
+    static const char data[] = "external data";
+    int cleanups = 0;
+
+    {
+        QByteArray ba = qByteArrayFromExternalData(data, 8, countCleanup, &cleanups);
+        QCOMPARE(ba, QByteArray("external"));
+        QCOMPARE(ba.constData(), data);
+
+        QByteArray copy = ba;
+        ba.clear();
+        QCOMPARE(cleanups, 0);
+        QCOMPARE(copy.constData(), data);
+
+        // modifying a shared copy detaches only that copy
+        QByteArray chopped = copy;
+        chopped.chop(2);
+        QCOMPARE(chopped, QByteArray("extern"));
+        QVERIFY(chopped.constData() != data);
+        QCOMPARE(cleanups, 0);
+
+        // detaching the last reference releases the data
+        copy.append('!');
+        QCOMPARE(copy, QByteArray("external!"));
+        QCOMPARE(cleanups, 1);
+    }
+    QCOMPARE(cleanups, 1);
+
+    {
+        QByteArray ba = qByteArrayFromExternalData(data, 8, countCleanup, &cleanups);
+        ba.squeeze();
+        ba.setRawData(data + 9, 4);
+        QCOMPARE(ba, QByteArray("data"));
+        QCOMPARE(cleanups, 1);
+    }
+    QCOMPARE(cleanups, 2);
+
+    // nothing to keep alive
+    QVERIFY(qByteArrayFromExternalData(data, 0, countCleanup, &cleanups).isEmpty());
+    QCOMPARE(cleanups, 3);
+}
+
 void tst_QByteArray::literals()
 {
     QByteArray str(QByteArrayLiteral("abcd"));
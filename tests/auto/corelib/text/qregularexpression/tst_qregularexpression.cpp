@@ -85,6 +85,8 @@ private slots:
     void wildcard();
     void testInvalidWildcard_data();
     void testInvalidWildcard();
+    void patternCache();
+    void serializeCompiledPatterns();
 
 private:
     void provideRegularExpressions();
@@ -2306,6 +2308,153 @@ void tst_QRegularExpression::testInvalidWildcard()
     QCOMPARE(re.isValid(), isValid);
 }
 
+void tst_QRegularExpression::patternCache()
+{
+    const int defaultCapacity = QRegularExpression::patternCacheCapacity();
+    QCOMPARE(defaultCapacity, 256);
+    QRegularExpression::clearPatternCache();
+
+    {
+        QRegularExpression re1("(\\d+)-(\\w+)");
+        QVERIFY(re1.isValid());
+        QRegularExpression::PatternCacheStatistics stats = QRegularExpression::patternCacheStatistics();
+        QCOMPARE(stats.hits, 0);
+        QCOMPARE(stats.misses, 1);
+        QCOMPARE(stats.count, 1);
+
+        // a different object with the same pattern and options
+        QRegularExpression re2("(\\d+)-(\\w+)");
+        QCOMPARE(re2.match("42-abc").captured(2), QStringLiteral("abc"));
+        stats = QRegularExpression::patternCacheStatistics();
+        QCOMPARE(stats.hits, 1);
+        QCOMPARE(stats.misses, 1);
+        QCOMPARE(stats.count, 1);
+
+        // the options are part of the key
+        QRegularExpression re3("(\\d+)-(\\w+)", QRegularExpression::CaseInsensitiveOption);
+        QVERIFY(re3.isValid());
+        stats = QRegularExpression::patternCacheStatistics();
+        QCOMPARE(stats.misses, 2);
+        QCOMPARE(stats.count, 2);
+
+        // invalid patterns are not cached
+        QRegularExpression invalid("(");
+        QVERIFY(!invalid.isValid());
+        QVERIFY(!invalid.errorString().isEmpty());
+        QCOMPARE(invalid.patternErrorOffset(), 1);
+        QCOMPARE(QRegularExpression::patternCacheStatistics().count, 2);
+    }
+
+    // the least recently used patterns get evicted
+    QRegularExpression::clearPatternCache();
+    QRegularExpression::setPatternCacheCapacity(2);
+    QCOMPARE(QRegularExpression::patternCacheCapacity(), 2);
+    QRegularExpression a("a+");
+    QRegularExpression b("b+");
+    QRegularExpression c("c+");
+    QVERIFY(a.isValid());
+    QVERIFY(b.isValid());
+    QVERIFY(c.isValid());
+    QRegularExpression::PatternCacheStatistics stats = QRegularExpression::patternCacheStatistics();
+    QCOMPARE(stats.misses, 3);
+    QCOMPARE(stats.evictions, 1);
+    QCOMPARE(stats.count, 2);
+    QCOMPARE(stats.capacity, 2);
+
+    // evicted code stays valid for the expressions using it
+    QVERIFY(a.match("xaay").hasMatch());
+    QVERIFY(QRegularExpression("c+").isValid());
+    QCOMPARE(QRegularExpression::patternCacheStatistics().hits, 1);
+
+    // a capacity of 0 disables the cache
+    QRegularExpression::setPatternCacheCapacity(0);
+    stats = QRegularExpression::patternCacheStatistics();
+    QCOMPARE(stats.evictions, 3);
+    QCOMPARE(stats.count, 0);
+    QRegularExpression d("d+");
+    QRegularExpression e("d+");
+    QVERIFY(d.isValid());
+    QVERIFY(e.match("ddd").hasMatch());
+    stats = QRegularExpression::patternCacheStatistics();
+    QCOMPARE(stats.hits, 1);
+    QCOMPARE(stats.misses, 5);
+    QCOMPARE(stats.count, 0);
+
+    QRegularExpression::setPatternCacheCapacity(defaultCapacity);
+    QRegularExpression::clearPatternCache();
+    stats = QRegularExpression::patternCacheStatistics();
+    QCOMPARE(stats.hits, 0);
+    QCOMPARE(stats.misses, 0);
+    QCOMPARE(stats.evictions, 0);
+    QCOMPARE(stats.capacity, defaultCapacity);
+}
+
+void tst_QRegularExpression::serializeCompiledPatterns()
+{
+    const QList<QRegularExpression> expressions = {
+        QRegularExpression("^(?<year>\\d{4})-(?<month>\\d{2})-(?<day>\\d{2})$"),
+        QRegularExpression("hello\\s+world", QRegularExpression::CaseInsensitiveOption),
+        QRegularExpression("^\\w+$", QRegularExpression::UseUnicodePropertiesOption
+                                          | QRegularExpression::MultilineOption),
+    };
+
+    const QByteArray data = QRegularExpression::serializeCompiledPatterns(expressions);
+    QVERIFY(!data.isEmpty());
+
+    QRegularExpression::clearPatternCache();
+    const QList<QRegularExpression> loaded = QRegularExpression::deserializeCompiledPatterns(data);
+    QCOMPARE(loaded, expressions);
+    for (const QRegularExpression &re : loaded)
+        QVERIFY(re.isValid());
+    // the patterns were not compiled again, and they were added to the cache
+    QRegularExpression::PatternCacheStatistics stats = QRegularExpression::patternCacheStatistics();
+    QCOMPARE(stats.misses, 0);
+    QCOMPARE(stats.count, expressions.size());
+    QVERIFY(QRegularExpression("hello\\s+world", QRegularExpression::CaseInsensitiveOption).isValid());
+    QCOMPARE(QRegularExpression::patternCacheStatistics().hits, 1);
+
+    const QRegularExpressionMatch date = loaded.at(0).match("2022-11-07");
+    QVERIFY(date.hasMatch());
+    QCOMPARE(date.captured("month"), QStringLiteral("11"));
+    QCOMPARE(loaded.at(0).namedCaptureGroups(), expressions.at(0).namedCaptureGroups());
+    QVERIFY(loaded.at(1).match("HELLO   World").hasMatch());
+    QVERIFY(loaded.at(2).match("abc\n\u00e9t\u00e9").hasMatch());
+    QVERIFY(!loaded.at(2).match("a b").hasMatch());
+
+    // deserialized expressions can be modified like any other
+    QRegularExpression copy = loaded.at(1);
+    copy.setPatternOptions(QRegularExpression::NoPatternOption);
+    QVERIFY(!copy.match("HELLO world").hasMatch());
+    QVERIFY(loaded.at(1).match("HELLO world").hasMatch());
+
+    // deserialized patterns can be serialized again, also together with
+    // patterns compiled by this process
+    QRegularExpression::clearPatternCache();
+    const QList<QRegularExpression> mixed = loaded + QList<QRegularExpression>{ QRegularExpression("x+y") };
+    const QList<QRegularExpression> reloaded =
+            QRegularExpression::deserializeCompiledPatterns(QRegularExpression::serializeCompiledPatterns(mixed));
+    QCOMPARE(reloaded, mixed);
+    QVERIFY(reloaded.last().match("axxy").hasMatch());
+
+    // corrupted or truncated data
+    QByteArray corrupted = data;
+    corrupted[corrupted.size() - 30] = ~corrupted.at(corrupted.size() - 30);
+    QVERIFY(QRegularExpression::deserializeCompiledPatterns(corrupted).isEmpty());
+    QVERIFY(QRegularExpression::deserializeCompiledPatterns(data.left(data.size() / 2)).isEmpty());
+    QVERIFY(QRegularExpression::deserializeCompiledPatterns(QByteArray()).isEmpty());
+    QVERIFY(QRegularExpression::deserializeCompiledPatterns("not compiled patterns").isEmpty());
+
+    // invalid patterns cannot be serialized
+    QVERIFY(QRegularExpression::serializeCompiledPatterns({ QRegularExpression("a"), QRegularExpression("(") }).isEmpty());
+
+    // an empty list round-trips
+    const QByteArray empty = QRegularExpression::serializeCompiledPatterns({});
+    QVERIFY(!empty.isEmpty());
+    QVERIFY(QRegularExpression::deserializeCompiledPatterns(empty).isEmpty());
+
+    QRegularExpression::clearPatternCache();
+}
+
 QTEST_APPLESS_MAIN(tst_QRegularExpression)
 
 #include "tst_qregularexpression.moc"
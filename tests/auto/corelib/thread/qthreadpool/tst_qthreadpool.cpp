@@ -105,6 +105,10 @@ private slots:
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
     void threadReuse();
+    void workStealing();
+    void workStealingTryTakeAndClear();
+    void setWorkStealingWhileBusy();
+    void workStealingReserveThread();
 
 private:
     QMutex m_functionTestMutex;
@@ -1410,5 +1414,137 @@ void tst_QThreadPool::threadReuse()
     }
 }
 
+void tst_QThreadPool::workStealing()
+{
+    class FanOutTask : public QRunnable
+    {
+    public:
+        FanOutTask(QThreadPool *pool, QAtomicInt *counter, int depth)
+            : pool(pool), counter(counter), depth(depth)
+        {}
+
+        void run() override
+        {
+            counter->ref();
+            if (depth == 0)
+                return;
+            for (int i = 0; i < 4; ++i)
+                pool->start(new FanOutTask(pool, counter, depth - 1));
+        }
+
+    private:
+        QThreadPool *pool;
+        QAtomicInt *counter;
+        int depth;
+    };
+
+    QThreadPool threadPool;
+    QVERIFY(!threadPool.isWorkStealingEnabled());
+    threadPool.setMaxThreadCount(4);
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+
+    for (int round = 0; round < 10; ++round) {
+        QAtomicInt counter;
+        threadPool.start(new FanOutTask(&threadPool, &counter, 5));
+        for (int i = 0; i < 100; ++i)
+            threadPool.start([&counter] { counter.ref(); });
+        QVERIFY(threadPool.waitForDone());
+        // 1 + 4 + 16 + 64 + 256 + 1024 fan-out tasks, plus the plain ones
+        QCOMPARE(counter.loadRelaxed(), 1365 + 100);
+        QCOMPARE(threadPool.activeThreadCount(), 0);
+    }
+
+    // tasks are still picked up after the threads went idle
+    QAtomicInt counter;
+    threadPool.setExpiryTimeout(-1);
+    for (int i = 0; i < 1000; ++i) {
+        threadPool.start([&counter] { counter.ref(); });
+        if (i % 100 == 0)
+            QTest::qSleep(1);
+    }
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(counter.loadRelaxed(), 1000);
+}
+
+void tst_QThreadPool::workStealingTryTakeAndClear()
+{
+    QSemaphore started;
+    QSemaphore blocker;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.start([&] { started.release(); blocker.acquire(); });
+    started.acquire();
+
+    count.storeRelaxed(0);
+    QRunnable *taken = new CountingRunnable;
+    threadPool.start(taken);
+    for (int i = 0; i < 10; ++i)
+        threadPool.start(new CountingRunnable);
+
+    QVERIFY(threadPool.tryTake(taken));
+    QVERIFY(!threadPool.tryTake(taken));
+    delete taken;
+
+    threadPool.clear();
+    threadPool.start(new CountingRunnable);
+    blocker.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(count.loadRelaxed(), 1);
+}
+
+void tst_QThreadPool::setWorkStealingWhileBusy()
+{
+    QSemaphore blocker;
+
+    QThreadPool threadPool;
+    threadPool.start([&] { blocker.acquire(); });
+
+    QTest::ignoreMessage(QtWarningMsg, "QThreadPool::setWorkStealingEnabled: "
+                         "Cannot change the mode while runnables are queued or running");
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(!threadPool.isWorkStealingEnabled());
+
+    blocker.release();
+    QVERIFY(threadPool.waitForDone());
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+}
+
+// Test that threads running stolen tasks honor reserveThread()
+void tst_QThreadPool::workStealingReserveThread()
+{
+    QSemaphore started;
+    QSemaphore blocker;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(2);
+    threadPool.setWorkStealingEnabled(true);
+    for (int i = 0; i < 2; ++i)
+        threadPool.start([&] { started.release(); blocker.acquire(); });
+    started.acquire(2);
+
+    QAtomicInt running;
+    QAtomicInt maxRunning;
+    for (int i = 0; i < 50; ++i) {
+        threadPool.start([&] {
+            const int current = running.fetchAndAddRelaxed(1) + 1;
+            int seen = maxRunning.loadRelaxed();
+            while (current > seen && !maxRunning.testAndSetRelaxed(seen, current, seen)) { }
+            QThread::msleep(1);
+            running.deref();
+        });
+    }
+
+    // One of the two threads has to give way to the reserved one
+    threadPool.reserveThread();
+    blocker.release(2);
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(maxRunning.loadRelaxed(), 1);
+    threadPool.releaseThread();
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
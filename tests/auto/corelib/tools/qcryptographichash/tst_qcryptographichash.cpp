@@ -47,6 +47,15 @@ private slots:
     void files_data();
     void files();
     void hashLength();
+    void blockBoundaries_data();
+    void blockBoundaries();
+    void millionA_data();
+    void millionA();
+    void hashBatch_data();
+    void hashBatch();
+    void hashDevice_data();
+    void hashDevice();
+    void hashDeviceNotReadable();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -303,5 +312,151 @@ void tst_QCryptographicHash::hashLength()
     }
 }
 
+void tst_QCryptographicHash::blockBoundaries_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::newRow("sha1") << QCryptographicHash::Sha1;
+    QTest::newRow("sha224") << QCryptographicHash::Sha224;
+    QTest::newRow("sha256") << QCryptographicHash::Sha256;
+}
+
+void tst_QCryptographicHash::blockBoundaries()
+{
+    // whole-buffer input takes the block-at-a-time path, single bytes never do
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QByteArray data;
+    for (int i = 0; i < 2 * 64 * 64 + 7; ++i)
+        data.append(char(i * 7 + (i >> 8)));
+
+    const auto matches = [&](int length) {
+        const QByteArray prefix = data.left(length);
+        QCryptographicHash byteByByte(algorithm);
+        for (char c : prefix)
+            byteByByte.addData(&c, 1);
+        const QByteArray expected = byteByByte.result();
+
+        QCryptographicHash unaligned(algorithm);
+        const int split = qMin(length, 13);
+        unaligned.addData(prefix.constData(), split);
+        unaligned.addData(prefix.constData() + split, length - split);
+
+        return QCryptographicHash::hash(prefix, algorithm) == expected && unaligned.result() == expected;
+    };
+
+    for (int length = 0; length <= 300; ++length)
+        QVERIFY2(matches(length), qPrintable(QString::number(length)));
+    QVERIFY(matches(data.size()));
+}
+
+void tst_QCryptographicHash::millionA_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::newRow("sha1") << QCryptographicHash::Sha1
+                          << QByteArray("34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+    QTest::newRow("sha224") << QCryptographicHash::Sha224
+                            << QByteArray("20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67");
+    QTest::newRow("sha256") << QCryptographicHash::Sha256
+                            << QByteArray("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+void tst_QCryptographicHash::millionA()
+{
+    // FIPS 180-2 test vectors
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(QByteArray, expected);
+    const QByteArray data(1000000, 'a');
+    QCOMPARE(QCryptographicHash::hash(data, algorithm).toHex(), expected);
+    QCOMPARE(QCryptographicHash::hashBatch({ data, "abc", data }, algorithm).last().toHex(), expected);
+}
+
+void tst_QCryptographicHash::hashBatch_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::newRow("md5") << QCryptographicHash::Md5;
+    QTest::newRow("sha1") << QCryptographicHash::Sha1;
+    QTest::newRow("sha224") << QCryptographicHash::Sha224;
+    QTest::newRow("sha256") << QCryptographicHash::Sha256;
+    QTest::newRow("sha512") << QCryptographicHash::Sha512;
+    QTest::newRow("sha3_256") << QCryptographicHash::Sha3_256;
+}
+
+void tst_QCryptographicHash::hashBatch()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+
+    QCOMPARE(QCryptographicHash::hashBatch(QByteArrayList(), algorithm), QByteArrayList());
+
+    QByteArrayList data;
+    const int lengths[] = { 0, 1, 3, 55, 56, 57, 63, 64, 65, 119, 120, 128, 1000, 4096, 5000, 17 };
+    for (int round = 0; round < 5; ++round) {
+        for (int length : lengths) {
+            QByteArray message;
+            for (int i = 0; i < length + round * 31; ++i)
+                message.append(char(i ^ data.size()));
+            data.append(message);
+        }
+    }
+
+    for (int count : { 1, 2, 9, int(data.size()) }) {
+        const QByteArrayList batch = data.mid(0, count);
+        const QByteArrayList result = QCryptographicHash::hashBatch(batch, algorithm);
+        QCOMPARE(result.size(), batch.size());
+        for (int i = 0; i < batch.size(); ++i)
+            QCOMPARE(result.at(i), QCryptographicHash::hash(batch.at(i), algorithm));
+    }
+}
+
+void tst_QCryptographicHash::hashDevice_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("skip");
+    QTest::newRow("empty") << 0 << 0;
+    QTest::newRow("small") << 1000 << 0;
+    QTest::newRow("small-skip") << 1000 << 100;
+    QTest::newRow("large") << 3 * 1024 * 1024 + 5 << 0;
+    QTest::newRow("large-skip") << 3 * 1024 * 1024 + 5 << 4097;
+}
+
+void tst_QCryptographicHash::hashDevice()
+{
+    QFETCH(int, size);
+    QFETCH(int, skip);
+
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = char(i * 13 + (i >> 10));
+    const QByteArray expected = QCryptographicHash::hash(data.mid(skip), QCryptographicHash::Sha256);
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QCOMPARE(buffer.read(skip).size(), skip);
+    QCOMPARE(QCryptographicHash::hash(&buffer, QCryptographicHash::Sha256), expected);
+    QVERIFY(buffer.atEnd());
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(size));
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.read(skip).size(), skip);
+    QCOMPARE(QCryptographicHash::hash(&file, QCryptographicHash::Sha256), expected);
+    QVERIFY(file.atEnd());
+
+    // hashing from a device continues an earlier addData()
+    QVERIFY(file.seek(skip));
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(data.left(skip));
+    QVERIFY(hash.addData(&file));
+    QCOMPARE(hash.result(), QCryptographicHash::hash(data, QCryptographicHash::Sha256));
+}
+
+void tst_QCryptographicHash::hashDeviceNotReadable()
+{
+    QBuffer buffer;
+    QVERIFY(QCryptographicHash::hash(&buffer, QCryptographicHash::Sha1).isNull());
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(QCryptographicHash::hash(&buffer, QCryptographicHash::Sha1).isNull());
+}
+
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
@@ -0,0 +1,413 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+
+#include <algorithm>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndLookup();
+    void subscriptOperator();
+    void removeAndTake();
+    void eraseWhileIterating();
+    void iterate();
+    void reserve();
+    void squeeze();
+    void removeInsertCycles();
+    void collisions();
+    void copyAndMove();
+    void copyAfterErase();
+    void compare();
+    void initializerList();
+    void complexTypes();
+    void keysAndValues();
+    void clear();
+};
+
+struct Counted
+{
+    static int instances;
+
+    Counted(int v = 0) : value(v) { ++instances; }
+    Counted(const Counted &other) : value(other.value) { ++instances; }
+    ~Counted() { --instances; }
+    Counted &operator=(const Counted &other) = default;
+
+    int value;
+};
+int Counted::instances = 0;
+
+// All keys land in the same group and share a control byte
+struct BadKey
+{
+    int value;
+    bool operator==(const BadKey &other) const { return value == other.value; }
+};
+static uint qHash(const BadKey &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::insertAndLookup()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1, -1), -1);
+    QVERIFY(hash.find(1) == hash.end());
+
+    const int count = 10000;
+    for (int i = 0; i < count; ++i) {
+        QFlatHash<int, int>::iterator it = hash.insert(i * 7, i);
+        QCOMPARE(it.key(), i * 7);
+        QCOMPARE(it.value(), i);
+    }
+    QCOMPARE(hash.size(), count);
+    QVERIFY(hash.capacity() >= count);
+
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(hash.contains(i * 7));
+        QCOMPARE(hash.value(i * 7), i);
+        QCOMPARE(hash.constFind(i * 7).value(), i);
+        QVERIFY(!hash.contains(i * 7 + 1));
+    }
+
+    // Inserting an existing key replaces the value
+    hash.insert(14, 42);
+    QCOMPARE(hash.size(), count);
+    QCOMPARE(hash.value(14), 42);
+}
+
+void tst_QFlatHash::subscriptOperator()
+{
+    QFlatHash<QString, int> hash;
+    hash[QStringLiteral("one")] = 1;
+    ++hash[QStringLiteral("one")];
+    QCOMPARE(hash[QStringLiteral("two")], 0);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(QStringLiteral("one")), 2);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QStringLiteral("three")], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::removeAndTake()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, QString::number(i));
+
+    QCOMPARE(hash.remove(10), 1);
+    QCOMPARE(hash.remove(10), 0);
+    QCOMPARE(hash.take(20), QStringLiteral("20"));
+    QCOMPARE(hash.take(20), QString());
+    QCOMPARE(hash.size(), 98);
+    QVERIFY(!hash.contains(10));
+    QVERIFY(!hash.contains(20));
+    for (int i = 0; i < 100; ++i) {
+        if (i != 10 && i != 20)
+            QCOMPARE(hash.value(i), QString::number(i));
+    }
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 666);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.begin() == hash.end());
+    QVERIFY(hash.constBegin() == hash.constEnd());
+
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, i * 2);
+
+    QVector<bool> seen(500);
+    int n = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.cbegin(); it != hash.cend(); ++it) {
+        QCOMPARE(it.value(), it.key() * 2);
+        QVERIFY(!seen.at(it.key()));
+        seen[it.key()] = true;
+        ++n;
+    }
+    QCOMPARE(n, 500);
+
+    for (int &value : hash)
+        value = -value;
+    QCOMPARE(hash.value(3), -6);
+}
+
+void tst_QFlatHash::reserve()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+
+    hash.insert(0, 0);
+    const int *first = &hash.find(0).value();
+    for (int i = 1; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+    // Nothing was rehashed, so the first item did not move
+    QCOMPARE(&hash.find(0).value(), first);
+
+    // Reserving less than we already have is a no-op
+    hash.reserve(10);
+    QCOMPARE(hash.capacity(), capacity);
+}
+
+void tst_QFlatHash::squeeze()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    const int capacity = hash.capacity();
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::removeInsertCycles()
+{
+    // Removing leaves markers behind; the table must reclaim them rather
+    // than grow without bound
+    QFlatHash<int, int> hash;
+    hash.reserve(100);
+    const int capacity = hash.capacity();
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 50; ++i)
+            hash.insert(round * 50 + i, i);
+        for (int i = 0; i < 50; ++i)
+            QCOMPARE(hash.remove(round * 50 + i), 1);
+    }
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), capacity);
+
+    hash.insert(1, 1);
+    QCOMPARE(hash.value(1), 1);
+}
+
+void tst_QFlatHash::collisions()
+{
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(BadKey{ i }, i);
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(BadKey{ i }, -1), i);
+    QVERIFY(!hash.contains(BadKey{ 200 }));
+
+    for (int i = 0; i < 200; i += 2)
+        hash.remove(BadKey{ i });
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.contains(BadKey{ i }), i % 2 == 1);
+}
+
+void tst_QFlatHash::copyAndMove()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, QString::number(i));
+    hash.remove(50);
+
+    QFlatHash<int, QString> copy(hash);
+    QCOMPARE(copy.size(), 99);
+    copy.insert(50, QStringLiteral("fifty"));
+    QVERIFY(!hash.contains(50));
+    QCOMPARE(copy.value(50), QStringLiteral("fifty"));
+    QCOMPARE(copy.value(99), QStringLiteral("99"));
+
+    QFlatHash<int, QString> moved(std::move(copy));
+    QCOMPARE(moved.size(), 100);
+    QVERIFY(copy.isEmpty());
+
+    copy = moved;
+    QCOMPARE(copy.size(), 100);
+    hash = std::move(moved);
+    QCOMPARE(hash.size(), 100);
+    QCOMPARE(hash.value(50), QStringLiteral("fifty"));
+
+    copy.swap(moved);
+    QCOMPARE(moved.size(), 100);
+    QVERIFY(copy.isEmpty());
+}
+
+void tst_QFlatHash::copyAfterErase()
+{
+    // Elements that probed past a group which was full, and only has room
+    // again because of an erase, must still be found in a copy
+    QFlatHash<BadKey, int> collided;
+    for (int i = 0; i < 100; ++i)
+        collided.insert(BadKey{ i }, i);
+    for (int i = 0; i < 100; i += 3)
+        collided.remove(BadKey{ i });
+    const QFlatHash<BadKey, int> collidedCopy(collided);
+    QCOMPARE(collidedCopy.size(), collided.size());
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(collidedCopy.value(BadKey{ i }, -1), i % 3 ? i : -1);
+
+    // 112 elements fill 128 slots up to the maximum load
+    for (int round = 0; round < 100; ++round) {
+        QFlatHash<int, int> hash;
+        hash.reserve(112);
+        QCOMPARE(hash.capacity(), 112);
+        for (int i = 0; i < 112; ++i)
+            hash.insert(round * 1000 + i, i);
+        for (int i = 0; i < 112; i += 3)
+            hash.remove(round * 1000 + i);
+
+        QFlatHash<int, int> copy(hash);
+        QCOMPARE(copy, hash);
+        for (int i = 0; i < 112; ++i)
+            QCOMPARE(copy.value(round * 1000 + i, -1), i % 3 ? i : -1);
+
+        // the copy reuses the deleted slots like the original would
+        for (int i = 0; i < 112; i += 3)
+            copy.insert(round * 1000 + i, i);
+        QCOMPARE(copy.size(), 112);
+        QCOMPARE(copy.capacity(), 112);
+        for (int i = 0; i < 112; ++i)
+            QCOMPARE(copy.value(round * 1000 + i, -1), i);
+    }
+}
+
+void tst_QFlatHash::compare()
+{
+    QFlatHash<int, int> a;
+    QFlatHash<int, int> b;
+    QVERIFY(a == b);
+
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+
+    b.insert(5, 6);
+    QVERIFY(a != b);
+    b.remove(5);
+    QVERIFY(a != b);
+}
+
+void tst_QFlatHash::initializerList()
+{
+    QFlatHash<int, QString> hash{ { 1, QStringLiteral("one") },
+                                  { 2, QStringLiteral("two") },
+                                  { 1, QStringLiteral("uno") } };
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(1), QStringLiteral("uno"));
+    QCOMPARE(hash.value(2), QStringLiteral("two"));
+}
+
+void tst_QFlatHash::complexTypes()
+{
+    QCOMPARE(Counted::instances, 0);
+    {
+        QFlatHash<QString, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(QString::number(i), Counted(i));
+        QCOMPARE(Counted::instances, 1000);
+
+        for (int i = 0; i < 1000; i += 2)
+            hash.remove(QString::number(i));
+        QCOMPARE(Counted::instances, 500);
+
+        QCOMPARE(hash.take(QStringLiteral("1")).value, 1);
+        QCOMPARE(Counted::instances, 499);
+
+        QFlatHash<QString, Counted> copy = hash;
+        QCOMPARE(Counted::instances, 998);
+        copy.squeeze();
+        QCOMPARE(Counted::instances, 998);
+        QCOMPARE(copy.value(QStringLiteral("999")).value, 999);
+    }
+    QCOMPARE(Counted::instances, 0);
+}
+
+void tst_QFlatHash::keysAndValues()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 50; ++i)
+        hash.insert(i, i + 100);
+
+    QList<int> keys = hash.keys();
+    QList<int> values = hash.values();
+    std::sort(keys.begin(), keys.end());
+    std::sort(values.begin(), values.end());
+    QCOMPARE(keys.size(), 50);
+    for (int i = 0; i < 50; ++i) {
+        QCOMPARE(keys.at(i), i);
+        QCOMPARE(values.at(i), i + 100);
+    }
+}
+
+void tst_QFlatHash::clear()
+{
+    QFlatHash<QString, QString> hash;
+    hash.insert(QStringLiteral("a"), QStringLiteral("b"));
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(QStringLiteral("a")));
+    hash.insert(QStringLiteral("c"), QStringLiteral("d"));
+    QCOMPARE(hash.value(QStringLiteral("c")), QStringLiteral("d"));
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
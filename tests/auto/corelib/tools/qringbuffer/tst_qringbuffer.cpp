@@ -52,6 +52,7 @@ private slots:
     void ungetChar();
     void indexOf();
     void appendAndRead();
+    void readPointers();
     void peek();
     void readLine();
 };
@@ -364,6 +365,31 @@ void tst_QRingBuffer::appendAndRead()
     QCOMPARE(ringBuffer.read(), ba3);
 }
 
+void tst_QRingBuffer::readPointers()
+{
+    QRingBuffer ringBuffer;
+    const char *data[4];
+    qint64 sizes[4];
+    QCOMPARE(ringBuffer.readPointers(data, sizes, 4), 0);
+
+    QByteArray ba1("Hello world!");
+    QByteArray ba2("Test string.");
+    QByteArray ba3("0123456789");
+    ringBuffer.append(ba1);
+    ringBuffer.append(ba2);
+    ringBuffer.append(ba3);
+    ringBuffer.free(6);
+
+    QCOMPARE(ringBuffer.readPointers(data, sizes, 2), 2);
+    QCOMPARE(QByteArray(data[0], sizes[0]), QByteArray("world!"));
+    QCOMPARE(QByteArray(data[1], sizes[1]), ba2);
+    // Appended byte arrays are shared, not copied
+    QCOMPARE(data[1], ba2.constData());
+
+    QCOMPARE(ringBuffer.readPointers(data, sizes, 4), 3);
+    QCOMPARE(QByteArray(data[2], sizes[2]), ba3);
+}
+
 void tst_QRingBuffer::peek()
 {
     QRingBuffer ringBuffer;
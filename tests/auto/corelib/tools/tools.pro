@@ -12,6 +12,7 @@ SUBDIRS=\
     qcryptographichash \
     qeasingcurve \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
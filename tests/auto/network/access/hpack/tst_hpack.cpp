@@ -54,11 +54,13 @@ private Q_SLOTS:
     void bitstreamReadWrite();
     void bitstreamCompression();
     void bitstreamErrors();
+    void bitstreamHuffman();
 
     void lookupTableConstructor();
 
     void lookupTableStatic();
     void lookupTableDynamic();
+    void lookupTableDuplicates();
 
     void hpackEncodeRequest_data();
     void hpackEncodeRequest();
@@ -342,6 +344,74 @@ void tst_Hpack::bitstreamErrors()
     }
 }
 
+void tst_Hpack::bitstreamHuffman()
+{
+    {
+        // Every octet value, in both directions:
+        QByteArray allOctets;
+        for (int i = 0; i < 256; ++i)
+            allOctets.append(char(i));
+        allOctets += allOctets;
+
+        std::vector<uchar> buffer;
+        BitOStream out(buffer);
+        out.write(allOctets, true);
+        BitIStream in(out.begin(), out.end());
+        QByteArray value;
+        QVERIFY(in.read(&value));
+        QCOMPARE(in.error(), StreamError::NoError);
+        QCOMPARE(value, allOctets);
+        QVERIFY(!in.hasMoreBits());
+    }
+    {
+        // HPACK, C.4.1:
+        const uchar bytes[] = {0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a,
+                               0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff};
+        std::vector<uchar> buffer;
+        BitOStream out(buffer);
+        out.write(QByteArray("www.example.com"), true);
+        QCOMPARE(out.byteLength(), quint64(sizeof bytes));
+        QVERIFY(std::equal(out.begin(), out.end(), bytes));
+
+        BitIStream in(bytes, bytes + sizeof bytes);
+        QByteArray value;
+        QVERIFY(in.read(&value));
+        QCOMPARE(value, QByteArray("www.example.com"));
+    }
+    {
+        // 'a' (00011) + valid padding:
+        const uchar bytes[] = {0x81, 0x1f};
+        BitIStream in(bytes, bytes + sizeof bytes);
+        QByteArray value;
+        QVERIFY(in.read(&value));
+        QCOMPARE(value, QByteArray("a"));
+    }
+    {
+        // 'a' + padding that is not a prefix of EOS:
+        const uchar bytes[] = {0x81, 0x18};
+        BitIStream in(bytes, bytes + sizeof bytes);
+        QByteArray value;
+        QVERIFY(!in.read(&value));
+        QCOMPARE(in.error(), StreamError::CompressionError);
+    }
+    {
+        // 'a' + padding longer than 7 bits:
+        const uchar bytes[] = {0x82, 0x1f, 0xff};
+        BitIStream in(bytes, bytes + sizeof bytes);
+        QByteArray value;
+        QVERIFY(!in.read(&value));
+        QCOMPARE(in.error(), StreamError::CompressionError);
+    }
+    {
+        // EOS:
+        const uchar bytes[] = {0x84, 0xff, 0xff, 0xff, 0xff};
+        BitIStream in(bytes, bytes + sizeof bytes);
+        QByteArray value;
+        QVERIFY(!in.read(&value));
+        QCOMPARE(in.error(), StreamError::CompressionError);
+    }
+}
+
 void tst_Hpack::lookupTableConstructor()
 {
     {
@@ -493,6 +563,43 @@ void tst_Hpack::lookupTableDynamic()
     QVERIFY(table.indexOf("name1") == 0);
 }
 
+void tst_Hpack::lookupTableDuplicates()
+{
+    FieldLookupTable table(4096, true);
+    const quint32 nStatic = table.numberOfStaticEntries();
+
+    // Static entries win over the dynamic ones:
+    QVERIFY(table.prependField(":method", "GET"));
+    QCOMPARE(table.indexOf(":method", "GET"), 2u);
+    QCOMPARE(table.indexOf(":method"), 2u);
+    QCOMPARE(table.indexOf("accept"), 19u);
+
+    QVERIFY(table.prependField("name", "value1"));
+    QVERIFY(table.prependField("name", "value2"));
+    QVERIFY(table.prependField("name", "value1"));
+    // The newest entries have the smallest indices:
+    QCOMPARE(table.indexOf("name", "value1"), nStatic + 1);
+    QCOMPARE(table.indexOf("name", "value2"), nStatic + 2);
+    QCOMPARE(table.indexOf("name"), nStatic + 1);
+
+    // Evicting ':method' and the older duplicate must not hide the newer ones:
+    table.evictEntry();
+    table.evictEntry();
+    QCOMPARE(table.numberOfDynamicEntries(), 2u);
+    QCOMPARE(table.indexOf("name", "value1"), nStatic + 1);
+    QCOMPARE(table.indexOf("name", "value2"), nStatic + 2);
+    QCOMPARE(table.indexOf("name"), nStatic + 1);
+
+    table.evictEntry();
+    QCOMPARE(table.indexOf("name", "value2"), 0u);
+    QCOMPARE(table.indexOf("name", "value1"), nStatic + 1);
+    QCOMPARE(table.indexOf("name"), nStatic + 1);
+
+    table.evictEntry();
+    QCOMPARE(table.indexOf("name", "value1"), 0u);
+    QCOMPARE(table.indexOf("name"), 0u);
+}
+
 void  tst_Hpack::hpackEncodeRequest_data()
 {
     QTest::addColumn<bool>("compression");
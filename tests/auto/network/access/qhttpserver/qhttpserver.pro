@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qhttpserver
+SOURCES += tst_qhttpserver.cpp
+QT = core network testlib
@@ -0,0 +1,491 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtNetwork/qhttpserver.h>
+#include <QtNetwork/qhttpserverrequest.h>
+#include <QtNetwork/qhttpserverresponse.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qtcpsocket.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qpointer.h>
+
+Q_DECLARE_METATYPE(QNetworkRequest::Attribute)
+
+class tst_QHttpServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void get_data();
+    void get();
+    void post_data();
+    void post();
+    void largeResponse_data();
+    void largeResponse();
+    void pipelining();
+    void chunkedRequest();
+    void unreadRequestBody_data();
+    void unreadRequestBody();
+    void noBody();
+    void http10();
+    void badRequest();
+    void keepAliveTimeout();
+    void http2HeaderLimit();
+
+private:
+    void addProtocols();
+    QUrl url(const QString &path) const;
+    QNetworkRequest networkRequest(const QString &path) const;
+    QByteArray rawExchange(const QByteArray &request, int expectedResponses);
+
+    QHttpServer *server = nullptr;
+};
+
+static QByteArray pattern(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = char('a' + (i * 7) % 26);
+    return data;
+}
+
+void tst_QHttpServer::init()
+{
+    server = new QHttpServer;
+    QVERIFY(server->listen(QHostAddress(QHostAddress::LocalHost)));
+    QVERIFY(server->isListening());
+    QVERIFY(server->serverPort() != 0);
+}
+
+void tst_QHttpServer::cleanup()
+{
+    delete server;
+    server = nullptr;
+}
+
+void tst_QHttpServer::addProtocols()
+{
+    QTest::addColumn<QNetworkRequest::Attribute>("attribute");
+    QTest::addColumn<bool>("http2");
+
+    QTest::newRow("http/1.1") << QNetworkRequest::HttpPipeliningAllowedAttribute << false;
+    QTest::newRow("h2c-upgrade") << QNetworkRequest::Http2AllowedAttribute << true;
+    QTest::newRow("h2c-direct") << QNetworkRequest::Http2DirectAttribute << true;
+}
+
+QUrl tst_QHttpServer::url(const QString &path) const
+{
+    return QUrl(QStringLiteral("http://127.0.0.1:%1%2").arg(server->serverPort()).arg(path));
+}
+
+QNetworkRequest tst_QHttpServer::networkRequest(const QString &path) const
+{
+    QFETCH(QNetworkRequest::Attribute, attribute);
+    QNetworkRequest request(url(path));
+    request.setAttribute(attribute, true);
+    return request;
+}
+
+QByteArray tst_QHttpServer::rawExchange(const QByteArray &request, int expectedResponses)
+{
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server->serverPort());
+    if (!socket.waitForConnected(5000))
+        return QByteArray();
+    socket.write(request);
+
+    QByteArray response;
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 5000 && socket.state() == QAbstractSocket::ConnectedState
+           && response.count("HTTP/1.") < expectedResponses) {
+        QTestEventLoop::instance().enterLoopMSecs(10);
+        response += socket.readAll();
+    }
+    // Let the last body arrive
+    QTestEventLoop::instance().enterLoopMSecs(50);
+    response += socket.readAll();
+    return response;
+}
+
+void tst_QHttpServer::get_data()
+{
+    addProtocols();
+}
+
+void tst_QHttpServer::get()
+{
+    QFETCH(bool, http2);
+
+    int requests = 0;
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        ++requests;
+        QCOMPARE(request->method(), QByteArray("GET"));
+        QVERIFY(request->isFinished());
+        QCOMPARE(request->majorVersion(), http2 ? 2 : 1);
+        QCOMPARE(request->url().port(), int(server->serverPort()));
+        response->setHeader("Content-Type", "text/plain");
+        response->write("hello " + request->url().path().toLatin1());
+        response->finish();
+    });
+
+    QNetworkAccessManager manager;
+    for (int i = 0; i < 3; ++i) {
+        QScopedPointer<QNetworkReply> reply(manager.get(networkRequest(QStringLiteral("/path%1").arg(i))));
+        QTRY_VERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+        QCOMPARE(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool(), http2);
+        QCOMPARE(reply->rawHeader("Content-Type"), QByteArray("text/plain"));
+        QCOMPARE(reply->readAll(), QByteArray("hello /path") + QByteArray::number(i));
+    }
+    QCOMPARE(requests, 3);
+}
+
+void tst_QHttpServer::post_data()
+{
+    addProtocols();
+}
+
+void tst_QHttpServer::post()
+{
+    const qint64 bufferSize = 4096;
+    server->setReadBufferSize(bufferSize);
+
+    const QByteArray body = pattern(1024 * 1024);
+    qint64 maxBuffered = 0;
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        QCryptographicHash *hash = new QCryptographicHash(QCryptographicHash::Sha1);
+        auto consume = [=, &maxBuffered]() {
+            maxBuffered = qMax(maxBuffered, request->bytesAvailable());
+            hash->addData(request->readAll());
+            if (request->atEnd()) {
+                response->write(hash->result().toHex());
+                response->finish();
+                delete hash;
+            }
+        };
+        connect(request, &QIODevice::readyRead, response, consume);
+        connect(request, &QHttpServerRequest::finished, response, consume);
+    });
+
+    QNetworkAccessManager manager;
+    QNetworkRequest request = networkRequest(QStringLiteral("/upload"));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+    QScopedPointer<QNetworkReply> reply(manager.post(request, body));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 20000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), QCryptographicHash::hash(body, QCryptographicHash::Sha1).toHex());
+    QVERIFY(maxBuffered > 0);
+    // HTTP/2 DATA frames are not split, so a frame may overshoot the buffer
+    QVERIFY2(maxBuffered <= bufferSize + 16384, QByteArray::number(maxBuffered).constData());
+}
+
+void tst_QHttpServer::largeResponse_data()
+{
+    addProtocols();
+}
+
+void tst_QHttpServer::largeResponse()
+{
+    const QByteArray body = pattern(3 * 1024 * 1024);
+    const int chunkSize = 64 * 1024;
+    qint64 maxQueued = 0;
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *, QHttpServerResponse *response) {
+        // Generate the body as the connection takes it
+        int *offset = new int(0);
+        auto produce = [=, &body, &maxQueued]() {
+            while (response->bytesToWrite() < 2 * chunkSize && *offset < body.size()) {
+                response->write(body.mid(*offset, chunkSize));
+                *offset += chunkSize;
+            }
+            maxQueued = qMax(maxQueued, response->bytesToWrite());
+            if (*offset >= body.size() && !response->isFinished()) {
+                response->finish();
+                delete offset;
+                response->disconnect();
+            }
+        };
+        connect(response, &QIODevice::bytesWritten, response, produce);
+        produce();
+    });
+
+    QNetworkAccessManager manager;
+    QScopedPointer<QNetworkReply> reply(manager.get(networkRequest(QStringLiteral("/large"))));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 20000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    const QByteArray received = reply->readAll();
+    QCOMPARE(received.size(), body.size());
+    QVERIFY(received == body);
+    QVERIFY(maxQueued <= 2 * chunkSize + chunkSize);
+}
+
+void tst_QHttpServer::pipelining()
+{
+    // The second response is complete first, but has to wait
+    QPointer<QHttpServerResponse> first;
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        if (request->url().path() == QLatin1String("/first")) {
+            first = response;
+            return;
+        }
+        response->write("second");
+        response->finish();
+        QTimer::singleShot(100, first.data(), [&first]() {
+            first->write("first");
+            first->finish();
+        });
+    });
+
+    const QByteArray response = rawExchange("GET /first HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                                            "GET /second HTTP/1.1\r\nHost: localhost\r\n\r\n", 2);
+    const int firstIndex = response.indexOf("\r\n\r\nfirst");
+    const int secondIndex = response.indexOf("\r\n\r\nsecond");
+    QVERIFY2(firstIndex > 0 && secondIndex > firstIndex, response.constData());
+    QCOMPARE(response.count("Content-Length:"), 2);
+}
+
+void tst_QHttpServer::chunkedRequest()
+{
+    QByteArray received;
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        connect(request, &QIODevice::readyRead, request, [&received, request]() {
+            received += request->readAll();
+        });
+        connect(request, &QHttpServerRequest::finished, response, [response]() {
+            // Not finished in this event loop iteration: chunked response
+            response->write("part1,");
+            QTimer::singleShot(10, response, [response]() {
+                response->write("part2");
+                response->finish();
+            });
+        });
+    });
+
+    const QByteArray response = rawExchange("POST / HTTP/1.1\r\nHost: localhost\r\n"
+                                            "Transfer-Encoding: chunked\r\n\r\n"
+                                            "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n", 1);
+    QCOMPARE(received, QByteArray("hello world"));
+    QVERIFY2(response.contains("Transfer-Encoding: chunked\r\n"), response.constData());
+    QVERIFY2(response.endsWith("\r\n\r\n6\r\npart1,\r\n5\r\npart2\r\n0\r\n\r\n"), response.constData());
+}
+
+void tst_QHttpServer::unreadRequestBody_data()
+{
+    QTest::addColumn<bool>("chunked");
+
+    QTest::newRow("content-length") << false;
+    QTest::newRow("chunked") << true;
+}
+
+void tst_QHttpServer::unreadRequestBody()
+{
+    QFETCH(bool, chunked);
+
+    QPointer<QHttpServerRequest> request;
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *r, QHttpServerResponse *) { request = r; });
+
+    // More than the kernel buffers on both ends of a loopback connection
+    const QByteArray body = pattern(32 * 1024 * 1024);
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server->serverPort());
+    QVERIFY(socket.waitForConnected(5000));
+    if (chunked) {
+        socket.write("POST / HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n");
+        const int chunkSize = 1024 * 1024;
+        for (int i = 0; i < body.size(); i += chunkSize) {
+            socket.write(QByteArray::number(chunkSize, 16) + "\r\n");
+            socket.write(body.mid(i, chunkSize) + "\r\n");
+        }
+        socket.write("0\r\n\r\n");
+    } else {
+        socket.write("POST / HTTP/1.1\r\nHost: localhost\r\nContent-Length: "
+                     + QByteArray::number(body.size()) + "\r\n\r\n");
+        socket.write(body);
+    }
+
+    // The application does not read the body: the server must stop
+    // reading from the connection instead of buffering the rest
+    QTRY_VERIFY(request);
+    QTest::qWait(500);
+    QVERIFY(request->bytesAvailable() <= server->readBufferSize());
+    QVERIFY2(socket.bytesToWrite() > body.size() / 2, QByteArray::number(socket.bytesToWrite()));
+
+    // Reading resumes once the application catches up
+    QByteArray received;
+    connect(request, &QIODevice::readyRead, this, [&]() {
+        QVERIFY(request->bytesAvailable() <= server->readBufferSize());
+        received += request->readAll();
+    });
+    received += request->readAll();
+    QTRY_VERIFY_WITH_TIMEOUT(request->isFinished(), 30000);
+    received += request->readAll();
+    QCOMPARE(received.size(), body.size());
+    QVERIFY(received == body);
+    QCOMPARE(socket.bytesToWrite(), qint64(0));
+}
+
+void tst_QHttpServer::noBody()
+{
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        if (request->url().path() == QLatin1String("/empty"))
+            response->setStatusCode(204);
+        response->write("body");
+        response->finish();
+    });
+
+    const QByteArray response = rawExchange("HEAD / HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                                            "GET /empty HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                                            "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n", 3);
+    QCOMPARE(response.count("HTTP/1.1 200 OK\r\n"), 2);
+    QCOMPARE(response.count("HTTP/1.1 204 No Content\r\n"), 1);
+    QCOMPARE(response.count("body"), 1);
+    QVERIFY(response.endsWith("\r\n\r\nbody"));
+}
+
+void tst_QHttpServer::http10()
+{
+    connect(server, &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        QCOMPARE(request->minorVersion(), 0);
+        response->write("streamed");
+        QTimer::singleShot(10, response, &QHttpServerResponse::finish);
+    });
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server->serverPort());
+    QVERIFY(socket.waitForConnected(5000));
+    socket.write("GET / HTTP/1.0\r\n\r\n");
+    // The body length is unknown, so the connection delimits it
+    QTRY_COMPARE(socket.state(), QAbstractSocket::UnconnectedState);
+    const QByteArray response = socket.readAll();
+    QVERIFY2(response.startsWith("HTTP/1.1 200 OK\r\n"), response.constData());
+    QVERIFY(response.contains("Connection: close\r\n"));
+    QVERIFY(!response.contains("Content-Length"));
+    QVERIFY(response.endsWith("\r\n\r\nstreamed"));
+}
+
+void tst_QHttpServer::badRequest()
+{
+    int requests = 0;
+    connect(server, &QHttpServer::newRequest, this, [&]() { ++requests; });
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server->serverPort());
+    QVERIFY(socket.waitForConnected(5000));
+    socket.write("NONSENSE\r\n\r\n");
+    QTRY_COMPARE(socket.state(), QAbstractSocket::UnconnectedState);
+    QVERIFY(socket.readAll().startsWith("HTTP/1.1 400 Bad Request\r\n"));
+
+    QTcpSocket socket2;
+    socket2.connectToHost(QHostAddress::LocalHost, server->serverPort());
+    QVERIFY(socket2.waitForConnected(5000));
+    socket2.write("GET / HTTP/2.0\r\n\r\n");
+    QTRY_COMPARE(socket2.state(), QAbstractSocket::UnconnectedState);
+    QVERIFY(socket2.readAll().startsWith("HTTP/1.1 505 HTTP Version Not Supported\r\n"));
+    QCOMPARE(requests, 0);
+}
+
+void tst_QHttpServer::keepAliveTimeout()
+{
+    server->setKeepAliveTimeout(100);
+    QCOMPARE(server->keepAliveTimeout(), 100);
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server->serverPort());
+    QVERIFY(socket.waitForConnected(5000));
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QAbstractSocket::UnconnectedState, 2000);
+}
+
+static QByteArray http2Frame(uchar type, uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    QByteArray frame(9, Qt::Uninitialized);
+    qToBigEndian(quint32(payload.size()) << 8 | type, frame.data());
+    frame[4] = char(flags);
+    qToBigEndian(streamID, frame.data() + 5);
+    return frame + payload;
+}
+
+void tst_QHttpServer::http2HeaderLimit()
+{
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server->serverPort());
+    QVERIFY(socket.waitForConnected(5000));
+    socket.write("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+    socket.write(http2Frame(0x4, 0, 0, QByteArray())); // SETTINGS
+
+    // A header block that never ends; the fragments are not decoded
+    // before END_HEADERS arrives
+    const QByteArray fragment(16000, 'x');
+    socket.write(http2Frame(0x1, 0x1, 1, fragment)); // HEADERS, END_STREAM
+    for (int i = 0; i < 64; ++i)
+        socket.write(http2Frame(0x9, 0, 1, fragment)); // CONTINUATION
+    QTRY_COMPARE(socket.state(), QAbstractSocket::UnconnectedState);
+
+    const QByteArray response = socket.readAll();
+    bool advertised = false;
+    quint32 goAwayError = 0;
+    for (int pos = 0; pos + 9 <= response.size();) {
+        const uchar *frame = reinterpret_cast<const uchar *>(response.constData()) + pos;
+        const int size = int(qFromBigEndian<quint32>(frame) >> 8);
+        const uchar type = frame[3];
+        const uchar *payload = frame + 9;
+        QVERIFY(pos + 9 + size <= response.size());
+        if (type == 0x4 && !(frame[4] & 0x1)) {
+            for (int i = 0; i + 6 <= size; i += 6) {
+                if (qFromBigEndian<quint16>(payload + i) == 0x6) // MAX_HEADER_LIST_SIZE
+                    advertised = qFromBigEndian<quint32>(payload + i + 2) > 0;
+            }
+        } else if (type == 0x7 && size >= 8) {
+            goAwayError = qFromBigEndian<quint32>(payload + 4);
+        }
+        pos += 9 + size;
+    }
+    QVERIFY(advertised);
+    QCOMPARE(goAwayError, quint32(0xb)); // ENHANCE_YOUR_CALM
+}
+
+QTEST_MAIN(tst_QHttpServer)
+
+#include "tst_qhttpserver.moc"
@@ -30,6 +30,9 @@
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QHttpServer>
+#include <QtNetwork/QHttpServerRequest>
+#include <QtNetwork/QHttpServerResponse>
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/QNetworkConfigurationManager>
 #endif
@@ -50,6 +53,8 @@ public:
 private slots:
     void networkAccessible();
     void alwaysCacheRequest();
+    void maximumConnectionsPerHost();
+    void connectionIdleTimeout();
 };
 
 tst_QNetworkAccessManager::tst_QNetworkAccessManager()
@@ -129,5 +134,98 @@ void tst_QNetworkAccessManager::alwaysCacheRequest()
     delete reply;
 }
 
+void tst_QNetworkAccessManager::maximumConnectionsPerHost()
+{
+    QHttpServer server;
+    QVERIFY(server.listen(QHostAddress(QHostAddress::LocalHost)));
+
+    // Hold the responses until all connections are busy
+    QList<QPointer<QHttpServerResponse> > pending;
+    QSet<quint16> peerPorts;
+    bool respond = false;
+    connect(&server, &QHttpServer::newRequest,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        peerPorts.insert(request->peerPort());
+        if (respond) {
+            response->finish();
+            return;
+        }
+        pending.append(response);
+    });
+
+    QNetworkAccessManager manager;
+    QCOMPARE(manager.maximumConnectionsPerHost(), 6);
+    manager.setMaximumConnectionsPerHost(2);
+    QCOMPARE(manager.maximumConnectionsPerHost(), 2);
+    QCOMPARE(manager.maximumConnectionsPerHost(QLatin1String("127.0.0.1")), 0);
+    manager.setMaximumConnectionsPerHost(QLatin1String("127.0.0.1"), 3);
+    QCOMPARE(manager.maximumConnectionsPerHost(QLatin1String("127.0.0.1")), 3);
+    QCOMPARE(manager.maximumConnectionsPerHost(), 2);
+
+    const QUrl url(QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort()));
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < 8; ++i)
+        replies.append(manager.get(QNetworkRequest(url)));
+
+    QTRY_COMPARE(pending.size(), 3);
+    QTRY_COMPARE(manager.connectionPoolStatistics().queuedRequests, 5);
+    QNetworkAccessManager::ConnectionPoolStatistics statistics = manager.connectionPoolStatistics();
+    QCOMPARE(statistics.openConnections, 3);
+    QCOMPARE(statistics.idleConnections, 0);
+    QCOMPARE(statistics.activeRequests, 3);
+    QCOMPARE(statistics.connectionCount, qint64(3));
+    QCOMPARE(peerPorts.size(), 3);
+
+    respond = true;
+    for (const QPointer<QHttpServerResponse> &response : qAsConst(pending))
+        response->finish();
+    for (QNetworkReply *reply : qAsConst(replies))
+        QTRY_VERIFY(reply->isFinished());
+    qDeleteAll(replies);
+
+    // The connections stay open for the next requests
+    QTRY_COMPARE(manager.connectionPoolStatistics().idleConnections, 3);
+    statistics = manager.connectionPoolStatistics();
+    QCOMPARE(statistics.openConnections, 3);
+    QCOMPARE(statistics.activeRequests, 0);
+    QCOMPARE(statistics.queuedRequests, 0);
+    QCOMPARE(statistics.requestCount, qint64(8));
+    QCOMPARE(statistics.connectionCount, qint64(3));
+    QCOMPARE(statistics.reuseRatio(), 1.0 - 3.0 / 8.0);
+    QCOMPARE(peerPorts.size(), 3);
+}
+
+void tst_QNetworkAccessManager::connectionIdleTimeout()
+{
+    QHttpServer server;
+    QVERIFY(server.listen(QHostAddress(QHostAddress::LocalHost)));
+    connect(&server, &QHttpServer::newRequest,
+            [](QHttpServerRequest *, QHttpServerResponse *response) {
+        response->write("ok");
+        response->finish();
+    });
+
+    QNetworkAccessManager manager;
+    QCOMPARE(manager.connectionIdleTimeout(), 120000);
+    manager.setConnectionIdleTimeout(200);
+    QCOMPARE(manager.connectionIdleTimeout(), 200);
+
+    const QUrl url(QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort()));
+    QScopedPointer<QNetworkReply> reply(manager.get(QNetworkRequest(url)));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->readAll(), QByteArray("ok"));
+    reply.reset();
+
+    QTRY_COMPARE(manager.connectionPoolStatistics().openConnections, 1);
+    QTRY_COMPARE_WITH_TIMEOUT(manager.connectionPoolStatistics().openConnections, 0, 5000);
+
+    // The next request has to connect again
+    reply.reset(manager.get(QNetworkRequest(url)));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(manager.connectionPoolStatistics().connectionCount, qint64(2));
+    QCOMPARE(manager.connectionPoolStatistics().requestCount, qint64(2));
+}
+
 QTEST_MAIN(tst_QNetworkAccessManager)
 #include "tst_qnetworkaccessmanager.moc"
@@ -343,6 +343,7 @@ private Q_SLOTS:
     void ioPostToHttpFromMiddleOfQBufferFiveBytes();
     void ioPostToHttpNoBufferFlag();
     void ioPostToHttpUploadProgress();
+    void ioPutToLocalHttpFromFile();
     void emitAllUploadProgressSignals();
     void ioPostToHttpEmptyUploadProgress();
 
@@ -5301,6 +5302,56 @@ void tst_QNetworkReply::ioPostToHttpUploadProgress()
     server.close();
 }
 
+// On plain HTTP, a QFile is sent by the socket straight from the file
+void tst_QNetworkReply::ioPutToLocalHttpFromFile()
+{
+    QByteArray content(2 * 1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < content.size(); ++i)
+        content[i] = char(i * 7 + (i >> 11));
+    QTemporaryFile sourceFile;
+    QVERIFY(sourceFile.open());
+    QCOMPARE(sourceFile.write(content), qint64(content.size()));
+    QVERIFY(sourceFile.flush());
+    // only the data from the current position on is uploaded
+    QVERIFY(sourceFile.seek(1000));
+    const QByteArray expected = content.mid(1000);
+
+    // emulate a minimal http server
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QUrl url = QUrl(QString("http://127.0.0.1:%1/").arg(server.serverPort()));
+    QNetworkRequest request(url);
+    request.setRawHeader("Content-Type", "application/octet-stream");
+    QNetworkReplyPtr reply(manager.put(request, &sourceFile));
+    QSignalSpy spy(reply.data(), SIGNAL(uploadProgress(qint64,qint64)));
+
+    QTRY_VERIFY(server.hasPendingConnections());
+    QTcpSocket *incomingSocket = server.nextPendingConnection();
+    QByteArray received;
+    connect(incomingSocket, &QIODevice::readyRead, [&]() {
+        received += incomingSocket->readAll();
+    });
+    received += incomingSocket->readAll();
+    auto bodySize = [&]() {
+        const int headerEnd = received.indexOf("\r\n\r\n");
+        return headerEnd == -1 ? -1 : received.size() - headerEnd - 4;
+    };
+    QTRY_COMPARE_WITH_TIMEOUT(bodySize(), expected.size(), 10000);
+
+    QVERIFY(received.startsWith("PUT / HTTP/1.1\r\n"));
+    QVERIFY(received.contains("\r\nContent-Length: " + QByteArray::number(expected.size()) + "\r\n"));
+    QVERIFY(received.endsWith(expected));
+    QTRY_VERIFY(!spy.isEmpty() && spy.last().at(0).toLongLong() == expected.size());
+    QCOMPARE(spy.last().at(1).toLongLong(), qint64(expected.size()));
+
+    incomingSocket->write("HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n");
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    // the file itself was not read
+    QCOMPARE(sourceFile.pos(), qint64(1000));
+}
+
 void tst_QNetworkReply::emitAllUploadProgressSignals()
 {
     QFile sourceFile(testDataDir + "/image1.jpg");
@@ -46,6 +46,8 @@
 #include <QTcpSocket>
 #include <private/qthread_p.h>
 #include <QTcpServer>
+#include <QUdpSocket>
+#include <QtEndian>
 
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/qnetworkconfigmanager.h>
@@ -81,6 +83,7 @@ class tst_QHostInfo : public QObject
 
 private slots:
     void init();
+    void cleanup();
     void initTestCase();
     void swapFunction();
     void moveOperator();
@@ -112,6 +115,13 @@ private slots:
     void cache();
 
     void abortHostLookup();
+
+    void dnsResolver();
+    void dnsResolverCache();
+    void dnsResolverSameLookups();
+    void dnsResolverTruncated();
+    void dnsResolverTruncatedOverTcp();
+    void dnsResolverSourcePorts();
 protected slots:
     void resultsReady(const QHostInfo &);
 
@@ -234,6 +244,12 @@ void tst_QHostInfo::init()
     qt_qhostinfo_enable_cache(cache);
 }
 
+void tst_QHostInfo::cleanup()
+{
+    QHostInfo::setResolverMode(QHostInfo::SystemResolver);
+    QHostInfo::setNameserver(QHostAddress());
+}
+
 void tst_QHostInfo::lookupIPv4_data()
 {
     QTest::addColumn<QString>("hostname");
@@ -753,5 +769,363 @@ public:
     int id;
 };
 
+// A name server answering A and AAAA queries from a table, over UDP and TCP
+class DnsServer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Host
+    {
+        QList<QHostAddress> addresses;
+        quint32 ttl = 300;
+        // Answer over UDP with the TC bit set
+        bool truncate = false;
+        // Set the TC bit over TCP as well
+        bool truncateOverTcp = false;
+    };
+
+    bool listen();
+    quint16 port() const { return udpSocket.localPort(); }
+
+    // Names not in the table do not exist
+    QHash<QByteArray, Host> hosts;
+    quint32 negativeTtl = 300;
+    int udpQueries = 0;
+    int tcpQueries = 0;
+    QList<quint16> senderPorts;
+
+private slots:
+    void readDatagrams();
+    void newConnection();
+
+private:
+    QByteArray reply(const QByteArray &query, bool overTcp) const;
+
+    QUdpSocket udpSocket;
+    QTcpServer tcpServer;
+};
+
+bool DnsServer::listen()
+{
+    for (int i = 0; i < 10; ++i) {
+        if (!udpSocket.bind(QHostAddress(QHostAddress::LocalHost)))
+            return false;
+        if (tcpServer.listen(QHostAddress(QHostAddress::LocalHost), udpSocket.localPort())) {
+            connect(&udpSocket, &QUdpSocket::readyRead, this, &DnsServer::readDatagrams);
+            connect(&tcpServer, &QTcpServer::newConnection, this, &DnsServer::newConnection);
+            return true;
+        }
+        udpSocket.close();
+    }
+    return false;
+}
+
+void DnsServer::readDatagrams()
+{
+    while (udpSocket.hasPendingDatagrams()) {
+        QHostAddress sender;
+        quint16 senderPort;
+        QByteArray query(int(udpSocket.pendingDatagramSize()), Qt::Uninitialized);
+        query.resize(int(udpSocket.readDatagram(query.data(), query.size(), &sender, &senderPort)));
+        ++udpQueries;
+        senderPorts.append(senderPort);
+        const QByteArray response = reply(query, false);
+        if (!response.isEmpty())
+            udpSocket.writeDatagram(response, sender, senderPort);
+    }
+}
+
+void DnsServer::newConnection()
+{
+    while (QTcpSocket *socket = tcpServer.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+            while (socket->bytesAvailable() >= 2) {
+                quint16 length;
+                socket->peek(reinterpret_cast<char *>(&length), 2);
+                length = qFromBigEndian(length);
+                if (socket->bytesAvailable() < 2 + length)
+                    return;
+                socket->read(2);
+                ++tcpQueries;
+                const QByteArray response = reply(socket->read(length), true);
+                const quint16 responseLength = qToBigEndian(quint16(response.size()));
+                socket->write(reinterpret_cast<const char *>(&responseLength), 2);
+                socket->write(response);
+            }
+        });
+    }
+}
+
+QByteArray DnsServer::reply(const QByteArray &query, bool overTcp) const
+{
+    auto appendUInt16 = [](QByteArray &data, quint16 value) {
+        value = qToBigEndian(value);
+        data.append(reinterpret_cast<const char *>(&value), 2);
+    };
+    auto appendUInt32 = [](QByteArray &data, quint32 value) {
+        value = qToBigEndian(value);
+        data.append(reinterpret_cast<const char *>(&value), 4);
+    };
+
+    // Read the question
+    int offset = 12;
+    QByteArray name;
+    while (offset < query.size() && query.at(offset)) {
+        const int length = quint8(query.at(offset));
+        if (!name.isEmpty())
+            name += '.';
+        name += query.mid(offset + 1, length).toLower();
+        offset += length + 1;
+    }
+    offset += 5;
+    if (offset > query.size())
+        return QByteArray();
+    const quint16 type = qFromBigEndian<quint16>(query.constData() + offset - 4);
+
+    QByteArray records;
+    quint16 flags = 0x8180; // response, recursion desired and available
+    quint16 answerCount = 0;
+    quint16 authorityCount = 0;
+    const auto host = hosts.constFind(name);
+    if (host != hosts.cend() && host->truncate && (!overTcp || host->truncateOverTcp)) {
+        flags |= 0x0200;
+    } else if (host != hosts.cend()) {
+        for (const QHostAddress &address : host->addresses) {
+            const bool ipv4 = address.protocol() == QAbstractSocket::IPv4Protocol;
+            if (type != (ipv4 ? 1 : 28))
+                continue;
+            appendUInt16(records, 0xc00c); // pointer to the question's name
+            appendUInt16(records, type);
+            appendUInt16(records, 1);
+            appendUInt32(records, host->ttl);
+            if (ipv4) {
+                appendUInt16(records, 4);
+                appendUInt32(records, address.toIPv4Address());
+            } else {
+                appendUInt16(records, 16);
+                const Q_IPV6ADDR ipv6 = address.toIPv6Address();
+                records.append(reinterpret_cast<const char *>(ipv6.c), 16);
+            }
+            ++answerCount;
+        }
+    } else {
+        flags |= 3; // NXDOMAIN
+    }
+
+    if (!answerCount && !(flags & 0x0200)) {
+        appendUInt16(records, 0xc00c);
+        appendUInt16(records, 6); // SOA
+        appendUInt16(records, 1);
+        appendUInt32(records, negativeTtl);
+        appendUInt16(records, 2 + 5 * 4);
+        records.append(2, '\0'); // MNAME and RNAME
+        for (int i = 0; i < 4; ++i)
+            appendUInt32(records, 3600);
+        appendUInt32(records, negativeTtl); // MINIMUM
+        authorityCount = 1;
+    }
+
+    QByteArray response = query.left(2);
+    appendUInt16(response, flags);
+    appendUInt16(response, 1);
+    appendUInt16(response, answerCount);
+    appendUInt16(response, authorityCount);
+    appendUInt16(response, 0);
+    return response + query.mid(12, offset - 12) + records;
+}
+
+void tst_QHostInfo::dnsResolver()
+{
+    DnsServer server;
+    QVERIFY(server.listen());
+    server.hosts.insert("host.example.com", {{QHostAddress("2001:db8::1"), QHostAddress("192.0.2.1")}});
+
+    QHostInfo::setResolverMode(QHostInfo::DnsResolver);
+    QHostInfo::setNameserver(QHostAddress(QHostAddress::LocalHost), server.port());
+    QCOMPARE(QHostInfo::resolverMode(), QHostInfo::DnsResolver);
+    QCOMPARE(QHostInfo::nameserver(), QHostAddress(QHostAddress::LocalHost));
+    QCOMPARE(QHostInfo::nameserverPort(), server.port());
+
+    lookupDone = false;
+    QHostInfo::lookupHost("Host.Example.com", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(lookupResults.hostName(), QString("Host.Example.com"));
+    // IPv4 addresses first, as the system resolver does
+    QCOMPARE(lookupResults.addresses(),
+             QList<QHostAddress>() << QHostAddress("192.0.2.1") << QHostAddress("2001:db8::1"));
+    QCOMPARE(server.udpQueries, 2);
+
+    lookupDone = false;
+    QHostInfo::lookupHost("invalid.example.com", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::HostNotFound);
+    QVERIFY(lookupResults.addresses().isEmpty());
+    QCOMPARE(server.udpQueries, 4);
+
+    // IP addresses are not sent to the name server
+    lookupDone = false;
+    QHostInfo::lookupHost("192.0.2.7", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.addresses(), QList<QHostAddress>() << QHostAddress("192.0.2.7"));
+    QCOMPARE(server.udpQueries, 4);
+}
+
+void tst_QHostInfo::dnsResolverCache()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    DnsServer server;
+    QVERIFY(server.listen());
+    server.hosts.insert("host.example.com", {{QHostAddress("192.0.2.1")}, 1});
+    server.negativeTtl = 1;
+
+    QHostInfo::setResolverMode(QHostInfo::DnsResolver);
+    QHostInfo::setNameserver(QHostAddress(QHostAddress::LocalHost), server.port());
+
+    const QStringList names = {"host.example.com", "invalid.example.com"};
+    for (const QString &name : names) {
+        const int queries = server.udpQueries;
+
+        // lookup twice, the second answer comes from the cache
+        for (int i = 0; i < 2; ++i) {
+            lookupDone = false;
+            QHostInfo::lookupHost(name, this, SLOT(resultsReady(QHostInfo)));
+            QTestEventLoop::instance().enterLoop(10);
+            QVERIFY(!QTestEventLoop::instance().timeout());
+            QVERIFY(lookupDone);
+            QCOMPARE(server.udpQueries, queries + 2);
+        }
+        QCOMPARE(lookupResults.error(),
+                 name == names.first() ? QHostInfo::NoError : QHostInfo::HostNotFound);
+
+        // the records expire after their time to live
+        QTest::qWait(1100);
+        lookupDone = false;
+        QHostInfo::lookupHost(name, this, SLOT(resultsReady(QHostInfo)));
+        QTestEventLoop::instance().enterLoop(10);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        QVERIFY(lookupDone);
+        QCOMPARE(server.udpQueries, queries + 4);
+    }
+}
+
+void tst_QHostInfo::dnsResolverSameLookups()
+{
+    DnsServer server;
+    QVERIFY(server.listen());
+    server.hosts.insert("host.example.com", {{QHostAddress("192.0.2.1")}});
+
+    QHostInfo::setResolverMode(QHostInfo::DnsResolver);
+    QHostInfo::setNameserver(QHostAddress(QHostAddress::LocalHost), server.port());
+
+    // concurrent lookups of a name share the queries
+    const int COUNT = 10;
+    lookupsDoneCounter = 0;
+    for (int i = 0; i < COUNT; i++)
+        QHostInfo::lookupHost("host.example.com", this, SLOT(resultsReady(QHostInfo)));
+
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 10000 && lookupsDoneCounter < COUNT)
+        QTestEventLoop::instance().enterLoop(2);
+    QCOMPARE(lookupsDoneCounter, COUNT);
+    QCOMPARE(lookupResults.addresses(), QList<QHostAddress>() << QHostAddress("192.0.2.1"));
+    QCOMPARE(server.udpQueries, 2);
+}
+
+void tst_QHostInfo::dnsResolverTruncated()
+{
+    DnsServer server;
+    QVERIFY(server.listen());
+    DnsServer::Host host;
+    for (int i = 1; i <= 40; ++i)
+        host.addresses << QHostAddress(QString("192.0.2.%1").arg(i));
+    host.truncate = true;
+    server.hosts.insert("host.example.com", host);
+
+    QHostInfo::setResolverMode(QHostInfo::DnsResolver);
+    QHostInfo::setNameserver(QHostAddress(QHostAddress::LocalHost), server.port());
+
+    lookupDone = false;
+    QHostInfo::lookupHost("host.example.com", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(lookupResults.addresses(), host.addresses);
+    // the truncated answers are retried over TCP
+    QCOMPARE(server.udpQueries, 2);
+    QCOMPARE(server.tcpQueries, 2);
+}
+
+void tst_QHostInfo::dnsResolverTruncatedOverTcp()
+{
+    DnsServer server;
+    QVERIFY(server.listen());
+    DnsServer::Host host;
+    host.addresses << QHostAddress("192.0.2.1");
+    host.truncate = true;
+    host.truncateOverTcp = true;
+    server.hosts.insert("host.example.com", host);
+
+    QHostInfo::setResolverMode(QHostInfo::DnsResolver);
+    QHostInfo::setNameserver(QHostAddress(QHostAddress::LocalHost), server.port());
+
+    // an answer that is still truncated is a server failure, not a
+    // name without addresses, and is not cached
+    for (int i = 0; i < 2; ++i) {
+        // let the previous lookup retire, so that this one is not merged into it
+        QTest::qWait(100);
+        const int queries = server.tcpQueries;
+        lookupDone = false;
+        QHostInfo::lookupHost("host.example.com", this, SLOT(resultsReady(QHostInfo)));
+        QTestEventLoop::instance().enterLoop(10);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        QVERIFY(lookupDone);
+        QCOMPARE(lookupResults.error(), QHostInfo::UnknownError);
+        QVERIFY(lookupResults.addresses().isEmpty());
+        // every attempt was retried over TCP
+        QVERIFY(server.tcpQueries > queries + 2);
+        QCOMPARE(server.tcpQueries, server.udpQueries);
+    }
+}
+
+void tst_QHostInfo::dnsResolverSourcePorts()
+{
+    DnsServer server;
+    QVERIFY(server.listen());
+    const int COUNT = 5;
+    for (int i = 0; i < COUNT; ++i)
+        server.hosts.insert("host" + QByteArray::number(i) + ".example.com", {{QHostAddress("192.0.2.1")}});
+
+    QHostInfo::setResolverMode(QHostInfo::DnsResolver);
+    QHostInfo::setNameserver(QHostAddress(QHostAddress::LocalHost), server.port());
+
+    // RFC 5452: the queries do not share a source port
+    for (int i = 0; i < COUNT; ++i) {
+        lookupDone = false;
+        QHostInfo::lookupHost(QString("host%1.example.com").arg(i), this, SLOT(resultsReady(QHostInfo)));
+        QTestEventLoop::instance().enterLoop(10);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        QVERIFY(lookupDone);
+        QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    }
+    QCOMPARE(server.senderPorts.size(), 2 * COUNT);
+    for (int i = 0; i < server.senderPorts.size(); i += 2)
+        QVERIFY(server.senderPorts.at(i) != server.senderPorts.at(i + 1));
+    const QSet<quint16> ports(server.senderPorts.cbegin(), server.senderPorts.cend());
+    QVERIFY2(ports.size() > COUNT, QByteArray::number(ports.size()));
+}
+
 QTEST_MAIN(tst_QHostInfo)
 #include "tst_qhostinfo.moc"
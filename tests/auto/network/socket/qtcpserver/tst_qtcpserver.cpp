@@ -117,6 +117,9 @@ private slots:
 
     void canAccessPendingConnectionsWhileNotListening();
 
+    void socketOptions();
+    void reusePort();
+
 private:
     bool shouldSkipIpv6TestsForBrokenGetsockopt();
 #ifdef SHOULD_CHECK_SYSCALL_SUPPORT
@@ -1063,5 +1066,77 @@ void tst_QTcpServer::canAccessPendingConnectionsWhileNotListening()
     QCOMPARE(&socket, server.nextPendingConnection());
 }
 
+void tst_QTcpServer::socketOptions()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTcpServer server;
+    QVERIFY(!server.socketOption(QAbstractSocket::LowDelayOption).isValid());
+
+    // Options set before listen() are kept and applied to the listening socket
+    server.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    QCOMPARE(server.socketOption(QAbstractSocket::LowDelayOption).toInt(), 1);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QCOMPARE(server.socketOption(QAbstractSocket::LowDelayOption).toInt(), 1);
+
+    server.setSocketOption(QAbstractSocket::LowDelayOption, 0);
+    QCOMPARE(server.socketOption(QAbstractSocket::LowDelayOption).toInt(), 0);
+
+    server.close();
+    QCOMPARE(server.socketOption(QAbstractSocket::LowDelayOption).toInt(), 0);
+}
+
+void tst_QTcpServer::reusePort()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTcpServer first;
+    first.setSocketOption(QAbstractSocket::ReusePortSocketOption, 1);
+    QVERIFY(first.listen(QHostAddress::LocalHost));
+    if (first.socketOption(QAbstractSocket::ReusePortSocketOption).toInt() != 1)
+        QSKIP("SO_REUSEPORT is not supported on this platform");
+
+    // Without the option, the port cannot be shared
+    QTcpServer other;
+    QVERIFY(!other.listen(QHostAddress::LocalHost, first.serverPort()));
+    QCOMPARE(other.serverError(), QAbstractSocket::AddressInUseError);
+
+    QTcpServer second;
+    second.setSocketOption(QAbstractSocket::ReusePortSocketOption, 1);
+    QVERIFY2(second.listen(QHostAddress::LocalHost, first.serverPort()),
+             qPrintable(second.errorString()));
+    QCOMPARE(second.serverPort(), first.serverPort());
+
+    // The connections are distributed between both servers
+    const int count = 32;
+    int accepted = 0;
+    QHash<QTcpServer *, int> acceptedBy;
+    for (QTcpServer *server : { &first, &second }) {
+        server->setMaxPendingConnections(count);
+        connect(server, &QTcpServer::newConnection, server, [server, &accepted, &acceptedBy] {
+            while (QTcpSocket *socket = server->nextPendingConnection()) {
+                ++accepted;
+                ++acceptedBy[server];
+                socket->deleteLater();
+            }
+        });
+    }
+
+    QList<QTcpSocket *> clients;
+    for (int i = 0; i < count; ++i) {
+        QTcpSocket *client = new QTcpSocket(this);
+        client->connectToHost(QHostAddress::LocalHost, first.serverPort());
+        clients << client;
+    }
+    QTRY_COMPARE(accepted, count);
+    QVERIFY(acceptedBy.value(&first) > 0);
+    QVERIFY(acceptedBy.value(&second) > 0);
+    qDeleteAll(clients);
+}
+
 QTEST_MAIN(tst_QTcpServer)
 #include "tst_qtcpserver.moc"
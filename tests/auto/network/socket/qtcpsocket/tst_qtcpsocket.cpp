@@ -61,6 +61,7 @@
 #include <QStringList>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTemporaryFile>
 #ifndef QT_NO_SSL
 #include <QSslSocket>
 #endif
@@ -203,6 +204,12 @@ private slots:
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
     void readNotificationsAfterBind();
+    void sendFile();
+    void sendFileInvalidArguments();
+    void sendFileTruncated();
+    void writeVector_data();
+    void writeVector();
+    void writeVectorOverriddenWriteData();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3239,5 +3246,220 @@ void tst_QTcpSocket::readNotificationsAfterBind()
     QCOMPARE(spyReadyRead.count(), 0);
 }
 
+// Test that file data queued with sendFile() goes out in order with the
+// data written around it
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QByteArray content(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < content.size(); ++i)
+        content[i] = char(QRandomGenerator::global()->bounded(256));
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(content), qint64(content.size()));
+    QVERIFY(file.flush());
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(server.serverAddress(), server.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *newConnection = server.nextPendingConnection();
+    QVERIFY(newConnection);
+
+    QByteArray received;
+    connect(newConnection, &QIODevice::readyRead, [&]() {
+        received += newConnection->readAll();
+    });
+    qint64 bytesWritten = 0;
+    connect(socket, &QIODevice::bytesWritten, [&](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    const QByteArray expected = "head" + content.mid(10, 500000) + "middle" + content + "tail";
+    QCOMPARE(socket->write("head"), Q_INT64_C(4));
+    QCOMPARE(socket->sendFile(&file, 10, 500000), Q_INT64_C(500000));
+    QCOMPARE(socket->write("middle"), Q_INT64_C(6));
+    QCOMPARE(socket->sendFile(&file), qint64(content.size()));
+    QCOMPARE(socket->write("tail"), Q_INT64_C(4));
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 10000);
+    QVERIFY(received == expected);
+    QCOMPARE(bytesWritten, qint64(expected.size()));
+    QCOMPARE(socket->bytesToWrite(), Q_INT64_C(0));
+
+    delete newConnection;
+    delete socket;
+}
+
+void tst_QTcpSocket::writeVector_data()
+{
+    QTest::addColumn<bool>("unbuffered");
+
+    QTest::newRow("buffered") << false;
+    QTest::newRow("unbuffered") << true;
+}
+
+// Test that buffers written with write(QByteArrayList) go out in order,
+// also when the send buffer fills up in the middle of one
+void tst_QTcpSocket::writeVector()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(bool, unbuffered);
+
+    QByteArray big(4 * 1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < big.size(); ++i)
+        big[i] = char(QRandomGenerator::global()->bounded(256));
+    const QByteArray content = big;
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(server.serverAddress(), server.serverPort(),
+                          unbuffered ? QIODevice::ReadWrite | QIODevice::Unbuffered
+                                     : QIODevice::ReadWrite);
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *newConnection = server.nextPendingConnection();
+    QVERIFY(newConnection);
+
+    QByteArray received;
+    connect(newConnection, &QIODevice::readyRead, [&]() {
+        received += newConnection->readAll();
+    });
+
+    const QByteArray expected = "head" + QByteArray("header:") + content + "\r\n" + "tail";
+    QCOMPARE(socket->write("head"), Q_INT64_C(4));
+    const QByteArrayList buffers = { "header:", QByteArray(), big, "\r\n" };
+    QCOMPARE(socket->write(buffers), qint64(expected.size() - 8));
+    // The socket must not see changes made after the write
+    big.fill('x');
+    QCOMPARE(socket->write("tail"), Q_INT64_C(4));
+
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 10000);
+    QVERIFY(received == expected);
+    QTRY_COMPARE(socket->bytesToWrite(), Q_INT64_C(0));
+
+    // An empty list writes nothing
+    QCOMPARE(socket->write(QByteArrayList()), Q_INT64_C(0));
+
+    delete newConnection;
+    delete socket;
+
+    // Not connected
+    socket = newSocket();
+    QCOMPARE(socket->write(buffers), Q_INT64_C(-1));
+    delete socket;
+}
+
+class WriteDataSocket : public QTcpSocket
+{
+public:
+    QByteArray seen;
+
+protected:
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        seen.append(data, int(len));
+        return QTcpSocket::writeData(data, len);
+    }
+};
+
+// Test that write(QByteArrayList) goes through a reimplemented writeData()
+void tst_QTcpSocket::writeVectorOverriddenWriteData()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    WriteDataSocket socket;
+    socket.connectToHost(server.serverAddress(), server.serverPort(),
+                         QIODevice::ReadWrite | QIODevice::Unbuffered);
+    QVERIFY(socket.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *newConnection = server.nextPendingConnection();
+    QVERIFY(newConnection);
+
+    QByteArray received;
+    connect(newConnection, &QIODevice::readyRead, [&]() {
+        received += newConnection->readAll();
+    });
+
+    const QByteArrayList buffers = { "header:", QByteArray(), "body", "\r\n" };
+    QCOMPARE(socket.write(buffers), Q_INT64_C(13));
+    QCOMPARE(socket.seen, QByteArray("header:body\r\n"));
+    QTRY_COMPARE(received, QByteArray("header:body\r\n"));
+
+    delete newConnection;
+}
+
+void tst_QTcpSocket::sendFileInvalidArguments()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write("0123456789"), Q_INT64_C(10));
+    QVERIFY(file.flush());
+
+    QTcpSocket *socket = newSocket();
+    // Not connected
+    QCOMPARE(socket->sendFile(&file), Q_INT64_C(-1));
+
+    QTest::ignoreMessage(QtWarningMsg, "QTcpSocket::sendFile: file must be open for reading and not sequential");
+    QCOMPARE(socket->sendFile(nullptr), Q_INT64_C(-1));
+    QTest::ignoreMessage(QtWarningMsg, "QTcpSocket::sendFile: offset and size must lie within the file");
+    QCOMPARE(socket->sendFile(&file, 5, 6), Q_INT64_C(-1));
+    QTest::ignoreMessage(QtWarningMsg, "QTcpSocket::sendFile: offset and size must lie within the file");
+    QCOMPARE(socket->sendFile(&file, 11), Q_INT64_C(-1));
+    QCOMPARE(socket->sendFile(&file, 10), Q_INT64_C(0));
+
+    delete socket;
+}
+
+// Test that a file truncated while it is being sent fails the socket
+// instead of leaving it waiting for data that never comes
+void tst_QTcpSocket::sendFileTruncated()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(QByteArray(1024 * 1024, 'a')), Q_INT64_C(1024 * 1024));
+    QVERIFY(file.flush());
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(server.serverAddress(), server.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *newConnection = server.nextPendingConnection();
+    QVERIFY(newConnection);
+    connect(newConnection, &QIODevice::readyRead, [&]() { newConnection->readAll(); });
+
+    QSignalSpy errorSpy(socket, &QAbstractSocket::errorOccurred);
+    QCOMPARE(socket->sendFile(&file), Q_INT64_C(1024 * 1024));
+    QVERIFY(file.resize(1000));
+    QTRY_COMPARE_WITH_TIMEOUT(errorSpy.count(), 1, 10000);
+    QCOMPARE(socket->state(), QAbstractSocket::UnconnectedState);
+
+    delete newConnection;
+    delete socket;
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
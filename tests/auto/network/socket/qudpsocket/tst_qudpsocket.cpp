@@ -119,6 +119,9 @@ private slots:
     void readyReadForEmptyDatagram();
     void asyncReadDatagram();
     void writeInHostLookupState();
+    void batchedDatagrams();
+    void segmentedDatagrams();
+    void receiveOffload();
 
 protected slots:
     void empty_readyReadSlot();
@@ -1944,5 +1947,141 @@ void tst_QUdpSocket::writeInHostLookupState()
     QVERIFY(!socket.putChar('0'));
 }
 
+void tst_QUdpSocket::batchedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket sender, receiver;
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    QVERIFY(receiver.receiveDatagrams(16).isEmpty());
+
+    // Datagrams of different sizes, including an empty one
+    QVector<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 100; ++i) {
+        datagrams << QNetworkDatagram(QByteArray(i * 7 % 300, char('a' + i % 26)),
+                                      receiver.localAddress(), receiver.localPort());
+    }
+    QSignalSpy bytesWrittenSpy(&sender, &QUdpSocket::bytesWritten);
+    QCOMPARE(sender.writeDatagrams(datagrams), datagrams.size());
+    qint64 totalBytes = 0;
+    for (const QVariantList &args : qAsConst(bytesWrittenSpy))
+        totalBytes += args.at(0).toLongLong();
+    qint64 expectedBytes = 0;
+    for (const QNetworkDatagram &datagram : qAsConst(datagrams))
+        expectedBytes += datagram.data().size();
+    QCOMPARE(totalBytes, expectedBytes);
+
+    QVector<QNetworkDatagram> received;
+    QDeadlineTimer deadline(5000);
+    while (received.size() < datagrams.size() && !deadline.hasExpired()) {
+        if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(100))
+            continue;
+        const QVector<QNetworkDatagram> batch = receiver.receiveDatagrams(32);
+        QVERIFY(batch.size() <= 32);
+        received += batch;
+    }
+    QCOMPARE(received.size(), datagrams.size());
+    for (int i = 0; i < datagrams.size(); ++i) {
+        QCOMPARE(received.at(i).data(), datagrams.at(i).data());
+        QCOMPARE(received.at(i).senderAddress(), sender.localAddress());
+        QCOMPARE(received.at(i).senderPort(), int(sender.localPort()));
+        QCOMPARE(received.at(i).destinationPort(), int(receiver.localPort()));
+    }
+
+    // Truncation to maxSize
+    QCOMPARE(sender.writeDatagrams({ QNetworkDatagram(QByteArray(100, 'x'), receiver.localAddress(),
+                                                      receiver.localPort()) }), 1);
+    QVERIFY(receiver.waitForReadyRead(5000));
+    received = receiver.receiveDatagrams(8, 10);
+    QCOMPARE(received.size(), 1);
+    QCOMPARE(received.at(0).data(), QByteArray(10, 'x'));
+}
+
+void tst_QUdpSocket::segmentedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    // Runs of equally sized datagrams to the same destination may be sent
+    // as one segmented message; they must arrive as separate datagrams
+    QUdpSocket sender, receiver, otherReceiver;
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    QVERIFY(otherReceiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1024 * 1024);
+
+    QVector<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 80; ++i) {
+        QByteArray data(i == 49 ? 500 : 1000, Qt::Uninitialized);
+        data.fill(char(i));
+        QUdpSocket &target = (i >= 60 && i % 2) ? otherReceiver : receiver;
+        datagrams << QNetworkDatagram(data, target.localAddress(), target.localPort());
+    }
+    QCOMPARE(sender.writeDatagrams(datagrams), datagrams.size());
+
+    QVector<QNetworkDatagram> expected, otherExpected;
+    for (const QNetworkDatagram &datagram : qAsConst(datagrams))
+        (datagram.destinationPort() == receiver.localPort() ? expected : otherExpected) << datagram;
+
+    for (auto pair : { qMakePair(&receiver, &expected), qMakePair(&otherReceiver, &otherExpected) }) {
+        QVector<QNetworkDatagram> received;
+        QDeadlineTimer deadline(5000);
+        while (received.size() < pair.second->size() && !deadline.hasExpired()) {
+            if (!pair.first->hasPendingDatagrams() && !pair.first->waitForReadyRead(100))
+                continue;
+            received += pair.first->receiveDatagrams(64);
+        }
+        QCOMPARE(received.size(), pair.second->size());
+        for (int i = 0; i < received.size(); ++i)
+            QCOMPARE(received.at(i).data(), pair.second->at(i).data());
+    }
+}
+
+void tst_QUdpSocket::receiveOffload()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket sender, receiver;
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveOffloadSocketOption, 1);
+    if (receiver.socketOption(QAbstractSocket::ReceiveOffloadSocketOption).toInt() != 1)
+        QSKIP("Receive offload is not supported on this platform");
+
+    QVector<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 40; ++i) {
+        datagrams << QNetworkDatagram(QByteArray(i == 39 ? 300 : 1200, char('A' + i % 26)),
+                                      receiver.localAddress(), receiver.localPort());
+    }
+    QCOMPARE(sender.writeDatagrams(datagrams), datagrams.size());
+    QVERIFY(receiver.waitForReadyRead(5000));
+
+    // Coalesced datagrams are split again, whichever API reads them
+    QVERIFY(receiver.hasPendingDatagrams());
+    QCOMPARE(receiver.pendingDatagramSize(), qint64(1200));
+    QNetworkDatagram first = receiver.receiveDatagram();
+    QCOMPARE(first.data(), datagrams.at(0).data());
+    QCOMPARE(first.senderPort(), int(sender.localPort()));
+
+    char buffer[2000];
+    QCOMPARE(receiver.readDatagram(buffer, sizeof buffer), qint64(1200));
+    QCOMPARE(QByteArray(buffer, 1200), datagrams.at(1).data());
+
+    QVector<QNetworkDatagram> received;
+    QDeadlineTimer deadline(5000);
+    while (received.size() < datagrams.size() - 2 && !deadline.hasExpired()) {
+        if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(100))
+            continue;
+        received += receiver.receiveDatagrams(5);
+    }
+    QCOMPARE(received.size(), datagrams.size() - 2);
+    for (int i = 0; i < received.size(); ++i)
+        QCOMPARE(received.at(i).data(), datagrams.at(i + 2).data());
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
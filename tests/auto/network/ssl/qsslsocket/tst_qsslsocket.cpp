@@ -60,6 +60,7 @@
 
 #include "private/qsslsocket_p.h"
 #include "private/qsslconfiguration_p.h"
+#include "private/qsslsessioncache_p.h"
 
 Q_DECLARE_METATYPE(QSslSocket::SslMode)
 typedef QVector<QSslError::SslError> SslErrorList;
@@ -266,6 +267,11 @@ private slots:
     void forwardReadChannelFinished();
     void signatureAlgorithm_data();
     void signatureAlgorithm();
+#ifdef QT_BUILD_INTERNAL
+    void sessionSharingDigest();
+    void sessionSharingOptOut_data();
+    void sessionSharingOptOut();
+#endif
 #endif
 
     void disabledProtocols_data();
@@ -4297,6 +4303,101 @@ void tst_QSslSocket::forwardReadChannelFinished()
     QVERIFY(readChannelFinishedSpy.count());
 }
 
+#ifdef QT_BUILD_INTERNAL
+static QByteArray sessionSharingDigest(const QSslConfiguration &configuration)
+{
+    const auto context = QSslContext::sharedFromConfiguration(QSslSocket::SslClientMode,
+                                                              configuration, false);
+    return context ? context->sessionCacheDigest() : QByteArray();
+}
+
+void tst_QSslSocket::sessionSharingDigest()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("Needs SSL");
+
+    const QSslConfiguration base = QSslConfiguration::defaultConfiguration();
+    const QByteArray digest = ::sessionSharingDigest(base);
+    QVERIFY(!digest.isEmpty());
+    QCOMPARE(::sessionSharingDigest(base), digest);
+
+    // A session must never be resumed by a socket that would not have
+    // accepted the handshake which created it
+    QSslConfiguration otherCa = base;
+    const auto caCertificates = QSslCertificate::fromPath(testDataDir + "certs/bogus-ca.crt");
+    QVERIFY(!caCertificates.isEmpty());
+    otherCa.addCaCertificates(caCertificates);
+    QVERIFY(::sessionSharingDigest(otherCa) != digest);
+
+    QSslConfiguration otherVerifyMode = base;
+    otherVerifyMode.setPeerVerifyMode(QSslSocket::VerifyNone);
+    QVERIFY(::sessionSharingDigest(otherVerifyMode) != digest);
+
+    QSslConfiguration otherLocalCertificate = base;
+    const auto localCertificates = QSslCertificate::fromPath(testDataDir + "certs/fluke.cert");
+    QVERIFY(!localCertificates.isEmpty());
+    otherLocalCertificate.setLocalCertificate(localCertificates.first());
+    QFile file(testDataDir + "certs/fluke.key");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    otherLocalCertificate.setPrivateKey(QSslKey(file.readAll(), QSsl::Rsa, QSsl::Pem, QSsl::PrivateKey));
+    QVERIFY(::sessionSharingDigest(otherLocalCertificate) != digest);
+
+    QSslConfiguration optOut = base;
+    optOut.setSslOption(QSsl::SslOptionDisableSessionSharing, true);
+    QVERIFY(::sessionSharingDigest(optOut).isEmpty());
+}
+
+void tst_QSslSocket::sessionSharingOptOut_data()
+{
+    QTest::addColumn<bool>("disableSessionSharing");
+
+    QTest::newRow("shared") << false;
+    QTest::newRow("SslOptionDisableSessionSharing") << true;
+}
+
+void tst_QSslSocket::sessionSharingOptOut()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        QSKIP("Test not adapted for use with proxying");
+
+    QFETCH(bool, disableSessionSharing);
+
+    QSslSessionCache::instance()->clear();
+
+    SslServer server;
+    server.protocol = QSsl::TlsV1_2;
+    server.config.setSslOption(QSsl::SslOptionDisableSessionSharing, disableSessionSharing);
+    QVERIFY(server.listen());
+
+    QSslConfiguration clientConfig = QSslConfiguration::defaultConfiguration();
+    clientConfig.setProtocol(QSsl::TlsV1_2);
+    // Sessions with ignored certificate errors are only shared without verification
+    clientConfig.setPeerVerifyMode(QSslSocket::VerifyNone);
+    clientConfig.setSslOption(QSsl::SslOptionDisableSessionSharing, disableSessionSharing);
+    QSslSocket client;
+    client.setSslConfiguration(clientConfig);
+    socket = &client;
+
+    QEventLoop loop;
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+    connect(socket, &QAbstractSocket::errorOccurred, &loop, &QEventLoop::quit);
+    connect(socket, QOverload<const QList<QSslError> &>::of(&QSslSocket::sslErrors), this, &tst_QSslSocket::ignoreErrorSlot);
+    connect(socket, &QSslSocket::encrypted, &loop, &QEventLoop::quit);
+
+    client.connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+    loop.exec();
+    socket = nullptr;
+    QVERIFY(client.isEncrypted());
+
+    if (disableSessionSharing)
+        QCOMPARE(QSslSessionCache::instance()->count(), 0);
+    else
+        QVERIFY(QSslSessionCache::instance()->count() > 0);
+    QSslSessionCache::instance()->clear();
+}
+#endif // QT_BUILD_INTERNAL
+
 #endif // QT_NO_OPENSSL
 
 void tst_QSslSocket::disabledProtocols_data()
@@ -9,3 +9,5 @@ SUBDIRS=\
    qsqlthread \
    qsql \
    qsqlresult \
+   qsqlasyncconnection \
+   qsqlconnectionpool \
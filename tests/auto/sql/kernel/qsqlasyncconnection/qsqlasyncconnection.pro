@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qsqlasyncconnection
+SOURCES  += tst_qsqlasyncconnection.cpp
+
+QT = core sql testlib core-private sql-private
@@ -0,0 +1,354 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#include "../qsqldatabase/tst_databases.h"
+
+class tst_QSqlAsyncConnection : public QObject
+{
+    Q_OBJECT
+
+public:
+    void generic_data(const QString &engine = QString());
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void exec_data() { generic_data(); }
+    void exec();
+    void boundValues_data() { generic_data(); }
+    void boundValues();
+    void manyInFlight_data() { generic_data(); }
+    void manyInFlight();
+    void statementError_data() { generic_data(); }
+    void statementError();
+    void connectionError();
+    void cancelQueued_data() { generic_data(); }
+    void cancelQueued();
+    void cancelRunning_data() { generic_data(); }
+    void cancelRunning();
+    void watcher_data() { generic_data(); }
+    void watcher();
+    void blocks_data() { generic_data(); }
+    void blocks();
+
+private:
+    tst_Databases dbs;
+};
+
+void tst_QSqlAsyncConnection::generic_data(const QString &engine)
+{
+    if (dbs.fillTestTable(engine) == 0) {
+        if (engine.isEmpty())
+            QSKIP("No database drivers are available in this Qt configuration");
+        else
+            QSKIP(QString("No database drivers of type %1 are available in this Qt configuration")
+                  .arg(engine).toLocal8Bit());
+    }
+}
+
+void tst_QSqlAsyncConnection::initTestCase()
+{
+    QVERIFY(dbs.open());
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        CHECK_DATABASE(db);
+        const QString tableName = qTableName("qtest_async", __FILE__, db);
+        tst_Databases::safeDropTable(db, tableName);
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT, name VARCHAR(20))"));
+        QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (1, 'one')"));
+        QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (2, 'two')"));
+    }
+}
+
+void tst_QSqlAsyncConnection::cleanupTestCase()
+{
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        tst_Databases::safeDropTables(db, { qTableName("qtest_async", __FILE__, db),
+                                            qTableName("qtest_async_many", __FILE__, db) });
+    }
+    dbs.close();
+}
+
+void tst_QSqlAsyncConnection::exec()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_async", __FILE__, db);
+
+    QSqlAsyncConnection connection(db);
+    QFuture<QSqlAsyncResult> future = connection.exec("SELECT id, name FROM " + tableName + " ORDER BY id");
+    future.waitForFinished();
+    QVERIFY(future.isFinished());
+    QCOMPARE(future.resultCount(), 1);
+
+    const QSqlAsyncResult result = future.result();
+    QVERIFY2(result.isValid(), qPrintable(result.lastError().text()));
+    QVERIFY(!result.lastError().isValid());
+    QVERIFY(result.isSelect());
+    QCOMPARE(result.size(), 2);
+    QCOMPARE(result.record().count(), 2);
+    QCOMPARE(result.value(0, 0).toInt(), 1);
+    QCOMPARE(result.value(0, "name").toString(), QStringLiteral("one"));
+    QCOMPARE(result.value(1, 1).toString(), QStringLiteral("two"));
+    QVERIFY(!result.value(2, 0).isValid());
+    QVERIFY(!result.value(0, 2).isValid());
+
+    const QVector<QSqlRecord> records = result.records();
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records.at(1).value("id").toInt(), 2);
+}
+
+void tst_QSqlAsyncConnection::boundValues()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_async", __FILE__, db);
+
+    QSqlAsyncConnection connection(db);
+    const QSqlAsyncResult result =
+            connection.exec("SELECT name FROM " + tableName + " WHERE id = ?", { 2 }).result();
+    QVERIFY2(result.isValid(), qPrintable(result.lastError().text()));
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result.value(0, 0).toString(), QStringLiteral("two"));
+}
+
+void tst_QSqlAsyncConnection::manyInFlight()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_async_many", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+
+    // Queries are executed in order on the same connection
+    QSqlAsyncConnection connection(db);
+    QVector<QFuture<QSqlAsyncResult>> futures;
+    futures << connection.exec("CREATE TABLE " + tableName + " (id INT)");
+    for (int i = 0; i < 100; ++i)
+        futures << connection.exec("INSERT INTO " + tableName + " (id) VALUES (?)", { i });
+    futures << connection.exec("SELECT COUNT(*), SUM(id) FROM " + tableName);
+    QVERIFY(connection.pendingCount() > 0);
+
+    connection.waitForDone();
+    QCOMPARE(connection.pendingCount(), 0);
+    for (const QFuture<QSqlAsyncResult> &future : qAsConst(futures)) {
+        QVERIFY(future.isFinished());
+        QVERIFY2(future.result().isValid(), qPrintable(future.result().lastError().text()));
+    }
+    QCOMPARE(futures.at(1).result().numRowsAffected(), 1);
+    const QSqlAsyncResult result = futures.last().result();
+    QCOMPARE(result.value(0, 0).toInt(), 100);
+    QCOMPARE(result.value(0, 1).toInt(), 4950);
+}
+
+void tst_QSqlAsyncConnection::statementError()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_async", __FILE__, db);
+
+    QSqlAsyncConnection connection(db);
+    QFuture<QSqlAsyncResult> failing = connection.exec("SELECT * FROM qtest_async_does_not_exist");
+    QFuture<QSqlAsyncResult> next = connection.exec("SELECT COUNT(*) FROM " + tableName);
+
+    const QSqlAsyncResult result = failing.result();
+    QVERIFY(!result.isValid());
+    QVERIFY(result.lastError().isValid());
+    QCOMPARE(result.lastQuery(), QStringLiteral("SELECT * FROM qtest_async_does_not_exist"));
+
+    // An error does not affect the queries after it
+    QVERIFY(next.result().isValid());
+    QCOMPARE(next.result().value(0, 0).toInt(), 2);
+}
+
+void tst_QSqlAsyncConnection::connectionError()
+{
+    if (!QSqlDatabase::isDriverAvailable("QSQLITE"))
+        QSKIP("This test requires the SQLite driver");
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "asyncConnectionError");
+    db.setDatabaseName(QDir::tempPath() + "/qt_sql_async_no_such_dir/db.sqlite");
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    {
+        QSqlAsyncConnection connection(db);
+        const QSqlAsyncResult result = connection.exec("SELECT 1").result();
+        QVERIFY(!result.isValid());
+        QCOMPARE(result.lastError().type(), QSqlError::ConnectionError);
+    }
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase("asyncConnectionError");
+}
+
+static QString longRunningQuery(QSqlDatabase db)
+{
+    switch (tst_Databases::getDatabaseType(db)) {
+    case QSqlDriver::SQLite:
+        return QStringLiteral("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c "
+                              "WHERE x < 1000000000) SELECT COUNT(*) FROM c");
+    case QSqlDriver::PostgreSQL:
+        return QStringLiteral("SELECT pg_sleep(60)");
+    default:
+        return QString();
+    }
+}
+
+void tst_QSqlAsyncConnection::cancelQueued()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_async", __FILE__, db);
+
+    QSqlAsyncConnection connection(db);
+    QFuture<QSqlAsyncResult> first = connection.exec("SELECT COUNT(*) FROM " + tableName);
+    QFuture<QSqlAsyncResult> second = connection.exec("SELECT COUNT(*) FROM " + tableName);
+    second.cancel();
+    connection.waitForDone();
+    QVERIFY(first.result().isValid());
+    QVERIFY(second.isCanceled());
+    QCOMPARE(second.resultCount(), 0);
+}
+
+void tst_QSqlAsyncConnection::cancelRunning()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString query = longRunningQuery(db);
+    if (query.isEmpty())
+        QSKIP("No long running query for this database");
+    if (!db.driver()->hasFeature(QSqlDriver::CancelQuery))
+        QSKIP("The driver cannot cancel queries");
+
+    QSqlAsyncConnection connection(db);
+    QFuture<QSqlAsyncResult> running = connection.exec(query);
+    QFuture<QSqlAsyncResult> queued = connection.exec("SELECT 1");
+    // Give the worker a chance to start the query
+    QTest::qWait(200);
+
+    QElapsedTimer timer;
+    timer.start();
+    connection.cancelAll();
+    running.waitForFinished();
+    queued.waitForFinished();
+    QVERIFY(running.isCanceled());
+    QVERIFY(queued.isCanceled());
+    QVERIFY(timer.elapsed() < 10000);
+    QCOMPARE(connection.pendingCount(), 0);
+
+    // The connection is still usable
+    const QSqlAsyncResult result = connection.exec("SELECT 1").result();
+    QVERIFY2(result.isValid(), qPrintable(result.lastError().text()));
+}
+
+void tst_QSqlAsyncConnection::watcher()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_async", __FILE__, db);
+
+    QSqlAsyncConnection connection(db);
+    QFutureWatcher<QSqlAsyncResult> watcher;
+    QSignalSpy spy(&watcher, &QFutureWatcherBase::finished);
+    watcher.setFuture(connection.exec("SELECT id FROM " + tableName));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(watcher.result().size(), 2);
+}
+
+void tst_QSqlAsyncConnection::blocks()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_async", __FILE__, db);
+    const QString query = "SELECT id, name FROM " + tableName + " ORDER BY id";
+
+    QSqlAsyncConnection connection(db);
+    QCOMPARE(connection.blockSize(), 0);
+    QSqlAsyncResult result = connection.exec(query).result();
+    QVERIFY2(result.isValid(), qPrintable(result.lastError().text()));
+    QCOMPARE(result.size(), 2);
+    QVERIFY(!result.hasMoreRows());
+
+    connection.setBlockSize(1);
+    QCOMPARE(connection.blockSize(), 1);
+    result = connection.exec(query).result();
+    QVERIFY2(result.isValid(), qPrintable(result.lastError().text()));
+    QCOMPARE(result.size(), 1);
+    QVERIFY(result.hasMoreRows());
+    QCOMPARE(result.value(0, 0).toInt(), 1);
+
+    result = connection.fetchMore(result).result();
+    QVERIFY2(result.isValid(), qPrintable(result.lastError().text()));
+    QVERIFY(result.isSelect());
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result.record().count(), 2);
+    QCOMPARE(result.value(0, "name").toString(), QStringLiteral("two"));
+    QCOMPARE(result.lastQuery(), query);
+
+    // The block size was reached exactly, so the last block is empty
+    QVERIFY(result.hasMoreRows());
+    result = connection.fetchMore(result).result();
+    QVERIFY2(result.isValid(), qPrintable(result.lastError().text()));
+    QCOMPARE(result.size(), 0);
+    QVERIFY(!result.hasMoreRows());
+
+    // A complete result cannot be continued
+    QVERIFY(!connection.fetchMore(result).result().isValid());
+
+    // Executing another query closes the result set; without a block
+    // size, fetchMore() delivers all remaining rows
+    const QSqlAsyncResult first = connection.exec(query).result();
+    QVERIFY(first.hasMoreRows());
+    connection.setBlockSize(0);
+    const QSqlAsyncResult rest = connection.fetchMore(first).result();
+    QVERIFY2(rest.isValid(), qPrintable(rest.lastError().text()));
+    QCOMPARE(rest.size(), 1);
+    QVERIFY(!rest.hasMoreRows());
+
+    connection.setBlockSize(1);
+    const QSqlAsyncResult stale = connection.exec(query).result();
+    QVERIFY(stale.hasMoreRows());
+    QVERIFY(connection.exec("SELECT COUNT(*) FROM " + tableName).result().isValid());
+    result = connection.fetchMore(stale).result();
+    QVERIFY(!result.isValid());
+    QCOMPARE(result.lastError().type(), QSqlError::StatementError);
+}
+
+QTEST_MAIN(tst_QSqlAsyncConnection)
+#include "tst_qsqlasyncconnection.moc"
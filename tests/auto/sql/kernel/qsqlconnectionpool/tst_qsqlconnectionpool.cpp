@@ -0,0 +1,390 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#include "../qsqldatabase/tst_databases.h"
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    void generic_data(const QString &engine = QString());
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void reuse_data() { generic_data(); }
+    void reuse();
+    void pooledConnection_data() { generic_data(); }
+    void pooledConnection();
+    void maximumSize_data() { generic_data(); }
+    void maximumSize();
+    void threadPool_data() { generic_data(); }
+    void threadPool();
+    void idleTimeout_data() { generic_data(); }
+    void idleTimeout();
+    void healthCheck_data() { generic_data(); }
+    void healthCheck();
+    void closedConnection_data() { generic_data(); }
+    void closedConnection();
+    void surplusConnection_data() { generic_data(); }
+    void surplusConnection();
+    void openError();
+
+private:
+    tst_Databases dbs;
+};
+
+void tst_QSqlConnectionPool::generic_data(const QString &engine)
+{
+    if (dbs.fillTestTable(engine) == 0) {
+        if (engine.isEmpty())
+            QSKIP("No database drivers are available in this Qt configuration");
+        else
+            QSKIP(QString("No database drivers of type %1 are available in this Qt configuration")
+                  .arg(engine).toLocal8Bit());
+    }
+}
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    QVERIFY(dbs.open());
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        CHECK_DATABASE(db);
+        const QString tableName = qTableName("qtest_pool", __FILE__, db);
+        tst_Databases::safeDropTable(db, tableName);
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT)"));
+        QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (0)"));
+    }
+}
+
+void tst_QSqlConnectionPool::cleanupTestCase()
+{
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        tst_Databases::safeDropTable(db, qTableName("qtest_pool", __FILE__, db));
+    }
+    dbs.close();
+}
+
+void tst_QSqlConnectionPool::reuse()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(db);
+    QCOMPARE(pool.size(), 0);
+
+    QSqlDatabase first = pool.acquire();
+    QVERIFY(first.isValid());
+    QVERIFY(first.isOpen());
+    QVERIFY(first.connectionName() != db.connectionName());
+    QCOMPARE(first.driverName(), db.driverName());
+    QCOMPARE(first.databaseName(), db.databaseName());
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.activeCount(), 1);
+    QCOMPARE(pool.idleCount(), 0);
+
+    // The connection can be looked up by name while checked out
+    QVERIFY(QSqlDatabase::database(first.connectionName(), false).isOpen());
+
+    const QString name = first.connectionName();
+    pool.release(first);
+    first = QSqlDatabase();
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.activeCount(), 0);
+    QCOMPARE(pool.idleCount(), 1);
+
+    QSqlDatabase second = pool.acquire();
+    QCOMPARE(second.connectionName(), name);
+    QSqlQuery q(second);
+    QVERIFY_SQL(q, exec("SELECT id FROM " + qTableName("qtest_pool", __FILE__, db)));
+    q = QSqlQuery();
+    pool.release(second);
+    second = QSqlDatabase();
+
+    pool.clear();
+    QCOMPARE(pool.size(), 0);
+    QVERIFY(!QSqlDatabase::contains(name));
+}
+
+void tst_QSqlConnectionPool::pooledConnection()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(db);
+    {
+        QSqlPooledConnection connection(&pool);
+        QVERIFY(connection.isValid());
+        QVERIFY(connection.database().isOpen());
+        QCOMPARE(pool.activeCount(), 1);
+    }
+    QCOMPARE(pool.activeCount(), 0);
+    QCOMPARE(pool.idleCount(), 1);
+
+    QSqlPooledConnection connection(&pool);
+    connection.release();
+    QVERIFY(!connection.isValid());
+    QCOMPARE(pool.idleCount(), 1);
+}
+
+void tst_QSqlConnectionPool::maximumSize()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(db);
+    pool.setMaximumSize(2);
+    QCOMPARE(pool.maximumSize(), 2);
+
+    QSqlDatabase first = pool.acquire();
+    QSqlDatabase second = pool.acquire();
+    QVERIFY(first.isValid());
+    QVERIFY(second.isValid());
+    QVERIFY(first.connectionName() != second.connectionName());
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!pool.acquire(50).isValid());
+    QVERIFY(timer.elapsed() >= 40);
+    QCOMPARE(pool.size(), 2);
+
+    // A release from another thread wakes up a waiting acquire()
+    QSqlDatabase third;
+    QThread *thread = QThread::create([&pool, &third] { third = pool.acquire(); });
+    thread->start();
+    QTest::qWait(50);
+    QVERIFY(thread->isRunning());
+    const QString name = first.connectionName();
+    pool.release(first);
+    first = QSqlDatabase();
+    QVERIFY(thread->wait(5000));
+    delete thread;
+    QCOMPARE(third.connectionName(), name);
+    QCOMPARE(pool.size(), 2);
+
+    // The connection now belongs to the finished thread and cannot be reused
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("must be released by the thread"));
+    pool.release(third);
+    third = QSqlDatabase();
+    QCOMPARE(pool.size(), 1);
+
+    pool.release(second);
+    second = QSqlDatabase();
+    pool.setMaximumSize(1);
+    QCOMPARE(pool.size(), 1);
+}
+
+void tst_QSqlConnectionPool::threadPool()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_pool", __FILE__, db);
+
+    QSqlConnectionPool pool(db);
+    pool.setMaximumSize(3);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(6);
+    // Short-lived threads, so that connections move between threads
+    threadPool.setExpiryTimeout(1);
+
+    QMutex mutex;
+    QSet<QString> names;
+    QAtomicInt failures;
+    for (int i = 0; i < 60; ++i) {
+        threadPool.start([&] {
+            QSqlPooledConnection connection(&pool);
+            if (!connection.isValid()) {
+                failures.ref();
+                return;
+            }
+            QSqlQuery q(connection.database());
+            if (!q.exec("SELECT id FROM " + tableName) || !q.next())
+                failures.ref();
+            QMutexLocker locker(&mutex);
+            names.insert(connection.database().connectionName());
+        });
+        if (i % 10 == 0)
+            QTest::qWait(5);
+    }
+    QVERIFY(threadPool.waitForDone(30000));
+
+    QCOMPARE(failures.loadRelaxed(), 0);
+    QVERIFY(names.size() <= 3);
+    QVERIFY(pool.size() <= 3);
+    QCOMPARE(pool.activeCount(), 0);
+}
+
+void tst_QSqlConnectionPool::idleTimeout()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(db);
+    pool.setMaximumSize(3);
+    pool.setMinimumSize(1);
+    pool.setIdleTimeout(20);
+    QCOMPARE(pool.idleTimeout(), 20);
+
+    QSqlDatabase first = pool.acquire();
+    QSqlDatabase second = pool.acquire();
+    QSqlDatabase third = pool.acquire();
+    pool.release(first);
+    pool.release(second);
+    first = second = QSqlDatabase();
+    QCOMPARE(pool.size(), 3);
+    QTRY_COMPARE(pool.size(), 1);
+    QCOMPARE(pool.activeCount(), 1);
+
+    pool.release(third);
+    third = QSqlDatabase();
+    QTest::qWait(50);
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 1);
+}
+
+void tst_QSqlConnectionPool::healthCheck()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("qtest_pool", __FILE__, db);
+
+    QSqlConnectionPool pool(db);
+    pool.setHealthCheckQuery("UPDATE " + tableName + " SET id = id + 1");
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("UPDATE " + tableName + " SET id = 0"));
+
+    // The check only runs for connections that are reused
+    pool.release(pool.acquire());
+    pool.release(pool.acquire());
+    pool.release(pool.acquire());
+    QVERIFY_SQL(q, exec("SELECT id FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 2);
+
+    pool.setHealthCheckInterval(60000);
+    pool.release(pool.acquire());
+    QVERIFY_SQL(q, exec("SELECT id FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 2);
+
+    // A failing check reopens the connection
+    pool.setHealthCheckInterval(0);
+    pool.setHealthCheckQuery("SELECT * FROM qtest_pool_does_not_exist");
+    QSqlDatabase connection = pool.acquire();
+    QVERIFY(connection.isOpen());
+    pool.release(connection);
+}
+
+void tst_QSqlConnectionPool::closedConnection()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(db);
+    QSqlDatabase connection = pool.acquire();
+    const QString name = connection.connectionName();
+    connection.close();
+    pool.release(connection);
+    // The name is gone right away, while the handle stays usable
+    QVERIFY(!QSqlDatabase::contains(name));
+    QCOMPARE(connection.connectionName(), name);
+    connection = QSqlDatabase();
+    QCOMPARE(pool.size(), 0);
+
+    connection = pool.acquire();
+    QVERIFY(connection.isOpen());
+    QVERIFY(connection.connectionName() != name);
+    pool.release(connection);
+    connection = QSqlDatabase();
+}
+
+void tst_QSqlConnectionPool::surplusConnection()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    // Without an idle timeout, nothing else removes retired connections
+    QSqlConnectionPool pool(db);
+    pool.setIdleTimeout(-1);
+    pool.setMaximumSize(2);
+    QStringList names;
+    for (int i = 0; i < 3; ++i) {
+        QSqlDatabase first = pool.acquire();
+        QSqlDatabase second = pool.acquire();
+        QVERIFY(first.isValid());
+        QVERIFY(second.isValid());
+        names << first.connectionName() << second.connectionName();
+        pool.setMaximumSize(1);
+        pool.release(first);
+        pool.release(second);
+        pool.setMaximumSize(2);
+    }
+    QCOMPARE(pool.size(), 1);
+    int remaining = 0;
+    for (const QString &name : qAsConst(names))
+        remaining += QSqlDatabase::contains(name);
+    QCOMPARE(remaining, 1);
+}
+
+void tst_QSqlConnectionPool::openError()
+{
+    if (!QSqlDatabase::isDriverAvailable("QSQLITE"))
+        QSKIP("This test requires the SQLite driver");
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "poolOpenError");
+    db.setDatabaseName(QDir::tempPath() + "/qt_sql_pool_no_such_dir/db.sqlite");
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    {
+        QSqlConnectionPool pool(db);
+        QVERIFY(!pool.acquire().isValid());
+        QCOMPARE(pool.lastError().type(), QSqlError::ConnectionError);
+        QCOMPARE(pool.size(), 0);
+    }
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase("poolOpenError");
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+#include "tst_qsqlconnectionpool.moc"
@@ -154,6 +154,14 @@ private slots:
     void batchExec();
     void QTBUG_43874_data() { generic_data(); }
     void QTBUG_43874();
+    void batchExecManyRows_data() { generic_data(); }
+    void batchExecManyRows();
+    void batchExecFailure_data() { generic_data(); }
+    void batchExecFailure();
+    void sqliteBatchExecRollback_data() { generic_data("QSQLITE"); }
+    void sqliteBatchExecRollback();
+    void fetchBlock_data() { generic_data(); }
+    void fetchBlock();
     void oraArrayBind_data() { generic_data("QOCI"); }
     void oraArrayBind();
     void lastInsertId_data() { generic_data(); }
@@ -374,6 +382,10 @@ void tst_QSqlQuery::dropTestTables( QSqlDatabase db )
                << qTableName("blobstest", __FILE__, db)
                << qTableName("oraRowId", __FILE__, db)
                << qTableName("bug43874", __FILE__, db)
+               << qTableName("qtest_batch_many", __FILE__, db)
+               << qTableName("qtest_batch_fail", __FILE__, db)
+               << qTableName("qtest_batch_rollback", __FILE__, db)
+               << qTableName("qtest_fetchblock", __FILE__, db)
                << qTableName("bug6421", __FILE__, db).toUpper()
                << qTableName("bug5765", __FILE__, db)
                << qTableName("bug6852", __FILE__, db)
@@ -2608,6 +2620,211 @@ void tst_QSqlQuery::QTBUG_43874()
     QCOMPARE(q.value(0).toInt(), 1);
 }
 
+void tst_QSqlQuery::batchExecManyRows()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName = qTableName("qtest_batch_many", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT, name VARCHAR(20))"));
+
+    // Large enough to be split into several chunks by drivers that pipeline rows
+    const int rowCount = 5000;
+    QVariantList ids;
+    QVariantList names;
+    qint64 idSum = 0;
+    for (int i = 0; i < rowCount; ++i) {
+        ids << i;
+        names << (i % 7 ? QVariant(QString::number(i)) : QVariant(QVariant::String));
+        idSum += i;
+    }
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name) VALUES (?, ?)"));
+    q.addBindValue(ids);
+    q.addBindValue(names);
+    QVERIFY_SQL(q, execBatch());
+    QCOMPARE(q.numRowsAffected(), 1);
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*), SUM(id), COUNT(name) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), rowCount);
+    QCOMPARE(q.value(1).toLongLong(), idSum);
+    QCOMPARE(q.value(2).toInt(), rowCount - (rowCount + 6) / 7);
+
+    // A batch executed inside a transaction is part of it
+    QVERIFY_SQL(q, exec("DELETE FROM " + tableName));
+    if (db.driver()->hasFeature(QSqlDriver::Transactions)) {
+        QVERIFY_SQL(db, transaction());
+        QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name) VALUES (?, ?)"));
+        q.addBindValue(ids);
+        q.addBindValue(names);
+        QVERIFY_SQL(q, execBatch());
+        QVERIFY_SQL(db, rollback());
+        QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 0);
+    }
+}
+
+void tst_QSqlQuery::batchExecFailure()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName = qTableName("qtest_batch_fail", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT NOT NULL PRIMARY KEY)"));
+
+    // The rows before the failing one are kept, the failing row and the rows
+    // after it are not executed.
+    const int rowCount = 3000;
+    const int duplicateRow = 2500;
+    QVariantList ids;
+    for (int i = 0; i < rowCount; ++i)
+        ids << (i == duplicateRow ? 0 : i);
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id) VALUES (?)"));
+    q.addBindValue(ids);
+    QVERIFY(!q.execBatch());
+    QVERIFY(q.lastError().isValid());
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*), MAX(id) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), duplicateRow);
+    QCOMPARE(q.value(1).toInt(), duplicateRow - 1);
+
+    // The connection is usable afterwards and not left inside a transaction
+    QVERIFY_SQL(db, transaction());
+    QVERIFY_SQL(db, rollback());
+}
+
+void tst_QSqlQuery::sqliteBatchExecRollback()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName = qTableName("qtest_batch_rollback", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT NOT NULL PRIMARY KEY)"));
+
+    // The conflict rolls back the transaction the batch runs in; the rows
+    // before the failing one are still kept.
+    const int rowCount = 100;
+    const int duplicateRow = 60;
+    QVariantList ids;
+    for (int i = 0; i < rowCount; ++i)
+        ids << (i == duplicateRow ? 0 : i);
+
+    QVERIFY_SQL(q, prepare("INSERT OR ROLLBACK INTO " + tableName + " (id) VALUES (?)"));
+    q.addBindValue(ids);
+    QVERIFY(!q.execBatch());
+    QVERIFY(q.lastError().isValid());
+    QVERIFY2(q.lastError().databaseText().contains("UNIQUE"), qPrintable(q.lastError().text()));
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*), MAX(id) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), duplicateRow);
+    QCOMPARE(q.value(1).toInt(), duplicateRow - 1);
+
+    QVERIFY_SQL(db, transaction());
+    QVERIFY_SQL(db, rollback());
+}
+
+void tst_QSqlQuery::fetchBlock()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName = qTableName("qtest_fetchblock", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT, num REAL, name VARCHAR(20), data "
+                        + tst_Databases::blobTypeName(db, 16) + ")"));
+
+    const int rowCount = 10;
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, num, name, data) VALUES (?, ?, ?, ?)"));
+    for (int i = 0; i < rowCount; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i % 3 ? QVariant(i + 0.5) : QVariant(QVariant::Double));
+        q.addBindValue(i % 4 ? QVariant(QString::fromUtf8("n\xc3\xa4me %1").arg(i).left(i % 2 ? 20 : 5))
+                             : QVariant(QVariant::String));
+        q.addBindValue(QByteArray(i, char('a' + i)));
+        QVERIFY_SQL(q, exec());
+    }
+
+    const auto verifyRow = [](const QSqlColumnBlock &block, int row, int id) {
+        QCOMPARE(block.int64Column(0)[row], qint64(id));
+        QCOMPARE(block.isNull(row, 1), id % 3 == 0);
+        QCOMPARE(block.doubleColumn(1)[row], id % 3 ? id + 0.5 : 0.0);
+        QCOMPARE(block.isNull(row, 2), id % 4 == 0);
+        QCOMPARE(block.stringColumn(2)[row],
+                 id % 4 ? QString::fromUtf8("n\xc3\xa4me %1").arg(id).left(id % 2 ? 20 : 5) : QString());
+        QCOMPARE(block.byteArrayColumn(3)[row], QByteArray(id, char('a' + id)));
+    };
+
+    for (bool forwardOnly : {true, false}) {
+        q.setForwardOnly(forwardOnly);
+        QVERIFY_SQL(q, exec("SELECT id, num, name, data FROM " + tableName + " ORDER BY id"));
+
+        QSqlColumnBlock block(4);
+        int id = 0;
+        int blocks = 0;
+        while (q.fetchBlock(&block)) {
+            ++blocks;
+            QCOMPARE(block.columnCount(), 4);
+            QCOMPARE(block.columnType(0), QMetaType::LongLong);
+            QCOMPARE(block.columnType(1), QMetaType::Double);
+            QCOMPARE(block.columnType(2), QMetaType::QString);
+            QCOMPARE(block.columnType(3), QMetaType::QByteArray);
+            QVERIFY(!block.doubleColumn(0));
+            QVERIFY(block.rowCount() <= block.capacity());
+            for (int row = 0; row < block.rowCount(); ++row, ++id)
+                verifyRow(block, row, id);
+        }
+        QCOMPARE(id, rowCount);
+        QCOMPARE(blocks, 3);
+        QCOMPARE(block.rowCount(), 0);
+        QCOMPARE(q.at(), int(QSql::AfterLastRow));
+        QVERIFY(!q.next());
+
+        // Mixed with next(), and with a requested column type
+        QVERIFY_SQL(q, exec("SELECT id, num, name, data FROM " + tableName + " ORDER BY id"));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 0);
+        block.setColumnType(0, QMetaType::QString);
+        QVERIFY(q.fetchBlock(&block));
+        QCOMPARE(block.rowCount(), 4);
+        QCOMPARE(q.at(), 4);
+        QCOMPARE(block.columnType(0), QMetaType::QString);
+        QCOMPARE(block.stringColumn(0)[0], QStringLiteral("1"));
+        QCOMPARE(block.stringColumn(0)[3], QStringLiteral("4"));
+        QVERIFY(q.next());
+        QCOMPARE(q.at(), 5);
+        QCOMPARE(q.value(0).toInt(), 5);
+        block.setColumnType(0, QMetaType::UnknownType);
+        QVERIFY(q.fetchBlock(&block));
+        QCOMPARE(block.rowCount(), 4);
+        for (int row = 0; row < block.rowCount(); ++row)
+            verifyRow(block, row, row + 6);
+        QVERIFY(!q.fetchBlock(&block));
+        QVERIFY(!q.next());
+    }
+
+    // Not on an active select
+    QSqlColumnBlock block;
+    QVERIFY_SQL(q, exec("DELETE FROM " + tableName));
+    QVERIFY(!q.fetchBlock(&block));
+    QCOMPARE(block.rowCount(), 0);
+}
+
 void tst_QSqlQuery::oraArrayBind()
 {
     QFETCH( QString, dbName );
@@ -1,8 +1,4 @@
-QT = core testlib
-CONFIG += benchmark
-CONFIG -= app_bundle
-
-TARGET = tst_bench_qtbinaryjson
-SOURCES += tst_bench_qtbinaryjson.cpp
-
-TESTDATA = numbers.json test.json
+TEMPLATE = subdirs
+SUBDIRS = \
+        qjsonstreamreader \
+        qtbinaryjson
@@ -0,0 +1,6 @@
+QT = core testlib
+CONFIG += benchmark
+CONFIG -= app_bundle
+
+TARGET = tst_bench_qjsonstreamreader
+SOURCES += tst_bench_qjsonstreamreader.cpp
@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <qjsondocument.h>
+#include <qjsonstreamreader.h>
+
+#if defined(Q_OS_LINUX)
+#  include <fstream>
+#  include <string>
+#  if defined(__GLIBC__)
+#    include <malloc.h>
+#  endif
+#endif
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void parse_data();
+    void parse();
+    void throughput_data() { parse_data(); }
+    void throughput();
+    void peakMemory_data() { parse_data(); }
+    void peakMemory();
+
+private:
+    QTemporaryDir dir;
+    QHash<QByteArray, QString> files;
+};
+
+enum Mode {
+    FromJson,
+    StreamDevice,
+    StreamMapped
+};
+Q_DECLARE_METATYPE(Mode)
+
+static QByteArray makeRecords(int count)
+{
+    QByteArray json = "[\n";
+    for (int i = 0; i < count; ++i) {
+        if (i)
+            json += ",\n";
+        json += "{\"id\":" + QByteArray::number(i)
+              + ",\"name\":\"record number " + QByteArray::number(i)
+              + "\",\"score\":" + QByteArray::number(i * 0.25)
+              + ",\"active\":" + (i % 2 ? "true" : "false")
+              + ",\"tags\":[\"alpha\",\"beta\\tgamma\"],\"parent\":null}";
+    }
+    return json + "\n]\n";
+}
+
+static QByteArray makeIndented(int count)
+{
+    return QJsonDocument::fromJson(makeRecords(count)).toJson(QJsonDocument::Indented);
+}
+
+static QByteArray makeNumbers(int count)
+{
+    QByteArray json = "[";
+    for (int i = 0; i < count; ++i) {
+        if (i)
+            json += ',';
+        json += QByteArray::number(qint64(i) * 7919) + ',' + QByteArray::number(i / 3.0, 'g', 15);
+    }
+    return json + "]";
+}
+
+static QByteArray makeStrings(int count)
+{
+    const QByteArray text = QByteArray("Lorem ipsum dolor sit amet, consectetur adipiscing elit, ")
+            + "sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. \xc3\xa9\xe2\x82\xac";
+    QByteArray json = "[";
+    for (int i = 0; i < count; ++i) {
+        if (i)
+            json += ',';
+        json += '"' + text + '"';
+    }
+    return json + "]";
+}
+
+// Consumes every token the way an application extracting values would
+static bool streamAll(QJsonStreamReader &reader, qint64 *checksum)
+{
+    qint64 sum = 0;
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QJsonStreamReader::Name:
+            sum += reader.name().size();
+            break;
+        case QJsonStreamReader::String:
+            sum += reader.stringValue().size();
+            break;
+        case QJsonStreamReader::Number:
+            sum += reader.integerValue();
+            break;
+        default:
+            break;
+        }
+    }
+    *checksum = sum;
+    return !reader.hasError();
+}
+
+static qint64 parseFile(const QString &fileName, Mode mode)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    qint64 checksum = 0;
+    switch (mode) {
+    case FromJson: {
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+        if (error.error != QJsonParseError::NoError)
+            return -1;
+        checksum = doc.array().size();
+        break;
+    }
+    case StreamDevice: {
+        QJsonStreamReader reader(&file);
+        if (!streamAll(reader, &checksum))
+            return -1;
+        break;
+    }
+    case StreamMapped: {
+        QJsonStreamReader reader(file.mapToByteArray(0, file.size()));
+        if (!streamAll(reader, &checksum))
+            return -1;
+        break;
+    }
+    }
+    return checksum;
+}
+
+#if defined(Q_OS_LINUX)
+static qint64 procStatus(const char *field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    const size_t len = strlen(field);
+    while (std::getline(status, line)) {
+        if (line.compare(0, len, field) == 0)
+            return qint64(std::stoll(line.substr(len + 1))) * 1024;
+    }
+    return -1;
+}
+
+static bool resetPeakRss()
+{
+#if defined(__GLIBC__)
+    // Return memory freed by earlier runs, so that it isn't reused for free
+    malloc_trim(0);
+#endif
+    // Writing 5 resets VmHWM to the current RSS (Linux 4.0)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+    return clearRefs.good();
+}
+#endif
+
+void tst_QJsonStreamReader::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    const QPair<const char *, QByteArray> inputs[] = {
+        { "records", makeRecords(200000) },
+        { "indented", makeIndented(100000) },
+        { "numbers", makeNumbers(1000000) },
+        { "strings", makeStrings(150000) }
+    };
+    for (const auto &input : inputs) {
+        const QString fileName = dir.filePath(QLatin1String(input.first) + QLatin1String(".json"));
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(input.second), qint64(input.second.size()));
+        files.insert(input.first, fileName);
+    }
+}
+
+void tst_QJsonStreamReader::parse_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<Mode>("mode");
+
+    const QByteArray names[] = { "records", "indented", "numbers", "strings" };
+    for (const QByteArray &name : names) {
+        QTest::newRow(name + "-fromJson") << files.value(name) << FromJson;
+        QTest::newRow(name + "-stream-device") << files.value(name) << StreamDevice;
+        QTest::newRow(name + "-stream-mapped") << files.value(name) << StreamMapped;
+    }
+}
+
+void tst_QJsonStreamReader::parse()
+{
+    QFETCH(QString, fileName);
+    QFETCH(Mode, mode);
+
+    QBENCHMARK {
+        QVERIFY(parseFile(fileName, mode) >= 0);
+    }
+}
+
+void tst_QJsonStreamReader::throughput()
+{
+    QFETCH(QString, fileName);
+    QFETCH(Mode, mode);
+
+    const qint64 size = QFileInfo(fileName).size();
+    QVERIFY(parseFile(fileName, mode) >= 0);    // warm up the page cache
+
+    const int iterations = 5;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+        QVERIFY(parseFile(fileName, mode) >= 0);
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), qint64(1));
+
+    const qreal bytesPerSecond = qreal(size) * iterations * 1e9 / elapsed;
+    qDebug("%s: %.1f MB/s", QTest::currentDataTag(), bytesPerSecond / (1024 * 1024));
+    QTest::setBenchmarkResult(bytesPerSecond, QTest::BytesPerSecond);
+}
+
+void tst_QJsonStreamReader::peakMemory()
+{
+#if defined(Q_OS_LINUX)
+    QFETCH(QString, fileName);
+    QFETCH(Mode, mode);
+
+    if (!resetPeakRss())
+        QSKIP("Cannot reset the peak RSS of this process");
+    const qint64 before = procStatus("VmRSS:");
+    QVERIFY(before > 0);
+    QVERIFY(parseFile(fileName, mode) >= 0);
+    const qint64 peak = procStatus("VmHWM:");
+    QVERIFY(peak > 0);
+
+    const qint64 growth = qMax(peak - before, qint64(0));
+    qDebug("%s: peak RSS grew by %.1f MB for a %.1f MB document", QTest::currentDataTag(),
+           growth / (1024. * 1024), QFileInfo(fileName).size() / (1024. * 1024));
+    QTest::setBenchmarkResult(growth, QTest::BytesAllocated);
+#else
+    QSKIP("Peak RSS is only measured on Linux");
+#endif
+}
+
+QTEST_MAIN(tst_QJsonStreamReader)
+
+#include "tst_bench_qjsonstreamreader.moc"
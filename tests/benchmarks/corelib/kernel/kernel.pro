@@ -1,10 +1,12 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         events \
+        qeventdispatcher \
         qmetaobject \
         qmetatype \
         qobject \
         qvariant \
+        queuedconnection \
         qcoreapplication \
         qtimer_vs_qmetaobject
 
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/private/qeventdispatcher_unix_p.h>
+#if QT_CONFIG(epoll)
+#  include <QtCore/private/qeventdispatcher_epoll_p.h>
+#endif
+#include <QtCore/private/qcore_unix_p.h>
+
+#include <sys/resource.h>
+
+class tst_QEventDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void idleNotifiers_data();
+    void idleNotifiers();
+};
+
+void tst_QEventDispatcher::initTestCase()
+{
+    // allow for as many pipes as the hard limit permits
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+void tst_QEventDispatcher::idleNotifiers_data()
+{
+    QTest::addColumn<QByteArray>("dispatcher");
+    QTest::addColumn<int>("notifierCount");
+
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+
+    QByteArrayList dispatchers = { "unix" };
+#if QT_CONFIG(epoll)
+    dispatchers << "epoll";
+#endif
+    for (int count : { 1, 10, 100, 1000, 10000 }) {
+        // two file descriptors per pipe, plus some head room
+        if (rlim_t(2 * count + 64) > limit.rlim_cur)
+            break;
+        for (const QByteArray &dispatcher : qAsConst(dispatchers))
+            QTest::addRow("%s-%d", dispatcher.constData(), count) << dispatcher << count;
+    }
+}
+
+// The cost of one event loop iteration that handles a wake-up, while many
+// socket notifiers are registered that never become ready. This is the
+// situation of a server with many mostly idle connections.
+void tst_QEventDispatcher::idleNotifiers()
+{
+    QFETCH(QByteArray, dispatcher);
+    QFETCH(int, notifierCount);
+
+    // not installed; the notifiers are registered with it directly
+    QScopedPointer<QAbstractEventDispatcher> eventDispatcher;
+#if QT_CONFIG(epoll)
+    if (dispatcher == "epoll")
+        eventDispatcher.reset(new QEventDispatcherEpoll);
+    else
+#endif
+        eventDispatcher.reset(new QEventDispatcherUNIX);
+
+    QVector<int> fds;
+    fds.reserve(2 * notifierCount);
+    std::vector<std::unique_ptr<QSocketNotifier>> notifiers;
+    notifiers.reserve(notifierCount);
+    for (int i = 0; i < notifierCount; ++i) {
+        int pipe[2];
+        QCOMPARE(qt_safe_pipe(pipe, O_NONBLOCK), 0);
+        fds << pipe[0] << pipe[1];
+        notifiers.emplace_back(new QSocketNotifier(pipe[0], QSocketNotifier::Read));
+        notifiers.back()->setEnabled(false);
+        eventDispatcher->registerSocketNotifier(notifiers.back().get());
+    }
+
+    QBENCHMARK {
+        eventDispatcher->wakeUp();
+        eventDispatcher->processEvents(QEventLoop::AllEvents);
+    }
+
+    for (const auto &notifier : notifiers)
+        eventDispatcher->unregisterSocketNotifier(notifier.get());
+    notifiers.clear();
+    for (int fd : qAsConst(fds))
+        qt_safe_close(fd);
+}
+
+QTEST_MAIN(tst_QEventDispatcher)
+
+#include "tst_qeventdispatcher.moc"
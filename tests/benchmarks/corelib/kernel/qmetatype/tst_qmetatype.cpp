@@ -28,6 +28,10 @@
 
 #include <qtest.h>
 #include <QtCore/qmetatype.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvector.h>
 
 class tst_QMetaType : public QObject
 {
@@ -59,6 +63,9 @@ private slots:
     void isRegisteredCustom();
     void isRegisteredNotRegistered();
 
+    void lookupThreaded_data();
+    void lookupThreaded();
+
     void constructInPlace_data();
     void constructInPlace();
     void constructInPlaceCopy_data();
@@ -245,6 +252,84 @@ void tst_QMetaType::isRegisteredNotRegistered()
     }
 }
 
+struct Bar1 { int i; };
+struct Bar2 { double d; };
+struct Bar3 { QByteArray ba; };
+struct Bar4 { qint64 l[4]; };
+
+class LookupThread : public QThread
+{
+public:
+    LookupThread(const QVector<int> &types, const QAtomicInt &stop)
+        : types(types), stop(stop) {}
+
+    void run() override
+    {
+        // Mix the lookups that QVariant and queued connections do all the time
+        while (!stop.loadRelaxed()) {
+            for (int type : types) {
+                const char *name = QMetaType::typeName(type);
+                if (QMetaType::type(name) != type || QMetaType::sizeOf(type) <= 0)
+                    return;
+            }
+            lookups += 3 * types.size();
+        }
+    }
+
+    qint64 lookups = 0;
+
+private:
+    const QVector<int> types;
+    const QAtomicInt &stop;
+};
+
+void tst_QMetaType::lookupThreaded_data()
+{
+    QTest::addColumn<int>("threadCount");
+    const int maxThreads = qMax(4, QThread::idealThreadCount());
+    for (int n = 1; n <= maxThreads; n *= 2)
+        QTest::addRow("%d", n) << n;
+}
+
+void tst_QMetaType::lookupThreaded()
+{
+    QFETCH(int, threadCount);
+    const QVector<int> types = {
+        qRegisterMetaType<Foo>("Foo"),
+        qRegisterMetaType<Bar1>("Bar1"),
+        qRegisterMetaType<Bar2>("Bar2"),
+        qRegisterMetaType<Bar3>("Bar3"),
+        qRegisterMetaType<Bar4>("Bar4"),
+        QMetaType::QString,
+        QMetaType::QVariantMap,
+    };
+
+    QAtomicInt stop;
+    QVector<LookupThread *> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads << new LookupThread(types, stop);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (LookupThread *thread : qAsConst(threads))
+        thread->start();
+    QThread::msleep(500);
+    stop.storeRelaxed(1);
+
+    qint64 lookups = 0;
+    for (LookupThread *thread : qAsConst(threads)) {
+        thread->wait();
+        lookups += thread->lookups;
+    }
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), qint64(1));
+    qDeleteAll(threads);
+    QVERIFY(lookups > 0);
+
+    const qreal lookupsPerSecond = qreal(lookups) * 1e9 / elapsed;
+    qDebug("%d threads: %.2f M lookups/s", threadCount, lookupsPerSecond / 1e6);
+    QTest::setBenchmarkResult(lookupsPerSecond, QTest::Events);
+}
+
 void tst_QMetaType::constructInPlace_data()
 {
     QTest::addColumn<int>("typeId");
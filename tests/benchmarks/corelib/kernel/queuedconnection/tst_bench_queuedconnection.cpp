@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvector.h>
+#include <QtTest/QtTest>
+
+class Sender : public QObject
+{
+    Q_OBJECT
+signals:
+    void valueChanged(int value);
+    void textChanged(const QString &text);
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public:
+    void expect(int count)
+    {
+        remaining = count;
+    }
+
+    QSemaphore done;
+
+public slots:
+    void onValueChanged(int value)
+    {
+        sum += value;
+        received();
+    }
+    void onTextChanged(const QString &text)
+    {
+        sum += text.size();
+        received();
+    }
+
+private:
+    void received()
+    {
+        if (!--remaining)
+            done.release();
+    }
+
+    int remaining = 0;
+    qint64 sum = 0;
+};
+
+class Producer : public QThread
+{
+public:
+    Producer(Sender *sender, int count, bool withText)
+        : sender(sender), count(count), withText(withText) {}
+
+    void run() override
+    {
+        const QString text = QStringLiteral("queued");
+        for (int i = 0; i < count; ++i) {
+            if (withText)
+                emit sender->textChanged(text);
+            else
+                emit sender->valueChanged(i);
+        }
+    }
+
+private:
+    Sender *sender;
+    int count;
+    bool withText;
+};
+
+class tst_QueuedConnection : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void throughput_data();
+    void throughput();
+};
+
+void tst_QueuedConnection::throughput_data()
+{
+    QTest::addColumn<int>("producerCount");
+    QTest::addColumn<bool>("withText");
+
+    const int maxProducers = qMax(4, QThread::idealThreadCount());
+    for (int n = 1; n <= maxProducers; n *= 2) {
+        QTest::addRow("int, %d producers", n) << n << false;
+        QTest::addRow("QString, %d producers", n) << n << true;
+    }
+}
+
+// Several threads emit signals that are queued to a receiver running an
+// event loop in yet another thread; reports the delivered signals per second.
+void tst_QueuedConnection::throughput()
+{
+    QFETCH(int, producerCount);
+    QFETCH(bool, withText);
+    const int total = 400000;
+    const int perProducer = total / producerCount;
+
+    QThread consumer;
+    Receiver receiver;
+    receiver.moveToThread(&consumer);
+    receiver.expect(perProducer * producerCount);
+
+    Sender sender;
+    if (withText)
+        connect(&sender, &Sender::textChanged, &receiver, &Receiver::onTextChanged, Qt::QueuedConnection);
+    else
+        connect(&sender, &Sender::valueChanged, &receiver, &Receiver::onValueChanged, Qt::QueuedConnection);
+    consumer.start();
+
+    QVector<Producer *> producers;
+    for (int i = 0; i < producerCount; ++i)
+        producers << new Producer(&sender, perProducer, withText);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (Producer *producer : qAsConst(producers))
+        producer->start();
+    QVERIFY(receiver.done.tryAcquire(1, 60000));
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), qint64(1));
+
+    for (Producer *producer : qAsConst(producers))
+        producer->wait();
+    qDeleteAll(producers);
+    consumer.quit();
+    consumer.wait();
+
+    const qreal signalsPerSecond = qreal(perProducer) * producerCount * 1e9 / elapsed;
+    qDebug("%s: %.2f M signals/s", QTest::currentDataTag(), signalsPerSecond / 1e6);
+    QTest::setBenchmarkResult(signalsPerSecond, QTest::Events);
+}
+
+QTEST_MAIN(tst_QueuedConnection)
+
+#include "tst_bench_queuedconnection.moc"
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QRegularExpression>
+#include <QTest>
+
+class tst_QRegularExpression : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void compileRuleSet_data();
+    void compileRuleSet();
+    void deserializeRuleSet_data() { compileRuleSet_data(); }
+    void deserializeRuleSet();
+};
+
+// A rule set like the ones of log filters or syntax highlighters: many
+// different, moderately complex patterns compiled at startup
+static QList<QRegularExpression> ruleSet(int size)
+{
+    QList<QRegularExpression> rules;
+    rules.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        rules.append(QRegularExpression(
+                QStringLiteral("^(?<date>\\d{4}-\\d{2}-\\d{2})\\s+(?<level>DEBUG|INFO|WARN|ERROR)\\s+"
+                               "\\[component%1\\]\\s+(?<message>.*?(?:timeout|refused|[a-z]+_%1)\\b.*)$")
+                        .arg(i),
+                QRegularExpression::MultilineOption));
+    }
+    return rules;
+}
+
+void tst_QRegularExpression::compileRuleSet_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("cached");
+
+    for (int size : { 10, 100, 1000 }) {
+        QTest::addRow("uncached-%d", size) << size << false;
+        QTest::addRow("cached-%d", size) << size << true;
+    }
+}
+
+void tst_QRegularExpression::compileRuleSet()
+{
+    QFETCH(int, size);
+    QFETCH(bool, cached);
+
+    const QList<QRegularExpression> rules = ruleSet(size);
+    QRegularExpression::setPatternCacheCapacity(size);
+    QRegularExpression::clearPatternCache();
+    for (const QRegularExpression &rule : rules)
+        QVERIFY(rule.isValid());
+
+    QBENCHMARK {
+        if (!cached)
+            QRegularExpression::clearPatternCache();
+        for (const QRegularExpression &rule : rules)
+            QRegularExpression(rule.pattern(), rule.patternOptions()).isValid();
+    }
+
+    QRegularExpression::setPatternCacheCapacity(256);
+}
+
+void tst_QRegularExpression::deserializeRuleSet()
+{
+    QFETCH(int, size);
+    QFETCH(bool, cached);
+
+    const QByteArray data = QRegularExpression::serializeCompiledPatterns(ruleSet(size));
+    QVERIFY(!data.isEmpty());
+    QRegularExpression::setPatternCacheCapacity(size);
+
+    QBENCHMARK {
+        if (!cached)
+            QRegularExpression::clearPatternCache();
+        const QList<QRegularExpression> rules = QRegularExpression::deserializeCompiledPatterns(data);
+        for (const QRegularExpression &rule : rules)
+            rule.isValid();
+    }
+
+    QRegularExpression::setPatternCacheCapacity(256);
+}
+
+QTEST_APPLESS_MAIN(tst_QRegularExpression)
+
+#include "main.moc"
@@ -40,6 +40,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void tinyTasks_data();
+    void tinyTasks();
+    void fanOut_data();
+    void fanOut();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +79,85 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+static void addThreadCountRows()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("workStealing");
+
+    const int idealThreadCount = qMax(QThread::idealThreadCount(), 1);
+    for (int threads = 1; ; threads = qMin(threads * 2, idealThreadCount)) {
+        QTest::addRow("shared-%d", threads) << threads << false;
+        QTest::addRow("stealing-%d", threads) << threads << true;
+        if (threads == idealThreadCount)
+            break;
+    }
+}
+
+void tst_QThreadPool::tinyTasks_data()
+{
+    addThreadCountRows();
+}
+
+// many tiny runnables started from one thread
+void tst_QThreadPool::tinyTasks()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workStealing);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+    QAtomicInt counter;
+
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i)
+            threadPool.start([&counter] { counter.ref(); });
+        threadPool.waitForDone();
+    }
+}
+
+class FanOutRunnable : public QRunnable
+{
+public:
+    FanOutRunnable(QThreadPool *pool, int depth)
+        : pool(pool), depth(depth)
+    {
+    }
+
+    void run() override
+    {
+        if (depth == 0)
+            return;
+        for (int i = 0; i < 4; ++i)
+            pool->start(new FanOutRunnable(pool, depth - 1));
+    }
+
+private:
+    QThreadPool *pool;
+    int depth;
+};
+
+void tst_QThreadPool::fanOut_data()
+{
+    addThreadCountRows();
+}
+
+// runnables starting further runnables from the pool's own threads
+void tst_QThreadPool::fanOut()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workStealing);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    QBENCHMARK {
+        // 1 + 4 + ... + 4^7 = 21845 runnables
+        threadPool.start(new FanOutRunnable(&threadPool, 7));
+        threadPool.waitForDone();
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
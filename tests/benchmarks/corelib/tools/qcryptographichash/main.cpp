@@ -30,6 +30,7 @@
 #include <QCryptographicHash>
 #include <QFile>
 #include <QRandomGenerator>
+#include <QTemporaryFile>
 #include <QString>
 #include <QtTest>
 
@@ -50,6 +51,12 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void hashBatch_data();
+    void hashBatch();
+    void hashEach_data() { hashBatch_data(); }
+    void hashEach();
+    void hashFile_data();
+    void hashFile();
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -167,6 +174,70 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::hashBatch_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<QByteArrayList>("data");
+
+    // 256 messages of each size, sliced out of blockOfData at varying offsets
+    static const int datasizes[] = { 64, 1024, 4096 };
+    for (int size : datasizes) {
+        QByteArrayList data;
+        for (int i = 0; i < 256; ++i)
+            data.append(QByteArray::fromRawData(blockOfData.constData() + (i * 97) % (MaxBlockSize - size), size));
+
+        for (int algo : { QCryptographicHash::Sha1, QCryptographicHash::Sha224, QCryptographicHash::Sha256 })
+            QTest::newRow(algoname(algo) + QByteArray::number(size)) << algo << data;
+    }
+}
+
+void tst_bench_QCryptographicHash::hashBatch()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArrayList, data);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        QCryptographicHash::hashBatch(data, algo);
+    }
+}
+
+void tst_bench_QCryptographicHash::hashEach()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArrayList, data);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        for (const QByteArray &message : qAsConst(data))
+            QCryptographicHash::hash(message, algo);
+    }
+}
+
+void tst_bench_QCryptographicHash::hashFile_data()
+{
+    QTest::addColumn<int>("algorithm");
+    for (int algo : { QCryptographicHash::Md5, QCryptographicHash::Sha1, QCryptographicHash::Sha256 })
+        QTest::newRow(algoname(algo) + QByteArray("64M")) << algo;
+}
+
+void tst_bench_QCryptographicHash::hashFile()
+{
+    QFETCH(int, algorithm);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int i = 0; i < 64 * 1024 * 1024 / MaxBlockSize; ++i)
+        QCOMPARE(file.write(blockOfData), qint64(MaxBlockSize));
+    QVERIFY(file.flush());
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        file.seek(0);
+        QCryptographicHash::hash(&file, algo);
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
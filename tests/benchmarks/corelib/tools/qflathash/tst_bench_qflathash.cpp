@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <qflathash.h>
+#include <qhash.h>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void insert_data() { data(); }
+    void insert();
+    void insertReserved_data() { data(); }
+    void insertReserved();
+    void lookupHit_data() { data(); }
+    void lookupHit();
+    void lookupMiss_data() { data(); }
+    void lookupMiss();
+    void erase_data() { data(); }
+    void erase();
+    void iterate_data() { data(); }
+    void iterate();
+    void memory_data() { data(); }
+    void memory();
+
+private:
+    void data();
+};
+
+enum Container {
+    Hash,
+    FlatHash
+};
+Q_DECLARE_METATYPE(Container)
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 1000, 100000, 1000000 }) {
+        const QByteArray suffix = '-' + QByteArray::number(size);
+        QTest::newRow(("QHash" + suffix).constData()) << Hash << size;
+        QTest::newRow(("QFlatHash" + suffix).constData()) << FlatHash << size;
+    }
+}
+
+// Spread the keys out, like the ids of a real index
+static inline int keyAt(int i)
+{
+    return int(uint(i) * 2654435761u);
+}
+
+template <typename Table>
+static Table makeTable(int size)
+{
+    Table table;
+    for (int i = 0; i < size; ++i)
+        table.insert(keyAt(i), i);
+    return table;
+}
+
+template <typename Table>
+static void benchInsert(int size, bool reserve)
+{
+    QBENCHMARK {
+        Table table;
+        if (reserve)
+            table.reserve(size);
+        for (int i = 0; i < size; ++i)
+            table.insert(keyAt(i), i);
+    }
+}
+
+template <typename Table>
+static void benchLookup(int size, int offset)
+{
+    const Table table = makeTable<Table>(size);
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < size; ++i)
+            sum += table.value(keyAt(i + offset), 1);
+    }
+    QVERIFY(sum != 0);
+}
+
+template <typename Table>
+static void benchErase(int size)
+{
+    QBENCHMARK {
+        Table table = makeTable<Table>(size);
+        for (int i = 0; i < size; ++i)
+            table.remove(keyAt(i));
+        QVERIFY(table.isEmpty());
+    }
+}
+
+template <typename Table>
+static void benchIterate(int size)
+{
+    const Table table = makeTable<Table>(size);
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (typename Table::const_iterator it = table.begin(), end = table.end(); it != end; ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum != 0);
+}
+
+#define DISPATCH(call) \
+    QFETCH(Container, container); \
+    QFETCH(int, size); \
+    if (container == Hash) { \
+        typedef QHash<int, int> Table; \
+        call; \
+    } else { \
+        typedef QFlatHash<int, int> Table; \
+        call; \
+    }
+
+void tst_QFlatHash::insert()
+{
+    DISPATCH(benchInsert<Table>(size, false))
+}
+
+void tst_QFlatHash::insertReserved()
+{
+    DISPATCH(benchInsert<Table>(size, true))
+}
+
+void tst_QFlatHash::lookupHit()
+{
+    DISPATCH(benchLookup<Table>(size, 0))
+}
+
+void tst_QFlatHash::lookupMiss()
+{
+    DISPATCH(benchLookup<Table>(size, size))
+}
+
+void tst_QFlatHash::erase()
+{
+    DISPATCH(benchErase<Table>(size))
+}
+
+void tst_QFlatHash::iterate()
+{
+    DISPATCH(benchIterate<Table>(size))
+}
+
+void tst_QFlatHash::memory()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    const size_t before = mallinfo2().uordblks;
+    size_t used;
+    if (container == Hash) {
+        const QHash<int, int> table = makeTable<QHash<int, int> >(size);
+        used = mallinfo2().uordblks - before;
+    } else {
+        const QFlatHash<int, int> table = makeTable<QFlatHash<int, int> >(size);
+        used = mallinfo2().uordblks - before;
+    }
+
+    qDebug("%s: %.1f bytes per item", QTest::currentDataTag(), double(used) / size);
+    QTest::setBenchmarkResult(qreal(used), QTest::BytesAllocated);
+#else
+    QSKIP("Heap usage can only be measured with glibc 2.33 or later");
+#endif
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "tst_bench_qflathash.moc"
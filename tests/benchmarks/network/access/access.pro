@@ -1,6 +1,8 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         qfile_vs_qnetworkaccessmanager \
+        hpack \
         qnetworkreply \
         qnetworkreply_from_cache \
+        qnetworkaccessmanager_connections \
         qnetworkdiskcache
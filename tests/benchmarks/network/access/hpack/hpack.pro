@@ -0,0 +1,3 @@
+TARGET = tst_bench_hpack
+QT = core network-private testlib
+SOURCES += tst_bench_hpack.cpp
@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtNetwork/private/bitstreams_p.h>
+#include <QtNetwork/private/hpack_p.h>
+
+#include <vector>
+
+using namespace HPack;
+
+// Encodes and decodes the headers of many small requests sent over
+// one connection, the way a browser loading a page would do.
+class tst_bench_hpack : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void encodeRequests_data();
+    void encodeRequests();
+    void decodeRequests_data();
+    void decodeRequests();
+    void huffmanDecode();
+
+private:
+    std::vector<HttpHeader> requests;
+};
+
+static const int RequestCount = 200;
+
+void tst_bench_hpack::initTestCase()
+{
+    for (int i = 0; i < RequestCount; ++i) {
+        requests.push_back({
+            {":authority", "www.example.com"},
+            {":method", "GET"},
+            {":path", "/static/images/thumbnail-" + QByteArray::number(i) + ".png"},
+            {":scheme", "https"},
+            {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                           "(KHTML, like Gecko) Chrome/99.0.4844.51 Safari/537.36"},
+            {"accept", "image/avif,image/webp,image/apng,image/*,*/*;q=0.8"},
+            {"accept-encoding", "gzip, deflate, br"},
+            {"accept-language", "en-US,en;q=0.9,de;q=0.8"},
+            {"cache-control", "no-cache"},
+            {"cookie", "session=5f2b9c41d7e8a03b6c19; theme=dark; visit=" + QByteArray::number(i % 7)},
+            {"referer", "https://www.example.com/gallery?page=" + QByteArray::number(i / 20)},
+            {"x-request-id", QByteArray::number(0x5f2b0000 + i, 16)}
+        });
+    }
+}
+
+void tst_bench_hpack::encodeRequests_data()
+{
+    QTest::addColumn<bool>("compressStrings");
+
+    QTest::newRow("plain") << false;
+    QTest::newRow("huffman") << true;
+}
+
+void tst_bench_hpack::encodeRequests()
+{
+    QFETCH(bool, compressStrings);
+
+    std::vector<uchar> buffer;
+    QBENCHMARK {
+        Encoder encoder(FieldLookupTable::DefaultSize, compressStrings);
+        for (const HttpHeader &header : requests) {
+            buffer.clear();
+            BitOStream outputStream(buffer);
+            QVERIFY(encoder.encodeRequest(outputStream, header));
+        }
+    }
+}
+
+void tst_bench_hpack::decodeRequests_data()
+{
+    encodeRequests_data();
+}
+
+void tst_bench_hpack::decodeRequests()
+{
+    QFETCH(bool, compressStrings);
+
+    std::vector<std::vector<uchar> > blocks(requests.size());
+    Encoder encoder(FieldLookupTable::DefaultSize, compressStrings);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        BitOStream outputStream(blocks[i]);
+        QVERIFY(encoder.encodeRequest(outputStream, requests[i]));
+    }
+
+    QBENCHMARK {
+        Decoder decoder(FieldLookupTable::DefaultSize);
+        for (const std::vector<uchar> &block : blocks) {
+            BitIStream inputStream(&block[0], &block[0] + block.size());
+            QVERIFY(decoder.decodeHeaderFields(inputStream));
+        }
+    }
+
+    // The last request is decoded correctly:
+    Decoder decoder(FieldLookupTable::DefaultSize);
+    for (const std::vector<uchar> &block : blocks) {
+        BitIStream inputStream(&block[0], &block[0] + block.size());
+        QVERIFY(decoder.decodeHeaderFields(inputStream));
+    }
+    QVERIFY(decoder.decodedHeader() == requests.back());
+}
+
+void tst_bench_hpack::huffmanDecode()
+{
+    // Without the dynamic table every string is decoded again:
+    std::vector<uchar> buffer;
+    BitOStream outputStream(buffer);
+    for (const HttpHeader &header : requests) {
+        for (const HeaderField &field : header)
+            outputStream.write(field.value, true);
+    }
+
+    QBENCHMARK {
+        BitIStream inputStream(outputStream.begin(), outputStream.end());
+        QByteArray value;
+        while (inputStream.hasMoreBits())
+            QVERIFY(inputStream.read(&value));
+    }
+}
+
+QTEST_MAIN(tst_bench_hpack)
+
+#include "tst_bench_hpack.moc"
@@ -0,0 +1,3 @@
+TARGET = tst_bench_qnetworkaccessmanager_connections
+QT = core network testlib
+SOURCES += tst_qnetworkaccessmanager_connections.cpp
@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QHttpServer>
+#include <QtNetwork/QHttpServerRequest>
+#include <QtNetwork/QHttpServerResponse>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+
+// Measures request throughput against a local server that takes a fixed
+// amount of time to answer each request, for different numbers of
+// connections per host.
+class tst_qnetworkaccessmanager_connections : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void throughput_data();
+    void throughput();
+
+private:
+    QHttpServer server;
+};
+
+static const int RequestCount = 120;
+static const int ResponseDelay = 5; // msecs
+
+void tst_qnetworkaccessmanager_connections::initTestCase()
+{
+    connect(&server, &QHttpServer::newRequest,
+            [](QHttpServerRequest *, QHttpServerResponse *response) {
+        QPointer<QHttpServerResponse> guard(response);
+        QTimer::singleShot(ResponseDelay, [guard]() {
+            if (!guard)
+                return;
+            guard->write(QByteArray(1024, 'x'));
+            guard->finish();
+        });
+    });
+    QVERIFY(server.listen(QHostAddress(QHostAddress::LocalHost)));
+}
+
+void tst_qnetworkaccessmanager_connections::throughput_data()
+{
+    QTest::addColumn<int>("channelCount");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("6") << 6;
+    QTest::newRow("16") << 16;
+}
+
+void tst_qnetworkaccessmanager_connections::throughput()
+{
+    QFETCH(int, channelCount);
+
+    const QUrl url(QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort()));
+    QNetworkAccessManager::ConnectionPoolStatistics statistics;
+
+    QBENCHMARK {
+        QNetworkAccessManager manager;
+        manager.setMaximumConnectionsPerHost(channelCount);
+
+        int finished = 0;
+        QEventLoop loop;
+        connect(&manager, &QNetworkAccessManager::finished, [&](QNetworkReply *reply) {
+            QCOMPARE(reply->error(), QNetworkReply::NoError);
+            reply->deleteLater();
+            if (++finished == RequestCount)
+                loop.quit();
+        });
+        for (int i = 0; i < RequestCount; ++i)
+            manager.get(QNetworkRequest(url));
+        QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+        loop.exec();
+        QCOMPARE(finished, RequestCount);
+        statistics = manager.connectionPoolStatistics();
+    }
+
+    QCOMPARE(statistics.requestCount, qint64(RequestCount));
+    QVERIFY(statistics.connectionCount <= channelCount);
+    qDebug("%d channels: %lld connections, reuse ratio %.2f", channelCount,
+           statistics.connectionCount, statistics.reuseRatio());
+}
+
+QTEST_MAIN(tst_qnetworkaccessmanager_connections)
+
+#include "tst_qnetworkaccessmanager_connections.moc"
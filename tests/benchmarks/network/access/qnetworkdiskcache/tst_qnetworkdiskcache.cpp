@@ -54,6 +54,7 @@ class tst_qnetworkdiskcache : public QObject
     Q_OBJECT
 private:
     void injectFakeData();
+    void injectFakeData(int count);
     void insertOneItem();
     bool isUrlCached(quint32 id);
     void cleanRecursive(QString &path);
@@ -77,6 +78,17 @@ private slots:
 
     void timeExpiration_data();
     void timeExpiration();
+
+    void timeLargeCacheOpen_data();
+    void timeLargeCacheOpen();
+    void timeLargeCacheLookup_data();
+    void timeLargeCacheLookup();
+    void timeLargeCacheExpiration_data();
+    void timeLargeCacheExpiration();
+
+private:
+    void largeCache_data();
+    void setupLargeCache(int entries);
 };
 
 
@@ -323,11 +335,141 @@ void tst_qnetworkdiskcache::timeExpiration()
     cleanRecursive(cacheDir);
 
 }
+void tst_qnetworkdiskcache::largeCache_data()
+{
+    QTest::addColumn<int>("entries");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    // QTest::newRow("100000") << 100000; // takes minutes to populate
+}
+
+// Creates a cache directory holding the given number of entries, leaving
+// the cache object closed so that the next one has to open it from scratch.
+void tst_qnetworkdiskcache::setupLargeCache(int entries)
+{
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    cacheDir = QString(cacheLoc + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    cleanRecursive(cacheDir); // slow op.
+    initCacheObject();
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit) * 10);
+    cache->clear();
+
+    injectFakeData(entries); // SLOW
+    cleanupCacheObject();
+}
+
+void tst_qnetworkdiskcache::timeLargeCacheOpen_data()
+{
+    largeCache_data();
+}
+
+//Times opening a populated cache and getting its size,
+//which is what happens before the first insertion
+void tst_qnetworkdiskcache::timeLargeCacheOpen()
+{
+    QFETCH(int, entries);
+    setupLargeCache(entries);
+
+    initCacheObject();
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit) * 10);
+    QBENCHMARK_ONCE {
+        cache->setCacheDirectory(cacheDir);
+        QVERIFY(cache->cacheSize() > 0);
+    }
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeLargeCacheLookup_data()
+{
+    largeCache_data();
+}
+
+//Times metaData() lookups in a populated cache, half of which miss
+void tst_qnetworkdiskcache::timeLargeCacheLookup()
+{
+    QFETCH(int, entries);
+    setupLargeCache(entries);
+
+    initCacheObject();
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit) * 10);
+    cache->setCacheDirectory(cacheDir);
+
+    QVector<QUrl> urls;
+    for (int i = 0; i < NumReadContent; ++i) {
+        urls.append(QUrl(fakeURLbase + QString::number(i * (entries / NumReadContent))));
+        urls.append(QUrl(fakeURLbase + QString::number(entries + i)));
+    }
+
+    int hits = 0;
+    QBENCHMARK {
+        hits = 0;
+        for (const QUrl &url : qAsConst(urls)) {
+            if (cache->metaData(url).isValid())
+                ++hits;
+        }
+    }
+    QCOMPARE(hits, int(NumReadContent));
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeLargeCacheExpiration_data()
+{
+    largeCache_data();
+}
+
+//Times shrinking a populated cache below its size, which evicts
+//the least recently used entries, and inserting into it
+void tst_qnetworkdiskcache::timeLargeCacheExpiration()
+{
+    QFETCH(int, entries);
+    setupLargeCache(entries);
+
+    initCacheObject();
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit) * 10);
+    cache->setCacheDirectory(cacheDir);
+    const qint64 size = cache->cacheSize();
+    QVERIFY(size > 0);
+
+    QBENCHMARK_ONCE {
+        // This evicts a tenth of the entries
+        cache->setMaximumCacheSize(size);
+        for (quint32 i = entries; i < entries + NumInsertions; i++) {
+            QNetworkCacheMetaData meta;
+            meta.setUrl(QUrl(fakeURLbase + QString::number(i)));
+            meta.setSaveToDisk(true);
+
+            QIODevice *device = cache->prepare(meta);
+            device->write(payload);
+            cache->insert(device);
+        }
+    }
+    QVERIFY(cache->cacheSize() < size);
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
 // This function simulates a partially or fully occupied disk cache
 // like a normal user of a cache might encounter is real-life browsing.
 // The point of this is to trigger degradation in file-system and media performance
 // that occur due to the quantity and layout of data.
 void tst_qnetworkdiskcache::injectFakeData()
+{
+    injectFakeData(NumFakeCacheObjects);
+}
+
+void tst_qnetworkdiskcache::injectFakeData(int count)
 {
 
     QNetworkCacheMetaData::RawHeaderList headers;
@@ -335,7 +477,7 @@ void tst_qnetworkdiskcache::injectFakeData()
 
 
     //Prep cache dir with fake data using QNetworkDiskCache APIs
-    for (quint32 i = 0; i < NumFakeCacheObjects; i++) {
+    for (int i = 0; i < count; i++) {
 
         //prepare metata for url
         QNetworkCacheMetaData meta;
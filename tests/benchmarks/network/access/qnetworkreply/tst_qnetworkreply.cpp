@@ -32,6 +32,7 @@
 #include <QtTest/QtTest>
 #include <QtCore/qrandom.h>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QTemporaryFile>
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qnetworkrequest.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
@@ -463,6 +464,7 @@ private slots:
     void uploadPerformance();
     void performanceControlRate();
     void httpUploadPerformance();
+    void httpUploadFromFilePerformance();
     void httpDownloadPerformance_data();
     void httpDownloadPerformance();
     void httpDownloadPerformanceDownloadBuffer_data();
@@ -698,6 +700,40 @@ void tst_qnetworkreply::httpUploadPerformance()
               << ((UploadSize/1024.0)/(elapsed/1000.0)) << " kB/sec";
 }
 
+void tst_qnetworkreply::httpUploadFromFilePerformance()
+{
+      enum {UploadSize = 128*1024*1024}; // 128 MB
+
+      // On plain HTTP the file is sent by the socket without being copied
+      QTemporaryFile file;
+      QVERIFY(file.open());
+      const QByteArray block(1024*1024, 'x');
+      for (int i = 0; i < UploadSize / block.size(); ++i)
+          QCOMPARE(file.write(block), qint64(block.size()));
+      QVERIFY(file.flush());
+      QVERIFY(file.seek(0));
+
+      ThreadedDataReaderHttpServer reader;
+
+      QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(reader.serverPort()) + "/?bare=1"));
+      QNetworkReplyPtr reply(manager.put(request, &file));
+
+      connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()));
+
+      QElapsedTimer time;
+      time.start();
+      QTestEventLoop::instance().enterLoop(40);
+      qint64 elapsed = time.elapsed();
+      reader.exit();
+      reader.wait();
+      QVERIFY(reply->isFinished());
+      QCOMPARE(reply->error(), QNetworkReply::NoError);
+      QVERIFY(!QTestEventLoop::instance().timeout());
+
+      qDebug() << "tst_QNetworkReply::httpUploadFromFilePerformance" << elapsed << "msec, "
+              << ((UploadSize/1024.0)/(elapsed/1000.0)) << " kB/sec";
+}
+
 
 void tst_qnetworkreply::performanceControlRate()
 {
@@ -59,6 +59,8 @@ private slots:
     void ipv4LoopbackPerformanceTest();
     void ipv6LoopbackPerformanceTest();
     void ipv4PerformanceTest();
+    void shardedAccept_data();
+    void shardedAccept();
 };
 
 tst_QTcpServer::tst_QTcpServer()
@@ -262,5 +264,77 @@ void tst_QTcpServer::ipv4PerformanceTest()
     delete clientB;
 }
 
+//----------------------------------------------------------------------------------
+void tst_QTcpServer::shardedAccept_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void tst_QTcpServer::shardedAccept()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(int, threadCount);
+
+    // One server per thread, all listening on the same port
+    QAtomicInt accepted;
+    quint16 port = 0;
+    QVector<QThread *> threads;
+    QVector<QTcpServer *> servers;
+    for (int i = 0; i < threadCount; ++i) {
+        QThread *thread = new QThread;
+        QTcpServer *server = new QTcpServer;
+        server->moveToThread(thread);
+        connect(thread, &QThread::finished, server, &QObject::deleteLater);
+        thread->start();
+        bool ok = false;
+        QMetaObject::invokeMethod(server, [server, &port, &ok, &accepted] {
+            server->setSocketOption(QAbstractSocket::ReusePortSocketOption, 1);
+            ok = server->listen(QHostAddress::LocalHost, port);
+            port = server->serverPort();
+            QObject::connect(server, &QTcpServer::newConnection, server, [server, &accepted] {
+                while (QTcpSocket *socket = server->nextPendingConnection()) {
+                    delete socket;
+                    accepted.ref();
+                }
+            });
+        }, Qt::BlockingQueuedConnection);
+        threads << thread;
+        servers << server;
+        if (!ok)
+            QSKIP("Listening sockets cannot share a port on this platform");
+    }
+
+    // Stay below the listen backlog so that no connection attempt is dropped
+    const int connectionsPerIteration = 40;
+    int expected = 0;
+    QBENCHMARK {
+        QList<QTcpSocket *> clients;
+        for (int i = 0; i < connectionsPerIteration; ++i) {
+            QTcpSocket *client = new QTcpSocket;
+            client->connectToHost(QHostAddress::LocalHost, port);
+            clients << client;
+        }
+        expected += connectionsPerIteration;
+        QElapsedTimer timer;
+        timer.start();
+        while (accepted.loadAcquire() < expected && timer.elapsed() < 10000)
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        qDeleteAll(clients);
+    }
+    QCOMPARE(accepted.loadAcquire(), expected);
+
+    for (QThread *thread : qAsConst(threads)) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+}
+
 QTEST_MAIN(tst_QTcpServer)
 #include "tst_qtcpserver.moc"
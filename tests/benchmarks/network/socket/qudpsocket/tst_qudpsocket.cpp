@@ -41,6 +41,8 @@ public:
 private slots:
     void pendingDatagramSize_data();
     void pendingDatagramSize();
+    void roundTrip_data();
+    void roundTrip();
 };
 
 tst_QUdpSocket::tst_QUdpSocket()
@@ -76,5 +78,52 @@ void tst_QUdpSocket::pendingDatagramSize()
     }
 }
 
+void tst_QUdpSocket::roundTrip_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("batched");
+    for (int value : {64, 512, 1200}) {
+        QTest::addRow("%d-single", value) << value << false;
+        QTest::addRow("%d-batched", value) << value << true;
+    }
+}
+
+void tst_QUdpSocket::roundTrip()
+{
+    QFETCH(int, size);
+    QFETCH(bool, batched);
+    const int count = 64;
+
+    QUdpSocket sender, receiver;
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost)));
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost)));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1024 * 1024);
+
+    QVector<QNetworkDatagram> datagrams(count, QNetworkDatagram(QByteArray(size, 'a'),
+                                                                receiver.localAddress(),
+                                                                receiver.localPort()));
+
+    QBENCHMARK {
+        if (batched) {
+            QCOMPARE(sender.writeDatagrams(datagrams), count);
+        } else {
+            for (const QNetworkDatagram &datagram : qAsConst(datagrams))
+                QCOMPARE(sender.writeDatagram(datagram), qint64(size));
+        }
+
+        int received = 0;
+        while (received < count) {
+            if (!receiver.hasPendingDatagrams())
+                QVERIFY(receiver.waitForReadyRead(5000));
+            if (batched) {
+                received += receiver.receiveDatagrams(count - received).size();
+            } else {
+                QVERIFY(receiver.receiveDatagram().isValid());
+                ++received;
+            }
+        }
+    }
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
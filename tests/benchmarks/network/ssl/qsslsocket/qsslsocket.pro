@@ -7,3 +7,5 @@ QT += network testlib
 CONFIG += release
 
 SOURCES += tst_qsslsocket.cpp
+
+TESTDATA += certs
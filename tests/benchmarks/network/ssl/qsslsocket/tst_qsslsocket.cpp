@@ -29,12 +29,86 @@
 #include <QtTest/QtTest>
 
 #include <qcoreapplication.h>
+#include <qsemaphore.h>
 #include <qsslconfiguration.h>
+#include <qsslkey.h>
 #include <qsslsocket.h>
+#include <qtcpserver.h>
+#include <qthread.h>
 
 
 #include "../../../../auto/network-settings.h"
 
+// Bytes the bulk transfer sends before the server answers
+static const qint64 bulkSize = 64 * 1024 * 1024;
+
+// Accepts TLS connections in its own thread. Every client message is
+// answered with one byte, except that bulk data is only answered once
+// bulkSize bytes have arrived.
+class SslServerThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit SslServerThread(const QSslConfiguration &configuration)
+        : configuration(configuration)
+    {
+    }
+
+    void start()
+    {
+        QThread::start();
+        ready.acquire();
+    }
+
+    quint16 port = 0;
+
+protected:
+    void run() override;
+
+private:
+    QSslConfiguration configuration;
+    QSemaphore ready;
+};
+
+class SslServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    QSslConfiguration configuration;
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+        QSslSocket *socket = new QSslSocket(this);
+        socket->setSslConfiguration(configuration);
+        socket->setSocketDescriptor(socketDescriptor);
+        socket->setProperty("received", qint64(0));
+        connect(socket, &QSslSocket::readyRead, socket, [socket] {
+            const qint64 received = socket->property("received").toLongLong()
+                    + socket->skip(socket->bytesAvailable());
+            if (received < 1024 || received >= bulkSize) {
+                socket->write("!", 1);
+                socket->setProperty("received", qint64(0));
+            } else {
+                socket->setProperty("received", received);
+            }
+        });
+        connect(socket, &QSslSocket::disconnected, socket, &QObject::deleteLater);
+        socket->startServerEncryption();
+    }
+};
+
+void SslServerThread::run()
+{
+    SslServer server;
+    server.configuration = configuration;
+    if (server.listen(QHostAddress::LocalHost))
+        port = server.serverPort();
+    ready.release();
+    if (port)
+        exec();
+}
+
 class tst_QSslSocket : public QObject
 {
     Q_OBJECT
@@ -46,11 +120,21 @@ public:
 
 public slots:
     void initTestCase();
+    void cleanupTestCase();
     void init();
     void cleanup();
 private slots:
     void rootCertLoading();
     void systemCaCertificates();
+    void reconnect_data();
+    void reconnect();
+    void bulkTransfer_data();
+    void bulkTransfer();
+
+private:
+    QSslConfiguration clientConfiguration() const;
+
+    QScopedPointer<SslServerThread> server;
 };
 
 tst_QSslSocket::tst_QSslSocket()
@@ -63,8 +147,26 @@ tst_QSslSocket::~tst_QSslSocket()
 
 void tst_QSslSocket::initTestCase()
 {
-    if (!QtNetworkSettings::verifyTestNetworkSettings())
-        QSKIP("No network test server available");
+    QFile certificateFile(QFINDTESTDATA("certs/bogus-server.crt"));
+    QFile keyFile(QFINDTESTDATA("certs/bogus-server.key"));
+    QVERIFY(certificateFile.open(QIODevice::ReadOnly));
+    QVERIFY(keyFile.open(QIODevice::ReadOnly));
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setLocalCertificate(QSslCertificate(certificateFile.readAll()));
+    configuration.setPrivateKey(QSslKey(keyFile.readAll(), QSsl::Rsa));
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    server.reset(new SslServerThread(configuration));
+    server->start();
+    QVERIFY(server->port);
+}
+
+void tst_QSslSocket::cleanupTestCase()
+{
+    if (server) {
+        server->quit();
+        server->wait();
+    }
 }
 
 void tst_QSslSocket::init()
@@ -79,6 +181,9 @@ void tst_QSslSocket::cleanup()
 
 void tst_QSslSocket::rootCertLoading()
 {
+    if (!QtNetworkSettings::verifyTestNetworkSettings())
+        QSKIP("No network test server available");
+
     QBENCHMARK_ONCE {
         QSslSocket socket;
         socket.connectToHostEncrypted(QtNetworkSettings::serverName(), 443);
@@ -96,5 +201,81 @@ void tst_QSslSocket::systemCaCertificates()
   }
 }
 
+QSslConfiguration tst_QSslSocket::clientConfiguration() const
+{
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    return configuration;
+}
+
+void tst_QSslSocket::reconnect_data()
+{
+    QTest::addColumn<bool>("shareSessions");
+
+    QTest::newRow("full-handshake") << false;
+    QTest::newRow("resumed") << true;
+}
+
+void tst_QSslSocket::reconnect()
+{
+    QFETCH(bool, shareSessions);
+
+    QSslConfiguration configuration = clientConfiguration();
+    configuration.setSslOption(QSsl::SslOptionDisableSessionSharing, !shareSessions);
+
+    // Every iteration is a new socket with a new context, like a client
+    // that reconnects for each request
+    QBENCHMARK {
+        QSslSocket socket;
+        socket.setSslConfiguration(configuration);
+        socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), server->port);
+        QVERIFY2(socket.waitForEncrypted(5000), qPrintable(socket.errorString()));
+        // A TLS 1.3 session ticket arrives after the handshake, before the
+        // answer
+        socket.write("?", 1);
+        QVERIFY(socket.waitForReadyRead(5000));
+        socket.disconnectFromHost();
+    }
+}
+
+void tst_QSslSocket::bulkTransfer_data()
+{
+    QTest::addColumn<bool>("kernelTls");
+
+    QTest::newRow("userspace") << false;
+    QTest::newRow("ktls") << true;
+}
+
+void tst_QSslSocket::bulkTransfer()
+{
+    QFETCH(bool, kernelTls);
+
+    // Without kernel support, this falls back to encrypting in userspace
+    QSslConfiguration configuration = clientConfiguration();
+    if (kernelTls)
+        configuration.setBackendConfigurationOption("Qt-KTLS", true);
+
+    QSslSocket socket;
+    socket.setSslConfiguration(configuration);
+    socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), server->port);
+    QVERIFY2(socket.waitForEncrypted(5000), qPrintable(socket.errorString()));
+    socket.write("?", 1);
+    QVERIFY(socket.waitForReadyRead(5000));
+    socket.readAll();
+
+    const QByteArray chunk(256 * 1024, 'x');
+    QBENCHMARK {
+        for (qint64 sent = 0; sent < bulkSize; sent += chunk.size()) {
+            socket.write(chunk);
+            while (socket.bytesToWrite() > 4 * chunk.size())
+                QVERIFY(socket.waitForBytesWritten(5000));
+        }
+        while (!socket.bytesAvailable())
+            QVERIFY(socket.waitForReadyRead(5000));
+        socket.readAll();
+    }
+    socket.disconnectFromHost();
+}
+
 QTEST_MAIN(tst_QSslSocket)
 #include "tst_qsslsocket.moc"
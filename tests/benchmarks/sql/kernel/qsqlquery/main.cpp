@@ -52,6 +52,10 @@ private slots:
     void benchmark();
     void benchmarkSelectPrepared_data() { generic_data(); }
     void benchmarkSelectPrepared();
+    void benchmarkScanValues_data() { generic_data(); }
+    void benchmarkScanValues();
+    void benchmarkScanBlock_data() { generic_data(); }
+    void benchmarkScanBlock();
 
 private:
     // returns all database connections
@@ -59,6 +63,7 @@ private:
     void dropTestTables( QSqlDatabase db );
     void createTestTables( QSqlDatabase db );
     void populateTestTables( QSqlDatabase db );
+    bool createScanTable(QSqlDatabase db, const QString &tableName);
 
     tst_Databases dbs;
 };
@@ -293,4 +298,89 @@ void tst_QSqlQuery::benchmarkSelectPrepared()
     tst_Databases::safeDropTable(db, tableName);
 }
 
+static const int scanRowCount = 100000;
+
+bool tst_QSqlQuery::createScanTable(QSqlDatabase db, const QString &tableName)
+{
+    QSqlQuery q(db);
+    tst_Databases::safeDropTable(db, tableName);
+    if (!q.exec("CREATE TABLE " + tableName + " (id INT NOT NULL, num REAL, name VARCHAR(20))"))
+        return false;
+
+    QVariantList ids, nums, names;
+    for (int i = 0; i < scanRowCount; ++i) {
+        ids << i;
+        nums << i * 0.5;
+        names << QString::fromLatin1("name %1").arg(i);
+    }
+    if (!q.prepare("INSERT INTO " + tableName + " (id, num, name) VALUES (?, ?, ?)"))
+        return false;
+    q.addBindValue(ids);
+    q.addBindValue(nums);
+    q.addBindValue(names);
+    return q.execBatch();
+}
+
+void tst_QSqlQuery::benchmarkScanValues()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("benchmark_scan", __FILE__, db));
+    QVERIFY(createScanTable(db, tableName));
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, prepare("SELECT id, num, name FROM " + tableName));
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec());
+        qint64 idSum = 0;
+        double numSum = 0;
+        qint64 nameLength = 0;
+        while (q.next()) {
+            idSum += q.value(0).toLongLong();
+            numSum += q.value(1).toDouble();
+            nameLength += q.value(2).toString().size();
+        }
+        QCOMPARE(idSum, qint64(scanRowCount) * (scanRowCount - 1) / 2);
+        QVERIFY(numSum > 0 && nameLength > 0);
+    }
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::benchmarkScanBlock()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("benchmark_scan", __FILE__, db));
+    QVERIFY(createScanTable(db, tableName));
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, prepare("SELECT id, num, name FROM " + tableName));
+    QSqlColumnBlock block(4096);
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec());
+        qint64 idSum = 0;
+        double numSum = 0;
+        qint64 nameLength = 0;
+        while (q.fetchBlock(&block)) {
+            const qint64 *ids = block.int64Column(0);
+            const double *nums = block.doubleColumn(1);
+            const QString *names = block.stringColumn(2);
+            for (int row = 0; row < block.rowCount(); ++row) {
+                idSum += ids[row];
+                numSum += nums[row];
+                nameLength += names[row].size();
+            }
+        }
+        QCOMPARE(idSum, qint64(scanRowCount) * (scanRowCount - 1) / 2);
+        QVERIFY(numSum > 0 && nameLength > 0);
+    }
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 #include "main.moc"